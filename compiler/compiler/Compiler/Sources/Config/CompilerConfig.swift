@@ -76,6 +76,10 @@ struct CompilerConfig {
     /// Whether to output for release, debug or both
     let outputTarget: OutputTarget
 
+    /// Whether .valdimodule files should be emitted in the seekable format, where each entry is
+    /// compressed independently and can be decompressed on demand by the runtime
+    let emitSeekableModules: Bool
+
     static func from(args: ValdiCompilerArguments, baseURL: URL, environment: [String: String]) throws -> CompilerConfig {
         let hotReloadingEnabled = args.monitor
 
@@ -122,7 +126,8 @@ struct CompilerConfig {
             outputForAndroid: args.android,
             outputForWeb: args.web,
             outputForCpp: args.cpp,
-            outputTarget: args.outputTarget ?? OutputTarget.all
+            outputTarget: args.outputTarget ?? OutputTarget.all,
+            emitSeekableModules: args.seekableModules
         )
     }
 }
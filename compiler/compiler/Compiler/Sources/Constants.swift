@@ -80,6 +80,11 @@ struct Magic {
         packetData.append(0x01)
         return packetData
     }()
+
+    // Head of .valdimodule archives using the seekable format, see ValdiModuleBuilder
+    static let valdiSeekableMagic: Data = {
+        return Data("VSAR".utf8)
+    }()
 }
 
 struct DeterministicDate {
@@ -144,13 +144,21 @@ class BundleResourcesProcessor: CompilationProcessor {
 
             let data = try moduleBuilder.build()
 
-            let cacheKey = getCacheKey(moduleName)
+            let emitSeekable = compilerConfig.emitSeekableModules
+            let cacheKey = emitSeekable ? getCacheKey(moduleName) + ".seekable" : getCacheKey(moduleName)
 
             if let cachedCompressed = diskCache?.getOutput(item: cacheKey, platform: platform, target: target, inputData: data) {
                 return cachedCompressed
             }
 
-            let compressedData = try ValdiModuleBuilder.compress(data: data)
+            let compressedData: Data
+            if emitSeekable {
+                let seekableModuleBuilder = ValdiModuleBuilder(items: zippableItems)
+                seekableModuleBuilder.seekable = true
+                compressedData = try seekableModuleBuilder.build()
+            } else {
+                compressedData = try ValdiModuleBuilder.compress(data: data)
+            }
             try diskCache?.setOutput(item: cacheKey, platform: platform, target: target, inputData: data, outputData: compressedData)
 
             return compressedData
@@ -41,18 +41,37 @@ extension Parser where T == Data {
     }
 }
 
+private struct SeekableIndexEntry {
+    static let compressedFlag: UInt32 = 1
+
+    var pathOffset: UInt32
+    var pathLength: UInt32
+    // Offset relative to the start of the entries data
+    var dataOffset: UInt32
+    var dataSize: UInt32
+    var decompressedSize: UInt32
+    var flags: UInt32
+}
+
 class ValdiModuleBuilder {
 
+    // Must be kept in sync with ValdiModuleArchive.cpp in the runtime
+    private static let seekableVersion: UInt32 = 1
+
     private let items: [ZippableItem]
     var compress = true
+    /**
+     When set, each entry is compressed into its own zstd frame and an index of the entries
+     is stored at the head of the archive, so that the runtime can decompress entries on demand.
+     The whole archive is then never compressed as a single frame.
+     */
+    var seekable = false
 
     init(items: [ZippableItem]) {
         self.items = items
     }
 
-    private func pack() throws -> Data {
-        var out = Data()
-
+    private func sortedItems() throws -> [ZippableItem] {
         let sortedItems = items.sorted { (left, right) -> Bool in
             return left.path > right.path
         }
@@ -61,7 +80,15 @@ class ValdiModuleBuilder {
             guard !item.path.hasPrefix("../") else {
                 throw CompilerError("Invalid path for entry '\(item.path)'")
             }
+        }
 
+        return sortedItems
+    }
+
+    private func pack() throws -> Data {
+        var out = Data()
+
+        for item in try sortedItems() {
             let filename = try item.path.utf8Data()
             let fileData = try item.file.readData()
 
@@ -72,7 +99,76 @@ class ValdiModuleBuilder {
         return out
     }
 
+    private static func appendPadding(data: inout Data) {
+        for _ in 0..<Data.computePadding(size: UInt32(data.count)) {
+            data.append(0)
+        }
+    }
+
+    /**
+     Layout, all fields are little endian UInt32:
+     | magic, version, entries count, paths size | index entries | entry paths, padded to 4 bytes |
+     | entries data, each padded to 4 bytes |
+     */
+    private func packSeekable() throws -> Data {
+        var index = [SeekableIndexEntry]()
+        var paths = Data()
+        var entriesData = Data()
+
+        for item in try sortedItems() {
+            let filename = try item.path.utf8Data()
+            let fileData = try item.file.readData()
+
+            var indexEntry = SeekableIndexEntry(pathOffset: UInt32(paths.count),
+                                                pathLength: UInt32(filename.count),
+                                                dataOffset: UInt32(entriesData.count),
+                                                dataSize: UInt32(fileData.count),
+                                                decompressedSize: UInt32(fileData.count),
+                                                flags: 0)
+            paths.append(filename)
+
+            let compressedData = self.compress ? try ValdiModuleBuilder.compress(data: fileData) : fileData
+            if compressedData.count < fileData.count {
+                indexEntry.flags = SeekableIndexEntry.compressedFlag
+                indexEntry.dataSize = UInt32(compressedData.count)
+                entriesData.append(compressedData)
+            } else {
+                // Stored as is when compression doesn't help, the runtime can then use the entry in place
+                entriesData.append(fileData)
+            }
+            ValdiModuleBuilder.appendPadding(data: &entriesData)
+
+            index.append(indexEntry)
+        }
+
+        ValdiModuleBuilder.appendPadding(data: &paths)
+
+        var out = Data()
+        out.append(Magic.valdiSeekableMagic)
+        out.append(integer: ValdiModuleBuilder.seekableVersion)
+        out.append(integer: UInt32(index.count))
+        out.append(integer: UInt32(paths.count))
+
+        for indexEntry in index {
+            out.append(integer: indexEntry.pathOffset)
+            out.append(integer: indexEntry.pathLength)
+            out.append(integer: indexEntry.dataOffset)
+            out.append(integer: indexEntry.dataSize)
+            out.append(integer: indexEntry.decompressedSize)
+            out.append(integer: indexEntry.flags)
+        }
+
+        out.append(paths)
+        out.append(entriesData)
+
+        return out
+    }
+
     func build() throws -> Data {
+        if self.seekable {
+            return try packSeekable()
+        }
+
         let packetData = try pack()
 
         var packed = Data()
@@ -90,7 +186,67 @@ class ValdiModuleBuilder {
         return try ZstdCompressor.compress(data: data)
     }
 
+    private static func unpackSeekable(module: Data) throws -> [ZippableItem] {
+        let parser = Parser(sequence: module)
+
+        guard try parser.parse(subsequence: Magic.valdiSeekableMagic) else {
+            throw CompilerError("Did not find valdi seekable magic in module")
+        }
+
+        let version = try parser.parseInt()
+        guard version == seekableVersion else {
+            throw CompilerError("Unsupported seekable module version \(version)")
+        }
+
+        let entriesCount = Int(try parser.parseInt())
+        let pathsSize = Int(try parser.parseInt())
+
+        var index = [SeekableIndexEntry]()
+        for _ in 0..<entriesCount {
+            index.append(SeekableIndexEntry(pathOffset: try parser.parseInt(),
+                                            pathLength: try parser.parseInt(),
+                                            dataOffset: try parser.parseInt(),
+                                            dataSize: try parser.parseInt(),
+                                            decompressedSize: try parser.parseInt(),
+                                            flags: try parser.parseInt()))
+        }
+
+        let paths = try parser.subsequence(length: pathsSize)
+        let entriesDataStart = paths.endIndex
+
+        var out = [ZippableItem]()
+
+        for indexEntry in index {
+            let pathStart = paths.startIndex + Int(indexEntry.pathOffset)
+            let dataStart = entriesDataStart + Int(indexEntry.dataOffset)
+            guard pathStart + Int(indexEntry.pathLength) <= paths.endIndex,
+                  dataStart + Int(indexEntry.dataSize) <= module.endIndex else {
+                throw CompilerError("Entry out of bounds in seekable module")
+            }
+
+            guard let filename = String(data: paths[pathStart..<pathStart + Int(indexEntry.pathLength)], encoding: .utf8) else {
+                throw CompilerError("Could not extract file name")
+            }
+
+            var fileData = Data(module[dataStart..<dataStart + Int(indexEntry.dataSize)])
+            if (indexEntry.flags & SeekableIndexEntry.compressedFlag) != 0 {
+                fileData = try ZstdCompressor.decompress(data: fileData)
+            }
+            guard fileData.count == Int(indexEntry.decompressedSize) else {
+                throw CompilerError("Unexpected size for entry '\(filename)'")
+            }
+
+            out.append(ZippableItem(file: .data(fileData), path: filename))
+        }
+
+        return out
+    }
+
     static func unpack(module: Data) throws -> [ZippableItem] {
+        if module.starts(with: Magic.valdiSeekableMagic) {
+            return try unpackSeekable(module: module)
+        }
+
         let moduleData = ZstdCompressor.isZstdCompressed(data: module) ? try ZstdCompressor.decompress(data: module) : module
 
         let parser = Parser(sequence: moduleData)
@@ -174,6 +174,9 @@ struct ValdiCompilerArguments: ParsableCommand {
     @Flag(help: "Whether assets should be packed inline within the .valdimodule")
     var inlineAssets = false
 
+    @Flag(help: "Emit .valdimodule files in the seekable format, where the runtime decompresses each entry on demand")
+    var seekableModules = false
+
     @Flag
     var duplicateStderrToStdout = false
 
@@ -1,25 +1,360 @@
 #include "utils/encoding/Base64Utils.hpp"
 
 #include <boost/algorithm/string.hpp>
-#include <openssl/base64.h>
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <string>
 #include <vector>
 
-// We wrap the BoringSSL Base64 encoding/decoding functions
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define SNAP_BASE64_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define SNAP_BASE64_X86_KERNELS 0
+#endif
+
+// Encoding and decoding follow the semantics of the BoringSSL EVP_EncodeBlock and EVP_DecodeBase64
+// functions that were previously wrapped here: the output is padded, and the input of the decoder
+// must be made of complete quads, only the last of which can be padded.
 namespace snap::utils::encoding {
 
-std::string binaryToBase64(const uint8_t* data, size_t size) {
-    size_t maxOutSize = 0;
-    if (size == 0 || EVP_EncodedLength(&maxOutSize, size) != 1 || maxOutSize == 0) {
-        return "";
+static constexpr char kEncodingTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static constexpr uint8_t kInvalidCharacter = 0xFF;
+
+static constexpr std::array<uint8_t, 256> makeDecodingTable() {
+    std::array<uint8_t, 256> table{};
+    for (auto& value : table) {
+        value = kInvalidCharacter;
+    }
+    for (uint8_t i = 0; i < 64; i++) {
+        table[static_cast<uint8_t>(kEncodingTable[i])] = i;
+    }
+    return table;
+}
+
+static constexpr auto kDecodingTable = makeDecodingTable();
+
+static inline void encodeTriplet(const uint8_t* data, char* output) {
+    uint32_t value = (static_cast<uint32_t>(data[0]) << 16) | (static_cast<uint32_t>(data[1]) << 8) | data[2];
+    output[0] = kEncodingTable[(value >> 18) & 0x3F];
+    output[1] = kEncodingTable[(value >> 12) & 0x3F];
+    output[2] = kEncodingTable[(value >> 6) & 0x3F];
+    output[3] = kEncodingTable[value & 0x3F];
+}
+
+/**
+ Encodes the 0, 1 or 2 bytes left after the last complete triplet, with padding.
+ */
+static size_t encodeRemainder(const uint8_t* data, size_t size, char* output) {
+    if (size == 0) {
+        return 0;
+    }
+
+    uint8_t triplet[3] = {data[0], size > 1 ? data[1] : static_cast<uint8_t>(0), 0};
+    encodeTriplet(triplet, output);
+    output[3] = '=';
+    if (size == 1) {
+        output[2] = '=';
+    }
+    return 4;
+}
+
+/**
+ Returns the number of bytes written for the quad, or -1 if it is invalid.
+ Padding is accepted as "xxx=" and "xx==".
+ */
+static inline int decodeQuad(const char* quad, uint8_t* output) {
+    uint32_t a = kDecodingTable[static_cast<uint8_t>(quad[0])];
+    uint32_t b = kDecodingTable[static_cast<uint8_t>(quad[1])];
+    uint32_t c = kDecodingTable[static_cast<uint8_t>(quad[2])];
+    uint32_t d = kDecodingTable[static_cast<uint8_t>(quad[3])];
+
+    if (((a | b | c | d) & 0x80) == 0) {
+        auto value = (a << 18) | (b << 12) | (c << 6) | d;
+        output[0] = static_cast<uint8_t>(value >> 16);
+        output[1] = static_cast<uint8_t>(value >> 8);
+        output[2] = static_cast<uint8_t>(value);
+        return 3;
+    }
+
+    if (((a | b) & 0x80) != 0 || quad[3] != '=') {
+        return -1;
     }
+    if (quad[2] == '=') {
+        output[0] = static_cast<uint8_t>((a << 2) | (b >> 4));
+        return 1;
+    }
+    if ((c & 0x80) != 0) {
+        return -1;
+    }
+    auto value = (a << 18) | (b << 12) | (c << 6);
+    output[0] = static_cast<uint8_t>(value >> 16);
+    output[1] = static_cast<uint8_t>(value >> 8);
+    return 2;
+}
+
+/*
+ * The kernels below encode every complete triplet of the input and return the number of bytes
+ * consumed, or decode quads until the first one that is not made of 4 valid non padding characters
+ * and return the number of characters consumed.
+ */
+
+static size_t encodeTripletsScalar(const uint8_t* data, size_t size, char* output) {
+    size_t i = 0;
+    for (; size - i >= 3; i += 3, output += 4) {
+        encodeTriplet(data + i, output);
+    }
+    return i;
+}
+
+static size_t decodeQuadsScalar(const char* input, size_t length, uint8_t* output) {
+    size_t i = 0;
+    for (; length - i >= 4; i += 4, output += 3) {
+        uint32_t a = kDecodingTable[static_cast<uint8_t>(input[i])];
+        uint32_t b = kDecodingTable[static_cast<uint8_t>(input[i + 1])];
+        uint32_t c = kDecodingTable[static_cast<uint8_t>(input[i + 2])];
+        uint32_t d = kDecodingTable[static_cast<uint8_t>(input[i + 3])];
+        if (((a | b | c | d) & 0x80) != 0) {
+            break;
+        }
+        auto value = (a << 18) | (b << 12) | (c << 6) | d;
+        output[0] = static_cast<uint8_t>(value >> 16);
+        output[1] = static_cast<uint8_t>(value >> 8);
+        output[2] = static_cast<uint8_t>(value);
+    }
+    return i;
+}
 
-    std::string result(maxOutSize, '\0');
-    EVP_EncodeBlock(reinterpret_cast<uint8_t*>(result.data()), data, size);
-    result.resize(result.size() - 1); // remove the trailing \0 that EVP_EncodeBlock always writes
+#if SNAP_BASE64_X86_KERNELS
+
+/*
+ * Vectorized Base64 from Wojciech Muła and Daniel Lemire, "Faster Base64 Encoding and Decoding
+ * Using AVX2 Instructions". The AVX2 variants run the same steps on both 128 bits lanes.
+ */
+
+__attribute__((target("ssse3"))) static inline __m128i encodeBlockSSSE3(__m128i input) {
+    // Spread the 12 bytes so that each 32 bits word holds a triplet, then extract the 6 bits indices
+    input = _mm_shuffle_epi8(input, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    auto t0 = _mm_and_si128(input, _mm_set1_epi32(0x0fc0fc00));
+    auto t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    auto t2 = _mm_and_si128(input, _mm_set1_epi32(0x003f03f0));
+    auto t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    auto indices = _mm_or_si128(t1, t3);
+
+    // Map each index to the offset of its range of the alphabet
+    auto ranges = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    auto isUpper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    ranges = _mm_or_si128(ranges, _mm_and_si128(isUpper, _mm_set1_epi8(13)));
+    auto offsets = _mm_shuffle_epi8(_mm_setr_epi8('a' - 26,
+                                                  '0' - 52,
+                                                  '0' - 52,
+                                                  '0' - 52,
+                                                  '0' - 52,
+                                                  '0' - 52,
+                                                  '0' - 52,
+                                                  '0' - 52,
+                                                  '0' - 52,
+                                                  '0' - 52,
+                                                  '0' - 52,
+                                                  '+' - 62,
+                                                  '/' - 63,
+                                                  'A',
+                                                  0,
+                                                  0),
+                                    ranges);
+    return _mm_add_epi8(indices, offsets);
+}
+
+__attribute__((target("ssse3"))) static inline bool decodeBlockSSSE3(__m128i input, __m128i& output) {
+    auto highNibbles = _mm_and_si128(_mm_srli_epi32(input, 4), _mm_set1_epi8(0x0F));
+    auto lowNibbles = _mm_and_si128(input, _mm_set1_epi8(0x0F));
+    auto low = _mm_shuffle_epi8(
+        _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A),
+        lowNibbles);
+    auto high = _mm_shuffle_epi8(
+        _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10),
+        highNibbles);
+    // A character is valid when the bits of its low and high nibbles do not intersect
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(low, high), _mm_setzero_si128())) != 0xFFFF) {
+        return false;
+    }
+
+    auto isSlash = _mm_cmpeq_epi8(input, _mm_set1_epi8('/'));
+    auto offsets = _mm_shuffle_epi8(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0),
+                                    _mm_add_epi8(isSlash, highNibbles));
+    auto values = _mm_add_epi8(input, offsets);
+
+    // Merge the 6 bits values into 24 bits words and pack them
+    auto merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    output = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    return true;
+}
+
+__attribute__((target("ssse3"))) static size_t encodeTripletsSSSE3(const uint8_t* data, size_t size, char* output) {
+    size_t i = 0;
+    // Each block reads 16 bytes and encodes the first 12
+    for (; size - i >= 16; i += 12, output += 16) {
+        auto input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), encodeBlockSSSE3(input));
+    }
+    return i + encodeTripletsScalar(data + i, size - i, output);
+}
+
+__attribute__((target("ssse3"))) static size_t decodeQuadsSSSE3(const char* input, size_t length, uint8_t* output) {
+    size_t i = 0;
+    for (; length - i >= 16; i += 16, output += 12) {
+        __m128i decoded;
+        if (!decodeBlockSSSE3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i)), decoded)) {
+            break;
+        }
+        // Only store the 12 decoded bytes, so that outputs can be sized exactly
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output), decoded);
+        auto last = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(decoded, 8)));
+        std::memcpy(output + 8, &last, sizeof(last));
+    }
+    return i + decodeQuadsScalar(input + i, length - i, output);
+}
+
+__attribute__((target("avx2"))) static inline __m256i broadcast128(__m128i value) {
+    return _mm256_broadcastsi128_si256(value);
+}
+
+__attribute__((target("avx2"))) static inline __m256i encodeBlockAVX2(__m256i input) {
+    input = _mm256_shuffle_epi8(input,
+                                broadcast128(_mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1)));
+    auto t0 = _mm256_and_si256(input, _mm256_set1_epi32(0x0fc0fc00));
+    auto t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    auto t2 = _mm256_and_si256(input, _mm256_set1_epi32(0x003f03f0));
+    auto t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    auto indices = _mm256_or_si256(t1, t3);
+
+    auto ranges = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    auto isUpper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    ranges = _mm256_or_si256(ranges, _mm256_and_si256(isUpper, _mm256_set1_epi8(13)));
+    auto offsets = _mm256_shuffle_epi8(broadcast128(_mm_setr_epi8('a' - 26,
+                                                                  '0' - 52,
+                                                                  '0' - 52,
+                                                                  '0' - 52,
+                                                                  '0' - 52,
+                                                                  '0' - 52,
+                                                                  '0' - 52,
+                                                                  '0' - 52,
+                                                                  '0' - 52,
+                                                                  '0' - 52,
+                                                                  '0' - 52,
+                                                                  '+' - 62,
+                                                                  '/' - 63,
+                                                                  'A',
+                                                                  0,
+                                                                  0)),
+                                       ranges);
+    return _mm256_add_epi8(indices, offsets);
+}
+
+__attribute__((target("avx2"))) static inline bool decodeBlockAVX2(__m256i input, __m256i& output) {
+    auto highNibbles = _mm256_and_si256(_mm256_srli_epi32(input, 4), _mm256_set1_epi8(0x0F));
+    auto lowNibbles = _mm256_and_si256(input, _mm256_set1_epi8(0x0F));
+    auto low = _mm256_shuffle_epi8(
+        broadcast128(_mm_setr_epi8(
+            0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A)),
+        lowNibbles);
+    auto high = _mm256_shuffle_epi8(
+        broadcast128(_mm_setr_epi8(
+            0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10)),
+        highNibbles);
+    if (!_mm256_testz_si256(low, high)) {
+        return false;
+    }
+
+    auto isSlash = _mm256_cmpeq_epi8(input, _mm256_set1_epi8('/'));
+    auto offsets = _mm256_shuffle_epi8(
+        broadcast128(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0)),
+        _mm256_add_epi8(isSlash, highNibbles));
+    auto values = _mm256_add_epi8(input, offsets);
+
+    auto merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+    merged = _mm256_shuffle_epi8(
+        merged, broadcast128(_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)));
+    // Join the 12 bytes of each lane into the first 24 bytes
+    output = _mm256_permutevar8x32_epi32(merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+    return true;
+}
+
+__attribute__((target("avx2"))) static size_t encodeTripletsAVX2(const uint8_t* data, size_t size, char* output) {
+    size_t i = 0;
+    // Each block reads 28 bytes and encodes the first 24, 12 per lane
+    for (; size - i >= 28; i += 24, output += 32) {
+        auto low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        auto high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 12));
+        auto input = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), encodeBlockAVX2(input));
+    }
+    _mm256_zeroupper();
+    // The remaining bytes can still fill a SSSE3 block, SSSE3 being implied by AVX2
+    return i + encodeTripletsSSSE3(data + i, size - i, output);
+}
+
+__attribute__((target("avx2"))) static size_t decodeQuadsAVX2(const char* input, size_t length, uint8_t* output) {
+    size_t i = 0;
+    for (; length - i >= 32; i += 32, output += 24) {
+        __m256i decoded;
+        if (!decodeBlockAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i)), decoded)) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm256_castsi256_si128(decoded));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output + 16), _mm256_extracti128_si256(decoded, 1));
+    }
+    _mm256_zeroupper();
+    return i + decodeQuadsSSSE3(input + i, length - i, output);
+}
+
+#endif
+
+struct Base64Kernels {
+    size_t (*encodeTriplets)(const uint8_t*, size_t, char*);
+    size_t (*decodeQuads)(const char*, size_t, uint8_t*);
+    const char* name;
+};
+
+static Base64Kernels resolveBase64Kernels() {
+#if SNAP_BASE64_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Base64Kernels{&encodeTripletsAVX2, &decodeQuadsAVX2, "avx2"};
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return Base64Kernels{&encodeTripletsSSSE3, &decodeQuadsSSSE3, "ssse3"};
+    }
+#endif
+    return Base64Kernels{&encodeTripletsScalar, &decodeQuadsScalar, "scalar"};
+}
+
+static const Base64Kernels& getBase64Kernels() {
+    static const auto kKernels = resolveBase64Kernels();
+    return kKernels;
+}
+
+const char* getBase64ImplementationName() {
+    return getBase64Kernels().name;
+}
+
+size_t base64EncodedLength(size_t size) {
+    return (size + 2) / 3 * 4;
+}
+
+size_t binaryToBase64(const uint8_t* data, size_t size, char* output) {
+    auto consumed = getBase64Kernels().encodeTriplets(data, size, output);
+    auto written = consumed / 3 * 4;
+    return written + encodeRemainder(data + consumed, size - consumed, output + written);
+}
+
+std::string binaryToBase64(const uint8_t* data, size_t size) {
+    std::string result(base64EncodedLength(size), '\0');
+    binaryToBase64(data, size, result.data());
     return result;
 }
 
@@ -39,25 +374,130 @@ std::string uint64ToBase64(uint64_t data) {
     return binaryToBase64(bytes.data(), bytes.size());
 }
 
-bool base64ToBinaryInternal(const char* encodedString, size_t inSize, std::vector<uint8_t>* ret) {
-    // Strip out newlines since the decoder returns an error code (0) if it finds them within the encoded string.
-    std::string noNewlines(encodedString, inSize);
-    boost::algorithm::replace_all(noNewlines, "\n", "");
-    boost::algorithm::replace_all(noNewlines, "\r", "");
+size_t Base64Encoder::maxEncodedLength(size_t size) {
+    return base64EncodedLength(size);
+}
+
+size_t Base64Encoder::encode(const uint8_t* data, size_t size, char* output) {
+    size_t written = 0;
+    if (_pendingSize > 0) {
+        auto toCopy = std::min(size, _pending.size() - _pendingSize);
+        std::memcpy(_pending.data() + _pendingSize, data, toCopy);
+        _pendingSize += toCopy;
+        data += toCopy;
+        size -= toCopy;
+        if (_pendingSize < _pending.size()) {
+            return 0;
+        }
+
+        encodeTriplet(_pending.data(), output);
+        _pendingSize = 0;
+        written += 4;
+    }
+
+    auto consumed = getBase64Kernels().encodeTriplets(data, size, output + written);
+    written += consumed / 3 * 4;
+
+    _pendingSize = size - consumed;
+    std::memcpy(_pending.data(), data + consumed, _pendingSize);
+
+    return written;
+}
+
+size_t Base64Encoder::finish(char* output) {
+    auto written = encodeRemainder(_pending.data(), _pendingSize, output);
+    _pendingSize = 0;
+    return written;
+}
+
+size_t Base64Decoder::maxDecodedLength(size_t length) {
+    // Up to 3 characters may be pending from the previous chunk
+    return (length + 3) / 4 * 3;
+}
 
-    // Determine the max array length we'll need given the string length
-    size_t maxOutSize = 0;
-    if (EVP_DecodedLength(&maxOutSize, noNewlines.length()) != 1 || maxOutSize == 0) {
+bool Base64Decoder::decode(std::string_view chunk, uint8_t* output, size_t* outputSize) {
+    *outputSize = 0;
+    if (_failed) {
         return false;
     }
 
-    ret->resize(maxOutSize);
+    const auto* input = chunk.data();
+    auto length = chunk.size();
+    size_t i = 0;
+    size_t written = 0;
+
+    while (i < length) {
+        if (_pendingSize == 0 && !_padded) {
+            auto consumed = getBase64Kernels().decodeQuads(input + i, length - i, output + written);
+            i += consumed;
+            written += consumed / 4 * 3;
+            if (i == length) {
+                break;
+            }
+        }
+
+        // The kernels stopped on a newline, a padding or invalid character, or a quad split by a newline
+        // or by the end of the chunk, which are handled one character at a time.
+        auto c = input[i++];
+        if (c == '\n' || c == '\r') {
+            continue;
+        }
+        if (_padded) {
+            // Only newlines can follow the padding
+            _failed = true;
+            break;
+        }
+
+        _pending[_pendingSize++] = c;
+        if (_pendingSize == _pending.size()) {
+            auto decoded = decodeQuad(_pending.data(), output + written);
+            if (decoded < 0) {
+                _failed = true;
+                break;
+            }
+            written += static_cast<size_t>(decoded);
+            _pendingSize = 0;
+            _padded = decoded != 3;
+        }
+    }
+
+    *outputSize = written;
+    return !_failed;
+}
+
+bool Base64Decoder::finish() const {
+    return !_failed && _pendingSize == 0;
+}
+
+size_t base64DecodedMaxLength(size_t length) {
+    return length / 4 * 3;
+}
+
+size_t base64DecodedMaxLength(std::string_view base64) {
+    auto length = base64DecodedMaxLength(base64.size());
+    // Inputs made of complete quads cannot decode past their padding. Otherwise they are either invalid,
+    // or contain newlines and therefore decode to at least one quad less.
+    if (base64.size() % 4 == 0 && length > 0) {
+        if (base64[base64.size() - 1] == '=') {
+            length--;
+            if (base64[base64.size() - 2] == '=') {
+                length--;
+            }
+        }
+    }
+    return length;
+}
+
+bool base64ToBinary(std::string_view base64, uint8_t* output, size_t* outputSize) {
+    Base64Decoder decoder;
+    // A valid non empty input always produces at least one byte
+    return decoder.decode(base64, output, outputSize) && decoder.finish() && *outputSize > 0;
+}
+
+static bool base64ToBinaryInternal(const char* encodedString, size_t inSize, std::vector<uint8_t>* ret) {
+    ret->resize(base64DecodedMaxLength(std::string_view(encodedString, inSize)));
     size_t outSize = 0;
-    if (EVP_DecodeBase64(reinterpret_cast<uint8_t*>(ret->data()),
-                         &outSize,
-                         maxOutSize,
-                         reinterpret_cast<const uint8_t*>(noNewlines.c_str()),
-                         noNewlines.length()) != 1) {
+    if (!base64ToBinary(std::string_view(encodedString, inSize), ret->data(), &outSize)) {
         // make it empty to indicate error
         ret->resize(0);
         return false;
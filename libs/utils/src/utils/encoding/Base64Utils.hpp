@@ -1,6 +1,10 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace snap::utils::encoding {
@@ -43,6 +47,134 @@ std::vector<uint8_t> base64ToBinary(std::string_view base64);
  */
 bool base64ToBinary(std::string_view base64, std::vector<uint8_t>& decoded);
 
+/**
+ * @brief Returns the number of characters needed to Base64 encode |size| bytes, padding included.
+ */
+size_t base64EncodedLength(size_t size);
+
+/**
+ * @brief Base64 encode the uint8_t buffer into |output|, which must be able to hold
+ * base64EncodedLength(size) characters. No null terminator is written.
+ * Returns the number of characters written.
+ */
+size_t binaryToBase64(const uint8_t* data, size_t size, char* output);
+
+/**
+ * @brief Returns the maximum number of bytes that decoding a Base64 string of |length|
+ * characters can produce.
+ */
+size_t base64DecodedMaxLength(size_t length);
+
+/**
+ * @brief Returns the maximum number of bytes that decoding the Base64 string can produce,
+ * taking its padding into account. This is the exact decoded size for valid strings without newlines.
+ */
+size_t base64DecodedMaxLength(std::string_view base64);
+
+/**
+ * @brief Base64 decode the string into |output|, which must be able to hold
+ * base64DecodedMaxLength(base64) bytes, and store the number of decoded bytes in |outputSize|.
+ * Newlines within the string are skipped.
+ * Returns false if failed to decode.
+ */
+bool base64ToBinary(std::string_view base64, uint8_t* output, size_t* outputSize);
+
+/**
+ * @brief Base64 encode the uint8_t buffer and append the result to |output|, without going
+ * through an intermediate string. |output| can be any container of bytes or chars providing
+ * size(), resize() and data(), like std::string, std::vector<uint8_t> or Valdi::ByteBuffer.
+ */
+template<typename Output>
+void appendBinaryToBase64(const uint8_t* data, size_t size, Output& output) {
+    auto offset = output.size();
+    output.resize(offset + base64EncodedLength(size));
+    binaryToBase64(data, size, reinterpret_cast<char*>(output.data()) + offset);
+}
+
+/**
+ * @brief Base64 decode the string and append the resulting bytes to |output|, which has the
+ * same requirements as in appendBinaryToBase64(). Newlines within the string are skipped.
+ * Returns false if failed to decode, in which case |output| is left with the bytes decoded
+ * before the error.
+ */
+template<typename Output>
+bool appendBase64ToBinary(std::string_view base64, Output& output) {
+    auto offset = output.size();
+    output.resize(offset + base64DecodedMaxLength(base64));
+    size_t decodedSize = 0;
+    auto success = base64ToBinary(base64, reinterpret_cast<uint8_t*>(output.data()) + offset, &decodedSize);
+    if (offset + decodedSize != output.size()) {
+        output.resize(offset + decodedSize);
+    }
+    return success;
+}
+
+/**
+ * @brief Base64 encoder for data provided in chunks, like large blobs read from disk.
+ * The characters written by the successive calls to encode() followed by finish() form
+ * the Base64 encoding of the concatenated chunks.
+ */
+class Base64Encoder {
+public:
+    /**
+     * @brief Returns the maximum number of characters written by encode() for a chunk of |size| bytes.
+     */
+    static size_t maxEncodedLength(size_t size);
+
+    /**
+     * @brief Encode the chunk into |output|, which must be able to hold maxEncodedLength(size)
+     * characters. Up to 2 bytes are kept for the next chunk.
+     * Returns the number of characters written.
+     */
+    size_t encode(const uint8_t* data, size_t size, char* output);
+
+    /**
+     * @brief Encode the bytes kept from the previous chunks with padding into |output|,
+     * which must be able to hold 4 characters. Returns the number of characters written.
+     */
+    size_t finish(char* output);
+
+private:
+    std::array<uint8_t, 3> _pending;
+    size_t _pendingSize = 0;
+};
+
+/**
+ * @brief Base64 decoder for strings provided in chunks, which accepts the same inputs as
+ * base64ToBinary() once the chunks are concatenated. Newlines are skipped.
+ */
+class Base64Decoder {
+public:
+    /**
+     * @brief Returns the maximum number of bytes written by decode() for a chunk of |length| characters.
+     */
+    static size_t maxDecodedLength(size_t length);
+
+    /**
+     * @brief Decode the chunk into |output|, which must be able to hold maxDecodedLength(chunk.size())
+     * bytes, and store the number of decoded bytes in |outputSize|. Up to 3 characters are kept for the
+     * next chunk.
+     * Returns false if the chunk is not valid Base64, after which all calls fail.
+     */
+    bool decode(std::string_view chunk, uint8_t* output, size_t* outputSize);
+
+    /**
+     * @brief Returns whether all the chunks were valid Base64 and ended on a complete quad.
+     */
+    bool finish() const;
+
+private:
+    std::array<char, 4> _pending;
+    size_t _pendingSize = 0;
+    bool _padded = false;
+    bool _failed = false;
+};
+
+/**
+ * @brief Returns the name of the Base64 implementation selected for this CPU.
+ */
+const char* getBase64ImplementationName();
+
 /**
  * @brief Base64 decode the string and store the first 8-bytes of the result in the
  * returned uint64_t. If the result is more than 8-bytes then it will be truncated.
@@ -0,0 +1,126 @@
+#include "snap_drawing/cpp/Drawing/DisplayList/DisplayList.hpp"
+#include "snap_drawing/cpp/Drawing/Raster/RasterContext.hpp"
+#include "snap_drawing/cpp/Utils/Bitmap.hpp"
+
+#include "valdi_core/cpp/Utils/ConsoleLogger.hpp"
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkMaskFilter.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkRRect.h"
+
+#include "benchmark/benchmark.h"
+
+using namespace snap::drawing;
+
+static constexpr int kBitmapWidth = 1080;
+static constexpr int kBitmapHeight = 1920;
+static constexpr int kCellsPerRow = 4;
+static constexpr int kCellsPerColumn = 12;
+
+/**
+ Records a feed cell made of a blurred shadow, rounded rects, an avatar circle,
+ placeholder text lines and a stroked path, which are typical CPU raster costs.
+ */
+static sk_sp<SkPicture> makeCellPicture(Scalar width, Scalar height) {
+    SkPictureRecorder recorder;
+    auto* canvas = recorder.beginRecording(SkRect::MakeWH(width, height));
+
+    SkPaint shadowPaint;
+    shadowPaint.setAntiAlias(true);
+    shadowPaint.setColor(SkColorSetARGB(80, 0, 0, 0));
+    shadowPaint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 6.0f));
+    canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(10, 12, width - 20, height - 20), 16, 16), shadowPaint);
+
+    SkPaint cardPaint;
+    cardPaint.setAntiAlias(true);
+    cardPaint.setColor(SK_ColorWHITE);
+    canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(8, 8, width - 16, height - 20), 16, 16), cardPaint);
+
+    SkPaint avatarPaint;
+    avatarPaint.setAntiAlias(true);
+    avatarPaint.setColor(SkColorSetARGB(255, 255, 252, 0));
+    canvas->drawCircle(40, 40, 22, avatarPaint);
+
+    SkPaint textPaint;
+    textPaint.setAntiAlias(true);
+    textPaint.setColor(SkColorSetARGB(200, 40, 40, 40));
+    for (int i = 0; i < 5; i++) {
+        auto lineWidth = (width - 90) * (1.0f - 0.12f * static_cast<Scalar>(i % 3));
+        canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(72, 22.5f + i * 18.5f, lineWidth, 9.5f), 4, 4),
+                          textPaint);
+    }
+
+    SkPath path;
+    path.moveTo(16, height - 30);
+    path.cubicTo(width * 0.3f, height - 60, width * 0.6f, height, width - 16, height - 34);
+    SkPaint strokePaint;
+    strokePaint.setAntiAlias(true);
+    strokePaint.setStyle(SkPaint::kStroke_Style);
+    strokePaint.setStrokeWidth(3.5f);
+    strokePaint.setColor(SkColorSetARGB(255, 0, 120, 255));
+    canvas->drawPath(path, strokePaint);
+
+    return recorder.finishRecordingAsPicture();
+}
+
+static Ref<DisplayList> makeFeedDisplayList() {
+    auto cellWidth = static_cast<Scalar>(kBitmapWidth) / kCellsPerRow;
+    auto cellHeight = static_cast<Scalar>(kBitmapHeight) / kCellsPerColumn;
+    auto picture = makeCellPicture(cellWidth, cellHeight);
+
+    auto displayList = Valdi::makeShared<DisplayList>(
+        Size::make(static_cast<Scalar>(kBitmapWidth), static_cast<Scalar>(kBitmapHeight)), TimePoint(0.0));
+    uint64_t layerId = 0;
+    for (int row = 0; row < kCellsPerColumn; row++) {
+        for (int column = 0; column < kCellsPerRow; column++) {
+            displayList->pushContext(Matrix::makeScaleTranslate(1, 1, column * cellWidth, row * cellHeight),
+                                     1.0f,
+                                     ++layerId,
+                                     true);
+            displayList->appendPicture(picture.get(), 1.0f);
+            displayList->popContext();
+        }
+    }
+
+    return displayList;
+}
+
+/**
+ Arguments are the number of worker threads, 0 meaning single threaded, and the tile size.
+ */
+static void RasterContextFullRaster(benchmark::State& state) {
+    auto threadsCount = static_cast<size_t>(state.range(0));
+    auto tileSize = static_cast<int>(state.range(1));
+
+    auto rasterContext = Valdi::makeShared<RasterContext>(
+        Valdi::ConsoleLogger::getLogger(), ExternalSurfaceRasterizationMethod::ACCURATE, false);
+    rasterContext->setTiledRasterization(tileSize, threadsCount);
+
+    auto bitmap = Bitmap::make(Valdi::BitmapInfo(kBitmapWidth,
+                                                 kBitmapHeight,
+                                                 Valdi::ColorType::ColorTypeRGBA8888,
+                                                 Valdi::AlphaType::AlphaTypePremul,
+                                                 kBitmapWidth * 4))
+                      .moveValue();
+    auto displayList = makeFeedDisplayList();
+
+    for (auto _ : state) {
+        auto result = rasterContext->raster(displayList, bitmap, true);
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kBitmapWidth * kBitmapHeight);
+}
+
+BENCHMARK(RasterContextFullRaster)
+    ->Args({0, 0})
+    ->Args({1, RasterContext::kDefaultTileSize})
+    ->Args({2, RasterContext::kDefaultTileSize})
+    ->Args({4, RasterContext::kDefaultTileSize})
+    ->Args({8, RasterContext::kDefaultTileSize})
+    ->Args({4, 128})
+    ->Args({4, 512})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
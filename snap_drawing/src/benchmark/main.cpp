@@ -1,11 +1,16 @@
+#include "snap_drawing/cpp/Layers/TextLayer.hpp"
 #include "snap_drawing/cpp/Text/FontManager.hpp"
 #include "snap_drawing/cpp/Text/TextLayoutBuilder.hpp"
+#include "snap_drawing/cpp/Text/TextLayoutCache.hpp"
 
 #include "valdi_core/cpp/Utils/ConsoleLogger.hpp"
 #include "valdi_core/cpp/Utils/Function.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
 
 #include "benchmark/benchmark.h"
 
+#include <cmath>
+
 using namespace snap::drawing;
 
 static void doBenchmark(benchmark::State& state, Valdi::Function<void(const Ref<FontManager>&)>&& benchmarkFn) {
@@ -93,9 +98,160 @@ static void TextLayoutArabicText(benchmark::State& state) {
     });
 }
 
+static const Ref<FontManager>& getSharedFontManager() {
+    static auto kFontManager = []() {
+        auto fontManager = Valdi::makeShared<FontManager>(Valdi::ConsoleLogger::getLogger(), true);
+        fontManager->load();
+        return fontManager;
+    }();
+    return kFontManager;
+}
+
+static std::string makeWord(size_t index) {
+    std::string word;
+    do {
+        word += static_cast<char>('a' + index % 26);
+        index /= 26;
+    } while (index != 0);
+    return word;
+}
+
+/**
+ Lays out a paragraph of the given words count from multiple threads sharing the same FontManager,
+ like measurement on the main thread and drawing on the render thread would.
+ When uniqueWords is set, every thread lays out words which were never shaped before,
+ which exercises the cache miss path.
+ */
+static void doMultiThreadedBenchmark(benchmark::State& state, bool uniqueWords) {
+    const auto& fontManager = getSharedFontManager();
+    auto font = fontManager->getDefaultFont().moveValue();
+
+    constexpr size_t kWordsCount = 32;
+    size_t wordIndex = static_cast<size_t>(state.thread_index()) * 1000000;
+
+    std::string text;
+    for (auto _ : state) {
+        text.clear();
+        for (size_t i = 0; i < kWordsCount; i++) {
+            text += makeWord(uniqueWords ? wordIndex++ : i);
+            text += ' ';
+        }
+
+        TextLayoutBuilder builder(TextAlignLeft, TextOverflowEllipsis, Size::make(200, 5000), 0, fontManager, false);
+        builder.append(text, font, 1.0f, 0.0f, TextDecorationNone);
+
+        benchmark::DoNotOptimize(builder.build());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kWordsCount));
+}
+
+static void TextLayoutMultiThreadedCachedWords(benchmark::State& state) {
+    doMultiThreadedBenchmark(state, false);
+}
+
+static void TextLayoutMultiThreadedUniqueWords(benchmark::State& state) {
+    doMultiThreadedBenchmark(state, true);
+}
+
+/**
+ Measures a screen of labels and then lays them out for drawing at their measured size, like a TextLayer
+ does after its text was measured by the layout pass. Arg 0 measures and draws without the TextLayoutCache,
+ arg 1 reuses the measured layouts through the cache.
+ */
+static void TextLayoutMeasureThenDraw(benchmark::State& state) {
+    const auto& fontManager = getSharedFontManager();
+    auto font = fontManager->getDefaultFont().moveValue();
+    auto textLayoutCache =
+        state.range(0) == 0 ? nullptr : Valdi::makeShared<TextLayoutCache>(TextLayoutCache::kDefaultMaxSizeBytes);
+
+    constexpr size_t kLabelsCount = 64;
+    std::vector<Valdi::StringBox> texts;
+    for (size_t i = 0; i < kLabelsCount; i++) {
+        std::string text;
+        for (size_t j = 0; j < 4 + i % 12; j++) {
+            text += makeWord(i * 16 + j);
+            text += ' ';
+        }
+        texts.emplace_back(Valdi::StringCache::getGlobal().makeString(text));
+    }
+
+    for (auto _ : state) {
+        if (textLayoutCache != nullptr) {
+            // Every iteration lays out texts which were not measured before
+            textLayoutCache->clear();
+        }
+
+        for (const auto& text : texts) {
+            auto measuredSize = TextLayer::measureText(Size::make(600, 5000),
+                                                       text,
+                                                       nullptr,
+                                                       font,
+                                                       TextAlignLeft,
+                                                       TextDecorationNone,
+                                                       TextOverflowEllipsis,
+                                                       0,
+                                                       1.0f,
+                                                       0.0f,
+                                                       false,
+                                                       false,
+                                                       0.0,
+                                                       false,
+                                                       1.0f,
+                                                       1.0f,
+                                                       fontManager,
+                                                       textLayoutCache);
+
+            auto frameSize = Size::make(std::ceil(measuredSize.width), std::ceil(measuredSize.height));
+
+            Ref<TextLayout> textLayout;
+            if (textLayoutCache != nullptr) {
+                TextLayoutCacheKey key;
+                key.text = text;
+                key.font = font;
+                key.numberOfLines = 0;
+                textLayout = textLayoutCache->find(key, frameSize);
+            }
+
+            if (textLayout == nullptr) {
+                textLayout = TextLayer::makeTextLayout(frameSize,
+                                                       text,
+                                                       nullptr,
+                                                       font,
+                                                       TextAlignLeft,
+                                                       TextDecorationNone,
+                                                       TextOverflowEllipsis,
+                                                       0,
+                                                       1.0f,
+                                                       0.0f,
+                                                       false,
+                                                       false,
+                                                       0.0,
+                                                       false,
+                                                       /* includeTextBlob */ true,
+                                                       1.0f,
+                                                       1.0f,
+                                                       fontManager);
+            }
+
+            benchmark::DoNotOptimize(textLayout);
+        }
+    }
+
+    if (textLayoutCache != nullptr) {
+        auto metrics = textLayoutCache->getMetrics();
+        state.counters["hitRate"] = metrics.getHitRate();
+        state.counters["cacheBytes"] = static_cast<double>(metrics.sizeBytes);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kLabelsCount));
+}
+
 BENCHMARK(TextLayoutSimpleTextSingleLine)->Arg(0)->Arg(1)->Arg(2);
 BENCHMARK(TextLayoutLongTextSingleLine)->Arg(0)->Arg(1)->Arg(2);
 BENCHMARK(TextLayoutLongTextMultiLine)->Arg(0)->Arg(1)->Arg(2);
 BENCHMARK(TextLayoutEmojiText)->Arg(0)->Arg(1)->Arg(2);
 BENCHMARK(TextLayoutArabicText)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK(TextLayoutMultiThreadedCachedWords)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(TextLayoutMultiThreadedUniqueWords)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(TextLayoutMeasureThenDraw)->Arg(0)->Arg(1);
 BENCHMARK_MAIN();
@@ -44,4 +44,15 @@ void BoxShadow::draw(DrawingContext& drawingContext, const BorderRadius& borderR
     drawingContext.drawPaint(_paint, borderRadius, drawBounds, _lazyPath);
 }
 
+Rect BoxShadow::getBounds(const Rect& drawBounds) const {
+    auto shadowBounds = drawBounds.makeOffset(_offset.width, _offset.height);
+    // The blur is a gaussian with a sigma of blurAmount * 2, which is visible up to 3 sigmas
+    auto blurExtent = _blurAmount * 6;
+
+    return Rect::makeLTRB(shadowBounds.left - blurExtent,
+                          shadowBounds.top - blurExtent,
+                          shadowBounds.right + blurExtent,
+                          shadowBounds.bottom + blurExtent);
+}
+
 } // namespace snap::drawing
@@ -29,6 +29,12 @@ public:
 
     void draw(DrawingContext& drawingContext, const BorderRadius& borderRadius);
 
+    /**
+     Returns the area covered by the shadow when drawn for the given bounds,
+     including the offset and the blur.
+     */
+    Rect getBounds(const Rect& drawBounds) const;
+
 private:
     Size _offset = Size::makeEmpty();
     Color _color = Color::transparent();
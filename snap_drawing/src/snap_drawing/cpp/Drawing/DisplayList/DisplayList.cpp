@@ -205,8 +205,11 @@ static void prepareCanvas(SkCanvas* canvas, Scalar scaleX, Scalar scaleY, bool s
 
 void DisplayList::draw(
     DrawableSurfaceCanvas& canvas, size_t planeIndex, Scalar scaleX, Scalar scaleY, bool shouldClearCanvas) const {
-    auto* skiaCanvas = canvas.getSkiaCanvas();
+    draw(canvas.getSkiaCanvas(), planeIndex, scaleX, scaleY, shouldClearCanvas);
+}
 
+void DisplayList::draw(
+    SkCanvas* skiaCanvas, size_t planeIndex, Scalar scaleX, Scalar scaleY, bool shouldClearCanvas) const {
     auto saveCount = skiaCanvas->save();
 
     prepareCanvas(skiaCanvas, scaleX, scaleY, shouldClearCanvas);
@@ -25,6 +25,8 @@
 
 #include <vector>
 
+class SkCanvas;
+
 namespace snap::drawing {
 
 class DrawableSurfaceCanvas;
@@ -79,6 +81,11 @@ public:
 
     void draw(DrawableSurfaceCanvas& canvas, size_t planeIndex, bool shouldClearCanvas = true) const;
 
+    /**
+     Draw the given plane into an arbitrary Skia canvas, like a picture recording canvas.
+     */
+    void draw(SkCanvas* canvas, size_t planeIndex, Scalar scaleX, Scalar scaleY, bool shouldClearCanvas) const;
+
     template<typename Visitor>
     void visitOperations(size_t planeIndex, Visitor& visitor) const {
         if (planeIndex == kDisplayListAllPlaneIndexes) {
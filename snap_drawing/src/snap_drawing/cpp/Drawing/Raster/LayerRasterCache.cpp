@@ -0,0 +1,115 @@
+#include "snap_drawing/cpp/Drawing/Raster/LayerRasterCache.hpp"
+
+namespace snap::drawing {
+
+double LayerRasterCache::Metrics::getHitRate() const {
+    auto total = hits + misses;
+    if (total == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(hits) / static_cast<double>(total);
+}
+
+LayerRasterCache::Entry::Entry(const void* owner, Scalar rasterScale, const LayerContent& content, size_t bytes)
+    : owner(owner), rasterScale(rasterScale), content(content), bytes(bytes) {}
+
+LayerRasterCache::Entry::~Entry() = default;
+
+LayerRasterCache::LayerRasterCache(size_t maxBytes) : _maxBytes(maxBytes) {}
+
+LayerRasterCache::~LayerRasterCache() = default;
+
+std::optional<LayerContent> LayerRasterCache::find(const void* owner, Scalar rasterScale) {
+    std::lock_guard<Valdi::Mutex> lock(_mutex);
+    const auto& it = _entryByOwner.find(owner);
+    if (it == _entryByOwner.end() || it->second->rasterScale != rasterScale) {
+        _misses++;
+        return std::nullopt;
+    }
+
+    _hits++;
+    auto entry = it->second;
+    _entries.pushFront(entry);
+
+    return entry->content;
+}
+
+bool LayerRasterCache::canStore(size_t bytes) const {
+    std::lock_guard<Valdi::Mutex> lock(_mutex);
+    return bytes <= _maxBytes;
+}
+
+void LayerRasterCache::insert(const void* owner, Scalar rasterScale, const LayerContent& content, size_t bytes) {
+    std::lock_guard<Valdi::Mutex> lock(_mutex);
+    const auto& it = _entryByOwner.find(owner);
+    if (it != _entryByOwner.end()) {
+        auto previousEntry = it->second;
+        removeEntry(previousEntry);
+    }
+
+    if (bytes > _maxBytes) {
+        return;
+    }
+
+    trimToSize(_maxBytes - bytes);
+
+    auto entry = Valdi::makeShared<Entry>(owner, rasterScale, content, bytes);
+    _entryByOwner[owner] = entry;
+    _entries.pushFront(entry);
+    _usedBytes += bytes;
+}
+
+void LayerRasterCache::remove(const void* owner) {
+    std::lock_guard<Valdi::Mutex> lock(_mutex);
+    const auto& it = _entryByOwner.find(owner);
+    if (it != _entryByOwner.end()) {
+        auto entry = it->second;
+        removeEntry(entry);
+    }
+}
+
+void LayerRasterCache::clear() {
+    std::lock_guard<Valdi::Mutex> lock(_mutex);
+    _entryByOwner.clear();
+    _entries.clear();
+    _usedBytes = 0;
+}
+
+void LayerRasterCache::setMaxBytes(size_t maxBytes) {
+    std::lock_guard<Valdi::Mutex> lock(_mutex);
+    _maxBytes = maxBytes;
+    trimToSize(maxBytes);
+}
+
+size_t LayerRasterCache::getMaxBytes() const {
+    std::lock_guard<Valdi::Mutex> lock(_mutex);
+    return _maxBytes;
+}
+
+LayerRasterCache::Metrics LayerRasterCache::getMetrics() const {
+    std::lock_guard<Valdi::Mutex> lock(_mutex);
+    Metrics metrics;
+    metrics.hits = _hits;
+    metrics.misses = _misses;
+    metrics.evictions = _evictions;
+    metrics.entriesCount = _entryByOwner.size();
+    metrics.usedBytes = _usedBytes;
+    metrics.maxBytes = _maxBytes;
+    return metrics;
+}
+
+void LayerRasterCache::removeEntry(const Ref<Entry>& entry) {
+    _entryByOwner.erase(entry->owner);
+    _entries.remove(_entries.iterator(entry));
+    _usedBytes -= entry->bytes;
+}
+
+void LayerRasterCache::trimToSize(size_t maxBytes) {
+    while (_usedBytes > maxBytes && !_entries.empty()) {
+        auto entry = _entries.tail();
+        removeEntry(entry);
+        _evictions++;
+    }
+}
+
+} // namespace snap::drawing
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "snap_drawing/cpp/Drawing/LayerContent.hpp"
+#include "snap_drawing/cpp/Utils/Scalar.hpp"
+#include "valdi_core/cpp/Utils/FlatMap.hpp"
+#include "valdi_core/cpp/Utils/LinkedList.hpp"
+#include "valdi_core/cpp/Utils/Mutex.hpp"
+#include <optional>
+
+namespace snap::drawing {
+
+/**
+LayerRasterCache holds the rasterized subtrees of layers which have shouldRasterize enabled.
+Each entry is a LayerContent which draws the rasterized bitmap of the layer, keyed by the layer
+that owns it. The total size of the bitmaps is bounded by a byte budget, the least recently used
+entries are evicted when inserting an entry would go above the budget.
+ */
+class LayerRasterCache : public Valdi::SimpleRefCountable {
+public:
+    static constexpr size_t kDefaultMaxBytes = 32 * 1024 * 1024;
+
+    struct Metrics {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+        size_t entriesCount = 0;
+        size_t usedBytes = 0;
+        size_t maxBytes = 0;
+
+        double getHitRate() const;
+    };
+
+    explicit LayerRasterCache(size_t maxBytes);
+    ~LayerRasterCache() override;
+
+    /**
+    Returns the rasterized content of the given owner if it was rasterized at the given scale.
+     */
+    std::optional<LayerContent> find(const void* owner, Scalar rasterScale);
+
+    /**
+    Returns whether an entry of the given size can be stored without going above the budget
+    once all the other entries are evicted.
+     */
+    bool canStore(size_t bytes) const;
+
+    void insert(const void* owner, Scalar rasterScale, const LayerContent& content, size_t bytes);
+
+    void remove(const void* owner);
+
+    void clear();
+
+    void setMaxBytes(size_t maxBytes);
+    size_t getMaxBytes() const;
+
+    Metrics getMetrics() const;
+
+private:
+    class Entry : public Valdi::LinkedListNode {
+    public:
+        Entry(const void* owner, Scalar rasterScale, const LayerContent& content, size_t bytes);
+        ~Entry() override;
+
+        const void* owner;
+        Scalar rasterScale;
+        LayerContent content;
+        size_t bytes;
+    };
+
+    mutable Valdi::Mutex _mutex;
+    Valdi::FlatMap<const void*, Ref<Entry>> _entryByOwner;
+    Valdi::LinkedList<Entry> _entries;
+    size_t _maxBytes;
+    size_t _usedBytes = 0;
+    size_t _hits = 0;
+    size_t _misses = 0;
+    size_t _evictions = 0;
+
+    void removeEntry(const Ref<Entry>& entry);
+    void trimToSize(size_t maxBytes);
+};
+
+} // namespace snap::drawing
@@ -13,9 +13,11 @@
 #include "valdi_core/cpp/Interfaces/IBitmap.hpp"
 #include "valdi_core/cpp/Interfaces/IBitmapFactory.hpp"
 #include "valdi_core/cpp/Interfaces/ILogger.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
 #include "valdi_core/cpp/Utils/Trace.hpp"
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 
 // These come from Skia SkBlitRow.h .
 // We use them for blending rows. They are highly optimized under the hood,
@@ -233,6 +235,42 @@ Valdi::Result<RasterContext::RasterResult> RasterContext::doRasterDelta(const Co
                                                                         const Valdi::BitmapInfo& bitmapInfo,
                                                                         const std::vector<Rect>& damageRects,
                                                                         size_t rasterId) {
+    RasterResult output;
+    output.renderedPixelsCount = 0;
+
+    for (const auto& damageRect : damageRects) {
+        output.renderedPixelsCount +=
+            static_cast<size_t>(damageRect.width()) * static_cast<size_t>(damageRect.height());
+    }
+
+    if (damageRects.empty()) {
+        return output;
+    }
+
+    auto externalSurfaceImages =
+        rasterExternalSurfaces(*compositionResult.displayList, compositionResult.planeList, bitmapInfo, rasterId);
+    if (!externalSurfaceImages) {
+        return externalSurfaceImages.moveError();
+    }
+
+    auto [workerPool, tileSize] = getTiledRasterization(bitmapInfo);
+    if (workerPool != nullptr) {
+        auto result = doRasterTiled(workerPool,
+                                    tileSize,
+                                    bitmap,
+                                    *compositionResult.displayList,
+                                    compositionResult.planeList,
+                                    externalSurfaceImages.value(),
+                                    bitmapInfo,
+                                    &damageRects,
+                                    true);
+        if (!result) {
+            return result.moveError();
+        }
+
+        return output;
+    }
+
     BitmapGraphicsContext graphicsContext;
     auto surface = graphicsContext.createBitmapSurface(bitmap);
 
@@ -241,26 +279,20 @@ Valdi::Result<RasterContext::RasterResult> RasterContext::doRasterDelta(const Co
         return canvas.moveError();
     }
 
-    RasterResult output;
-    output.renderedPixelsCount = 0;
-
     for (const auto& damageRect : damageRects) {
         VALDI_TRACE("SnapDrawing.rasterContext.rasterDeltaInRect");
         auto* skiaCanvas = canvas.value().getSkiaCanvas();
         auto saveCount = skiaCanvas->save();
         skiaCanvas->clipRect(damageRect.getSkValue());
 
-        auto doRasterResult = doRaster(
-            canvas.value(), *compositionResult.displayList, compositionResult.planeList, bitmapInfo, true, rasterId);
+        doRaster(canvas.value(),
+                 *compositionResult.displayList,
+                 compositionResult.planeList,
+                 externalSurfaceImages.value(),
+                 bitmapInfo,
+                 true);
 
         skiaCanvas->restoreToCount(saveCount);
-
-        if (!doRasterResult) {
-            return doRasterResult.moveError();
-        }
-
-        output.renderedPixelsCount +=
-            static_cast<size_t>(damageRect.width()) * static_cast<size_t>(damageRect.height());
     }
 
     surface->flush();
@@ -275,6 +307,24 @@ Valdi::Result<Valdi::Void> RasterContext::rasterNonDelta(const Ref<Valdi::IBitma
                                                          bool shouldClearBitmapBeforeDrawing,
                                                          size_t rasterId) {
     VALDI_TRACE("SnapDrawing.rasterContext.rasterNonDelta");
+    auto externalSurfaceImages = rasterExternalSurfaces(displayList, planeList, bitmapInfo, rasterId);
+    if (!externalSurfaceImages) {
+        return externalSurfaceImages.moveError();
+    }
+
+    auto [workerPool, tileSize] = getTiledRasterization(bitmapInfo);
+    if (workerPool != nullptr) {
+        return doRasterTiled(workerPool,
+                             tileSize,
+                             bitmap,
+                             displayList,
+                             planeList,
+                             externalSurfaceImages.value(),
+                             bitmapInfo,
+                             nullptr,
+                             shouldClearBitmapBeforeDrawing);
+    }
+
     BitmapGraphicsContext graphicsContext;
     auto surface = graphicsContext.createBitmapSurface(bitmap);
 
@@ -283,20 +333,144 @@ Valdi::Result<Valdi::Void> RasterContext::rasterNonDelta(const Ref<Valdi::IBitma
         return canvas.moveError();
     }
 
-    auto doRasterResult =
-        doRaster(canvas.value(), displayList, planeList, bitmapInfo, shouldClearBitmapBeforeDrawing, rasterId);
+    doRaster(canvas.value(),
+             displayList,
+             planeList,
+             externalSurfaceImages.value(),
+             bitmapInfo,
+             shouldClearBitmapBeforeDrawing);
 
     surface->flush();
 
-    return doRasterResult;
+    return Valdi::Void();
 }
 
-Valdi::Result<Valdi::Void> RasterContext::doRaster(DrawableSurfaceCanvas& canvas,
-                                                   const DisplayList& displayList,
-                                                   const CompositorPlaneList& planeList,
-                                                   const Valdi::BitmapInfo& bitmapInfo,
-                                                   bool shouldClearBitmapBeforeDrawing,
-                                                   size_t rasterId) {
+Valdi::Result<Valdi::Void> RasterContext::doRasterTiled(const Ref<Valdi::ParallelWorkerPool>& workerPool,
+                                                        int tileSize,
+                                                        const Ref<Valdi::IBitmap>& bitmap,
+                                                        const DisplayList& displayList,
+                                                        const CompositorPlaneList& planeList,
+                                                        const std::vector<Ref<Image>>& externalSurfaceImages,
+                                                        const Valdi::BitmapInfo& bitmapInfo,
+                                                        const std::vector<Rect>* damageRects,
+                                                        bool shouldClearBitmapBeforeDrawing) {
+    VALDI_TRACE("SnapDrawing.rasterContext.rasterTiled");
+
+    // The clip rects to raster for each tile. When delta rasterizing, those are the
+    // intersections of the tile with the damage rects, processed in the same order
+    // as the single threaded path so that overlapping damage rects resolve the same way.
+    std::vector<std::vector<Rect>> tiles;
+    for (int y = 0; y < bitmapInfo.height; y += tileSize) {
+        for (int x = 0; x < bitmapInfo.width; x += tileSize) {
+            auto tileRect = Rect::makeXYWH(static_cast<Scalar>(x),
+                                           static_cast<Scalar>(y),
+                                           static_cast<Scalar>(std::min(tileSize, bitmapInfo.width - x)),
+                                           static_cast<Scalar>(std::min(tileSize, bitmapInfo.height - y)));
+
+            std::vector<Rect> clipRects;
+            if (damageRects == nullptr) {
+                clipRects.emplace_back(tileRect);
+            } else {
+                for (const auto& damageRect : *damageRects) {
+                    if (tileRect.intersects(damageRect)) {
+                        clipRects.emplace_back(tileRect.intersection(damageRect));
+                    }
+                }
+            }
+
+            if (!clipRects.empty()) {
+                tiles.emplace_back(std::move(clipRects));
+            }
+        }
+    }
+
+    auto* bytes = bitmap->lockBytes();
+    if (bytes == nullptr) {
+        return Valdi::Error("Failed to lock bytes");
+    }
+
+    std::vector<std::optional<Valdi::Error>> errors(tiles.size());
+
+    workerPool->run(tiles.size(), [&](size_t tileIndex) {
+        VALDI_TRACE("SnapDrawing.rasterContext.rasterTile");
+        // Each tile draws into the full bitmap with a clip, so that the coordinates and
+        // therefore the produced pixels are the same as when drawing without tiles.
+        BitmapGraphicsContext graphicsContext;
+        auto surface = graphicsContext.createBitmapSurface(bitmapInfo, bytes);
+
+        auto canvas = surface->prepareCanvas();
+        if (!canvas) {
+            errors[tileIndex] = canvas.moveError();
+            return;
+        }
+
+        auto* skiaCanvas = canvas.value().getSkiaCanvas();
+        for (const auto& clipRect : tiles[tileIndex]) {
+            auto saveCount = skiaCanvas->save();
+            skiaCanvas->clipRect(clipRect.getSkValue());
+
+            doRaster(canvas.value(),
+                     displayList,
+                     planeList,
+                     externalSurfaceImages,
+                     bitmapInfo,
+                     shouldClearBitmapBeforeDrawing);
+
+            skiaCanvas->restoreToCount(saveCount);
+        }
+
+        surface->flush();
+    });
+
+    bitmap->unlockBytes();
+
+    for (auto& error : errors) {
+        if (error) {
+            return std::move(error.value());
+        }
+    }
+
+    return Valdi::Void();
+}
+
+Valdi::Result<std::vector<Ref<Image>>> RasterContext::rasterExternalSurfaces(const DisplayList& displayList,
+                                                                             const CompositorPlaneList& planeList,
+                                                                             const Valdi::BitmapInfo& bitmapInfo,
+                                                                             size_t rasterId) {
+    std::vector<Ref<Image>> images;
+
+    for (const auto& plane : planeList) {
+        if (plane.getType() != CompositorPlaneTypeExternal) {
+            continue;
+        }
+
+        auto rasterScaleX = bitmapInfo.width / displayList.getSize().width;
+        auto rasterScaleY = bitmapInfo.height / displayList.getSize().height;
+        const auto& presenterState = *plane.getExternalSurfacePresenterState();
+
+        auto rasterImage = getOrCreateRasterImageForExternalSurfaceSnapshot(plane.getExternalSurfaceSnapshot(),
+                                                                            presenterState.frame,
+                                                                            presenterState.transform,
+                                                                            bitmapInfo,
+                                                                            rasterScaleX,
+                                                                            rasterScaleY,
+                                                                            rasterId);
+        if (!rasterImage) {
+            return rasterImage.moveError();
+        }
+
+        images.emplace_back(rasterImage.moveValue());
+    }
+
+    return images;
+}
+
+void RasterContext::doRaster(DrawableSurfaceCanvas& canvas,
+                             const DisplayList& displayList,
+                             const CompositorPlaneList& planeList,
+                             const std::vector<Ref<Image>>& externalSurfaceImages,
+                             const Valdi::BitmapInfo& bitmapInfo,
+                             bool shouldClearBitmapBeforeDrawing) {
     if (shouldClearBitmapBeforeDrawing) {
         Paint paint;
         paint.setColor(Color::transparent());
@@ -305,6 +479,7 @@ Valdi::Result<Valdi::Void> RasterContext::doRaster(DrawableSurfaceCanvas& canvas
     }
 
     size_t drawablePlaneIndex = 0;
+    size_t externalPlaneIndex = 0;
     for (const auto& plane : planeList) {
         switch (plane.getType()) {
             case CompositorPlaneTypeDrawable:
@@ -315,17 +490,8 @@ Valdi::Result<Valdi::Void> RasterContext::doRaster(DrawableSurfaceCanvas& canvas
                 auto rasterScaleX = bitmapInfo.width / displayList.getSize().width;
                 auto rasterScaleY = bitmapInfo.height / displayList.getSize().height;
                 const auto& presenterState = *plane.getExternalSurfacePresenterState();
-
-                auto rasterImage = getOrCreateRasterImageForExternalSurfaceSnapshot(plane.getExternalSurfaceSnapshot(),
-                                                                                    presenterState.frame,
-                                                                                    presenterState.transform,
-                                                                                    bitmapInfo,
-                                                                                    rasterScaleX,
-                                                                                    rasterScaleY,
-                                                                                    rasterId);
-                if (!rasterImage) {
-                    return rasterImage.moveError();
-                }
+                const auto& rasterImage = externalSurfaceImages[externalPlaneIndex];
+                externalPlaneIndex++;
 
                 auto* skiaCanvas = canvas.getSkiaCanvas();
                 auto saveCount = skiaCanvas->save();
@@ -339,14 +505,36 @@ Valdi::Result<Valdi::Void> RasterContext::doRaster(DrawableSurfaceCanvas& canvas
                 Paint paint;
                 paint.setAntiAlias(true);
                 paint.setAlpha(presenterState.opacity);
-                skiaCanvas->drawImage(
-                    rasterImage.value()->getSkValue(), 0, 0, SkSamplingOptions(), &paint.getSkValue());
+                skiaCanvas->drawImage(rasterImage->getSkValue(), 0, 0, SkSamplingOptions(), &paint.getSkValue());
                 skiaCanvas->restoreToCount(saveCount);
             } break;
         }
     }
+}
 
-    return Valdi::Void();
+void RasterContext::setTiledRasterization(int tileSize, size_t threadsCount) {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    if (tileSize <= 0 || threadsCount == 0) {
+        _workerPool = nullptr;
+        return;
+    }
+
+    _tileSize = tileSize;
+    if (_workerPool == nullptr || _workerPool->getThreadsCount() != threadsCount) {
+        _workerPool = Valdi::makeShared<Valdi::ParallelWorkerPool>(
+            STRING_LITERAL("SnapDrawing Raster"), Valdi::ThreadQoSClassHigh, threadsCount);
+    }
+}
+
+std::pair<Ref<Valdi::ParallelWorkerPool>, int> RasterContext::getTiledRasterization(
+    const Valdi::BitmapInfo& bitmapInfo) const {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    if (_workerPool == nullptr || (bitmapInfo.width <= _tileSize && bitmapInfo.height <= _tileSize)) {
+        // Nothing to parallelize
+        return std::make_pair(nullptr, 0);
+    }
+
+    return std::make_pair(_workerPool, _tileSize);
 }
 
 void RasterContext::removeUnusedCachedRasterizedExternalSurfaces(size_t rasterId) {
@@ -4,6 +4,7 @@
 #include "snap_drawing/cpp/Drawing/Raster/RasterDamageResolver.hpp"
 #include "snap_drawing/cpp/Drawing/Surface/ExternalSurfacePresenterState.hpp"
 #include "snap_drawing/cpp/Utils/Aliases.hpp"
+#include "valdi_core/cpp/Threading/ParallelWorkerPool.hpp"
 #include "valdi_core/cpp/Utils/Result.hpp"
 #include <mutex>
 #include <vector>
@@ -53,6 +54,11 @@ avoid re-rasterizing external surfaces for each frame if they don't change.
 
 If "enableDeltaRasterization" is true, all the raster operations will be delta rasterized, with the
 RasterContext keeping a bitmap cache of the last raster pass.
+
+If tiled rasterization is enabled, the bitmap is split into square tiles which are rasterized
+in parallel on a pool of worker threads, each tile replaying the display list with a clip.
+In delta mode, only the parts of the tiles that intersect the damage rects are rasterized.
+The output is pixel-identical to the single threaded path.
  */
 class RasterContext : public Valdi::SimpleRefCountable {
 public:
@@ -75,6 +81,15 @@ public:
      */
     Valdi::Result<RasterResult> rasterDelta(const Ref<DisplayList>& displayList, const Ref<Valdi::IBitmap>& bitmap);
 
+    /**
+    Enable tiled rasterization, using tiles of tileSize x tileSize pixels rasterized by
+    threadsCount worker threads alongside the calling thread. Passing a threadsCount
+    of 0 or a tileSize of 0 disables tiled rasterization.
+     */
+    void setTiledRasterization(int tileSize, size_t threadsCount);
+
+    static constexpr int kDefaultTileSize = 256;
+
 private:
     struct CachedRasterizedExternalSurface {
         Ref<Image> image;
@@ -97,15 +112,34 @@ private:
     Ref<Valdi::IBitmap> _lastBitmap;
     RasterDamageResolver _rasterDamageResolver;
     bool _deltaRasterizationEnabled;
+    int _tileSize = kDefaultTileSize;
+    Ref<Valdi::ParallelWorkerPool> _workerPool;
 
     CompositionResult performCompositionIfNeeded(const Ref<DisplayList>& displayList) const;
 
-    Valdi::Result<Valdi::Void> doRaster(DrawableSurfaceCanvas& canvas,
-                                        const DisplayList& displayList,
-                                        const CompositorPlaneList& planeList,
-                                        const Valdi::BitmapInfo& bitmapInfo,
-                                        bool shouldClearBitmapBeforeDrawing,
-                                        size_t rasterId);
+    Valdi::Result<std::vector<Ref<Image>>> rasterExternalSurfaces(const DisplayList& displayList,
+                                                                  const CompositorPlaneList& planeList,
+                                                                  const Valdi::BitmapInfo& bitmapInfo,
+                                                                  size_t rasterId);
+
+    static void doRaster(DrawableSurfaceCanvas& canvas,
+                         const DisplayList& displayList,
+                         const CompositorPlaneList& planeList,
+                         const std::vector<Ref<Image>>& externalSurfaceImages,
+                         const Valdi::BitmapInfo& bitmapInfo,
+                         bool shouldClearBitmapBeforeDrawing);
+
+    Valdi::Result<Valdi::Void> doRasterTiled(const Ref<Valdi::ParallelWorkerPool>& workerPool,
+                                             int tileSize,
+                                             const Ref<Valdi::IBitmap>& bitmap,
+                                             const DisplayList& displayList,
+                                             const CompositorPlaneList& planeList,
+                                             const std::vector<Ref<Image>>& externalSurfaceImages,
+                                             const Valdi::BitmapInfo& bitmapInfo,
+                                             const std::vector<Rect>* damageRects,
+                                             bool shouldClearBitmapBeforeDrawing);
+
+    std::pair<Ref<Valdi::ParallelWorkerPool>, int> getTiledRasterization(const Valdi::BitmapInfo& bitmapInfo) const;
 
     Valdi::Result<RasterResult> doRasterDelta(const CompositionResult& compositionResult,
                                               const Ref<Valdi::IBitmap>& bitmap,
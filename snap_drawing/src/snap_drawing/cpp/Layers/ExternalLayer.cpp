@@ -82,4 +82,8 @@ void ExternalLayer::onDraw(DrawingContext& drawingContext) {
     }
 }
 
+bool ExternalLayer::drawsExternalSurface() const {
+    return _externalSurface != nullptr && !shouldRasterizeExternalSurface();
+}
+
 } // namespace snap::drawing
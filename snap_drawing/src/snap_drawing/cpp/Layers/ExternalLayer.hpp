@@ -30,6 +30,7 @@ public:
 
 protected:
     void onDraw(DrawingContext& drawingContext) override;
+    bool drawsExternalSurface() const override;
 
 private:
     Ref<ExternalSurface> _externalSurface;
@@ -12,15 +12,20 @@
 
 #include "utils/debugging/Assert.hpp"
 
+#include "valdi_core/cpp/Utils/LoggerUtils.hpp"
 #include "valdi_core/cpp/Utils/StringCache.hpp"
+#include "valdi_core/cpp/Utils/Trace.hpp"
 
 #include "snap_drawing/cpp/Animations/Animation.hpp"
 
 #include "snap_drawing/cpp/Drawing/BoxShadow.hpp"
 #include "snap_drawing/cpp/Drawing/DisplayList/DisplayList.hpp"
+#include "snap_drawing/cpp/Drawing/GraphicsContext/BitmapGraphicsContext.hpp"
+#include "snap_drawing/cpp/Drawing/Raster/LayerRasterCache.hpp"
 #include "snap_drawing/cpp/Drawing/LinearGradient.hpp"
 #include "snap_drawing/cpp/Utils/GradientWrapper.hpp"
 
+#include <cmath>
 #include <iostream>
 
 namespace snap::drawing {
@@ -35,6 +40,10 @@ Layer::~Layer() {
     for (const auto& gestureRecognizer : _gestureRecognizers.readAccess()) {
         gestureRecognizer->setLayer(nullptr);
     }
+
+    if (_shouldRasterize) {
+        _resources->getLayerRasterCache()->remove(this);
+    }
 }
 
 void Layer::onInitialize() {}
@@ -51,7 +60,7 @@ void Layer::draw(DisplayList& displayList, DrawMetrics& metrics) {
 
     if (_matrixDirty) {
         _matrixDirty = false;
-        updateMatrix(width, height);
+        _matrix = computeMatrix(width, height);
 
         metrics.matrixCacheMiss++;
     }
@@ -73,8 +82,25 @@ void Layer::draw(DisplayList& displayList, DrawMetrics& metrics) {
         _layerId = _root->allocateLayerId();
     }
 
-    displayList.pushContext(_matrix, resolvedContextOpacity, _layerId, _needsDisplay);
+    if (!_shouldRasterize ||
+        !drawRasterized(displayList, metrics, width, height, resolvedContextOpacity, resolvedPictureOpacity)) {
+        displayList.pushContext(_matrix, resolvedContextOpacity, _layerId, _needsDisplay);
+        drawLayerContents(displayList, metrics, width, height, resolvedPictureOpacity);
+        displayList.popContext();
+    }
+
+    if (_needsDisplay) {
+        _needsDisplay = false;
+        metrics.drawCacheMiss++;
+    }
+
+    _childNeedsDisplay = false;
+    _descendantNeedsDisplay = false;
+    _isDrawing = false;
+}
 
+void Layer::drawLayerContents(
+    DisplayList& displayList, DrawMetrics& metrics, Scalar width, Scalar height, Scalar resolvedPictureOpacity) {
     if (_needsDisplay) {
         drawBackground(width, height);
         drawContent(width, height);
@@ -122,20 +148,178 @@ void Layer::draw(DisplayList& displayList, DrawMetrics& metrics) {
     if (!_cachedForeground.isEmpty()) {
         displayList.appendLayerContent(_cachedForeground, resolvedPictureOpacity);
     }
+}
 
-    if (_needsDisplay) {
-        _needsDisplay = false;
-        metrics.drawCacheMiss++;
+bool Layer::drawRasterized(DisplayList& displayList,
+                           DrawMetrics& metrics,
+                           Scalar width,
+                           Scalar height,
+                           Scalar resolvedContextOpacity,
+                           Scalar resolvedPictureOpacity) {
+    auto subtreeChanged = _needsDisplay || _descendantNeedsDisplay;
+    if (_rasterizationUnsupported && !subtreeChanged) {
+        return false;
     }
 
-    _childNeedsDisplay = false;
-    _isDrawing = false;
+    const auto& rasterCache = _resources->getLayerRasterCache();
+    auto rasterScale = _resources->getDisplayScale();
+
+    std::optional<LayerContent> rasterizedContent;
+    if (!subtreeChanged) {
+        rasterizedContent = rasterCache->find(this, rasterScale);
+    }
+
+    auto hasUpdates = !rasterizedContent.has_value();
+    if (rasterizedContent) {
+        metrics.rasterCacheHit++;
+    } else {
+        // Checked before visiting the subtree, so that it is drawn only once when falling back
+        if (!subtreeDrawsExternalSurface()) {
+            rasterizedContent = rasterize(displayList.getFrameTime(), metrics, width, height, rasterScale);
+        }
+
+        _rasterizationUnsupported = !rasterizedContent.has_value();
+        if (_rasterizationUnsupported) {
+            return false;
+        }
+
+        metrics.rasterCacheMiss++;
+    }
 
+    displayList.pushContext(_matrix, resolvedContextOpacity, _layerId, hasUpdates);
+    displayList.appendLayerContent(rasterizedContent.value(), resolvedPictureOpacity);
     displayList.popContext();
+
+    return true;
+}
+
+std::optional<LayerContent> Layer::rasterize(
+    TimePoint frameTime, DrawMetrics& metrics, Scalar width, Scalar height, Scalar rasterScale) {
+    auto rasterBounds = computeRasterBounds();
+    auto bitmapWidth = static_cast<int>(std::ceil(rasterBounds.width() * rasterScale));
+    auto bitmapHeight = static_cast<int>(std::ceil(rasterBounds.height() * rasterScale));
+    if (bitmapWidth <= 0 || bitmapHeight <= 0) {
+        return std::nullopt;
+    }
+
+    auto bitmapInfo = Valdi::BitmapInfo(bitmapWidth,
+                                        bitmapHeight,
+                                        Valdi::ColorType::ColorTypeRGBA8888,
+                                        Valdi::AlphaType::AlphaTypePremul,
+                                        static_cast<size_t>(bitmapWidth) * 4);
+    const auto& rasterCache = _resources->getLayerRasterCache();
+    if (!rasterCache->canStore(bitmapInfo.bytesLength())) {
+        return std::nullopt;
+    }
+
+    VALDI_TRACE("SnapDrawing.rasterizeLayer");
+
+    // Draw the subtree with the origin of the raster bounds at 0,0
+    auto subtreeDisplayList = Valdi::makeShared<DisplayList>(rasterBounds.size(), frameTime);
+    subtreeDisplayList->pushContext(
+        Matrix::makeScaleTranslate(1.0f, 1.0f, -rasterBounds.left, -rasterBounds.top), 1.0f, _layerId, true);
+    drawLayerContents(*subtreeDisplayList, metrics, width, height, 1.0f);
+    subtreeDisplayList->popContext();
+
+    // From here on the subtree was visited, so we always return a content holding it.
+    SkPictureRecorder recorder;
+    auto* recordingCanvas = recorder.beginRecording(rasterBounds.getSkValue());
+
+    BitmapGraphicsContext graphicsContext;
+    auto surface = graphicsContext.createBitmapSurface(bitmapInfo);
+    auto canvas = surface->prepareCanvas();
+    std::optional<Ref<Image>> image;
+    if (canvas) {
+        subtreeDisplayList->draw(canvas.value(), 0, rasterScale, rasterScale, true);
+        auto snapshot = canvas.value().snapshot();
+        surface->flush();
+        if (snapshot) {
+            image = snapshot.moveValue();
+        }
+    }
+
+    if (!image) {
+        VALDI_ERROR(getLogger(), "Failed to rasterize layer, drawing its subtree without caching it");
+        recordingCanvas->translate(rasterBounds.left, rasterBounds.top);
+        subtreeDisplayList->draw(recordingCanvas, 0, 1.0f, 1.0f, false);
+        return LayerContent(recorder.finishRecordingAsPicture(), nullptr);
+    }
+
+    auto targetRect = Rect::makeXYWH(rasterBounds.left,
+                                     rasterBounds.top,
+                                     static_cast<Scalar>(bitmapWidth) / rasterScale,
+                                     static_cast<Scalar>(bitmapHeight) / rasterScale);
+    recordingCanvas->drawImageRect(
+        image.value()->getSkValue(), targetRect.getSkValue(), SkSamplingOptions(SkFilterMode::kLinear), nullptr);
+
+    LayerContent rasterizedContent(recorder.finishRecordingAsPicture(), nullptr);
+    rasterCache->insert(this, rasterScale, rasterizedContent, bitmapInfo.bytesLength());
+
+    return rasterizedContent;
+}
+
+Rect Layer::computeRasterBounds() const {
+    auto bounds = Rect::makeXYWH(0, 0, _frame.width(), _frame.height());
+    auto rasterBounds = bounds;
+
+    if (_boxShadow != nullptr) {
+        rasterBounds.join(_boxShadow->getBounds(bounds));
+    }
+
+    if (_borderWidth != 0) {
+        // Borders are stroked on the edges of the bounds
+        auto halfBorderWidth = _borderWidth / 2;
+        rasterBounds.join(Rect::makeLTRB(bounds.left - halfBorderWidth,
+                                         bounds.top - halfBorderWidth,
+                                         bounds.right + halfBorderWidth,
+                                         bounds.bottom + halfBorderWidth));
+    }
+
+    if (!_clipsToBounds) {
+        auto children = _children.readAccess();
+        for (const auto& child : *children) {
+            if (!child->isVisible()) {
+                continue;
+            }
+
+            // The child resolves its own matrix when it gets drawn
+            auto childMatrix = child->_matrix;
+            if (child->_matrixDirty) {
+                childMatrix = child->computeMatrix(child->_frame.width(), child->_frame.height());
+            }
+
+            rasterBounds.join(childMatrix.mapRect(child->computeRasterBounds()));
+        }
+    }
+
+    // Snap to whole points so that the bitmap pixels stay aligned with the layer
+    return Rect::makeLTRB(std::floor(rasterBounds.left),
+                          std::floor(rasterBounds.top),
+                          std::ceil(rasterBounds.right),
+                          std::ceil(rasterBounds.bottom));
+}
+
+bool Layer::subtreeDrawsExternalSurface() const {
+    if (drawsExternalSurface()) {
+        return true;
+    }
+
+    auto children = _children.readAccess();
+    for (const auto& child : *children) {
+        if (child->isVisible() && child->subtreeDrawsExternalSurface()) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 void Layer::onDraw(DrawingContext& drawingContext) {}
 
+bool Layer::drawsExternalSurface() const {
+    return false;
+}
+
 void Layer::drawContent(Scalar width, Scalar height) {
     DrawingContext drawingContext(width, height);
 
@@ -212,6 +396,8 @@ void Layer::insertChild(const Valdi::Ref<Layer>& childLayer, size_t index) {
 
     childLayer->onParentChanged(Valdi::strongSmallRef(this));
 
+    _descendantNeedsDisplay = true;
+    _rasterizationUnsupported = false;
     setChildNeedsDisplay();
 
     onChildInserted(childLayer.get(), index);
@@ -245,6 +431,8 @@ void Layer::removeChild(Layer* childLayer, bool shouldNotify) {
         if (shouldNotify) {
             onChildRemoved(childLayer);
         }
+        _descendantNeedsDisplay = true;
+        _rasterizationUnsupported = false;
         setChildNeedsDisplay();
     }
 }
@@ -321,8 +509,8 @@ Ref<Layer> Layer::getLayerAtPoint(const Point& point) {
     return Valdi::strongSmallRef(this);
 }
 
-void Layer::updateMatrix(Scalar width, Scalar height) {
-    _matrix.setIdentity();
+Matrix Layer::computeMatrix(Scalar width, Scalar height) const {
+    Matrix matrix;
 
     auto scaledWidth = width;
     auto scaledHeight = height;
@@ -334,24 +522,26 @@ void Layer::updateMatrix(Scalar width, Scalar height) {
         scaledWidth *= _scaleX;
 
         translationX += (width - scaledWidth) / 2.0f;
-        _matrix.setScaleX(_scaleX);
+        matrix.setScaleX(_scaleX);
     }
 
     if (_scaleY != 1.0f) {
         scaledHeight *= _scaleY;
 
         translationY += (height - scaledHeight) / 2.0f;
-        _matrix.setScaleY(_scaleY);
+        matrix.setScaleY(_scaleY);
     }
 
-    _matrix.setTranslateX(_frame.left + translationX);
-    _matrix.setTranslateY(_frame.top + translationY);
+    matrix.setTranslateX(_frame.left + translationX);
+    matrix.setTranslateY(_frame.top + translationY);
 
     if (_rotation != 0.0f) {
-        Scalar centerX = _matrix.getTranslateX() + scaledWidth / 2.0f;
-        Scalar centerY = _matrix.getTranslateY() + scaledHeight / 2.0f;
-        _matrix.postRotate(_rotation, centerX, centerY);
+        Scalar centerX = matrix.getTranslateX() + scaledWidth / 2.0f;
+        Scalar centerY = matrix.getTranslateY() + scaledHeight / 2.0f;
+        matrix.postRotate(_rotation, centerX, centerY);
     }
+
+    return matrix;
 }
 
 void Layer::setTouchAreaExtension(Scalar left, Scalar right, Scalar top, Scalar bottom) {
@@ -570,6 +760,12 @@ void Layer::requestFocus(ILayer* layer) {
 void Layer::notifyParentSetChildNeedsDisplay() {
     auto parent = _parent.lock();
     if (parent != nullptr) {
+        // Unlike setChildNeedsDisplay(), which is also called when the transform of the layer itself
+        // changes, this tracks changes coming from descendants, which invalidate the rasterized subtree.
+        auto parentLayer = Valdi::castOrNull<Layer>(parent);
+        if (parentLayer != nullptr) {
+            parentLayer->_descendantNeedsDisplay = true;
+        }
         parent->setChildNeedsDisplay();
     }
 }
@@ -1140,4 +1336,22 @@ const Valdi::StringBox& Layer::getAccessibilityId() const {
     return _accessibilityId;
 }
 
+void Layer::setShouldRasterize(bool shouldRasterize) {
+    if (_shouldRasterize != shouldRasterize) {
+        _shouldRasterize = shouldRasterize;
+        _rasterizationUnsupported = false;
+        _descendantNeedsDisplay = true;
+
+        if (!shouldRasterize) {
+            _resources->getLayerRasterCache()->remove(this);
+        }
+
+        setChildNeedsDisplay();
+    }
+}
+
+bool Layer::shouldRasterize() const {
+    return _shouldRasterize;
+}
+
 } // namespace snap::drawing
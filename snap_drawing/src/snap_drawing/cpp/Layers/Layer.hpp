@@ -28,6 +28,7 @@
 #include "snap_drawing/cpp/Utils/LazyPath.hpp"
 #include "snap_drawing/cpp/Utils/Matrix.hpp"
 #include "snap_drawing/cpp/Utils/SafeContainer.hpp"
+#include "snap_drawing/cpp/Utils/TimePoint.hpp"
 
 #include <optional>
 #include <string>
@@ -65,6 +66,8 @@ struct DrawMetrics {
     int drawCacheMiss = 0;
     int matrixCacheMiss = 0;
     int visitedLayers = 0;
+    int rasterCacheHit = 0;
+    int rasterCacheMiss = 0;
 };
 
 template<typename T, typename std::enable_if<std::is_convertible<T*, ILayer*>::value, int>::type = 0, typename... Args>
@@ -141,6 +144,17 @@ public:
     void setAccessibilityId(const Valdi::StringBox& accessibilityId);
     const Valdi::StringBox& getAccessibilityId() const;
 
+    /**
+     When enabled, the layer and its subtree are flattened into a bitmap at the display scale,
+     which is re-used across frames until the layer or one of its descendants needs display.
+     Changing the transform or opacity of the layer itself does not invalidate the bitmap.
+     Bitmaps are stored in the LayerRasterCache from the Resources, which evicts the least
+     recently used ones when going above its byte budget. Subtrees containing external
+     surfaces are drawn normally.
+     */
+    void setShouldRasterize(bool shouldRasterize);
+    bool shouldRasterize() const;
+
     virtual bool hitTest(const Point& point) const;
     Ref<Layer> getLayerAtPoint(const Point& point);
 
@@ -240,6 +254,12 @@ protected:
 
     virtual std::string_view getClassName() const;
 
+    /**
+     Returns whether the layer draws an ExternalSurface, which is composited separately
+     and prevents its ancestors from being rasterized.
+     */
+    virtual bool drawsExternalSurface() const;
+
 private:
     Ref<Resources> _resources;
     SafeContainer<std::vector<Valdi::Ref<Layer>>> _children;
@@ -283,6 +303,9 @@ private:
     bool _visualFrameDirty = true;
     bool _matrixDirty = true;
     bool _isRightToLeft = false;
+    bool _shouldRasterize = false;
+    bool _descendantNeedsDisplay = true;
+    bool _rasterizationUnsupported = false;
     std::optional<EventId> _enqueuedFrame;
     Valdi::StringBox _accessibilityId;
 
@@ -293,6 +316,22 @@ private:
     void removeFromParent(bool shouldNotify);
     void removeChild(Layer* childLayer, bool shouldNotify);
 
+    void drawLayerContents(DisplayList& displayList,
+                           DrawMetrics& metrics,
+                           Scalar width,
+                           Scalar height,
+                           Scalar resolvedPictureOpacity);
+    bool drawRasterized(DisplayList& displayList,
+                        DrawMetrics& metrics,
+                        Scalar width,
+                        Scalar height,
+                        Scalar resolvedContextOpacity,
+                        Scalar resolvedPictureOpacity);
+    std::optional<LayerContent> rasterize(
+        TimePoint frameTime, DrawMetrics& metrics, Scalar width, Scalar height, Scalar rasterScale);
+    Rect computeRasterBounds() const;
+    bool subtreeDrawsExternalSurface() const;
+
     void drawBackground(Scalar width, Scalar height);
     void drawContent(Scalar width, Scalar height);
     void drawForeground(Scalar width, Scalar height);
@@ -301,7 +340,7 @@ private:
 
     void notifyParentSetChildNeedsDisplay();
 
-    void updateMatrix(Scalar width, Scalar height);
+    Matrix computeMatrix(Scalar width, Scalar height) const;
 
     void scheduleProcessAnimationsIfNeeded();
     bool cancelProcessAnimations();
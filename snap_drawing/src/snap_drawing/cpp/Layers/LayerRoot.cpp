@@ -114,10 +114,13 @@ Ref<DisplayList> LayerRoot::draw() {
     auto elapsed = sw.elapsed();
     if (elapsed.milliseconds() >= kFrameWarningThresholdMs) {
         VALDI_WARN(_resources->getLogger(),
-                   "Spent {} to render frame (draw cache hit {}, draw cache miss {})",
+                   "Spent {} to render frame (draw cache hit {}, draw cache miss {}, raster cache hit {}, raster "
+                   "cache miss {})",
                    elapsed.toString(),
                    metrics.visitedLayers - metrics.drawCacheMiss,
-                   metrics.drawCacheMiss);
+                   metrics.drawCacheMiss,
+                   metrics.rasterCacheHit,
+                   metrics.rasterCacheMiss);
     }
 
     return displayList;
@@ -14,6 +14,7 @@
 #include "include/core/SkMaskFilter.h"
 #include "include/effects/SkGradientShader.h"
 #include "snap_drawing/cpp/Text/FontManager.hpp"
+#include "snap_drawing/cpp/Text/TextLayoutCache.hpp"
 #include "snap_drawing/cpp/Text/TextLayoutBuilder.hpp"
 #include "snap_drawing/cpp/Touches/AttributedTextOnTapGestureRecognizer.hpp"
 #include "snap_drawing/cpp/Utils/GradientWrapper.hpp"
@@ -378,30 +379,52 @@ TextLayout& TextLayer::getTextLayout(Size size, bool respectDynamicType, Scalar
     // Align maxSize to pixel grid
     auto maxSize = Size::make(ceilf(size.width * displayScale), ceilf(size.height * displayScale));
 
-    if (_textLayout != nullptr && (_textLayout->getMaxSize() != maxSize)) {
+    if (_textLayout != nullptr && !TextLayoutCache::isCompatible(*_textLayout, _textAlign, maxSize)) {
         _textLayout = nullptr;
     }
 
     if (_textLayout == nullptr) {
-        VALDI_TRACE("SnapDrawing.makeTextLayout");
-        _textLayout = TextLayer::makeTextLayout(maxSize,
-                                                _text,
-                                                _attributedText,
-                                                _textFont,
-                                                _textAlign,
-                                                _textDecoration,
-                                                _textOverflow,
-                                                _numberOfLines,
-                                                _lineHeightMultiple,
-                                                _letterSpacing,
-                                                isRightToLeft(),
-                                                _adjustsFontSizeToFitWidth,
-                                                _minimumScaleFactor,
-                                                respectDynamicType,
-                                                /* includeTextBlob*/ true,
-                                                displayScale,
-                                                dynamicTypeScale,
-                                                getResources()->getFontManager());
+        // The layout is usually already in the cache from when the text was measured
+        const auto& textLayoutCache = getResources()->getTextLayoutCache();
+        auto cacheKey = makeTextLayoutCacheKey(_text,
+                                               _attributedText,
+                                               _textFont,
+                                               _textAlign,
+                                               _textDecoration,
+                                               _textOverflow,
+                                               _numberOfLines,
+                                               _lineHeightMultiple,
+                                               _letterSpacing,
+                                               isRightToLeft(),
+                                               _adjustsFontSizeToFitWidth,
+                                               _minimumScaleFactor,
+                                               respectDynamicType,
+                                               displayScale,
+                                               dynamicTypeScale);
+        _textLayout = textLayoutCache->find(cacheKey, maxSize);
+
+        if (_textLayout == nullptr) {
+            VALDI_TRACE("SnapDrawing.makeTextLayout");
+            _textLayout = TextLayer::makeTextLayout(maxSize,
+                                                    _text,
+                                                    _attributedText,
+                                                    _textFont,
+                                                    _textAlign,
+                                                    _textDecoration,
+                                                    _textOverflow,
+                                                    _numberOfLines,
+                                                    _lineHeightMultiple,
+                                                    _letterSpacing,
+                                                    isRightToLeft(),
+                                                    _adjustsFontSizeToFitWidth,
+                                                    _minimumScaleFactor,
+                                                    respectDynamicType,
+                                                    /* includeTextBlob*/ true,
+                                                    displayScale,
+                                                    dynamicTypeScale,
+                                                    getResources()->getFontManager());
+            textLayoutCache->insert(cacheKey, _textLayout);
+        }
 
         if (hasOnTapAttributeInTextLayout(*_textLayout)) {
             addOnTapGestureRecognizer();
@@ -413,6 +436,40 @@ TextLayout& TextLayer::getTextLayout(Size size, bool respectDynamicType, Scalar
     return *_textLayout;
 }
 
+TextLayoutCacheKey TextLayer::makeTextLayoutCacheKey(const String& text,
+                                                     const Ref<AttributedText>& attributedText,
+                                                     const Ref<Font>& font,
+                                                     TextAlign textAlign,
+                                                     TextDecoration textDecoration,
+                                                     TextOverflow textOverflow,
+                                                     int numberOfLines,
+                                                     Scalar lineHeightMultiple,
+                                                     Scalar letterSpacing,
+                                                     bool isRightToLeft,
+                                                     bool adjustsFontSizeToFitWidth,
+                                                     double minimumScaleFactor,
+                                                     bool respectDynamicType,
+                                                     Scalar displayScale,
+                                                     Scalar dynamicTypeScale) {
+    TextLayoutCacheKey key;
+    key.text = text;
+    key.attributedText = attributedText;
+    key.font = font;
+    key.textAlign = textAlign;
+    key.textDecoration = textDecoration;
+    key.textOverflow = textOverflow;
+    key.numberOfLines = numberOfLines;
+    key.lineHeightMultiple = lineHeightMultiple;
+    key.letterSpacing = letterSpacing;
+    key.isRightToLeft = isRightToLeft;
+    key.adjustsFontSizeToFitWidth = adjustsFontSizeToFitWidth;
+    key.minimumScaleFactor = minimumScaleFactor;
+    key.respectDynamicType = respectDynamicType;
+    key.displayScale = displayScale;
+    key.dynamicTypeScale = dynamicTypeScale;
+    return key;
+}
+
 void TextLayer::removeOnTapGestureRecognizer() {
     if (_attributedTextOnTapGestureRecognizer != nullptr) {
         removeGestureRecognizer(_attributedTextOnTapGestureRecognizer);
@@ -452,7 +509,35 @@ Size TextLayer::measureText(Size maxSize,
                             bool respectDynamicType,
                             Scalar displayScale,
                             Scalar dynamicTypeScale,
-                            const Ref<FontManager>& fontManager) {
+                            const Ref<FontManager>& fontManager,
+                            const Ref<TextLayoutCache>& textLayoutCache) {
+    // The key holds the parameters the layout is built with, so that a layer drawing with different
+    // ones, like a center aligned text which is always measured as left aligned, doesn't reuse it
+    TextLayoutCacheKey cacheKey;
+    if (textLayoutCache != nullptr) {
+        cacheKey = makeTextLayoutCacheKey(text,
+                                          attributedText,
+                                          font,
+                                          textAlign,
+                                          textDecoration,
+                                          textOverflow,
+                                          numberOfLines,
+                                          lineHeightMultiple,
+                                          letterSpacing,
+                                          isRightToLeft,
+                                          adjustsFontSizeToFitWidth,
+                                          minimumScaleFactor,
+                                          respectDynamicType,
+                                          displayScale,
+                                          dynamicTypeScale);
+
+        auto cachedTextLayout = textLayoutCache->find(cacheKey, maxSize);
+        if (cachedTextLayout != nullptr) {
+            return cachedTextLayout->getBounds().size();
+        }
+    }
+
+    // The text blobs are only needed when the layout can be reused for drawing
     auto textLayout = makeTextLayout(maxSize,
                                      text,
                                      attributedText,
@@ -467,11 +552,15 @@ Size TextLayer::measureText(Size maxSize,
                                      adjustsFontSizeToFitWidth,
                                      minimumScaleFactor,
                                      respectDynamicType,
-                                     /* includeTextBlob*/ false,
+                                     /* includeTextBlob*/ textLayoutCache != nullptr,
                                      displayScale,
                                      dynamicTypeScale,
                                      fontManager);
 
+    if (textLayoutCache != nullptr) {
+        textLayoutCache->insert(cacheKey, textLayout);
+    }
+
     return textLayout->getBounds().size();
 }
 
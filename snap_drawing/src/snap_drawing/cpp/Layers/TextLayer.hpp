@@ -19,6 +19,8 @@ namespace snap::drawing {
 class FontManager;
 class ValdiAnimator;
 class AttributedTextOnTapGestureRecognizer;
+class TextLayoutCache;
+struct TextLayoutCacheKey;
 
 struct TextShadow {
     Color color;
@@ -106,7 +108,8 @@ public:
                             bool respectDynamicType,
                             Scalar displayScale,
                             Scalar dynamicTypeScale,
-                            const Ref<FontManager>& fontManager);
+                            const Ref<FontManager>& fontManager,
+                            const Ref<TextLayoutCache>& textLayoutCache);
 
     static Ref<TextLayout> makeTextLayout(Size maxSize,
                                           const String& text,
@@ -170,6 +173,22 @@ private:
 
     TextLayout& getTextLayout(Size size, bool respectDynamicType, Scalar displayScale, Scalar dynamicTypeScale);
 
+    static TextLayoutCacheKey makeTextLayoutCacheKey(const String& text,
+                                                     const Ref<AttributedText>& attributedText,
+                                                     const Ref<Font>& font,
+                                                     TextAlign textAlign,
+                                                     TextDecoration textDecoration,
+                                                     TextOverflow textOverflow,
+                                                     int numberOfLines,
+                                                     Scalar lineHeightMultiple,
+                                                     Scalar letterSpacing,
+                                                     bool isRightToLeft,
+                                                     bool adjustsFontSizeToFitWidth,
+                                                     double minimumScaleFactor,
+                                                     bool respectDynamicType,
+                                                     Scalar displayScale,
+                                                     Scalar dynamicTypeScale);
+
     void setNeedsTextLayout();
 
     void removeOnTapGestureRecognizer();
@@ -7,6 +7,8 @@
 
 #include "snap_drawing/cpp/Resources.hpp"
 #include "include/core/SkGraphics.h"
+#include "snap_drawing/cpp/Drawing/Raster/LayerRasterCache.hpp"
+#include "snap_drawing/cpp/Text/TextLayoutCache.hpp"
 #include "snap_drawing/cpp/Utils/Image.hpp"
 #include "valdi_core/cpp/Interfaces/ILogger.hpp"
 
@@ -24,7 +26,9 @@ Resources::Resources(const Ref<FontManager>& fontManager,
       _displayScale(displayScale),
       _dynamicTypeScale(1.0),
       _gesturesConfiguration(gesturesConfiguration),
-      _logger(&logger) {
+      _logger(&logger),
+      _layerRasterCache(Valdi::makeShared<LayerRasterCache>(LayerRasterCache::kDefaultMaxBytes)),
+      _textLayoutCache(Valdi::makeShared<TextLayoutCache>(TextLayoutCache::kDefaultMaxEntries)) {
     // Make sure all Skia features are properly loaded.
     // This will be a no-op if this call was already done before.
     SkGraphics::Init();
@@ -61,6 +65,14 @@ void Resources::setDynamicTypeScale(Scalar dynamicTypeScale) {
     _dynamicTypeScale = dynamicTypeScale;
 }
 
+const Ref<LayerRasterCache>& Resources::getLayerRasterCache() const {
+    return _layerRasterCache;
+}
+
+const Ref<TextLayoutCache>& Resources::getTextLayoutCache() const {
+    return _textLayoutCache;
+}
+
 const GesturesConfiguration& Resources::getGesturesConfiguration() const {
     return _gesturesConfiguration;
 }
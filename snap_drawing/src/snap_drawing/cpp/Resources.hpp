@@ -22,6 +22,9 @@ class ILogger;
 
 namespace snap::drawing {
 
+class LayerRasterCache;
+class TextLayoutCache;
+
 class Resources : public Valdi::SimpleRefCountable {
 public:
     Resources(const Ref<FontManager>& fontManager,
@@ -47,6 +50,18 @@ public:
 
     const GesturesConfiguration& getGesturesConfiguration() const;
 
+    /**
+    Returns the cache holding the rasterized content of layers with shouldRasterize enabled.
+    The cache is shared by all the layers using these Resources.
+     */
+    const Ref<LayerRasterCache>& getLayerRasterCache() const;
+
+    /**
+    Returns the cache holding the recently built text layouts, which lets text layers reuse
+    the layout computed when their text was measured.
+     */
+    const Ref<TextLayoutCache>& getTextLayoutCache() const;
+
 private:
     Ref<FontManager> _fontManager;
     bool _respectDynamicType;
@@ -54,6 +69,8 @@ private:
     Scalar _dynamicTypeScale;
     GesturesConfiguration _gesturesConfiguration;
     Ref<Valdi::ILogger> _logger;
+    Ref<LayerRasterCache> _layerRasterCache;
+    Ref<TextLayoutCache> _textLayoutCache;
 };
 
 } // namespace snap::drawing
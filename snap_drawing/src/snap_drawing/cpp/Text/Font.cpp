@@ -93,18 +93,26 @@ std::string Font::getDescription() const {
 }
 
 const FontMetrics& Font::metrics() {
-    if (!_loadedMetrics) {
-        _loadedMetrics = true;
-        _metrics = _typeface->getFontMetrics(_size * _scale);
+    // Fonts are shared between the threads measuring text
+    if (!_hasMetrics.load(std::memory_order_acquire)) {
+        std::lock_guard<Valdi::Mutex> lock(_mutex);
+        if (!_hasMetrics.load(std::memory_order_relaxed)) {
+            _metrics = _typeface->getFontMetrics(_size * _scale);
+            _hasMetrics.store(true, std::memory_order_release);
+        }
     }
 
     return _metrics;
 }
 
 const HBFont& Font::getHBFont() {
-    if (!_hasHBFont) {
-        _hasHBFont = true;
-        _hbFont = Harfbuzz::createSubFont(_typeface->getHBFont(), &_font);
+    // Fonts are shared between the threads shaping text
+    if (!_hasHBFont.load(std::memory_order_acquire)) {
+        std::lock_guard<Valdi::Mutex> lock(_mutex);
+        if (!_hasHBFont.load(std::memory_order_relaxed)) {
+            _hbFont = Harfbuzz::createSubFont(_typeface->getHBFont(), &_font);
+            _hasHBFont.store(true, std::memory_order_release);
+        }
     }
 
     return _hbFont;
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "valdi_core/cpp/Utils/Mutex.hpp"
 #include "valdi_core/cpp/Utils/Result.hpp"
 #include "valdi_core/cpp/Utils/ValdiObject.hpp"
 
@@ -18,6 +19,7 @@
 #include "snap_drawing/cpp/Utils/Geometry.hpp"
 
 #include "include/core/SkFont.h"
+#include <atomic>
 
 namespace snap::drawing {
 
@@ -74,8 +76,9 @@ private:
     double _scale;
     bool _respectDynamicType;
     FontMetrics _metrics;
-    bool _loadedMetrics = false;
-    bool _hasHBFont = false;
+    Valdi::Mutex _mutex;
+    std::atomic_bool _hasMetrics = false;
+    std::atomic_bool _hasHBFont = false;
 };
 
 } // namespace snap::drawing
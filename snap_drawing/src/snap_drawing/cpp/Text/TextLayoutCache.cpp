@@ -0,0 +1,220 @@
+#include "snap_drawing/cpp/Text/TextLayoutCache.hpp"
+#include "snap_drawing/cpp/Text/Typeface.hpp"
+#include <boost/functional/hash.hpp>
+#include <limits>
+
+namespace snap::drawing {
+
+static bool areFontsEqual(const Ref<Font>& left, const Ref<Font>& right) {
+    if (left == right) {
+        return true;
+    }
+    if (left == nullptr || right == nullptr) {
+        return false;
+    }
+
+    return left->typeface() == right->typeface() && left->size() == right->size() &&
+           left->scale() == right->scale() && left->respectDynamicType() == right->respectDynamicType();
+}
+
+static bool areAttributedTextsEqual(const Ref<AttributedText>& left, const Ref<AttributedText>& right) {
+    if (left == right) {
+        return true;
+    }
+    if (left == nullptr || right == nullptr || left->getPartsSize() != right->getPartsSize()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < left->getPartsSize(); i++) {
+        const auto& leftStyle = left->getStyleAtIndex(i);
+        const auto& rightStyle = right->getStyleAtIndex(i);
+
+        // onTap attributes are referenced by the layout attachments, they are compared by identity
+        if (left->getContentAtIndex(i) != right->getContentAtIndex(i) || leftStyle.color != rightStyle.color ||
+            leftStyle.textDecoration != rightStyle.textDecoration || leftStyle.onTap != rightStyle.onTap ||
+            !areFontsEqual(leftStyle.font, rightStyle.font)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TextLayoutCacheKey::operator==(const TextLayoutCacheKey& other) const {
+    return text == other.text && textAlign == other.textAlign && textDecoration == other.textDecoration &&
+           textOverflow == other.textOverflow && numberOfLines == other.numberOfLines &&
+           lineHeightMultiple == other.lineHeightMultiple && letterSpacing == other.letterSpacing &&
+           isRightToLeft == other.isRightToLeft && adjustsFontSizeToFitWidth == other.adjustsFontSizeToFitWidth &&
+           minimumScaleFactor == other.minimumScaleFactor && respectDynamicType == other.respectDynamicType &&
+           displayScale == other.displayScale && dynamicTypeScale == other.dynamicTypeScale &&
+           areFontsEqual(font, other.font) && areAttributedTextsEqual(attributedText, other.attributedText);
+}
+
+bool TextLayoutCacheKey::operator!=(const TextLayoutCacheKey& other) const {
+    return !(*this == other);
+}
+
+size_t TextLayoutCacheKey::hash() const {
+    auto hash = text.hash();
+    if (attributedText != nullptr) {
+        for (size_t i = 0; i < attributedText->getPartsSize(); i++) {
+            boost::hash_combine(hash, attributedText->getContentAtIndex(i).hash());
+        }
+    }
+    if (font != nullptr) {
+        boost::hash_combine(hash, std::hash<float>()(font->size()));
+    }
+    boost::hash_combine(hash, static_cast<int>(textAlign));
+    boost::hash_combine(hash, static_cast<int>(textDecoration));
+    boost::hash_combine(hash, static_cast<int>(textOverflow));
+    boost::hash_combine(hash, numberOfLines);
+    boost::hash_combine(hash, std::hash<float>()(lineHeightMultiple));
+    boost::hash_combine(hash, std::hash<float>()(letterSpacing));
+    boost::hash_combine(hash, isRightToLeft);
+    boost::hash_combine(hash, std::hash<float>()(displayScale));
+
+    return hash;
+}
+
+double TextLayoutCache::Metrics::getHitRate() const {
+    auto total = hits + misses;
+    if (total == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(hits) / static_cast<double>(total);
+}
+
+TextLayoutCache::TextLayoutCache(size_t maxSizeBytes)
+    : _cache(std::numeric_limits<size_t>::max()), _maxSizeBytes(maxSizeBytes) {}
+
+TextLayoutCache::~TextLayoutCache() = default;
+
+bool TextLayoutCache::isCompatible(const TextLayout& textLayout, TextAlign textAlign, Size maxSize) {
+    const auto& layoutMaxSize = textLayout.getMaxSize();
+    if (layoutMaxSize == maxSize) {
+        return true;
+    }
+
+    if (!textLayout.fitsInMaxSize()) {
+        return false;
+    }
+
+    if (textAlign != TextAlignLeft && layoutMaxSize.width != maxSize.width) {
+        return false;
+    }
+
+    const auto& bounds = textLayout.getBounds();
+    return bounds.right <= maxSize.width && maxSize.width <= layoutMaxSize.width && bounds.bottom <= maxSize.height &&
+           maxSize.height <= layoutMaxSize.height;
+}
+
+size_t TextLayoutCache::estimateByteSize(const TextLayout& textLayout) {
+    auto byteSize = sizeof(TextLayout);
+    for (const auto& entry : textLayout.getEntries()) {
+        byteSize += sizeof(TextLayoutEntry);
+        for (const auto& segment : entry.segments) {
+            byteSize += sizeof(TextLayoutEntrySegment) + segment.characters.size();
+            if (entry.textBlob != nullptr) {
+                // A glyph id and a position per character in the blob
+                byteSize += segment.characters.size() * (sizeof(SkGlyphID) + sizeof(SkPoint));
+            }
+        }
+    }
+    byteSize += textLayout.getDecorations().size() * sizeof(TextLayoutDecorationEntry);
+    byteSize += textLayout.getAttachments().size() * sizeof(TextLayoutAttachment);
+
+    return byteSize;
+}
+
+Ref<TextLayout> TextLayoutCache::find(const TextLayoutCacheKey& key, Size maxSize) {
+    std::lock_guard<Valdi::Mutex> lock(_mutex);
+    auto it = _cache.find(key);
+    if (it != _cache.end()) {
+        for (const auto& textLayout : it->value().textLayouts) {
+            if (isCompatible(*textLayout, key.textAlign, maxSize)) {
+                _hits++;
+                return textLayout;
+            }
+        }
+    }
+
+    _misses++;
+    return nullptr;
+}
+
+void TextLayoutCache::insert(const TextLayoutCacheKey& key, const Ref<TextLayout>& textLayout) {
+    auto textLayoutByteSize = estimateByteSize(*textLayout);
+
+    std::lock_guard<Valdi::Mutex> lock(_mutex);
+    auto it = _cache.find(key);
+    if (it == _cache.end()) {
+        Entry entry;
+        // The key retains its text
+        entry.sizeBytes = sizeof(Entry) + sizeof(TextLayoutCacheKey) + key.text.length();
+        _sizeBytes += entry.sizeBytes;
+        it = _cache.insert(TextLayoutCacheKey(key), std::move(entry));
+    }
+
+    auto& entry = it->value();
+    entry.textLayouts.insert(entry.textLayouts.begin(), textLayout);
+    entry.sizeBytes += textLayoutByteSize;
+    _sizeBytes += textLayoutByteSize;
+
+    if (entry.textLayouts.size() > kMaxLayoutsPerEntry) {
+        auto removedByteSize = estimateByteSize(*entry.textLayouts.back());
+        entry.textLayouts.pop_back();
+        entry.sizeBytes -= removedByteSize;
+        _sizeBytes -= removedByteSize;
+    }
+
+    trimToMaxSize();
+}
+
+void TextLayoutCache::trimToMaxSize() {
+    while (_sizeBytes > _maxSizeBytes && !_cache.empty()) {
+        auto last = _cache.last();
+        _sizeBytes -= last->value().sizeBytes;
+        _cache.remove(last->key());
+        _evictions++;
+    }
+}
+
+void TextLayoutCache::clear() {
+    std::lock_guard<Valdi::Mutex> lock(_mutex);
+    _cache.clear();
+    _sizeBytes = 0;
+}
+
+void TextLayoutCache::setMaxSizeBytes(size_t maxSizeBytes) {
+    std::lock_guard<Valdi::Mutex> lock(_mutex);
+    _maxSizeBytes = maxSizeBytes;
+    trimToMaxSize();
+}
+
+size_t TextLayoutCache::getMaxSizeBytes() const {
+    std::lock_guard<Valdi::Mutex> lock(_mutex);
+    return _maxSizeBytes;
+}
+
+TextLayoutCache::Metrics TextLayoutCache::getMetrics() const {
+    std::lock_guard<Valdi::Mutex> lock(_mutex);
+    Metrics metrics;
+    metrics.hits = _hits;
+    metrics.misses = _misses;
+    metrics.evictions = _evictions;
+    metrics.entriesCount = _cache.size();
+    metrics.sizeBytes = _sizeBytes;
+    metrics.maxSizeBytes = _maxSizeBytes;
+    return metrics;
+}
+
+} // namespace snap::drawing
+
+namespace std {
+
+std::size_t hash<snap::drawing::TextLayoutCacheKey>::operator()(
+    const snap::drawing::TextLayoutCacheKey& k) const noexcept {
+    return k.hash();
+}
+
+} // namespace std
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "snap_drawing/cpp/Text/AttributedText.hpp"
+#include "snap_drawing/cpp/Text/Font.hpp"
+#include "snap_drawing/cpp/Text/TextLayout.hpp"
+#include "snap_drawing/cpp/Utils/Aliases.hpp"
+
+#include "valdi_core/cpp/Utils/LRUCache.hpp"
+#include "valdi_core/cpp/Utils/Mutex.hpp"
+#include "valdi_core/cpp/Utils/StringBox.hpp"
+
+#include <vector>
+
+namespace snap::drawing {
+
+/**
+ All the parameters that a TextLayout depends on, except the max size.
+ Fonts and attributed texts are compared by value, as measure and draw resolve them separately.
+ */
+struct TextLayoutCacheKey {
+    Valdi::StringBox text;
+    Ref<AttributedText> attributedText;
+    Ref<Font> font;
+    TextAlign textAlign = TextAlignLeft;
+    TextDecoration textDecoration = TextDecorationNone;
+    TextOverflow textOverflow = TextOverflowEllipsis;
+    int numberOfLines = 1;
+    Scalar lineHeightMultiple = 1.0f;
+    Scalar letterSpacing = 0.0f;
+    bool isRightToLeft = false;
+    bool adjustsFontSizeToFitWidth = false;
+    double minimumScaleFactor = 0.0;
+    bool respectDynamicType = false;
+    Scalar displayScale = 1.0f;
+    Scalar dynamicTypeScale = 1.0f;
+
+    bool operator==(const TextLayoutCacheKey& other) const;
+    bool operator!=(const TextLayoutCacheKey& other) const;
+
+    size_t hash() const;
+};
+
+/**
+ TextLayoutCache holds recently built text layouts, so that the layout computed while measuring a text
+ can be reused to draw it, and identical labels can share their layout. A layout is returned for a
+ different max size only if building it again with that max size would give the same result.
+ The cache is bounded by the estimated memory used by its layouts and evicts the least recently used ones.
+ */
+class TextLayoutCache : public Valdi::SimpleRefCountable {
+public:
+    static constexpr size_t kDefaultMaxSizeBytes = 1024 * 1024;
+    // Number of layouts built with different max sizes kept for the same key
+    static constexpr size_t kMaxLayoutsPerEntry = 4;
+
+    struct Metrics {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+        size_t entriesCount = 0;
+        size_t sizeBytes = 0;
+        size_t maxSizeBytes = 0;
+
+        double getHitRate() const;
+    };
+
+    explicit TextLayoutCache(size_t maxSizeBytes);
+    ~TextLayoutCache() override;
+
+    /**
+     Returns a layout for the given key which can be used for the given max size, or null.
+     */
+    Ref<TextLayout> find(const TextLayoutCacheKey& key, Size maxSize);
+
+    void insert(const TextLayoutCacheKey& key, const Ref<TextLayout>& textLayout);
+
+    void clear();
+
+    void setMaxSizeBytes(size_t maxSizeBytes);
+    size_t getMaxSizeBytes() const;
+
+    Metrics getMetrics() const;
+
+    /**
+     Returns whether the given layout is what laying out its text again with the given max size would produce.
+     Lines only break where the next word did not fit, so the line breaks stay the same for any max width
+     between the widest line and the max width that was used, as long as nothing was truncated. Only left
+     aligned lines keep their position when the max width changes.
+     */
+    static bool isCompatible(const TextLayout& textLayout, TextAlign textAlign, Size maxSize);
+
+    /**
+     Returns an estimate of the memory held by the given layout, including its text blobs.
+     */
+    static size_t estimateByteSize(const TextLayout& textLayout);
+
+private:
+    struct Entry {
+        std::vector<Ref<TextLayout>> textLayouts;
+        size_t sizeBytes = 0;
+    };
+
+    mutable Valdi::Mutex _mutex;
+    Valdi::LRUCache<TextLayoutCacheKey, Entry> _cache;
+    size_t _sizeBytes = 0;
+    size_t _maxSizeBytes;
+    size_t _hits = 0;
+    size_t _misses = 0;
+    size_t _evictions = 0;
+
+    void trimToMaxSize();
+};
+
+} // namespace snap::drawing
+
+namespace std {
+
+template<>
+struct hash<snap::drawing::TextLayoutCacheKey> {
+    std::size_t operator()(const snap::drawing::TextLayoutCacheKey& k) const noexcept;
+};
+
+} // namespace std
@@ -7,6 +7,7 @@
 
 #include "snap_drawing/cpp/Text/TextShaperCache.hpp"
 #include "valdi_core/cpp/Utils/InlineContainerAllocator.hpp"
+#include <algorithm>
 #include <boost/functional/hash.hpp>
 
 namespace snap::drawing {
@@ -107,6 +108,20 @@ Ref<TextShaperCacheNode> TextShaperCacheNode::make(FontId fontId,
     return Ref<TextShaperCacheNode>(reinterpret_cast<TextShaperCacheNode*>(region));
 }
 
+Ref<TextShaperCacheNode> TextShaperCacheNode::make(const TextShaperCacheKey& key,
+                                                   const ShapedGlyph* glyphs,
+                                                   size_t glyphsLength) {
+    return make(key.fontId,
+                key.letterSpacing,
+                key.script,
+                key.isRightToLeft,
+                key.characters,
+                key.length,
+                glyphs,
+                glyphsLength,
+                key.hash());
+}
+
 TextShaperCache::TextShaperCache(size_t capacity) : _cache(capacity) {}
 
 TextShaperCache::~TextShaperCache() = default;
@@ -129,18 +144,70 @@ std::optional<TextShaperCacheValue> TextShaperCache::find(const TextShaperCacheK
 }
 
 void TextShaperCache::insert(const TextShaperCacheKey& key, const ShapedGlyph* glyphs, size_t glyphsLength) {
-    auto node = TextShaperCacheNode::make(key.fontId,
-                                          key.letterSpacing,
-                                          key.script,
-                                          key.isRightToLeft,
-                                          key.characters,
-                                          key.length,
-                                          glyphs,
-                                          glyphsLength,
-                                          key.hash());
+    insert(TextShaperCacheNode::make(key, glyphs, glyphsLength));
+}
+
+void TextShaperCache::insert(const Ref<TextShaperCacheNode>& node) {
     _cache.insert(node);
 }
 
+ConcurrentTextShaperCache::Segment::Segment(size_t capacity) : cache(capacity) {}
+
+ConcurrentTextShaperCache::ConcurrentTextShaperCache(size_t capacity) {
+    auto segmentCapacity = std::max(static_cast<size_t>(1), (capacity + kSegmentsCount - 1) / kSegmentsCount);
+    for (auto& segment : _segments) {
+        segment = std::make_unique<Segment>(segmentCapacity);
+    }
+}
+
+ConcurrentTextShaperCache::~ConcurrentTextShaperCache() = default;
+
+void ConcurrentTextShaperCache::clear() {
+    for (const auto& segment : _segments) {
+        std::lock_guard<Valdi::Mutex> lock(segment->mutex);
+        segment->cache.clear();
+    }
+}
+
+bool ConcurrentTextShaperCache::contains(const TextShaperCacheKey& key) const {
+    auto& segment = getSegment(key);
+    std::lock_guard<Valdi::Mutex> lock(segment.mutex);
+    return segment.cache.contains(key);
+}
+
+bool ConcurrentTextShaperCache::find(const TextShaperCacheKey& key, std::vector<ShapedGlyph>& out) {
+    auto& segment = getSegment(key);
+    std::lock_guard<Valdi::Mutex> lock(segment.mutex);
+    auto result = segment.cache.find(key);
+    if (!result) {
+        return false;
+    }
+
+    out.insert(out.end(), result.value().glyphs, result.value().glyphs + result.value().length);
+    return true;
+}
+
+void ConcurrentTextShaperCache::insert(const TextShaperCacheKey& key,
+                                       const ShapedGlyph* glyphs,
+                                       size_t glyphsLength) {
+    // Allocating the node does not need the lock, only the insertion in the segment does
+    auto node = TextShaperCacheNode::make(key, glyphs, glyphsLength);
+
+    auto& segment = getSegment(key);
+    std::lock_guard<Valdi::Mutex> lock(segment.mutex);
+    segment.cache.insert(node);
+}
+
+ConcurrentTextShaperCache::Segment& ConcurrentTextShaperCache::getSegment(const TextShaperCacheKey& key) const {
+    // The low bits of the hash are used by the FlatMap of each segment, so the segment
+    // is picked from the high bits of a multiplicative mix of the hash.
+    constexpr uint64_t kSegmentShift = 60;
+    static_assert(kSegmentsCount == (static_cast<uint64_t>(1) << (64 - kSegmentShift)));
+
+    auto mixed = static_cast<uint64_t>(key.hash()) * 0x9E3779B97F4A7C15ULL;
+    return *_segments[static_cast<size_t>(mixed >> kSegmentShift)];
+}
+
 } // namespace snap::drawing
 
 namespace std {
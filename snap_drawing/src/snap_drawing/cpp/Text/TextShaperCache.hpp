@@ -8,13 +8,17 @@
 #pragma once
 
 #include "valdi_core/cpp/Utils/LRUCache.hpp"
+#include "valdi_core/cpp/Utils/Mutex.hpp"
 
 #include "snap_drawing/cpp/Text/Character.hpp"
 #include "snap_drawing/cpp/Text/Font.hpp"
 #include "snap_drawing/cpp/Text/TextShaper.hpp"
 #include "snap_drawing/cpp/Utils/Aliases.hpp"
 
+#include <array>
+#include <memory>
 #include <optional>
+#include <vector>
 
 namespace snap::drawing {
 
@@ -82,6 +86,10 @@ public:
                                          const ShapedGlyph* glyphs,
                                          size_t glyphsLength,
                                          size_t hash);
+
+    static Ref<TextShaperCacheNode> make(const TextShaperCacheKey& key,
+                                         const ShapedGlyph* glyphs,
+                                         size_t glyphsLength);
 };
 
 /**
@@ -98,11 +106,51 @@ public:
     bool contains(const TextShaperCacheKey& key) const;
     std::optional<TextShaperCacheValue> find(const TextShaperCacheKey& key);
     void insert(const TextShaperCacheKey& key, const ShapedGlyph* glyphs, size_t glyphsLength);
+    void insert(const Ref<TextShaperCacheNode>& node);
 
 private:
     Valdi::LRUCache<TextShaperCacheKey, TextShaperCacheValue> _cache;
 };
 
+/**
+ * A thread safe TextShaperCache split into independent LRU segments.
+ * The segment of an entry is picked from the hash of its key, so that threads
+ * shaping different words rarely contend on the same lock. Each segment holds
+ * an equal share of the total capacity.
+ */
+class ConcurrentTextShaperCache {
+public:
+    static constexpr size_t kSegmentsCount = 16;
+
+    explicit ConcurrentTextShaperCache(size_t capacity);
+    ~ConcurrentTextShaperCache();
+
+    void clear();
+
+    bool contains(const TextShaperCacheKey& key) const;
+
+    /**
+     * Append the cached shaped glyphs for the given key into the given vector.
+     * Returns false if the cache has no entry for the key. The glyphs are copied while
+     * the segment is locked, as the entry might be evicted by another thread right after.
+     */
+    bool find(const TextShaperCacheKey& key, std::vector<ShapedGlyph>& out);
+
+    void insert(const TextShaperCacheKey& key, const ShapedGlyph* glyphs, size_t glyphsLength);
+
+private:
+    struct Segment {
+        mutable Valdi::Mutex mutex;
+        TextShaperCache cache;
+
+        explicit Segment(size_t capacity);
+    };
+
+    std::array<std::unique_ptr<Segment>, kSegmentsCount> _segments;
+
+    Segment& getSegment(const TextShaperCacheKey& key) const;
+};
+
 } // namespace snap::drawing
 
 namespace std {
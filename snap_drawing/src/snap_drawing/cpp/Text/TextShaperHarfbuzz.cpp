@@ -31,9 +31,29 @@ enum class TextDirectionResolutionResult {
     RightToLeft,
 };
 
-TextShaperHarfbuzz::TextShaperHarfbuzz() : _buffer(hb_buffer_create()) {}
+TextShaperHarfbuzz::TextShaperHarfbuzz() = default;
 TextShaperHarfbuzz::~TextShaperHarfbuzz() = default;
 
+HBBuffer TextShaperHarfbuzz::acquireBuffer() {
+    {
+        std::lock_guard<Valdi::Mutex> lock(_mutex);
+        if (!_availableBuffers.empty()) {
+            auto buffer = std::move(_availableBuffers.back());
+            _availableBuffers.pop_back();
+            return buffer;
+        }
+    }
+
+    return HBBuffer(hb_buffer_create());
+}
+
+void TextShaperHarfbuzz::releaseBuffer(HBBuffer&& buffer) {
+    hb_buffer_clear_contents(buffer.get());
+
+    std::lock_guard<Valdi::Mutex> lock(_mutex);
+    _availableBuffers.emplace_back(std::move(buffer));
+}
+
 /**
  * Disable certain scripts (mostly those with cursive connection) from having letterspacing
  * applied. See https://github.com/behdad/harfbuzz/issues/64 for more details.
@@ -281,15 +301,14 @@ size_t TextShaperHarfbuzz::shape(const Character* unicodeText,
                                  Scalar letterSpacing,
                                  TextScript script,
                                  std::vector<ShapedGlyph>& out) {
-    std::lock_guard<Valdi::Mutex> lock(_mutex);
-
-    auto* buffer = _buffer.get();
-    if (buffer == nullptr) {
+    auto* hbFont = font.getHBFont().get();
+    if (hbFont == nullptr) {
         return 0;
     }
 
-    auto* hbFont = font.getHBFont().get();
-    if (hbFont == nullptr) {
+    auto hbBuffer = acquireBuffer();
+    auto* buffer = hbBuffer.get();
+    if (buffer == nullptr) {
         return 0;
     }
 
@@ -325,7 +344,7 @@ size_t TextShaperHarfbuzz::shape(const Character* unicodeText,
     auto fontSize = font.getSkValue().getSize();
     double textSizeY = fontSize / scaleY;
     double textSizeX = fontSize / scaleX * font.getSkValue().getScaleX();
-    Scalar advanceOffset = isScriptOkForLetterspacing(hb_buffer_get_script(_buffer.get())) ? letterSpacing : 0.0f;
+    Scalar advanceOffset = isScriptOkForLetterspacing(hb_buffer_get_script(buffer)) ? letterSpacing : 0.0f;
 
     auto glyphsLength = static_cast<size_t>(glyphCount);
 
@@ -345,7 +364,7 @@ size_t TextShaperHarfbuzz::shape(const Character* unicodeText,
         glyph.advanceX = (pos.x_advance * textSizeX) + advanceOffset;
     }
 
-    hb_buffer_clear_contents(buffer);
+    releaseBuffer(std::move(hbBuffer));
 
     return glyphsLength;
 }
@@ -10,6 +10,7 @@
 #include "snap_drawing/cpp/Text/Harfbuzz.hpp"
 #include "snap_drawing/cpp/Text/TextShaper.hpp"
 #include "valdi_core/cpp/Utils/Mutex.hpp"
+#include <vector>
 
 namespace snap::drawing {
 
@@ -32,7 +33,12 @@ public:
 
 private:
     Valdi::Mutex _mutex;
-    HBBuffer _buffer;
+    // Buffers which are not currently used by a shape() call. Shaping happens
+    // outside of the lock, each concurrent call uses its own buffer.
+    std::vector<HBBuffer> _availableBuffers;
+
+    HBBuffer acquireBuffer();
+    void releaseBuffer(HBBuffer&& buffer);
 
     static TextParagraphList resolveParagraphsPrimitive(const Character* unicodeText,
                                                         size_t length,
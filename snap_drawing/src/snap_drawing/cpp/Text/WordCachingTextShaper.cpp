@@ -19,7 +19,6 @@ WordCachingTextShaper::WordCachingTextShaper(const Ref<TextShaper>& innerShaper,
 WordCachingTextShaper::~WordCachingTextShaper() = default;
 
 void WordCachingTextShaper::clearCache() {
-    std::lock_guard<Valdi::Mutex> lock(_mutex);
     _cache.clear();
 }
 
@@ -36,8 +35,6 @@ size_t WordCachingTextShaper::shape(const Character* unicodeText,
                                     Scalar letterSpacing,
                                     TextScript script,
                                     std::vector<ShapedGlyph>& out) {
-    std::lock_guard<Valdi::Mutex> lock(_mutex);
-
     if (font.typeface()->hasSpaceInLigaturesOrKerning()) {
         return _innerShaper->shape(unicodeText, length, font, isRightToLeft, letterSpacing, script, out);
     }
@@ -152,28 +149,27 @@ void WordCachingTextShaper::shapeWord(const Character* unicodeText,
                                       TextScript script,
                                       std::vector<ShapedGlyph>& out) {
     auto cacheKey = TextShaperCacheKey(fontId, letterSpacing, script, isRightToLeft, unicodeText, length);
-    auto cacheResult = _cache.find(cacheKey);
-
-    if (cacheResult) {
-        copyGlyphs(cacheResult.value().glyphs, cacheResult.value().length, out);
+    if (_cache.find(cacheKey, out)) {
         return;
     }
 
+    // Shape directly at the end of the output. Two threads might shape the same word
+    // concurrently on a miss, in which case the last one to finish will replace the entry.
+    auto sizeBefore = out.size();
     auto writtenGlyphsLength =
-        _innerShaper->shape(unicodeText, length, font, isRightToLeft, letterSpacing, script, _tmp);
+        _innerShaper->shape(unicodeText, length, font, isRightToLeft, letterSpacing, script, out);
 
-    auto* writtenGlyphs = _tmp.data();
+    auto* writtenGlyphs = out.data() + sizeBefore;
 
     if (isRightToLeft) {
         std::reverse(writtenGlyphs, writtenGlyphs + writtenGlyphsLength);
     }
 
     _cache.insert(cacheKey, writtenGlyphs, writtenGlyphsLength);
-    copyGlyphs(writtenGlyphs, writtenGlyphsLength, out);
-    _tmp.clear();
 }
 
 Ref<Font> WordCachingTextShaper::getUniformFont(const Ref<Typeface>& typeface) {
+    std::lock_guard<Valdi::Mutex> lock(_uniformFontsMutex);
     const auto& it = _uniformFonts.find(typeface->getId());
     if (it != _uniformFonts.end()) {
         return it->second;
@@ -185,23 +181,13 @@ Ref<Font> WordCachingTextShaper::getUniformFont(const Ref<Typeface>& typeface) {
     return font;
 }
 
-void WordCachingTextShaper::copyGlyphs(const ShapedGlyph* glyphs, size_t length, std::vector<ShapedGlyph>& out) {
-    auto beforeSize = out.size();
-    out.resize(beforeSize + length);
-
-    auto* outGlyphs = &out[beforeSize];
-    for (size_t i = 0; i < length; i++) {
-        outGlyphs[i] = glyphs[i];
-    }
-}
-
 ShapedGlyph WordCachingTextShaper::getSpaceGlyphForFont(FontId fontId, Font& font) {
     auto text = static_cast<Character>(' ');
     auto cacheKey = TextShaperCacheKey(fontId, 0.0f, TextScript::common(), false, &text, 1);
 
-    auto cacheResult = _cache.find(cacheKey);
-    if (cacheResult && cacheResult.value().length == 1) {
-        return cacheResult.value().glyphs[0];
+    std::vector<ShapedGlyph> cachedGlyphs;
+    if (_cache.find(cacheKey, cachedGlyphs) && cachedGlyphs.size() == 1) {
+        return cachedGlyphs[0];
     }
 
     auto spaceGlyphId = font.getSkValue().unicharToGlyph(static_cast<SkUnichar>(text));
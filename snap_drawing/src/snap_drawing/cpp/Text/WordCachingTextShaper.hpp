@@ -10,6 +10,7 @@
 #include "snap_drawing/cpp/Text/TextShaper.hpp"
 #include "snap_drawing/cpp/Text/TextShaperCache.hpp"
 #include "valdi_core/cpp/Utils/FlatMap.hpp"
+#include "valdi_core/cpp/Utils/Mutex.hpp"
 
 namespace snap::drawing {
 
@@ -18,6 +19,8 @@ enum class WordCachingTextShaperStrategy { DisableCache, PrioritizeCacheHit, Pri
 /**
  * A TextShaper implementation that breaks down shaping by words and use a cache.
  * The given innerShaper will be used to shape the individual words on a cache miss.
+ * The cache is safe to use concurrently, and shaping on a cache miss happens outside
+ * of any lock held by the WordCachingTextShaper, so the innerShaper must be thread safe.
  */
 class WordCachingTextShaper : public TextShaper {
 public:
@@ -37,12 +40,11 @@ public:
                  std::vector<ShapedGlyph>& out) override;
 
 private:
-    Valdi::Mutex _mutex;
     Ref<TextShaper> _innerShaper;
-    TextShaperCache _cache;
+    ConcurrentTextShaperCache _cache;
     WordCachingTextShaperStrategy _strategy;
+    Valdi::Mutex _uniformFontsMutex;
     Valdi::FlatMap<uint32_t, Ref<Font>> _uniformFonts;
-    std::vector<ShapedGlyph> _tmp;
 
     size_t shapeUsingUniformFont(const Character* unicodeText,
                                  size_t length,
@@ -72,8 +74,6 @@ private:
     ShapedGlyph getSpaceGlyphForFont(FontId fontId, Font& font);
 
     Ref<Font> getUniformFont(const Ref<Typeface>& typeface);
-
-    static void copyGlyphs(const ShapedGlyph* glyphs, size_t length, std::vector<ShapedGlyph>& out);
 };
 
 } // namespace snap::drawing
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include "snap_drawing/cpp/Drawing/Raster/LayerRasterCache.hpp"
+
+using namespace Valdi;
+
+namespace snap::drawing {
+
+static const void* makeOwner(uintptr_t value) {
+    return reinterpret_cast<const void*>(value);
+}
+
+TEST(LayerRasterCache, canFindInsertedEntries) {
+    LayerRasterCache cache(1000);
+
+    ASSERT_FALSE(cache.find(makeOwner(1), 1.0f).has_value());
+
+    cache.insert(makeOwner(1), 1.0f, LayerContent(), 100);
+
+    ASSERT_TRUE(cache.find(makeOwner(1), 1.0f).has_value());
+    // Rasterized at a different scale
+    ASSERT_FALSE(cache.find(makeOwner(1), 2.0f).has_value());
+
+    auto metrics = cache.getMetrics();
+    ASSERT_EQ(static_cast<size_t>(1), metrics.hits);
+    ASSERT_EQ(static_cast<size_t>(2), metrics.misses);
+    ASSERT_EQ(static_cast<size_t>(1), metrics.entriesCount);
+    ASSERT_EQ(static_cast<size_t>(100), metrics.usedBytes);
+    ASSERT_EQ(static_cast<size_t>(1000), metrics.maxBytes);
+    ASSERT_DOUBLE_EQ(1.0 / 3.0, metrics.getHitRate());
+
+    cache.insert(makeOwner(1), 2.0f, LayerContent(), 400);
+
+    metrics = cache.getMetrics();
+    ASSERT_EQ(static_cast<size_t>(1), metrics.entriesCount);
+    ASSERT_EQ(static_cast<size_t>(400), metrics.usedBytes);
+    ASSERT_TRUE(cache.find(makeOwner(1), 2.0f).has_value());
+
+    cache.remove(makeOwner(1));
+
+    ASSERT_FALSE(cache.find(makeOwner(1), 2.0f).has_value());
+    ASSERT_EQ(static_cast<size_t>(0), cache.getMetrics().usedBytes);
+}
+
+TEST(LayerRasterCache, evictsLeastRecentlyUsedEntries) {
+    LayerRasterCache cache(100);
+
+    cache.insert(makeOwner(1), 1.0f, LayerContent(), 40);
+    cache.insert(makeOwner(2), 1.0f, LayerContent(), 40);
+
+    // Makes owner 2 the least recently used
+    ASSERT_TRUE(cache.find(makeOwner(1), 1.0f).has_value());
+
+    cache.insert(makeOwner(3), 1.0f, LayerContent(), 40);
+
+    ASSERT_TRUE(cache.find(makeOwner(1), 1.0f).has_value());
+    ASSERT_FALSE(cache.find(makeOwner(2), 1.0f).has_value());
+    ASSERT_TRUE(cache.find(makeOwner(3), 1.0f).has_value());
+
+    auto metrics = cache.getMetrics();
+    ASSERT_EQ(static_cast<size_t>(1), metrics.evictions);
+    ASSERT_EQ(static_cast<size_t>(2), metrics.entriesCount);
+    ASSERT_EQ(static_cast<size_t>(80), metrics.usedBytes);
+
+    cache.setMaxBytes(50);
+
+    metrics = cache.getMetrics();
+    ASSERT_EQ(static_cast<size_t>(2), metrics.evictions);
+    ASSERT_EQ(static_cast<size_t>(1), metrics.entriesCount);
+    ASSERT_EQ(static_cast<size_t>(40), metrics.usedBytes);
+    ASSERT_TRUE(cache.find(makeOwner(3), 1.0f).has_value());
+}
+
+TEST(LayerRasterCache, rejectsEntriesLargerThanBudget) {
+    LayerRasterCache cache(100);
+
+    ASSERT_TRUE(cache.canStore(100));
+    ASSERT_FALSE(cache.canStore(101));
+
+    cache.insert(makeOwner(1), 1.0f, LayerContent(), 60);
+    // Fits once the other entries are evicted
+    ASSERT_TRUE(cache.canStore(80));
+
+    cache.clear();
+    ASSERT_EQ(static_cast<size_t>(0), cache.getMetrics().entriesCount);
+}
+
+} // namespace snap::drawing
@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 
 #include "DisplayListBuilder.hpp"
+#include "TestBitmap.hpp"
 #include "snap_drawing/cpp/Drawing/DisplayList/DisplayList.hpp"
+#include "snap_drawing/cpp/Drawing/GraphicsContext/BitmapGraphicsContext.hpp"
+#include "snap_drawing/cpp/Drawing/Raster/LayerRasterCache.hpp"
 #include "snap_drawing/cpp/Layers/Layer.hpp"
 #include "snap_drawing/cpp/Layers/Mask/PaintMaskLayer.hpp"
 #include "valdi_core/cpp/Utils/ConsoleLogger.hpp"
@@ -39,10 +42,34 @@ protected:
         return metrics;
     }
 
+    Ref<TestBitmap> drawInBitmap(const Ref<Layer>& layer, int width, int height, DrawMetrics& metrics) {
+        auto displayList = makeShared<DisplayList>(Size::make(width, height), TimePoint::fromSeconds(0.0));
+        layer->draw(*displayList, metrics);
+
+        auto bitmap = makeShared<TestBitmap>(width, height);
+        BitmapGraphicsContext graphicsContext;
+        auto surface = graphicsContext.createBitmapSurface(bitmap);
+        auto canvas = surface->prepareCanvas();
+        displayList->draw(canvas.value(), 0, true);
+        surface->flush();
+
+        return bitmap;
+    }
+
     Ref<Resources> _resources;
     Ref<Layer> _root;
 };
 
+class ExternalSurfaceTestLayer : public Layer {
+public:
+    explicit ExternalSurfaceTestLayer(const Ref<Resources>& resources) : Layer(resources) {}
+
+protected:
+    bool drawsExternalSurface() const override {
+        return true;
+    }
+};
+
 TEST_F(LayerTests, visitsChildrenOnDraw) {
     auto metrics = draw();
     ASSERT_EQ(1, metrics.drawCacheMiss);
@@ -399,4 +426,185 @@ TEST_F(LayerTests, canDrawMaskAboveBackground) {
     ASSERT_EQ(Operations::ApplyMask::kId, operations[3]->type);
 }
 
+TEST_F(LayerTests, reusesRasterizedLayerUntilSubtreeChanges) {
+    _root->setFrame(Rect::makeXYWH(0, 0, 100, 100));
+
+    auto container = createLayer();
+    container->setFrame(Rect::makeXYWH(0, 0, 20, 20));
+    container->setBackgroundColor(Color::red());
+    container->setShouldRasterize(true);
+    auto child1 = createLayer();
+    child1->setFrame(Rect::makeXYWH(0, 0, 10, 10));
+    child1->setBackgroundColor(Color::blue());
+    auto child2 = createLayer();
+    child2->setFrame(Rect::makeXYWH(10, 10, 10, 10));
+    child2->setBackgroundColor(Color::green());
+
+    _root->addChild(container);
+    container->addChild(child1);
+    container->addChild(child2);
+
+    auto metrics = draw();
+    ASSERT_EQ(0, metrics.rasterCacheHit);
+    ASSERT_EQ(1, metrics.rasterCacheMiss);
+    ASSERT_EQ(4, metrics.visitedLayers);
+
+    // Moving the rasterized layer should not re-visit its subtree
+    container->setTranslationX(5);
+    metrics = draw();
+    ASSERT_EQ(1, metrics.rasterCacheHit);
+    ASSERT_EQ(0, metrics.rasterCacheMiss);
+    ASSERT_EQ(2, metrics.visitedLayers);
+    ASSERT_EQ(0, metrics.drawCacheMiss);
+
+    container->setOpacity(0.5f);
+    metrics = draw();
+    ASSERT_EQ(1, metrics.rasterCacheHit);
+    ASSERT_EQ(0, metrics.rasterCacheMiss);
+
+    // Changes within the subtree should invalidate the rasterized layer
+    child2->setBackgroundColor(Color::black());
+    metrics = draw();
+    ASSERT_EQ(0, metrics.rasterCacheHit);
+    ASSERT_EQ(1, metrics.rasterCacheMiss);
+    ASSERT_EQ(4, metrics.visitedLayers);
+    ASSERT_EQ(1, metrics.drawCacheMiss);
+
+    child1->setTranslationY(2);
+    metrics = draw();
+    ASSERT_EQ(1, metrics.rasterCacheMiss);
+
+    auto cacheMetrics = _resources->getLayerRasterCache()->getMetrics();
+    ASSERT_EQ(static_cast<size_t>(1), cacheMetrics.entriesCount);
+    ASSERT_EQ(static_cast<size_t>(20 * 20 * 4), cacheMetrics.usedBytes);
+    ASSERT_EQ(static_cast<size_t>(2), cacheMetrics.hits);
+
+    container->setShouldRasterize(false);
+    ASSERT_EQ(static_cast<size_t>(0), _resources->getLayerRasterCache()->getMetrics().entriesCount);
+
+    metrics = draw();
+    ASSERT_EQ(0, metrics.rasterCacheHit);
+    ASSERT_EQ(0, metrics.rasterCacheMiss);
+    ASSERT_EQ(4, metrics.visitedLayers);
+    ASSERT_EQ(0, metrics.drawCacheMiss);
+}
+
+TEST_F(LayerTests, rasterizedLayerEmitsSinglePicture) {
+    _root->setFrame(Rect::makeXYWH(0, 0, 100, 100));
+    _root->setShouldRasterize(true);
+    _root->setBackgroundColor(Color::red());
+
+    auto child = createLayer();
+    // Overflows the bounds of the rasterized layer
+    child->setFrame(Rect::makeXYWH(90, 90, 20, 20));
+    child->setBackgroundColor(Color::blue());
+    _root->addChild(child);
+
+    auto displayList = makeShared<DisplayList>(Size::make(100, 100), TimePoint::fromSeconds(0.0));
+    DrawMetrics metrics;
+    _root->draw(*displayList, metrics);
+
+    auto operations = getOperationsFromDisplayList(displayList, 0);
+
+    ASSERT_EQ(static_cast<size_t>(3), operations.size());
+    ASSERT_EQ(Operations::PushContext::kId, operations[0]->type);
+    ASSERT_EQ(Operations::DrawPicture::kId, operations[1]->type);
+    ASSERT_EQ(Operations::PopContext::kId, operations[2]->type);
+
+    auto* picture = reinterpret_cast<const Operations::DrawPicture*>(operations[1])->picture;
+    ASSERT_EQ(Rect::makeXYWH(0, 0, 110, 110), fromSkValue<Rect>(picture->cullRect()));
+    ASSERT_EQ(static_cast<size_t>(110 * 110 * 4), _resources->getLayerRasterCache()->getMetrics().usedBytes);
+}
+
+static Ref<Layer> makeRasterizationTestLayer(const Ref<Layer>& container) {
+    container->setFrame(Rect::makeXYWH(10, 10, 40, 40));
+    container->setBackgroundColor(Color::red());
+    container->setBorderWidth(2);
+    container->setBorderColor(Color::black());
+    container->setOpacity(0.5f);
+
+    auto child1 = makeLayer<Layer>(container->getResources());
+    child1->setFrame(Rect::makeXYWH(5, 5, 20, 20));
+    child1->setBackgroundColor(Color::blue());
+    child1->setScaleX(1.5f);
+    child1->setRotation(0.3f);
+    container->addChild(child1);
+
+    // Overlaps child1 and overflows the bounds of the container
+    auto child2 = makeLayer<Layer>(container->getResources());
+    child2->setFrame(Rect::makeXYWH(25, 25, 20, 20));
+    child2->setBackgroundColor(Color::green());
+    child2->setTranslationX(4);
+    child2->setOpacity(0.8f);
+    container->addChild(child2);
+
+    return container;
+}
+
+TEST_F(LayerTests, rasterizedLayerMatchesDirectDrawing) {
+    auto directRoot = createLayer();
+    directRoot->setFrame(Rect::makeXYWH(0, 0, 64, 64));
+    directRoot->addChild(makeRasterizationTestLayer(createLayer()));
+
+    DrawMetrics directMetrics;
+    auto directBitmap = drawInBitmap(directRoot, 64, 64, directMetrics);
+    ASSERT_EQ(0, directMetrics.rasterCacheMiss);
+
+    auto rasterizedRoot = createLayer();
+    rasterizedRoot->setFrame(Rect::makeXYWH(0, 0, 64, 64));
+    auto container = makeRasterizationTestLayer(createLayer());
+    container->setShouldRasterize(true);
+    rasterizedRoot->addChild(container);
+
+    DrawMetrics rasterizedMetrics;
+    auto rasterizedBitmap = drawInBitmap(rasterizedRoot, 64, 64, rasterizedMetrics);
+    ASSERT_EQ(1, rasterizedMetrics.rasterCacheMiss);
+    ASSERT_EQ(directMetrics.visitedLayers, rasterizedMetrics.visitedLayers);
+    ASSERT_EQ(directMetrics.matrixCacheMiss, rasterizedMetrics.matrixCacheMiss);
+
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 64; x++) {
+            auto directPixel = directBitmap->getPixel(x, y);
+            auto rasterizedPixel = rasterizedBitmap->getPixel(x, y);
+
+            ASSERT_NEAR(directPixel.getAlpha(), rasterizedPixel.getAlpha(), 2) << "at " << x << "," << y;
+            ASSERT_NEAR(directPixel.getRed(), rasterizedPixel.getRed(), 2) << "at " << x << "," << y;
+            ASSERT_NEAR(directPixel.getGreen(), rasterizedPixel.getGreen(), 2) << "at " << x << "," << y;
+            ASSERT_NEAR(directPixel.getBlue(), rasterizedPixel.getBlue(), 2) << "at " << x << "," << y;
+        }
+    }
+
+    DrawMetrics cachedMetrics;
+    auto cachedBitmap = drawInBitmap(rasterizedRoot, 64, 64, cachedMetrics);
+    ASSERT_EQ(1, cachedMetrics.rasterCacheHit);
+    ASSERT_EQ(*rasterizedBitmap, *cachedBitmap);
+}
+
+TEST_F(LayerTests, drawsSubtreeWithExternalSurfaceOnce) {
+    _root->setFrame(Rect::makeXYWH(0, 0, 100, 100));
+
+    auto container = createLayer();
+    container->setFrame(Rect::makeXYWH(0, 0, 20, 20));
+    container->setShouldRasterize(true);
+    auto child = makeLayer<ExternalSurfaceTestLayer>(_resources);
+    child->setFrame(Rect::makeXYWH(0, 0, 10, 10));
+    child->setBackgroundColor(Color::blue());
+
+    _root->addChild(container);
+    container->addChild(child);
+
+    auto metrics = draw();
+    ASSERT_EQ(0, metrics.rasterCacheHit);
+    ASSERT_EQ(0, metrics.rasterCacheMiss);
+    ASSERT_EQ(3, metrics.visitedLayers);
+    ASSERT_EQ(3, metrics.drawCacheMiss);
+    ASSERT_EQ(static_cast<size_t>(0), _resources->getLayerRasterCache()->getMetrics().entriesCount);
+
+    container->setTranslationX(5);
+    metrics = draw();
+    ASSERT_EQ(0, metrics.rasterCacheMiss);
+    ASSERT_EQ(3, metrics.visitedLayers);
+    ASSERT_EQ(0, metrics.drawCacheMiss);
+}
+
 } // namespace snap::drawing
@@ -670,4 +670,107 @@ TEST_F(RasterContextTests, canRasterWithInternalDeltaModeAndNoClear) {
     ASSERT_EQ(9, result.value().renderedPixelsCount);
 }
 
+static Ref<Layer> makeSceneWithAntiAliasedEdges(const Ref<Resources>& resources, const Ref<Layer>& contentLayer) {
+    contentLayer->setBackgroundColor(Color::red());
+    contentLayer->setFrame(Rect::makeXYWH(0, 0, 37, 29));
+
+    auto roundedLayer = makeLayer<Layer>(resources);
+    roundedLayer->setBackgroundColor(Color::blue());
+    roundedLayer->setBorderRadius(BorderRadius(7.5f, 3.0f, 9.0f, 1.5f, false, false, false, false));
+    roundedLayer->setBorderWidth(1.5f);
+    roundedLayer->setBorderColor(Color::green());
+    roundedLayer->setFrame(Rect::makeXYWH(3.3f, 2.7f, 25.1f, 17.9f));
+    contentLayer->addChild(roundedLayer);
+
+    auto rotatedLayer = makeLayer<Layer>(resources);
+    rotatedLayer->setBackgroundColor(Color::black());
+    rotatedLayer->setOpacity(0.6f);
+    rotatedLayer->setRotation(0.4f);
+    rotatedLayer->setFrame(Rect::makeXYWH(14.5f, 9.25f, 17.0f, 13.0f));
+    contentLayer->addChild(rotatedLayer);
+
+    return rotatedLayer;
+}
+
+TEST_F(RasterContextTests, tiledRasterIsPixelIdentical) {
+    makeSceneWithAntiAliasedEdges(_resources, _contentLayer);
+
+    auto expectedBitmap = makeShared<TestBitmap>(37, 29);
+    auto result = rasterInto(expectedBitmap);
+    ASSERT_TRUE(result) << result.description();
+
+    // Tile sizes which do not divide the bitmap size, and one which covers it entirely
+    for (auto tileSize : {4, 7, 16, 64}) {
+        _rasterContext->setTiledRasterization(tileSize, 3);
+
+        auto outputBitmap = makeShared<TestBitmap>(37, 29);
+        result = rasterInto(outputBitmap);
+        ASSERT_TRUE(result) << result.description();
+        ASSERT_EQ(37 * 29, result.value().renderedPixelsCount);
+
+        ASSERT_EQ(*expectedBitmap, *outputBitmap) << "tileSize " << tileSize;
+    }
+}
+
+TEST_F(RasterContextTests, tiledDeltaRasterIsPixelIdentical) {
+    auto rotatedLayer = makeSceneWithAntiAliasedEdges(_resources, _contentLayer);
+
+    auto tiledRasterContext =
+        makeShared<RasterContext>(_resources->getLogger(), ExternalSurfaceRasterizationMethod::ACCURATE, true);
+    tiledRasterContext->setTiledRasterization(8, 2);
+    _rasterContext =
+        makeShared<RasterContext>(_resources->getLogger(), ExternalSurfaceRasterizationMethod::ACCURATE, true);
+
+    auto expectedBitmap = makeShared<TestBitmap>(37, 29);
+    auto outputBitmap = makeShared<TestBitmap>(37, 29);
+
+    for (size_t i = 0; i < 3; i++) {
+        auto displayList = Valdi::makeShared<DisplayList>(_contentLayer->getFrame().size(), TimePoint(0.0));
+        DrawMetrics metrics;
+        _contentLayer->draw(*displayList, metrics);
+
+        auto expectedResult = _rasterContext->raster(displayList, expectedBitmap, true);
+        ASSERT_TRUE(expectedResult) << expectedResult.description();
+        auto result = tiledRasterContext->raster(displayList, outputBitmap, true);
+        ASSERT_TRUE(result) << result.description();
+
+        ASSERT_EQ(expectedResult.value().renderedPixelsCount, result.value().renderedPixelsCount);
+        ASSERT_EQ(*expectedBitmap, *outputBitmap) << "iteration " << i;
+
+        rotatedLayer->setTranslationX(static_cast<Scalar>(i + 1) * -3.5f);
+        rotatedLayer->setBackgroundColor(i % 2 == 0 ? Color::green() : Color::blue());
+    }
+}
+
+TEST_F(RasterContextTests, tiledRasterSupportsExternalSurfaces) {
+    _contentLayer->setBackgroundColor(Color::red());
+
+    auto centerLayer = makeLayer<ExternalLayer>(_resources);
+    auto externalSurface = makeShared<RasterContextTestExternalSurface>(_bitmapFactory, Color::green());
+    centerLayer->setExternalSurface(externalSurface);
+    _contentLayer->addChild(centerLayer);
+
+    _contentLayer->setFrame(Rect::makeXYWH(0, 0, 4, 4));
+    centerLayer->setFrame(Rect::makeXYWH(1, 1, 2, 2));
+
+    _rasterContext->setTiledRasterization(1, 4);
+
+    auto result = raster();
+    ASSERT_TRUE(result) << result.description();
+
+    ASSERT_EQ(*result.value(),
+              std::initializer_list<Color>({
+                  // clang-format off
+                Color::red(), Color::red(), Color::red(), Color::red(),
+                Color::red(), Color::green(), Color::green(), Color::red(),
+                Color::red(), Color::green(), Color::green(), Color::red(),
+                Color::red(), Color::red(), Color::red(), Color::red(),
+                  // clang-format on
+              }));
+
+    // The external surface should be rasterized once, not once per tile
+    ASSERT_EQ(1, _bitmapFactory->createdBitmapCount);
+    ASSERT_EQ(1, externalSurface->rasterCount);
+}
+
 } // namespace snap::drawing
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+
+#include "snap_drawing/cpp/Layers/TextLayer.hpp"
+#include "snap_drawing/cpp/Text/FontManager.hpp"
+#include "snap_drawing/cpp/Text/TextLayoutCache.hpp"
+#include "valdi_core/cpp/Utils/ConsoleLogger.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
+
+#include <cmath>
+
+using namespace Valdi;
+
+namespace snap::drawing {
+
+static Ref<TextLayout> makeTestTextLayout(Size maxSize, const Rect& bounds, bool fitsInMaxSize) {
+    std::vector<TextLayoutEntry> entries;
+    entries.emplace_back(bounds, std::nullopt, std::vector<TextLayoutEntrySegment>());
+    return makeShared<TextLayout>(
+        maxSize, std::move(entries), std::vector<TextLayoutDecorationEntry>(), {}, fitsInMaxSize);
+}
+
+static TextLayoutCacheKey makeTestKey(std::string_view text) {
+    TextLayoutCacheKey key;
+    key.text = StringCache::getGlobal().makeString(text);
+    return key;
+}
+
+TEST(TextLayoutCache, onlyReturnsCompatibleLayouts) {
+    auto textLayout = makeTestTextLayout(Size::make(100, 100), Rect::makeXYWH(0, 0, 50, 20), true);
+
+    ASSERT_TRUE(TextLayoutCache::isCompatible(*textLayout, TextAlignLeft, Size::make(100, 100)));
+    ASSERT_TRUE(TextLayoutCache::isCompatible(*textLayout, TextAlignLeft, Size::make(50, 20)));
+    ASSERT_TRUE(TextLayoutCache::isCompatible(*textLayout, TextAlignLeft, Size::make(60, 30)));
+    // Text would break into more lines
+    ASSERT_FALSE(TextLayoutCache::isCompatible(*textLayout, TextAlignLeft, Size::make(40, 30)));
+    ASSERT_FALSE(TextLayoutCache::isCompatible(*textLayout, TextAlignLeft, Size::make(60, 10)));
+    // Text might fit in less lines
+    ASSERT_FALSE(TextLayoutCache::isCompatible(*textLayout, TextAlignLeft, Size::make(120, 30)));
+    // Lines would be positioned differently
+    ASSERT_FALSE(TextLayoutCache::isCompatible(*textLayout, TextAlignCenter, Size::make(60, 30)));
+    ASSERT_TRUE(TextLayoutCache::isCompatible(*textLayout, TextAlignCenter, Size::make(100, 30)));
+
+    auto truncatedTextLayout = makeTestTextLayout(Size::make(100, 100), Rect::makeXYWH(0, 0, 50, 20), false);
+    ASSERT_TRUE(TextLayoutCache::isCompatible(*truncatedTextLayout, TextAlignLeft, Size::make(100, 100)));
+    ASSERT_FALSE(TextLayoutCache::isCompatible(*truncatedTextLayout, TextAlignLeft, Size::make(60, 30)));
+}
+
+TEST(TextLayoutCache, canFindInsertedLayouts) {
+    TextLayoutCache cache(TextLayoutCache::kDefaultMaxSizeBytes);
+    auto key = makeTestKey("Hello");
+    auto textLayout = makeTestTextLayout(Size::make(100, 100), Rect::makeXYWH(0, 0, 50, 20), true);
+
+    ASSERT_EQ(nullptr, cache.find(key, Size::make(100, 100)));
+
+    cache.insert(key, textLayout);
+
+    ASSERT_EQ(textLayout, cache.find(key, Size::make(50, 20)));
+    ASSERT_EQ(nullptr, cache.find(key, Size::make(40, 20)));
+    ASSERT_EQ(nullptr, cache.find(makeTestKey("World"), Size::make(50, 20)));
+
+    auto otherKey = makeTestKey("Hello");
+    otherKey.numberOfLines = 0;
+    ASSERT_EQ(nullptr, cache.find(otherKey, Size::make(50, 20)));
+
+    auto metrics = cache.getMetrics();
+    ASSERT_EQ(static_cast<size_t>(1), metrics.hits);
+    ASSERT_EQ(static_cast<size_t>(4), metrics.misses);
+    ASSERT_EQ(static_cast<size_t>(1), metrics.entriesCount);
+    ASSERT_DOUBLE_EQ(1.0 / 5.0, metrics.getHitRate());
+}
+
+TEST(TextLayoutCache, keepsLayoutsForMultipleMaxSizes) {
+    TextLayoutCache cache(TextLayoutCache::kDefaultMaxSizeBytes);
+    auto key = makeTestKey("Hello");
+    auto wideTextLayout = makeTestTextLayout(Size::make(100, 100), Rect::makeXYWH(0, 0, 90, 20), true);
+    auto narrowTextLayout = makeTestTextLayout(Size::make(50, 100), Rect::makeXYWH(0, 0, 45, 40), true);
+
+    cache.insert(key, wideTextLayout);
+    cache.insert(key, narrowTextLayout);
+
+    ASSERT_EQ(wideTextLayout, cache.find(key, Size::make(95, 20)));
+    ASSERT_EQ(narrowTextLayout, cache.find(key, Size::make(48, 40)));
+    ASSERT_EQ(static_cast<size_t>(1), cache.getMetrics().entriesCount);
+}
+
+TEST(TextLayoutCache, evictsLeastRecentlyUsedEntries) {
+    auto textLayout = makeTestTextLayout(Size::make(100, 100), Rect::makeXYWH(0, 0, 50, 20), true);
+
+    TextLayoutCache cache(TextLayoutCache::kDefaultMaxSizeBytes);
+    cache.insert(makeTestKey("1"), textLayout);
+    auto entrySize = cache.getMetrics().sizeBytes;
+    ASSERT_TRUE(entrySize > TextLayoutCache::estimateByteSize(*textLayout));
+
+    // Only room for two entries
+    cache.setMaxSizeBytes(entrySize * 2 + entrySize / 2);
+    cache.insert(makeTestKey("2"), textLayout);
+    // Makes 2 the least recently used entry
+    ASSERT_NE(nullptr, cache.find(makeTestKey("1"), Size::make(100, 100)));
+    cache.insert(makeTestKey("3"), textLayout);
+
+    ASSERT_NE(nullptr, cache.find(makeTestKey("1"), Size::make(100, 100)));
+    ASSERT_EQ(nullptr, cache.find(makeTestKey("2"), Size::make(100, 100)));
+    ASSERT_NE(nullptr, cache.find(makeTestKey("3"), Size::make(100, 100)));
+
+    auto metrics = cache.getMetrics();
+    ASSERT_EQ(static_cast<size_t>(1), metrics.evictions);
+    ASSERT_EQ(static_cast<size_t>(2), metrics.entriesCount);
+    ASSERT_EQ(entrySize * 2, metrics.sizeBytes);
+
+    cache.setMaxSizeBytes(entrySize);
+    ASSERT_EQ(static_cast<size_t>(2), cache.getMetrics().evictions);
+    ASSERT_EQ(entrySize, cache.getMetrics().sizeBytes);
+    ASSERT_EQ(entrySize, cache.getMaxSizeBytes());
+}
+
+TEST(TextLayoutCache, boundsLayoutsPerEntry) {
+    TextLayoutCache cache(TextLayoutCache::kDefaultMaxSizeBytes);
+    auto key = makeTestKey("Hello");
+    auto textLayout = makeTestTextLayout(Size::make(100, 100), Rect::makeXYWH(0, 0, 50, 20), true);
+
+    cache.insert(key, textLayout);
+    auto entrySize = cache.getMetrics().sizeBytes;
+
+    for (size_t i = 0; i < TextLayoutCache::kMaxLayoutsPerEntry * 2; i++) {
+        cache.insert(key, textLayout);
+    }
+
+    auto layoutSize = TextLayoutCache::estimateByteSize(*textLayout);
+    ASSERT_EQ(entrySize + layoutSize * (TextLayoutCache::kMaxLayoutsPerEntry - 1), cache.getMetrics().sizeBytes);
+
+    cache.clear();
+    ASSERT_EQ(static_cast<size_t>(0), cache.getMetrics().sizeBytes);
+}
+
+TEST(TextLayoutCache, measuredLayoutCanBeDrawn) {
+    auto fontManager = makeShared<FontManager>(ConsoleLogger::getLogger());
+    fontManager->load();
+    auto font = fontManager->getDefaultFont().moveValue();
+    auto cache = makeShared<TextLayoutCache>(TextLayoutCache::kDefaultMaxSizeBytes);
+    auto text = STRING_LITERAL("Hello World! This text is long enough to span multiple lines");
+
+    auto measure = [&](Size maxSize) {
+        return TextLayer::measureText(maxSize,
+                                      text,
+                                      nullptr,
+                                      font,
+                                      TextAlignLeft,
+                                      TextDecorationNone,
+                                      TextOverflowEllipsis,
+                                      0,
+                                      1.0f,
+                                      0.0f,
+                                      false,
+                                      false,
+                                      0.0,
+                                      false,
+                                      1.0f,
+                                      1.0f,
+                                      fontManager,
+                                      cache);
+    };
+
+    auto measuredSize = measure(Size::make(200, 5000));
+    auto uncachedSize = TextLayer::measureText(Size::make(200, 5000),
+                                               text,
+                                               nullptr,
+                                               font,
+                                               TextAlignLeft,
+                                               TextDecorationNone,
+                                               TextOverflowEllipsis,
+                                               0,
+                                               1.0f,
+                                               0.0f,
+                                               false,
+                                               false,
+                                               0.0,
+                                               false,
+                                               1.0f,
+                                               1.0f,
+                                               fontManager,
+                                               nullptr);
+    ASSERT_EQ(uncachedSize, measuredSize);
+
+    // Measuring again with the measured size gives the same result from the cache
+    auto frameSize = Size::make(std::ceil(measuredSize.width), std::ceil(measuredSize.height));
+    ASSERT_EQ(measuredSize, measure(frameSize));
+
+    TextLayoutCacheKey key;
+    key.text = text;
+    key.font = font;
+    key.numberOfLines = 0;
+    auto textLayout = cache->find(key, frameSize);
+    ASSERT_NE(nullptr, textLayout);
+    ASSERT_FALSE(textLayout->getEntries().empty());
+    ASSERT_NE(nullptr, textLayout->getEntries()[0].textBlob);
+
+    auto metrics = cache->getMetrics();
+    ASSERT_EQ(static_cast<size_t>(2), metrics.hits);
+    ASSERT_EQ(static_cast<size_t>(1), metrics.misses);
+}
+
+} // namespace snap::drawing
@@ -3,6 +3,9 @@
 #include "snap_drawing/cpp/Text/TextShaperCache.hpp"
 #include "snap_drawing/cpp/Utils/UTFUtils.hpp"
 
+#include <atomic>
+#include <thread>
+
 namespace snap::drawing {
 
 static std::vector<ShapedGlyph> toGlyphVec(const ShapedGlyph* glyphs, size_t length) {
@@ -193,4 +196,73 @@ TEST(TextShaperCache, removesLeastRecentlyUsedWhenFull) {
     ASSERT_TRUE(cache.contains(makeCacheKey(1, characters4)));
 }
 
+TEST(ConcurrentTextShaperCache, canInsertAndGet) {
+    ConcurrentTextShaperCache cache(64);
+
+    auto characters = utf8ToUnicode("Hello World what is going on!");
+    auto shapedGlyphs = generateGlyphVec(characters.data(), characters.size());
+
+    std::vector<ShapedGlyph> result;
+    ASSERT_FALSE(cache.find(makeCacheKey(1, characters), result));
+    ASSERT_TRUE(result.empty());
+
+    cache.insert(makeCacheKey(1, characters), shapedGlyphs.data(), shapedGlyphs.size());
+
+    ASSERT_TRUE(cache.contains(makeCacheKey(1, characters)));
+    ASSERT_FALSE(cache.contains(makeCacheKey(2, characters)));
+
+    ASSERT_TRUE(cache.find(makeCacheKey(1, characters), result));
+    ASSERT_EQ(shapedGlyphs, result);
+
+    // Glyphs should be appended
+    ASSERT_TRUE(cache.find(makeCacheKey(1, characters), result));
+    ASSERT_EQ(shapedGlyphs.size() * 2, result.size());
+
+    cache.clear();
+
+    ASSERT_FALSE(cache.contains(makeCacheKey(1, characters)));
+}
+
+TEST(ConcurrentTextShaperCache, supportsConcurrentAccess) {
+    constexpr size_t kThreadsCount = 4;
+    constexpr size_t kWordsCount = 200;
+
+    // Smaller than the number of words so that entries get evicted while other threads read them
+    ConcurrentTextShaperCache cache(kWordsCount / 2);
+
+    std::vector<std::vector<Character>> words;
+    for (size_t i = 0; i < kWordsCount; i++) {
+        words.emplace_back(utf8ToUnicode("word" + std::to_string(i)));
+    }
+
+    std::atomic<size_t> mismatches = 0;
+    std::vector<std::thread> threads;
+    for (size_t threadIndex = 0; threadIndex < kThreadsCount; threadIndex++) {
+        threads.emplace_back([&, threadIndex]() {
+            std::vector<ShapedGlyph> out;
+            for (size_t iteration = 0; iteration < 20; iteration++) {
+                for (size_t i = 0; i < kWordsCount; i++) {
+                    const auto& word = words[(i + threadIndex * 7) % kWordsCount];
+                    auto expectedGlyphs = generateGlyphVec(word.data(), word.size());
+
+                    out.clear();
+                    if (cache.find(makeCacheKey(1, word), out)) {
+                        if (out != expectedGlyphs) {
+                            mismatches++;
+                        }
+                    } else {
+                        cache.insert(makeCacheKey(1, word), expectedGlyphs.data(), expectedGlyphs.size());
+                    }
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(static_cast<size_t>(0), mismatches.load());
+}
+
 } // namespace snap::drawing
@@ -153,6 +153,7 @@ export interface ValdiRuntime extends RuntimeBase {
 
   startTraceRecording(): number;
   stopTraceRecording(id: number): any[];
+  stopTraceRecordingAsChromeTrace(id: number): string;
 
   submitDebugMessage: SubmitDebugMessageFunc;
 
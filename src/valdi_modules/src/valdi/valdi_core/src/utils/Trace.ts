@@ -42,6 +42,15 @@ export function stopTraceRecording(id: number): RecordedTrace[] {
   return out;
 }
 
+/**
+ * Stop recording the traces from a previous startTraceRecording call.
+ * Returns the captured traces as a Chrome trace event JSON document,
+ * which can be opened with Perfetto (ui.perfetto.dev) or chrome://tracing.
+ */
+export function stopTraceRecordingAsChromeTrace(id: number): string {
+  return runtime.stopTraceRecordingAsChromeTrace(id);
+}
+
 /**
  * Execute the given function and associate it with a traced label
  * @param tag the trace tag to use
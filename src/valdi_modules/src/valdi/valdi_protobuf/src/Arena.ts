@@ -99,6 +99,24 @@ export class Arena implements IArena {
     });
   }
 
+  batchDecodeMessagesAsync(constructor: IMessageConstructor, data: readonly Uint8Array[]): Promise<IMessage<any>[]> {
+    return new Promise((resolve, reject) => {
+      this.protobuf.batchDecodeMessagesAsync(
+        this.$native,
+        constructor.messageFactory,
+        constructor.descriptorIndex,
+        data.slice(),
+        makeSingleCallInterruptibleCallback((messageIndexes, error) => {
+          if (messageIndexes !== undefined) {
+            resolve(messageIndexes.map(messageIndex => this.getMessageInstance(constructor, messageIndex)));
+          } else {
+            reject(new Error(error));
+          }
+        }),
+      );
+    });
+  }
+
   decodeMessageDebugJSONAsync(constructor: IMessageConstructor, data: string): Promise<IMessage<any>> {
     return new Promise((resolve, reject) => {
       this.protobuf.decodeMessageDebugJSONAsync(
@@ -183,6 +183,15 @@ class DescriptorPool implements IDescriptorPool {
     return this.protobuf.getFieldsForMessageDescriptor(this.nativeMessageFactory, descriptorIndex);
   }
 
+  setMessageProjection(messagePath: string, fieldPaths: readonly string[]): void {
+    const descriptorIndex = this.descriptorNames.indexOf(messagePath);
+    if (descriptorIndex < 0) {
+      throw new Error(`Unknown message type ${messagePath}`);
+    }
+
+    this.protobuf.setMessageProjection?.(this.nativeMessageFactory, descriptorIndex, [...fieldPaths]);
+  }
+
   getMessageNamespace(messagePath: string): IMessageNamespace | undefined {
     const components = messagePath.split('.');
     let current = this.namespaces;
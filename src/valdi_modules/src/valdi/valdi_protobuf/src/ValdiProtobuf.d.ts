@@ -75,6 +75,8 @@ export interface ValdiProtobufModule {
 
   getNamespaceEntries(factory: INativeMessageFactory, namespaceId: number): INativeNamespaceEntries;
 
+  setMessageProjection?(factory: INativeMessageFactory, messageDescriptorIndex: number, fieldPaths: string[]): void;
+
   createMessage(
     arena: INativeMessageArena,
     factory: INativeMessageFactory,
@@ -96,6 +98,14 @@ export interface ValdiProtobufModule {
     callback: (messageIndex: INativeMessageIndex | undefined, error: string | undefined) => void,
   ): void;
 
+  batchDecodeMessagesAsync(
+    arena: INativeMessageArena,
+    factory: INativeMessageFactory,
+    messageDescriptorIndex: number,
+    data: Uint8Array[],
+    callback: (messageIndexes: INativeMessageIndex[] | undefined, error: string | undefined) => void,
+  ): void;
+
   decodeMessageDebugJSONAsync(
     arena: INativeMessageArena,
     factory: INativeMessageFactory,
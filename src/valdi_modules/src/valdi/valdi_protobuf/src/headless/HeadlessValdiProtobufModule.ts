@@ -66,6 +66,15 @@ export class HeadlessValdiProtobufModule implements ValdiProtobufModule {
   ): void {
     throw new Error('Method not implemented.');
   }
+  batchDecodeMessagesAsync(
+    arena: INativeMessageArena,
+    factory: INativeMessageFactory,
+    messageDescriptorIndex: number,
+    data: Uint8Array[],
+    callback: (messageIndexes: number[] | undefined, error: string | undefined) => void,
+  ): void {
+    throw new Error('Method not implemented.');
+  }
   decodeMessageDebugJSONAsync(
     arena: INativeMessageArena,
     factory: INativeMessageFactory,
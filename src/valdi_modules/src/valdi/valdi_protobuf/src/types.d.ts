@@ -77,6 +77,12 @@ export interface IArena {
   createMessage(constructor: IMessageConstructor): IMessage;
   decodeMessage(constructor: IMessageConstructor, data: Uint8Array): IMessage;
   decodeMessageAsync(constructor: IMessageConstructor, data: Uint8Array): Promise<IMessage>;
+  /**
+   * Asynchronously decode a list of buffers of the same message type.
+   * The buffers are decoded in parallel across several threads, which
+   * is more efficient than decoding each buffer individually.
+   */
+  batchDecodeMessagesAsync(constructor: IMessageConstructor, data: readonly Uint8Array[]): Promise<IMessage[]>;
   encodeMessage(message: IMessage): Uint8Array;
   encodeMessageAsync(message: IMessage): Promise<Uint8Array>;
   decodeMessageDebugJSONAsync(constructor: IMessageConstructor, data: string): Promise<IMessage>;
@@ -135,6 +141,15 @@ export interface IDescriptorPool {
    * can be retrieved by passing my_package.MyMessage
    */
   getMessageNamespace(messagePath: string): IMessageNamespace | undefined;
+
+  /**
+   * Declare the field paths that will be read from the messages of the given
+   * message path, like "items.id" or "title". Messages of that type will only
+   * decode those fields, the other fields are kept as raw bytes until they are
+   * accessed and are preserved when the message is encoded again.
+   * This is a no-op if the native module does not support projections.
+   */
+  setMessageProjection(messagePath: string, fieldPaths: readonly string[]): void;
 }
 
 /**
@@ -1,6 +1,6 @@
 import { Arena, DecodingMode } from 'valdi_protobuf/src/Arena';
 import { loadDescriptorPoolFromProtoFiles } from 'valdi_protobuf/src/ProtobufBuilder';
-import { IArena, IMessage } from 'valdi_protobuf/src/types';
+import { IArena, IMessage, IMessageConstructor } from 'valdi_protobuf/src/types';
 import 'jasmine/src/jasmine';
 import { package_with_underscores, test } from './proto';
 
@@ -2213,6 +2213,48 @@ describe('Valdi Proto Runtime', () => {
       expect(decodedMessages[2].sfixed32).toBe(3);
       expect(decodedMessages[2].string).toBe('And Hello Again');
     });
+
+    it('can decode async in batch', async () => {
+      const arena = new Arena();
+
+      const encoded: Uint8Array[] = [];
+      let constructor: IMessageConstructor | undefined;
+      for (let i = 0; i < 20; i++) {
+        const message = test.Message.create(arena, {
+          sfixed32: i,
+          string: `Message ${i}`,
+        });
+        constructor = message.constructor as IMessageConstructor;
+        encoded.push(test.Message.encode(message));
+      }
+
+      const decodedMessages = await arena.batchDecodeMessagesAsync(constructor!, encoded);
+
+      expect(decodedMessages.length).toBe(20);
+
+      for (let i = 0; i < 20; i++) {
+        const decoded = decodedMessages[i] as test.Message;
+        expect(decoded.sfixed32).toBe(i);
+        expect(decoded.string).toBe(`Message ${i}`);
+      }
+    });
+
+    it('fails to decode async in batch with invalid data', async () => {
+      const arena = new Arena();
+
+      const message = test.Message.create(arena, { string: 'Hello World' });
+      const constructor = message.constructor as IMessageConstructor;
+      const encoded = test.Message.encode(message);
+
+      let error: Error | undefined;
+      try {
+        await arena.batchDecodeMessagesAsync(constructor, [encoded, new Uint8Array([0xff, 0xff, 0xff])]);
+      } catch (err: any) {
+        error = err;
+      }
+
+      expect(error).toBeDefined();
+    });
   });
 
   describe('JSON', () => {
@@ -2286,5 +2328,56 @@ describe('Valdi Proto Runtime', () => {
       expect(message.title).toBe('Hello World');
       expect(message.count).toBe(42);
     });
+
+    it('can decode messages with a projection', () => {
+      interface MyProjectedMessage {
+        id: number;
+        title: string;
+        count: number;
+      }
+
+      const descriptor = loadDescriptorPoolFromProtoFiles(
+        'my_projection_test.proto',
+        `
+      syntax = "proto3";
+      package my_projection_test;
+
+      message MyProjectedMessage {
+        int32 id = 1;
+        string title = 2;
+        int32 count = 3;
+      }
+      `,
+      );
+
+      const messageNamespace = descriptor.getMessageNamespace('my_projection_test.MyProjectedMessage');
+      expect(messageNamespace).toBeDefined();
+      const encoded = messageNamespace!.encode({ id: 1, title: 'Hello World', count: 42 });
+
+      descriptor.setMessageProjection('my_projection_test.MyProjectedMessage', ['title']);
+
+      const arena = new Arena();
+      const message = messageNamespace!.decode(arena, encoded);
+      expect((message as unknown as MyProjectedMessage).title).toBe('Hello World');
+      // Fields outside of the projection are still readable and are encoded back in place
+      expect(message.encode()).toEqual(encoded);
+      expect((message as unknown as MyProjectedMessage).count).toBe(42);
+    });
+
+    it('fails to set a projection on an unknown message', () => {
+      const descriptor = loadDescriptorPoolFromProtoFiles(
+        'my_unknown_projection_test.proto',
+        `
+      syntax = "proto3";
+      package my_unknown_projection_test;
+
+      message MyMessage {
+        int32 id = 1;
+      }
+      `,
+      );
+
+      expect(() => descriptor.setMessageProjection('my_unknown_projection_test.Unknown', ['id'])).toThrow();
+    });
   });
 });
@@ -90,6 +90,7 @@ export const parseAndLoadMessages = moduleInstance.parseAndLoadMessages?.bind(mo
 export const getFieldsForMessageDescriptor =
   moduleInstance.getFieldsForMessageDescriptor.bind(moduleInstance);
 export const getNamespaceEntries = moduleInstance.getNamespaceEntries.bind(moduleInstance);
+export const setMessageProjection = moduleInstance.setMessageProjection?.bind(moduleInstance);
 export const createMessage = moduleInstance.createMessage.bind(moduleInstance);
 export const decodeMessage = moduleInstance.decodeMessage.bind(moduleInstance);
 export const decodeMessageAsync = moduleInstance.decodeMessageAsync.bind(moduleInstance);
@@ -97,6 +98,7 @@ export const decodeMessageDebugJSONAsync =
   moduleInstance.decodeMessageDebugJSONAsync.bind(moduleInstance);
 export const encodeMessage = moduleInstance.encodeMessage.bind(moduleInstance);
 export const encodeMessageAsync = moduleInstance.encodeMessageAsync.bind(moduleInstance);
+export const batchDecodeMessagesAsync = moduleInstance.batchDecodeMessagesAsync.bind(moduleInstance);
 export const batchEncodeMessageAsync = moduleInstance.batchEncodeMessageAsync.bind(moduleInstance);
 export const encodeMessageToJSON = moduleInstance.encodeMessageToJSON.bind(moduleInstance);
 export const setMessageField = moduleInstance.setMessageField.bind(moduleInstance);
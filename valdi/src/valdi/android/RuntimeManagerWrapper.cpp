@@ -28,6 +28,7 @@
 #include "valdi/runtime/Utils/BytesUtils.hpp"
 #include "valdi/runtime/Utils/HTTPRequestManagerUtils.hpp"
 #include "valdi_core/NativeJavaScriptEngineType.hpp"
+#include "valdi_core/cpp/Threading/WorkerPoolDispatchQueue.hpp"
 #include "valdi_core/cpp/Utils/LoggerUtils.hpp"
 #include "valdi_core/cpp/Utils/Marshaller.hpp"
 #include "valdi_core/cpp/Utils/Trace.hpp"
@@ -145,7 +146,8 @@ RuntimeManagerWrapper::RuntimeManagerWrapper(JavaEnv env,
                                                                            _runtimeManager->getWorkerQueue(),
                                                                            maxCacheSizeInBytes);
 
-            snapDrawingRuntime->registerAssetLoaders(*_runtimeManager->getAssetLoaderManager());
+            snapDrawingRuntime->registerAssetLoaders(*_runtimeManager->getAssetLoaderManager(),
+                                                     _runtimeManager->getWorkerPool());
             snapDrawingRuntime->getFontManager()->setListener(
                 Valdi::makeShared<snap::drawing::FontResolverWithRuntimeManager>(_runtimeManager));
             applyDynamicTypeScale(snapDrawingRuntime);
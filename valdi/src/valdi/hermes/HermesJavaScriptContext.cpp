@@ -21,6 +21,8 @@
 #include "valdi_core/cpp/Utils/StringCache.hpp"
 #include "valdi_core/cpp/Utils/ValueUtils.hpp"
 
+#include "hermes/BCGen/HBC/BytecodeVersion.h"
+
 #ifdef HERMES_ENABLE_DEBUGGER
 #include "valdi/hermes/HermesDebuggerServer.hpp"
 #endif
@@ -249,6 +251,10 @@ bool HermesJavaScriptContext::supportsPreCompilation() const {
 #endif
 }
 
+StringBox HermesJavaScriptContext::getPreCompiledBytecodeVersion() const {
+    return STRING_FORMAT("hermes-hbc{}", ::hermes::hbc::BYTECODE_VERSION);
+}
+
 BytesView HermesJavaScriptContext::preCompile(const std::string_view& script,
                                               const std::string_view& sourceFilename,
                                               JSExceptionTracker& exceptionTracker) {
@@ -35,6 +35,8 @@ public:
 
     bool supportsPreCompilation() const final;
 
+    StringBox getPreCompiledBytecodeVersion() const final;
+
     JSValueRef evaluate(const std::string& script,
                         const std::string_view& sourceFilename,
                         JSExceptionTracker& exceptionTracker) final;
@@ -7,6 +7,7 @@
 
 #include "valdi/hermes/HermesJavaScriptContextFactory.hpp"
 #include "valdi/hermes/HermesJavaScriptContext.hpp"
+#include "valdi/runtime/Interfaces/IDiskCache.hpp"
 #include "valdi/runtime/JavaScript/JavaScriptHeapDumpBuilder.hpp"
 
 #ifdef HERMES_ENABLE_DEBUGGER
@@ -77,4 +78,34 @@ BytesView HermesJavaScriptContextFactory::dumpHeap(std::span<IJavaScriptContext*
     }
 }
 
+void HermesJavaScriptContextFactory::dumpHeapToDiskCache(std::span<IJavaScriptContext*> jsContexts,
+                                                         IDiskCache& diskCache,
+                                                         const Path& path,
+                                                         JSExceptionTracker& exceptionTracker) {
+    if constexpr (shouldEnableJsHeapDump()) {
+        // Nodes and edges are spilled next to the heap dump instead of being kept in memory,
+        // only the dump of one context at a time is held while it is merged
+        Valdi::JavaScriptHeapDumpBuilder heapDumpBuilder(diskCache.getRootPath());
+
+        for (auto* jsContext : jsContexts) {
+            auto heapDump = dynamic_cast<HermesJavaScriptContext*>(jsContext)->dumpHeap(exceptionTracker);
+            if (!exceptionTracker) {
+                return;
+            }
+
+            heapDumpBuilder.appendDump(heapDump.data(), heapDump.size(), exceptionTracker);
+            if (!exceptionTracker) {
+                return;
+            }
+        }
+
+        auto result = heapDumpBuilder.write(diskCache, path);
+        if (!result) {
+            exceptionTracker.onError(result.moveError());
+        }
+    } else {
+        exceptionTracker.onError("Heap dump support not enabled");
+    }
+}
+
 } // namespace Valdi::Hermes
@@ -26,6 +26,11 @@ public:
 
     BytesView dumpHeap(std::span<IJavaScriptContext*> jsContexts, JSExceptionTracker& exceptionTracker) final;
 
+    void dumpHeapToDiskCache(std::span<IJavaScriptContext*> jsContexts,
+                             IDiskCache& diskCache,
+                             const Path& path,
+                             JSExceptionTracker& exceptionTracker) final;
+
     void startJsDebuggerServer(ILogger& logger) final;
 
     void stopJsDebuggerServer() final;
@@ -270,6 +270,12 @@ bool QuickJSJavaScriptContext::supportsPreCompilation() const {
     return true;
 }
 
+Valdi::StringBox QuickJSJavaScriptContext::getPreCompiledBytecodeVersion() const {
+    // Should be updated whenever the QuickJS version is updated, as the bytecode
+    // format is not guaranteed to be stable across versions.
+    return STRING_LITERAL("quickjs-2021-03-27");
+}
+
 Valdi::BytesView QuickJSJavaScriptContext::preCompile(const std::string_view& script,
                                                       const std::string_view& sourceFilename,
                                                       Valdi::JSExceptionTracker& exceptionTracker) {
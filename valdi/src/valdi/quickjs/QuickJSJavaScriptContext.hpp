@@ -47,6 +47,8 @@ public:
 
     bool supportsPreCompilation() const override;
 
+    Valdi::StringBox getPreCompiledBytecodeVersion() const override;
+
     Valdi::JSValueRef evaluate(const std::string& script,
                                const std::string_view& sourceFilename,
                                Valdi::JSExceptionTracker& exceptionTracker) override;
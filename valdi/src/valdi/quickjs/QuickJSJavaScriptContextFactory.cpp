@@ -7,6 +7,7 @@
 
 #include "valdi/quickjs/QuickJSJavaScriptContextFactory.hpp"
 #include "valdi/quickjs/QuickJSJavaScriptContext.hpp"
+#include "valdi/runtime/Interfaces/IDiskCache.hpp"
 #include "valdi/runtime/JavaScript/JavaScriptHeapDumpBuilder.hpp"
 
 namespace ValdiQuickJS {
@@ -42,4 +43,25 @@ Valdi::BytesView QuickJSJavaScriptContextFactory::dumpHeap(std::span<Valdi::IJav
     }
 }
 
+void QuickJSJavaScriptContextFactory::dumpHeapToDiskCache(std::span<Valdi::IJavaScriptContext*> jsContexts,
+                                                          Valdi::IDiskCache& diskCache,
+                                                          const Valdi::Path& path,
+                                                          Valdi::JSExceptionTracker& exceptionTracker) {
+    if constexpr (Valdi::shouldEnableJsHeapDump()) {
+        // Nodes and edges are spilled next to the heap dump instead of being kept in memory
+        Valdi::JavaScriptHeapDumpBuilder heapDumpBuilder(diskCache.getRootPath());
+
+        for (auto* jsContext : jsContexts) {
+            dynamic_cast<QuickJSJavaScriptContext*>(jsContext)->dumpHeap(heapDumpBuilder);
+        }
+
+        auto result = heapDumpBuilder.write(diskCache, path);
+        if (!result) {
+            exceptionTracker.onError(result.moveError());
+        }
+    } else {
+        exceptionTracker.onError("Heap dump support not enabled");
+    }
+}
+
 } // namespace ValdiQuickJS
@@ -25,6 +25,11 @@ public:
 
     Valdi::BytesView dumpHeap(std::span<Valdi::IJavaScriptContext*> jsContexts,
                               Valdi::JSExceptionTracker& exceptionTracker) final;
+
+    void dumpHeapToDiskCache(std::span<Valdi::IJavaScriptContext*> jsContexts,
+                             Valdi::IDiskCache& diskCache,
+                             const Valdi::Path& path,
+                             Valdi::JSExceptionTracker& exceptionTracker) final;
 };
 
 } // namespace ValdiQuickJS
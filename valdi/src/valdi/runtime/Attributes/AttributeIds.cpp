@@ -12,7 +12,51 @@
 
 namespace Valdi {
 
-AttributeIds::AttributeIds() {
+static constexpr size_t kInitialSlotsCount = 64;
+static constexpr AttributeId kEmptySlot = 0;
+
+/**
+ Open addressing table of the ids, offset by one so that zero can mark an empty slot.
+ Slots and names are only written once, before the slot is published, and the table
+ is kept at most half full so that probe sequences stay short.
+ */
+struct AttributeIds::Table {
+    size_t mask;
+    std::unique_ptr<std::atomic<AttributeId>[]> slots;
+    std::unique_ptr<const StringBox*[]> names;
+
+    explicit Table(size_t slotsCount)
+        : mask(slotsCount - 1),
+          slots(new std::atomic<AttributeId>[slotsCount]),
+          names(new const StringBox*[getNamesCapacity()]) {
+        for (size_t i = 0; i < slotsCount; i++) {
+            slots[i].store(kEmptySlot, std::memory_order_relaxed);
+        }
+    }
+
+    size_t getNamesCapacity() const {
+        return (mask + 1) / 2;
+    }
+
+    void insert(AttributeId id, const StringBox* name) {
+        names[id] = name;
+        auto index = getSlotIndex(*name) & mask;
+        while (slots[index].load(std::memory_order_relaxed) != kEmptySlot) {
+            index = (index + 1) & mask;
+        }
+        slots[index].store(id + 1, std::memory_order_release);
+    }
+
+    static size_t getSlotIndex(const StringBox& name) {
+        // The hash of a StringBox is the address of its interned string, whose low bits are always zero
+        auto hash = name.hash();
+        hash ^= hash >> 17;
+        hash *= static_cast<size_t>(0x9E3779B97F4A7C15ULL);
+        return hash ^ (hash >> 15);
+    }
+};
+
+AttributeIds::AttributeIds() : _table(new Table(kInitialSlotsCount)) {
     // Start at 1
     getIdForName("");
 
@@ -39,31 +83,37 @@ AttributeIds::AttributeIds() {
     registerDefaultAttribute(DefaultAttributeAccessibilityId, "accessibilityId");
 }
 
-AttributeIds::~AttributeIds() = default;
+AttributeIds::~AttributeIds() {
+    delete _table.load();
+}
 
 AttributeId AttributeIds::getIdForName(std::string_view name) {
     return getIdForName(StringCache::getGlobal().makeString(name));
 }
 
 AttributeId AttributeIds::getIdForName(const StringBox& name) {
-    std::lock_guard<std::mutex> guard(_mutex);
-    const auto& it = _idForName.find(name);
-    if (it != _idForName.end()) {
-        return it->second;
+    // Fast path: the name is already registered, we don't need the lock.
+    auto id = findId(*_table.load(std::memory_order_acquire), name);
+    if (id) {
+        return id.value();
     }
 
-    auto id = _attributes.size();
-    _attributes.emplace_back(name);
-    _idForName[name] = id;
-    return id;
+    std::lock_guard<Mutex> guard(_mutex);
+    // The name might have been registered while we were waiting for the lock
+    id = findId(*_table.load(std::memory_order_relaxed), name);
+    if (id) {
+        return id.value();
+    }
+
+    return registerName(name);
 }
 
 StringBox AttributeIds::getNameForId(AttributeId id) const {
-    std::lock_guard<std::mutex> guard(_mutex);
-    if (id >= _attributes.size()) {
+    // The table is published before the count, so it contains at least the names we can see
+    if (id >= _namesCount.load(std::memory_order_acquire)) {
         return StringBox();
     }
-    return _attributes[id];
+    return *_table.load(std::memory_order_acquire)->names[id];
 }
 
 std::vector<AttributeId> AttributeIds::getIdsForNames(const std::vector<StringBox>& attributeNames) {
@@ -74,6 +124,43 @@ std::vector<AttributeId> AttributeIds::getIdsForNames(const std::vector<StringBo
     return attributeIds;
 }
 
+std::optional<AttributeId> AttributeIds::findId(const Table& table, const StringBox& name) {
+    auto index = Table::getSlotIndex(name) & table.mask;
+    for (;;) {
+        auto slot = table.slots[index].load(std::memory_order_acquire);
+        if (slot == kEmptySlot) {
+            return std::nullopt;
+        }
+        if (*table.names[slot - 1] == name) {
+            return slot - 1;
+        }
+        index = (index + 1) & table.mask;
+    }
+}
+
+AttributeId AttributeIds::registerName(const StringBox& name) {
+    auto id = _namesCount.load(std::memory_order_relaxed);
+    const auto* storedName = &_names.emplace_back(name);
+
+    auto* table = _table.load(std::memory_order_relaxed);
+    if (id >= table->getNamesCapacity()) {
+        auto* newTable = new Table((table->mask + 1) * 2);
+        for (AttributeId existingId = 0; existingId < id; existingId++) {
+            newTable->insert(existingId, table->names[existingId]);
+        }
+        newTable->insert(id, storedName);
+
+        _table.store(newTable, std::memory_order_release);
+        _retiredTables.emplace_back(table);
+    } else {
+        table->insert(id, storedName);
+    }
+
+    _namesCount.store(id + 1, std::memory_order_release);
+
+    return id;
+}
+
 void AttributeIds::registerDefaultAttribute(DefaultAttribute defaultAttribute, std::string_view name) {
     auto id = getIdForName(name);
     SC_ASSERT(defaultAttribute == id);
@@ -12,7 +12,11 @@
 #include "valdi_core/cpp/Utils/FlatMap.hpp"
 #include "valdi_core/cpp/Utils/Mutex.hpp"
 #include "valdi_core/cpp/Utils/StringBox.hpp"
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <string_view>
 #include <vector>
 
@@ -37,6 +41,13 @@ enum DefaultAttribute : AttributeId {
     DefaultAttributeAccessibilityId,
 };
 
+/**
+ Registry of the attribute names and their ids. Ids are assigned in registration order
+ and never change.
+ Lookups don't take any lock: they read the currently published table, whose existing
+ entries are never modified. The mutex is only taken to register a new name, which is
+ appended to the table, or published with a bigger copy of the table when it is full.
+ */
 class AttributeIds : public snap::NonCopyable {
 public:
     AttributeIds();
@@ -49,9 +60,21 @@ public:
     std::vector<AttributeId> getIdsForNames(const std::vector<StringBox>& names);
 
 private:
-    mutable std::mutex _mutex;
-    std::vector<StringBox> _attributes;
-    FlatMap<StringBox, AttributeId> _idForName;
+    struct Table;
+
+    Mutex _mutex;
+    // Elements of a deque are never moved when appending, tables reference them by address
+    std::deque<StringBox> _names;
+    std::atomic<Table*> _table;
+    std::atomic<size_t> _namesCount{0};
+    // Tables replaced by a bigger one. Readers might still be using them, they are deleted
+    // with the registry. As tables double in size, they use less memory than the current one.
+    std::vector<std::unique_ptr<Table>> _retiredTables;
+
+    static std::optional<AttributeId> findId(const Table& table, const StringBox& name);
+
+    // Should be called with the lock already acquired
+    AttributeId registerName(const StringBox& name);
 
     void registerDefaultAttribute(DefaultAttribute defaultAttribute, std::string_view name);
 };
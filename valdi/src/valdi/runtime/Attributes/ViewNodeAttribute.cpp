@@ -9,6 +9,7 @@
 #include "valdi/runtime/Attributes/AttributeHandler.hpp"
 #include "valdi/runtime/Attributes/AttributeOwner.hpp"
 #include "valdi/runtime/Attributes/AttributesApplier.hpp"
+#include "valdi/runtime/Attributes/ViewNodeAttributeStorage.hpp"
 
 #include "valdi_core/cpp/Utils/LoggerUtils.hpp"
 #include "valdi_core/cpp/Utils/ValueMap.hpp"
@@ -17,8 +18,9 @@
 
 namespace Valdi {
 
-ViewNodeAttribute::ViewNodeAttribute(const AttributeHandler* handler)
+ViewNodeAttribute::ViewNodeAttribute(const AttributeHandler* handler, ViewNodeAttributeStorage& storage)
     : _handler(handler),
+      _storage(&storage),
       _handlerNeedsView(handler->requiresView()),
       _handlerCanAffectLayout(handler->shouldInvalidateLayoutOnChange()),
       _handlerIsCompositePart(handler->isCompositePart()) {}
@@ -27,7 +29,7 @@ ViewNodeAttribute::~ViewNodeAttribute() {
     if (_hasSingleAttribute) {
         getSingleAttributeValue().~AttributeValue();
     } else if (_hasAttributeCollection) {
-        delete &getAttributeValueCollection();
+        _storage->destroyValueCollection(&getAttributeValueCollection());
     }
 }
 
@@ -79,7 +81,7 @@ bool ViewNodeAttribute::setValue(const AttributeOwner* owner, const Value& value
 
             _hasSingleAttribute = false;
 
-            *reinterpret_cast<AttributeValueCollection**>(&_valuesUnion) = new AttributeValueCollection();
+            *reinterpret_cast<AttributeValueCollection**>(&_valuesUnion) = _storage->makeValueCollection();
             _hasAttributeCollection = true;
 
             auto& attributeCollection = getAttributeValueCollection();
@@ -339,6 +341,10 @@ const StringBox& ViewNodeAttribute::getAttributeName() const {
     return _handler->getName();
 }
 
+const AttributeHandler* ViewNodeAttribute::getHandler() const {
+    return _handler;
+}
+
 Result<Void> ViewNodeAttribute::update(ViewTransactionScope& viewTransactionScope,
                                        ViewNode* viewNode,
                                        bool hasView,
@@ -432,19 +438,17 @@ void ViewNodeAttribute::markDirty() {
     }
 }
 
-Ref<ViewNodeAttribute> ViewNodeAttribute::copy() {
-    auto copy = makeShared<ViewNodeAttribute>(_handler);
+void ViewNodeAttribute::copyResolvedValueTo(ViewNodeAttribute& copy) {
+    SC_ASSERT(copy.empty());
 
     if (!empty()) {
         auto result = getResolvedPreprocessedValue();
         if (result) {
-            copy->unsafeSetAsTrivial(nullptr, Value(result.value()));
-            copy->getSingleAttributeValue().preprocessedValue = PreprocessedValue(result.moveValue());
+            copy.unsafeSetAsTrivial(nullptr, Value(result.value()));
+            copy.getSingleAttributeValue().preprocessedValue = PreprocessedValue(result.moveValue());
         }
-        copy->_appliedValueDirty = true;
+        copy._appliedValueDirty = true;
     }
-
-    return copy;
 }
 
 void ViewNodeAttribute::setHandler(const AttributeHandler* handler) {
@@ -9,6 +9,7 @@
 
 #include "valdi/runtime/Attributes/AttributeIds.hpp"
 #include "valdi/runtime/Attributes/AttributeValue.hpp"
+#include "utils/base/NonCopyable.hpp"
 #include "valdi/runtime/Attributes/PreprocessorCache.hpp"
 #include "valdi_core/cpp/Utils/Result.hpp"
 #include "valdi_core/cpp/Utils/Shared.hpp"
@@ -24,11 +25,18 @@ class AttributeHandler;
 class AttributeOwner;
 class CompositeAttribute;
 class ViewTransactionScope;
-
-class ViewNodeAttribute : public SimpleRefCountable {
+class ViewNodeAttributeStorage;
+class ViewNodeAttributeRef;
+
+/**
+ An attribute set on a ViewNode, holding the values of all its owners.
+ Instances are allocated by the ViewNodeAttributeStorage of the ViewNode
+ and referenced through ViewNodeAttributeRef.
+ */
+class ViewNodeAttribute : public snap::NonCopyable {
 public:
-    explicit ViewNodeAttribute(const AttributeHandler* handler);
-    ~ViewNodeAttribute() override;
+    ViewNodeAttribute(const AttributeHandler* handler, ViewNodeAttributeStorage& storage);
+    ~ViewNodeAttribute();
 
     /**
      Update the attribute to the given ViewNode.
@@ -48,9 +56,9 @@ public:
     void willAnimate();
 
     /**
-     Copy this attribute with its resolved value
+     Copy the resolved value of this attribute into the given empty attribute
      */
-    Ref<ViewNodeAttribute> copy();
+    void copyResolvedValueTo(ViewNodeAttribute& copy);
 
     /**
      Returns the value for the given owner.
@@ -119,6 +127,7 @@ public:
 
     AttributeId getAttributeId() const;
     const StringBox& getAttributeName() const;
+    const AttributeHandler* getHandler() const;
 
     /**
      Replace the attribute handler that this ViewNodeAttribute holds
@@ -126,7 +135,10 @@ public:
     void setHandler(const AttributeHandler* handler);
 
 private:
+    friend ViewNodeAttributeRef;
+
     const AttributeHandler* _handler;
+    ViewNodeAttributeStorage* _storage;
     // Set whenever animating an attribute for a ViewNode which doesn't have a view
     std::unique_ptr<Result<Value>> _pendingAnimatedValue;
 
@@ -143,6 +155,8 @@ private:
     bool _hasSingleAttribute = false;
     bool _hasAttributeCollection = false;
 
+    uint32_t _retainCount = 0;
+
     Result<Void> flushPendingAnimatedValue(ViewTransactionScope& viewTransactionScope,
                                            ViewNode* viewNode,
                                            const std::unique_ptr<Result<Value>>& pendingAnimatedValue,
@@ -0,0 +1,135 @@
+#include "valdi/runtime/Attributes/ViewNodeAttributeStorage.hpp"
+
+#include <algorithm>
+
+namespace Valdi {
+
+ViewNodeAttributeRef::ViewNodeAttributeRef(ViewNodeAttribute* attribute) : _attribute(attribute) {
+    if (_attribute != nullptr) {
+        _attribute->_retainCount++;
+    }
+}
+
+ViewNodeAttributeRef::ViewNodeAttributeRef(const ViewNodeAttributeRef& other)
+    : ViewNodeAttributeRef(other._attribute) {}
+
+ViewNodeAttributeRef::ViewNodeAttributeRef(ViewNodeAttributeRef&& other) noexcept : _attribute(other._attribute) {
+    other._attribute = nullptr;
+}
+
+ViewNodeAttributeRef::~ViewNodeAttributeRef() {
+    release();
+}
+
+ViewNodeAttributeRef& ViewNodeAttributeRef::operator=(const ViewNodeAttributeRef& other) {
+    if (this != &other) {
+        if (other._attribute != nullptr) {
+            other._attribute->_retainCount++;
+        }
+        release();
+        _attribute = other._attribute;
+    }
+    return *this;
+}
+
+ViewNodeAttributeRef& ViewNodeAttributeRef::operator=(ViewNodeAttributeRef&& other) noexcept {
+    if (this != &other) {
+        release();
+        _attribute = other._attribute;
+        other._attribute = nullptr;
+    }
+    return *this;
+}
+
+void ViewNodeAttributeRef::release() {
+    auto* attribute = _attribute;
+    if (attribute == nullptr) {
+        return;
+    }
+    _attribute = nullptr;
+
+    if (--attribute->_retainCount == 0) {
+        attribute->_storage->destroyAttribute(attribute);
+    }
+}
+
+ViewNodeAttributeStorage::ViewNodeAttributeStorage() = default;
+
+ViewNodeAttributeStorage::~ViewNodeAttributeStorage() {
+    clear();
+}
+
+ViewNodeAttributeStorage::iterator ViewNodeAttributeStorage::lowerBound(AttributeId id) {
+    return std::lower_bound(begin(), end(), id, [](const Entry& entry, AttributeId id) { return entry.first < id; });
+}
+
+ViewNodeAttributeStorage::iterator ViewNodeAttributeStorage::find(AttributeId id) {
+    auto it = lowerBound(id);
+    if (it != end() && it->first == id) {
+        return it;
+    }
+    return end();
+}
+
+ViewNodeAttributeStorage::const_iterator ViewNodeAttributeStorage::find(AttributeId id) const {
+    return const_cast<ViewNodeAttributeStorage*>(this)->find(id);
+}
+
+const ViewNodeAttributeRef& ViewNodeAttributeStorage::emplace(AttributeId id, const AttributeHandler* handler) {
+    auto it = lowerBound(id);
+    if (it != end() && it->first == id) {
+        return it->second;
+    }
+
+    ViewNodeAttributeRef attribute(_attributesPool.make(handler, *this));
+    auto index = static_cast<size_t>(it - begin());
+    _entries.emplace(_entries.begin() + index, id, std::move(attribute));
+    return _entries[index].second;
+}
+
+const ViewNodeAttributeRef& ViewNodeAttributeStorage::replace(AttributeId id, const AttributeHandler* handler) {
+    ViewNodeAttributeRef attribute(_attributesPool.make(handler, *this));
+
+    auto it = lowerBound(id);
+    if (it != end() && it->first == id) {
+        // The previous attribute is destroyed here if nobody else references it
+        it->second = std::move(attribute);
+        return it->second;
+    }
+
+    auto index = static_cast<size_t>(it - begin());
+    _entries.emplace(_entries.begin() + index, id, std::move(attribute));
+    return _entries[index].second;
+}
+
+ViewNodeAttributeStorage::iterator ViewNodeAttributeStorage::erase(iterator it) {
+    auto index = static_cast<size_t>(it - begin());
+    _entries.erase(_entries.begin() + index);
+    return begin() + index;
+}
+
+void ViewNodeAttributeStorage::clear() {
+    _entries.clear();
+}
+
+AttributeValueCollection* ViewNodeAttributeStorage::makeValueCollection() {
+    return _valueCollectionsPool.make();
+}
+
+void ViewNodeAttributeStorage::destroyValueCollection(AttributeValueCollection* valueCollection) {
+    _valueCollectionsPool.destroy(valueCollection);
+}
+
+void ViewNodeAttributeStorage::destroyAttribute(ViewNodeAttribute* attribute) {
+    _attributesPool.destroy(attribute);
+}
+
+size_t ViewNodeAttributeStorage::getAllocatedBytes() const {
+    auto bytes = _attributesPool.getAllocatedBytes() + _valueCollectionsPool.getAllocatedBytes();
+    if (_entries.capacity() > kInlineAttributesCount) {
+        bytes += _entries.capacity() * sizeof(Entry);
+    }
+    return bytes;
+}
+
+} // namespace Valdi
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "valdi/runtime/Attributes/AttributeValue.hpp"
+#include "valdi/runtime/Attributes/ViewNodeAttribute.hpp"
+#include "valdi/runtime/Utils/ObjectBlockPool.hpp"
+#include "valdi_core/cpp/Utils/SmallVector.hpp"
+
+#include <utility>
+
+namespace Valdi {
+
+/**
+ Strong reference to a ViewNodeAttribute allocated by a ViewNodeAttributeStorage.
+ The retain count is not atomic, as the attributes of a ViewNode are only accessed
+ while holding the lock of its tree. The attribute goes back to its storage when the
+ last reference goes away, which lets callers keep using an attribute that was removed
+ while it was being applied.
+ */
+class ViewNodeAttributeRef {
+public:
+    ViewNodeAttributeRef() = default;
+    ViewNodeAttributeRef(const std::nullptr_t& /*ptr*/) : ViewNodeAttributeRef() {}
+    explicit ViewNodeAttributeRef(ViewNodeAttribute* attribute);
+    ViewNodeAttributeRef(const ViewNodeAttributeRef& other);
+    ViewNodeAttributeRef(ViewNodeAttributeRef&& other) noexcept;
+    ~ViewNodeAttributeRef();
+
+    ViewNodeAttributeRef& operator=(const ViewNodeAttributeRef& other);
+    ViewNodeAttributeRef& operator=(ViewNodeAttributeRef&& other) noexcept;
+
+    ViewNodeAttribute* get() const {
+        return _attribute;
+    }
+
+    ViewNodeAttribute* operator->() const {
+        return _attribute;
+    }
+
+    ViewNodeAttribute& operator*() const {
+        return *_attribute;
+    }
+
+    bool operator==(std::nullptr_t) const {
+        return _attribute == nullptr;
+    }
+
+    bool operator!=(std::nullptr_t) const {
+        return _attribute != nullptr;
+    }
+
+private:
+    ViewNodeAttribute* _attribute = nullptr;
+
+    void release();
+};
+
+/**
+ Storage for the attributes of a ViewNode, which exposes the same map-like interface as
+ the FlatMap it replaces. Entries are kept sorted by attribute id in a small inline array,
+ which only goes to the heap for nodes with many attributes. The attributes themselves,
+ and the value collections used when multiple owners set the same attribute, come from
+ pools owned by the storage, so that setting an attribute doesn't allocate once the
+ pools have grown to fit the node. The first attributes are stored inline and the pools
+ then grow from small blocks, since most nodes only have a few attributes.
+ */
+class ViewNodeAttributeStorage : public snap::NonCopyable {
+public:
+    using Entry = std::pair<AttributeId, ViewNodeAttributeRef>;
+    using iterator = Entry*;
+    using const_iterator = const Entry*;
+
+    static constexpr size_t kInlineAttributesCount = 4;
+    static constexpr size_t kInlineAttributesPoolCapacity = 2;
+
+    ViewNodeAttributeStorage();
+    ~ViewNodeAttributeStorage();
+
+    iterator find(AttributeId id);
+    const_iterator find(AttributeId id) const;
+
+    iterator begin() {
+        return _entries.data();
+    }
+
+    iterator end() {
+        return _entries.data() + _entries.size();
+    }
+
+    const_iterator begin() const {
+        return _entries.data();
+    }
+
+    const_iterator end() const {
+        return _entries.data() + _entries.size();
+    }
+
+    size_t size() const {
+        return _entries.size();
+    }
+
+    bool empty() const {
+        return _entries.empty();
+    }
+
+    /**
+     Returns the attribute for the given id, creating it with the given handler
+     if it doesn't exist yet.
+     */
+    const ViewNodeAttributeRef& emplace(AttributeId id, const AttributeHandler* handler);
+
+    /**
+     Replaces the attribute for the given id by a new empty attribute using the given handler.
+     */
+    const ViewNodeAttributeRef& replace(AttributeId id, const AttributeHandler* handler);
+
+    iterator erase(iterator it);
+
+    void clear();
+
+    AttributeValueCollection* makeValueCollection();
+    void destroyValueCollection(AttributeValueCollection* valueCollection);
+
+    /**
+     Returns the number of bytes allocated on the heap by this storage.
+     */
+    size_t getAllocatedBytes() const;
+
+private:
+    friend ViewNodeAttributeRef;
+
+    // Declared before the entries, so that they are destroyed after the attributes
+    // Value collections are rare, they are never stored inline
+    ObjectBlockPool<AttributeValueCollection, 0, 1> _valueCollectionsPool;
+    ObjectBlockPool<ViewNodeAttribute, kInlineAttributesPoolCapacity> _attributesPool;
+    SmallVector<Entry, kInlineAttributesCount> _entries;
+
+    iterator lowerBound(AttributeId id);
+
+    void destroyAttribute(ViewNodeAttribute* attribute);
+};
+
+} // namespace Valdi
@@ -357,7 +357,7 @@ const AttributeHandler* ViewNodeAttributesApplier::getAttributeHandler(Attribute
     return attributeHandler;
 }
 
-Ref<ViewNodeAttribute> ViewNodeAttributesApplier::emplaceAttribute(AttributeId id) {
+ViewNodeAttributeRef ViewNodeAttributesApplier::emplaceAttribute(AttributeId id) {
     auto it = _attributes.find(id);
     if (it != _attributes.end()) {
         return it->second;
@@ -371,9 +371,8 @@ Ref<ViewNodeAttribute> ViewNodeAttributesApplier::emplaceAttribute(AttributeId i
         return nullptr;
     }
 
-    auto attribute = makeShared<ViewNodeAttribute>(attributeHandler);
-
-    _attributes.mutate([&](auto& container) { container[id] = attribute; });
+    ViewNodeAttributeRef attribute;
+    _attributes.mutate([&](auto& container) { attribute = container.emplace(id, attributeHandler); });
 
     return attribute;
 }
@@ -384,7 +383,10 @@ void ViewNodeAttributesApplier::copyViewLayoutAttributes(ViewNodeAttributesAppli
             auto name = it.first;
             auto attribute = it.second;
 
-            attributesApplier._attributes.mutate([&](auto& container) { container[name] = attribute->copy(); });
+            attributesApplier._attributes.mutate([&](auto& container) {
+                const auto& copy = container.replace(name, attribute->getHandler());
+                attribute->copyResolvedValueTo(*copy);
+            });
         }
     }
 }
@@ -437,6 +439,10 @@ ILogger& ViewNodeAttributesApplier::getLogger() const {
     return _viewNode->getLogger();
 }
 
+size_t ViewNodeAttributesApplier::getAttributesAllocatedBytes() const {
+    return _attributes.getContainer().getAllocatedBytes();
+}
+
 void ViewNodeAttributesApplier::setBoundAttributes(Ref<BoundAttributes> boundAttributes) {
     auto hadAttributes = _boundAttributes != nullptr;
     _boundAttributes = std::move(boundAttributes);
@@ -9,6 +9,7 @@
 
 #include "valdi/runtime/Attributes/AttributeOwner.hpp"
 #include "valdi/runtime/Attributes/AttributesApplier.hpp"
+#include "valdi/runtime/Attributes/ViewNodeAttributeStorage.hpp"
 #include "valdi/runtime/Utils/SafeReentrantContainer.hpp"
 #include "valdi_core/cpp/Utils/FlatMap.hpp"
 #include "valdi_core/cpp/Utils/FlatSet.hpp"
@@ -21,7 +22,6 @@ class ViewNode;
 class BoundAttributes;
 class ILogger;
 class CompositeAttribute;
-class ViewNodeAttribute;
 class AttributeHandler;
 class ViewTransactionScope;
 
@@ -88,6 +88,11 @@ public:
 
     ILogger& getLogger() const;
 
+    /**
+     Returns the number of bytes allocated on the heap to store the attributes.
+     */
+    size_t getAttributesAllocatedBytes() const;
+
     void onApplyAttributeFailed(AttributeId id, const Error& error);
 
     void destroy();
@@ -97,7 +102,7 @@ private:
     Ref<BoundAttributes> _boundAttributes;
 
     // Attributes set on this applier.
-    SafeReentrantContainer<FlatMap<AttributeId, Ref<ViewNodeAttribute>>> _attributes;
+    SafeReentrantContainer<ViewNodeAttributeStorage> _attributes;
     FlatMap<AttributeId, Ref<Animator>> _dirtyCompositeAttributes;
 
     bool _hasView = false;
@@ -106,7 +111,7 @@ private:
                                   AttributeId compositeId,
                                   const Ref<Animator>& animator);
 
-    Ref<ViewNodeAttribute> emplaceAttribute(AttributeId id);
+    ViewNodeAttributeRef emplaceAttribute(AttributeId id);
     void processAttributeChange(ViewTransactionScope& viewTransactionScope,
                                 AttributeId id,
                                 ViewNodeAttribute& attribute,
@@ -143,6 +143,8 @@ void CSSAttributesManager::applyAttributesOfStyle(const Ref<CSSAttributes>& cssA
 }
 
 void CSSAttributesManager::updateCSS(const CSSAttributesManagerUpdateContext& context) {
+    _parentChanged = false;
+
     if (_cssNodeContainerFromParentOveridde != nullptr && _cssNodeContainerFromParentOveridde->cssDocument != nullptr) {
         _cssNodeContainerFromParentOveridde->node.applyCss(context.viewTransactionScope,
                                                            *_cssNodeContainerFromParentOveridde->cssDocument,
@@ -169,6 +171,7 @@ bool CSSAttributesManager::setCSSDocument(const Value& cssDocument, bool isOverr
     }
 
     nodeContainer.cssDocument = std::move(cssDocumentNative);
+    nodeContainer.node.setDocumentChanged();
     if (nodeContainer.cssDocument != nullptr) {
         nodeContainer.node.setMonitoredCssAttributes(nodeContainer.cssDocument->getMonitoredAttributes());
     } else {
@@ -216,7 +219,13 @@ void CSSAttributesManager::copyCSSDocument(const CSSAttributesManager& other) {
 }
 
 void CSSAttributesManager::setParent(CSSAttributesManager* attributesManagerOfParent) {
+    if (_attributesManagerOfParent == attributesManagerOfParent) {
+        return;
+    }
+
     _attributesManagerOfParent = attributesManagerOfParent;
+    _parentChanged = true;
+    setAncestorsChanged();
 }
 
 bool CSSAttributesManager::setSiblingsIndexes(int siblingsCount, int indexAmongSiblings) {
@@ -277,6 +286,33 @@ bool CSSAttributesManager::attributeChanged(AttributeId attribute) {
     return changed;
 }
 
+bool CSSAttributesManager::setAncestorsChanged() {
+    bool needUpdate = false;
+    if (_cssNodeContainer != nullptr) {
+        needUpdate |= _cssNodeContainer->node.setAncestorsChanged();
+    }
+    if (_cssNodeContainerFromParentOveridde != nullptr) {
+        needUpdate |= _cssNodeContainerFromParentOveridde->node.setAncestorsChanged();
+    }
+    return needUpdate;
+}
+
+bool CSSAttributesManager::canAffectDescendantsCSS() const {
+    // Descendants resolve their ancestors through the parent chain, which changed
+    if (_parentChanged) {
+        return true;
+    }
+    if (_cssNodeContainer != nullptr && _cssNodeContainer->cssDocument != nullptr &&
+        _cssNodeContainer->cssDocument->hasAncestorSelectors()) {
+        return true;
+    }
+    if (_cssNodeContainerFromParentOveridde != nullptr && _cssNodeContainerFromParentOveridde->cssDocument != nullptr &&
+        _cssNodeContainerFromParentOveridde->cssDocument->hasAncestorSelectors()) {
+        return true;
+    }
+    return false;
+}
+
 CSSNodeContainer& CSSAttributesManager::getCSSNodeContainer(bool isOverridenFromParent) {
     if (isOverridenFromParent) {
         if (_cssNodeContainerFromParentOveridde == nullptr) {
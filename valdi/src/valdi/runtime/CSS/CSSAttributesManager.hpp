@@ -75,6 +75,17 @@ public:
 
     bool attributeChanged(AttributeId attribute);
 
+    /**
+     Notifies that the inputs of one of the ancestors changed.
+     Returns whether the CSS of this node depends on its ancestors and needs to be updated.
+     */
+    bool setAncestorsChanged();
+
+    /**
+     Returns whether a change on this node can affect the CSS of its descendants.
+     */
+    bool canAffectDescendantsCSS() const;
+
     StringBox getNodeId() const;
     bool hasNodeId(const StringBox& nodeId) const;
 
@@ -92,6 +103,7 @@ private:
     std::unique_ptr<CSSNodeContainer> _cssNodeContainer;
     std::unique_ptr<CSSNodeContainer> _cssNodeContainerFromParentOveridde;
     CSSAttributesManager* _attributesManagerOfParent = nullptr;
+    bool _parentChanged = false;
 
     bool removeAllStyles(const CSSAttributesManagerUpdateContext& context);
 
@@ -10,8 +10,18 @@
 #include "valdi_core/cpp/Utils/StringCache.hpp"
 #include "valdi_core/cpp/Utils/ValueUtils.hpp"
 
+#include <mutex>
+
 namespace Valdi {
 
+// Bounds the memory used by the memoized matches of documents with many distinct signatures
+static constexpr size_t kMaxMemoizedMatches = 256;
+
+bool CSSSelectorSignature::operator==(const CSSSelectorSignature& other) const noexcept {
+    return nodeId == other.nodeId && cssClass == other.cssClass && tagName == other.tagName &&
+           indexAmongSiblings == other.indexAmongSiblings && siblingsCount == other.siblingsCount;
+}
+
 CSSDocument::CSSDocument(const ResourceId& resourceId, const Valdi::StyleNode& styleNode, AttributeIds& attributeIds)
     : _resourceId(resourceId) {
     populateStyleNode(attributeIds, styleNode, _rootNode);
@@ -81,6 +91,26 @@ void CSSDocument::populateRuleIndex(AttributeIds& attributeIds,
     populateMapRule(attributeIds, ruleIndex.class_rules(), currentRuleIndex.classRules);
     populateMapRule(attributeIds, ruleIndex.tag_rules(), currentRuleIndex.tagRules);
 
+    if (!currentRuleIndex.idRules.empty()) {
+        _selectorDependencies |= kCSSSelectorDependencyId;
+    }
+    if (!currentRuleIndex.classRules.empty()) {
+        _selectorDependencies |= kCSSSelectorDependencyClass;
+    }
+    if (!currentRuleIndex.tagRules.empty()) {
+        _selectorDependencies |= kCSSSelectorDependencyTag;
+    }
+
+    if (ruleIndex.attribute_rules_size() > 0) {
+        _selectorDependencies |= kCSSSelectorDependencyAttribute;
+    }
+    if (ruleIndex.has_first_child_rule() || ruleIndex.has_last_child_rule() || ruleIndex.nth_child_rules_size() > 0) {
+        _selectorDependencies |= kCSSSelectorDependencySiblingPosition;
+    }
+    if (ruleIndex.has_direct_parent_rules() || ruleIndex.has_ancestor_rules()) {
+        _selectorDependencies |= kCSSSelectorDependencyAncestors;
+    }
+
     for (const auto& attributeRule : ruleIndex.attribute_rules()) {
         auto& newAttributeRule = currentRuleIndex.attributeRules.emplace_back();
         newAttributeRule.attribute = toCSSAttribute(attributeIds, attributeRule.attribute());
@@ -142,6 +172,45 @@ const ResourceId& CSSDocument::getResourceId() const {
     return _resourceId;
 }
 
+CSSSelectorDependencies CSSDocument::getSelectorDependencies() const {
+    return _selectorDependencies;
+}
+
+bool CSSDocument::hasAncestorSelectors() const {
+    return (_selectorDependencies & kCSSSelectorDependencyAncestors) != 0;
+}
+
+bool CSSDocument::getMemoizedMatch(const CSSSelectorSignature& signature,
+                                   CSSMatchedDeclarations& declarations,
+                                   CSSSelectorDependencies& dependencies) const {
+    std::lock_guard<Mutex> lock(_memoizedMatchesMutex);
+    const auto& it = _memoizedMatches.find(signature);
+    if (it == _memoizedMatches.end()) {
+        return false;
+    }
+
+    declarations = it->second.declarations;
+    dependencies = it->second.dependencies;
+    return true;
+}
+
+void CSSDocument::memoizeMatch(const CSSSelectorSignature& signature,
+                               const CSSMatchedDeclarations& declarations,
+                               CSSSelectorDependencies dependencies) const {
+    if ((dependencies & (kCSSSelectorDependencyAttribute | kCSSSelectorDependencyAncestors)) != 0) {
+        return;
+    }
+
+    std::lock_guard<Mutex> lock(_memoizedMatchesMutex);
+    if (_memoizedMatches.size() >= kMaxMemoizedMatches) {
+        _memoizedMatches.clear();
+    }
+
+    auto& memoizedMatch = _memoizedMatches[signature];
+    memoizedMatch.declarations = declarations;
+    memoizedMatch.dependencies = dependencies;
+}
+
 Result<Ref<CSSDocument>> CSSDocument::parse(const ResourceId& resourceId,
                                             const Byte* data,
                                             size_t len,
@@ -159,3 +228,16 @@ Result<Ref<CSSDocument>> CSSDocument::parse(const ResourceId& resourceId,
 VALDI_CLASS_IMPL(CSSDocument)
 
 } // namespace Valdi
+
+namespace std {
+
+std::size_t hash<Valdi::CSSSelectorSignature>::operator()(const Valdi::CSSSelectorSignature& signature) const noexcept {
+    auto hash = signature.nodeId.hash();
+    hash = hash * 31 + signature.cssClass.hash();
+    hash = hash * 31 + signature.tagName.hash();
+    hash = hash * 31 + static_cast<size_t>(signature.indexAmongSiblings);
+    hash = hash * 31 + static_cast<size_t>(signature.siblingsCount);
+    return hash;
+}
+
+} // namespace std
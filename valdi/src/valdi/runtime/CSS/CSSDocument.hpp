@@ -13,6 +13,7 @@
 #include "valdi_core/cpp/Utils/Bytes.hpp"
 #include "valdi_core/cpp/Utils/FlatMap.hpp"
 #include "valdi_core/cpp/Utils/FlatSet.hpp"
+#include "valdi_core/cpp/Utils/Mutex.hpp"
 #include "valdi_core/cpp/Utils/Result.hpp"
 #include "valdi_core/cpp/Utils/StringBox.hpp"
 #include "valdi_core/cpp/Utils/ValdiObject.hpp"
@@ -26,6 +27,50 @@ namespace Valdi {
 
 struct CSSProcessedRuleIndex;
 
+/**
+ Bit mask of the inputs of a CSSNode that selectors can match against.
+ Used to know which changes on a node can affect the rules that it matches.
+ */
+using CSSSelectorDependencies = uint8_t;
+
+constexpr CSSSelectorDependencies kCSSSelectorDependencyNone = 0;
+constexpr CSSSelectorDependencies kCSSSelectorDependencyId = 1 << 0;
+constexpr CSSSelectorDependencies kCSSSelectorDependencyClass = 1 << 1;
+constexpr CSSSelectorDependencies kCSSSelectorDependencyTag = 1 << 2;
+constexpr CSSSelectorDependencies kCSSSelectorDependencyAttribute = 1 << 3;
+constexpr CSSSelectorDependencies kCSSSelectorDependencySiblingPosition = 1 << 4;
+constexpr CSSSelectorDependencies kCSSSelectorDependencyAncestors = 1 << 5;
+constexpr CSSSelectorDependencies kCSSSelectorDependencyAll = (1 << 6) - 1;
+
+/**
+ The inputs of a CSSNode that the rules of a document read when matching it.
+ Inputs that no selector of the document depends on are left empty.
+ */
+struct CSSSelectorSignature {
+    StringBox nodeId;
+    StringBox cssClass;
+    StringBox tagName;
+    int indexAmongSiblings = 0;
+    int siblingsCount = 0;
+
+    bool operator==(const CSSSelectorSignature& other) const noexcept;
+};
+
+} // namespace Valdi
+
+namespace std {
+
+template<>
+struct hash<Valdi::CSSSelectorSignature> {
+    std::size_t operator()(const Valdi::CSSSelectorSignature& signature) const noexcept;
+};
+
+} // namespace std
+
+namespace Valdi {
+
+using CSSMatchedDeclarations = FlatMap<AttributeId, const CSSStyleDeclaration*>;
+
 struct CSSStyleNode {
     std::vector<CSSStyleDeclaration> styles;
     std::unique_ptr<CSSProcessedRuleIndex> ruleIndex = nullptr;
@@ -74,11 +119,47 @@ public:
 
     const ResourceId& getResourceId() const;
 
+    /**
+     Returns the union of the dependencies of all the selectors of the document.
+     */
+    CSSSelectorDependencies getSelectorDependencies() const;
+
+    /**
+     Returns whether the selectors of the document can match against the ancestors of a node,
+     in which case changes on a node can affect the matched rules of its descendants.
+     */
+    bool hasAncestorSelectors() const;
+
+    /**
+     Looks up the declarations previously matched for a node with the given signature.
+     Returns false if the match was not memoized.
+     */
+    bool getMemoizedMatch(const CSSSelectorSignature& signature,
+                          CSSMatchedDeclarations& declarations,
+                          CSSSelectorDependencies& dependencies) const;
+
+    /**
+     Memoizes the declarations matched for a node with the given signature.
+     Matches which depended on the attributes or the ancestors of the node are not
+     fully described by the signature, and are ignored.
+     */
+    void memoizeMatch(const CSSSelectorSignature& signature,
+                      const CSSMatchedDeclarations& declarations,
+                      CSSSelectorDependencies dependencies) const;
+
     VALDI_CLASS_HEADER(CSSDocument)
 private:
+    struct MemoizedMatch {
+        CSSMatchedDeclarations declarations;
+        CSSSelectorDependencies dependencies;
+    };
+
     ResourceId _resourceId;
     CSSStyleNode _rootNode;
     MonitoredCssAttributesPtr _monitoredCssAttributes;
+    CSSSelectorDependencies _selectorDependencies = kCSSSelectorDependencyNone;
+    mutable Mutex _memoizedMatchesMutex;
+    mutable FlatMap<CSSSelectorSignature, MemoizedMatch> _memoizedMatches;
 
     void populateStyleNode(AttributeIds& attributeIds, const Valdi::StyleNode& styleNode, CSSStyleNode& currentNode);
     void populateRuleIndex(AttributeIds& attributeIds,
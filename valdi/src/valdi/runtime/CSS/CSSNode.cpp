@@ -70,6 +70,7 @@ bool CSSNode::setClass(const StringBox& cssClass) {
     _resolvedCssClasses.clear();
 
     forEachCSSClass(cssClass, [&](StringBox cssClass) { _resolvedCssClasses.emplace(std::move(cssClass)); });
+    _changedDependencies |= kCSSSelectorDependencyClass;
 
     return true;
 }
@@ -79,6 +80,7 @@ bool CSSNode::setNodeId(const StringBox& nodeId) {
         return false;
     }
     _nodeId = nodeId;
+    _changedDependencies |= kCSSSelectorDependencyId;
     return true;
 }
 
@@ -91,6 +93,7 @@ bool CSSNode::setTagName(const StringBox& tagName) {
         return false;
     }
     _tagName = tagName;
+    _changedDependencies |= kCSSSelectorDependencyTag;
     return true;
 }
 
@@ -115,7 +118,22 @@ bool CSSNode::isMonitoredAttribute(AttributeId attribute) const {
 }
 
 bool CSSNode::attributeChanged(AttributeId attribute) {
-    return isMonitoredAttribute(attribute);
+    if (!isMonitoredAttribute(attribute)) {
+        return false;
+    }
+
+    _changedDependencies |= kCSSSelectorDependencyAttribute;
+    return true;
+}
+
+void CSSNode::setDocumentChanged() {
+    _selectorDependencies = kCSSSelectorDependencyAll;
+    _changedDependencies = kCSSSelectorDependencyAll;
+}
+
+bool CSSNode::setAncestorsChanged() {
+    _changedDependencies |= kCSSSelectorDependencyAncestors;
+    return (_selectorDependencies & kCSSSelectorDependencyAncestors) != 0;
 }
 
 int CSSNode::getIndexAmongSiblings() const {
@@ -128,6 +146,7 @@ bool CSSNode::setIndexAmongSiblings(int index) {
     }
 
     _indexAmongSiblings = index;
+    _changedDependencies |= kCSSSelectorDependencySiblingPosition;
     return true;
 }
 
@@ -137,6 +156,7 @@ bool CSSNode::setSiblingsCount(int count) {
     }
 
     _siblingsCount = count;
+    _changedDependencies |= kCSSSelectorDependencySiblingPosition;
     return true;
 }
 
@@ -166,13 +186,15 @@ void insertDeclarationIfNeeded(const CSSStyleDeclaration& declaration,
 void CSSNode::insertDeclarations(const CSSDocument& cssDocument,
                                  const CSSStyleNode& styleNode,
                                  AttributesApplier& attributesApplier,
-                                 FlatMap<AttributeId, const CSSStyleDeclaration*>& bestStyleDeclarationByKey) {
+                                 FlatMap<AttributeId, const CSSStyleDeclaration*>& bestStyleDeclarationByKey,
+                                 CSSSelectorDependencies& dependencies) {
     for (const auto& decl : styleNode.styles) {
         insertDeclarationIfNeeded(decl, bestStyleDeclarationByKey);
     }
 
     if (styleNode.ruleIndex != nullptr) {
-        insertDeclarations(cssDocument, *styleNode.ruleIndex, attributesApplier, bestStyleDeclarationByKey);
+        insertDeclarations(
+            cssDocument, *styleNode.ruleIndex, attributesApplier, bestStyleDeclarationByKey, dependencies);
     }
 }
 
@@ -190,35 +212,43 @@ inline bool nthChildMatchesIndex(const int index, const int n, const int offset)
 void CSSNode::insertDeclarations(const CSSDocument& cssDocument,
                                  const CSSProcessedRuleIndex& ruleIndex,
                                  AttributesApplier& attributesApplier,
-                                 FlatMap<AttributeId, const CSSStyleDeclaration*>& bestStyleDeclarationByKey) {
+                                 FlatMap<AttributeId, const CSSStyleDeclaration*>& bestStyleDeclarationByKey,
+                                 CSSSelectorDependencies& dependencies) {
     // ORDER: id -> class -> tag -> attrib -> firstChild -> lastChild -> nthChild
+    // Nested rule indexes are only reached after a match on an input which is recorded
+    // as a dependency, so recording the inputs read at each level is enough to know
+    // which changes can affect the result.
 
     if (!ruleIndex.idRules.empty()) {
+        dependencies |= kCSSSelectorDependencyId;
         const auto& idRules = ruleIndex.idRules;
 
         const auto& childNode = idRules.find(_nodeId);
         if (childNode != idRules.end()) {
-            insertDeclarations(cssDocument, childNode->second, attributesApplier, bestStyleDeclarationByKey);
+            insertDeclarations(
+                cssDocument, childNode->second, attributesApplier, bestStyleDeclarationByKey, dependencies);
         }
     }
 
     if (!ruleIndex.classRules.empty()) {
+        dependencies |= kCSSSelectorDependencyClass;
         const auto& classRules = ruleIndex.classRules;
         for (const auto& className : _resolvedCssClasses) {
             auto it = classRules.find(className);
             if (it != classRules.end()) {
-                insertDeclarations(cssDocument, it->second, attributesApplier, bestStyleDeclarationByKey);
+                insertDeclarations(cssDocument, it->second, attributesApplier, bestStyleDeclarationByKey, dependencies);
             }
         }
     }
 
     if (!ruleIndex.tagRules.empty()) {
+        dependencies |= kCSSSelectorDependencyTag;
         const auto& tagRules = ruleIndex.tagRules;
 
         if (!_tagName.isEmpty()) {
             auto it = tagRules.find(_tagName);
             if (it != tagRules.end()) {
-                insertDeclarations(cssDocument, it->second, attributesApplier, bestStyleDeclarationByKey);
+                insertDeclarations(cssDocument, it->second, attributesApplier, bestStyleDeclarationByKey, dependencies);
             }
         }
 
@@ -226,11 +256,12 @@ void CSSNode::insertDeclarations(const CSSDocument& cssDocument,
 
         auto it = tagRules.find(kWildcardRule);
         if (it != tagRules.end()) {
-            insertDeclarations(cssDocument, it->second, attributesApplier, bestStyleDeclarationByKey);
+            insertDeclarations(cssDocument, it->second, attributesApplier, bestStyleDeclarationByKey, dependencies);
         }
     }
 
     if (!ruleIndex.attributeRules.empty()) {
+        dependencies |= kCSSSelectorDependencyAttribute;
         const auto& attributeRules = ruleIndex.attributeRules;
 
         for (const auto& attributeRule : attributeRules) {
@@ -238,8 +269,11 @@ void CSSNode::insertDeclarations(const CSSDocument& cssDocument,
                 case Valdi::CSSRuleIndex_AttributeRule_Type_EQUALS: {
                     auto value = attributesApplier.getResolvedAttributeValue(attributeRule.attribute.id);
                     if (value == attributeRule.attribute.value) {
-                        insertDeclarations(
-                            cssDocument, attributeRule.styleNode, attributesApplier, bestStyleDeclarationByKey);
+                        insertDeclarations(cssDocument,
+                                           attributeRule.styleNode,
+                                           attributesApplier,
+                                           bestStyleDeclarationByKey,
+                                           dependencies);
                     }
                 } break;
                 default:
@@ -250,39 +284,56 @@ void CSSNode::insertDeclarations(const CSSDocument& cssDocument,
     }
 
     if (ruleIndex.firstChildRule != nullptr) {
+        dependencies |= kCSSSelectorDependencySiblingPosition;
         if (_indexAmongSiblings == 0) {
-            insertDeclarations(cssDocument, *ruleIndex.firstChildRule, attributesApplier, bestStyleDeclarationByKey);
+            insertDeclarations(
+                cssDocument, *ruleIndex.firstChildRule, attributesApplier, bestStyleDeclarationByKey, dependencies);
         }
     }
 
     if (ruleIndex.lastChildRule != nullptr) {
+        dependencies |= kCSSSelectorDependencySiblingPosition;
         if (_indexAmongSiblings == _siblingsCount - 1) {
-            insertDeclarations(cssDocument, *ruleIndex.lastChildRule, attributesApplier, bestStyleDeclarationByKey);
+            insertDeclarations(
+                cssDocument, *ruleIndex.lastChildRule, attributesApplier, bestStyleDeclarationByKey, dependencies);
         }
     }
 
     if (!ruleIndex.nthChildRules.empty()) {
+        dependencies |= kCSSSelectorDependencySiblingPosition;
         const auto& nthChildRules = ruleIndex.nthChildRules;
         for (const auto& nthChildRule : nthChildRules) {
             if (nthChildMatchesIndex(_indexAmongSiblings, nthChildRule.n, nthChildRule.offset)) {
-                insertDeclarations(cssDocument, nthChildRule.node, attributesApplier, bestStyleDeclarationByKey);
+                insertDeclarations(
+                    cssDocument, nthChildRule.node, attributesApplier, bestStyleDeclarationByKey, dependencies);
             }
         }
     }
 
+    // Whatever the ancestors read while matching is covered by the ancestors dependency of this node
+    CSSSelectorDependencies ancestorDependencies = kCSSSelectorDependencyNone;
+
     if (ruleIndex.directParentRules != nullptr) {
+        dependencies |= kCSSSelectorDependencyAncestors;
         auto* parent = resolveParent(cssDocument);
         if (parent != nullptr) {
-            parent->insertDeclarations(
-                cssDocument, *ruleIndex.directParentRules, attributesApplier, bestStyleDeclarationByKey);
+            parent->insertDeclarations(cssDocument,
+                                       *ruleIndex.directParentRules,
+                                       attributesApplier,
+                                       bestStyleDeclarationByKey,
+                                       ancestorDependencies);
         }
     }
 
     if (ruleIndex.ancestorRules != nullptr) {
+        dependencies |= kCSSSelectorDependencyAncestors;
         auto* ancestor = resolveParent(cssDocument);
         while (ancestor != nullptr) {
-            ancestor->insertDeclarations(
-                cssDocument, *ruleIndex.ancestorRules, attributesApplier, bestStyleDeclarationByKey);
+            ancestor->insertDeclarations(cssDocument,
+                                         *ruleIndex.ancestorRules,
+                                         attributesApplier,
+                                         bestStyleDeclarationByKey,
+                                         ancestorDependencies);
             ancestor = ancestor->resolveParent(cssDocument);
         }
     }
@@ -297,13 +348,64 @@ void CSSNode::setAttributeFromDeclaration(ViewTransactionScope& viewTransactionS
         viewTransactionScope, attributeId, this, styleDeclaration->attribute.value, animator);
 }
 
+CSSSelectorSignature CSSNode::makeSelectorSignature(const CSSDocument& cssDocument) const {
+    auto documentDependencies = cssDocument.getSelectorDependencies();
+
+    // Inputs that no selector reads are left out, so that more nodes share the same signature
+    CSSSelectorSignature signature;
+    if ((documentDependencies & kCSSSelectorDependencyId) != 0) {
+        signature.nodeId = _nodeId;
+    }
+    if ((documentDependencies & kCSSSelectorDependencyClass) != 0) {
+        signature.cssClass = _cssClass;
+    }
+    if ((documentDependencies & kCSSSelectorDependencyTag) != 0) {
+        signature.tagName = _tagName;
+    }
+    if ((documentDependencies & kCSSSelectorDependencySiblingPosition) != 0) {
+        signature.indexAmongSiblings = _indexAmongSiblings;
+        signature.siblingsCount = _siblingsCount;
+    }
+
+    return signature;
+}
+
+void CSSNode::matchDeclarations(const CSSDocument& cssDocument,
+                                AttributesApplier& attributesApplier,
+                                FlatMap<AttributeId, const CSSStyleDeclaration*>& bestStyleDeclarationByKey) {
+    auto signature = makeSelectorSignature(cssDocument);
+    if (cssDocument.getMemoizedMatch(signature, bestStyleDeclarationByKey, _selectorDependencies)) {
+        return;
+    }
+
+    CSSSelectorDependencies dependencies = kCSSSelectorDependencyNone;
+    insertDeclarations(
+        cssDocument, cssDocument.getRootNode(), attributesApplier, bestStyleDeclarationByKey, dependencies);
+    _selectorDependencies = dependencies;
+
+    cssDocument.memoizeMatch(signature, bestStyleDeclarationByKey, dependencies);
+}
+
 void CSSNode::applyCss(ViewTransactionScope& viewTransactionScope,
                        const CSSDocument& cssDocument,
                        AttributesApplier& attributesApplier,
                        const SharedAnimator& animator) {
+    if ((_changedDependencies & _selectorDependencies) == 0) {
+        // Nothing that the matched rules depend on has changed
+        _changedDependencies = kCSSSelectorDependencyNone;
+        return;
+    }
+    _changedDependencies = kCSSSelectorDependencyNone;
+
     auto bestStyleDeclarationByKey = CSSNode::newStyleDeclarationMap();
 
-    insertDeclarations(cssDocument, cssDocument.getRootNode(), attributesApplier, *bestStyleDeclarationByKey);
+    matchDeclarations(cssDocument, attributesApplier, *bestStyleDeclarationByKey);
+
+    if (_lastStyleDeclarations != nullptr && *_lastStyleDeclarations == *bestStyleDeclarationByKey) {
+        // Same declarations as the ones already applied
+        CSSNode::releaseStyleDeclarationMap(std::move(bestStyleDeclarationByKey));
+        return;
+    }
 
     if (_lastStyleDeclarations != nullptr) {
         for (const auto& it : *_lastStyleDeclarations) {
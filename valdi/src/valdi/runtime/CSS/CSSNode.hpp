@@ -36,11 +36,28 @@ public:
     bool setClass(const StringBox& cssClass);
     const StringBox& getClass() const;
 
+    /**
+     Matches the rules of the document and applies the resulting attributes.
+     Matching is skipped when none of the inputs that the previously matched
+     rules depend on have changed since the last call.
+     */
     void applyCss(ViewTransactionScope& viewTransactionScope,
                   const CSSDocument& cssDocument,
                   AttributesApplier& attributesApplier,
                   const SharedAnimator& animator);
 
+    /**
+     Notifies that the document or the rules of the document changed, which
+     requires a full match on the next applyCss().
+     */
+    void setDocumentChanged();
+
+    /**
+     Notifies that the ancestors of the node changed.
+     Returns whether the matched rules of the node depend on its ancestors.
+     */
+    bool setAncestorsChanged();
+
     void setParentResolver(CSSNodeParentResolver* parentResolver);
 
     int getIndexAmongSiblings() const;
@@ -79,14 +96,27 @@ private:
     int _siblingsCount = 0;
     bool _managingRootOfChildTree = false;
 
+    // Inputs read by the rules during the last match
+    CSSSelectorDependencies _selectorDependencies = kCSSSelectorDependencyAll;
+    // Inputs which changed since the last match
+    CSSSelectorDependencies _changedDependencies = kCSSSelectorDependencyAll;
+
     void insertDeclarations(const CSSDocument& cssDocument,
                             const CSSStyleNode& styleNode,
                             AttributesApplier& attributesApplier,
-                            FlatMap<AttributeId, const CSSStyleDeclaration*>& bestStyleDeclarationByKey);
+                            FlatMap<AttributeId, const CSSStyleDeclaration*>& bestStyleDeclarationByKey,
+                            CSSSelectorDependencies& dependencies);
     void insertDeclarations(const CSSDocument& cssDocument,
                             const CSSProcessedRuleIndex& ruleIndex,
                             AttributesApplier& attributesApplier,
-                            FlatMap<AttributeId, const CSSStyleDeclaration*>& bestStyleDeclarationByKey);
+                            FlatMap<AttributeId, const CSSStyleDeclaration*>& bestStyleDeclarationByKey,
+                            CSSSelectorDependencies& dependencies);
+
+    void matchDeclarations(const CSSDocument& cssDocument,
+                           AttributesApplier& attributesApplier,
+                           FlatMap<AttributeId, const CSSStyleDeclaration*>& bestStyleDeclarationByKey);
+
+    CSSSelectorSignature makeSelectorSignature(const CSSDocument& cssDocument) const;
 
     void setAttributeFromDeclaration(ViewTransactionScope& viewTransactionScope,
                                      AttributeId attributeId,
@@ -13,6 +13,7 @@
 #include "valdi/runtime/Context/ViewManagerContext.hpp"
 #include "valdi/runtime/Metrics/Metrics.hpp"
 #include "valdi/runtime/Rendering/RenderRequest.hpp"
+#include "valdi/runtime/Rendering/RenderRequestCoalescer.hpp"
 #include "valdi/runtime/Runtime.hpp"
 #include "valdi/runtime/Utils/AsyncGroup.hpp"
 #include "valdi_core/cpp/Utils/ContainerUtils.hpp"
@@ -29,8 +30,10 @@ static void callUpdateCompletedCallbacks(const std::vector<Ref<ValueFunction>>&
     }
 }
 
-Context::PendingRenderRequest::PendingRenderRequest(ContextUpdateId updateId, const Ref<RenderRequest>& renderRequest)
-    : updateId(updateId), renderRequest(renderRequest) {};
+Context::PendingRenderRequest::PendingRenderRequest(ContextUpdateId updateId,
+                                                   const Ref<RenderRequest>& renderRequest,
+                                                   bool canCoalesce)
+    : updateId(updateId), renderRequest(renderRequest), canCoalesce(canCoalesce) {};
 
 Context::Context(ContextId contextId, const Ref<ILogger>& logger)
     : Context(contextId,
@@ -251,13 +254,16 @@ ContextUpdateId Context::enqueueUpdate() {
 }
 
 std::optional<ContextUpdateId> Context::enqueueRenderRequest(const Ref<RenderRequest>& renderRequest) {
+    // Checked before taking the lock, so that a backlog can be merged without going through its entries
+    auto canCoalesce = RenderRequestCoalescer::canCoalesce(*renderRequest);
+
     std::unique_lock<Mutex> guard(_mutex);
     if (_destroyed) {
         return std::optional<ContextUpdateId>();
     }
 
     auto updateId = lockFreeEnqueueUpdate();
-    _pendingRenderRequests.emplace_back(updateId, renderRequest);
+    _pendingRenderRequests.emplace_back(updateId, renderRequest, canCoalesce);
 
     if (!_deferRender) {
         runNextPendingRenderRequest(guard);
@@ -279,12 +285,42 @@ bool Context::runRenderRequest(ContextUpdateId updateId) {
 void Context::runNextPendingRenderRequest(std::unique_lock<Mutex>& guard) {
     auto pendingRenderRequest = _pendingRenderRequests.front();
     _pendingRenderRequests.pop_front();
+    auto renderRequestsToCoalesce = takeCoalescablePendingRenderRequests(pendingRenderRequest);
     Ref<Runtime> runtime(_runtime);
     guard.unlock();
+
+    if (renderRequestsToCoalesce.size() > 1) {
+        pendingRenderRequest.renderRequest = RenderRequestCoalescer::coalesce(renderRequestsToCoalesce);
+    }
+
     runtime->processRenderRequest(pendingRenderRequest.renderRequest);
     markUpdateCompleted(pendingRenderRequest.updateId, guard);
 }
 
+std::vector<Ref<RenderRequest>> Context::takeCoalescablePendingRenderRequests(
+    PendingRenderRequest& pendingRenderRequest) {
+    std::vector<Ref<RenderRequest>> renderRequests;
+    if (_pendingRenderRequests.empty() || !pendingRenderRequest.canCoalesce) {
+        return renderRequests;
+    }
+
+    // When the main thread falls behind, render the backlog as a single request, so that
+    // the intermediate states which would never be visible are not applied.
+    // The requests are only taken out here, they are merged once the lock is released.
+    renderRequests.emplace_back(pendingRenderRequest.renderRequest);
+
+    while (!_pendingRenderRequests.empty() && _pendingRenderRequests.front().canCoalesce) {
+        auto& next = _pendingRenderRequests.front();
+        renderRequests.emplace_back(std::move(next.renderRequest));
+        // The merged request completes the update of the last request it contains
+        _pendingUpdates.erase(pendingRenderRequest.updateId);
+        pendingRenderRequest.updateId = next.updateId;
+        _pendingRenderRequests.pop_front();
+    }
+
+    return renderRequests;
+}
+
 bool Context::flushRenderRequests() {
     bool didFlush = false;
     std::unique_lock<Mutex> guard(_mutex);
@@ -149,10 +149,11 @@ protected:
 
 private:
     struct PendingRenderRequest {
-        PendingRenderRequest(ContextUpdateId updateId, const Ref<RenderRequest>& renderRequest);
+        PendingRenderRequest(ContextUpdateId updateId, const Ref<RenderRequest>& renderRequest, bool canCoalesce);
 
         ContextUpdateId updateId;
         Ref<RenderRequest> renderRequest;
+        bool canCoalesce;
     };
 
     mutable Mutex _mutex;
@@ -183,6 +184,7 @@ private:
     void markUpdateCompleted(ContextUpdateId updateId, std::unique_lock<Mutex>& guard);
 
     void runNextPendingRenderRequest(std::unique_lock<Mutex>& guard);
+    std::vector<Ref<RenderRequest>> takeCoalescablePendingRenderRequests(PendingRenderRequest& pendingRenderRequest);
 };
 
 } // namespace Valdi
@@ -24,6 +24,7 @@
 #include "valdi/runtime/Views/MeasureDelegate.hpp"
 #include "valdi/runtime/Views/ViewTransactionScope.hpp"
 #include "valdi_core/cpp/Constants.hpp"
+#include "valdi_core/cpp/Threading/ParallelWorkerPool.hpp"
 #include "valdi_core/cpp/Utils/LoggerUtils.hpp"
 #include "valdi_core/cpp/Utils/ObjectPool.hpp"
 #include "valdi_core/cpp/Utils/StringCache.hpp"
@@ -1434,6 +1435,13 @@ Size ViewNode::onMeasure(float width, MeasureMode widthMode, float height, Measu
     }
 }
 
+Size ViewNode::onMeasureWithLayoutAttributes(
+    const Ref<ValueMap>& layoutAttributes, float width, MeasureMode widthMode, float height, MeasureMode heightMode) {
+    VALDI_TRACE("Valdi.onMeasureNode.concurrent");
+    return _attributesApplier.getBoundAttributes()->getMeasureDelegate()->measureWithLayoutAttributes(
+        layoutAttributes, width, widthMode, height, heightMode, isRightToLeft());
+}
+
 Ref<ViewNode> ViewNode::makePlaceholderViewNode(ViewTransactionScope& viewTransactionScope,
                                                 const Ref<View>& placeholderView) {
     auto viewNode = Valdi::makeShared<ViewNode>(nullptr, _attributeIds, _logger);
@@ -1964,6 +1972,9 @@ void ViewNode::scheduleLazyLayout() {
 
 struct MeasureMetrics {
     uint32_t totalMeasure = 0;
+    // Set when calculating from a layout worker thread, holds the layout attributes
+    // of the nodes measured by a MeasureDelegate, resolved on the owning thread.
+    const FlatMap<const ViewNode*, Ref<ValueMap>>* concurrentMeasureAttributes = nullptr;
 };
 
 YGValue resolveYogaValue(float containerSize, YGValue appliedValue) {
@@ -2232,18 +2243,15 @@ bool ViewNode::updateCalculatedFrame(float viewOffsetX,
 }
 
 bool ViewNode::updateLazyLayout() {
-    // Using lazy-layout creates a new "detached" yoga subtree, so the device-level RTL/LTR style that
-    // we set on the root node doesn't propagate to that detached subtree.
-    // Need to manually set the Direction style on the detached subtree.
-    auto direction = _yogaNode->getLayout().direction();
-    auto previousDirection = _lazyLayoutData->yogaNode->getLayout().direction();
-    auto directionHasChanged = direction != previousDirection;
-    YGNodeStyleSetDirection(_lazyLayoutData->yogaNode, direction);
-
-    auto sizeHasChanged = _lazyLayoutData->availableWidth != _calculatedFrame.width ||
-                          _lazyLayoutData->availableHeight != _calculatedFrame.height;
+    if (_lazyLayoutData->hasConcurrentLayoutResult) {
+        _lazyLayoutData->hasConcurrentLayoutResult = false;
+        if (!_lazyLayoutData->yogaNode->isDirty() && _lazyLayoutData->availableWidth == _calculatedFrame.width &&
+            _lazyLayoutData->availableHeight == _calculatedFrame.height) {
+            return true;
+        }
+    }
 
-    bool forceLayout = sizeHasChanged || directionHasChanged;
+    bool forceLayout = prepareLazyLayout(_calculatedFrame.size());
     auto updated = calculateLayoutOnNodeIfNeeded(_lazyLayoutData->yogaNode,
                                                  _calculatedFrame.width,
                                                  MeasureModeExactly,
@@ -2260,6 +2268,163 @@ bool ViewNode::updateLazyLayout() {
     return updated;
 }
 
+/**
+ Prepare the detached lazy layout yoga subtree for a calculation with the given available size.
+ Returns whether the layout needs to be calculated even if the yoga subtree is not dirty.
+ */
+bool ViewNode::prepareLazyLayout(Size availableSize) {
+    // Using lazy-layout creates a new "detached" yoga subtree, so the device-level RTL/LTR style that
+    // we set on the root node doesn't propagate to that detached subtree.
+    // Need to manually set the Direction style on the detached subtree.
+    auto direction = _yogaNode->getLayout().direction();
+    auto previousDirection = _lazyLayoutData->yogaNode->getLayout().direction();
+    auto directionHasChanged = direction != previousDirection;
+    YGNodeStyleSetDirection(_lazyLayoutData->yogaNode, direction);
+
+    auto sizeHasChanged = _lazyLayoutData->availableWidth != availableSize.width ||
+                          _lazyLayoutData->availableHeight != availableSize.height;
+
+    return sizeHasChanged || directionHasChanged;
+}
+
+/**
+ Prepare the measure callback of this node to be called from a layout worker pool thread.
+ Nodes measured by a JS onMeasure callback have to be measured on the thread owning the tree.
+ The layout attributes of nodes measured by a MeasureDelegate are resolved here, as the
+ attribute processors can only run on the thread owning the tree.
+ */
+bool ViewNode::prepareConcurrentMeasure(FlatMap<const ViewNode*, Ref<ValueMap>>& measureAttributes) {
+    if (_yogaNode == nullptr || !_yogaNode->hasMeasureFunc()) {
+        return true;
+    }
+
+    if (_lazyLayoutData != nullptr && _lazyLayoutData->onMeasureCallback != nullptr) {
+        return false;
+    }
+
+    const auto& boundAttributes = _attributesApplier.getBoundAttributes();
+    if (boundAttributes == nullptr || boundAttributes->getMeasureDelegate() == nullptr) {
+        return true;
+    }
+
+    if (!boundAttributes->getMeasureDelegate()->canMeasureConcurrently()) {
+        return false;
+    }
+
+    auto layoutAttributes = copyProcessedViewLayoutAttributes();
+    if (!layoutAttributes) {
+        return false;
+    }
+
+    measureAttributes[this] = layoutAttributes.moveValue();
+    return true;
+}
+
+bool ViewNode::prepareChildrenConcurrentMeasure(FlatMap<const ViewNode*, Ref<ValueMap>>& measureAttributes) {
+    for (auto* child : *this) {
+        if (!child->prepareConcurrentMeasure(measureAttributes)) {
+            return false;
+        }
+        // Nested lazy layouts are measured from their estimated size, their children
+        // are in a separate yoga subtree which is not calculated as part of ours.
+        if (!child->isLazyLayout() && !child->prepareChildrenConcurrentMeasure(measureAttributes)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ Calculate the dirty lazy layouts of our visible children on the given worker pool.
+ The results are committed in children order on the calling thread, and are picked up
+ by updateLazyLayout() when layoutFinished() visits each child.
+ */
+void ViewNode::calculateChildrenLazyLayoutsConcurrently(ParallelWorkerPool& layoutWorkerPool,
+                                                        bool didPerformLayoutForChildren) {
+    struct LazyLayoutTask {
+        ViewNode* viewNode;
+        Size availableSize;
+        MetricsDuration elapsed;
+        MeasureMetrics measureMetrics;
+        FlatMap<const ViewNode*, Ref<ValueMap>> measureAttributes;
+    };
+
+    std::vector<LazyLayoutTask> tasks;
+
+    for (auto* childViewNode : *this) {
+        if (!childViewNode->_flags[kIsLazyLayoutFlag] || childViewNode->getLazyLayoutYogaNode() == nullptr ||
+            !childViewNode->_flags[kVisibleInViewportFlag]) {
+            continue;
+        }
+
+        // Same size as what the child will resolve in updateCalculatedFrame()
+        auto availableSize = didPerformLayoutForChildren ? ygNodeGetFrame(childViewNode->_yogaNode, 0).size() :
+                                                           childViewNode->_calculatedFrame.size();
+        auto forceLayout = childViewNode->prepareLazyLayout(availableSize);
+        if (!forceLayout && !childViewNode->_lazyLayoutData->yogaNode->isDirty()) {
+            continue;
+        }
+
+        FlatMap<const ViewNode*, Ref<ValueMap>> measureAttributes;
+        if (!childViewNode->prepareChildrenConcurrentMeasure(measureAttributes)) {
+            continue;
+        }
+
+        auto& task = tasks.emplace_back();
+        task.viewNode = childViewNode;
+        task.availableSize = availableSize;
+        task.measureAttributes = std::move(measureAttributes);
+    }
+
+    if (tasks.size() < 2) {
+        // Not worth dispatching, updateLazyLayout() will calculate it inline
+        return;
+    }
+
+    VALDI_TRACE("Valdi.calculateLazyLayoutsConcurrently");
+
+    layoutWorkerPool.run(tasks.size(), [&](size_t index) {
+        auto& task = tasks[index];
+        VALDI_TRACE("Valdi.calculateLayout");
+        MetricsStopWatch stopWatch;
+        task.measureMetrics.concurrentMeasureAttributes = &task.measureAttributes;
+        doCalculateLayoutOnNode(task.viewNode->_lazyLayoutData->yogaNode,
+                                task.availableSize.width,
+                                MeasureModeExactly,
+                                task.availableSize.height,
+                                MeasureModeExactly,
+                                LayoutDirectionLTR,
+                                task.measureMetrics);
+        task.elapsed = stopWatch.elapsed();
+    });
+
+    auto metricsObj = getMetrics();
+    auto backendString = getBackendString(getBackend(_viewNodeTree));
+
+    for (const auto& task : tasks) {
+        auto& lazyLayoutData = *task.viewNode->_lazyLayoutData;
+        lazyLayoutData.availableWidth = task.availableSize.width;
+        lazyLayoutData.availableHeight = task.availableSize.height;
+        lazyLayoutData.hasConcurrentLayoutResult = true;
+
+        if (metricsObj != nullptr) {
+            const auto& module = task.viewNode->getModuleName();
+            metricsObj->emitCalculateLazyLayoutLatency(module, backendString, task.elapsed);
+            if (task.measureMetrics.totalMeasure > 0) {
+                metricsObj->emitCalculateLazyLayoutLatencyMeasure(module, backendString, task.elapsed);
+            }
+        }
+
+        if (Valdi::traceRenderingPerformance) {
+            VALDI_INFO(getLogger(),
+                       "Calculated layout in {} from node {}",
+                       task.elapsed,
+                       task.viewNode->getDebugId());
+        }
+    }
+}
+
 void ViewNode::updateScrollState() {
     auto& scrollState = getOrCreateScrollState();
     scrollState.setInScrollMode(true);
@@ -2408,6 +2573,10 @@ void ViewNode::layoutFinished(ViewTransactionScope& viewTransactionScope,
         frameObserver->appendCompleteCallback(_onLayoutCompletedCallback);
     }
 
+    if (_viewNodeTree != nullptr && _viewNodeTree->getLayoutWorkerPool() != nullptr) {
+        calculateChildrenLazyLayoutsConcurrently(*_viewNodeTree->getLayoutWorkerPool(), didPerformLayoutForChildren);
+    }
+
     auto* childrenIndexer = _childrenIndexer.get();
     for (auto* childViewNode : *this) {
         childViewNode->layoutFinished(viewTransactionScope,
@@ -2873,20 +3042,28 @@ void ViewNode::setCSSHasChildNeedsUpdate() {
 
 void ViewNode::updateCSS(ViewTransactionScope& viewTransactionScope,
                          const Ref<Animator>& animator,
-                         bool force,
+                         bool ancestorsChanged,
                          int siblingsCount,
                          int indexAmongSiblings,
                          CSSUpdateResult& updateResult) {
     updateResult.visitedNodes++;
 
-    handleCSSChange(getCSSAttributesManager().setSiblingsIndexes(siblingsCount, indexAmongSiblings));
+    auto& cssAttributesManager = getCSSAttributesManager();
+    handleCSSChange(cssAttributesManager.setSiblingsIndexes(siblingsCount, indexAmongSiblings));
 
-    auto needUpdateSelf = force || _flags[kCSSNeedsUpdate];
-    auto needUpdateChildren = needUpdateSelf || _flags[kCSSHasChildNeedsUpdate];
+    bool needUpdateSelf = _flags[kCSSNeedsUpdate];
+    if (ancestorsChanged && cssAttributesManager.setAncestorsChanged()) {
+        needUpdateSelf = true;
+    }
+
+    // Only selectors on ancestors can make a change on this node affect the CSS of its descendants
+    auto descendantsAncestorsChanged =
+        ancestorsChanged || (_flags[kCSSNeedsUpdate] && cssAttributesManager.canAffectDescendantsCSS());
+    auto needUpdateChildren = descendantsAncestorsChanged || _flags[kCSSHasChildNeedsUpdate];
 
     if (needUpdateSelf) {
         updateResult.updatedNodes++;
-        getCSSAttributesManager().updateCSS(
+        cssAttributesManager.updateCSS(
             CSSAttributesManagerUpdateContext(viewTransactionScope, getAttributesApplier(), getLogger(), animator));
     }
     _attributesApplier.flush(viewTransactionScope);
@@ -2895,7 +3072,8 @@ void ViewNode::updateCSS(ViewTransactionScope& viewTransactionScope,
         auto childCount = static_cast<int>(getChildCount());
         int index = 0;
         for (auto* childViewNode : *this) {
-            childViewNode->updateCSS(viewTransactionScope, animator, needUpdateSelf, childCount, index, updateResult);
+            childViewNode->updateCSS(
+                viewTransactionScope, animator, descendantsAncestorsChanged, childCount, index, updateResult);
             index++;
         }
     }
@@ -3372,7 +3550,18 @@ YGSize ygMeasureYoga(
     auto convertedWidthMode = yogaMeasureModeToValdiMeasureMode(widthMode);
     auto convertedHeightMode = yogaMeasureModeToValdiMeasureMode(heightMode);
 
-    auto measuredSize = viewNode->onMeasure(width, convertedWidthMode, height, convertedHeightMode);
+    Size measuredSize;
+    if (measureCount->concurrentMeasureAttributes != nullptr) {
+        const auto& it = measureCount->concurrentMeasureAttributes->find(viewNode);
+        if (it != measureCount->concurrentMeasureAttributes->end()) {
+            measuredSize = viewNode->onMeasureWithLayoutAttributes(
+                it->second, width, convertedWidthMode, height, convertedHeightMode);
+        } else {
+            measuredSize = viewNode->onMeasure(width, convertedWidthMode, height, convertedHeightMode);
+        }
+    } else {
+        measuredSize = viewNode->onMeasure(width, convertedWidthMode, height, convertedHeightMode);
+    }
 
     auto pointScale = viewNode->getPointScale();
 
@@ -18,6 +18,7 @@
 
 #include "valdi_core/cpp/Context/PlatformType.hpp"
 #include "valdi_core/cpp/Utils/Bytes.hpp"
+#include "valdi_core/cpp/Utils/FlatMap.hpp"
 #include "valdi_core/cpp/Utils/Function.hpp"
 #include "valdi_core/cpp/Utils/ObjectPool.hpp"
 #include "valdi_core/cpp/Utils/Shared.hpp"
@@ -57,6 +58,7 @@ class BoundAttributes;
 class AttributeOwner;
 class ViewNodesFrameObserver;
 class Metrics;
+class ParallelWorkerPool;
 
 class ViewNode;
 class ViewNodeIterator {
@@ -81,6 +83,8 @@ struct LazyLayoutData {
     float estimatedWidth = 0;
     float estimatedHeight = 0;
     Ref<ValueFunction> onMeasureCallback;
+    // Whether the yoga node was already calculated by the layout worker pool for the current pass
+    bool hasConcurrentLayoutResult = false;
 
     ~LazyLayoutData();
 
@@ -351,6 +355,16 @@ public:
      */
     Size onMeasure(float width, MeasureMode widthMode, float height, MeasureMode heightMode);
 
+    /**
+     Measure through the MeasureDelegate from layout attributes which were resolved ahead of time,
+     can be called from a layout worker thread.
+     */
+    Size onMeasureWithLayoutAttributes(const Ref<ValueMap>& layoutAttributes,
+                                       float width,
+                                       MeasureMode widthMode,
+                                       float height,
+                                       MeasureMode heightMode);
+
     std::string getLayoutDebugDescription() const;
 
     Ref<ValueMap> getDebugDescriptionMap() const;
@@ -652,6 +666,12 @@ private:
     void setViewFrameNeedsUpdate();
 
     bool updateLazyLayout();
+    bool prepareLazyLayout(Size availableSize);
+    void calculateChildrenLazyLayoutsConcurrently(ParallelWorkerPool& layoutWorkerPool,
+                                                  bool didPerformLayoutForChildren);
+    bool prepareConcurrentMeasure(FlatMap<const ViewNode*, Ref<ValueMap>>& measureAttributes);
+    bool prepareChildrenConcurrentMeasure(FlatMap<const ViewNode*, Ref<ValueMap>>& measureAttributes);
+
     void doUpdateViewTree(ViewTransactionScope& viewTransactionScope,
                           const Ref<View>& currentParentView,
                           bool parentVisibleInViewport,
@@ -742,7 +762,7 @@ private:
 
     void updateCSS(ViewTransactionScope& viewTransactionScope,
                    const Ref<Animator>& animator,
-                   bool force,
+                   bool ancestorsChanged,
                    int siblingsCount,
                    int indexAmongSiblings,
                    CSSUpdateResult& updateResult);
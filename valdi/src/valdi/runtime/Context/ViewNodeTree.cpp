@@ -24,6 +24,7 @@
 #include "valdi/runtime/Views/GlobalViewFactories.hpp"
 #include "valdi/runtime/Views/MeasureDelegate.hpp"
 #include "valdi/runtime/Views/ViewTransactionScope.hpp"
+#include "valdi_core/cpp/Threading/ParallelWorkerPool.hpp"
 #include "valdi_core/cpp/Utils/SmallVector.hpp"
 
 #include "valdi_core/cpp/Utils/LoggerUtils.hpp"
@@ -831,6 +832,14 @@ void ViewNodeTree::setAssetTracker(const Ref<IViewNodesAssetTracker>& assetTrack
     _assetTracker = assetTracker;
 }
 
+void ViewNodeTree::setLayoutWorkerPool(const Ref<ParallelWorkerPool>& layoutWorkerPool) {
+    _layoutWorkerPool = layoutWorkerPool;
+}
+
+const Ref<ParallelWorkerPool>& ViewNodeTree::getLayoutWorkerPool() const {
+    return _layoutWorkerPool;
+}
+
 ViewNodeTreeDisableUpdates::ViewNodeTreeDisableUpdates() : _viewNodeTree(nullptr) {}
 
 ViewNodeTreeDisableUpdates::ViewNodeTreeDisableUpdates(const Ref<ViewNodeTree>& tree, TrackedLock&& guard)
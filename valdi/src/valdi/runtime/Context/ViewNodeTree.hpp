@@ -35,6 +35,7 @@ using SharedViewNodeTree = Ref<ViewNodeTree>;
 class ViewNodesVisibilityObserver;
 class ViewNodesFrameObserver;
 class IViewNodesAssetTracker;
+class ParallelWorkerPool;
 class MainThreadManager;
 class AttributesManager;
 class Metrics;
@@ -214,6 +215,13 @@ public:
     const Ref<IViewNodesAssetTracker>& getAssetTracker() const;
     void setAssetTracker(const Ref<IViewNodesAssetTracker>& assetTracker);
 
+    /**
+     Set the worker pool used to calculate the lazy layouts of sibling ViewNodes in parallel.
+     When not set, lazy layouts are calculated one after the other on the thread updating the tree.
+     */
+    void setLayoutWorkerPool(const Ref<ParallelWorkerPool>& layoutWorkerPool);
+    const Ref<ParallelWorkerPool>& getLayoutWorkerPool() const;
+
     void onNextLayout(const Ref<ValueFunction>& callback);
 
     [[nodiscard]] ViewNodeTreeDisableUpdates beginDisableUpdates();
@@ -246,6 +254,7 @@ private:
     Ref<ViewNodesVisibilityObserver> _visibilityObserver;
     Ref<ViewNodesFrameObserver> _framesObserver;
     Ref<IViewNodesAssetTracker> _assetTracker;
+    Ref<ParallelWorkerPool> _layoutWorkerPool;
     SharedAnimator _animator;
     Ref<View> _rootView;
     Ref<MainThreadManager> _mainThreadManager;
@@ -7,6 +7,7 @@
 
 #include "valdi/runtime/Context/ViewNodeTreeManager.hpp"
 #include "valdi/runtime/Context/ViewManagerContext.hpp"
+#include "valdi_core/cpp/Threading/ParallelWorkerPool.hpp"
 
 namespace Valdi {
 
@@ -43,6 +44,7 @@ SharedViewNodeTree ViewNodeTreeManager::lockFreeCreateViewNodeTreeForContext(
                                                         std::move(runtime),
                                                         &_mainThreadManager,
                                                         threadAffinity == ViewNodeTreeThreadAffinity::MAIN_THREAD);
+    viewNodeTree->setLayoutWorkerPool(_layoutWorkerPool);
 
     auto emplaced = _trees.try_emplace(context->getContextId(), viewNodeTree).second;
     SC_ASSERT(emplaced, "ViewNodeTree was already registered");
@@ -88,6 +90,11 @@ void ViewNodeTreeManager::setRuntime(std::weak_ptr<Runtime> runtime) {
     _runtime = std::move(runtime);
 }
 
+void ViewNodeTreeManager::setLayoutWorkerPool(const Ref<ParallelWorkerPool>& layoutWorkerPool) {
+    auto lock = std::unique_lock<std::mutex>(_mutex);
+    _layoutWorkerPool = layoutWorkerPool;
+}
+
 std::vector<SharedViewNodeTree> ViewNodeTreeManager::getAllRootViewNodeTrees() const {
     auto lock = std::unique_lock<std::mutex>(_mutex);
     std::vector<SharedViewNodeTree> out;
@@ -16,6 +16,7 @@ namespace Valdi {
 class Runtime;
 class ILogger;
 class MainThreadManager;
+class ParallelWorkerPool;
 
 enum class ViewNodeTreeThreadAffinity {
     /**
@@ -48,6 +49,12 @@ public:
 
     void setRuntime(std::weak_ptr<Runtime> runtime);
 
+    /**
+     Set the worker pool given to the ViewNodeTrees created from now on,
+     used to calculate the lazy layouts of sibling ViewNodes in parallel.
+     */
+    void setLayoutWorkerPool(const Ref<ParallelWorkerPool>& layoutWorkerPool);
+
     std::vector<SharedViewNodeTree> getAllRootViewNodeTrees() const;
 
     int getViewNodeTreesCount() const;
@@ -56,6 +63,7 @@ private:
     MainThreadManager& _mainThreadManager;
     [[maybe_unused]] ILogger& _logger;
     std::weak_ptr<Runtime> _runtime;
+    Ref<ParallelWorkerPool> _layoutWorkerPool;
     mutable std::mutex _mutex;
 
     FlatMap<ContextId, SharedViewNodeTree> _trees;
@@ -0,0 +1,78 @@
+#include "valdi/runtime/Interfaces/IDiskCache.hpp"
+#include "valdi_core/cpp/Utils/ByteBuffer.hpp"
+#include <cstring>
+
+namespace Valdi {
+
+// Each record is prefixed by its size, so that a record which was only partially written can be detected
+using DiskCacheRecordSize = uint32_t;
+
+Result<Void> IDiskCache::appendRecords(const Path& path, const std::vector<BytesView>& records) {
+    auto output = makeShared<ByteBuffer>();
+    serializeRecords(records, *output);
+
+    return appendByRewriting(path, output->toBytesView());
+}
+
+Result<Void> IDiskCache::append(const Path& path, const BytesView& bytes) {
+    return appendByRewriting(path, bytes);
+}
+
+Result<Void> IDiskCache::appendByRewriting(const Path& path, const BytesView& bytes) {
+    auto output = makeShared<ByteBuffer>();
+
+    if (exists(path)) {
+        auto existing = load(path);
+        if (!existing) {
+            return existing.moveError();
+        }
+        output->append(existing.value().begin(), existing.value().end());
+    }
+
+    output->append(bytes.begin(), bytes.end());
+
+    return store(path, output->toBytesView());
+}
+
+Result<std::vector<BytesView>> IDiskCache::loadRecords(const Path& path) {
+    auto data = load(path);
+    if (!data) {
+        return data.moveError();
+    }
+
+    return parseRecords(data.value());
+}
+
+void IDiskCache::serializeRecords(const std::vector<BytesView>& records, ByteBuffer& output) {
+    for (const auto& record : records) {
+        auto recordSize = static_cast<DiskCacheRecordSize>(record.size());
+        output.append(reinterpret_cast<const Byte*>(&recordSize),
+                      reinterpret_cast<const Byte*>(&recordSize) + sizeof(recordSize));
+        output.append(record.begin(), record.end());
+    }
+}
+
+std::vector<BytesView> IDiskCache::parseRecords(const BytesView& data) {
+    std::vector<BytesView> records;
+
+    const auto* current = data.begin();
+    const auto* end = data.end();
+
+    while (static_cast<size_t>(end - current) >= sizeof(DiskCacheRecordSize)) {
+        DiskCacheRecordSize recordSize;
+        std::memcpy(&recordSize, current, sizeof(recordSize));
+        current += sizeof(recordSize);
+
+        if (static_cast<size_t>(end - current) < recordSize) {
+            // Truncated record
+            break;
+        }
+
+        records.emplace_back(data.getSource(), current, recordSize);
+        current += recordSize;
+    }
+
+    return records;
+}
+
+} // namespace Valdi
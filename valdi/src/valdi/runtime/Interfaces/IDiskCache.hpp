@@ -13,8 +13,12 @@
 #include "valdi_core/cpp/Utils/Shared.hpp"
 #include "valdi_core/cpp/Utils/StringBox.hpp"
 
+#include <vector>
+
 namespace Valdi {
 
+class ByteBuffer;
+
 class IDiskCache : public SimpleRefCountable {
 public:
     /**
@@ -28,6 +32,15 @@ public:
      */
     [[nodiscard]] virtual Result<BytesView> load(const Path& path) = 0;
 
+    /**
+     Load the content of the item at the given path, mapping it into memory
+     when supported by the implementation. The returned bytes remain valid
+     even if the item is later replaced or removed.
+     */
+    [[nodiscard]] virtual Result<BytesView> loadMapped(const Path& path) {
+        return load(path);
+    }
+
     /**
      Load the content of the item at the given absolute URL and return the result
      as bytes.
@@ -39,6 +52,45 @@ public:
      */
     [[nodiscard]] virtual Result<Void> store(const Path& path, const BytesView& bytes) = 0;
 
+    /**
+     Append the given records at the end of the item at the given path, creating the item
+     if needed. Records are meant for append-only journals and should only be read back
+     using loadRecords(). The default implementation rewrites the whole item.
+     */
+    [[nodiscard]] virtual Result<Void> appendRecords(const Path& path, const std::vector<BytesView>& records);
+
+    /**
+     Returns whether append() and appendRecords() only write the appended bytes. Callers should not
+     keep append-only journals in caches which return false, since every append rewrites the whole item.
+     */
+    virtual bool supportsIncrementalAppend() const {
+        return false;
+    }
+
+    /**
+     Append the given bytes at the end of the item at the given path, creating the item if needed.
+     Used to write large items incrementally, which should be read back using loadAppended().
+     The bytes are not retained after the call returns. The default implementation rewrites
+     the whole item.
+     */
+    [[nodiscard]] virtual Result<Void> append(const Path& path, const BytesView& bytes);
+
+    /**
+     Load the content of an item that was written using append(). Implementations which
+     transform the stored bytes can store each appended chunk separately, and reassemble
+     them here. The default implementation calls load().
+     */
+    [[nodiscard]] virtual Result<BytesView> loadAppended(const Path& path) {
+        return load(path);
+    }
+
+    /**
+     Load the records that were appended to the item at the given path using appendRecords(),
+     in the order in which they were appended. A trailing record which was only partially
+     written, for instance because the process was killed while appending, is ignored.
+     */
+    [[nodiscard]] virtual Result<std::vector<BytesView>> loadRecords(const Path& path);
+
     /**
      Creates a new IDiskCache that will operate relative to the given path.
      */
@@ -66,6 +118,19 @@ public:
      should not be stored on disk.
      */
     virtual StringBox getAbsoluteURL(const Path& path) const = 0;
+
+protected:
+    /**
+     Serialize the given records into the format read by parseRecords().
+     */
+    static void serializeRecords(const std::vector<BytesView>& records, ByteBuffer& output);
+    static std::vector<BytesView> parseRecords(const BytesView& data);
+
+    /**
+     Append the given bytes by loading the whole item and storing it back.
+     Used by implementations which cannot append in place.
+     */
+    Result<Void> appendByRewriting(const Path& path, const BytesView& bytes);
 };
 
 } // namespace Valdi
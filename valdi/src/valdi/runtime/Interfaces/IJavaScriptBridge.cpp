@@ -0,0 +1,28 @@
+#include "valdi/runtime/Interfaces/IJavaScriptBridge.hpp"
+#include "valdi/runtime/Interfaces/IDiskCache.hpp"
+#include "valdi_core/cpp/Utils/Format.hpp"
+
+namespace Valdi {
+
+void IJavaScriptBridge::dumpHeapToDiskCache(std::span<IJavaScriptContext*> jsContexts,
+                                            IDiskCache& diskCache,
+                                            const Path& path,
+                                            JSExceptionTracker& exceptionTracker) {
+    auto heapDump = dumpHeap(jsContexts, exceptionTracker);
+    if (!exceptionTracker) {
+        return;
+    }
+
+    // Items read back through loadAppended() must be written through append()
+    if (diskCache.exists(path) && !diskCache.remove(path)) {
+        exceptionTracker.onError(Error(STRING_FORMAT("Unable to remove previous heap dump at {}", path.toString())));
+        return;
+    }
+
+    auto result = diskCache.append(path, heapDump);
+    if (!result) {
+        exceptionTracker.onError(result.moveError());
+    }
+}
+
+} // namespace Valdi
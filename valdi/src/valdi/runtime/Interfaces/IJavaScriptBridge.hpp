@@ -10,10 +10,12 @@
 
 #include "valdi/runtime/Interfaces/IJavaScriptContext.hpp"
 #include "valdi_core/cpp/Utils/Bytes.hpp"
+#include "valdi_core/cpp/Utils/PathUtils.hpp"
 #include <span>
 
 namespace Valdi {
 
+class IDiskCache;
 class ILogger;
 
 struct IJavaScriptBridgeConfig {};
@@ -50,6 +52,17 @@ public:
      */
     virtual BytesView dumpHeap(std::span<IJavaScriptContext*> jsContexts, JSExceptionTracker& exceptionTracker) = 0;
 
+    /**
+     Dumps the heap for the given JSContexts into the item at the given path of the disk cache.
+     The item should be read back using IDiskCache::loadAppended(). Bridges which build the heap dump
+     themselves should stream it into the disk cache. The default implementation stores the result
+     of dumpHeap().
+     */
+    virtual void dumpHeapToDiskCache(std::span<IJavaScriptContext*> jsContexts,
+                                     IDiskCache& diskCache,
+                                     const Path& path,
+                                     JSExceptionTracker& exceptionTracker);
+
     /**
      * Starts the JS debugger server for the created JSContexts.
      */
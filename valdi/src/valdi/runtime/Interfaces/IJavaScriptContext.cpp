@@ -6,6 +6,8 @@
 //
 
 #include "valdi/runtime/Interfaces/IJavaScriptContext.hpp"
+#include "valdi/runtime/Interfaces/IDiskCache.hpp"
+#include "valdi/runtime/JavaScript/JavaScriptBytecodeCache.hpp"
 #include "valdi/runtime/JavaScript/JavaScriptFunctionCallContext.hpp"
 #include "valdi/runtime/JavaScript/JavaScriptUtils.hpp"
 #include "valdi/runtime/JavaScript/JavaScriptValueMarshaller.hpp"
@@ -22,6 +24,38 @@ JavaScriptTaskScheduler* IJavaScriptContext::getTaskScheduler() const {
     return _taskScheduler;
 }
 
+void IJavaScriptContext::setBytecodeDiskCache(const Ref<IDiskCache>& diskCache,
+                                              const Ref<DispatchQueue>& dispatchQueue,
+                                              size_t maxSizeBytes,
+                                              ILogger& logger) {
+    if (diskCache == nullptr || !supportsPreCompilation()) {
+        _bytecodeCache = nullptr;
+        return;
+    }
+
+    auto bytecodeVersion = getPreCompiledBytecodeVersion();
+    if (bytecodeVersion.isEmpty()) {
+        _bytecodeCache = nullptr;
+        return;
+    }
+
+    // Each engine version gets its own folder so that upgrading the engine does not
+    // require to load the previous entries to discard them.
+    auto scopedDiskCache = diskCache->scopedCache(Path(bytecodeVersion.toStringView()), false);
+    if (scopedDiskCache == nullptr) {
+        _bytecodeCache = nullptr;
+        return;
+    }
+
+    _bytecodeCache =
+        makeShared<JavaScriptBytecodeCache>(scopedDiskCache, dispatchQueue, bytecodeVersion, maxSizeBytes, logger);
+    _bytecodeCache->prewarm();
+}
+
+const Ref<JavaScriptBytecodeCache>& IJavaScriptContext::getBytecodeCache() const {
+    return _bytecodeCache;
+}
+
 void IJavaScriptContext::setLongConstructor(const JSValueRef& longConstructor) {
     _longConstructor = ensureRetainedValue(longConstructor);
 }
@@ -40,6 +40,8 @@ class IJavaScriptContext;
 class JavaScriptTaskScheduler;
 class JavaScriptValueMarshaller;
 class IDiskCache;
+class ILogger;
+class JavaScriptBytecodeCache;
 
 constexpr bool shouldEnableJsHeapDump() {
     return snap::kIsDevBuild || snap::kIsGoldBuild;
@@ -289,7 +291,31 @@ public:
         return Error("Profiler Unimplemented");
     }
 
-    virtual void setBytecodeDiskCache(const Ref<IDiskCache>& diskCache) {}
+    /**
+     Returns a version identifying the format of the bytecode produced by preCompile().
+     It should change whenever bytecode produced by a previous version of the engine
+     can't be evaluated anymore. Returns an empty string if the bytecode produced by
+     this engine should not be persisted.
+     */
+    virtual StringBox getPreCompiledBytecodeVersion() const {
+        return StringBox();
+    }
+
+    /**
+     Enables the persistent bytecode cache for the JS modules which are loaded from source.
+     The modules will be compiled with preCompile() the first time they are loaded and
+     stored into the given disk cache, writes happen on the given dispatch queue.
+     Does nothing if the engine does not support pre compilation.
+     */
+    void setBytecodeDiskCache(const Ref<IDiskCache>& diskCache,
+                              const Ref<DispatchQueue>& dispatchQueue,
+                              size_t maxSizeBytes,
+                              ILogger& logger);
+
+    /**
+     Returns the bytecode cache if it was enabled with setBytecodeDiskCache()
+     */
+    const Ref<JavaScriptBytecodeCache>& getBytecodeCache() const;
 
     IJavaScriptContextListener* getListener() const;
 
@@ -432,6 +458,7 @@ private:
     bool _tearingDown = false;
 
     std::unique_ptr<JavaScriptValueMarshaller> _valueMarshaller;
+    Ref<JavaScriptBytecodeCache> _bytecodeCache;
 
     StashedJSValue* doGetStashedJSValue(const JSValueID& id);
 
@@ -0,0 +1,495 @@
+#include "valdi/runtime/JavaScript/JavaScriptBytecodeCache.hpp"
+#include "valdi/runtime/Context/Context.hpp"
+#include "valdi/runtime/Interfaces/IDiskCache.hpp"
+#include "valdi/runtime/Interfaces/IJavaScriptBridge.hpp"
+#include "valdi/runtime/Interfaces/IJavaScriptContext.hpp"
+#include "valdi/runtime/JavaScript/JavaScriptContextEntryPoint.hpp"
+#include "valdi/runtime/Utils/BytesUtils.hpp"
+#include "valdi_core/cpp/Utils/LoggerUtils.hpp"
+#include "valdi_core/cpp/Utils/Parser.hpp"
+#include "valdi_core/cpp/Utils/Trace.hpp"
+
+#include <cstring>
+
+namespace Valdi {
+
+// Bump when the layout of the entries or of the index changes
+static constexpr uint32_t kBytecodeCacheFormatVersion = 2;
+static constexpr uint32_t kBytecodeCacheEntryMagic = 0x43434256; // VBCC
+static constexpr uint32_t kBytecodeCacheIndexMagic = 0x49434256; // VBCI
+static constexpr size_t kSHA256Length = 32;
+static constexpr size_t kFileNameLength = kSHA256Length * 2;
+static constexpr std::string_view kIndexFileName = "index";
+
+struct BytecodeCacheEntryHeader {
+    uint32_t magic;
+    uint32_t formatVersion;
+    uint64_t engineBytecodeVersionHash;
+    uint64_t sourceSize;
+    uint64_t bytecodeSize;
+    uint64_t bytecodeChecksum;
+    Byte sourceHash[kSHA256Length];
+};
+
+struct BytecodeCacheIndexHeader {
+    uint32_t magic;
+    uint32_t formatVersion;
+    uint64_t entriesCount;
+    uint64_t accessSequence;
+};
+
+struct BytecodeCacheIndexEntry {
+    char fileName[kFileNameLength];
+    uint64_t size;
+    uint64_t lastAccess;
+};
+
+// 64 bits FNV-1a. The checksums are persisted, so unlike std::hash the result
+// must be the same across builds, standard libraries and processes.
+static uint64_t computeChecksum(const Byte* data, size_t length) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= static_cast<uint64_t>(data[i]);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static uint64_t computeChecksum(std::string_view str) {
+    return computeChecksum(reinterpret_cast<const Byte*>(str.data()), str.size());
+}
+
+JavaScriptBytecodeCache::JavaScriptBytecodeCache(const Ref<IDiskCache>& diskCache,
+                                                 const Ref<DispatchQueue>& dispatchQueue,
+                                                 const StringBox& engineBytecodeVersion,
+                                                 size_t maxSizeBytes,
+                                                 ILogger& logger)
+    : _diskCache(diskCache),
+      _dispatchQueue(dispatchQueue),
+      _engineBytecodeVersion(engineBytecodeVersion),
+      _engineBytecodeVersionHash(computeChecksum(engineBytecodeVersion.toStringView())),
+      _maxSizeBytes(maxSizeBytes),
+      _logger(logger) {}
+
+JavaScriptBytecodeCache::~JavaScriptBytecodeCache() = default;
+
+void JavaScriptBytecodeCache::prewarm() {
+    std::lock_guard<Mutex> guard(_mutex);
+    scheduleLoadIndex();
+}
+
+JavaScriptBytecodeCacheKey JavaScriptBytecodeCache::makeKey(const StringBox& importPath,
+                                                            const BytesView& source) const {
+    JavaScriptBytecodeCacheKey key;
+    key.sourceHash = BytesUtils::sha256(source);
+    key.sourceSize = source.size();
+
+    // The import path is part of the key as the engines embed the source filename
+    // inside the bytecode for the stack traces.
+    ByteBuffer keyData;
+    keyData.append(_engineBytecodeVersion.toStringView());
+    keyData.append(static_cast<Byte>(0));
+    keyData.append(importPath.toStringView());
+    keyData.append(static_cast<Byte>(0));
+    keyData.append(key.sourceHash->begin(), key.sourceHash->end());
+
+    key.fileName = BytesUtils::sha256String(keyData.data(), keyData.size());
+
+    return key;
+}
+
+std::optional<BytesView> JavaScriptBytecodeCache::load(const JavaScriptBytecodeCacheKey& key) {
+    VALDI_TRACE("Valdi.loadCachedBytecode");
+    waitForIndex();
+    {
+        std::lock_guard<Mutex> guard(_mutex);
+        if (_index.find(key.fileName) == _index.end()) {
+            _missCount++;
+            return std::nullopt;
+        }
+    }
+
+    auto loadResult = _diskCache->load(Path(key.fileName));
+
+    std::optional<BytesView> output;
+    if (loadResult) {
+        const auto& entryBytes = loadResult.value();
+        Parser<Byte> parser(entryBytes.data(), entryBytes.data() + entryBytes.size());
+        auto header = parser.parseStruct<BytecodeCacheEntryHeader>();
+
+        if (header) {
+            const auto& entryHeader = *header.value();
+            if (entryHeader.magic == kBytecodeCacheEntryMagic &&
+                entryHeader.formatVersion == kBytecodeCacheFormatVersion &&
+                entryHeader.engineBytecodeVersionHash == _engineBytecodeVersionHash &&
+                entryHeader.sourceSize == key.sourceSize &&
+                std::memcmp(entryHeader.sourceHash, key.sourceHash->data(), kSHA256Length) == 0 &&
+                entryHeader.bytecodeSize == parser.getDistanceToEnd() &&
+                entryHeader.bytecodeChecksum == computeChecksum(parser.getCurrent(), parser.getDistanceToEnd())) {
+                output = {BytesView(entryBytes.getSource(), parser.getCurrent(), parser.getDistanceToEnd())};
+            }
+        }
+    }
+
+    if (!output) {
+        VALDI_WARN(_logger, "Discarding stale or corrupted JS bytecode cache entry '{}'", key.fileName);
+        _missCount++;
+        {
+            std::lock_guard<Mutex> guard(_mutex);
+            removeFromIndex(key.fileName);
+        }
+        remove(key);
+        return std::nullopt;
+    }
+
+    _hitCount++;
+    std::lock_guard<Mutex> guard(_mutex);
+    const auto& it = _index.find(key.fileName);
+    if (it != _index.end()) {
+        it->second.lastAccess = ++_accessSequence;
+        scheduleFlushIndex();
+    }
+
+    return output;
+}
+
+void JavaScriptBytecodeCache::store(JavaScriptBytecodeCacheKey key, const BytesView& preCompiledJsModule) {
+    _dispatchQueue->async([self = strongSmallRef(this), key = std::move(key), preCompiledJsModule]() {
+        self->doStore(key, preCompiledJsModule);
+    });
+}
+
+void JavaScriptBytecodeCache::compileAndStore(IJavaScriptBridge& jsBridge,
+                                              JavaScriptBytecodeCacheKey key,
+                                              const StringBox& importPath,
+                                              const BytesView& source) {
+    std::lock_guard<Mutex> guard(_mutex);
+    auto& pendingCompilation = _pendingCompilations.emplace_back();
+    pendingCompilation.jsBridge = &jsBridge;
+    pendingCompilation.key = std::move(key);
+    pendingCompilation.importPath = importPath;
+    pendingCompilation.source = source;
+
+    if (_compilationScheduled) {
+        return;
+    }
+    _compilationScheduled = true;
+
+    _dispatchQueue->async([self = strongSmallRef(this)]() { self->doCompilePending(); });
+}
+
+void JavaScriptBytecodeCache::remove(JavaScriptBytecodeCacheKey key) {
+    _dispatchQueue->async([self = strongSmallRef(this), key = std::move(key)]() { self->doRemove(key.fileName); });
+}
+
+void JavaScriptBytecodeCache::doStore(const JavaScriptBytecodeCacheKey& key, const BytesView& preCompiledJsModule) {
+    VALDI_TRACE("Valdi.storeCachedBytecode");
+
+    BytecodeCacheEntryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = kBytecodeCacheEntryMagic;
+    header.formatVersion = kBytecodeCacheFormatVersion;
+    header.engineBytecodeVersionHash = _engineBytecodeVersionHash;
+    header.sourceSize = static_cast<uint64_t>(key.sourceSize);
+    header.bytecodeSize = static_cast<uint64_t>(preCompiledJsModule.size());
+    header.bytecodeChecksum = computeChecksum(preCompiledJsModule.data(), preCompiledJsModule.size());
+    std::memcpy(header.sourceHash, key.sourceHash->data(), kSHA256Length);
+
+    auto entryBytes = makeShared<ByteBuffer>();
+    entryBytes->reserve(sizeof(header) + preCompiledJsModule.size());
+    entryBytes->append(reinterpret_cast<const Byte*>(&header), reinterpret_cast<const Byte*>(&header + 1));
+    entryBytes->append(preCompiledJsModule.begin(), preCompiledJsModule.end());
+
+    loadIndexIfNeeded();
+    removeOrphanedFiles();
+
+    auto storeResult = _diskCache->store(Path(key.fileName), entryBytes->toBytesView());
+    if (!storeResult) {
+        VALDI_ERROR(_logger, "Failed to store JS bytecode cache entry: {}", storeResult.error());
+        return;
+    }
+
+    std::vector<std::string> evictedFileNames;
+    Ref<ByteBuffer> indexBytes;
+    {
+        std::lock_guard<Mutex> guard(_mutex);
+        auto& indexEntry = _index[key.fileName];
+        _totalSize -= indexEntry.size;
+        indexEntry.size = static_cast<uint32_t>(entryBytes->size());
+        indexEntry.lastAccess = ++_accessSequence;
+        _totalSize += indexEntry.size;
+
+        evictIfNeeded(evictedFileNames);
+        indexBytes = serializeIndex();
+    }
+
+    removeFiles(evictedFileNames);
+    persistIndex(indexBytes);
+}
+
+void JavaScriptBytecodeCache::doRemove(const std::string& fileName) {
+    loadIndexIfNeeded();
+
+    Ref<ByteBuffer> indexBytes;
+    {
+        std::lock_guard<Mutex> guard(_mutex);
+        removeFromIndex(fileName);
+        indexBytes = serializeIndex();
+    }
+
+    removeFiles({fileName});
+    persistIndex(indexBytes);
+}
+
+void JavaScriptBytecodeCache::doCompilePending() {
+    VALDI_TRACE("Valdi.compileCachedBytecode");
+
+    std::vector<PendingCompilation> pendingCompilations;
+    {
+        std::lock_guard<Mutex> guard(_mutex);
+        pendingCompilations = std::move(_pendingCompilations);
+        _pendingCompilations.clear();
+        _compilationScheduled = false;
+    }
+
+    if (pendingCompilations.empty()) {
+        return;
+    }
+
+    // The JS contexts are single threaded, the compilation uses its own context
+    // which lives for the duration of this task.
+    auto context = makeShared<Context>(1, strongSmallRef(&_logger));
+    context->retainDisposables();
+
+    {
+        JavaScriptContextEntry entry(context);
+        IJavaScriptBridge* jsBridge = nullptr;
+        Ref<IJavaScriptContext> jsContext;
+
+        for (const auto& pendingCompilation : pendingCompilations) {
+            if (jsBridge != pendingCompilation.jsBridge) {
+                jsBridge = pendingCompilation.jsBridge;
+                jsContext = jsBridge->createJsContext(nullptr, _logger);
+
+                JSExceptionTracker exceptionTracker(*jsContext);
+                jsContext->initialize(IJavaScriptContextConfig(), exceptionTracker);
+                if (!exceptionTracker) {
+                    VALDI_ERROR(_logger,
+                                "Failed to create JS context to compile bytecode: {}",
+                                exceptionTracker.extractError());
+                    jsContext = nullptr;
+                }
+            }
+
+            if (jsContext == nullptr) {
+                continue;
+            }
+
+            JSExceptionTracker exceptionTracker(*jsContext);
+            auto preCompiledModule = jsContext->preCompile(pendingCompilation.source.asStringView(),
+                                                           pendingCompilation.importPath.toStringView(),
+                                                           exceptionTracker);
+            if (!exceptionTracker) {
+                // The error is surfaced by the JS thread which evaluated the source
+                exceptionTracker.clearError();
+                continue;
+            }
+
+            doStore(pendingCompilation.key, preCompiledModule);
+        }
+    }
+
+    context->releaseDisposables();
+}
+
+size_t JavaScriptBytecodeCache::getTotalSize() {
+    waitForIndex();
+    std::lock_guard<Mutex> guard(_mutex);
+    return _totalSize;
+}
+
+size_t JavaScriptBytecodeCache::getHitCount() const {
+    return _hitCount.load();
+}
+
+size_t JavaScriptBytecodeCache::getMissCount() const {
+    return _missCount.load();
+}
+
+void JavaScriptBytecodeCache::scheduleLoadIndex() {
+    if (_indexLoaded || _indexLoadScheduled) {
+        return;
+    }
+    _indexLoadScheduled = true;
+
+    _dispatchQueue->async([self = strongSmallRef(this)]() { self->loadIndexIfNeeded(); });
+}
+
+void JavaScriptBytecodeCache::waitForIndex() {
+    std::unique_lock<Mutex> lock(_mutex);
+    scheduleLoadIndex();
+    while (!_indexLoaded) {
+        _indexLoadedCondition.wait(lock);
+    }
+}
+
+void JavaScriptBytecodeCache::loadIndexIfNeeded() {
+    {
+        std::lock_guard<Mutex> guard(_mutex);
+        if (_indexLoaded) {
+            return;
+        }
+    }
+
+    // Only called from the dispatch queue, so the index cannot be written concurrently.
+    auto indexResult = _diskCache->load(Path(kIndexFileName));
+
+    std::lock_guard<Mutex> guard(_mutex);
+    _indexLoaded = true;
+    _indexLoadedCondition.notifyAll();
+
+    if (!indexResult) {
+        return;
+    }
+
+    const auto& indexBytes = indexResult.value();
+    Parser<Byte> parser(indexBytes.data(), indexBytes.data() + indexBytes.size());
+    auto header = parser.parseStruct<BytecodeCacheIndexHeader>();
+    if (!header || header.value()->magic != kBytecodeCacheIndexMagic ||
+        header.value()->formatVersion != kBytecodeCacheFormatVersion) {
+        // Unknown index, the entries will be removed as orphans on the next store
+        return;
+    }
+
+    auto entriesCount = header.value()->entriesCount;
+    _accessSequence = header.value()->accessSequence;
+
+    for (uint64_t i = 0; i < entriesCount; i++) {
+        auto entry = parser.parseStruct<BytecodeCacheIndexEntry>();
+        if (!entry) {
+            break;
+        }
+
+        auto& indexEntry = _index[std::string(entry.value()->fileName, kFileNameLength)];
+        indexEntry.size = static_cast<uint32_t>(entry.value()->size);
+        indexEntry.lastAccess = entry.value()->lastAccess;
+        _totalSize += indexEntry.size;
+    }
+}
+
+void JavaScriptBytecodeCache::removeFromIndex(const std::string& fileName) {
+    const auto& it = _index.find(fileName);
+    if (it != _index.end()) {
+        _totalSize -= it->second.size;
+        _index.erase(it);
+    }
+}
+
+void JavaScriptBytecodeCache::evictIfNeeded(std::vector<std::string>& evictedFileNames) {
+    while (_totalSize > _maxSizeBytes && !_index.empty()) {
+        auto leastRecentlyUsed = _index.begin();
+        for (auto it = _index.begin(); it != _index.end(); ++it) {
+            if (it->second.lastAccess < leastRecentlyUsed->second.lastAccess) {
+                leastRecentlyUsed = it;
+            }
+        }
+
+        auto fileName = leastRecentlyUsed->first;
+        removeFromIndex(fileName);
+        evictedFileNames.emplace_back(std::move(fileName));
+    }
+}
+
+void JavaScriptBytecodeCache::removeOrphanedFiles() {
+    if (_orphansRemoved) {
+        return;
+    }
+    _orphansRemoved = true;
+
+    // Remove files that were written but never made it to the index,
+    // which can happen if the process is killed between the two writes.
+    std::vector<std::string> fileNames;
+    for (const auto& path : _diskCache->list(_diskCache->getRootPath())) {
+        auto fileName = path.getLastComponent();
+        if (fileName != kIndexFileName) {
+            fileNames.emplace_back(fileName);
+        }
+    }
+
+    removeFiles(fileNames);
+}
+
+void JavaScriptBytecodeCache::removeFiles(const std::vector<std::string>& fileNames) {
+    for (const auto& fileName : fileNames) {
+        {
+            std::lock_guard<Mutex> guard(_mutex);
+            if (_index.find(fileName) != _index.end()) {
+                continue;
+            }
+        }
+
+        // Entries are only added to the index from the dispatch queue, so the file
+        // cannot be referenced again while it is being removed.
+        _diskCache->remove(Path(fileName));
+    }
+}
+
+Ref<ByteBuffer> JavaScriptBytecodeCache::serializeIndex() {
+    _indexDirty = false;
+
+    BytecodeCacheIndexHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = kBytecodeCacheIndexMagic;
+    header.formatVersion = kBytecodeCacheFormatVersion;
+    header.entriesCount = static_cast<uint64_t>(_index.size());
+    header.accessSequence = _accessSequence;
+
+    auto indexBytes = makeShared<ByteBuffer>();
+    indexBytes->reserve(sizeof(header) + sizeof(BytecodeCacheIndexEntry) * _index.size());
+    indexBytes->append(reinterpret_cast<const Byte*>(&header), reinterpret_cast<const Byte*>(&header + 1));
+
+    for (const auto& it : _index) {
+        if (it.first.size() != kFileNameLength) {
+            continue;
+        }
+
+        BytecodeCacheIndexEntry entry;
+        std::memcpy(entry.fileName, it.first.data(), kFileNameLength);
+        entry.size = static_cast<uint64_t>(it.second.size);
+        entry.lastAccess = it.second.lastAccess;
+        indexBytes->append(reinterpret_cast<const Byte*>(&entry), reinterpret_cast<const Byte*>(&entry + 1));
+    }
+
+    return indexBytes;
+}
+
+void JavaScriptBytecodeCache::persistIndex(const Ref<ByteBuffer>& indexBytes) {
+    auto storeResult = _diskCache->store(Path(kIndexFileName), indexBytes->toBytesView());
+    if (!storeResult) {
+        VALDI_ERROR(_logger, "Failed to store JS bytecode cache index: {}", storeResult.error());
+    }
+}
+
+void JavaScriptBytecodeCache::scheduleFlushIndex() {
+    _indexDirty = true;
+    if (_flushScheduled) {
+        return;
+    }
+    _flushScheduled = true;
+
+    _dispatchQueue->async([self = strongSmallRef(this)]() {
+        Ref<ByteBuffer> indexBytes;
+        {
+            std::lock_guard<Mutex> guard(self->_mutex);
+            self->_flushScheduled = false;
+            if (!self->_indexDirty) {
+                return;
+            }
+            indexBytes = self->serializeIndex();
+        }
+
+        self->persistIndex(indexBytes);
+    });
+}
+
+} // namespace Valdi
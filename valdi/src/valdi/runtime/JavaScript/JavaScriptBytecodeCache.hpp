@@ -0,0 +1,152 @@
+#pragma once
+
+#include "valdi_core/cpp/Threading/DispatchQueue.hpp"
+#include "valdi_core/cpp/Utils/ByteBuffer.hpp"
+#include "valdi_core/cpp/Utils/Bytes.hpp"
+#include "valdi_core/cpp/Utils/FlatMap.hpp"
+#include "valdi_core/cpp/Utils/Mutex.hpp"
+#include "valdi_core/cpp/Utils/Shared.hpp"
+#include "valdi_core/cpp/Utils/StringBox.hpp"
+#include <atomic>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Valdi {
+
+class IDiskCache;
+class IJavaScriptBridge;
+class ILogger;
+
+struct JavaScriptBytecodeCacheKey {
+    // Name of the file holding the entry, derived from the engine version, import path and content hash
+    std::string fileName;
+    // SHA256 of the JS source
+    Ref<ByteBuffer> sourceHash;
+    size_t sourceSize = 0;
+};
+
+/**
+ A persistent cache of JS modules compiled into bytecode by the JS engine.
+ It is used for modules that are shipped as JS source, so that the parsing
+ and compilation only happens once per module and engine version.
+
+ Entries are keyed by the hash of the module content, the import path and
+ the bytecode version of the engine. Each entry holds a header which is
+ checked on load, so that stale or corrupted entries are rejected and removed.
+ The total size of the cache is bounded, the least recently used entries are
+ evicted when the cache goes above its maximum size.
+
+ load() can be called from any thread but the dispatch queue. The index, writes,
+ evictions and compilations happen on the given dispatch queue. The disk cache is
+ never accessed while holding the lock protecting the in-memory index.
+ */
+class JavaScriptBytecodeCache : public SimpleRefCountable {
+public:
+    static constexpr size_t kDefaultMaxSizeBytes = 32 * 1024 * 1024;
+
+    JavaScriptBytecodeCache(const Ref<IDiskCache>& diskCache,
+                            const Ref<DispatchQueue>& dispatchQueue,
+                            const StringBox& engineBytecodeVersion,
+                            size_t maxSizeBytes,
+                            ILogger& logger);
+    ~JavaScriptBytecodeCache() override;
+
+    /**
+     Start loading the index on the dispatch queue, so that it is ready
+     by the time the first module is loaded.
+     */
+    void prewarm();
+
+    JavaScriptBytecodeCacheKey makeKey(const StringBox& importPath, const BytesView& source) const;
+
+    /**
+     Returns the cached pre compiled JS module for the given key,
+     as produced by IJavaScriptContext::preCompile(), or nullopt if
+     the cache has no valid entry for it. Waits for the index if it
+     is still being loaded.
+     */
+    std::optional<BytesView> load(const JavaScriptBytecodeCacheKey& key);
+
+    /**
+     Asynchronously store the pre compiled JS module for the given key.
+     */
+    void store(JavaScriptBytecodeCacheKey key, const BytesView& preCompiledJsModule);
+
+    /**
+     Asynchronously compile the given JS module source and store the result.
+     The compilation happens on the dispatch queue with a JS context created from
+     the given bridge, so that it does not block the JS thread. Compilations
+     scheduled while one is in progress share the same JS context.
+     */
+    void compileAndStore(IJavaScriptBridge& jsBridge,
+                         JavaScriptBytecodeCacheKey key,
+                         const StringBox& importPath,
+                         const BytesView& source);
+
+    /**
+     Asynchronously remove the entry for the given key. Should be called
+     when the engine failed to evaluate a cached entry.
+     */
+    void remove(JavaScriptBytecodeCacheKey key);
+
+    /**
+     Returns the sum of the size of all the entries in the cache.
+     */
+    size_t getTotalSize();
+
+    size_t getHitCount() const;
+    size_t getMissCount() const;
+
+private:
+    struct IndexEntry {
+        uint32_t size = 0;
+        uint64_t lastAccess = 0;
+    };
+
+    struct PendingCompilation {
+        IJavaScriptBridge* jsBridge = nullptr;
+        JavaScriptBytecodeCacheKey key;
+        StringBox importPath;
+        BytesView source;
+    };
+
+    Mutex _mutex;
+    ConditionVariable _indexLoadedCondition;
+    Ref<IDiskCache> _diskCache;
+    Ref<DispatchQueue> _dispatchQueue;
+    StringBox _engineBytecodeVersion;
+    uint64_t _engineBytecodeVersionHash;
+    size_t _maxSizeBytes;
+    ILogger& _logger;
+
+    FlatMap<std::string, IndexEntry> _index;
+    size_t _totalSize = 0;
+    uint64_t _accessSequence = 0;
+    bool _indexLoaded = false;
+    bool _indexLoadScheduled = false;
+    bool _indexDirty = false;
+    bool _flushScheduled = false;
+    bool _orphansRemoved = false;
+    bool _compilationScheduled = false;
+    std::vector<PendingCompilation> _pendingCompilations;
+    std::atomic<size_t> _hitCount = 0;
+    std::atomic<size_t> _missCount = 0;
+
+    void scheduleLoadIndex();
+    void waitForIndex();
+    void loadIndexIfNeeded();
+    void removeFromIndex(const std::string& fileName);
+    void evictIfNeeded(std::vector<std::string>& evictedFileNames);
+    void removeOrphanedFiles();
+    void removeFiles(const std::vector<std::string>& fileNames);
+    Ref<ByteBuffer> serializeIndex();
+    void persistIndex(const Ref<ByteBuffer>& indexBytes);
+    void scheduleFlushIndex();
+
+    void doStore(const JavaScriptBytecodeCacheKey& key, const BytesView& preCompiledJsModule);
+    void doRemove(const std::string& fileName);
+    void doCompilePending();
+};
+
+} // namespace Valdi
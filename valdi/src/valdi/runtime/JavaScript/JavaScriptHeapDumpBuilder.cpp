@@ -7,8 +7,10 @@
 
 #include "valdi/runtime/JavaScript/JavaScriptHeapDumpBuilder.hpp"
 #include "utils/debugging/Assert.hpp"
+#include "valdi/runtime/Interfaces/IDiskCache.hpp"
 #include "valdi_core/cpp/Schema/ValueSchema.hpp"
-#include "valdi_core/cpp/Utils/JSONReader.hpp"
+#include "valdi_core/cpp/Utils/DiskUtils.hpp"
+#include "valdi_core/cpp/Utils/JSONTokenizer.hpp"
 #include "valdi_core/cpp/Utils/JSONWriter.hpp"
 #include "valdi_core/cpp/Utils/StringCache.hpp"
 #include "valdi_core/cpp/Utils/ValueTypedObject.hpp"
@@ -17,6 +19,10 @@
 #include "valdi_core/cpp/Utils/Format.hpp"
 #include "valdi_core/cpp/Utils/SmallVector.hpp"
 
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <unistd.h>
 #include <utility>
 
 namespace Valdi {
@@ -215,14 +221,14 @@ bool JavaScriptHeapDumpFieldsIndexes::resolveEdgeTypeByIndex(const ValueArray* e
 JavaScriptHeapDumpParser::JavaScriptHeapDumpParser(const Byte* data,
                                                    size_t length,
                                                    ExceptionTracker& exceptionTracker) {
-    JSONReader reader(std::string_view(reinterpret_cast<const char*>(data), length));
+    JSONTokenizer tokenizer(std::string_view(reinterpret_cast<const char*>(data), length));
 
-    parseHeapDump(reader);
+    parseHeapDump(tokenizer);
 
-    if (reader.hasError()) {
+    if (tokenizer.hasError()) {
         _nodes.clear();
         _edges.clear();
-        exceptionTracker.onError(reader.getError());
+        exceptionTracker.onError(tokenizer.getError());
         return;
     }
 }
@@ -245,105 +251,108 @@ bool JavaScriptHeapDumpParser::parseSnapshot(const Value& snapshot, int32_t& nod
     return _fieldsIndexes.populate(nodeFields, nodeTypes, edgeFields, edgeTypes);
 }
 
-void JavaScriptHeapDumpParser::parseHeapDump(JSONReader& reader) {
-    if (!reader.parseBeginObject()) {
+static bool parseToken(JSONTokenizer& tokenizer, JSONTokenizer::TokenType type, std::string_view errorMessage) {
+    if (tokenizer.next().type != type) {
+        tokenizer.setErrorAtCurrentPosition(errorMessage);
+        return false;
+    }
+    return true;
+}
+
+void JavaScriptHeapDumpParser::parseHeapDump(JSONTokenizer& tokenizer) {
+    if (!parseToken(tokenizer, JSONTokenizer::TokenType::BeginObject, "Expected '{'")) {
         return;
     }
 
-    bool isFirst = true;
-    std::string key;
     int32_t nodeCount = 0;
     int32_t edgeCount = 0;
 
-    while (!reader.tryParseEndObject()) {
-        if (reader.hasError()) {
+    auto token = tokenizer.next();
+    while (token.type != JSONTokenizer::TokenType::EndObject) {
+        if (token.type != JSONTokenizer::TokenType::String) {
+            tokenizer.setErrorAtCurrentPosition("Expected object key");
             return;
         }
 
-        if (isFirst) {
-            isFirst = false;
-        } else if (!reader.parseComma()) {
-            return;
-        }
+        // The key is only valid until the next token
+        auto key = token.value;
+        auto isSnapshot = key == "snapshot";
+        auto isNodes = key == "nodes";
+        auto isEdges = key == "edges";
+        auto isStrings = key == "strings";
 
-        key.clear();
-        if (!reader.parseString(key) || !reader.parseColon()) {
+        if (!parseToken(tokenizer, JSONTokenizer::TokenType::Colon, "Expected ':'")) {
             return;
         }
 
-        if (key == "snapshot") {
-            auto snapshotJSON = readValueFromJSONReader(reader);
-            if (reader.hasError()) {
+        if (isSnapshot) {
+            auto snapshotJSON = readValueFromJSONTokenizer(tokenizer);
+            if (tokenizer.hasError()) {
                 return;
             }
             if (!parseSnapshot(snapshotJSON, nodeCount, edgeCount)) {
-                reader.setErrorAtCurrentPosition("Failed to parse snapshot");
-                return;
-            }
-        } else if (key == "nodes") {
-            parseNodes(reader, nodeCount);
-            if (reader.hasError()) {
-                return;
-            }
-        } else if (key == "edges") {
-            parseEdges(reader, edgeCount);
-            if (reader.hasError()) {
-                return;
-            }
-        } else if (key == "strings") {
-            parseStrings(reader);
-            if (reader.hasError()) {
+                tokenizer.setErrorAtCurrentPosition("Failed to parse snapshot");
                 return;
             }
+        } else if (isNodes) {
+            parseNodes(tokenizer, nodeCount);
+        } else if (isEdges) {
+            parseEdges(tokenizer, edgeCount);
+        } else if (isStrings) {
+            parseStrings(tokenizer);
         } else {
-            // Unknown key, just consume the JSONReader
-            readValueFromJSONReader(reader);
-            if (reader.hasError()) {
-                return;
-            }
+            // Unknown key, just consume the value
+            readValueFromJSONTokenizer(tokenizer);
+        }
+
+        if (tokenizer.hasError()) {
+            return;
+        }
+
+        token = tokenizer.next();
+        if (token.type == JSONTokenizer::TokenType::Comma) {
+            token = tokenizer.next();
+        } else if (token.type != JSONTokenizer::TokenType::EndObject) {
+            tokenizer.setErrorAtCurrentPosition("Expected ',' or '}'");
+            return;
         }
     }
 
-    if (!reader.ensureIsAtEnd()) {
+    if (!parseToken(tokenizer, JSONTokenizer::TokenType::End, "Expected end of input")) {
         return;
     }
 
-    validateDump(reader);
+    validateDump(tokenizer);
 }
 
-static bool parseComponents(JSONReader& reader, std::vector<uint32_t>& output, size_t length) {
-    output.resize(length);
-    auto* outputBegin = output.data();
-    auto* outputEnd = outputBegin + length;
-    auto* outputIt = outputBegin;
-
-    while (outputIt != outputEnd) {
-        if (outputIt != outputBegin && !reader.parseComma()) {
-            return false;
-        }
+static bool parseComponents(JSONTokenizer& tokenizer, std::vector<uint32_t>& output, size_t length) {
+    if (!parseToken(tokenizer, JSONTokenizer::TokenType::BeginArray, "Expected '['")) {
+        return false;
+    }
 
-        if (!reader.parseUInt(*outputIt)) {
-            return false;
-        }
+    output.reserve(length);
+    if (!tokenizer.parseUIntArray(output)) {
+        return false;
+    }
 
-        outputIt++;
+    if (output.size() != length) {
+        tokenizer.setErrorAtCurrentPosition(
+            STRING_FORMAT("Expected {} components, found {}", length, output.size()).toStringView());
+        return false;
     }
 
     return true;
 }
 
-void JavaScriptHeapDumpParser::parseNodes(JSONReader& reader, int32_t nodeCount) {
-    if (!reader.parseBeginArray()) {
-        return;
-    }
-
+void JavaScriptHeapDumpParser::parseNodes(JSONTokenizer& tokenizer, int32_t nodeCount) {
     auto fieldsCountPerNode = _fieldsIndexes.fieldsCountPerNode;
     std::vector<uint32_t> components;
-    if (!parseComponents(reader, components, fieldsCountPerNode * nodeCount)) {
+    if (!parseComponents(tokenizer, components, fieldsCountPerNode * nodeCount)) {
         return;
     }
 
     auto* componentsPtr = components.data();
+    _nodes.reserve(static_cast<size_t>(nodeCount));
 
     size_t edgesStart = 0;
     auto nodeTypeMaxSize = static_cast<uint32_t>(_fieldsIndexes.nodeTypeByIndex.size());
@@ -356,7 +365,7 @@ void JavaScriptHeapDumpParser::parseNodes(JSONReader& reader, int32_t nodeCount)
         auto edgesCount = componentsPtr[_fieldsIndexes.nodes.edgeCount];
 
         if (typeIndex >= nodeTypeMaxSize) {
-            reader.setErrorAtCurrentPosition("Out of bounds edgeType");
+            tokenizer.setErrorAtCurrentPosition("Out of bounds edgeType");
             return;
         }
 
@@ -366,21 +375,16 @@ void JavaScriptHeapDumpParser::parseNodes(JSONReader& reader, int32_t nodeCount)
         edgesStart += edgesCount;
         componentsPtr += fieldsCountPerNode;
     }
-
-    reader.parseEndArray();
 }
 
-void JavaScriptHeapDumpParser::parseEdges(JSONReader& reader, int32_t edgeCount) {
-    if (!reader.parseBeginArray()) {
-        return;
-    }
-
+void JavaScriptHeapDumpParser::parseEdges(JSONTokenizer& tokenizer, int32_t edgeCount) {
     auto fieldsCountPerEdge = _fieldsIndexes.fieldsCountPerEdge;
     std::vector<uint32_t> components;
-    if (!parseComponents(reader, components, fieldsCountPerEdge * edgeCount)) {
+    if (!parseComponents(tokenizer, components, fieldsCountPerEdge * edgeCount)) {
         return;
     }
     auto* componentsPtr = components.data();
+    _edges.reserve(static_cast<size_t>(edgeCount));
     auto edgeTypeMaxSize = static_cast<uint32_t>(_fieldsIndexes.edgeTypeByIndex.size());
 
     for (int32_t i = 0; i < edgeCount; i++) {
@@ -389,7 +393,7 @@ void JavaScriptHeapDumpParser::parseEdges(JSONReader& reader, int32_t edgeCount)
         auto edgeToNode = componentsPtr[_fieldsIndexes.edges.toNode];
 
         if (edgeTypeIndex >= edgeTypeMaxSize) {
-            reader.setErrorAtCurrentPosition("Out of bounds edgeType");
+            tokenizer.setErrorAtCurrentPosition("Out of bounds edgeType");
             return;
         }
 
@@ -400,59 +404,62 @@ void JavaScriptHeapDumpParser::parseEdges(JSONReader& reader, int32_t edgeCount)
 
         componentsPtr += fieldsCountPerEdge;
     }
-
-    reader.parseEndArray();
 }
 
-void JavaScriptHeapDumpParser::parseStrings(JSONReader& reader) {
-    if (!reader.parseBeginArray()) {
+void JavaScriptHeapDumpParser::parseStrings(JSONTokenizer& tokenizer) {
+    if (!parseToken(tokenizer, JSONTokenizer::TokenType::BeginArray, "Expected '['")) {
         return;
     }
 
-    std::string str;
+    auto token = tokenizer.next();
+    if (token.type == JSONTokenizer::TokenType::EndArray) {
+        return;
+    }
 
-    auto first = true;
-    while (!reader.tryParseEndArray()) {
-        if (first) {
-            first = false;
-        } else {
-            if (!reader.parseComma()) {
-                return;
-            }
+    for (;;) {
+        if (token.type != JSONTokenizer::TokenType::String) {
+            tokenizer.setErrorAtCurrentPosition("Expected string");
+            return;
         }
 
-        str.clear();
-        if (!reader.parseString(str)) {
+        // Strings without escapes are views into the heap dump, they are not copied before being interned
+        _strings.emplace_back(StringCache::getGlobal().makeString(token.value));
+
+        token = tokenizer.next();
+        if (token.type == JSONTokenizer::TokenType::EndArray) {
             return;
         }
-
-        _strings.emplace_back(StringCache::getGlobal().makeString(str));
+        if (token.type != JSONTokenizer::TokenType::Comma) {
+            tokenizer.setErrorAtCurrentPosition("Expected ',' or ']'");
+            return;
+        }
+        token = tokenizer.next();
     }
 }
 
-void JavaScriptHeapDumpParser::validateDump(JSONReader& reader) {
+void JavaScriptHeapDumpParser::validateDump(JSONTokenizer& tokenizer) {
     auto stringsSize = static_cast<uint32_t>(_strings.size());
     auto edgesSize = static_cast<uint32_t>(_edges.size());
     auto nodesSize = static_cast<uint32_t>(_nodes.size());
 
     for (const auto& node : _nodes) {
         if (node._nameIndex >= stringsSize) {
-            reader.setErrorAtCurrentPosition("Out of bounds name");
+            tokenizer.setErrorAtCurrentPosition("Out of bounds name");
             return;
         }
         if (node._edgesStart + node._edgesCount > edgesSize) {
-            reader.setErrorAtCurrentPosition("Out of bounds edges");
+            tokenizer.setErrorAtCurrentPosition("Out of bounds edges");
             return;
         }
     }
 
     for (const auto& edge : _edges) {
         if (edge._type != JavaScriptHeapDumpEdgeType::ELEMENT && edge._nameOrIndex >= stringsSize) {
-            reader.setErrorAtCurrentPosition("Out of bounds name");
+            tokenizer.setErrorAtCurrentPosition("Out of bounds name");
             return;
         }
         if (edge._nodeIndex >= nodesSize) {
-            reader.setErrorAtCurrentPosition("Out of bounds node");
+            tokenizer.setErrorAtCurrentPosition("Out of bounds node");
             return;
         }
     }
@@ -518,8 +525,187 @@ std::span<const JavaScriptHeapDumpParser::Edge> JavaScriptHeapDumpParser::Node::
 }
 
 static constexpr size_t kElementsPerNode = 7;
+// Number of nodes or edges kept in memory before they are flushed into the spill files
+static constexpr size_t kSpillRecordsCount = 16384;
+// Size after which the serialized heap dump is flushed into its destination
+static constexpr size_t kOutputFlushThreshold = 256 * 1024;
+
+/**
+ Unlinked temporary file holding fixed size records which were flushed out of memory.
+ */
+class JavaScriptHeapDumpSpillFile {
+public:
+    explicit JavaScriptHeapDumpSpillFile(int fd) : _fd(fd) {}
+
+    ~JavaScriptHeapDumpSpillFile() {
+        ::close(_fd);
+    }
+
+    static Result<std::unique_ptr<JavaScriptHeapDumpSpillFile>> open(const Path& directory) {
+        if (!DiskUtils::isDirectory(directory) && !DiskUtils::makeDirectory(directory, true)) {
+            return Error(STRING_FORMAT("Unable to create spill directory {}", directory.toString()));
+        }
+
+        auto pathTemplate = directory.appending(".heapdump.XXXXXX").toString();
+        auto fd = ::mkstemp(pathTemplate.data());
+        if (fd < 0) {
+            return Error(STRING_FORMAT("Unable to create spill file in {}: {}", directory.toString(), strerror(errno)));
+        }
+        // The file is reclaimed as soon as it is closed
+        ::unlink(pathTemplate.c_str());
+
+        return std::make_unique<JavaScriptHeapDumpSpillFile>(fd);
+    }
+
+    template<typename T>
+    Result<Void> append(const std::vector<T>& records) {
+        const auto* data = reinterpret_cast<const char*>(records.data());
+        auto length = records.size() * sizeof(T);
+
+        while (length > 0) {
+            auto result = ::write(_fd, data, length);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return Error(STRING_FORMAT("Unable to write spill file: {}", strerror(errno)));
+            }
+            data += result;
+            length -= static_cast<size_t>(result);
+        }
+
+        return Void();
+    }
+
+    template<typename T>
+    Result<Void> read(size_t recordsOffset, size_t recordsCount, std::vector<T>& output) const {
+        output.resize(recordsCount);
+        auto* data = reinterpret_cast<char*>(output.data());
+        auto offset = recordsOffset * sizeof(T);
+        auto length = recordsCount * sizeof(T);
+
+        while (length > 0) {
+            auto result = ::pread(_fd, data, length, static_cast<off_t>(offset));
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return Error(STRING_FORMAT("Unable to read spill file: {}", strerror(errno)));
+            }
+            if (result == 0) {
+                return Error("Unexpectedly reached end of spill file");
+            }
+            data += result;
+            offset += static_cast<size_t>(result);
+            length -= static_cast<size_t>(result);
+        }
+
+        return Void();
+    }
+
+private:
+    int _fd;
+};
+
+/**
+ Buffers the serialized heap dump, and flushes it into its destination
+ whenever the buffer grows beyond a threshold.
+ */
+class JavaScriptHeapDumpOutputStream {
+public:
+    using FlushFunction = std::function<Result<Void>(const BytesView&)>;
+
+    JavaScriptHeapDumpOutputStream(ByteBuffer& buffer, size_t flushThreshold, FlushFunction flushFunction)
+        : _buffer(buffer), _flushThreshold(flushThreshold), _flushFunction(std::move(flushFunction)) {}
+
+    ByteBuffer& getBuffer() {
+        return _buffer;
+    }
+
+    Result<Void> flushIfNeeded() {
+        if (_buffer.size() < _flushThreshold) {
+            return Void();
+        }
+        return flush();
+    }
+
+    Result<Void> flush() {
+        if (!_flushFunction || _buffer.size() == 0) {
+            return Void();
+        }
+
+        auto result = _flushFunction(BytesView(nullptr, _buffer.data(), _buffer.size()));
+        _buffer.clear();
+        return result;
+    }
+
+private:
+    ByteBuffer& _buffer;
+    size_t _flushThreshold;
+    FlushFunction _flushFunction;
+};
+
+/**
+ Call the given function for every record, starting with the records held in the spill file,
+ followed by the records which are still in memory. The records are read back from the spill file
+ in batches, so that only a bounded amount of them are in memory at once.
+ */
+template<typename T, typename F>
+static Result<Void> forEachRecord(const JavaScriptHeapDumpSpillFile* spillFile,
+                                  size_t flushedRecordsCount,
+                                  const std::vector<T>& records,
+                                  F&& fn) {
+    if (spillFile != nullptr && flushedRecordsCount > 0) {
+        std::vector<T> batch;
+        size_t recordsOffset = 0;
+        while (recordsOffset < flushedRecordsCount) {
+            auto batchSize = std::min(kSpillRecordsCount, flushedRecordsCount - recordsOffset);
+            auto result = spillFile->read(recordsOffset, batchSize, batch);
+            if (!result) {
+                return result;
+            }
+
+            for (const auto& record : batch) {
+                auto fnResult = fn(record);
+                if (!fnResult) {
+                    return fnResult;
+                }
+            }
+
+            recordsOffset += batchSize;
+        }
+    }
+
+    for (const auto& record : records) {
+        auto fnResult = fn(record);
+        if (!fnResult) {
+            return fnResult;
+        }
+    }
+
+    return Void();
+}
 
 JavaScriptHeapDumpBuilder::JavaScriptHeapDumpBuilder() = default;
+
+JavaScriptHeapDumpBuilder::JavaScriptHeapDumpBuilder(const Path& spillDirectory) {
+    auto nodesSpillFile = JavaScriptHeapDumpSpillFile::open(spillDirectory);
+    if (!nodesSpillFile) {
+        _spillError = nodesSpillFile.moveError();
+        return;
+    }
+    auto edgesSpillFile = JavaScriptHeapDumpSpillFile::open(spillDirectory);
+    if (!edgesSpillFile) {
+        _spillError = edgesSpillFile.moveError();
+        return;
+    }
+
+    _nodesSpillFile = nodesSpillFile.moveValue();
+    _edgesSpillFile = edgesSpillFile.moveValue();
+    _nodes.reserve(kSpillRecordsCount);
+    _edges.reserve(kSpillRecordsCount);
+}
+
 JavaScriptHeapDumpBuilder::~JavaScriptHeapDumpBuilder() = default;
 
 static void writeSnapshot(size_t nodeCount, size_t edgeCount, JSONWriter& writer) {
@@ -589,76 +775,176 @@ static void writeSnapshot(size_t nodeCount, size_t edgeCount, JSONWriter& writer
 }
 
 BytesView JavaScriptHeapDumpBuilder::build() {
-    SC_ASSERT(_nodes.size() == _nodeById.size());
-
     auto output = makeShared<ByteBuffer>();
-    JSONWriter writer(*output);
+    JavaScriptHeapDumpOutputStream outputStream(*output, 0, nullptr);
+
+    auto result = writeTo(outputStream);
+    if (!result) {
+        return BytesView();
+    }
+
+    return output->toBytesView();
+}
+
+Result<Void> JavaScriptHeapDumpBuilder::write(int fd) {
+    ByteBuffer buffer;
+    buffer.reserve(kOutputFlushThreshold + kOutputFlushThreshold / 4);
+
+    JavaScriptHeapDumpOutputStream outputStream(
+        buffer, kOutputFlushThreshold, [fd](const BytesView& bytes) -> Result<Void> {
+            const auto* data = bytes.data();
+            auto length = bytes.size();
+
+            while (length > 0) {
+                auto result = ::write(fd, data, length);
+                if (result < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return Error(STRING_FORMAT("Unable to write heap dump: {}", strerror(errno)));
+                }
+                data += result;
+                length -= static_cast<size_t>(result);
+            }
+
+            return Void();
+        });
+
+    return writeTo(outputStream);
+}
+
+Result<Void> JavaScriptHeapDumpBuilder::write(IDiskCache& diskCache, const Path& path) {
+    // The heap dump is appended in chunks, a previous item would end up in front of it
+    if (diskCache.exists(path) && !diskCache.remove(path)) {
+        return Error(STRING_FORMAT("Unable to remove previous heap dump at {}", path.toString()));
+    }
+
+    ByteBuffer buffer;
+    buffer.reserve(kOutputFlushThreshold + kOutputFlushThreshold / 4);
+
+    JavaScriptHeapDumpOutputStream outputStream(
+        buffer, kOutputFlushThreshold, [&](const BytesView& bytes) { return diskCache.append(path, bytes); });
+
+    return writeTo(outputStream);
+}
+
+Result<Void> JavaScriptHeapDumpBuilder::writeTo(JavaScriptHeapDumpOutputStream& output) {
+    if (_spillError) {
+        return _spillError.value();
+    }
+
+    SC_ASSERT(getNodesCount() == _nodeById.size());
+
+    JSONWriter writer(output.getBuffer());
 
     writer.writeBeginObject();
 
     writer.writeProperty("snapshot");
-    writeSnapshot(_nodes.size(), _edges.size(), writer);
+    writeSnapshot(getNodesCount(), getEdgesCount(), writer);
     writer.writeComma();
     writer.writeNewLine();
 
     writer.writeProperty("nodes");
-    writer.writeArray(_nodes, [&](const JavaScriptHeapDumpBuilder::Node& node) {
-        /**
-         0    type    The type of node. See Node types, below.
-         1    name    The name of the node. This is a number that's the index in the top-level strings array. To find
-         the actual name, use the index number to look up the string in the top-level strings array.
-         2    id    The node's unique ID.
-         3    self_size    The node's size in bytes.
-         4    edge_count    The number of edges connected to this node.
-         5    trace_node_id    The ID of the trace node
-         6    detachedness    Whether this node can be reached from the window global object. 0 means the node is not
-         detached; the node can be reached from the window global object. 1 means the node is detached; the node can't
-         be reached from the window global object.
-         */
-        writer.writeInt(node.type);
-        writer.writeComma();
-        writer.writeInt(node.name);
-        writer.writeComma();
-        writer.writeInt(node.id);
-        writer.writeComma();
-        writer.writeInt(node.selfSize);
-        writer.writeComma();
-        writer.writeInt(node.edgeCount);
-        writer.writeComma();
-        writer.writeInt(static_cast<int32_t>(0));
-        writer.writeComma();
-        writer.writeInt(static_cast<int32_t>(0));
-    });
+    writer.writeBeginArray();
+    auto isFirst = true;
+    auto result = forEachRecord(
+        _nodesSpillFile.get(), _flushedNodesCount, _nodes, [&](const JavaScriptHeapDumpBuilder::Node& node) {
+            if (isFirst) {
+                isFirst = false;
+            } else {
+                writer.writeComma();
+            }
+            /**
+             0    type    The type of node. See Node types, below.
+             1    name    The name of the node. This is a number that's the index in the top-level strings array. To
+             find the actual name, use the index number to look up the string in the top-level strings array.
+             2    id    The node's unique ID.
+             3    self_size    The node's size in bytes.
+             4    edge_count    The number of edges connected to this node.
+             5    trace_node_id    The ID of the trace node
+             6    detachedness    Whether this node can be reached from the window global object. 0 means the node is
+             not detached; the node can be reached from the window global object. 1 means the node is detached; the
+             node can't be reached from the window global object.
+             */
+            writer.writeInt(node.type);
+            writer.writeComma();
+            writer.writeInt(node.name);
+            writer.writeComma();
+            writer.writeInt(node.id);
+            writer.writeComma();
+            writer.writeInt(node.selfSize);
+            writer.writeComma();
+            writer.writeInt(node.edgeCount);
+            writer.writeComma();
+            writer.writeInt(static_cast<int32_t>(0));
+            writer.writeComma();
+            writer.writeInt(static_cast<int32_t>(0));
+
+            return output.flushIfNeeded();
+        });
+    if (!result) {
+        return result;
+    }
+    writer.writeEndArray();
     writer.writeComma();
     writer.writeNewLine();
 
     writer.writeProperty("edges");
-    writer.writeArray(_edges, [&](const JavaScriptHeapDumpBuilder::Edge& edge) {
-        /**
-         0    type    The type of edge. See Edge types to find out what are the possible types.
-         1    name_or_index    This can be a number or a string. If it's a number, it corresponds to the index in the
-         top-level strings array, where the name of the edge can be found. 2    to_node    The index within the nodes
-         array that this edge is connected to.
-         */
-        const auto& indexedNode = _nodeById[edge.nodeId - 1];
-        // We should have visited the node and resolved its index
-        SC_ASSERT(indexedNode.nodeIndex.has_value());
-
-        writer.writeInt(edge.type);
-        writer.writeComma();
-        writer.writeInt(edge.nameOrIndex);
-        writer.writeComma();
-        writer.writeInt(static_cast<int32_t>(indexedNode.nodeIndex.value() * kElementsPerNode));
-    });
+    writer.writeBeginArray();
+    isFirst = true;
+    result = forEachRecord(
+        _edgesSpillFile.get(), _flushedEdgesCount, _edges, [&](const JavaScriptHeapDumpBuilder::Edge& edge) {
+            if (isFirst) {
+                isFirst = false;
+            } else {
+                writer.writeComma();
+            }
+            /**
+             0    type    The type of edge. See Edge types to find out what are the possible types.
+             1    name_or_index    This can be a number or a string. If it's a number, it corresponds to the index in
+             the top-level strings array, where the name of the edge can be found. 2    to_node    The index within
+             the nodes array that this edge is connected to.
+             */
+            const auto& indexedNode = _nodeById[edge.nodeId - 1];
+            // We should have visited the node and resolved its index
+            SC_ASSERT(indexedNode.nodeIndex.has_value());
+
+            writer.writeInt(edge.type);
+            writer.writeComma();
+            writer.writeInt(edge.nameOrIndex);
+            writer.writeComma();
+            writer.writeInt(static_cast<int32_t>(indexedNode.nodeIndex.value() * kElementsPerNode));
+
+            return output.flushIfNeeded();
+        });
+    if (!result) {
+        return result;
+    }
+    writer.writeEndArray();
     writer.writeComma();
     writer.writeNewLine();
 
     writer.writeProperty("strings");
-    writer.writeArray(_stringTable, [&](const StringBox& str) { writer.writeString(str.toStringView()); });
+    writer.writeBeginArray();
+    isFirst = true;
+    for (const auto& str : _stringTable) {
+        if (isFirst) {
+            isFirst = false;
+        } else {
+            writer.writeComma();
+        }
+        writer.writeString(str.toStringView());
+
+        result = output.flushIfNeeded();
+        if (!result) {
+            return result;
+        }
+    }
+    writer.writeEndArray();
 
     writer.writeEndObject();
 
-    return output->toBytesView();
+    return output.flush();
 }
 
 void JavaScriptHeapDumpBuilder::appendDump(const Byte* data, size_t length, ExceptionTracker& exceptionTracker) {
@@ -692,20 +978,16 @@ void JavaScriptHeapDumpBuilder::beginNode(JavaScriptHeapDumpNodeType type,
                                           const StringBox& name,
                                           uint64_t nodeId,
                                           size_t selfSizeBytes) {
+    // The previous nodes are complete, they can be flushed
+    if (_nodes.size() >= kSpillRecordsCount) {
+        flushNodes();
+    }
+
     auto& referencedNode = getReferencedNode(nodeId);
     SC_ASSERT(!referencedNode.nodeIndex.has_value());
-    auto newNodeIndex = _nodes.size();
-    referencedNode.nodeIndex = {newNodeIndex};
 
-    auto& node = _nodes.emplace_back();
-
-    node.type = static_cast<int32_t>(type);
-    node.name = getStringTableIndex(name);
-    node.id = referencedNode.id;
-    node.selfSize = static_cast<int32_t>(selfSizeBytes);
-
-    _currentNode = &node;
-    _currentNodeIndex = newNodeIndex;
+    _currentNodeIndex = _nodes.size();
+    appendNode(referencedNode, type, name, selfSizeBytes);
 }
 
 void JavaScriptHeapDumpBuilder::appendEdge(JavaScriptHeapDumpEdgeType type,
@@ -717,16 +999,7 @@ void JavaScriptHeapDumpBuilder::appendEdge(JavaScriptHeapDumpEdgeType type,
 void JavaScriptHeapDumpBuilder::appendEdge(JavaScriptHeapDumpEdgeType type,
                                            const JavaScriptHeapEdgeIdentifier& identifier,
                                            uint64_t nodeId) {
-    auto& edge = _edges.emplace_back();
-    edge.type = static_cast<int32_t>(type);
-    edge.nodeId = getReferencedNode(nodeId).id;
-    _currentNode->edgeCount++;
-
-    if (identifier.isNamed()) {
-        edge.nameOrIndex = getStringTableIndex(identifier.getName());
-    } else {
-        edge.nameOrIndex = identifier.getIndex();
-    }
+    appendEdgeToReferencedNode(type, identifier, getReferencedNode(nodeId));
 }
 
 void JavaScriptHeapDumpBuilder::appendEdgeToValue(JavaScriptHeapDumpEdgeType type,
@@ -753,24 +1026,37 @@ void JavaScriptHeapDumpBuilder::appendEdgeToValue(JavaScriptHeapDumpEdgeType typ
     }
 
     if (!referencedNode->nodeIndex) {
-        referencedNode->nodeIndex = {_nodes.size()};
-
         auto internedName = StringCache::getGlobal().makeString(std::string_view(stringValue));
+        appendNode(*referencedNode, nodeType, internedName, valueSelfSizeBytes);
+    }
+
+    appendEdgeToReferencedNode(type, identifier, *referencedNode);
+}
+
+void JavaScriptHeapDumpBuilder::appendNode(ReferencedNode& referencedNode,
+                                           JavaScriptHeapDumpNodeType type,
+                                           const StringBox& name,
+                                           size_t selfSizeBytes) {
+    referencedNode.nodeIndex = {static_cast<uint32_t>(getNodesCount())};
 
-        auto& node = _nodes.emplace_back();
+    auto& node = _nodes.emplace_back();
 
-        node.type = static_cast<int32_t>(nodeType);
-        node.name = getStringTableIndex(internedName);
-        node.id = referencedNode->id;
-        node.selfSize = static_cast<int32_t>(valueSelfSizeBytes);
+    node.type = static_cast<int32_t>(type);
+    node.name = getStringTableIndex(name);
+    node.id = referencedNode.id;
+    node.selfSize = static_cast<int32_t>(selfSizeBytes);
+}
 
-        // Restore current node
-        _currentNode = &_nodes[_currentNodeIndex];
+void JavaScriptHeapDumpBuilder::appendEdgeToReferencedNode(JavaScriptHeapDumpEdgeType type,
+                                                           const JavaScriptHeapEdgeIdentifier& identifier,
+                                                           const ReferencedNode& referencedNode) {
+    if (_edges.size() >= kSpillRecordsCount) {
+        flushEdges();
     }
 
     auto& edge = _edges.emplace_back();
     edge.type = static_cast<int32_t>(type);
-    edge.nodeId = referencedNode->id;
+    edge.nodeId = referencedNode.id;
 
     if (identifier.isNamed()) {
         edge.nameOrIndex = getStringTableIndex(identifier.getName());
@@ -778,7 +1064,45 @@ void JavaScriptHeapDumpBuilder::appendEdgeToValue(JavaScriptHeapDumpEdgeType typ
         edge.nameOrIndex = identifier.getIndex();
     }
 
-    _currentNode->edgeCount++;
+    _nodes[_currentNodeIndex].edgeCount++;
+}
+
+void JavaScriptHeapDumpBuilder::flushNodes() {
+    if (_nodesSpillFile == nullptr || _spillError) {
+        return;
+    }
+
+    auto result = _nodesSpillFile->append(_nodes);
+    if (!result) {
+        _spillError = result.moveError();
+        return;
+    }
+
+    _flushedNodesCount += _nodes.size();
+    _nodes.clear();
+}
+
+void JavaScriptHeapDumpBuilder::flushEdges() {
+    if (_edgesSpillFile == nullptr || _spillError) {
+        return;
+    }
+
+    auto result = _edgesSpillFile->append(_edges);
+    if (!result) {
+        _spillError = result.moveError();
+        return;
+    }
+
+    _flushedEdgesCount += _edges.size();
+    _edges.clear();
+}
+
+size_t JavaScriptHeapDumpBuilder::getNodesCount() const {
+    return _flushedNodesCount + _nodes.size();
+}
+
+size_t JavaScriptHeapDumpBuilder::getEdgesCount() const {
+    return _flushedEdgesCount + _edges.size();
 }
 
 JavaScriptHeapDumpBuilder::ReferencedNode& JavaScriptHeapDumpBuilder::getReferencedNode(uint64_t nodeId) {
@@ -10,6 +10,8 @@
 #include "valdi_core/cpp/Utils/Bytes.hpp"
 #include "valdi_core/cpp/Utils/ExceptionTracker.hpp"
 #include "valdi_core/cpp/Utils/FlatMap.hpp"
+#include "valdi_core/cpp/Utils/PathUtils.hpp"
+#include "valdi_core/cpp/Utils/Result.hpp"
 #include "valdi_core/cpp/Utils/SmallVector.hpp"
 #include "valdi_core/cpp/Utils/StaticString.hpp"
 #include "valdi_core/cpp/Utils/StringBox.hpp"
@@ -17,12 +19,17 @@
 #include "valdi_core/cpp/Utils/ValueArrayBuilder.hpp"
 
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <span>
 #include <vector>
 
 namespace Valdi {
 
-class JSONReader;
+class IDiskCache;
+class JSONTokenizer;
+class JavaScriptHeapDumpOutputStream;
+class JavaScriptHeapDumpSpillFile;
 
 /**
  The first number in the group of numbers for a node in the nodes array corresponds to its type.
@@ -134,6 +141,15 @@ private:
 class JavaScriptHeapDumpBuilder {
 public:
     JavaScriptHeapDumpBuilder();
+
+    /**
+     Create a builder which streams the nodes and edges into temporary files created within the given
+     directory as they are appended, instead of keeping all of them in memory. Only the string table and
+     the mapping between node ids and node indexes remain in memory. Combined with write(), this allows
+     producing heap dumps of large heaps without holding the whole heap dump in memory.
+     */
+    explicit JavaScriptHeapDumpBuilder(const Path& spillDirectory);
+
     ~JavaScriptHeapDumpBuilder();
 
     /**
@@ -185,8 +201,25 @@ public:
      */
     void appendDump(const Byte* data, size_t length, ExceptionTracker& exceptionTracker);
 
+    /**
+     Build the heap dump in memory. Returns an empty BytesView if the nodes or edges could not be
+     written to or read back from the spill files.
+     */
     BytesView build();
 
+    /**
+     Write the heap dump into the given file descriptor. The heap dump is serialized incrementally,
+     so that only a bounded amount of it is buffered in memory at any given time.
+     */
+    Result<Void> write(int fd);
+
+    /**
+     Write the heap dump into the item at the given path of the disk cache, replacing the item if it exists.
+     The heap dump is serialized incrementally through IDiskCache::append(), so that only a bounded amount
+     of it is buffered in memory at any given time. It should be read back using IDiskCache::loadAppended().
+     */
+    Result<Void> write(IDiskCache& diskCache, const Path& path);
+
 private:
     /**
      Represents a Node that has been visited through the beginNode() method.
@@ -237,25 +270,48 @@ private:
      */
     struct ReferencedNode {
         int32_t id;
-        // The index inside the _nodes array.
+        // The index of the node within all the nodes of the heap dump.
         // Will be populated as we go through the nodes
-        std::optional<size_t> nodeIndex;
+        std::optional<uint32_t> nodeIndex;
     };
 
+    // Nodes and edges which were not yet flushed into the spill files.
+    // When spilling is disabled, they hold all the nodes and edges.
     std::vector<Node> _nodes;
     std::vector<Edge> _edges;
+    size_t _flushedNodesCount = 0;
+    size_t _flushedEdgesCount = 0;
+    std::unique_ptr<JavaScriptHeapDumpSpillFile> _nodesSpillFile;
+    std::unique_ptr<JavaScriptHeapDumpSpillFile> _edgesSpillFile;
+    std::optional<Error> _spillError;
+
     std::vector<ReferencedNode> _nodeById;
     FlatMap<uint64_t, size_t> _nodePtrToIndex;
     std::vector<StringBox> _stringTable;
     FlatMap<StringBox, int32_t> _stringToStringTableIndex;
+    // Index of the current node within _nodes
     size_t _currentNodeIndex = 0;
     size_t _appendDumpIndex = 0;
 
-    Node* _currentNode = nullptr;
-
     ReferencedNode& getReferencedNode(uint64_t nodeId);
     ReferencedNode& appendReferencedNode();
 
+    void appendNode(ReferencedNode& referencedNode,
+                    JavaScriptHeapDumpNodeType type,
+                    const StringBox& name,
+                    size_t selfSizeBytes);
+    void appendEdgeToReferencedNode(JavaScriptHeapDumpEdgeType type,
+                                    const JavaScriptHeapEdgeIdentifier& identifier,
+                                    const ReferencedNode& referencedNode);
+
+    void flushNodes();
+    void flushEdges();
+
+    size_t getNodesCount() const;
+    size_t getEdgesCount() const;
+
+    Result<Void> writeTo(JavaScriptHeapDumpOutputStream& output);
+
     int32_t getStringTableIndex(const StringBox& str);
 };
 
@@ -374,12 +430,12 @@ private:
     friend JavaScriptHeapDumpParser::Node;
     friend JavaScriptHeapDumpParser::Edge;
 
-    void parseHeapDump(JSONReader& reader);
+    void parseHeapDump(JSONTokenizer& tokenizer);
     bool parseSnapshot(const Value& snapshot, int32_t& nodeCount, int32_t& edgeCount);
-    void parseNodes(JSONReader& reader, int32_t nodeCount);
-    void parseEdges(JSONReader& reader, int32_t edgeCount);
-    void parseStrings(JSONReader& reader);
-    void validateDump(JSONReader& reader);
+    void parseNodes(JSONTokenizer& tokenizer, int32_t nodeCount);
+    void parseEdges(JSONTokenizer& tokenizer, int32_t edgeCount);
+    void parseStrings(JSONTokenizer& tokenizer);
+    void validateDump(JSONTokenizer& tokenizer);
 };
 
 } // namespace Valdi
@@ -33,6 +33,7 @@
 #include "valdi_core/cpp/Constants.hpp"
 #include "valdi_core/cpp/Resources/LoadedAsset.hpp"
 #include "valdi_core/cpp/Resources/ResourceId.hpp"
+#include "valdi_core/cpp/Utils/ChromeTraceWriter.hpp"
 #include "valdi_core/cpp/Utils/ConsoleLogger.hpp"
 #include "valdi_core/cpp/Utils/LoggerUtils.hpp"
 #include "valdi_core/cpp/Utils/Marshaller.hpp"
@@ -51,6 +52,7 @@
 #include "valdi/runtime/JavaScript/Modules/JavaScriptModuleFactory.hpp"
 
 #include "valdi/runtime/Interfaces/IDiskCache.hpp"
+#include "valdi/runtime/JavaScript/JavaScriptBytecodeCache.hpp"
 
 #include "valdi/runtime/Resources/AssetCatalog.hpp"
 #include "valdi/runtime/Resources/AssetResolver.hpp"
@@ -476,6 +478,11 @@ Result<Void> JavaScriptRuntime::initializeContext() {
     JSExceptionTracker exceptionTracker(*jsContext);
     jsContext->initialize(config, exceptionTracker);
 
+    if (exceptionTracker && _diskCache != nullptr && !_enableDebugger) {
+        jsContext->setBytecodeDiskCache(
+            _diskCache, _bytecodeCacheQueue, JavaScriptBytecodeCache::kDefaultMaxSizeBytes, *_logger);
+    }
+
     if (exceptionTracker) {
         jsContext->startDebugger(_isWorker);
 
@@ -494,6 +501,16 @@ Result<Void> JavaScriptRuntime::initializeContext() {
     }
 }
 
+void JavaScriptRuntime::setBytecodeDiskCache(const Ref<IDiskCache>& diskCache,
+                                             const Ref<DispatchQueue>& dispatchQueue) {
+    _diskCache = diskCache;
+    _bytecodeCacheQueue = dispatchQueue;
+}
+
+void JavaScriptRuntime::setHeapDumpDiskCache(const Ref<IDiskCache>& diskCache) {
+    _heapDumpDiskCache = diskCache;
+}
+
 const Ref<DispatchQueue>& JavaScriptRuntime::getJsDispatchQueue() const {
     return _dispatchQueue;
 }
@@ -945,6 +962,21 @@ JSValueRef JavaScriptRuntime::runtimeStopTraceRecording(JSFunctionNativeCallCont
                           callContext.getExceptionTracker());
 }
 
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+JSValueRef JavaScriptRuntime::runtimeStopTraceRecordingAsChromeTrace(JSFunctionNativeCallContext& callContext) {
+    auto id = static_cast<size_t>(callContext.getParameterAsInt(0));
+    CHECK_CALL_CONTEXT(callContext);
+
+    auto traces = Tracer::shared().stopRecording(id);
+
+    ByteBuffer output;
+    ChromeTraceWriter writer(output);
+    writer.write(traces);
+    writer.finish();
+
+    return callContext.getContext().newStringUTF8(output.toStringView(), callContext.getExceptionTracker());
+}
+
 JSValueRef JavaScriptRuntime::runtimeSubmitDebugMessage(JSFunctionNativeCallContext& callContext) {
     auto debugLevel = static_cast<int32_t>(callContext.getParameterAsInt(0));
     CHECK_CALL_CONTEXT(callContext);
@@ -1292,6 +1324,8 @@ const char* moduleLoadModeToString(ModuleLoadMode moduleLoadMode) {
             return "js source";
         case ModuleLoadMode::JS_BYTECODE:
             return "js bytecode";
+        case ModuleLoadMode::JS_BYTECODE_CACHE:
+            return "js bytecode cache";
         case ModuleLoadMode::NATIVE:
             return "native";
     }
@@ -1431,6 +1465,10 @@ ModuleLoadResult JavaScriptRuntime::loadJsModuleFromBytes(IJavaScriptContext& js
             moduleLoadMode = ModuleLoadMode::JS_BYTECODE;
             evalResult =
                 jsContext.evaluatePreCompiled(preCompiledContent.value(), importPath.toStringView(), exceptionTracker);
+        } else if (auto cachedResult = loadJsModuleFromBytecodeCache(jsContext, jsModule, importPath, exceptionTracker);
+                   cachedResult) {
+            evalResult = std::move(cachedResult.value().first);
+            moduleLoadMode = cachedResult.value().second;
         } else {
             moduleLoadMode = ModuleLoadMode::JS_SOURCE;
             auto moduleSrc = jsModule.asStringView();
@@ -1447,6 +1485,44 @@ ModuleLoadResult JavaScriptRuntime::loadJsModuleFromBytes(IJavaScriptContext& js
     return std::make_pair(jsContext.callObjectAsFunction(evalResult.get(), callContext), moduleLoadMode);
 }
 
+std::optional<ModuleLoadResult> JavaScriptRuntime::loadJsModuleFromBytecodeCache(IJavaScriptContext& jsContext,
+                                                                                 const BytesView& jsModule,
+                                                                                 const StringBox& importPath,
+                                                                                 JSExceptionTracker& exceptionTracker) {
+    const auto& bytecodeCache = jsContext.getBytecodeCache();
+    if (bytecodeCache == nullptr) {
+        return std::nullopt;
+    }
+
+    auto key = bytecodeCache->makeKey(importPath, jsModule);
+    auto cachedModule = bytecodeCache->load(key);
+    if (cachedModule) {
+        auto preCompiledContent = getPreCompiledJsModuleData(cachedModule.value());
+        if (preCompiledContent) {
+            auto evalResult =
+                jsContext.evaluatePreCompiled(preCompiledContent.value(), importPath.toStringView(), exceptionTracker);
+            if (exceptionTracker) {
+                return std::make_pair(std::move(evalResult), ModuleLoadMode::JS_BYTECODE_CACHE);
+            }
+
+            VALDI_WARN(*_logger,
+                       "Failed to evaluate cached bytecode of JS module {}, falling back to source: {}",
+                       importPath,
+                       exceptionTracker.extractError());
+        }
+
+        // The entry is unusable, we load from source for this session and let the next one re-populate it.
+        bytecodeCache->remove(std::move(key));
+        return std::nullopt;
+    }
+
+    // The module is evaluated from source on the JS thread as usual, while a JS context
+    // owned by the bytecode cache queue compiles it so that the next session can use the bytecode.
+    bytecodeCache->compileAndStore(_javaScriptBridge, std::move(key), importPath, jsModule);
+
+    return std::nullopt;
+}
+
 ModuleLoadResult JavaScriptRuntime::loadJsModuleFromNative(IJavaScriptContext& jsContext,
                                                            const StringBox& importPath,
                                                            const JSValueRef* parameters,
@@ -2286,6 +2362,11 @@ void JavaScriptRuntime::buildContext(Valdi::IJavaScriptContext& context,
 
     JS_BIND(context, exceptionTracker, runtimeObject, "startTraceRecording", runtimeStartTraceRecording);
     JS_BIND(context, exceptionTracker, runtimeObject, "stopTraceRecording", runtimeStopTraceRecording);
+    JS_BIND(context,
+            exceptionTracker,
+            runtimeObject,
+            "stopTraceRecordingAsChromeTrace",
+            runtimeStopTraceRecordingAsChromeTrace);
 
     JS_BIND(context, exceptionTracker, runtimeObject, "scheduleWorkItem", runtimeScheduleWorkItem);
     JS_BIND(context, exceptionTracker, runtimeObject, "unscheduleWorkItem", runtimeUnscheduleWorkItem);
@@ -3755,8 +3836,19 @@ Result<BytesView> JavaScriptRuntime::dumpHeap() {
             std::vector<IJavaScriptContext*> jsContexts;
 
             lockAllJSContexts(jsContexts, [&]() {
-                result = _javaScriptBridge.dumpHeap(
-                    std::span<IJavaScriptContext*>(jsContexts.data(), jsContexts.size()), entry.exceptionTracker);
+                auto jsContextsSpan = std::span<IJavaScriptContext*>(jsContexts.data(), jsContexts.size());
+                if (_heapDumpDiskCache == nullptr) {
+                    result = _javaScriptBridge.dumpHeap(jsContextsSpan, entry.exceptionTracker);
+                    return;
+                }
+
+                static auto kHeapDumpPath = Path("heap.heapsnapshot");
+                _javaScriptBridge.dumpHeapToDiskCache(
+                    jsContextsSpan, *_heapDumpDiskCache, kHeapDumpPath, entry.exceptionTracker);
+                if (entry.exceptionTracker) {
+                    result = _heapDumpDiskCache->loadAppended(kHeapDumpPath);
+                }
+                _heapDumpDiskCache->remove(kHeapDumpPath);
             });
 
             if (!entry.exceptionTracker) {
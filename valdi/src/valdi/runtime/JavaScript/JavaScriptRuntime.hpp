@@ -137,6 +137,13 @@ enum class ModuleLoadMode {
      */
     JS_BYTECODE,
 
+    /**
+     * Module is loaded from JS bytecode that has been
+     * compiled from JS source on device and persisted
+     * in the bytecode cache
+     */
+    JS_BYTECODE_CACHE,
+
     /**
      * Module is loaded from TS that has been natively
      * compiled with TSN
@@ -191,6 +198,18 @@ public:
 
     void setThreadQoS(ThreadQoSClass threadQoS);
 
+    /**
+     Enable the persistent bytecode cache for the JS modules loaded from source.
+     Must be called before postInit().
+     */
+    void setBytecodeDiskCache(const Ref<IDiskCache>& diskCache, const Ref<DispatchQueue>& dispatchQueue);
+
+    /**
+     Set the disk cache into which heap dumps are streamed. When set, heap dumps are built
+     on disk and only loaded back once complete.
+     */
+    void setHeapDumpDiskCache(const Ref<IDiskCache>& diskCache);
+
     Ref<ContextHandler> getContextHandler() const;
 
     bool callComponentFunction(ContextId contextId,
@@ -343,7 +362,11 @@ private:
     JSValueRef _moduleLoader;
     JSPropertyNameIndex<6> _propertyNameIndex;
 
+    // Where compiled JS modules are persisted, if the bytecode cache is enabled
     Ref<IDiskCache> _diskCache;
+    Ref<DispatchQueue> _bytecodeCacheQueue;
+    // Where heap dumps are written before being returned, if set
+    Ref<IDiskCache> _heapDumpDiskCache;
     // List of JS modules which should be reloaded whenever they are unloaded
     FlatSet<ResourceId> _modulesToAutoReload;
     // List of JS modules which were unloaded and need to be reloaded
@@ -471,6 +494,7 @@ private:
     JSValueRef runtimeMakeTraceProxy(JSFunctionNativeCallContext& callContext);
     JSValueRef runtimeStartTraceRecording(JSFunctionNativeCallContext& callContext);
     JSValueRef runtimeStopTraceRecording(JSFunctionNativeCallContext& callContext);
+    JSValueRef runtimeStopTraceRecordingAsChromeTrace(JSFunctionNativeCallContext& callContext);
 
     JSValueRef runtimeScheduleWorkItem(JSFunctionNativeCallContext& callContext);
     JSValueRef runtimeUnscheduleWorkItem(JSFunctionNativeCallContext& callContext);
@@ -556,6 +580,11 @@ private:
                                            size_t parametersLength,
                                            JSExceptionTracker& exceptionTracker);
 
+    std::optional<ModuleLoadResult> loadJsModuleFromBytecodeCache(IJavaScriptContext& jsContext,
+                                                                  const BytesView& jsModule,
+                                                                  const StringBox& importPath,
+                                                                  JSExceptionTracker& exceptionTracker);
+
     ModuleLoadResult loadJsModuleFromNative(IJavaScriptContext& jsContext,
                                             const StringBox& importPath,
                                             const JSValueRef* parameters,
@@ -14,6 +14,7 @@
 #include "valdi/runtime/JavaScript/ValueFunctionWithJSValue.hpp"
 #include "valdi/runtime/Rendering/AnimationOptions.hpp"
 #include "valdi/runtime/Rendering/RenderRequest.hpp"
+#include "valdi_core/cpp/Utils/ObjectPool.hpp"
 #include "valdi_core/cpp/Utils/Result.hpp"
 #include "valdi_core/cpp/Utils/StringCache.hpp"
 #include "valdi_core/cpp/Utils/Trace.hpp"
@@ -114,16 +115,16 @@ static Ref<RenderRequest> onParseError(JSExceptionTracker& exceptionTracker) {
 }
 
 const Value& JavaScriptRuntimeDeserializers::getAttachedValue(const RenderRequestDescriptor& requestDescriptor,
-                                                              const Ref<ValueArray>& values,
+                                                              std::vector<Value>& values,
                                                               size_t index,
                                                               const ReferenceInfoBuilder& referenceInfoBuilder,
                                                               JSExceptionTracker& exceptionTracker) const {
-    if (values == nullptr || index >= values->size()) {
+    if (index >= values.size()) {
         onParseError(exceptionTracker);
         return Value::undefinedRef();
     }
 
-    auto& entry = (*values)[index];
+    auto& entry = values[index];
     if (entry.isNull()) {
         auto propertyValue = _jsContext.getObjectPropertyForIndex(requestDescriptor.values, index, exceptionTracker);
         if (!exceptionTracker) {
@@ -147,7 +148,10 @@ Ref<RenderRequest> JavaScriptRuntimeDeserializers::parseRequestDescriptor(
     const auto* descriptor = reinterpret_cast<const uint32_t*>(requestDescriptor.descriptor.data);
 
     auto valuesSize = requestDescriptor.valuesLength;
-    Ref<ValueArray> values = valuesSize > 0 ? ValueArray::make(valuesSize) : nullptr;
+    // The attached values are only needed while parsing, they are held in a recycled array
+    auto valuesArray = makeReusableArray<Value>();
+    auto& values = *valuesArray;
+    values.resize(valuesSize);
     auto length = static_cast<size_t>(requestDescriptor.descriptorSize);
     if (requestDescriptor.descriptor.length / 4 < length) {
         return onParseError(exceptionTracker);
@@ -11,6 +11,8 @@
 #include "valdi/runtime/JavaScript/JSPropertyNameIndex.hpp"
 #include "valdi_core/cpp/Utils/Shared.hpp"
 
+#include <vector>
+
 namespace Valdi {
 
 template<typename T>
@@ -46,7 +48,7 @@ private:
                                               JSExceptionTracker& exceptionTracker);
 
     const Value& getAttachedValue(const RenderRequestDescriptor& requestDescriptor,
-                                  const Ref<ValueArray>& values,
+                                  std::vector<Value>& values,
                                   size_t index,
                                   const ReferenceInfoBuilder& referenceInfoBuilder,
                                   JSExceptionTracker& exceptionTracker) const;
@@ -11,10 +11,15 @@
 #include "valdi_core/cpp/Resources/ValdiArchive.hpp"
 #include "valdi_core/cpp/Utils/Format.hpp"
 #include "valdi_core/cpp/Utils/LoggerUtils.hpp"
+#include "valdi_core/cpp/Utils/Trace.hpp"
 
 namespace Valdi {
 
 constexpr int64_t kPersistentStoreSaveDelayMs = 50;
+// The journal is compacted once it is bigger than the snapshot multiplied by this ratio
+constexpr size_t kPersistentStoreJournalCompactionRatio = 1;
+// Journals smaller than this are never compacted
+constexpr size_t kPersistentStoreMinJournalSizeForCompaction = 64 * 1024;
 
 PersistentStore::PersistentStore(const StringBox& diskCachePath,
                                  const Ref<IDiskCache>& diskCache,
@@ -25,6 +30,7 @@ PersistentStore::PersistentStore(const StringBox& diskCachePath,
                                  uint64_t maxWeight,
                                  bool disableBatchWrites)
     : _diskCachePath(diskCachePath),
+      _journalPath(Path(diskCachePath).appendFileExtension("journal")),
       _diskCache(diskCache),
       _userSession(userSession),
       _keychain(keychain),
@@ -45,6 +51,7 @@ void PersistentStore::store(const StringBox& key,
     _dispatchQueue->async(
         [key, blob, ttlSeconds, weight, self = strongRef(this), completion = std::move(completion)]() {
             self->_store.store(key, blob, ttlSeconds, weight);
+            self->appendToJournal(KeyValueStoreJournalOperation::Store, key);
             self->scheduleSave(completion);
         });
 }
@@ -103,12 +110,14 @@ void PersistentStore::updateActiveDiskStore() {
     }
 
     _activeDiskCache = std::move(activeDiskCache);
+    _journalEnabled = _activeDiskCache->supportsIncrementalAppend();
 }
 
 void PersistentStore::fetchAll(
     Function<void(const std::vector<std::pair<StringBox, KeyValueStoreEntry>>&)> completion) {
     _dispatchQueue->async([self = strongRef(this), completion = std::move(completion)]() {
         auto entries = self->_store.fetchAll();
+        self->appendEvictionsToJournal();
         completion(entries);
     });
 }
@@ -117,6 +126,10 @@ void PersistentStore::fetch(const StringBox& key, Function<void(Result<BytesView
     _dispatchQueue->async([key, self = strongRef(this), completion = std::move(completion)]() {
         auto data = self->_store.fetch(key);
         if (data) {
+            // Persisted with the next save, like the updated mutation id was with full snapshots
+            if (self->_journalEnabled) {
+                self->_touchedKeys.insert(key);
+            }
             completion(data.value());
         } else {
             completion(Error(STRING_FORMAT("Did not find item '{}'", key)));
@@ -132,6 +145,7 @@ void PersistentStore::exists(const StringBox& key, Function<void(bool)> completi
 void PersistentStore::remove(const StringBox& key, Function<void(Result<Void>)> completion) {
     _dispatchQueue->async([key, self = strongRef(this), completion = std::move(completion)]() {
         if (self->_store.remove(key)) {
+            self->appendToJournal(KeyValueStoreJournalOperation::Remove, key);
             self->scheduleSave(completion);
         } else {
             completion(Error(STRING_FORMAT("Did not find item '{}'", key)));
@@ -142,6 +156,8 @@ void PersistentStore::remove(const StringBox& key, Function<void(Result<Void>)>
 void PersistentStore::removeAll(Function<void(Result<Void>)> completion) {
     _dispatchQueue->async([self = strongRef(this), completion = std::move(completion)]() {
         self->_store.removeAll();
+        // Cheaper to write an empty snapshot than to journal every removal
+        self->_compactionRequested = true;
         self->scheduleSave(completion);
     });
 }
@@ -160,19 +176,129 @@ void PersistentStore::scheduleSave(Function<void(Result<Void>)> completion) {
 }
 
 void PersistentStore::doSave() {
-    Result<Void> result;
-    auto serializeResult = _store.serialize();
+    appendEvictionsToJournal();
 
-    if (serializeResult) {
-        result = _activeDiskCache->store(_diskCachePath, serializeResult.value());
+    Result<Void> result;
+    if (!_hasSnapshot || _compactionRequested || !_journalEnabled) {
+        result = compact();
     } else {
-        result = serializeResult.moveError();
+        appendTouchesToJournal();
+        result = flushJournal();
+        if (!result) {
+            VALDI_WARN(_logger, "Failed to append to journal at '{}': {}", _journalPath.toString(), result.error());
+            // The snapshot holds the whole store, so a successful compaction recovers from the failed append
+            result = compact();
+        }
     }
 
     auto pendingSaves = std::move(_pendingSaves);
     for (const auto& pendingSave : pendingSaves) {
         pendingSave(result);
     }
+
+    scheduleCompactionIfNeeded();
+}
+
+void PersistentStore::appendToJournal(KeyValueStoreJournalOperation operation, const StringBox& key) {
+    if (!_journalEnabled) {
+        return;
+    }
+    _pendingJournalRecords.emplace_back(_store.makeJournalRecord(operation, key));
+}
+
+void PersistentStore::appendEvictionsToJournal() {
+    _store.evictIfNeeded();
+    for (const auto& key : _store.takeEvictedKeys()) {
+        appendToJournal(KeyValueStoreJournalOperation::Remove, key);
+    }
+}
+
+void PersistentStore::appendTouchesToJournal() {
+    for (const auto& key : _touchedKeys) {
+        appendToJournal(KeyValueStoreJournalOperation::Touch, key);
+    }
+    _touchedKeys.clear();
+}
+
+Result<Void> PersistentStore::flushJournal() {
+    if (_pendingJournalRecords.empty()) {
+        return Void();
+    }
+
+    auto records = std::move(_pendingJournalRecords);
+    _pendingJournalRecords.clear();
+
+    auto result = _activeDiskCache->appendRecords(_journalPath, records);
+    if (result) {
+        for (const auto& record : records) {
+            _journalSize += record.size();
+        }
+    }
+
+    return result;
+}
+
+Result<Void> PersistentStore::compact() {
+    VALDI_TRACE("Valdi.compactPersistentStore");
+
+    // The snapshot holds the state of all the pending records
+    _pendingJournalRecords.clear();
+    _touchedKeys.clear();
+
+    auto serializeResult = _store.serialize();
+    // Entries evicted while serializing are already absent from the snapshot
+    _store.takeEvictedKeys();
+
+    if (!serializeResult) {
+        _compactionRequested = true;
+        return serializeResult.moveError();
+    }
+
+    auto result = _activeDiskCache->store(_diskCachePath, serializeResult.value());
+    if (!result) {
+        _compactionRequested = true;
+        return result;
+    }
+
+    // The snapshot saves the mutation id sequence, and journal records made before it are skipped
+    // on replay. A journal left behind by an interruption or a failed removal is thus never
+    // applied on top of the newer snapshot.
+    if (_activeDiskCache->exists(_journalPath) && !_activeDiskCache->remove(_journalPath)) {
+        VALDI_WARN(_logger, "Failed to remove journal at '{}'", _journalPath.toString());
+    }
+
+    _hasSnapshot = true;
+    _compactionRequested = false;
+    _snapshotSize = serializeResult.value().size();
+    _journalSize = 0;
+
+    return Void();
+}
+
+void PersistentStore::scheduleCompactionIfNeeded() {
+    if (_compactionScheduled || !_hasSnapshot) {
+        return;
+    }
+
+    if (!_compactionRequested && (_journalSize < kPersistentStoreMinJournalSizeForCompaction ||
+                                  _journalSize < _snapshotSize * kPersistentStoreJournalCompactionRatio)) {
+        return;
+    }
+
+    _compactionScheduled = true;
+    _dispatchQueue->async([self = strongRef(this)]() {
+        self->_compactionScheduled = false;
+        if (!self->_hasSnapshot) {
+            return;
+        }
+        auto result = self->compact();
+        if (!result) {
+            VALDI_ERROR(self->_logger,
+                        "Failed to compact store at '{}': {}",
+                        self->_activeDiskCache->getAbsoluteURL(self->_diskCachePath),
+                        result.error());
+        }
+    });
 }
 
 void PersistentStore::populate() {
@@ -183,9 +309,18 @@ void PersistentStore::onPopulateFailure(const Error& error) {
     VALDI_ERROR(
         _logger, "Failed to populate cache at '{}': {}", _activeDiskCache->getAbsoluteURL(_diskCachePath), error);
     _store.removeAll();
+    // Make sure the invalid content gets replaced on the next save
+    _compactionRequested = true;
 }
 
 void PersistentStore::doPopulate() {
+    _pendingJournalRecords.clear();
+    _touchedKeys.clear();
+    _hasSnapshot = false;
+    _compactionRequested = false;
+    _snapshotSize = 0;
+    _journalSize = 0;
+
     if (_activeDiskCache->exists(_diskCachePath)) {
         auto result = _activeDiskCache->load(_diskCachePath);
         if (!result) {
@@ -198,7 +333,40 @@ void PersistentStore::doPopulate() {
             onPopulateFailure(populateResult.error());
             return;
         }
+
+        _hasSnapshot = true;
+        _snapshotSize = result.value().size();
+    }
+
+    if (_activeDiskCache->exists(_journalPath)) {
+        auto replayResult = replayJournal();
+        if (!replayResult) {
+            onPopulateFailure(replayResult.error());
+            return;
+        }
+
+        // Fold the journal back into the snapshot, so that new records are never appended
+        // after a record which was truncated by an interrupted write.
+        _compactionRequested = true;
+        scheduleCompactionIfNeeded();
+    }
+}
+
+Result<Void> PersistentStore::replayJournal() {
+    auto records = _activeDiskCache->loadRecords(_journalPath);
+    if (!records) {
+        return records.moveError();
+    }
+
+    for (const auto& record : records.value()) {
+        auto result = _store.replayJournalRecord(record);
+        if (!result) {
+            return result;
+        }
+        _journalSize += record.size();
     }
+
+    return Void();
 }
 
 void PersistentStore::setCurrentTimeSeconds(uint64_t timeSeconds) {
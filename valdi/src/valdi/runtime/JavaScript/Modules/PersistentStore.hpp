@@ -14,6 +14,7 @@
 #include "valdi_core/cpp/Utils/ByteBuffer.hpp"
 #include "valdi_core/cpp/Utils/Bytes.hpp"
 #include "valdi_core/cpp/Utils/FlatMap.hpp"
+#include "valdi_core/cpp/Utils/FlatSet.hpp"
 #include "valdi_core/cpp/Utils/PathUtils.hpp"
 #include "valdi_core/cpp/Utils/Result.hpp"
 #include "valdi_core/cpp/Utils/StringBox.hpp"
@@ -31,6 +32,14 @@ namespace Valdi {
 
 class UserSession;
 
+/**
+ PersistentStore is a KeyValueStore persisted into a disk cache.
+ It is saved as a snapshot of all the entries, followed by an append-only journal of the
+ store and remove operations made since the snapshot was written. populate() restores the
+ snapshot and replays the journal. The journal is compacted back into a new snapshot on
+ the dispatch queue once it grows past a ratio of the snapshot size. Disk caches which cannot
+ append in place always get a new snapshot.
+ */
 class PersistentStore : public ValdiObject {
 public:
     PersistentStore(const StringBox& diskCachePath,
@@ -73,6 +82,7 @@ public:
 private:
     KeyValueStore _store;
     Path _diskCachePath;
+    Path _journalPath;
     Ref<IDiskCache> _diskCache;
     Ref<IDiskCache> _activeDiskCache;
     Ref<UserSession> _userSession;
@@ -81,10 +91,27 @@ private:
     [[maybe_unused]] ILogger& _logger;
     bool _disableBatchWrites;
     std::vector<Function<void(Result<Void>)>> _pendingSaves;
+    std::vector<BytesView> _pendingJournalRecords;
+    // Keys fetched since the last save, journaled as Touch records with the next save
+    FlatSet<StringBox> _touchedKeys;
+    size_t _journalSize = 0;
+    size_t _snapshotSize = 0;
+    bool _hasSnapshot = false;
+    bool _compactionRequested = false;
+    bool _compactionScheduled = false;
+    bool _journalEnabled = false;
 
     void scheduleSave(Function<void(Result<Void>)> completion);
     void doSave();
     void doPopulate();
+    Result<Void> replayJournal();
+
+    void appendToJournal(KeyValueStoreJournalOperation operation, const StringBox& key);
+    void appendEvictionsToJournal();
+    void appendTouchesToJournal();
+    Result<Void> flushJournal();
+    Result<Void> compact();
+    void scheduleCompactionIfNeeded();
 
     void updateUserSession(const Ref<UserSession>& userSession);
     void updateActiveDiskStore();
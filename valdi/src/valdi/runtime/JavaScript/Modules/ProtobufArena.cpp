@@ -23,7 +23,12 @@ size_t JSProtobufMessage::getMessageIndex() const {
 
 ProtobufArena::ProtobufArena(bool eagerDecoding, bool includeAllFieldsDuringEncoding)
     : _eagerDecoding(eagerDecoding), _includeAllFieldsDuringEncoding(includeAllFieldsDuringEncoding) {}
-ProtobufArena::~ProtobufArena() = default;
+ProtobufArena::~ProtobufArena() {
+    // Messages can be retained past the arena, their skipped fields can't be postprocessed through it anymore
+    for (const auto& message : _messages) {
+        message->setSkippedFieldsMessageFactory(nullptr);
+    }
+}
 
 std::unique_lock<std::recursive_mutex> ProtobufArena::lock() const {
     return std::unique_lock<std::recursive_mutex>(_mutex);
@@ -54,6 +59,7 @@ size_t ProtobufArena::decodeMessage(const Ref<ProtobufMessageFactory>& messageFa
     VALDI_TRACE_META("Protobuf.decodeMessage", descriptor->name());
 
     auto message = createMessageForDescriptor(descriptor, bytes.getSource());
+    message->setProjection(messageFactory->getProjectionForDescriptor(descriptor));
 
     if (!message->decode(bytes.data(), bytes.size(), exceptionTracker)) {
         return 0;
@@ -125,12 +131,14 @@ BytesView ProtobufArena::encodeMessage(size_t messageIndex, ExceptionTracker& ex
 
 size_t ProtobufArena::fieldToMessageIndex(JSProtobufMessage& message,
                                           Protobuf::Field& field,
-                                          const google::protobuf::Descriptor* descriptor,
+                                          const google::protobuf::FieldDescriptor* fieldDescriptor,
                                           ExceptionTracker& exceptionTracker) {
     auto raw = field.getRaw();
     if (raw.data != nullptr) {
         // Parse the bytes of the message into a concrete message instance
-        auto outputMessage = createMessageForDescriptor(descriptor, message.getDataSource());
+        auto outputMessage = createMessageForDescriptor(fieldDescriptor->message_type(), message.getDataSource());
+        outputMessage->setProjection(
+            message.getNestedProjection(static_cast<Protobuf::FieldNumber>(fieldDescriptor->number())));
 
         if (!outputMessage->decode(raw.data, static_cast<size_t>(raw.length), exceptionTracker)) {
             return 0;
@@ -189,6 +197,30 @@ std::string ProtobufArena::messageToJSON(size_t messageIndex,
     return message->toJSON(printOptions, exceptionTracker);
 }
 
+Ref<ProtobufArena> ProtobufArena::makeStagingArena() const {
+    return makeShared<ProtobufArena>(_eagerDecoding, _includeAllFieldsDuringEncoding);
+}
+
+size_t ProtobufArena::mergeStagingArena(ProtobufArena& stagingArena) {
+    auto indexOffset = _messages.size();
+
+    _messages.reserve(_messages.size() + stagingArena._messages.size());
+    for (auto& message : stagingArena._messages) {
+        // Nested messages reference each other through their Field, so only the indexes need to be rebased
+        message->_messageIndex += indexOffset;
+        // The skipped fields of the message should be decoded into this arena from now on
+        message->setSkippedFieldsMessageFactory(this);
+        _messages.emplace_back(std::move(message));
+    }
+    stagingArena._messages.clear();
+
+    for (const auto& messageFactory : stagingArena._retainedMessageFactories) {
+        retainMessageFactory(messageFactory);
+    }
+
+    return indexOffset;
+}
+
 void ProtobufArena::retainMessageFactory(const Ref<ProtobufMessageFactory>& messageFactory) {
     for (const auto& existingMessageFactory : _retainedMessageFactories) {
         if (existingMessageFactory == messageFactory) {
@@ -24,6 +24,8 @@
 
 namespace Valdi {
 
+class ProtobufArena;
+
 class JSProtobufMessage : public Protobuf::Message {
 public:
     JSProtobufMessage(size_t messageIndex,
@@ -35,6 +37,8 @@ public:
 
 private:
     size_t _messageIndex;
+
+    friend ProtobufArena;
 };
 
 class ProtobufArena : public ValdiObject, protected Protobuf::IMessageFactory {
@@ -60,7 +64,7 @@ public:
 
     size_t fieldToMessageIndex(JSProtobufMessage& message,
                                Protobuf::Field& field,
-                               const google::protobuf::Descriptor* descriptor,
+                               const google::protobuf::FieldDescriptor* fieldDescriptor,
                                ExceptionTracker& exceptionTracker);
 
     BytesView encodeMessage(size_t messageIndex, ExceptionTracker& exceptionTracker) const;
@@ -69,6 +73,19 @@ public:
 
     size_t copyMessage(const ProtobufArena& fromArena, size_t messageIndex, ExceptionTracker& exceptionTracker);
 
+    /**
+     Create an empty arena with the same decoding and encoding options as this arena.
+     Messages can be decoded into it from another thread without contending on this
+     arena's lock, and then moved into this arena using mergeStagingArena().
+     */
+    Ref<ProtobufArena> makeStagingArena() const;
+
+    /**
+     Move all the messages of the given staging arena into this arena, and return the
+     offset that was added to their indexes. The caller must hold this arena's lock.
+     */
+    size_t mergeStagingArena(ProtobufArena& stagingArena);
+
     std::string messageToJSON(size_t messageIndex,
                               const Protobuf::JSONPrintOptions& printOptions,
                               ExceptionTracker& exceptionTracker) const;
@@ -0,0 +1,99 @@
+#include "valdi/runtime/JavaScript/Modules/ProtobufBatchDecode.hpp"
+#include "valdi/runtime/JavaScript/Modules/ProtobufArena.hpp"
+#include "valdi/runtime/JavaScript/Modules/ProtobufMessageFactory.hpp"
+
+#include "valdi_core/cpp/Threading/DispatchQueue.hpp"
+#include "valdi_core/cpp/Utils/Trace.hpp"
+#include "valdi_core/cpp/Utils/ValueArray.hpp"
+
+#include <algorithm>
+
+namespace Valdi {
+
+// Below this number of messages per job, fanning out costs more than it saves
+static constexpr size_t kMinMessagesPerJob = 4;
+
+ProtobufBatchDecode::ProtobufBatchDecode(Ref<ProtobufArena> arena,
+                                         Ref<ProtobufMessageFactory> messageFactory,
+                                         size_t descriptorIndex,
+                                         std::vector<BytesView> buffers,
+                                         size_t jobsCount,
+                                         Ref<ValueFunction> callback)
+    : _arena(std::move(arena)),
+      _messageFactory(std::move(messageFactory)),
+      _descriptorIndex(descriptorIndex),
+      _buffers(std::move(buffers)),
+      _jobs(jobsCount),
+      _remainingJobsCount(jobsCount),
+      _callback(std::move(callback)) {}
+
+ProtobufBatchDecode::~ProtobufBatchDecode() = default;
+
+void ProtobufBatchDecode::dispatch(DispatchQueue& queue) {
+    for (size_t i = 0; i < _jobs.size(); i++) {
+        queue.async([self = strongSmallRef(this), i]() { self->runJob(i); });
+    }
+}
+
+void ProtobufBatchDecode::runJob(size_t jobIndex) {
+    VALDI_TRACE("Protobuf.decodeMessageBatchJob");
+
+    auto& job = _jobs[jobIndex];
+    auto rangeStart = jobIndex * _buffers.size() / _jobs.size();
+    auto rangeEnd = (jobIndex + 1) * _buffers.size() / _jobs.size();
+
+    job.stagingArena = _arena->makeStagingArena();
+    job.messageIndexes.reserve(rangeEnd - rangeStart);
+
+    SimpleExceptionTracker exceptionTracker;
+    for (auto i = rangeStart; i < rangeEnd; i++) {
+        auto messageIndex =
+            job.stagingArena->decodeMessage(_messageFactory, _descriptorIndex, _buffers[i], true, exceptionTracker);
+        if (!exceptionTracker) {
+            job.error = exceptionTracker.extractError();
+            break;
+        }
+        job.messageIndexes.emplace_back(messageIndex);
+    }
+
+    if (_remainingJobsCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        complete();
+    }
+}
+
+size_t ProtobufBatchDecode::getJobsCount() const {
+    return _jobs.size();
+}
+
+size_t ProtobufBatchDecode::getJobsCountForMessages(size_t messagesCount, size_t maxJobsCount) {
+    return std::clamp((messagesCount + kMinMessagesPerJob - 1) / kMinMessagesPerJob,
+                      static_cast<size_t>(1),
+                      std::max(maxJobsCount, static_cast<size_t>(1)));
+}
+
+void ProtobufBatchDecode::complete() {
+    for (const auto& job : _jobs) {
+        if (job.error) {
+            (*_callback)({Value::undefined(), Value(job.error.value().toStringBox())});
+            return;
+        }
+    }
+
+    auto output = ValueArray::make(_buffers.size());
+    size_t outputIndex = 0;
+
+    {
+        VALDI_TRACE("Protobuf.mergeMessageBatch");
+        auto lock = _arena->lock();
+        for (auto& job : _jobs) {
+            auto indexOffset = _arena->mergeStagingArena(*job.stagingArena);
+            for (auto messageIndex : job.messageIndexes) {
+                (*output)[outputIndex++] = Value(static_cast<int32_t>(indexOffset + messageIndex));
+            }
+        }
+    }
+
+    (*_callback)({Value(output), Value::undefined()});
+}
+
+} // namespace Valdi
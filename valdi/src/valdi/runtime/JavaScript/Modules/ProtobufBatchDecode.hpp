@@ -0,0 +1,69 @@
+#pragma once
+
+#include "valdi_core/cpp/Utils/Bytes.hpp"
+#include "valdi_core/cpp/Utils/Error.hpp"
+#include "valdi_core/cpp/Utils/Shared.hpp"
+#include "valdi_core/cpp/Utils/ValueFunction.hpp"
+
+#include <atomic>
+#include <optional>
+#include <vector>
+
+namespace Valdi {
+
+class DispatchQueue;
+class ProtobufArena;
+class ProtobufMessageFactory;
+
+/**
+ Decodes a list of buffers of the same message type into an arena.
+
+ The buffers are split into contiguous ranges, each decoded by a job into its own staging arena,
+ so that the jobs can run concurrently without contending on the arena's lock. When the last job
+ completes, the staging arenas are merged into the arena in input order and the callback is called
+ with the array of message indexes, or with the first error that was encountered.
+ */
+class ProtobufBatchDecode : public SimpleRefCountable {
+public:
+    ProtobufBatchDecode(Ref<ProtobufArena> arena,
+                        Ref<ProtobufMessageFactory> messageFactory,
+                        size_t descriptorIndex,
+                        std::vector<BytesView> buffers,
+                        size_t jobsCount,
+                        Ref<ValueFunction> callback);
+    ~ProtobufBatchDecode() override;
+
+    /**
+     Enqueue all the jobs on the given queue, which may run them concurrently.
+     */
+    void dispatch(DispatchQueue& queue);
+
+    void runJob(size_t jobIndex);
+
+    size_t getJobsCount() const;
+
+    /**
+     Returns how many jobs should be used to decode the given number of messages, so that
+     each job has enough messages for fanning out to be worth it.
+     */
+    static size_t getJobsCountForMessages(size_t messagesCount, size_t maxJobsCount);
+
+private:
+    struct Job {
+        Ref<ProtobufArena> stagingArena;
+        std::vector<size_t> messageIndexes;
+        std::optional<Error> error;
+    };
+
+    Ref<ProtobufArena> _arena;
+    Ref<ProtobufMessageFactory> _messageFactory;
+    size_t _descriptorIndex;
+    std::vector<BytesView> _buffers;
+    std::vector<Job> _jobs;
+    std::atomic<size_t> _remainingJobsCount;
+    Ref<ValueFunction> _callback;
+
+    void complete();
+};
+
+} // namespace Valdi
@@ -62,6 +62,36 @@ const google::protobuf::Descriptor* ProtobufMessageFactory::getDescriptorAtIndex
     return descriptor;
 }
 
+bool ProtobufMessageFactory::setProjectionForDescriptorIndex(size_t index,
+                                                             const std::vector<std::string_view>& fieldPaths,
+                                                             ExceptionTracker& exceptionTracker) {
+    const auto* descriptor = getDescriptorAtIndex(index, exceptionTracker);
+    if (descriptor == nullptr) {
+        return false;
+    }
+
+    auto projection = Protobuf::MessageProjection::fromFieldPaths(descriptor, fieldPaths);
+    if (!projection) {
+        exceptionTracker.onError(projection.moveError());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(_projectionsMutex);
+    _projections[descriptor] = projection.moveValue();
+
+    return true;
+}
+
+Ref<Protobuf::MessageProjection> ProtobufMessageFactory::getProjectionForDescriptor(
+    const google::protobuf::Descriptor* descriptor) const {
+    std::lock_guard<std::mutex> guard(_projectionsMutex);
+    const auto& it = _projections.find(descriptor);
+    if (it == _projections.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
 static std::string_view getLastComponent(std::string_view fullName) {
     auto dotSeparator = fullName.find_last_of('.');
     if (dotSeparator != std::string_view::npos) {
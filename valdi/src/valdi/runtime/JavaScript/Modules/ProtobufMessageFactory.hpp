@@ -15,9 +15,12 @@
 #include "valdi_core/cpp/Utils/ValdiObject.hpp"
 
 #include "valdi_protobuf/FullyQualifiedName.hpp"
+#include "valdi_protobuf/MessageProjection.hpp"
 
 #include <google/protobuf/descriptor.h>
 
+#include <mutex>
+
 namespace Valdi {
 
 namespace Protobuf {
@@ -55,6 +58,17 @@ public:
     size_t getMessagePrototypeIndexForDescriptor(const google::protobuf::Descriptor* descriptor,
                                                  ExceptionTracker& exceptionTracker) const;
 
+    /**
+     * Annotate the message type at the given index with the list of field paths that
+     * will be read from it. Messages of that type decoded through a ProtobufArena
+     * will only tokenize the projected fields, and keep the others as raw bytes.
+     */
+    bool setProjectionForDescriptorIndex(size_t index,
+                                         const std::vector<std::string_view>& fieldPaths,
+                                         ExceptionTracker& exceptionTracker);
+
+    Ref<Protobuf::MessageProjection> getProjectionForDescriptor(const google::protobuf::Descriptor* descriptor) const;
+
     std::vector<NamespaceEntry> getRootNamespaceEntries() const;
     std::vector<NamespaceEntry> getNamespaceEntriesForId(size_t id, ExceptionTracker& exceptionTracker) const;
 
@@ -63,6 +77,8 @@ public:
 private:
     std::unique_ptr<Protobuf::DescriptorDatabase> _descriptorDatabase;
     google::protobuf::DescriptorPool _pool;
+    mutable std::mutex _projectionsMutex;
+    FlatMap<const google::protobuf::Descriptor*, Ref<Protobuf::MessageProjection>> _projections;
 };
 
 } // namespace Valdi
@@ -9,11 +9,14 @@
 #include "valdi/runtime/JavaScript/JSFunctionWithMethod.hpp"
 #include "valdi/runtime/JavaScript/JavaScriptUtils.hpp"
 #include "valdi/runtime/JavaScript/Modules/ProtobufArena.hpp"
+#include "valdi/runtime/JavaScript/Modules/ProtobufBatchDecode.hpp"
 #include "valdi/runtime/JavaScript/Modules/ProtobufMessageFactory.hpp"
 #include "valdi/runtime/Resources/ResourceManager.hpp"
 #include "valdi/runtime/ValdiRuntimeTweaks.hpp"
 
 #include "valdi_core/cpp/JavaScript/JavaScriptPathResolver.hpp"
+#include "valdi_core/cpp/Threading/DispatchQueue.hpp"
+#include "valdi_core/cpp/Threading/WorkerPoolDispatchQueue.hpp"
 #include "valdi_core/cpp/Utils/Format.hpp"
 #include "valdi_core/cpp/Utils/Trace.hpp"
 
@@ -21,6 +24,8 @@
 
 #include "utils/debugging/Assert.hpp"
 
+#include <algorithm>
+
 namespace Valdi {
 
 class ProtobufArenaAccess {
@@ -146,8 +151,8 @@ static JSValueRef getProtobufNonRepeatedField(ProtobufArena& arena,
         case google::protobuf::FieldDescriptor::TYPE_GROUP:
             return jsContext.newUndefined();
         case google::protobuf::FieldDescriptor::TYPE_MESSAGE: {
-            auto messageIndex = arena.fieldToMessageIndex(
-                message, field, fieldDescriptor->message_type(), callContext.getExceptionTracker());
+            auto messageIndex =
+                arena.fieldToMessageIndex(message, field, fieldDescriptor, callContext.getExceptionTracker());
             CHECK_CALL_CONTEXT(callContext);
 
             return toJSIndex(callContext, messageIndex);
@@ -473,8 +478,11 @@ static JSValueRef setProtobufMessageField(ProtobufArena& arena,
     }
 }
 
-ProtobufModule::ProtobufModule(ResourceManager& resourceManager, const Ref<DispatchQueue>& workerQueue, ILogger& logger)
-    : _resourcesManager(resourceManager), _workerQueue(workerQueue), _logger(logger) {}
+ProtobufModule::ProtobufModule(ResourceManager& resourceManager,
+                               const Ref<DispatchQueue>& workerQueue,
+                               const Ref<WorkerPoolDispatchQueue>& workerPool,
+                               ILogger& logger)
+    : _resourcesManager(resourceManager), _workerQueue(workerQueue), _workerPool(workerPool), _logger(logger) {}
 
 ProtobufModule::~ProtobufModule() = default;
 
@@ -581,11 +589,11 @@ JSValueRef ProtobufModule::arenaDecodeMessageAsync(JSFunctionNativeCallContext&
     auto callback = callContext.getParameterAsFunction(4);
     CHECK_CALL_CONTEXT(callContext);
 
-    _workerQueue->async([arenaResult = std::move(arenaResult),
-                         messageFactoryResult = std::move(messageFactoryResult),
-                         descriptorIndex,
-                         bytes = std::move(bytes),
-                         callback = std::move(callback)]() {
+    getAsyncQueue().async([arenaResult = std::move(arenaResult),
+                            messageFactoryResult = std::move(messageFactoryResult),
+                            descriptorIndex,
+                            bytes = std::move(bytes),
+                            callback = std::move(callback)]() {
         auto lock = arenaResult->lock();
 
         SimpleExceptionTracker exceptionTracker;
@@ -601,6 +609,95 @@ JSValueRef ProtobufModule::arenaDecodeMessageAsync(JSFunctionNativeCallContext&
     return callContext.getContext().newUndefined();
 }
 
+static std::vector<BytesView> getBytesViews(JSFunctionNativeCallContext& callContext, size_t parameterIndex) {
+    std::vector<BytesView> output;
+
+    auto array = callContext.getParameter(parameterIndex);
+    auto length = jsArrayGetLength(callContext.getContext(), array, callContext.getExceptionTracker());
+    if (!callContext.getExceptionTracker()) {
+        return output;
+    }
+
+    output.reserve(length);
+
+    for (size_t i = 0; i < length; i++) {
+        auto property = callContext.getContext().getObjectPropertyForIndex(array, i, callContext.getExceptionTracker());
+        if (!callContext.getExceptionTracker()) {
+            return output;
+        }
+        auto typedArray = jsTypedArrayToValueTypedArray(callContext.getContext(),
+                                                        property.get(),
+                                                        ReferenceInfoBuilder(callContext.getReferenceInfo()),
+                                                        callContext.getExceptionTracker());
+        if (!callContext.getExceptionTracker()) {
+            return output;
+        }
+        output.emplace_back(typedArray->getBuffer());
+    }
+
+    return output;
+}
+
+DispatchQueue& ProtobufModule::getAsyncQueue() const {
+    if (_workerPool != nullptr) {
+        return *_workerPool;
+    }
+    return *_workerQueue;
+}
+
+// Maximum number of jobs a batch decode is split into
+static constexpr size_t kMaxBatchDecodeJobs = 4;
+
+const Ref<WorkerPoolDispatchQueue>& ProtobufModule::getBatchDecodeQueue() {
+    if (_batchDecodeQueue == nullptr) {
+        if (_workerPool != nullptr) {
+            // The jobs only touch their own staging arena, they can share the runtime worker pool
+            _batchDecodeQueue = _workerPool;
+        } else {
+            _batchDecodeQueue = makeShared<WorkerPoolDispatchQueue>(
+                STRING_LITERAL("Valdi Protobuf Worker"), ThreadQoSClassHigh, kMaxBatchDecodeJobs);
+        }
+    }
+
+    return _batchDecodeQueue;
+}
+
+JSValueRef ProtobufModule::arenaBatchDecodeMessagesAsync(JSFunctionNativeCallContext& callContext) {
+    auto arenaResult = getArenaUnsafe(callContext, 0);
+    CHECK_CALL_CONTEXT(callContext);
+
+    auto messageFactoryResult = getMessageFactory(callContext, 1);
+    CHECK_CALL_CONTEXT(callContext);
+
+    auto descriptorIndex = getIndex(callContext, 2);
+    CHECK_CALL_CONTEXT(callContext);
+
+    auto buffers = getBytesViews(callContext, 3);
+    CHECK_CALL_CONTEXT(callContext);
+
+    auto callback = callContext.getParameterAsFunction(4);
+    CHECK_CALL_CONTEXT(callContext);
+
+    // Resolve the descriptor upfront, so that the jobs only read from the message factory
+    messageFactoryResult->getDescriptorAtIndex(descriptorIndex, callContext.getExceptionTracker());
+    CHECK_CALL_CONTEXT(callContext);
+
+    const auto& queue = getBatchDecodeQueue();
+    auto jobsCount = ProtobufBatchDecode::getJobsCountForMessages(
+        buffers.size(), std::min(kMaxBatchDecodeJobs, queue->getWorkersCount()));
+
+    auto batchDecode = makeShared<ProtobufBatchDecode>(std::move(arenaResult),
+                                                       std::move(messageFactoryResult),
+                                                       descriptorIndex,
+                                                       std::move(buffers),
+                                                       jobsCount,
+                                                       std::move(callback));
+
+    batchDecode->dispatch(*queue);
+
+    return callContext.getContext().newUndefined();
+}
+
 JSValueRef ProtobufModule::arenaDecodeMessageDebugJSONAsync(JSFunctionNativeCallContext& callContext) {
     if constexpr (ProtobufModule::areProtoDebugFeaturesEnabled()) {
         auto arenaResult = getArenaUnsafe(callContext, 0);
@@ -618,11 +715,11 @@ JSValueRef ProtobufModule::arenaDecodeMessageDebugJSONAsync(JSFunctionNativeCall
         auto callback = callContext.getParameterAsFunction(4);
         CHECK_CALL_CONTEXT(callContext);
 
-        _workerQueue->async([arenaResult = std::move(arenaResult),
-                             messageFactoryResult = std::move(messageFactoryResult),
-                             descriptorIndex,
-                             json = std::move(json),
-                             callback = std::move(callback)]() {
+        getAsyncQueue().async([arenaResult = std::move(arenaResult),
+                                messageFactoryResult = std::move(messageFactoryResult),
+                                descriptorIndex,
+                                json = std::move(json),
+                                callback = std::move(callback)]() {
             auto utf8Storage = json->utf8Storage();
             auto lock = arenaResult->lock();
 
@@ -668,7 +765,7 @@ JSValueRef ProtobufModule::arenaEncodeMessageAsync(JSFunctionNativeCallContext&
     auto callback = callContext.getParameterAsFunction(2);
     CHECK_CALL_CONTEXT(callContext);
 
-    _workerQueue->async([arenaResult = std::move(arenaResult), messageIndex, callback = std::move(callback)]() {
+    getAsyncQueue().async([arenaResult = std::move(arenaResult), messageIndex, callback = std::move(callback)]() {
         auto lock = arenaResult->lock();
         SimpleExceptionTracker exceptionTracker;
 
@@ -721,9 +818,9 @@ JSValueRef ProtobufModule::arenaBatchEncodeMessageAsync(JSFunctionNativeCallCont
     auto callback = callContext.getParameterAsFunction(2);
     CHECK_CALL_CONTEXT(callContext);
 
-    _workerQueue->async([arenaResult = std::move(arenaResult),
-                         messageIndexes = std::move(messageIndexes),
-                         callback = std::move(callback)]() {
+    getAsyncQueue().async([arenaResult = std::move(arenaResult),
+                            messageIndexes = std::move(messageIndexes),
+                            callback = std::move(callback)]() {
         VALDI_TRACE("Protobuf.encodeMessageBatch");
         auto lock = arenaResult->lock();
 
@@ -979,6 +1076,38 @@ JSValueRef ProtobufModule::getNamespaceEntries(JSFunctionNativeCallContext& call
     return namespaceEntriesToJS(callContext.getContext(), callContext.getExceptionTracker(), namespaceEnties);
 }
 
+JSValueRef ProtobufModule::setMessageProjection(JSFunctionNativeCallContext& callContext) {
+    auto messageFactory = getMessageFactory(callContext, 0);
+    CHECK_CALL_CONTEXT(callContext);
+
+    auto descriptorIndex = getIndex(callContext, 1);
+    CHECK_CALL_CONTEXT(callContext);
+
+    auto fieldPathsArray = callContext.getParameter(2);
+    auto length = jsArrayGetLength(callContext.getContext(), fieldPathsArray, callContext.getExceptionTracker());
+    CHECK_CALL_CONTEXT(callContext);
+
+    std::vector<std::string> fieldPathStrings;
+    fieldPathStrings.reserve(length);
+
+    for (size_t i = 0; i < length; i++) {
+        auto property = callContext.getContext().getObjectPropertyForIndex(
+            fieldPathsArray, i, callContext.getExceptionTracker());
+        CHECK_CALL_CONTEXT(callContext);
+
+        auto fieldPath =
+            callContext.getContext().valueToStaticString(property.get(), callContext.getExceptionTracker());
+        CHECK_CALL_CONTEXT(callContext);
+
+        fieldPathStrings.emplace_back(fieldPath->utf8Storage().toStringView());
+    }
+
+    std::vector<std::string_view> fieldPaths(fieldPathStrings.begin(), fieldPathStrings.end());
+    messageFactory->setProjectionForDescriptorIndex(descriptorIndex, fieldPaths, callContext.getExceptionTracker());
+
+    return callContext.getContext().newUndefined();
+}
+
 JSValueRef ProtobufModule::doLoadMessagesFromFactory(const Ref<ProtobufMessageFactory>& messageFactory,
                                                      JSFunctionNativeCallContext& callContext) {
     auto descriptorNames = messageFactory->getDescriptorNames();
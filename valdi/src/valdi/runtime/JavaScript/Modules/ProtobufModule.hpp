@@ -22,11 +22,15 @@ namespace Valdi {
 class ResourceManager;
 class IJavaScriptContext;
 class DispatchQueue;
+class WorkerPoolDispatchQueue;
 class ProtobufMessageFactory;
 
 class ProtobufModule : public SimpleRefCountable {
 public:
-    ProtobufModule(ResourceManager& resourceManager, const Ref<DispatchQueue>& workerQueue, ILogger& logger);
+    ProtobufModule(ResourceManager& resourceManager,
+                   const Ref<DispatchQueue>& workerQueue,
+                   const Ref<WorkerPoolDispatchQueue>& workerPool,
+                   ILogger& logger);
     ~ProtobufModule() override;
 
     constexpr static bool areProtoDebugFeaturesEnabled() {
@@ -42,11 +46,13 @@ public:
 
     JSValueRef getFieldsForMessageDescriptor(JSFunctionNativeCallContext& callContext);
     JSValueRef getNamespaceEntries(JSFunctionNativeCallContext& callContext);
+    JSValueRef setMessageProjection(JSFunctionNativeCallContext& callContext);
 
     JSValueRef createArena(JSFunctionNativeCallContext& callContext);
     JSValueRef arenaCreateMessage(JSFunctionNativeCallContext& callContext);
     JSValueRef arenaDecodeMessage(JSFunctionNativeCallContext& callContext);
     JSValueRef arenaDecodeMessageAsync(JSFunctionNativeCallContext& callContext);
+    JSValueRef arenaBatchDecodeMessagesAsync(JSFunctionNativeCallContext& callContext);
     JSValueRef arenaEncodeMessage(JSFunctionNativeCallContext& callContext);
     JSValueRef arenaEncodeMessageAsync(JSFunctionNativeCallContext& callContext);
     JSValueRef arenaBatchEncodeMessageAsync(JSFunctionNativeCallContext& callContext);
@@ -59,10 +65,20 @@ public:
 protected:
     ResourceManager& _resourcesManager;
     Ref<DispatchQueue> _workerQueue;
+    Ref<WorkerPoolDispatchQueue> _workerPool;
     [[maybe_unused]] ILogger& _logger;
+    Ref<WorkerPoolDispatchQueue> _batchDecodeQueue;
 
     JSValueRef doLoadMessagesFromFactory(const Ref<ProtobufMessageFactory>& messageFactory,
                                          JSFunctionNativeCallContext& callContext);
+
+    const Ref<WorkerPoolDispatchQueue>& getBatchDecodeQueue();
+
+    /**
+     Returns the queue on which the async decode and encode calls run. The jobs lock their arena
+     and do not depend on each other, so they run concurrently on the worker pool when there is one.
+     */
+    DispatchQueue& getAsyncQueue() const;
 };
 
 } // namespace Valdi
@@ -17,6 +17,7 @@
 #include "valdi/runtime/Resources/ResourceManager.hpp"
 #include "valdi/runtime/ValdiRuntimeTweaks.hpp"
 
+#include "valdi_core/cpp/Threading/WorkerPoolDispatchQueue.hpp"
 #include "valdi_core/cpp/Utils/LoggerUtils.hpp"
 #include "valdi_core/cpp/Utils/Trace.hpp"
 
@@ -38,8 +39,9 @@ private:
 
 ProtobufModuleFactory::ProtobufModuleFactory(ResourceManager& resourcesManager,
                                              const Ref<DispatchQueue>& workerQueue,
+                                             const Ref<WorkerPoolDispatchQueue>& workerPool,
                                              ILogger& logger)
-    : _resourcesManager(resourcesManager), _workerQueue(workerQueue), _logger(logger) {}
+    : _resourcesManager(resourcesManager), _workerQueue(workerQueue), _workerPool(workerPool), _logger(logger) {}
 
 ProtobufModuleFactory::~ProtobufModuleFactory() = default;
 
@@ -93,9 +95,11 @@ JSValueRef ProtobufModuleFactory::loadModule(IJavaScriptContext& jsContext,
         std::vector({std::make_pair("loadMessages", &ProtobufModule::loadMessages),
                      std::make_pair("getFieldsForMessageDescriptor", &ProtobufModule::getFieldsForMessageDescriptor),
                      std::make_pair("getNamespaceEntries", &ProtobufModule::getNamespaceEntries),
+                     std::make_pair("setMessageProjection", &ProtobufModule::setMessageProjection),
                      std::make_pair("createMessage", &ProtobufModule::arenaCreateMessage),
                      std::make_pair("decodeMessage", &ProtobufModule::arenaDecodeMessage),
                      std::make_pair("decodeMessageAsync", &ProtobufModule::arenaDecodeMessageAsync),
+                     std::make_pair("batchDecodeMessagesAsync", &ProtobufModule::arenaBatchDecodeMessagesAsync),
                      std::make_pair("encodeMessage", &ProtobufModule::arenaEncodeMessage),
                      std::make_pair("encodeMessageAsync", &ProtobufModule::arenaEncodeMessageAsync),
                      std::make_pair("batchEncodeMessageAsync", &ProtobufModule::arenaBatchEncodeMessageAsync),
@@ -110,7 +114,7 @@ JSValueRef ProtobufModuleFactory::loadModule(IJavaScriptContext& jsContext,
         functions.emplace_back("parseAndLoadMessages", &ProtobufModule::loadMessagesFromProtoFileContent);
     }
 
-    auto m = makeShared<ProtobufModule>(_resourcesManager, _workerQueue, _logger);
+    auto m = makeShared<ProtobufModule>(_resourcesManager, _workerQueue, _workerPool, _logger);
 
     for (const auto& function : functions) {
         registerModuleFunction(
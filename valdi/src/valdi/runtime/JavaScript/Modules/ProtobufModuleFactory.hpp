@@ -17,10 +17,14 @@ namespace Valdi {
 class ResourceManager;
 class IJavaScriptContext;
 class DispatchQueue;
+class WorkerPoolDispatchQueue;
 
 class ProtobufModuleFactory : public JavaScriptModuleFactory {
 public:
-    ProtobufModuleFactory(ResourceManager& resourcesManager, const Ref<DispatchQueue>& workerQueue, ILogger& logger);
+    ProtobufModuleFactory(ResourceManager& resourcesManager,
+                          const Ref<DispatchQueue>& workerQueue,
+                          const Ref<WorkerPoolDispatchQueue>& workerPool,
+                          ILogger& logger);
     ~ProtobufModuleFactory() override;
 
     static void preloadProtoModule(const Ref<ResourceManager>& resourcesManager,
@@ -35,6 +39,7 @@ public:
 private:
     [[maybe_unused]] ResourceManager& _resourcesManager;
     Ref<DispatchQueue> _workerQueue;
+    Ref<WorkerPoolDispatchQueue> _workerPool;
     [[maybe_unused]] ILogger& _logger;
 };
 
@@ -40,6 +40,12 @@ struct DestructEntryVisitor {
     }
 };
 
+static void cleanUpEntries(ByteBuffer& entries) {
+    entries.clear();
+}
+
+RenderRequest::RenderRequest() : _entries(ObjectPool<ByteBuffer>::get().getOrCreate(&cleanUpEntries)) {}
+
 RenderRequest::~RenderRequest() {
     DestructEntryVisitor visitor;
     visitEntries(visitor);
@@ -74,7 +80,7 @@ size_t RenderRequest::getEntriesSize() const {
 }
 
 size_t RenderRequest::getEntriesBytesCount() const {
-    return _entries.size();
+    return _entries->size();
 }
 
 RenderRequestEntries::CreateElement* RenderRequest::appendCreateElement() {
@@ -114,7 +120,7 @@ RenderRequestEntries::OnLayoutComplete* RenderRequest::appendOnLayoutComplete()
 }
 
 RenderRequestEntries::EntryBase* RenderRequest::doAppendEntry(size_t size) {
-    auto* buffer = _entries.appendWritable(size);
+    auto* buffer = _entries->appendWritable(size);
     _entriesSize++;
     return reinterpret_cast<RenderRequestEntries::EntryBase*>(buffer);
 }
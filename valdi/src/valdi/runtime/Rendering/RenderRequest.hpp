@@ -14,6 +14,7 @@
 #include "valdi_core/cpp/Utils/ByteBuffer.hpp"
 
 #include "valdi_core/cpp/Utils/InlineContainerAllocator.hpp"
+#include "valdi_core/cpp/Utils/ObjectPool.hpp"
 #include "valdi_core/cpp/Utils/Shared.hpp"
 #include "valdi_core/cpp/Utils/ValueMap.hpp"
 
@@ -49,6 +50,7 @@ constexpr size_t getEntryAllocSize(const T& /*placeholder*/) {
  */
 class RenderRequest : public SimpleRefCountable {
 public:
+    RenderRequest();
     ~RenderRequest() override;
 
     ContextId getContextId() const;
@@ -82,8 +84,8 @@ public:
 
     template<typename Visitor>
     void visitEntries(Visitor& visitor) {
-        auto* current = _entries.data();
-        auto* end = current + _entries.size();
+        auto* current = _entries->data();
+        auto* end = current + _entries->size();
 
         while (current != end) {
             current += RenderRequestEntries::visitEntry(*reinterpret_cast<RenderRequestEntries::EntryBase*>(current),
@@ -96,7 +98,9 @@ public:
 
 private:
     ContextId _contextId = ContextIdNull;
-    ByteBuffer _entries;
+    // Recycled across requests, so that the entries buffer has usually
+    // grown to fit the request before we start appending to it.
+    ObjectPoolEntry<ByteBuffer, void (*)(ByteBuffer&)> _entries;
     Value _visibilityObserverCallback;
     Value _frameObserverCallback;
     size_t _entriesSize = 0;
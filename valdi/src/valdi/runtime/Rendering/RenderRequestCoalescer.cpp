@@ -0,0 +1,333 @@
+#include "valdi/runtime/Rendering/RenderRequestCoalescer.hpp"
+
+#include "valdi_core/cpp/Utils/FlatMap.hpp"
+#include "valdi_core/cpp/Utils/FlatSet.hpp"
+#include "valdi_core/cpp/Utils/SmallVector.hpp"
+
+#include <limits>
+
+namespace Valdi {
+
+/**
+ An attribute written on a node, used to only keep the last write of each attribute.
+ */
+struct CoalescedAttributeWrite {
+    size_t node;
+    AttributeId attributeId;
+    bool injectedFromParent;
+
+    bool operator==(const CoalescedAttributeWrite& other) const noexcept {
+        return node == other.node && attributeId == other.attributeId &&
+               injectedFromParent == other.injectedFromParent;
+    }
+};
+
+} // namespace Valdi
+
+namespace std {
+
+template<>
+struct hash<Valdi::CoalescedAttributeWrite> {
+    std::size_t operator()(const Valdi::CoalescedAttributeWrite& write) const noexcept {
+        auto hash = write.node;
+        hash = hash * 31 + write.attributeId;
+        hash = hash * 31 + static_cast<size_t>(write.injectedFromParent);
+        return hash;
+    }
+};
+
+} // namespace std
+
+namespace Valdi {
+
+static constexpr size_t kNoIndex = std::numeric_limits<size_t>::max();
+
+struct CanCoalesceVisitor {
+    bool canCoalesce = true;
+
+    template<typename T>
+    void visit(T& /*entry*/) {}
+
+    void visit(RenderRequestEntries::StartAnimations& /*entry*/) {
+        canCoalesce = false;
+    }
+
+    void visit(RenderRequestEntries::EndAnimations& /*entry*/) {
+        canCoalesce = false;
+    }
+
+    void visit(RenderRequestEntries::CancelAnimation& /*entry*/) {
+        canCoalesce = false;
+    }
+};
+
+/**
+ A node of the tree while going through the requests. A new node is created
+ every time an element id is created, so that an id re-used after being destroyed
+ is treated as a different node.
+ */
+struct CoalescedNode {
+    size_t createIndex = kNoIndex;
+    size_t destroyIndex = kNoIndex;
+    bool hasDependents = false;
+    bool dropped = false;
+    SmallVector<size_t, 2> moveIndexes;
+    SmallVector<size_t, 2> childMoveIndexes;
+};
+
+struct CoalescedEntry {
+    RenderRequestEntries::EntryBase* entry = nullptr;
+    size_t node = kNoIndex;
+    size_t parentNode = kNoIndex;
+    size_t structuralOrdinal = 0;
+    bool dropped = false;
+};
+
+class CoalescedEntriesBuilder {
+public:
+    std::vector<CoalescedEntry> entries;
+    std::vector<CoalescedNode> nodes;
+
+    template<typename T>
+    void visit(T& entry) {
+        append(entry);
+    }
+
+    void visit(RenderRequestEntries::CreateElement& entry) {
+        auto& coalescedEntry = append(entry);
+        coalescedEntry.node = nodes.size();
+        nodes.emplace_back().createIndex = entries.size() - 1;
+        _currentNodes[entry.getElementId()] = coalescedEntry.node;
+    }
+
+    void visit(RenderRequestEntries::DestroyElement& entry) {
+        auto& coalescedEntry = append(entry);
+        coalescedEntry.node = resolveNode(entry.getElementId());
+        auto& node = nodes[coalescedEntry.node];
+        if (node.destroyIndex == kNoIndex) {
+            node.destroyIndex = entries.size() - 1;
+        }
+        onStructuralChange(coalescedEntry);
+    }
+
+    void visit(RenderRequestEntries::MoveElementToParent& entry) {
+        auto& coalescedEntry = append(entry);
+        coalescedEntry.node = resolveNode(entry.getElementId());
+        coalescedEntry.parentNode = resolveNode(entry.getParentElementId());
+        nodes[coalescedEntry.node].moveIndexes.emplace_back(entries.size() - 1);
+
+        auto& parentNode = nodes[coalescedEntry.parentNode];
+        parentNode.hasDependents = true;
+        parentNode.childMoveIndexes.emplace_back(entries.size() - 1);
+        onStructuralChange(coalescedEntry);
+    }
+
+    void visit(RenderRequestEntries::SetRootElement& entry) {
+        auto& coalescedEntry = append(entry);
+        coalescedEntry.node = resolveNode(entry.getElementId());
+        nodes[coalescedEntry.node].hasDependents = true;
+    }
+
+    void visit(RenderRequestEntries::SetElementAttribute& entry) {
+        auto& coalescedEntry = append(entry);
+        coalescedEntry.node = resolveNode(entry.getElementId());
+    }
+
+private:
+    FlatMap<RawViewNodeId, size_t> _currentNodes;
+    size_t _structuralOrdinal = 0;
+
+    CoalescedEntry& append(RenderRequestEntries::EntryBase& entry) {
+        auto& coalescedEntry = entries.emplace_back();
+        coalescedEntry.entry = &entry;
+        coalescedEntry.structuralOrdinal = _structuralOrdinal;
+        return coalescedEntry;
+    }
+
+    void onStructuralChange(CoalescedEntry& coalescedEntry) {
+        coalescedEntry.structuralOrdinal = ++_structuralOrdinal;
+    }
+
+    size_t resolveNode(RawViewNodeId id) {
+        const auto& it = _currentNodes.find(id);
+        if (it != _currentNodes.end()) {
+            return it->second;
+        }
+
+        // Node which existed before the requests
+        auto node = nodes.size();
+        nodes.emplace_back();
+        _currentNodes[id] = node;
+        return node;
+    }
+};
+
+class CopyEntryVisitor {
+public:
+    explicit CopyEntryVisitor(RenderRequest& output) : _output(output) {}
+
+    void visit(RenderRequestEntries::CreateElement& entry) {
+        auto* copy = _output.appendCreateElement();
+        copy->setElementId(entry.getElementId());
+        copy->setViewClassName(entry.getViewClassName());
+    }
+
+    void visit(RenderRequestEntries::DestroyElement& entry) {
+        _output.appendDestroyElement()->setElementId(entry.getElementId());
+    }
+
+    void visit(RenderRequestEntries::MoveElementToParent& entry) {
+        auto* copy = _output.appendMoveElementToParent();
+        copy->setElementId(entry.getElementId());
+        copy->setParentElementId(entry.getParentElementId());
+        copy->setParentIndex(entry.getParentIndex());
+    }
+
+    void visit(RenderRequestEntries::SetRootElement& entry) {
+        _output.appendSetRootElement()->setElementId(entry.getElementId());
+    }
+
+    void visit(RenderRequestEntries::SetElementAttribute& entry) {
+        auto* copy = _output.appendSetElementAttribute();
+        copy->setElementId(entry.getElementId());
+        copy->setAttributeId(entry.getAttributeId());
+        copy->setInjectedFromParent(entry.isInjectedFromParent());
+        copy->setAttributeValue(entry.getAttributeValue());
+    }
+
+    void visit(RenderRequestEntries::OnLayoutComplete& entry) {
+        _output.appendOnLayoutComplete()->setCallback(entry.getCallback());
+    }
+
+    template<typename T>
+    void visit(T& /*entry*/) {
+        SC_ASSERT_FAIL("Animation entries cannot be coalesced");
+    }
+
+private:
+    RenderRequest& _output;
+};
+
+static bool hasChildMoveBetween(const CoalescedNode& parentNode, size_t from, size_t to) {
+    for (auto index : parentNode.childMoveIndexes) {
+        if (index > from && index < to) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ A node created and destroyed within the requests can be dropped entirely, unless
+ other nodes were inserted into it, or its insertion shifted the index at which
+ a sibling was inserted.
+ */
+static bool canDropTransientNode(const CoalescedNode& node, const CoalescedEntriesBuilder& builder) {
+    if (node.createIndex == kNoIndex || node.destroyIndex == kNoIndex || node.hasDependents) {
+        return false;
+    }
+
+    for (size_t i = 0; i < node.moveIndexes.size(); i++) {
+        auto moveIndex = node.moveIndexes[i];
+        if (moveIndex > node.destroyIndex) {
+            break;
+        }
+        auto removeIndex = i + 1 < node.moveIndexes.size() ? std::min(node.moveIndexes[i + 1], node.destroyIndex)
+                                                           : node.destroyIndex;
+
+        const auto& parentNode = builder.nodes[builder.entries[moveIndex].parentNode];
+        if (hasChildMoveBetween(parentNode, moveIndex, removeIndex)) {
+            return false;
+        }
+        if (parentNode.destroyIndex > moveIndex && parentNode.destroyIndex < removeIndex) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void dropTransientNodes(CoalescedEntriesBuilder& builder) {
+    for (auto& node : builder.nodes) {
+        node.dropped = canDropTransientNode(node, builder);
+    }
+
+    for (auto& entry : builder.entries) {
+        if (entry.node != kNoIndex && builder.nodes[entry.node].dropped) {
+            entry.dropped = true;
+        }
+    }
+}
+
+static void collapseRepeatedMoves(CoalescedEntriesBuilder& builder) {
+    for (const auto& node : builder.nodes) {
+        for (size_t i = 0; i + 1 < node.moveIndexes.size(); i++) {
+            auto& move = builder.entries[node.moveIndexes[i]];
+            const auto& nextMove = builder.entries[node.moveIndexes[i + 1]];
+            // The next move of the node replaces this one if nothing else moved or got destroyed in between
+            if (nextMove.structuralOrdinal == move.structuralOrdinal + 1) {
+                move.dropped = true;
+            }
+        }
+    }
+}
+
+static void keepLastAttributeWrites(CoalescedEntriesBuilder& builder) {
+    FlatSet<CoalescedAttributeWrite> writtenAttributes;
+
+    for (auto it = builder.entries.rbegin(); it != builder.entries.rend(); ++it) {
+        auto& entry = *it;
+        if (entry.dropped || entry.entry->getType() != RenderRequestEntryType::SetElementAttribute) {
+            continue;
+        }
+
+        const auto& setAttribute = *reinterpret_cast<RenderRequestEntries::SetElementAttribute*>(entry.entry);
+        CoalescedAttributeWrite write{entry.node, setAttribute.getAttributeId(), setAttribute.isInjectedFromParent()};
+        if (!writtenAttributes.insert(write).second) {
+            entry.dropped = true;
+        }
+    }
+}
+
+bool RenderRequestCoalescer::canCoalesce(const RenderRequest& renderRequest) {
+    CanCoalesceVisitor visitor;
+    renderRequest.visitEntries(visitor);
+    return visitor.canCoalesce;
+}
+
+Ref<RenderRequest> RenderRequestCoalescer::coalesce(const std::vector<Ref<RenderRequest>>& renderRequests) {
+    auto output = makeShared<RenderRequest>();
+    if (renderRequests.empty()) {
+        return output;
+    }
+
+    output->setContextId(renderRequests.front()->getContextId());
+
+    CoalescedEntriesBuilder builder;
+    for (const auto& renderRequest : renderRequests) {
+        renderRequest->visitEntries(builder);
+
+        // Observer callbacks are replaced every time they are registered
+        if (!renderRequest->getVisibilityObserverCallback().isNullOrUndefined()) {
+            output->setVisibilityObserverCallback(renderRequest->getVisibilityObserverCallback());
+        }
+        if (!renderRequest->getFrameObserverCallback().isNullOrUndefined()) {
+            output->setFrameObserverCallback(renderRequest->getFrameObserverCallback());
+        }
+    }
+
+    dropTransientNodes(builder);
+    collapseRepeatedMoves(builder);
+    keepLastAttributeWrites(builder);
+
+    CopyEntryVisitor copyVisitor(*output);
+    for (const auto& entry : builder.entries) {
+        if (!entry.dropped) {
+            RenderRequestEntries::visitEntry(*entry.entry, [&](auto& typedEntry) { copyVisitor.visit(typedEntry); });
+        }
+    }
+
+    return output;
+}
+
+} // namespace Valdi
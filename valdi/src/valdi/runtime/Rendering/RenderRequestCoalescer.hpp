@@ -0,0 +1,37 @@
+#pragma once
+
+#include "valdi/runtime/Rendering/RenderRequest.hpp"
+
+#include "valdi_core/cpp/Utils/Shared.hpp"
+
+#include <vector>
+
+namespace Valdi {
+
+/**
+ Merges consecutive render requests of a tree into a single request, so that a backlog
+ of requests can be applied with a single render and layout pass. The merged request
+ produces the same tree as applying the requests one after the other:
+ - Only the last write of an attribute on a node is kept.
+ - Nodes that are created and destroyed within the merged requests are dropped, as long
+   as no other node depends on them.
+ - A move of a node is dropped when it is followed by another move of the same node
+   without any other structural change in between.
+ Requests that start or end animations rely on their intermediate states, and are
+ never merged.
+ */
+class RenderRequestCoalescer {
+public:
+    /**
+     Returns whether the given request can be merged with other requests.
+     */
+    static bool canCoalesce(const RenderRequest& renderRequest);
+
+    /**
+     Merges the given requests, in order, into a single request.
+     All the requests must be for the same tree and satisfy canCoalesce().
+     */
+    static Ref<RenderRequest> coalesce(const std::vector<Ref<RenderRequest>>& renderRequests);
+};
+
+} // namespace Valdi
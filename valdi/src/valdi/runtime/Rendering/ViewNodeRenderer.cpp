@@ -16,6 +16,7 @@
 #include "valdi/runtime/Rendering/AnimationOptions.hpp"
 #include "valdi/runtime/Rendering/RenderRequest.hpp"
 #include "valdi/runtime/Utils/MainThreadManager.hpp"
+#include "valdi/runtime/Utils/RecyclingAllocator.hpp"
 #include "valdi_core/cpp/Utils/Format.hpp"
 #include "valdi_core/cpp/Utils/LoggerUtils.hpp"
 #include "valdi_core/cpp/Utils/Shared.hpp"
@@ -54,8 +55,9 @@ void ViewNodeRenderer::visit(RenderRequestEntries::CreateElement& entry) {
         return;
     }
 
-    auto viewNode =
-        Valdi::makeShared<ViewNode>(_attributesManager.getYogaConfig(), _attributesManager.getAttributeIds(), _logger);
+    // ViewNodes are created and destroyed in bulk as trees are rendered, their memory is recycled
+    auto viewNode = Valdi::makeRecycledShared<ViewNode>(
+        _attributesManager.getYogaConfig(), _attributesManager.getAttributeIds(), _logger);
     viewNode->setViewFactory(_viewTransactionScope, _viewNodeTree.getOrCreateViewFactory(entry.getViewClassName()));
     viewNode->setRawId(entry.getElementId());
 
@@ -123,8 +123,11 @@ Result<Void> Bundle::lockFreeLoadEntriesIfNeeded() {
 
     for (const auto& entryPath : _decompressedBundle->getAllEntryPaths()) {
         if (_entryByPath.find(entryPath) == _entryByPath.end()) {
-            auto entry = _decompressedBundle->getEntry(entryPath);
-            _entryByPath[entryPath] = BytesView(_decompressedBundle, entry->data, entry->size);
+            // Entries of seekable archives are decompressed on demand in getEntry()
+            if (!_decompressedBundle->isSeekable()) {
+                auto entry = _decompressedBundle->getEntry(entryPath);
+                _entryByPath[entryPath] = BytesView(_decompressedBundle, entry->data, entry->size);
+            }
             _allEntryPaths.emplace_back(entryPath);
         }
     }
@@ -132,6 +135,11 @@ Result<Void> Bundle::lockFreeLoadEntriesIfNeeded() {
     return Void();
 }
 
+bool Bundle::lockFreeHasArchiveEntry(const StringBox& path) const {
+    return _loadedEntries && _decompressedBundle != nullptr && _decompressedBundle->isSeekable() &&
+           _decompressedBundle->containsEntry(path);
+}
+
 Result<BytesView> Bundle::getEntry(const StringBox& path) {
     std::lock_guard<std::recursive_mutex> guard(_mutex);
 
@@ -142,6 +150,10 @@ Result<BytesView> Bundle::getEntry(const StringBox& path) {
 
     const auto& it = _entryByPath.find(path);
     if (it == _entryByPath.end()) {
+        if (lockFreeHasArchiveEntry(path)) {
+            return _decompressedBundle->getEntryBytes(path);
+        }
+
         return Error(STRING_FORMAT("No item named '{}' in module '{}', available items are: {}",
                                    path,
                                    _name,
@@ -155,14 +167,14 @@ bool Bundle::hasEntry(const StringBox& path) {
     std::lock_guard<std::recursive_mutex> guard(_mutex);
     lockFreeLoadEntriesIfNeeded();
 
-    return _entryByPath.find(path) != _entryByPath.end();
+    return _entryByPath.find(path) != _entryByPath.end() || lockFreeHasArchiveEntry(path);
 }
 
 void Bundle::setEntry(const StringBox& path, const BytesView& data) {
     std::lock_guard<std::recursive_mutex> guard(_mutex);
 
     const auto& it = _entryByPath.find(path);
-    if (it == _entryByPath.end()) {
+    if (it == _entryByPath.end() && !lockFreeHasArchiveEntry(path)) {
         _allEntryPaths.emplace_back(path);
     }
     _entryByPath[path] = data;
@@ -162,6 +162,7 @@ private:
     std::vector<StringBox> _allEntryPaths;
 
     Result<Void> lockFreeLoadEntriesIfNeeded();
+    bool lockFreeHasArchiveEntry(const StringBox& path) const;
 
     Result<Ref<AssetCatalog>> lockFreeGetAssetCatalog(const StringBox& assetCatalogPath);
 };
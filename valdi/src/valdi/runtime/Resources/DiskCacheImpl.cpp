@@ -6,6 +6,7 @@
 //
 
 #include "valdi/runtime/Resources/DiskCacheImpl.hpp"
+#include "valdi_core/cpp/Utils/ByteBuffer.hpp"
 #include "valdi_core/cpp/Utils/DiskUtils.hpp"
 #include "valdi_core/cpp/Utils/Format.hpp"
 #include "valdi_core/cpp/Utils/PathUtils.hpp"
@@ -46,6 +47,15 @@ Result<BytesView> DiskCacheImpl::load(const Path& path) {
     return DiskUtils::load(resolvedPath.value());
 }
 
+Result<BytesView> DiskCacheImpl::loadMapped(const Path& path) {
+    auto resolvedPath = resolveAbsolutePath(path, true);
+    if (!resolvedPath) {
+        return resolvedPath.moveError();
+    }
+
+    return DiskUtils::loadMapped(resolvedPath.value());
+}
+
 Result<BytesView> DiskCacheImpl::loadForAbsoluteURL(const StringBox& url) {
     URL parsedURL(url);
     if (parsedURL.getScheme() != "file") {
@@ -56,7 +66,7 @@ Result<BytesView> DiskCacheImpl::loadForAbsoluteURL(const StringBox& url) {
     return load(path);
 }
 
-Result<Void> DiskCacheImpl::store(const Path& path, const BytesView& bytes) {
+Result<Path> DiskCacheImpl::resolveWritePath(const Path& path) const {
     auto resolvedPath = resolveAbsolutePath(path, false);
     if (!resolvedPath) {
         return resolvedPath.moveError();
@@ -71,7 +81,48 @@ Result<Void> DiskCacheImpl::store(const Path& path, const BytesView& bytes) {
         }
     }
 
-    return DiskUtils::store(filePath, bytes);
+    return filePath;
+}
+
+Result<Void> DiskCacheImpl::store(const Path& path, const BytesView& bytes) {
+    auto filePath = resolveWritePath(path);
+    if (!filePath) {
+        return filePath.moveError();
+    }
+
+    // Files might be memory mapped by loadMapped(), they should never be truncated in place
+    return DiskUtils::storeAtomically(filePath.value(), bytes);
+}
+
+Result<Void> DiskCacheImpl::append(const Path& path, const BytesView& bytes) {
+    auto filePath = resolveWritePath(path);
+    if (!filePath) {
+        return filePath.moveError();
+    }
+
+    return DiskUtils::append(filePath.value(), bytes);
+}
+
+Result<BytesView> DiskCacheImpl::loadAppended(const Path& path) {
+    // Appended items are stored as is and are usually large, map them instead of copying them
+    return loadMapped(path);
+}
+
+Result<Void> DiskCacheImpl::appendRecords(const Path& path, const std::vector<BytesView>& records) {
+    auto filePath = resolveWritePath(path);
+    if (!filePath) {
+        return filePath.moveError();
+    }
+
+    auto output = makeShared<ByteBuffer>();
+    serializeRecords(records, *output);
+
+    // Appending leaves the existing bytes untouched, which keeps memory mappings valid
+    return DiskUtils::append(filePath.value(), output->toBytesView());
+}
+
+bool DiskCacheImpl::supportsIncrementalAppend() const {
+    return true;
 }
 
 Ref<IDiskCache> DiskCacheImpl::scopedCache(const Path& subfolder, bool allowsReadOutsideOfScope) const {
@@ -27,10 +27,19 @@ public:
 
     Result<BytesView> load(const Path& path) override;
 
+    Result<BytesView> loadMapped(const Path& path) override;
+
     Result<BytesView> loadForAbsoluteURL(const StringBox& url) override;
 
     Result<Void> store(const Path& path, const BytesView& bytes) override;
 
+    Result<Void> append(const Path& path, const BytesView& bytes) override;
+    Result<BytesView> loadAppended(const Path& path) override;
+
+    Result<Void> appendRecords(const Path& path, const std::vector<BytesView>& records) override;
+
+    bool supportsIncrementalAppend() const override;
+
     bool remove(const Path& path) override;
 
     StringBox getAbsoluteURL(const Path& path) const override;
@@ -49,6 +58,7 @@ private:
     Path _allowedReadPath;
 
     Result<Path> resolveAbsolutePath(const Path& path, bool isRead) const;
+    Result<Path> resolveWritePath(const Path& path) const;
 };
 
 } // namespace Valdi
@@ -55,6 +55,68 @@ Result<Void> EncryptedDiskCache::store(const Path& path, const BytesView& bytes)
     return _diskCache->store(path, encrypted.value());
 }
 
+Result<Void> EncryptedDiskCache::appendRecords(const Path& path, const std::vector<BytesView>& records) {
+    std::vector<BytesView> encryptedRecords;
+    encryptedRecords.reserve(records.size());
+
+    for (const auto& record : records) {
+        auto encrypted = encrypt(record);
+        if (!encrypted) {
+            return encrypted.moveError();
+        }
+        encryptedRecords.emplace_back(encrypted.moveValue());
+    }
+
+    return _diskCache->appendRecords(path, encryptedRecords);
+}
+
+Result<std::vector<BytesView>> EncryptedDiskCache::loadRecords(const Path& path) {
+    auto encryptedRecords = _diskCache->loadRecords(path);
+    if (!encryptedRecords) {
+        return encryptedRecords.moveError();
+    }
+
+    std::vector<BytesView> records;
+    records.reserve(encryptedRecords.value().size());
+
+    for (const auto& encryptedRecord : encryptedRecords.value()) {
+        auto decrypted = decrypt(encryptedRecord);
+        if (!decrypted) {
+            return decrypted.moveError();
+        }
+        records.emplace_back(decrypted.moveValue());
+    }
+
+    return records;
+}
+
+bool EncryptedDiskCache::supportsIncrementalAppend() const {
+    return _diskCache->supportsIncrementalAppend();
+}
+
+Result<Void> EncryptedDiskCache::append(const Path& path, const BytesView& bytes) {
+    auto encrypted = encrypt(bytes);
+    if (!encrypted) {
+        return encrypted.moveError();
+    }
+
+    return _diskCache->appendRecords(path, {encrypted.value()});
+}
+
+Result<BytesView> EncryptedDiskCache::loadAppended(const Path& path) {
+    auto chunks = loadRecords(path);
+    if (!chunks) {
+        return chunks.moveError();
+    }
+
+    auto out = makeShared<ByteBuffer>();
+    for (const auto& chunk : chunks.value()) {
+        out->append(chunk.begin(), chunk.end());
+    }
+
+    return out->toBytesView();
+}
+
 bool EncryptedDiskCache::remove(const Path& path) {
     return _diskCache->remove(path);
 }
@@ -38,6 +38,24 @@ public:
 
     Result<Void> store(const Path& path, const BytesView& bytes) final;
 
+    /**
+     Records are encrypted individually before being appended
+     to the underlying disk cache.
+     */
+    Result<Void> appendRecords(const Path& path, const std::vector<BytesView>& records) final;
+
+    Result<std::vector<BytesView>> loadRecords(const Path& path) final;
+
+    bool supportsIncrementalAppend() const final;
+
+    /**
+     Each appended chunk is encrypted individually and appended as a record
+     to the underlying disk cache, so that the item is never rewritten.
+     */
+    Result<Void> append(const Path& path, const BytesView& bytes) final;
+
+    Result<BytesView> loadAppended(const Path& path) final;
+
     bool remove(const Path& path) final;
 
     StringBox getAbsoluteURL(const Path& path) const final;
@@ -25,6 +25,16 @@ struct KeyValueStoreManifest {
     KeyValueStoreEntryManifest manifest[0];
 };
 
+struct KeyValueStoreJournalRecordHeader {
+    uint64_t version;
+    KeyValueStoreJournalOperation operation;
+    uint64_t mutationId;
+    uint64_t expirationDate;
+    uint64_t weight;
+    uint64_t keyLength;
+    // Followed by the key and the entry data
+};
+
 constexpr uint64_t kKeyValueStoreVersion = 2;
 
 STRING_CONST(manifestEntryName, "__manifest__")
@@ -45,7 +55,20 @@ void KeyValueStore::store(const StringBox& key, const BytesView& blob, uint64_t
         expirationDateSeconds = currentTimeSeconds() + ttlSeconds;
     }
 
-    _entries[key] = KeyValueStoreEntry(++_mutationId, expirationDateSeconds, weight, blob);
+    setEntry(key, KeyValueStoreEntry(++_mutationId, expirationDateSeconds, weight, blob));
+}
+
+void KeyValueStore::setEntry(const StringBox& key, KeyValueStoreEntry&& entry) {
+    auto& existingEntry = _entries[key];
+    _totalWeight -= existingEntry.weight;
+    _totalWeight += entry.weight;
+    existingEntry = std::move(entry);
+}
+
+FlatMap<StringBox, KeyValueStoreEntry>::iterator KeyValueStore::eraseEntry(
+    FlatMap<StringBox, KeyValueStoreEntry>::iterator it) {
+    _totalWeight -= it->second.weight;
+    return _entries.erase(it);
 }
 
 std::optional<BytesView> KeyValueStore::fetch(const StringBox& key, bool updateSequence) {
@@ -55,7 +78,7 @@ std::optional<BytesView> KeyValueStore::fetch(const StringBox& key, bool updateS
     }
 
     if (isEntryExpired(it->second)) {
-        _entries.erase(it);
+        eraseEntry(it);
         return std::nullopt;
     }
 
@@ -79,17 +102,19 @@ bool KeyValueStore::exists(const StringBox& key) {
 }
 
 bool KeyValueStore::remove(const StringBox& key) {
-    const auto& it = _entries.find(key);
+    auto it = _entries.find(key);
     if (it == _entries.end()) {
         return false;
     }
 
-    _entries.erase(it);
+    eraseEntry(it);
     return true;
 }
 
 void KeyValueStore::removeAll() {
     _entries.clear();
+    _totalWeight = 0;
+    _snapshotMutationId = 0;
 }
 
 void KeyValueStore::setMaxWeight(uint64_t maxWeight) {
@@ -120,7 +145,7 @@ std::vector<std::pair<StringBox, KeyValueStoreEntry>> KeyValueStore::collectEntr
 
             it++;
         } else {
-            it = _entries.erase(it);
+            it = eraseEntry(it);
         }
     }
 
@@ -148,9 +173,10 @@ void KeyValueStore::evictEntriesIfNeeded(std::vector<std::pair<StringBox, KeyVal
     if (i > 0) {
         // Remove all evicted entries from the entries map
         for (size_t j = 0; j < i; j++) {
-            const auto& it = _entries.find(collectedEntries[j].first);
+            auto it = _entries.find(collectedEntries[j].first);
             if (it != _entries.end()) {
-                _entries.erase(it);
+                eraseEntry(it);
+                _evictedKeys.emplace_back(collectedEntries[j].first);
             }
         }
 
@@ -263,12 +289,13 @@ Result<Void> KeyValueStore::populate(const BytesView& data) {
             }
 
             if (!isEntryExpired(entryResult.value())) {
-                _entries[entry.filePath] = entryResult.moveValue();
+                setEntry(entry.filePath, entryResult.moveValue());
             }
         }
     }
 
     _mutationId = idSequence;
+    _snapshotMutationId = idSequence;
     return Void();
 }
 
@@ -276,6 +303,106 @@ uint64_t KeyValueStore::getMutationId() const {
     return _mutationId;
 }
 
+void KeyValueStore::evictIfNeeded() {
+    if (_maxWeight == 0 || _totalWeight <= _maxWeight) {
+        return;
+    }
+
+    collectEntries();
+}
+
+std::vector<StringBox> KeyValueStore::takeEvictedKeys() {
+    auto evictedKeys = std::move(_evictedKeys);
+    _evictedKeys.clear();
+    return evictedKeys;
+}
+
+BytesView KeyValueStore::makeJournalRecord(KeyValueStoreJournalOperation operation, const StringBox& key) {
+    KeyValueStoreJournalRecordHeader header;
+    header.version = kKeyValueStoreVersion;
+    header.operation = operation;
+    header.mutationId = 0;
+    header.expirationDate = 0;
+    header.weight = 0;
+    header.keyLength = key.length();
+
+    const KeyValueStoreEntry* entry = nullptr;
+    if (operation == KeyValueStoreJournalOperation::Remove) {
+        // Removals don't have an entry to take the mutation id from
+        header.mutationId = ++_mutationId;
+    } else {
+        const auto& it = _entries.find(key);
+        if (it != _entries.end()) {
+            entry = &it->second;
+            header.mutationId = entry->mutationId;
+            header.expirationDate = entry->expirationDate;
+            header.weight = entry->weight;
+        }
+    }
+
+    auto output = makeShared<ByteBuffer>();
+    auto dataSize = entry != nullptr && operation == KeyValueStoreJournalOperation::Store ? entry->data.size() : 0;
+    output->reserve(sizeof(header) + key.length() + dataSize);
+    output->append(reinterpret_cast<const Byte*>(&header), reinterpret_cast<const Byte*>(&header) + sizeof(header));
+    output->append(key.toStringView());
+    if (dataSize > 0) {
+        output->append(entry->data.begin(), entry->data.end());
+    }
+
+    return output->toBytesView();
+}
+
+Result<Void> KeyValueStore::replayJournalRecord(const BytesView& record) {
+    auto parser = Parser<Byte>(record.begin(), record.end());
+    auto headerResult = parser.parseStruct<KeyValueStoreJournalRecordHeader>();
+    if (!headerResult) {
+        return headerResult.moveError();
+    }
+    const auto* header = headerResult.value();
+
+    if (header->version != kKeyValueStoreVersion) {
+        return Error("Incompatible KeyValueStore journal version");
+    }
+
+    if (header->mutationId <= _snapshotMutationId) {
+        // Already part of the snapshot, the journal was not removed after the snapshot was written
+        return Void();
+    }
+
+    auto keyResult = parser.parse<char>(header->keyLength);
+    if (!keyResult) {
+        return keyResult.moveError();
+    }
+    auto key = StringCache::getGlobal().makeString(std::string_view(keyResult.value(), header->keyLength));
+
+    _mutationId = std::max(_mutationId, header->mutationId);
+
+    switch (header->operation) {
+        case KeyValueStoreJournalOperation::Store: {
+            auto data = BytesView(record.getSource(), parser.getCurrent(), parser.getDistanceToEnd());
+            auto entry = KeyValueStoreEntry(header->mutationId, header->expirationDate, header->weight, data);
+            if (isEntryExpired(entry)) {
+                remove(key);
+            } else {
+                setEntry(key, std::move(entry));
+            }
+        } break;
+        case KeyValueStoreJournalOperation::Remove:
+            remove(key);
+            break;
+        case KeyValueStoreJournalOperation::Touch: {
+            auto it = _entries.find(key);
+            if (it != _entries.end()) {
+                it->second.mutationId = header->mutationId;
+            }
+        } break;
+        default:
+            return Error("Invalid KeyValueStore journal operation");
+    }
+
+    return Void();
+}
+
 uint64_t KeyValueStore::currentTimeSeconds() const {
     if (_currentTimeSeconds != 0) {
         return _currentTimeSeconds;
@@ -28,6 +28,13 @@ struct KeyValueStoreEntry {
     KeyValueStoreEntry();
 };
 
+enum class KeyValueStoreJournalOperation : uint64_t {
+    Store = 1,
+    Remove = 2,
+    // Updates the mutation id of an entry after it was fetched
+    Touch = 3,
+};
+
 class KeyValueStore {
 public:
     KeyValueStore();
@@ -36,6 +43,21 @@ public:
     Result<BytesView> serialize();
     Result<Void> populate(const BytesView& data);
 
+    /**
+     Returns a journal record describing the given operation on the given key, which
+     can be replayed with replayJournalRecord() on top of a store restored with populate().
+     Store and Touch records capture the current state of the entry, and should be made right
+     after the operation was applied. Every record is stamped with a mutation id, which is
+     compared against the mutation id sequence saved in the snapshot on replay.
+     */
+    BytesView makeJournalRecord(KeyValueStoreJournalOperation operation, const StringBox& key);
+
+    /**
+     Apply the given journal record on the store. Records which were made before the
+     snapshot restored with populate() was serialized are already part of it, and are skipped.
+     */
+    Result<Void> replayJournalRecord(const BytesView& record);
+
     void store(const StringBox& key, const BytesView& blob, uint64_t ttlSeconds, uint64_t weight);
 
     std::optional<BytesView> fetch(const StringBox& key);
@@ -50,14 +72,28 @@ public:
 
     uint64_t getMutationId() const;
 
+    /**
+     Evict the least recently used entries if the store is above its max weight.
+     */
+    void evictIfNeeded();
+
+    /**
+     Returns the keys of the entries that were evicted because of the max weight
+     since the last call.
+     */
+    std::vector<StringBox> takeEvictedKeys();
+
     // For unit tests
     void setCurrentTimeSeconds(uint64_t timeSeconds);
 
 private:
     uint64_t _currentTimeSeconds = 0;
     uint64_t _mutationId = 0;
+    uint64_t _snapshotMutationId = 0;
     uint64_t _maxWeight;
+    uint64_t _totalWeight = 0;
     FlatMap<StringBox, KeyValueStoreEntry> _entries;
+    std::vector<StringBox> _evictedKeys;
 
     void buildManifest(const std::vector<std::pair<StringBox, KeyValueStoreEntry>>& entries, ByteBuffer& output) const;
     std::vector<std::pair<StringBox, KeyValueStoreEntry>> collectEntries();
@@ -68,6 +104,9 @@ private:
     uint64_t currentTimeSeconds() const;
 
     std::optional<BytesView> fetch(const StringBox& key, bool updateSequence);
+
+    void setEntry(const StringBox& key, KeyValueStoreEntry&& entry);
+    FlatMap<StringBox, KeyValueStoreEntry>::iterator eraseEntry(FlatMap<StringBox, KeyValueStoreEntry>::iterator it);
 };
 
 } // namespace Valdi
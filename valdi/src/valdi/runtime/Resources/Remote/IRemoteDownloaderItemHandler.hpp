@@ -32,6 +32,16 @@ public:
      */
     virtual Result<Value> transform(const StringBox& localFilename, const BytesView& data) const = 0;
 
+    /**
+     Returns whether the data provided to transform() can be memory mapped from disk instead
+     of being read into the heap. This only pays off when the transformed representation keeps
+     referencing the data, otherwise the mapping is released right after transform() and costs
+     as much as a read.
+     */
+    virtual bool canTransformMappedData() const {
+        return false;
+    }
+
     /**
      Returns a string describing the type of items that the transformer handles
      */
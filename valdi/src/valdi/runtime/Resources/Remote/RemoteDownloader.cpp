@@ -128,12 +128,19 @@ RemoteDownloader::RemoteDownloader(const Ref<IDiskCache>& diskCache,
 
 RemoteDownloader::~RemoteDownloader() = default;
 
+Result<BytesView> RemoteDownloader::loadFromDisk(const RemoteDownloaderTask& task, const Path& path) {
+    if (task.getItemHandler().canTransformMappedData()) {
+        return _diskCache->loadMapped(path);
+    }
+    return _diskCache->load(path);
+}
+
 bool RemoteDownloader::loadFromDiskCache(const Shared<RemoteDownloaderTask>& task) {
     if (_diskCache == nullptr) {
         return false;
     }
 
-    auto result = _diskCache->load(Path(task->getLocalFilename()));
+    auto result = loadFromDisk(*task, Path(task->getLocalFilename()));
     if (!result) {
         return false;
     }
@@ -181,7 +188,7 @@ void RemoteDownloader::loadFileUrl(const Shared<RemoteDownloaderTask>& task) {
 
     auto absolutePath = task->getUrl().substring(std::string_view("file://").size());
 
-    auto loadResult = _diskCache->load(Path(absolutePath));
+    auto loadResult = loadFromDisk(*task, Path(absolutePath));
     if (!loadResult) {
         loadCompleted(task, loadResult.moveError(), true);
         return;
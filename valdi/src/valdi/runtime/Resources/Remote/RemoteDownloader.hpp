@@ -34,6 +34,7 @@ class ValdiModuleArchive;
 class DispatchQueue;
 class RemoteDownloaderTask;
 class IDiskCache;
+class Path;
 
 class CachedLoadedItem {
 public:
@@ -92,6 +93,7 @@ private:
 
     void doLoad(const Shared<RemoteDownloaderTask>& task);
 
+    Result<BytesView> loadFromDisk(const RemoteDownloaderTask& task, const Path& path);
     bool loadFromDiskCache(const Shared<RemoteDownloaderTask>& task);
     void loadRemote(const Shared<RemoteDownloaderTask>& task);
     void loadFileUrl(const Shared<RemoteDownloaderTask>& task);
@@ -50,7 +50,7 @@ Result<Value> ModuleBundleResultTransformer::transform(const StringBox& /*localF
     if (_decompressionDisabled) {
         decompressedBundleResult = ValdiModuleArchive::deserialize(data);
     } else {
-        decompressedBundleResult = ValdiModuleArchive::decompress(data.data(), data.size());
+        decompressedBundleResult = ValdiModuleArchive::decompress(data);
     }
 
     if (!decompressedBundleResult) {
@@ -61,6 +61,13 @@ Result<Value> ModuleBundleResultTransformer::transform(const StringBox& /*localF
         Valdi::makeShared<ValdiModuleArchive>(decompressedBundleResult.moveValue())));
 }
 
+// Seekable archives, emitted by the compiler with --seekable-modules, reference the data directly and only
+// decompress the entries which are accessed. Legacy archives are decompressed as a whole into the heap, the
+// mapping then only serves as the decompression input and is released right after.
+bool ModuleBundleResultTransformer::canTransformMappedData() const {
+    return true;
+}
+
 std::string_view ModuleBundleResultTransformer::getItemTypeDescription() const {
     return "module";
 }
@@ -87,7 +94,7 @@ Result<BytesView> ResourcesBundleResultTransformer::preprocess(const StringBox&
     if (_decompressionDisabled) {
         decompressedBundleResult = ValdiModuleArchive::deserialize(remoteData);
     } else {
-        decompressedBundleResult = ValdiModuleArchive::decompress(remoteData.data(), remoteData.size());
+        decompressedBundleResult = ValdiModuleArchive::decompress(remoteData);
     }
 
     if (!decompressedBundleResult) {
@@ -103,14 +110,14 @@ Result<BytesView> ResourcesBundleResultTransformer::preprocess(const StringBox&
     cacheDirectoryPath.appendFileExtension("dir");
 
     for (const auto& path : decompressedBundle->getAllEntryPaths()) {
-        auto entry = decompressedBundle->getEntry(path);
-        SC_ASSERT(entry.has_value(), "Unable to retrieve module entry");
-
-        auto bytesView = BytesView(decompressedBundle, entry->data, entry->size);
+        auto entry = decompressedBundle->getEntryBytes(path);
+        if (!entry) {
+            return entry.moveError();
+        }
 
         auto cachePath = cacheDirectoryPath.appending(path.toStringView());
 
-        auto storeSuccess = _diskCache->store(cachePath, bytesView);
+        auto storeSuccess = _diskCache->store(cachePath, entry.value());
         if (!storeSuccess) {
             return storeSuccess.error().rethrow(
                 STRING_FORMAT("Failed to store resource item '{}' in disk cache", path));
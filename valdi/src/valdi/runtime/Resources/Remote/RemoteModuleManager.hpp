@@ -40,6 +40,8 @@ class ModuleBundleResultTransformer : public IRemoteDownloaderItemHandler {
 public:
     Result<Value> transform(const StringBox& localFilename, const BytesView& data) const override;
 
+    bool canTransformMappedData() const override;
+
     std::string_view getItemTypeDescription() const override;
 
     void setDecompressionDisabled(bool decompressionDisabled);
@@ -93,7 +93,7 @@ Result<Ref<ValdiModuleArchive>> ResourceManager::getArchiveForModule(const Strin
 
     const auto& data = bundleContent.value();
 
-    auto result = ValdiModuleArchive::decompress(data.data(), data.size());
+    auto result = ValdiModuleArchive::decompress(data);
     if (!result) {
         return result.moveError();
     }
@@ -115,11 +115,10 @@ void ResourceManager::initializeBundle(BundleInitializer& bundleInitializer, Ref
 
     if (moduleArchive->containsEntry(kDownloadManifestName)) {
         // This is a downlodable module
-        auto entry = moduleArchive->getEntry(kDownloadManifestName);
-        SC_ASSERT(entry.has_value(), "Unable to retrieve module entry");
+        auto entry = moduleArchive->getEntryBytes(kDownloadManifestName);
         auto manifest = makeShared<DownloadableModuleManifestWrapper>();
 
-        if (!manifest->pb.ParseFromArray(entry->data, static_cast<int>(entry->size))) {
+        if (!entry || !manifest->pb.ParseFromArray(entry.value().data(), static_cast<int>(entry.value().size()))) {
             VALDI_ERROR(_logger, "Invalid download manifest in module '{}'", bundleName);
             initializeBundle(bundleInitializer, makeShared<ValdiModuleArchive>());
             return;
@@ -180,7 +179,7 @@ void ResourceManager::insertImageAssetInBundle(const Ref<Bundle>& bundle,
 
 void ResourceManager::insertAssetPackageInBundle(const Ref<Bundle>& bundle, const BytesView& assetPackageData) {
     _workerQueue->async([self = strongSmallRef(this), bundle, assetPackageData]() {
-        auto result = ValdiModuleArchive::decompress(assetPackageData.data(), assetPackageData.size());
+        auto result = ValdiModuleArchive::decompress(assetPackageData);
         if (!result) {
             VALDI_ERROR(self->_logger,
                         "Failed to decompress asset bundle in bundle '{}': {}",
@@ -202,9 +201,17 @@ void ResourceManager::insertAssetPackageInBundle(const Ref<Bundle>& bundle, cons
             return;
         }
 
-        auto assetsEntry = assetPackage.getEntryForIndex(bestIndex.value());
+        auto assetsEntry = assetPackage.getEntryBytesForIndex(bestIndex.value());
+        if (!assetsEntry) {
+            VALDI_ERROR(self->_logger,
+                        "Failed to load archive of asset bundle '{}' at index '{}': {}",
+                        bundle->getName(),
+                        bestIndex.value(),
+                        assetsEntry.error());
+            return;
+        }
 
-        ValdiArchive archive(assetsEntry.data, assetsEntry.data + assetsEntry.size);
+        ValdiArchive archive(assetsEntry.value().begin(), assetsEntry.value().end());
         auto allFiles = archive.getEntries();
         if (!allFiles) {
             VALDI_ERROR(self->_logger,
@@ -216,7 +223,7 @@ void ResourceManager::insertAssetPackageInBundle(const Ref<Bundle>& bundle, cons
         }
 
         for (const auto& asset : allFiles.value()) {
-            auto bytes = BytesView(result.value().getDecompressedContent().getSource(), asset.data, asset.dataLength);
+            auto bytes = BytesView(assetsEntry.value().getSource(), asset.data, asset.dataLength);
             self->doInsertImageAssetInBundle(bundle, asset.filePath, bytes);
         }
     });
@@ -9,16 +9,175 @@
 #include "valdi/runtime/Resources/ZStdUtils.hpp"
 #include "valdi_core/cpp/Resources/ValdiArchive.hpp"
 
+#include "valdi_core/cpp/Utils/InlineContainerAllocator.hpp"
+#include "valdi_core/cpp/Utils/Mutex.hpp"
 #include "valdi_core/cpp/Utils/Parser.hpp"
 #include "valdi_core/cpp/Utils/Shared.hpp"
 #include "valdi_core/cpp/Utils/StringCache.hpp"
 
+#include <cstring>
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 #include <iostream>
 
 namespace Valdi {
 
+// Seekable archive layout, all fields are little endian uint32:
+// | header | index entries | entry paths, padded to 4 bytes | entries data, each padded to 4 bytes |
+// Each compressed entry is its own zstd frame, so that any entry can be decompressed
+// without touching the rest of the archive.
+constexpr uint32_t kSeekableArchiveMagic = 0x52415356; // "VSAR"
+constexpr uint32_t kSeekableArchiveVersion = 1;
+constexpr uint32_t kSeekableEntryCompressed = 1;
+
+struct SeekableArchiveHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entriesCount;
+    uint32_t pathsSize;
+};
+
+struct SeekableArchiveIndexEntry {
+    uint32_t pathOffset;
+    uint32_t pathLength;
+    // Offset relative to the start of the entries data
+    uint32_t dataOffset;
+    uint32_t dataSize;
+    uint32_t decompressedSize;
+    uint32_t flags;
+};
+
+static void appendPadding(ByteBuffer& buffer) {
+    auto padding = alignUp(buffer.size(), sizeof(uint32_t)) - buffer.size();
+    for (size_t i = 0; i < padding; i++) {
+        buffer.append(static_cast<Byte>(0));
+    }
+}
+
+class ValdiModuleArchive::SeekableContent : public SimpleRefCountable {
+public:
+    SeekableContent(BytesView content,
+                    BytesView entriesData,
+                    std::vector<SeekableArchiveIndexEntry> index,
+                    const std::vector<StringBox>& orderedEntryPaths)
+        : _content(std::move(content)),
+          _entriesData(std::move(entriesData)),
+          _index(std::move(index)),
+          _cache(_index.size()) {
+        for (size_t i = 0; i < orderedEntryPaths.size(); i++) {
+            _indexByPath[orderedEntryPaths[i]] = i;
+        }
+    }
+
+    ~SeekableContent() override = default;
+
+    const BytesView& getContent() const {
+        return _content;
+    }
+
+    std::optional<size_t> find(const StringBox& path) const {
+        const auto& it = _indexByPath.find(path);
+        if (it == _indexByPath.end()) {
+            return std::nullopt;
+        }
+        return {it->second};
+    }
+
+    Result<BytesView> getEntry(size_t index) {
+        SC_ASSERT(index < _index.size());
+        const auto& indexEntry = _index[index];
+        if ((indexEntry.flags & kSeekableEntryCompressed) == 0) {
+            return _entriesData.subrange(indexEntry.dataOffset, indexEntry.dataSize);
+        }
+
+        {
+            std::lock_guard<Mutex> guard(_mutex);
+            auto& cachedEntry = _cache[index];
+            if (cachedEntry.bytes != nullptr) {
+                cachedEntry.lastAccess = ++_accessSequence;
+                return cachedEntry.bytes->toBytesView();
+            }
+        }
+
+        // Decompress outside of the lock so that distinct entries can be decompressed concurrently
+        auto decompressed = ZStdUtils::decompressFrame(
+            _entriesData.data() + indexEntry.dataOffset, indexEntry.dataSize, indexEntry.decompressedSize);
+        if (!decompressed) {
+            return decompressed.moveError();
+        }
+
+        std::lock_guard<Mutex> guard(_mutex);
+        auto& cachedEntry = _cache[index];
+        if (cachedEntry.bytes == nullptr) {
+            cachedEntry.bytes = decompressed.moveValue();
+            _cachedSize += cachedEntry.bytes->size();
+        }
+        cachedEntry.lastAccess = ++_accessSequence;
+        // Retain before evicting, the entry might be larger than the whole cache
+        auto bytes = cachedEntry.bytes;
+        evictIfNeeded();
+
+        return bytes->toBytesView();
+    }
+
+    std::optional<ValdiModuleArchiveEntry> getStoredEntry(size_t index) const {
+        SC_ASSERT(index < _index.size());
+        const auto& indexEntry = _index[index];
+        if ((indexEntry.flags & kSeekableEntryCompressed) != 0) {
+            return std::nullopt;
+        }
+        return ValdiModuleArchiveEntry{.data = _entriesData.data() + indexEntry.dataOffset,
+                                       .size = indexEntry.dataSize};
+    }
+
+    void setMaxCacheSize(size_t maxCacheSize) {
+        std::lock_guard<Mutex> guard(_mutex);
+        _maxCacheSize = maxCacheSize;
+        evictIfNeeded();
+    }
+
+    size_t getMaxCacheSize() const {
+        std::lock_guard<Mutex> guard(_mutex);
+        return _maxCacheSize;
+    }
+
+private:
+    struct CachedEntry {
+        Ref<ByteBuffer> bytes;
+        uint64_t lastAccess = 0;
+    };
+
+    mutable Mutex _mutex;
+    BytesView _content;
+    BytesView _entriesData;
+    std::vector<SeekableArchiveIndexEntry> _index;
+    FlatMap<StringBox, size_t> _indexByPath;
+    std::vector<CachedEntry> _cache;
+    size_t _cachedSize = 0;
+    size_t _maxCacheSize = kDefaultDecompressedEntriesCacheSize;
+    uint64_t _accessSequence = 0;
+
+    void evictIfNeeded() {
+        while (_cachedSize > _maxCacheSize) {
+            CachedEntry* leastRecentlyUsed = nullptr;
+            for (auto& cachedEntry : _cache) {
+                if (cachedEntry.bytes != nullptr &&
+                    (leastRecentlyUsed == nullptr || cachedEntry.lastAccess < leastRecentlyUsed->lastAccess)) {
+                    leastRecentlyUsed = &cachedEntry;
+                }
+            }
+
+            if (leastRecentlyUsed == nullptr) {
+                return;
+            }
+
+            // Entries still referenced by a BytesView stay alive until released
+            _cachedSize -= leastRecentlyUsed->bytes->size();
+            leastRecentlyUsed->bytes = nullptr;
+        }
+    }
+};
+
 ValdiModuleArchive::ValdiModuleArchive() = default;
 
 ValdiModuleArchive::ValdiModuleArchive(BytesView decompressedContent,
@@ -28,13 +187,32 @@ ValdiModuleArchive::ValdiModuleArchive(BytesView decompressedContent,
       _entries(std::move(entries)),
       _orderedEntryPaths(std::move(orderedEntryPaths)) {}
 
+ValdiModuleArchive::ValdiModuleArchive(Ref<SeekableContent> seekableContent, std::vector<StringBox> orderedEntryPaths)
+    : _orderedEntryPaths(std::move(orderedEntryPaths)), _seekableContent(std::move(seekableContent)) {}
+
+ValdiModuleArchive::ValdiModuleArchive(const ValdiModuleArchive& other) = default;
+ValdiModuleArchive::ValdiModuleArchive(ValdiModuleArchive&& other) noexcept = default;
 ValdiModuleArchive::~ValdiModuleArchive() = default;
 
+ValdiModuleArchive& ValdiModuleArchive::operator=(const ValdiModuleArchive& other) = default;
+ValdiModuleArchive& ValdiModuleArchive::operator=(ValdiModuleArchive&& other) noexcept = default;
+
 bool ValdiModuleArchive::containsEntry(const Valdi::StringBox& path) const {
+    if (_seekableContent != nullptr) {
+        return _seekableContent->find(path).has_value();
+    }
     return _entries.find(path) != _entries.end();
 }
 
 std::optional<ValdiModuleArchiveEntry> ValdiModuleArchive::getEntry(const Valdi::StringBox& path) const {
+    if (_seekableContent != nullptr) {
+        auto index = _seekableContent->find(path);
+        if (!index) {
+            return std::nullopt;
+        }
+        return _seekableContent->getStoredEntry(index.value());
+    }
+
     const auto& it = _entries.find(path);
     if (it == _entries.end()) {
         return std::nullopt;
@@ -43,6 +221,49 @@ std::optional<ValdiModuleArchiveEntry> ValdiModuleArchive::getEntry(const Valdi:
     return {it->second};
 }
 
+Result<BytesView> ValdiModuleArchive::getEntryBytes(const Valdi::StringBox& path) const {
+    if (_seekableContent != nullptr) {
+        auto index = _seekableContent->find(path);
+        if (!index) {
+            return Error(STRING_FORMAT("No entry named '{}' in archive", path));
+        }
+        auto entry = _seekableContent->getEntry(index.value());
+        if (!entry) {
+            return entry.error().rethrow(STRING_FORMAT("Failed to decompress entry '{}'", path));
+        }
+        return entry;
+    }
+
+    const auto& it = _entries.find(path);
+    if (it == _entries.end()) {
+        return Error(STRING_FORMAT("No entry named '{}' in archive", path));
+    }
+
+    return BytesView(_decompressedContent.getSource(), it->second.data, it->second.size);
+}
+
+Result<BytesView> ValdiModuleArchive::getEntryBytesForIndex(size_t index) const {
+    SC_ASSERT(index < _orderedEntryPaths.size());
+    return getEntryBytes(_orderedEntryPaths[index]);
+}
+
+bool ValdiModuleArchive::isSeekable() const {
+    return _seekableContent != nullptr;
+}
+
+void ValdiModuleArchive::setDecompressedEntriesCacheSize(size_t maxSize) {
+    if (_seekableContent != nullptr) {
+        _seekableContent->setMaxCacheSize(maxSize);
+    }
+}
+
+size_t ValdiModuleArchive::getDecompressedEntriesCacheSize() const {
+    if (_seekableContent == nullptr) {
+        return 0;
+    }
+    return _seekableContent->getMaxCacheSize();
+}
+
 const std::vector<StringBox>& ValdiModuleArchive::getAllEntryPaths() const {
     return _orderedEntryPaths;
 }
@@ -55,6 +276,11 @@ ValdiModuleArchiveEntry ValdiModuleArchive::getEntryForIndex(size_t index) const
 }
 
 bool ValdiModuleArchive::operator==(const ValdiModuleArchive& other) const {
+    if (_seekableContent != nullptr || other._seekableContent != nullptr) {
+        return _seekableContent != nullptr && other._seekableContent != nullptr &&
+               _seekableContent->getContent() == other._seekableContent->getContent();
+    }
+
     return _decompressedContent == other._decompressedContent;
 }
 
@@ -67,19 +293,143 @@ const BytesView& ValdiModuleArchive::getDecompressedContent() const {
 }
 
 Result<ValdiModuleArchive> ValdiModuleArchive::decompress(const Byte* data, size_t len) {
-    if (ZStdUtils::isZstdFile(data, len)) {
-        auto decompressed = ZStdUtils::decompress(data, len);
+    // The bytes are borrowed, like for uncompressed legacy archives
+    return decompress(BytesView(nullptr, data, len));
+}
+
+Result<ValdiModuleArchive> ValdiModuleArchive::decompress(const BytesView& data) {
+    if (isSeekableArchive(data.data(), data.size())) {
+        return ValdiModuleArchive::deserializeSeekable(data);
+    } else if (ZStdUtils::isZstdFile(data.data(), data.size())) {
+        auto decompressed = ZStdUtils::decompress(data.data(), data.size());
         if (!decompressed) {
             return decompressed.moveError();
         }
 
         return ValdiModuleArchive::deserialize(decompressed.value()->toBytesView());
     } else {
-        return ValdiModuleArchive::deserialize(BytesView(nullptr, data, len));
+        return ValdiModuleArchive::deserialize(data);
+    }
+}
+
+bool ValdiModuleArchive::isSeekableArchive(const Byte* data, size_t len) {
+    if (len < sizeof(SeekableArchiveHeader)) {
+        return false;
+    }
+    uint32_t magic;
+    std::memcpy(&magic, data, sizeof(uint32_t));
+    return magic == kSeekableArchiveMagic;
+}
+
+Result<ValdiModuleArchive> ValdiModuleArchive::deserializeSeekable(const BytesView& content) {
+    auto parser = Parser(content.begin(), content.end());
+    auto header = parser.parseStruct<SeekableArchiveHeader>();
+    if (!header) {
+        return header.moveError();
+    }
+    if (header.value()->magic != kSeekableArchiveMagic) {
+        return Error("Invalid seekable archive magic");
+    }
+    if (header.value()->version != kSeekableArchiveVersion) {
+        return Error(STRING_FORMAT("Unsupported seekable archive version {}", header.value()->version));
+    }
+
+    auto entriesCount = static_cast<size_t>(header.value()->entriesCount);
+    auto pathsSize = static_cast<size_t>(header.value()->pathsSize);
+
+    auto indexEntries = parser.parse<SeekableArchiveIndexEntry>(entriesCount * sizeof(SeekableArchiveIndexEntry));
+    if (!indexEntries) {
+        return indexEntries.moveError();
+    }
+    auto paths = parser.parse<char>(pathsSize);
+    if (!paths) {
+        return paths.moveError();
+    }
+
+    auto entriesDataOffset = parser.getDistanceToBegin();
+    auto entriesData = content.subrange(entriesDataOffset, content.size() - entriesDataOffset);
+
+    std::vector<SeekableArchiveIndexEntry> index(indexEntries.value(), indexEntries.value() + entriesCount);
+    std::vector<StringBox> orderedEntryPaths;
+    orderedEntryPaths.reserve(entriesCount);
+
+    for (const auto& indexEntry : index) {
+        if (static_cast<size_t>(indexEntry.pathOffset) + indexEntry.pathLength > pathsSize) {
+            return Error("Invalid seekable archive: entry path out of bounds");
+        }
+        if (static_cast<size_t>(indexEntry.dataOffset) + indexEntry.dataSize > entriesData.size()) {
+            return Error("Invalid seekable archive: entry data out of bounds");
+        }
+        if ((indexEntry.flags & kSeekableEntryCompressed) == 0 && indexEntry.dataSize != indexEntry.decompressedSize) {
+            return Error("Invalid seekable archive: stored entry size mismatch");
+        }
+
+        orderedEntryPaths.emplace_back(
+            StringCache::getGlobal().makeString(paths.value() + indexEntry.pathOffset, indexEntry.pathLength));
     }
+
+    auto seekableContent =
+        makeShared<SeekableContent>(content, std::move(entriesData), std::move(index), orderedEntryPaths);
+    return ValdiModuleArchive(std::move(seekableContent), std::move(orderedEntryPaths));
+}
+
+Ref<ByteBuffer> ValdiModuleArchive::serializeSeekable(const std::vector<ValdiArchiveEntry>& entries,
+                                                      int compressionLevel) {
+    std::vector<SeekableArchiveIndexEntry> index;
+    index.reserve(entries.size());
+    ByteBuffer paths;
+    ByteBuffer entriesData;
+
+    for (const auto& entry : entries) {
+        auto& indexEntry = index.emplace_back();
+        indexEntry.pathOffset = static_cast<uint32_t>(paths.size());
+        indexEntry.pathLength = static_cast<uint32_t>(entry.filePath.length());
+        paths.append(entry.filePath.toStringView());
+
+        indexEntry.dataOffset = static_cast<uint32_t>(entriesData.size());
+        indexEntry.decompressedSize = static_cast<uint32_t>(entry.dataLength);
+
+        auto compressed = ZStdUtils::compress(entry.data, entry.dataLength, compressionLevel);
+        if (compressed && compressed.value()->size() < entry.dataLength) {
+            indexEntry.flags = kSeekableEntryCompressed;
+            indexEntry.dataSize = static_cast<uint32_t>(compressed.value()->size());
+            entriesData.append(compressed.value()->begin(), compressed.value()->end());
+        } else {
+            // Store as is when compression doesn't help, the entry can then be used in place
+            indexEntry.flags = 0;
+            indexEntry.dataSize = static_cast<uint32_t>(entry.dataLength);
+            entriesData.append(entry.data, entry.data + entry.dataLength);
+        }
+
+        appendPadding(entriesData);
+    }
+
+    appendPadding(paths);
+
+    SeekableArchiveHeader header;
+    header.magic = kSeekableArchiveMagic;
+    header.version = kSeekableArchiveVersion;
+    header.entriesCount = static_cast<uint32_t>(index.size());
+    header.pathsSize = static_cast<uint32_t>(paths.size());
+
+    auto output = makeShared<ByteBuffer>();
+    output->reserve(sizeof(SeekableArchiveHeader) + index.size() * sizeof(SeekableArchiveIndexEntry) + paths.size() +
+                    entriesData.size());
+    output->append(reinterpret_cast<const Byte*>(&header), reinterpret_cast<const Byte*>(&header + 1));
+    output->append(reinterpret_cast<const Byte*>(index.data()),
+                   reinterpret_cast<const Byte*>(index.data() + index.size()));
+    output->append(paths.begin(), paths.end());
+    output->append(entriesData.begin(), entriesData.end());
+
+    return output;
 }
 
 Result<ValdiModuleArchive> ValdiModuleArchive::deserialize(BytesView decompressedContent) {
+    // Seekable archives are never compressed as a whole
+    if (isSeekableArchive(decompressedContent.data(), decompressedContent.size())) {
+        return ValdiModuleArchive::deserializeSeekable(decompressedContent);
+    }
+
     auto module = ValdiArchive(decompressedContent.data(), decompressedContent.data() + decompressedContent.size());
 
     FlatMap<StringBox, ValdiModuleArchiveEntry> entries;
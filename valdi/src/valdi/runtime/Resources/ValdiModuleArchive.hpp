@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "valdi_core/cpp/Utils/ByteBuffer.hpp"
 #include "valdi_core/cpp/Utils/Bytes.hpp"
 #include "valdi_core/cpp/Utils/FlatMap.hpp"
 #include "valdi_core/cpp/Utils/Result.hpp"
@@ -20,34 +21,94 @@ struct ValdiModuleArchiveEntry {
     size_t size;
 };
 
+struct ValdiArchiveEntry;
+
 class ValdiModuleArchive : public SharedPtrRefCountable {
 public:
+    static constexpr size_t kDefaultDecompressedEntriesCacheSize = 4 * 1024 * 1024;
+
     ValdiModuleArchive();
+    ValdiModuleArchive(const ValdiModuleArchive& other);
+    ValdiModuleArchive(ValdiModuleArchive&& other) noexcept;
     ~ValdiModuleArchive() override;
 
+    ValdiModuleArchive& operator=(const ValdiModuleArchive& other);
+    ValdiModuleArchive& operator=(ValdiModuleArchive&& other) noexcept;
+
+    /**
+     Returns the entry for the given path, pointing into the content of the archive.
+     On archives using the seekable format, only entries which were stored without
+     compression can be returned, getEntryBytes() must be used for the others.
+     */
     std::optional<ValdiModuleArchiveEntry> getEntry(const Valdi::StringBox& path) const;
     ValdiModuleArchiveEntry getEntryForIndex(size_t index) const;
 
+    /**
+     Returns the content of the entry for the given path. On archives using the
+     seekable format, only the requested entry is decompressed. Decompressed entries
+     are kept in a bounded cache, the returned BytesView retains its storage.
+     */
+    Result<BytesView> getEntryBytes(const Valdi::StringBox& path) const;
+    Result<BytesView> getEntryBytesForIndex(size_t index) const;
+
     bool containsEntry(const Valdi::StringBox& path) const;
 
     const std::vector<StringBox>& getAllEntryPaths() const;
 
+    /**
+     Returns the whole decompressed content of the archive.
+     Empty for archives using the seekable format, which are never fully decompressed.
+     */
     const BytesView& getDecompressedContent() const;
 
+    /**
+     Whether the archive was stored with independently compressed entries,
+     in which case entries are decompressed lazily.
+     */
+    bool isSeekable() const;
+
+    /**
+     Set the maximum amount of bytes of decompressed entries that should be kept
+     in the cache of a seekable archive.
+     */
+    void setDecompressedEntriesCacheSize(size_t maxSize);
+    size_t getDecompressedEntriesCacheSize() const;
+
+    /**
+     Decompress the archive from the given bytes. The bytes are borrowed by archives
+     which are not compressed as a whole, they must then outlive the returned archive.
+     The BytesView overload retains the source of the bytes instead.
+     */
     [[nodiscard]] static Result<ValdiModuleArchive> decompress(const Byte* data, size_t len);
+    [[nodiscard]] static Result<ValdiModuleArchive> decompress(const BytesView& data);
     [[nodiscard]] static Result<ValdiModuleArchive> deserialize(BytesView decompressedContent);
 
+    static bool isSeekableArchive(const Byte* data, size_t len);
+
+    /**
+     Serialize the given entries into the seekable archive format, where each entry
+     is compressed into its own zstd frame and can be decompressed independently
+     through an index stored at the head of the archive.
+     */
+    static Ref<ByteBuffer> serializeSeekable(const std::vector<ValdiArchiveEntry>& entries, int compressionLevel);
+
     bool operator==(const ValdiModuleArchive& other) const;
     bool operator!=(const ValdiModuleArchive& other) const;
 
 private:
+    class SeekableContent;
+
     BytesView _decompressedContent;
     FlatMap<StringBox, ValdiModuleArchiveEntry> _entries;
     std::vector<StringBox> _orderedEntryPaths;
+    Ref<SeekableContent> _seekableContent;
 
     ValdiModuleArchive(BytesView decompressedContent,
                        FlatMap<StringBox, ValdiModuleArchiveEntry> entries,
                        std::vector<StringBox> orderedEntryPaths);
+    ValdiModuleArchive(Ref<SeekableContent> seekableContent, std::vector<StringBox> orderedEntryPaths);
+
+    [[nodiscard]] static Result<ValdiModuleArchive> deserializeSeekable(const BytesView& content);
 };
 
 } // namespace Valdi
@@ -73,4 +73,35 @@ Result<Ref<ByteBuffer>> ZStdUtils::decompress(const Byte* input, size_t len) {
 
     return output;
 }
+
+Result<Ref<ByteBuffer>> ZStdUtils::decompressFrame(const Byte* input, size_t len, size_t decompressedSize) {
+    auto output = makeShared<ByteBuffer>();
+    output->resize(decompressedSize);
+
+    auto result = ZSTD_decompress(output->data(), decompressedSize, input, len);
+    if (ZSTD_isError(result) != 0) {
+        return Error(STRING_FORMAT("Could not decompress frame: {}", ZSTD_getErrorName(result)));
+    }
+    if (result != decompressedSize) {
+        return Error(STRING_FORMAT("Decompressed frame size mismatch, expected {} bytes got {}", decompressedSize, result));
+    }
+
+    return output;
+}
+
+Result<Ref<ByteBuffer>> ZStdUtils::compress(const Byte* input, size_t len, int compressionLevel) {
+    auto output = makeShared<ByteBuffer>();
+    output->resize(ZSTD_compressBound(len));
+
+    auto result = ZSTD_compress(output->data(), output->size(), input, len, compressionLevel);
+    if (ZSTD_isError(result) != 0) {
+        return Error(STRING_FORMAT("Could not compress: {}", ZSTD_getErrorName(result)));
+    }
+
+    output->resize(result);
+    output->shrinkToFit();
+
+    return output;
+}
+
 } // namespace Valdi
@@ -17,6 +17,12 @@ namespace Valdi {
 class ZStdUtils {
 public:
     [[nodiscard]] static Result<Ref<ByteBuffer>> decompress(const Byte* input, size_t len);
+    /**
+     Decompress a single zstd frame whose decompressed size is known upfront,
+     directly into a buffer of that size.
+     */
+    [[nodiscard]] static Result<Ref<ByteBuffer>> decompressFrame(const Byte* input, size_t len, size_t decompressedSize);
+    [[nodiscard]] static Result<Ref<ByteBuffer>> compress(const Byte* input, size_t len, int compressionLevel);
     static bool isZstdFile(const Byte* input, size_t length);
 };
 
@@ -43,7 +43,10 @@
 #include "valdi/runtime/ErrorCodes.hpp"
 #include "valdi/runtime/ValdiRuntimeTweaks.hpp"
 #include "valdi_core/cpp/Resources/ResourceId.hpp"
+#include "valdi_core/cpp/Threading/ParallelWorkerPool.hpp"
+#include "valdi_core/cpp/Threading/WorkerPoolDispatchQueue.hpp"
 #include "valdi_core/cpp/Utils/LoggerUtils.hpp"
+#include "valdi_core/cpp/Utils/PathUtils.hpp"
 #include "valdi_core/cpp/Utils/Trace.hpp"
 #include "valdi_core/cpp/Utils/ValueArrayBuilder.hpp"
 
@@ -65,6 +68,7 @@ Runtime::Runtime(AttributeIds& attributeIds,
                  const Ref<MainThreadManager>& mainThreadManager,
                  IJavaScriptBridge* jsBridge,
                  Ref<DispatchQueue> workerQueue,
+                 const Ref<WorkerPoolDispatchQueue>& workerPool,
                  ThreadQoSClass jsRuntimeThreadQoS,
                  const SharedAtomicObject<UserSession>& userSession,
                  const Shared<snap::valdi::Keychain>& keychain,
@@ -101,6 +105,7 @@ Runtime::Runtime(AttributeIds& attributeIds,
       _keychain(keychain),
       _yogaConfig(yogaConfig),
       _workerQueue(std::move(workerQueue)),
+      _workerPool(workerPool),
       _runtimeMessageHandler(runtimeMessageHandler),
       _logger(logger),
       _debuggerServiceEnabled(debuggerServiceEnabled),
@@ -152,7 +157,21 @@ void Runtime::postInit() {
     _viewNodeManager.setRuntime(weakRef(this));
     _contextManager.setListener(this);
 
+    if (enableConcurrentLazyLayout()) {
+        // The thread updating the tree participates in the work
+        auto threadsCount = std::max(WorkerPoolDispatchQueue::getDefaultWorkersCount(), static_cast<size_t>(2)) - 1;
+        _viewNodeManager.setLayoutWorkerPool(
+            makeShared<ParallelWorkerPool>(STRING_LITERAL("Valdi Layout"), ThreadQoSClassHigh, threadsCount));
+    }
+
     if (_javaScriptRuntime != nullptr) {
+        if (_diskCache != nullptr && enableJsBytecodeCache()) {
+            _javaScriptRuntime->setBytecodeDiskCache(_diskCache->scopedCache(Path("js_bytecode_cache"), false),
+                                                     _workerQueue);
+        }
+        if (_diskCache != nullptr) {
+            _javaScriptRuntime->setHeapDumpDiskCache(_diskCache->scopedCache(Path("js_heap_dumps"), false));
+        }
         _javaScriptRuntime->postInit();
 
         if (_diskCache != nullptr) {
@@ -162,7 +181,8 @@ void Runtime::postInit() {
         registerNativeModuleFactory(makeShared<FileSystemFactory>().toShared());
         registerNativeModuleFactory(makeShared<AttributedTextNativeModuleFactory>(_colorPalette, *_logger).toShared());
 
-        registerJavaScriptModuleFactory(makeShared<ProtobufModuleFactory>(*_resourceManager, _workerQueue, *_logger));
+        registerJavaScriptModuleFactory(
+            makeShared<ProtobufModuleFactory>(*_resourceManager, _workerQueue, _workerPool, *_logger));
         registerJavaScriptModuleFactory(makeShared<UnicodeModuleFactory>());
 
         if constexpr (kTCPSocketEnabled) {
@@ -489,6 +509,24 @@ void Runtime::runWithExclusiveJsThreadLock(DispatchFunction&& cb) {
     }
 }
 
+bool Runtime::enableJsBytecodeCache() {
+    const auto& runtimeTweaks = getRuntimeTweaks();
+    if (runtimeTweaks == NULL) {
+        return false;
+    }
+
+    return runtimeTweaks->enableJsBytecodeCache();
+}
+
+bool Runtime::enableConcurrentLazyLayout() {
+    const auto& runtimeTweaks = getRuntimeTweaks();
+    if (runtimeTweaks == NULL) {
+        return false;
+    }
+
+    return runtimeTweaks->enableConcurrentLazyLayout();
+}
+
 bool Runtime::disablePersistentStoreEncryption() {
     const auto& runtimeTweaks = getRuntimeTweaks();
     if (runtimeTweaks == NULL) {
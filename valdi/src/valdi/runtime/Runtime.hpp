@@ -58,6 +58,7 @@ class ModuleFactory;
 namespace Valdi {
 
 class IDiskCache;
+class WorkerPoolDispatchQueue;
 class IResourceLoader;
 class JavaScriptModuleFactory;
 
@@ -83,6 +84,7 @@ public:
             const Ref<MainThreadManager>& mainThreadManager,
             IJavaScriptBridge* jsBridge,
             Ref<DispatchQueue> workerQueue,
+            const Ref<WorkerPoolDispatchQueue>& workerPool,
             ThreadQoSClass jsRuntimeThreadQoS,
             const SharedAtomicObject<UserSession>& userSession,
             const Shared<snap::valdi::Keychain>& keychain,
@@ -316,6 +318,7 @@ private:
 
     Shared<YGConfig> _yogaConfig;
     Ref<DispatchQueue> _workerQueue;
+    Ref<WorkerPoolDispatchQueue> _workerPool;
     Shared<snap::valdi::RuntimeMessageHandler> _runtimeMessageHandler;
 
     Ref<ILogger> _logger;
@@ -346,6 +349,8 @@ private:
 
     void runWithExclusiveJsThreadLock(DispatchFunction&& cb);
     bool disablePersistentStoreEncryption();
+    bool enableJsBytecodeCache();
+    bool enableConcurrentLazyLayout();
 };
 
 } // namespace Valdi
@@ -17,16 +17,20 @@
 
 #include "valdi/runtime/JavaScript/JavaScriptANRDetector.hpp"
 
+#include "valdi_core/cpp/Utils/ByteBuffer.hpp"
 #include "valdi_core/cpp/Utils/ContainerUtils.hpp"
+#include "valdi_core/cpp/Utils/ObjectPool.hpp"
 
 #include "valdi/runtime/Debugger/DebuggerService.hpp"
 #include "valdi/runtime/Interfaces/IDiskCache.hpp"
 #include "valdi/runtime/Metrics/Metrics.hpp"
+#include "valdi/runtime/Utils/RecyclingAllocator.hpp"
 #include "valdi/runtime/Utils/ShutdownUtils.hpp"
 #include "valdi/runtime/Views/GlobalViewFactories.hpp"
 #include "valdi/runtime/Views/ViewPreloader.hpp"
 #include "valdi_core/cpp/JavaScript/ModuleFactoryRegistry.hpp"
 #include "valdi_core/cpp/Threading/DispatchQueue.hpp"
+#include "valdi_core/cpp/Threading/WorkerPoolDispatchQueue.hpp"
 
 #include "valdi_core/ModuleFactoriesProvider.hpp"
 #include "valdi_core/cpp/Utils/LoggerUtils.hpp"
@@ -125,7 +129,17 @@ RuntimeManager::RuntimeManager(const Ref<IMainThreadDispatcher>& mainThreadDispa
       _jsThreadQoS(jsThreadQoS),
       _debuggerServiceEnabled(_debuggerService != nullptr) {
     _mainThreadManager->postInit();
+#if __APPLE__
+    // Work dispatched on the worker queue relies on the autorelease pools managed by GCD
     _workerQueue = DispatchQueue::create(STRING_LITERAL("Valdi Worker Thread"), ThreadQoSClassHigh);
+#else
+    _workerPool = makeShared<WorkerPoolDispatchQueue>(STRING_LITERAL("Valdi Worker Thread"),
+                                                      ThreadQoSClassHigh,
+                                                      WorkerPoolDispatchQueue::getDefaultWorkersCount());
+    // Users of the worker queue rely on their tasks running one at a time and in order.
+    // Independent jobs, like protobuf and image decoding, are dispatched on the pool directly.
+    _workerQueue = _workerPool->createSerialQueue(ThreadQoSClassHigh);
+#endif
     _anrDetector = makeShared<JavaScriptANRDetector>(_logger);
     if (runtimeMessageHandler != nullptr) {
         _anrDetector->setListener(makeShared<ANRDetectorListener>(runtimeMessageHandler));
@@ -159,6 +173,9 @@ void RuntimeManager::fullTeardown() {
     }
     _mainThreadManager->clearAndTeardown();
     _workerQueue->flushAndTeardown();
+    if (_workerPool != nullptr) {
+        _workerPool->flushAndTeardown();
+    }
     _debuggerService = nullptr;
 }
 
@@ -172,6 +189,7 @@ SharedRuntime RuntimeManager::createRuntime(const Shared<IResourceLoader>& resou
                                                                                      _mainThreadManager,
                                               _jsBridge,
                                               _workerQueue,
+                                              _workerPool,
                                               _jsThreadQoS,
                                               _userSession,
                                               _keychain,
@@ -334,6 +352,10 @@ void RuntimeManager::applicationIsLowInMemory() {
     for (const auto& runtime : getAllRuntimes()) {
         runtime->removeUnusedResources();
     }
+    // Buffers and ViewNode blocks kept around by previous renders
+    ObjectPool<ByteBuffer>::get().clear();
+    ObjectPool<std::vector<Value>>::get().clear();
+    BlockRecyclerBase::trimAll();
 }
 
 void RuntimeManager::applicationWillTerminate() {
@@ -400,6 +422,10 @@ const Ref<DispatchQueue>& RuntimeManager::getWorkerQueue() const {
     return _workerQueue;
 }
 
+const Ref<WorkerPoolDispatchQueue>& RuntimeManager::getWorkerPool() const {
+    return _workerPool;
+}
+
 const Ref<AssetLoaderManager>& RuntimeManager::getAssetLoaderManager() const {
     return _assetLoaderManager;
 }
@@ -37,6 +37,7 @@ namespace Valdi {
 
 class ViewPreloader;
 class DispatchQueue;
+class WorkerPoolDispatchQueue;
 class IDiskCache;
 class IResourceLoader;
 class DebuggerService;
@@ -100,6 +101,13 @@ public:
 
     const Ref<DispatchQueue>& getWorkerQueue() const;
 
+    /**
+     Returns the pool of worker threads backing the worker queue, on which work which is safe
+     to run concurrently can be dispatched. Returns null on platforms where the worker queue
+     is not backed by a pool.
+     */
+    const Ref<WorkerPoolDispatchQueue>& getWorkerPool() const;
+
     void setRequestManager(const Shared<snap::valdi_core::HTTPRequestManager>& requestManager);
 
     const Ref<AssetLoaderManager>& getAssetLoaderManager() const;
@@ -176,6 +184,7 @@ private:
     IJavaScriptBridge* _jsBridge;
 
     Ref<DispatchQueue> _workerQueue;
+    Ref<WorkerPoolDispatchQueue> _workerPool;
     Ref<IDiskCache> _diskCache;
     Shared<snap::valdi::Keychain> _keychain;
     Shared<snap::valdi::RuntimeMessageHandler> _runtimeMessageHandler;
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "utils/base/NonCopyable.hpp"
+#include "utils/debugging/Assert.hpp"
+
+#include <array>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace Valdi {
+
+/**
+ Allocates objects of a single type from slots owned by the pool, instead of making
+ one heap allocation per object. The first objects are allocated from slots stored
+ inline in the pool, the following ones from heap blocks which double in size as the
+ pool grows. Released slots are reused before a new block is allocated. Objects never
+ move once allocated. The pool is not thread safe, and all the objects must be destroyed
+ before the pool.
+ */
+template<typename T, size_t kInlineCapacity = 1, size_t kFirstBlockCapacity = 2>
+class ObjectBlockPool : public snap::NonCopyable {
+public:
+    ObjectBlockPool() = default;
+
+    ~ObjectBlockPool() {
+        SC_ASSERT(_liveObjectsCount == 0, "Objects must be destroyed before their pool");
+
+        auto* block = _lastBlock;
+        while (block != nullptr) {
+            auto* previous = block->previous;
+            block->~Block();
+            ::operator delete(block);
+            block = previous;
+        }
+    }
+
+    template<typename... Args>
+    T* make(Args&&... args) {
+        auto* slot = allocateSlot();
+        auto* object = new (slot->storage) T(std::forward<Args>(args)...);
+        _liveObjectsCount++;
+        return object;
+    }
+
+    void destroy(T* object) {
+        object->~T();
+        auto* slot = reinterpret_cast<Slot*>(object);
+        slot->nextFree = _freeList;
+        _freeList = slot;
+        _liveObjectsCount--;
+    }
+
+    size_t getLiveObjectsCount() const {
+        return _liveObjectsCount;
+    }
+
+    /**
+     Returns the number of bytes allocated on the heap by the pool for its blocks.
+     */
+    size_t getAllocatedBytes() const {
+        size_t bytes = 0;
+        for (const auto* block = _lastBlock; block != nullptr; block = block->previous) {
+            bytes += sizeof(Block) + block->capacity * sizeof(Slot);
+        }
+        return bytes;
+    }
+
+private:
+    union Slot {
+        Slot* nextFree;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    // Header of a heap block, immediately followed by its slots
+    struct alignas(Slot) Block {
+        Block* previous;
+        size_t capacity;
+
+        Slot* slots() {
+            return reinterpret_cast<Slot*>(this + 1);
+        }
+    };
+
+    std::array<Slot, kInlineCapacity> _inlineSlots;
+    size_t _inlineSlotsSize = 0;
+    Block* _lastBlock = nullptr;
+    size_t _lastBlockSize = 0;
+    Slot* _freeList = nullptr;
+    size_t _liveObjectsCount = 0;
+
+    Slot* allocateSlot() {
+        if (_freeList != nullptr) {
+            auto* slot = _freeList;
+            _freeList = slot->nextFree;
+            return slot;
+        }
+
+        if (_inlineSlotsSize < kInlineCapacity) {
+            return &_inlineSlots[_inlineSlotsSize++];
+        }
+
+        if (_lastBlock == nullptr || _lastBlockSize == _lastBlock->capacity) {
+            auto capacity = _lastBlock == nullptr ? kFirstBlockCapacity : _lastBlock->capacity * 2;
+            auto* memory = ::operator new(sizeof(Block) + capacity * sizeof(Slot));
+            _lastBlock = new (memory) Block{_lastBlock, capacity};
+            _lastBlockSize = 0;
+        }
+
+        return &_lastBlock->slots()[_lastBlockSize++];
+    }
+};
+
+} // namespace Valdi
@@ -0,0 +1,29 @@
+#include "valdi/runtime/Utils/RecyclingAllocator.hpp"
+
+namespace Valdi {
+
+struct BlockRecyclersRegistry {
+    Mutex mutex;
+    std::vector<BlockRecyclerBase*> recyclers;
+
+    static BlockRecyclersRegistry& get() {
+        static auto* kInstance = new BlockRecyclersRegistry();
+        return *kInstance;
+    }
+};
+
+void BlockRecyclerBase::trimAll() {
+    auto& registry = BlockRecyclersRegistry::get();
+    std::lock_guard<Mutex> lock(registry.mutex);
+    for (auto* recycler : registry.recyclers) {
+        recycler->trim();
+    }
+}
+
+void BlockRecyclerBase::registerRecycler(BlockRecyclerBase* recycler) {
+    auto& registry = BlockRecyclersRegistry::get();
+    std::lock_guard<Mutex> lock(registry.mutex);
+    registry.recyclers.emplace_back(recycler);
+}
+
+} // namespace Valdi
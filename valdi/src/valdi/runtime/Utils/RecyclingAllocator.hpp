@@ -0,0 +1,162 @@
+#pragma once
+
+#include "utils/base/NonCopyable.hpp"
+#include "valdi_core/cpp/Utils/Mutex.hpp"
+#include "valdi_core/cpp/Utils/Shared.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Valdi {
+
+/**
+ Base of the BlockRecycler of every size class, which allows to release
+ the recycled blocks of all of them at once.
+ */
+class BlockRecyclerBase : public snap::NonCopyable {
+public:
+    virtual ~BlockRecyclerBase() = default;
+
+    /**
+     Releases the recycled blocks back to the general heap.
+     */
+    virtual void trim() = 0;
+
+    /**
+     Releases the recycled blocks of every size class, typically when
+     the application is low in memory.
+     */
+    static void trimAll();
+
+protected:
+    static void registerRecycler(BlockRecyclerBase* recycler);
+};
+
+/**
+ Thread safe free list of memory blocks of a single size class. Blocks that are
+ deallocated are kept for the next allocation, up to kMaxRecycledBlocks, instead of
+ going back to the general heap.
+ */
+template<size_t kSize, size_t kAlignment>
+class BlockRecycler : public BlockRecyclerBase {
+public:
+    static constexpr size_t kMaxRecycledBlocks = 1024;
+
+    static_assert(kAlignment <= alignof(std::max_align_t), "Over-aligned types are not supported");
+
+    static BlockRecycler& get() {
+        static auto* kInstance = []() {
+            auto* recycler = new BlockRecycler();
+            registerRecycler(recycler);
+            return recycler;
+        }();
+        return *kInstance;
+    }
+
+    void* allocate() {
+        {
+            std::lock_guard<Mutex> lock(_mutex);
+            if (!_blocks.empty()) {
+                auto* block = _blocks.back();
+                _blocks.pop_back();
+                return block;
+            }
+        }
+
+        return ::operator new(kSize);
+    }
+
+    void deallocate(void* block) {
+        {
+            std::lock_guard<Mutex> lock(_mutex);
+            if (_blocks.size() < kMaxRecycledBlocks) {
+                _blocks.emplace_back(block);
+                return;
+            }
+        }
+
+        ::operator delete(block);
+    }
+
+    void trim() override {
+        std::vector<void*> blocks;
+        {
+            std::lock_guard<Mutex> lock(_mutex);
+            blocks = std::move(_blocks);
+            _blocks = std::vector<void*>();
+        }
+
+        for (auto* block : blocks) {
+            ::operator delete(block);
+        }
+    }
+
+    size_t getRecycledBlocksCount() {
+        std::lock_guard<Mutex> lock(_mutex);
+        return _blocks.size();
+    }
+
+private:
+    Mutex _mutex;
+    std::vector<void*> _blocks;
+
+    BlockRecycler() = default;
+};
+
+/**
+ Standard allocator which takes single objects from the BlockRecycler of their size class.
+ Used with std::allocate_shared, it makes the object and its control block come from
+ recycled memory.
+ */
+template<typename T>
+class RecyclingAllocator {
+public:
+    using value_type = T;
+
+    RecyclingAllocator() noexcept = default;
+
+    template<typename U>
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    RecyclingAllocator(const RecyclingAllocator<U>& /*other*/) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n != 1) {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T*>(BlockRecycler<sizeof(T), alignof(T)>::get().allocate());
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        if (n != 1) {
+            std::allocator<T>().deallocate(ptr, n);
+            return;
+        }
+        BlockRecycler<sizeof(T), alignof(T)>::get().deallocate(ptr);
+    }
+
+    template<typename U>
+    bool operator==(const RecyclingAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const RecyclingAllocator<U>& /*other*/) const noexcept {
+        return false;
+    }
+};
+
+/**
+ Same as makeShared(), but the object is allocated through a RecyclingAllocator.
+ */
+template<typename T,
+         typename std::enable_if<std::is_convertible<T*, SharedPtrRefCountable*>::value, int>::type = 0,
+         typename... Args>
+inline Ref<T> makeRecycledShared(Args&&... args) {
+    return Ref<T>(std::allocate_shared<T>(RecyclingAllocator<T>(), std::forward<Args>(args)...));
+}
+
+} // namespace Valdi
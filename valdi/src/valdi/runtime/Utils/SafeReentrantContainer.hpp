@@ -112,6 +112,10 @@ public:
         return SafeReentrantContainerIterator(this, _mutationId, _container.find(key));
     }
 
+    const T& getContainer() const {
+        return _container;
+    }
+
     auto begin() {
         return SafeReentrantContainerIterator(this, _mutationId, _container.begin());
     }
@@ -59,6 +59,14 @@ bool ValdiRuntimeTweaks::disablePersistentStoreEncryption() const {
     return getConfigKey("VALDI_DISABLE_PERSISTENT_STORE_ENCRYPTION");
 }
 
+bool ValdiRuntimeTweaks::enableJsBytecodeCache() const {
+    return getConfigKey("VALDI_ENABLE_JS_BYTECODE_CACHE");
+}
+
+bool ValdiRuntimeTweaks::enableConcurrentLazyLayout() const {
+    return getConfigKey("VALDI_ENABLE_CONCURRENT_LAZY_LAYOUT");
+}
+
 bool ValdiRuntimeTweaks::enableTSNForModule(const StringBox& moduleName) const {
     auto const key = StringCache::getGlobal().makeStringFromLiteral(std::string_view("VALDI_TSN_ENABLED_MODULES"));
     auto const fallback = Value(makeShared<ValueTypedArray>(TypedArrayType::Uint8Array, Valdi::BytesView()));
@@ -31,6 +31,8 @@ public:
     bool shouldNudgeJSThread() const;
     bool disablePersistentStoreEncryption() const;
     bool skipProtoIndex() const;
+    bool enableJsBytecodeCache() const;
+    bool enableConcurrentLazyLayout() const;
 
 private:
     Shared<ITweakValueProvider> _tweakValueProvider;
@@ -24,4 +24,13 @@ Size DefaultMeasureDelegate::measure(
     return onMeasure(layoutAttributes.value(), width, widthMode, height, heightMode, viewNode.isRightToLeft());
 }
 
+Size DefaultMeasureDelegate::measureWithLayoutAttributes(const Ref<ValueMap>& layoutAttributes,
+                                                         float width,
+                                                         MeasureMode widthMode,
+                                                         float height,
+                                                         MeasureMode heightMode,
+                                                         bool isRightToLeft) {
+    return onMeasure(layoutAttributes, width, widthMode, height, heightMode, isRightToLeft);
+}
+
 } // namespace Valdi
@@ -20,6 +20,13 @@ public:
 
     Size measure(ViewNode& viewNode, float width, MeasureMode widthMode, float height, MeasureMode heightMode) final;
 
+    Size measureWithLayoutAttributes(const Ref<ValueMap>& layoutAttributes,
+                                     float width,
+                                     MeasureMode widthMode,
+                                     float height,
+                                     MeasureMode heightMode,
+                                     bool isRightToLeft) final;
+
     virtual Valdi::Size onMeasure(const Valdi::Ref<Valdi::ValueMap>& attributes,
                                   float width,
                                   Valdi::MeasureMode widthMode,
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "valdi_core/cpp/Utils/Shared.hpp"
+#include "valdi_core/cpp/Utils/ValueMap.hpp"
 
 #include "valdi/runtime/Views/Frame.hpp"
 #include "valdi/runtime/Views/Measure.hpp"
@@ -20,6 +21,32 @@ class MeasureDelegate : public SimpleRefCountable {
 public:
     virtual Size measure(
         ViewNode& viewNode, float width, MeasureMode widthMode, float height, MeasureMode heightMode) = 0;
+
+    /**
+     Returns whether the delegate can measure from a layout worker thread, concurrently with
+     other measure calls on different ViewNodes, through measureWithLayoutAttributes().
+     The layout attributes are resolved on the thread owning the tree before the concurrent
+     layout pass starts, as the attribute processors are not thread safe. Delegates which need
+     the ViewNode or must measure on a specific thread, like the main thread, should return false,
+     in which case the lazy layout subtrees containing nodes measured by this delegate are
+     calculated on the owning thread.
+     */
+    virtual bool canMeasureConcurrently() const {
+        return false;
+    }
+
+    /**
+     Measure from the given layout attributes, as returned by ViewNode::copyProcessedViewLayoutAttributes().
+     Only called when canMeasureConcurrently() returns true, the implementation must be thread safe.
+     */
+    virtual Size measureWithLayoutAttributes(const Ref<ValueMap>& /*layoutAttributes*/,
+                                             float /*width*/,
+                                             MeasureMode /*widthMode*/,
+                                             float /*height*/,
+                                             MeasureMode /*heightMode*/,
+                                             bool /*isRightToLeft*/) {
+        return Size();
+    }
 };
 
 } // namespace Valdi
@@ -141,18 +141,52 @@ void ImageLoader::loadImageFromBytes(const Ref<ImageLoaderTask>& task, const Val
         return;
     }
 
-    auto result = Image::make(bytes);
+    Valdi::Ref<Valdi::DispatchQueue> decodeQueue;
+    {
+        std::lock_guard<Valdi::Mutex> guard(_mutex);
+        decodeQueue = _decodeQueue;
+    }
+
+    if (decodeQueue == nullptr) {
+        handleImageDecodeResult(task, Image::make(bytes));
+        return;
+    }
+
+    // Decoding doesn't touch the cache, the result is inserted back on the loader queue
+    decodeQueue->async([task, bytes]() {
+        if (task->wasCanceled()) {
+            return;
+        }
+
+        auto result = Image::make(bytes);
+
+        if (auto strongThis = task->getImageLoader().lock()) {
+            strongThis->_queue->async([task, result = std::move(result)]() {
+                if (auto strongThis = task->getImageLoader().lock()) {
+                    strongThis->handleImageDecodeResult(task, result);
+                }
+            });
+        }
+    });
+}
+
+void ImageLoader::handleImageDecodeResult(const Ref<ImageLoaderTask>& task, const Valdi::Result<Ref<Image>>& result) {
     if (!result) {
         handleImageLoadResult(task, result.error());
         return;
     }
 
-    imgResult = _cache.setCachedItemAndGetResizedImage(
+    auto imgResult = _cache.setCachedItemAndGetResizedImage(
         task->getUrl(), result.value(), task->getPreferredWidth(), task->getPreferredHeight());
 
     handleImageLoadResult(task, imgResult);
 }
 
+void ImageLoader::setDecodeQueue(const Valdi::Ref<Valdi::DispatchQueue>& decodeQueue) {
+    std::lock_guard<Valdi::Mutex> guard(_mutex);
+    _decodeQueue = decodeQueue;
+}
+
 void ImageLoader::setReclamationInterval(size_t expirationTime) {
     std::unique_lock<Valdi::Mutex> guard(_mutex);
     auto previousExpirationTime = _reclamationInterval;
@@ -33,6 +33,12 @@ public:
 
     void setReclamationInterval(size_t expirationTime);
 
+    /**
+     Set a queue on which images are decoded, which can run tasks concurrently.
+     Images are decoded on the loader queue when not set.
+     */
+    void setDecodeQueue(const Valdi::Ref<Valdi::DispatchQueue>& decodeQueue);
+
     Valdi::Shared<snap::valdi_core::Cancelable> loadAsset(const Valdi::StringBox& url,
                                                           int32_t preferredWidth,
                                                           int32_t preferredHeight,
@@ -43,6 +49,7 @@ public:
 private:
     mutable Valdi::Mutex _mutex;
     Valdi::Ref<Valdi::DispatchQueue> _queue;
+    Valdi::Ref<Valdi::DispatchQueue> _decodeQueue;
     [[maybe_unused]] Valdi::ILogger& _logger;
     ImageCache _cache;
 
@@ -56,6 +63,8 @@ private:
 
     void loadImageFromBytes(const Ref<ImageLoaderTask>& task, const Valdi::BytesView& bytes);
 
+    void handleImageDecodeResult(const Ref<ImageLoaderTask>& task, const Valdi::Result<Ref<Image>>& result);
+
     void scheduleReclamation();
 };
 
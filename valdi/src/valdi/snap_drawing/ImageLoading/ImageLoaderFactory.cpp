@@ -26,9 +26,11 @@ Valdi::Ref<ImageLoader> createImageLoader(const Valdi::Ref<Valdi::DispatchQueue>
 void registerAssetLoaders(Valdi::AssetLoaderManager& assetLoaderManager,
                           const Ref<Resources>& resources,
                           const Valdi::Ref<Valdi::DispatchQueue>& queue,
+                          const Valdi::Ref<Valdi::DispatchQueue>& decodeQueue,
                           Valdi::ILogger& logger,
                           uint64_t maxCacheSizeInBytes) {
     auto imageLoader = createImageLoader(queue, logger, maxCacheSizeInBytes);
+    imageLoader->setDecodeQueue(decodeQueue);
 
     assetLoaderManager.registerAssetLoaderFactory(imageLoader);
     assetLoaderManager.registerAssetLoaderFactory(Valdi::makeShared<AnimatedImageLoaderFactory>(resources));
@@ -29,6 +29,7 @@ Ref<ImageLoader> createImageLoader(const Valdi::Ref<Valdi::DispatchQueue>& queue
 void registerAssetLoaders(Valdi::AssetLoaderManager& assetLoaderManager,
                           const Ref<Resources>& resources,
                           const Valdi::Ref<Valdi::DispatchQueue>& queue,
+                          const Valdi::Ref<Valdi::DispatchQueue>& decodeQueue,
                           Valdi::ILogger& logger,
                           uint64_t maxCacheSizeInBytes);
 
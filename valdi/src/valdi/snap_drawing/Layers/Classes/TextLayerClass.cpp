@@ -7,6 +7,7 @@
 
 #include "valdi/snap_drawing/Layers/Classes/TextLayerClass.hpp"
 #include "snap_drawing/cpp/Resources.hpp"
+#include "snap_drawing/cpp/Text/TextLayoutCache.hpp"
 #include "valdi/snap_drawing/Utils/AttributedTextParser.hpp"
 #include "valdi/snap_drawing/Utils/AttributesBinderUtils.hpp"
 #include "valdi_core/cpp/Attributes/TextAttributeValue.hpp"
@@ -65,6 +66,8 @@ Size TextLayerClass::onMeasure(const Valdi::Value& attributes, Size maxSize, boo
         textOverflow = TextOverflowClip;
     }
 
+    // textAlign and textDecoration don't invalidate the layout, the text is always measured left aligned
+    // without decoration. The layer only reuses the measured layout when it draws with the same parameters.
     auto textSize = TextLayer::measureText(scaledMaxSize,
                                            resolvedText,
                                            resolvedAttributedText,
@@ -75,17 +78,22 @@ Size TextLayerClass::onMeasure(const Valdi::Value& attributes, Size maxSize, boo
                                            resolvedNumberOfLines,
                                            static_cast<Scalar>(resolvedLineHeight),
                                            static_cast<Scalar>(resolvedLetterSpacing),
-                                           false,
+                                           isRightToLeft,
                                            adjustsFontSizeToFitWidth.toBool(),
                                            minimumScaleFactor.toDouble(),
                                            respectDynamicType,
                                            displayScale,
                                            dynamicTypeScale,
-                                           fontManager);
+                                           fontManager,
+                                           getResources()->getTextLayoutCache());
 
     return Size::make(textSize.width / displayScale, textSize.height / displayScale);
 }
 
+bool TextLayerClass::canMeasureConcurrently() const {
+    return true;
+}
+
 void TextLayerClass::bindAttributes(Valdi::AttributesBindingContext& binder) {
     std::vector<snap::valdi_core::CompositeAttributePart> parts;
     parts.emplace_back(STRING_LITERAL("fontSize"), snap::valdi_core::AttributeType::Double, true, true);
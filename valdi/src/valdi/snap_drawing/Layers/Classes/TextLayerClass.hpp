@@ -22,6 +22,13 @@ public:
 
     Size onMeasure(const Valdi::Value& attributes, Size maxSize, bool isRightToLeft) override;
 
+    /**
+     Text measurement only reads the already resolved layout attributes and goes through
+     the FontManager, the TextLayoutCache and the Font lazy state, which are all synchronized.
+     The font attribute preprocessor, which is not thread safe, runs before the measurement.
+     */
+    bool canMeasureConcurrently() const override;
+
     void bindAttributes(Valdi::AttributesBindingContext& binder) override;
 
     DECLARE_TEXT_ATTRIBUTE(TextLayer, value)
@@ -59,11 +59,17 @@ void Runtime::initializeViewManager(Valdi::PlatformType platformType) {
 }
 
 void Runtime::registerAssetLoaders(Valdi::AssetLoaderManager& assetLoaderManager) {
+    registerAssetLoaders(assetLoaderManager, nullptr);
+}
+
+void Runtime::registerAssetLoaders(Valdi::AssetLoaderManager& assetLoaderManager,
+                                   const Valdi::Ref<Valdi::DispatchQueue>& decodeQueue) {
     auto& logger = _resources->getLogger();
     auto queue =
         Valdi::DispatchQueue::create(STRING_LITERAL("com.snap.valdi.ImageLoader"), Valdi::ThreadQoSClassNormal);
 
-    snap::drawing::registerAssetLoaders(assetLoaderManager, _resources, queue, logger, _maxCacheSizeInBytes);
+    snap::drawing::registerAssetLoaders(
+        assetLoaderManager, _resources, queue, decodeQueue, logger, _maxCacheSizeInBytes);
 }
 
 const Ref<IFrameScheduler>& Runtime::getFrameScheduler() const {
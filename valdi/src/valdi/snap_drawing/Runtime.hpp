@@ -50,6 +50,13 @@ public:
 
     void registerAssetLoaders(Valdi::AssetLoaderManager& assetLoaderManager);
 
+    /**
+     Register the asset loaders, decoding the images on the given queue when it is not null.
+     The queue can run its tasks concurrently.
+     */
+    void registerAssetLoaders(Valdi::AssetLoaderManager& assetLoaderManager,
+                              const Valdi::Ref<Valdi::DispatchQueue>& decodeQueue);
+
     const Ref<IFrameScheduler>& getFrameScheduler() const;
 
     const Ref<SnapDrawingViewManager>& getViewManager() const;
@@ -101,6 +101,10 @@ bool InMemoryDiskCache::exists(const Path& path) {
     return _cache->entries.find(fileKey) != _cache->entries.end();
 }
 
+bool InMemoryDiskCache::supportsIncrementalAppend() const {
+    return true;
+}
+
 bool InMemoryDiskCache::remove(const Path& path) {
     return removeForAbsolutePath(toAbsolutePath(path));
 }
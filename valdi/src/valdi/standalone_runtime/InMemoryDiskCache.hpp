@@ -39,6 +39,11 @@ public:
 
     bool remove(const Path& path) override;
 
+    /**
+     Nothing is written to disk, so appending by copying the item in memory is acceptable.
+     */
+    bool supportsIncrementalAppend() const override;
+
     StringBox getAbsoluteURL(const Path& path) const override;
 
     bool removeForAbsolutePath(const Path& absolutePath);
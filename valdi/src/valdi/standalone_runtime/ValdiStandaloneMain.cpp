@@ -7,6 +7,7 @@
 
 #include "valdi/standalone_runtime/ValdiStandaloneMain.hpp"
 #include "valdi/runtime/Interfaces/ITweakValueProvider.hpp"
+#include "valdi/runtime/Resources/DiskCacheImpl.hpp"
 #include "valdi/runtime/Runtime.hpp"
 #include "valdi/runtime/RuntimeManager.hpp"
 #include "valdi/standalone_runtime/Arguments.hpp"
@@ -60,6 +61,14 @@ Ref<ValdiStandaloneRuntime> createValdiStandaloneRuntime(const StandaloneArgumen
         tweakValueProvider->config.setMapValue(StringBox::fromCString("VALDI_ENABLE_TSN"), Value(true));
     }
 
+    Ref<IDiskCache> diskCache;
+    if (!arguments.jsBytecodeCacheDirectory.isEmpty()) {
+        tweakValueProvider->config.setMapValue(StringBox::fromCString("VALDI_ENABLE_JS_BYTECODE_CACHE"), Value(true));
+        diskCache = Valdi::makeShared<DiskCacheImpl>(arguments.jsBytecodeCacheDirectory);
+    } else {
+        diskCache = Valdi::makeShared<InMemoryDiskCache>();
+    }
+
     auto runtime = ValdiStandaloneRuntime::create(arguments.enableDebuggerService,
                                                   !arguments.enableHotReloader,
                                                   false,
@@ -67,7 +76,7 @@ Ref<ValdiStandaloneRuntime> createValdiStandaloneRuntime(const StandaloneArgumen
                                                   false,
                                                   arguments.jsBridge,
                                                   mainQueue,
-                                                  Valdi::makeShared<InMemoryDiskCache>(),
+                                                  diskCache,
                                                   nullptr,
                                                   resourceLoader,
                                                   tweakValueProvider.toShared());
@@ -33,6 +33,9 @@ struct StandaloneArguments {
     bool enableDebuggerService = false;
     bool enableHotReloader = false;
     bool enableTSN = false;
+    // When set, the runtime uses a disk cache at this path instead of an in memory one,
+    // and persists the JS bytecode it compiles so that subsequent launches can reuse it.
+    StringBox jsBytecodeCacheDirectory;
 };
 
 Ref<ValdiStandaloneRuntime> createValdiStandaloneRuntime(const StandaloneArguments& arguments);
@@ -24,6 +24,7 @@
 #include "valdi/standalone_runtime/StandaloneView.hpp"
 #include "valdi/standalone_runtime/StandaloneViewManager.hpp"
 #include "valdi_core/ModuleFactory.hpp"
+#include "valdi_core/cpp/Threading/WorkerPoolDispatchQueue.hpp"
 #include "valdi_core/cpp/Utils/ConsoleLogger.hpp"
 #include "valdi_core/cpp/Utils/DiskUtils.hpp"
 #include "valdi_core/cpp/Utils/LoggerUtils.hpp"
@@ -71,7 +72,7 @@ void registerSnapDrawingModuleFactoriesProvider(RuntimeManager& runtimeManager)
 
         auto runtimeManager = weakRuntimeManager.lock();
         if (runtimeManager != nullptr) {
-            runtime->registerAssetLoaders(*runtimeManager->getAssetLoaderManager());
+            runtime->registerAssetLoaders(*runtimeManager->getAssetLoaderManager(), runtimeManager->getWorkerPool());
             runtime->getFontManager()->setListener(
                 makeShared<snap::drawing::FontResolverWithRuntimeManager>(runtimeManager));
         }
@@ -79,6 +79,9 @@ int main(int argc, const char** argv) {
     auto engineArgument = parser.addArgument("--js_engine")
                               ->setDescription("The JavaScript engine to use")
                               ->setChoices({"auto", "quickjs", "jscore", "v8", "hermes", "quickjs_tsn"});
+    auto bytecodeCacheDirArgument =
+        parser.addArgument("--js_bytecode_cache_dir")
+            ->setDescription("Directory where the JS bytecode compiled on device should be cached between runs");
 
     Valdi::Arguments arguments(argc, argv);
     arguments.next(); // skip the executable path
@@ -114,6 +117,9 @@ int main(int argc, const char** argv) {
         }
     }
     standaloneArguments.jsBridge = Valdi::JavaScriptBridge::get(engineType);
+    if (bytecodeCacheDirArgument->hasValue()) {
+        standaloneArguments.jsBytecodeCacheDirectory = bytecodeCacheDirArgument->value();
+    }
 
     snap::utils::time::StopWatch sw;
     sw.start();
@@ -0,0 +1,123 @@
+#include "valdi/runtime/Attributes/AttributeIds.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <mutex>
+
+using namespace Valdi;
+
+namespace {
+
+constexpr size_t kNamesCount = 256;
+
+/**
+ The previous registry, where every lookup takes the mutex.
+ */
+class MutexAttributeIds {
+public:
+    AttributeId getIdForName(const StringBox& name) {
+        std::lock_guard<std::mutex> guard(_mutex);
+        const auto& it = _idForName.find(name);
+        if (it != _idForName.end()) {
+            return it->second;
+        }
+
+        auto id = _attributes.size();
+        _attributes.emplace_back(name);
+        _idForName[name] = id;
+        return id;
+    }
+
+    StringBox getNameForId(AttributeId id) const {
+        std::lock_guard<std::mutex> guard(_mutex);
+        if (id >= _attributes.size()) {
+            return StringBox();
+        }
+        return _attributes[id];
+    }
+
+private:
+    mutable std::mutex _mutex;
+    std::vector<StringBox> _attributes;
+    FlatMap<StringBox, AttributeId> _idForName;
+};
+
+const std::vector<StringBox>& getNames() {
+    static auto* kNames = []() {
+        auto* names = new std::vector<StringBox>();
+        for (size_t i = 0; i < kNamesCount; i++) {
+            names->emplace_back(STRING_FORMAT("attribute{}", i));
+        }
+        return names;
+    }();
+    return *kNames;
+}
+
+template<typename T>
+T& getRegistry() {
+    static auto* kRegistry = []() {
+        auto* registry = new T();
+        for (const auto& name : getNames()) {
+            registry->getIdForName(name);
+        }
+        return registry;
+    }();
+    return *kRegistry;
+}
+
+/**
+ Mix of lookups similar to attribute application: mostly name to id, with some id to name.
+ */
+template<typename T>
+void runLookups(benchmark::State& state) {
+    auto& registry = getRegistry<T>();
+    const auto& names = getNames();
+    size_t index = static_cast<size_t>(state.thread_index()) * 31;
+
+    for (auto _ : state) {
+        const auto& name = names[index % kNamesCount];
+        auto id = registry.getIdForName(name);
+        if (index % 4 == 0) {
+            benchmark::DoNotOptimize(registry.getNameForId(id));
+        }
+        benchmark::DoNotOptimize(id);
+        index++;
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+} // namespace
+
+static void AttributeIdsLookupMutex(benchmark::State& state) {
+    runLookups<MutexAttributeIds>(state);
+}
+BENCHMARK(AttributeIdsLookupMutex)->ThreadRange(1, 8)->UseRealTime();
+
+static void AttributeIdsLookup(benchmark::State& state) {
+    runLookups<AttributeIds>(state);
+}
+BENCHMARK(AttributeIdsLookup)->ThreadRange(1, 8)->UseRealTime();
+
+/**
+ Lookups while another thread keeps registering new names.
+ */
+static void AttributeIdsLookupWithRegistrations(benchmark::State& state) {
+    auto& registry = getRegistry<AttributeIds>();
+    const auto& names = getNames();
+    size_t index = 0;
+    size_t registeredCount = 0;
+
+    for (auto _ : state) {
+        if (state.thread_index() == 0 && index % 64 == 0) {
+            registry.getIdForName(STRING_FORMAT("registered{}-{}", state.threads(), registeredCount++));
+        }
+        benchmark::DoNotOptimize(registry.getIdForName(names[index % kNamesCount]));
+        index++;
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(AttributeIdsLookupWithRegistrations)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
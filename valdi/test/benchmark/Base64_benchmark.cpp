@@ -0,0 +1,207 @@
+#include "utils/encoding/Base64Utils.hpp"
+#include "valdi_core/cpp/Utils/ByteBuffer.hpp"
+#include <benchmark/benchmark.h>
+#include <boost/algorithm/string.hpp>
+#include <openssl/base64.h>
+#include <string>
+#include <vector>
+
+using namespace snap::utils::encoding;
+
+namespace {
+
+constexpr size_t kStreamingChunkSize = 64 * 1024;
+
+std::vector<uint8_t> makeData(size_t size) {
+    std::vector<uint8_t> data(size);
+    uint32_t state = 0x12345678;
+    for (auto& byte : data) {
+        state = state * 1664525 + 1013904223;
+        byte = static_cast<uint8_t>(state >> 24);
+    }
+    return data;
+}
+
+/**
+ Base64 wrapped at 76 characters per line, like MIME encoded payloads.
+ */
+std::string makeWrappedBase64(size_t size) {
+    auto base64 = binaryToBase64(makeData(size));
+    std::string wrapped;
+    for (size_t i = 0; i < base64.size(); i += 76) {
+        wrapped += base64.substr(i, 76);
+        wrapped += "\r\n";
+    }
+    return wrapped;
+}
+
+/**
+ The previous implementation of binaryToBase64(), which wrapped BoringSSL.
+ */
+std::string boringSSLBinaryToBase64(const uint8_t* data, size_t size) {
+    size_t maxOutSize = 0;
+    if (size == 0 || EVP_EncodedLength(&maxOutSize, size) != 1 || maxOutSize == 0) {
+        return "";
+    }
+
+    std::string result(maxOutSize, '\0');
+    EVP_EncodeBlock(reinterpret_cast<uint8_t*>(result.data()), data, size);
+    result.resize(result.size() - 1);
+    return result;
+}
+
+/**
+ The previous implementation of base64ToBinary(), which wrapped BoringSSL.
+ */
+bool boringSSLBase64ToBinary(std::string_view base64, std::vector<uint8_t>& output) {
+    std::string noNewlines(base64);
+    boost::algorithm::replace_all(noNewlines, "\n", "");
+    boost::algorithm::replace_all(noNewlines, "\r", "");
+
+    size_t maxOutSize = 0;
+    if (EVP_DecodedLength(&maxOutSize, noNewlines.length()) != 1 || maxOutSize == 0) {
+        return false;
+    }
+
+    output.resize(maxOutSize);
+    size_t outSize = 0;
+    if (EVP_DecodeBase64(output.data(),
+                         &outSize,
+                         maxOutSize,
+                         reinterpret_cast<const uint8_t*>(noNewlines.c_str()),
+                         noNewlines.length()) != 1) {
+        output.resize(0);
+        return false;
+    }
+
+    output.resize(outSize);
+    return true;
+}
+
+void setCounters(benchmark::State& state, const char* implementation) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+    state.SetLabel(implementation);
+}
+
+void applyArguments(benchmark::internal::Benchmark* benchmark) {
+    benchmark->RangeMultiplier(8)->Range(64, 16 * 1024 * 1024);
+}
+
+} // namespace
+
+static void EncodeBoringSSL(benchmark::State& state) {
+    auto data = makeData(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(boringSSLBinaryToBase64(data.data(), data.size()));
+    }
+    setCounters(state, "boringssl");
+}
+BENCHMARK(EncodeBoringSSL)->Apply(applyArguments);
+
+static void EncodeString(benchmark::State& state) {
+    auto data = makeData(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(binaryToBase64(data.data(), data.size()));
+    }
+    setCounters(state, getBase64ImplementationName());
+}
+BENCHMARK(EncodeString)->Apply(applyArguments);
+
+static void EncodeByteBuffer(benchmark::State& state) {
+    auto data = makeData(static_cast<size_t>(state.range(0)));
+    Valdi::ByteBuffer output;
+    for (auto _ : state) {
+        output.clear();
+        appendBinaryToBase64(data.data(), data.size(), output);
+        benchmark::DoNotOptimize(output.data());
+    }
+    setCounters(state, getBase64ImplementationName());
+}
+BENCHMARK(EncodeByteBuffer)->Apply(applyArguments);
+
+static void EncodeStreaming(benchmark::State& state) {
+    auto data = makeData(static_cast<size_t>(state.range(0)));
+    std::string output(Base64Encoder::maxEncodedLength(kStreamingChunkSize), '\0');
+    for (auto _ : state) {
+        Base64Encoder encoder;
+        for (size_t i = 0; i < data.size(); i += kStreamingChunkSize) {
+            auto size = std::min(kStreamingChunkSize, data.size() - i);
+            benchmark::DoNotOptimize(encoder.encode(data.data() + i, size, output.data()));
+        }
+        benchmark::DoNotOptimize(encoder.finish(output.data()));
+    }
+    setCounters(state, getBase64ImplementationName());
+}
+BENCHMARK(EncodeStreaming)->Apply(applyArguments);
+
+static void DecodeBoringSSL(benchmark::State& state) {
+    auto base64 = binaryToBase64(makeData(static_cast<size_t>(state.range(0))));
+    std::vector<uint8_t> output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(boringSSLBase64ToBinary(base64, output));
+    }
+    setCounters(state, "boringssl");
+}
+BENCHMARK(DecodeBoringSSL)->Apply(applyArguments);
+
+static void DecodeVector(benchmark::State& state) {
+    auto base64 = binaryToBase64(makeData(static_cast<size_t>(state.range(0))));
+    std::vector<uint8_t> output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(base64ToBinary(base64, output));
+    }
+    setCounters(state, getBase64ImplementationName());
+}
+BENCHMARK(DecodeVector)->Apply(applyArguments);
+
+static void DecodeByteBuffer(benchmark::State& state) {
+    auto base64 = binaryToBase64(makeData(static_cast<size_t>(state.range(0))));
+    Valdi::ByteBuffer output;
+    for (auto _ : state) {
+        output.clear();
+        benchmark::DoNotOptimize(appendBase64ToBinary(base64, output));
+    }
+    setCounters(state, getBase64ImplementationName());
+}
+BENCHMARK(DecodeByteBuffer)->Apply(applyArguments);
+
+static void DecodeStreaming(benchmark::State& state) {
+    auto base64 = binaryToBase64(makeData(static_cast<size_t>(state.range(0))));
+    std::vector<uint8_t> output(Base64Decoder::maxDecodedLength(kStreamingChunkSize));
+    for (auto _ : state) {
+        Base64Decoder decoder;
+        for (size_t i = 0; i < base64.size(); i += kStreamingChunkSize) {
+            size_t written = 0;
+            decoder.decode(std::string_view(base64).substr(i, kStreamingChunkSize), output.data(), &written);
+            benchmark::DoNotOptimize(written);
+        }
+        benchmark::DoNotOptimize(decoder.finish());
+    }
+    setCounters(state, getBase64ImplementationName());
+}
+BENCHMARK(DecodeStreaming)->Apply(applyArguments);
+
+/**
+ The previous implementation had to copy newline separated inputs to strip the newlines before decoding.
+ */
+static void DecodeWithNewlinesBoringSSL(benchmark::State& state) {
+    auto wrapped = makeWrappedBase64(static_cast<size_t>(state.range(0)));
+    std::vector<uint8_t> output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(boringSSLBase64ToBinary(wrapped, output));
+    }
+    setCounters(state, "boringssl");
+}
+BENCHMARK(DecodeWithNewlinesBoringSSL)->Apply(applyArguments);
+
+static void DecodeWithNewlines(benchmark::State& state) {
+    auto wrapped = makeWrappedBase64(static_cast<size_t>(state.range(0)));
+    std::vector<uint8_t> output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(base64ToBinary(wrapped, output));
+    }
+    setCounters(state, getBase64ImplementationName());
+}
+BENCHMARK(DecodeWithNewlines)->Apply(applyArguments);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,304 @@
+#include "valdi/runtime/JavaScript/JavaScriptHeapDumpBuilder.hpp"
+#include "valdi_core/cpp/Utils/JSONReader.hpp"
+#include "valdi_core/cpp/Utils/JSONTokenizer.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
+#include "valdi_core/cpp/Utils/TextParser.hpp"
+#include <benchmark/benchmark.h>
+#include <charconv>
+#include <cstdlib>
+#include <fmt/format.h>
+
+using namespace Valdi;
+
+namespace {
+
+constexpr size_t kChunkSize = 64 * 1024;
+
+/**
+ A heap dump of 100000 nodes with 5 edges each, as produced by the JavaScriptHeapDumpBuilder.
+ Mostly made of long arrays of small integers.
+ */
+const std::string& getHeapDumpCorpus() {
+    static auto* kCorpus = []() {
+        std::vector<StringBox> names;
+        for (size_t i = 0; i < 20; i++) {
+            names.emplace_back(STRING_FORMAT("Object{}", i));
+        }
+        std::vector<StringBox> propertyNames;
+        for (size_t i = 0; i < 1000; i++) {
+            propertyNames.emplace_back(STRING_FORMAT("prop{}", i));
+        }
+
+        constexpr size_t nodesCount = 100000;
+        constexpr size_t edgesPerNodeCount = 5;
+
+        JavaScriptHeapDumpBuilder builder;
+        for (size_t i = 0; i < nodesCount; i++) {
+            auto nodeType =
+                static_cast<JavaScriptHeapDumpNodeType>(i % static_cast<size_t>(JavaScriptHeapDumpNodeType::COUNT));
+            builder.beginNode(nodeType, names[i % names.size()], static_cast<uint64_t>(i), 42);
+            for (size_t j = i + 1; j < nodesCount && j - i < edgesPerNodeCount; j++) {
+                builder.appendEdge(JavaScriptHeapDumpEdgeType::PROPERTY,
+                                   JavaScriptHeapEdgeIdentifier::named(propertyNames[j % propertyNames.size()]),
+                                   static_cast<uint64_t>(j));
+            }
+        }
+
+        auto heapDump = builder.build();
+        return new std::string(reinterpret_cast<const char*>(heapDump.data()), heapDump.size());
+    }();
+
+    return *kCorpus;
+}
+
+/**
+ An array of 20000 messages in the protobuf JSON mapping: camelCase keys, 64 bits
+ integers as strings, bytes as base64, nested messages and repeated fields.
+ */
+const std::string& getProtobufJSONCorpus() {
+    static auto* kCorpus = []() {
+        auto* corpus = new std::string("[");
+        for (size_t i = 0; i < 20000; i++) {
+            if (i != 0) {
+                *corpus += ",\n";
+            }
+            *corpus += fmt::format(
+                R"({{"id": "{}", "displayName": "User {}", "bio": "Line one\nLine \"two\" é", )"
+                R"("createdAt": "2023-12-21T10:{:02}:00Z", "score": {}.{}, "verified": {}, )"
+                R"("tags": ["friend", "tag{}", "recent"], "avatar": "aGVsbG8gd29ybGQgaGVsbG8gd29ybGQ=", )"
+                R"("settings": {{"notificationsEnabled": true, "theme": "THEME_DARK", "unreadCount": {}}}}})",
+                9000000000000000000ULL + i,
+                i,
+                i % 60,
+                i % 100,
+                i % 7,
+                i % 2 == 0 ? "true" : "false",
+                i % 50,
+                i % 30);
+        }
+        *corpus += "]";
+        return corpus;
+    }();
+
+    return *kCorpus;
+}
+
+bool parseNumber(JSONReader& reader, uint32_t& output) {
+    return reader.parseUInt(output);
+}
+
+bool parseNumber(JSONReader& reader, double& output) {
+    return reader.parseDouble(output);
+}
+
+bool parseNumber(std::string_view str, uint32_t& output) {
+    const auto* end = str.data() + str.size();
+    auto result = std::from_chars(str.data(), end, output);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+bool parseNumber(std::string_view str, double& output) {
+    TextParser parser(str);
+    return parser.parseDouble(output) && parser.isAtEnd();
+}
+
+template<typename Number>
+bool readValue(JSONReader& reader, std::string& str, size_t& tokensCount);
+
+template<typename Number>
+bool readContainerValues(JSONReader& reader, std::string& str, size_t& tokensCount, bool isObject) {
+    auto tryParseEnd = [&]() { return isObject ? reader.tryParseEndObject() : reader.tryParseEndArray(); };
+
+    auto isFirst = true;
+    while (!tryParseEnd()) {
+        if (reader.hasError()) {
+            return false;
+        }
+        if (isFirst) {
+            isFirst = false;
+        } else if (!reader.parseComma()) {
+            return false;
+        }
+
+        if (isObject) {
+            str.clear();
+            if (!reader.parseString(str) || !reader.parseColon()) {
+                return false;
+            }
+            tokensCount++;
+        }
+
+        if (!readValue<Number>(reader, str, tokensCount)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ Visit every token of a value using the JSONReader, decoding strings and numbers.
+ Numbers are parsed as the given type, like the consumers of each corpus do.
+ */
+template<typename Number>
+bool readValue(JSONReader& reader, std::string& str, size_t& tokensCount) {
+    tokensCount++;
+
+    switch (reader.peekToken()) {
+        case JSONReader::Token::Error:
+            return false;
+        case JSONReader::Token::Object:
+            return reader.parseBeginObject() && readContainerValues<Number>(reader, str, tokensCount, true);
+        case JSONReader::Token::Array:
+            return reader.parseBeginArray() && readContainerValues<Number>(reader, str, tokensCount, false);
+        case JSONReader::Token::String:
+            str.clear();
+            return reader.parseString(str);
+        case JSONReader::Token::Number: {
+            Number number;
+            return parseNumber(reader, number);
+        }
+        case JSONReader::Token::Boolean: {
+            bool b;
+            return reader.parseBool(b);
+        }
+        case JSONReader::Token::Null:
+            return reader.parseNull();
+    }
+}
+
+template<typename Number>
+size_t readAllTokens(std::string_view json) {
+    JSONReader reader(json);
+    std::string str;
+    size_t tokensCount = 0;
+
+    if (!readValue<Number>(reader, str, tokensCount) || !reader.ensureIsAtEnd()) {
+        std::abort();
+    }
+
+    return tokensCount;
+}
+
+/**
+ Visit every token using the JSONTokenizer, feeding the input in chunks of the given size.
+ Numbers are parsed as the given type, to match the work done by the JSONReader.
+ */
+template<typename Number>
+size_t tokenizeAllTokens(std::string_view json, size_t chunkSize) {
+    JSONTokenizer tokenizer;
+    size_t offset = 0;
+    size_t valuesCount = 0;
+
+    for (;;) {
+        auto token = tokenizer.next();
+        switch (token.type) {
+            case JSONTokenizer::TokenType::NeedsInput:
+                if (offset == json.size()) {
+                    tokenizer.finish();
+                } else {
+                    auto length = std::min(chunkSize, json.size() - offset);
+                    tokenizer.feed(json.substr(offset, length));
+                    offset += length;
+                }
+                break;
+            case JSONTokenizer::TokenType::End:
+                return valuesCount;
+            case JSONTokenizer::TokenType::Error:
+                std::abort();
+            case JSONTokenizer::TokenType::Number: {
+                Number number;
+                if (!parseNumber(token.value, number)) {
+                    std::abort();
+                }
+                benchmark::DoNotOptimize(number);
+                valuesCount++;
+            } break;
+            case JSONTokenizer::TokenType::Comma:
+            case JSONTokenizer::TokenType::Colon:
+            case JSONTokenizer::TokenType::EndObject:
+            case JSONTokenizer::TokenType::EndArray:
+                break;
+            default:
+                benchmark::DoNotOptimize(token.value.data());
+                valuesCount++;
+                break;
+        }
+    }
+}
+
+void setCorpusCounters(benchmark::State& state, const std::string& corpus, size_t residentInputBytes) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * corpus.size()));
+    // Bytes of input which need to be resident at once while parsing
+    state.counters["resident_input_bytes"] = static_cast<double>(residentInputBytes);
+}
+
+} // namespace
+
+static void JSONReaderHeapDump(benchmark::State& state) {
+    const auto& corpus = getHeapDumpCorpus();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(readAllTokens<uint32_t>(corpus));
+    }
+
+    setCorpusCounters(state, corpus, corpus.size());
+}
+BENCHMARK(JSONReaderHeapDump)->Unit(benchmark::kMillisecond);
+
+static void JSONTokenizerHeapDump(benchmark::State& state) {
+    const auto& corpus = getHeapDumpCorpus();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tokenizeAllTokens<uint32_t>(corpus, corpus.size()));
+    }
+
+    setCorpusCounters(state, corpus, corpus.size());
+}
+BENCHMARK(JSONTokenizerHeapDump)->Unit(benchmark::kMillisecond);
+
+static void JSONTokenizerHeapDumpChunked(benchmark::State& state) {
+    const auto& corpus = getHeapDumpCorpus();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tokenizeAllTokens<uint32_t>(corpus, kChunkSize));
+    }
+
+    setCorpusCounters(state, corpus, kChunkSize);
+}
+BENCHMARK(JSONTokenizerHeapDumpChunked)->Unit(benchmark::kMillisecond);
+
+static void JSONReaderProtobufJSON(benchmark::State& state) {
+    const auto& corpus = getProtobufJSONCorpus();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(readAllTokens<double>(corpus));
+    }
+
+    setCorpusCounters(state, corpus, corpus.size());
+}
+BENCHMARK(JSONReaderProtobufJSON)->Unit(benchmark::kMillisecond);
+
+static void JSONTokenizerProtobufJSON(benchmark::State& state) {
+    const auto& corpus = getProtobufJSONCorpus();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tokenizeAllTokens<double>(corpus, corpus.size()));
+    }
+
+    setCorpusCounters(state, corpus, corpus.size());
+}
+BENCHMARK(JSONTokenizerProtobufJSON)->Unit(benchmark::kMillisecond);
+
+static void JSONTokenizerProtobufJSONChunked(benchmark::State& state) {
+    const auto& corpus = getProtobufJSONCorpus();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tokenizeAllTokens<double>(corpus, kChunkSize));
+    }
+
+    setCorpusCounters(state, corpus, kChunkSize);
+}
+BENCHMARK(JSONTokenizerProtobufJSONChunked)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -1,7 +1,13 @@
 #include "valdi/runtime/JavaScript/JavaScriptHeapDumpBuilder.hpp"
+#include "valdi/runtime/Resources/DiskCacheImpl.hpp"
+#include "valdi_core/cpp/Utils/DiskUtils.hpp"
 #include "valdi_core/cpp/Utils/Format.hpp"
 #include "valdi_core/cpp/Utils/StringCache.hpp"
 #include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <sys/resource.h>
 
 using namespace Valdi;
 
@@ -18,8 +24,7 @@ struct BenchmarkHelper {
         }
     }
 
-    void populateHeapDumpBuilder(JavaScriptHeapDumpBuilder& builder) {
-        constexpr size_t nodesCount = 100000;
+    void populateHeapDumpBuilder(JavaScriptHeapDumpBuilder& builder, size_t nodesCount = 100000) {
         constexpr size_t edgesPerNodeCount = 5;
 
         for (size_t i = 0; i < nodesCount; i++) {
@@ -83,4 +88,128 @@ static void MergeHeapDump(benchmark::State& state) {
 }
 BENCHMARK(MergeHeapDump);
 
+class TemporaryDirectory {
+public:
+    TemporaryDirectory() {
+        char directoryLocation[] = "/tmp/.valdi_benchmark.XXXXXX";
+        if (mkdtemp(directoryLocation) == nullptr) {
+            std::abort();
+        }
+        _path = StringBox::fromCString(directoryLocation);
+    }
+
+    ~TemporaryDirectory() {
+        DiskUtils::remove(Path(_path));
+    }
+
+    const StringBox& get() const {
+        return _path;
+    }
+
+private:
+    StringBox _path;
+};
+
+static size_t readProcStatusKilobytes(std::string_view key) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (std::string_view(line).starts_with(key)) {
+            return static_cast<size_t>(std::strtoull(line.c_str() + key.size(), nullptr, 10));
+        }
+    }
+    return 0;
+}
+
+/**
+ Resets the peak resident set size of the process to its current resident set size,
+ so that the peak of a single benchmark can be measured. Only supported on Linux, other
+ platforms report the peak of the whole process. Memory freed by a previous benchmark may
+ still be held by the allocator, run the benchmarks separately using --benchmark_filter to
+ get accurate numbers.
+ */
+static size_t resetPeakResidentBytes() {
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    clearRefs.close();
+
+    return readProcStatusKilobytes("VmRSS:") * 1024;
+}
+
+static size_t getPeakResidentBytes() {
+    auto peakKilobytes = readProcStatusKilobytes("VmHWM:");
+    if (peakKilobytes == 0) {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+        return static_cast<size_t>(usage.ru_maxrss);
+#else
+        peakKilobytes = static_cast<size_t>(usage.ru_maxrss);
+#endif
+    }
+
+    return peakKilobytes * 1024;
+}
+
+static void setPeakResidentCounters(benchmark::State& state, size_t residentBytesBefore, size_t heapDumpSize) {
+    auto peakResidentBytes = getPeakResidentBytes();
+    state.counters["peak_rss_bytes"] = static_cast<double>(peakResidentBytes);
+    state.counters["peak_rss_growth_bytes"] =
+        static_cast<double>(peakResidentBytes > residentBytesBefore ? peakResidentBytes - residentBytesBefore : 0);
+    state.counters["heap_dump_bytes"] = static_cast<double>(heapDumpSize);
+}
+
+/**
+ Builds a large heap dump in memory and stores it on disk, like runtimeHeapDump does.
+ */
+static void StoreHeapDumpInMemory(benchmark::State& state) {
+    BenchmarkHelper helper;
+    TemporaryDirectory directory;
+    DiskCacheImpl diskCache(directory.get());
+    size_t residentBytesBefore = 0;
+    size_t heapDumpSize = 0;
+
+    for (auto _ : state) {
+        residentBytesBefore = resetPeakResidentBytes();
+
+        JavaScriptHeapDumpBuilder builder;
+        helper.populateHeapDumpBuilder(builder, static_cast<size_t>(state.range(0)));
+        auto heapDump = builder.build();
+        heapDumpSize = heapDump.size();
+
+        if (!diskCache.store(Path("heap.heapsnapshot"), heapDump)) {
+            std::abort();
+        }
+    }
+
+    setPeakResidentCounters(state, residentBytesBefore, heapDumpSize);
+}
+BENCHMARK(StoreHeapDumpInMemory)->Arg(1000000)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+/**
+ Same as StoreHeapDumpInMemory, but nodes and edges are spilled to disk as they are appended,
+ and the heap dump is written incrementally.
+ */
+static void StoreHeapDumpStreaming(benchmark::State& state) {
+    BenchmarkHelper helper;
+    TemporaryDirectory directory;
+    DiskCacheImpl diskCache(directory.get());
+    size_t residentBytesBefore = 0;
+
+    for (auto _ : state) {
+        residentBytesBefore = resetPeakResidentBytes();
+
+        JavaScriptHeapDumpBuilder builder(Path(directory.get().toStringView()));
+        helper.populateHeapDumpBuilder(builder, static_cast<size_t>(state.range(0)));
+
+        if (!builder.write(diskCache, Path("heap.heapsnapshot"))) {
+            std::abort();
+        }
+    }
+
+    setPeakResidentCounters(
+        state, residentBytesBefore, DiskUtils::stat(diskCache.getRootPath().appending("heap.heapsnapshot")).size());
+}
+BENCHMARK(StoreHeapDumpStreaming)->Arg(1000000)->Iterations(1)->Unit(benchmark::kMillisecond);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,197 @@
+#include "benchmark/utils/benchmark_utils.hpp"
+#include <benchmark/benchmark.h>
+
+#include "valdi/runtime/JavaScript/Modules/PersistentStore.hpp"
+#include "valdi/runtime/Resources/DiskCacheImpl.hpp"
+#include "valdi/runtime/Resources/KeyValueStore.hpp"
+#include "valdi/runtime/Resources/UserSession.hpp"
+#include "valdi_core/cpp/Utils/ByteBuffer.hpp"
+#include "valdi_core/cpp/Utils/ConsoleLogger.hpp"
+#include "valdi_core/cpp/Utils/DiskUtils.hpp"
+#include <cstdlib>
+#include <fmt/format.h>
+
+using namespace Valdi;
+
+namespace {
+
+constexpr size_t kEntrySize = 256;
+
+/**
+ An IDiskCache which forwards to another disk cache, while counting
+ the number of bytes that are written.
+ */
+class CountingDiskCache : public IDiskCache {
+public:
+    CountingDiskCache(const Ref<IDiskCache>& diskCache, std::atomic<size_t>& bytesWritten)
+        : _diskCache(diskCache), _bytesWritten(bytesWritten) {}
+
+    bool exists(const Path& path) override {
+        return _diskCache->exists(path);
+    }
+
+    Result<BytesView> load(const Path& path) override {
+        return _diskCache->load(path);
+    }
+
+    Result<BytesView> loadForAbsoluteURL(const StringBox& url) override {
+        return _diskCache->loadForAbsoluteURL(url);
+    }
+
+    Result<Void> store(const Path& path, const BytesView& bytes) override {
+        _bytesWritten += bytes.size();
+        return _diskCache->store(path, bytes);
+    }
+
+    Result<Void> appendRecords(const Path& path, const std::vector<BytesView>& records) override {
+        for (const auto& record : records) {
+            _bytesWritten += sizeof(uint32_t) + record.size();
+        }
+        return _diskCache->appendRecords(path, records);
+    }
+
+    bool supportsIncrementalAppend() const override {
+        return _diskCache->supportsIncrementalAppend();
+    }
+
+    Result<std::vector<BytesView>> loadRecords(const Path& path) override {
+        return _diskCache->loadRecords(path);
+    }
+
+    Ref<IDiskCache> scopedCache(const Path& path, bool allowsReadOutsideOfScope) const override {
+        return makeShared<CountingDiskCache>(_diskCache->scopedCache(path, allowsReadOutsideOfScope), _bytesWritten);
+    }
+
+    std::vector<Path> list(const Path& path) const override {
+        return _diskCache->list(path);
+    }
+
+    bool remove(const Path& path) override {
+        return _diskCache->remove(path);
+    }
+
+    Path getRootPath() const override {
+        return _diskCache->getRootPath();
+    }
+
+    StringBox getAbsoluteURL(const Path& path) const override {
+        return _diskCache->getAbsoluteURL(path);
+    }
+
+private:
+    Ref<IDiskCache> _diskCache;
+    std::atomic<size_t>& _bytesWritten;
+};
+
+class TemporaryDirectory {
+public:
+    TemporaryDirectory() {
+        char directoryLocation[] = "/tmp/.valdi_benchmark.XXXXXX";
+        if (mkdtemp(directoryLocation) == nullptr) {
+            std::abort();
+        }
+        _path = StringBox::fromCString(directoryLocation);
+    }
+
+    ~TemporaryDirectory() {
+        DiskUtils::remove(Path(_path));
+    }
+
+    const StringBox& get() const {
+        return _path;
+    }
+
+private:
+    StringBox _path;
+};
+
+StringBox makeKey(size_t index) {
+    return StringCache::getGlobal().makeString(fmt::format("entry_{}", index));
+}
+
+BytesView makeEntryData() {
+    return makeShared<ByteBuffer>(makeRandomString(kEntrySize))->toBytesView();
+}
+
+void setBytesWrittenCounter(benchmark::State& state, size_t bytesWritten) {
+    state.counters["bytes_written_per_store"] =
+        benchmark::Counter(static_cast<double>(bytesWritten), benchmark::Counter::kAvgIterations);
+}
+
+} // namespace
+
+/**
+ Updates entries of a PersistentStore holding the given number of entries,
+ waiting for each store() to be persisted.
+ */
+static void PersistentStoreUpdateEntry(benchmark::State& state) {
+    auto entriesCount = static_cast<size_t>(state.range(0));
+
+    TemporaryDirectory directory;
+    std::atomic<size_t> bytesWritten = 0;
+    auto diskCache = makeShared<CountingDiskCache>(makeShared<DiskCacheImpl>(directory.get()), bytesWritten);
+    auto dispatchQueue = DispatchQueue::create(STRING_LITERAL("PersistentStore"), ThreadQoSClassMax);
+    auto store = makeShared<PersistentStore>(STRING_LITERAL("store"),
+                                             diskCache,
+                                             nullptr,
+                                             nullptr,
+                                             dispatchQueue,
+                                             ConsoleLogger::getLogger(),
+                                             0,
+                                             false);
+    store->populate();
+
+    auto data = makeEntryData();
+    for (size_t i = 0; i < entriesCount; i++) {
+        store->store(makeKey(i), data, 0, 0, [](const auto& /*result*/) {});
+    }
+    // Make sure the initial snapshot is written
+    dispatchQueue->sync([]() {});
+    store->setBatchWritesDisabled(true);
+    dispatchQueue->sync([]() {});
+
+    bytesWritten = 0;
+    size_t index = 0;
+    for (auto _ : state) {
+        store->store(makeKey(index++ % entriesCount), data, 0, 0, [](const auto& /*result*/) {});
+        dispatchQueue->sync([]() {});
+    }
+
+    setBytesWrittenCounter(state, bytesWritten);
+    dispatchQueue->fullTeardown();
+}
+BENCHMARK(PersistentStoreUpdateEntry)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+/**
+ Same as PersistentStoreUpdateEntry, but writes a full snapshot of the store
+ on every store(), like the PersistentStore did before it had a journal.
+ */
+static void PersistentStoreUpdateEntryFullSnapshot(benchmark::State& state) {
+    auto entriesCount = static_cast<size_t>(state.range(0));
+
+    TemporaryDirectory directory;
+    DiskCacheImpl diskCache(directory.get());
+    KeyValueStore store;
+    store.setMaxWeight(0);
+
+    auto data = makeEntryData();
+    for (size_t i = 0; i < entriesCount; i++) {
+        store.store(makeKey(i), data, 0, 0);
+    }
+
+    size_t bytesWritten = 0;
+    size_t index = 0;
+    for (auto _ : state) {
+        store.store(makeKey(index++ % entriesCount), data, 0, 0);
+        auto snapshot = store.serialize();
+        bytesWritten += snapshot.value().size();
+        if (!diskCache.store(Path("store"), snapshot.value())) {
+            std::abort();
+        }
+    }
+
+    setBytesWrittenCounter(state, bytesWritten);
+}
+BENCHMARK(PersistentStoreUpdateEntryFullSnapshot)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
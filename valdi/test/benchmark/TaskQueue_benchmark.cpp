@@ -0,0 +1,87 @@
+#include "valdi_core/cpp/Threading/TaskQueue.hpp"
+#include <benchmark/benchmark.h>
+#include <thread>
+#include <vector>
+
+using namespace Valdi;
+
+constexpr size_t kTasksPerProducer = 20000;
+
+/**
+ Producers enqueue tasks concurrently while a single consumer thread runs them,
+ like the threads dispatching onto the JS or the worker queue.
+ */
+static void TaskQueueContention(benchmark::State& state) {
+    auto producersCount = static_cast<size_t>(state.range(0));
+    auto totalTasks = producersCount * kTasksPerProducer;
+
+    for (auto _ : state) {
+        TaskQueue taskQueue;
+        size_t ranTasks = 0;
+
+        std::thread consumer([&]() {
+            while (ranTasks < totalTasks) {
+                taskQueue.runNextTask(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+            }
+        });
+
+        std::vector<std::thread> producers;
+        producers.reserve(producersCount);
+        for (size_t i = 0; i < producersCount; i++) {
+            producers.emplace_back([&]() {
+                for (size_t j = 0; j < kTasksPerProducer; j++) {
+                    taskQueue.async([&]() { ranTasks++; });
+                }
+            });
+        }
+
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        consumer.join();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * totalTasks));
+}
+BENCHMARK(TaskQueueContention)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+/**
+ Schedule and cancel a timer while many other timers are pending, which is what
+ timeouts and debounced callbacks do.
+ */
+static void TaskQueueScheduleAndCancelTimer(benchmark::State& state) {
+    TaskQueue taskQueue;
+    auto pendingTimers = static_cast<size_t>(state.range(0));
+    for (size_t i = 0; i < pendingTimers; i++) {
+        taskQueue.asyncAfter([]() {}, std::chrono::seconds(60) + std::chrono::microseconds(i * 7919 % 100000));
+    }
+
+    for (auto _ : state) {
+        auto taskId = taskQueue.asyncAfter([]() {}, std::chrono::seconds(60) + std::chrono::milliseconds(50));
+        taskQueue.cancel(taskId);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(TaskQueueScheduleAndCancelTimer)->RangeMultiplier(8)->Range(8, 32768);
+
+/**
+ Enqueue and run tasks from a single thread, the uncontended case.
+ */
+static void TaskQueueEnqueueAndFlush(benchmark::State& state) {
+    TaskQueue taskQueue;
+    size_t ranTasks = 0;
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < 64; i++) {
+            taskQueue.async([&]() { ranTasks++; });
+        }
+        taskQueue.flush();
+    }
+
+    benchmark::DoNotOptimize(ranTasks);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 64));
+}
+BENCHMARK(TaskQueueEnqueueAndFlush);
+
+BENCHMARK_MAIN();
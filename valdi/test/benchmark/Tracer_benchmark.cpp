@@ -0,0 +1,140 @@
+#include "valdi_core/cpp/Utils/Trace.hpp"
+#include <benchmark/benchmark.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace Valdi;
+
+namespace {
+
+constexpr const char* kTraceName = "ViewNode.calculateLayout";
+
+/**
+ The previous tracer, where every trace takes the mutex and copies its name.
+ */
+class MutexTracer {
+public:
+    size_t startRecording() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto sequence = ++_recordingSequence;
+        _recorders.emplace_back(sequence);
+        return sequence;
+    }
+
+    std::vector<RecordedTrace> stopRecording(size_t recordingIdentifier) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = std::find(_recorders.begin(), _recorders.end(), recordingIdentifier);
+        if (it == _recorders.end()) {
+            return {};
+        }
+        _recorders.erase(it);
+
+        std::vector<RecordedTrace> outTraces;
+        for (const auto& trace : _pendingTraces) {
+            if (trace.recordingSequence >= recordingIdentifier) {
+                outTraces.emplace_back(trace);
+            }
+        }
+        if (_recorders.empty()) {
+            _pendingTraces.clear();
+        }
+        return outTraces;
+    }
+
+    void append(std::string&& trace, const TraceTimePoint& start, const TraceTimePoint& end) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_recorders.empty()) {
+            return;
+        }
+
+        _pendingTraces.emplace_back(std::move(trace), start, end, getCurrentThreadId(), _recordingSequence);
+    }
+
+private:
+    std::mutex _mutex;
+    size_t _recordingSequence = 0;
+    std::vector<RecordedTrace> _pendingTraces;
+    std::vector<size_t> _recorders;
+};
+
+/**
+ Keeps a recording active and periodically collects the recorded traces, like a profiling
+ session would.
+ */
+template<typename T>
+class RecordingSession {
+public:
+    explicit RecordingSession(T& tracer) : _tracer(tracer), _recordingId(tracer.startRecording()) {
+        _thread = std::thread([this]() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (!_stopped) {
+                _condition.wait_for(lock, std::chrono::milliseconds(1));
+                auto id = _tracer.startRecording();
+                benchmark::DoNotOptimize(_tracer.stopRecording(id));
+            }
+        });
+    }
+
+    ~RecordingSession() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopped = true;
+        }
+        _condition.notify_one();
+        _thread.join();
+        _tracer.stopRecording(_recordingId);
+    }
+
+private:
+    T& _tracer;
+    size_t _recordingId;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopped = false;
+    std::thread _thread;
+};
+
+template<typename T, typename F>
+void runRecording(benchmark::State& state, T& tracer, F&& appendTrace) {
+    std::unique_ptr<RecordingSession<T>> session;
+    if (state.thread_index() == 0) {
+        session = std::make_unique<RecordingSession<T>>(tracer);
+    }
+
+    for (auto _ : state) {
+        appendTrace();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+} // namespace
+
+static void TracerAppendMutex(benchmark::State& state) {
+    static auto* kTracer = new MutexTracer();
+    runRecording(state, *kTracer, []() {
+        auto start = std::chrono::steady_clock::now();
+        kTracer->append(std::string(kTraceName), start, std::chrono::steady_clock::now());
+    });
+}
+BENCHMARK(TracerAppendMutex)->Threads(1)->Threads(4)->Threads(8)->UseRealTime();
+
+static void TracerAppend(benchmark::State& state) {
+    static auto* kTracer = new Tracer();
+    runRecording(state, *kTracer, []() {
+        auto start = std::chrono::steady_clock::now();
+        kTracer->append(TraceNames::internLiteral(kTraceName, kTraceName), start, std::chrono::steady_clock::now());
+    });
+}
+BENCHMARK(TracerAppend)->Threads(1)->Threads(4)->Threads(8)->UseRealTime();
+
+/**
+ Full cost of VALDI_TRACE while recording, including the platform trace emitters.
+ */
+static void ScopedTraceRecording(benchmark::State& state) {
+    runRecording(state, Tracer::shared(), []() { ScopedTrace trace("ViewNode.calculateLayout"); });
+}
+BENCHMARK(ScopedTraceRecording)->Threads(1)->Threads(4)->Threads(8)->UseRealTime();
+
+BENCHMARK_MAIN();
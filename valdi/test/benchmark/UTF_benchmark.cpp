@@ -0,0 +1,159 @@
+#include "valdi_core/cpp/Text/UTF16Utils.hpp"
+#include "valdi_core/cpp/Text/UTFTranscoding.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+using namespace Valdi;
+
+namespace {
+
+enum class Corpus {
+    ASCII,
+    Latin,
+    CJK,
+    Emoji,
+    Invalid,
+};
+
+constexpr const char* kCorpusNames[] = {"ascii", "latin", "cjk", "emoji", "invalid"};
+
+/**
+ Build a UTF-8 string of approximately the given length, made of characters
+ typical of the given corpus.
+ */
+std::string makeUtf8String(Corpus corpus, size_t length) {
+    std::string_view fragment;
+    switch (corpus) {
+        case Corpus::ASCII:
+            fragment = "The quick brown fox jumps over the lazy dog. ";
+            break;
+        case Corpus::Latin:
+            fragment = "Ça été très agréable, à bientôt à Zürich! ";
+            break;
+        case Corpus::CJK:
+            fragment = "敏捷的棕色狐狸跳过了懒狗。";
+            break;
+        case Corpus::Emoji:
+            fragment = "Hey \U0001F44B\U0001F3FD see you soon \U0001F385\U0001F384 ";
+            break;
+        case Corpus::Invalid:
+            fragment = "Valid text \xC3\x28 \xE2\x82 \xF0\x28\x8C\x28 \x80 \xED\xA0\x80 end ";
+            break;
+    }
+
+    std::string output;
+    while (output.size() < length) {
+        output += fragment;
+    }
+    output.resize(length);
+
+    return output;
+}
+
+std::u16string makeUtf16String(Corpus corpus, size_t length) {
+    auto utf8 = makeUtf8String(corpus, length);
+    auto utf16 = utf8ToUtf16(utf8.data(), utf8.size());
+    return std::u16string(utf16.first, utf16.second);
+}
+
+void setCounters(benchmark::State& state, size_t inputBytes, const char* implementation) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * inputBytes));
+    state.SetLabel(std::string(kCorpusNames[state.range(0)]) + "/" + implementation);
+}
+
+void applyArguments(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgsProduct({{static_cast<int64_t>(Corpus::ASCII),
+                             static_cast<int64_t>(Corpus::Latin),
+                             static_cast<int64_t>(Corpus::CJK),
+                             static_cast<int64_t>(Corpus::Emoji),
+                             static_cast<int64_t>(Corpus::Invalid)},
+                            {16, 128, 4096, 65536}});
+}
+
+template<typename F>
+void runUtf8ToUtf16(benchmark::State& state, F&& transcode, const char* implementation) {
+    auto input = makeUtf8String(static_cast<Corpus>(state.range(0)), static_cast<size_t>(state.range(1)));
+    std::vector<char16_t> output(maxUtf8ToUtf16Length(input.size()));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(transcode(input.data(), input.size(), output.data()));
+        benchmark::ClobberMemory();
+    }
+
+    setCounters(state, input.size(), implementation);
+}
+
+template<typename F>
+void runUtf8ToUtf32(benchmark::State& state, F&& transcode, const char* implementation) {
+    auto input = makeUtf8String(static_cast<Corpus>(state.range(0)), static_cast<size_t>(state.range(1)));
+    std::vector<uint32_t> output(maxUtf8ToUtf32Length(input.size()));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(transcode(input.data(), input.size(), output.data()));
+        benchmark::ClobberMemory();
+    }
+
+    setCounters(state, input.size(), implementation);
+}
+
+template<typename F>
+void runUtf16ToUtf8(benchmark::State& state, F&& transcode, const char* implementation) {
+    auto input = makeUtf16String(static_cast<Corpus>(state.range(0)), static_cast<size_t>(state.range(1)));
+    std::vector<char> output(maxUtf16ToUtf8Length(input.size()));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(transcode(input.data(), input.size(), output.data()));
+        benchmark::ClobberMemory();
+    }
+
+    setCounters(state, input.size() * sizeof(char16_t), implementation);
+}
+
+} // namespace
+
+static void Utf8ToUtf16(benchmark::State& state) {
+    runUtf8ToUtf16(state, &transcodeUtf8ToUtf16, getUTFTranscoderName());
+}
+BENCHMARK(Utf8ToUtf16)->Apply(applyArguments);
+
+static void Utf8ToUtf16Scalar(benchmark::State& state) {
+    runUtf8ToUtf16(state, &transcodeUtf8ToUtf16Scalar, "scalar");
+}
+BENCHMARK(Utf8ToUtf16Scalar)->Apply(applyArguments);
+
+static void Utf8ToUtf32(benchmark::State& state) {
+    runUtf8ToUtf32(state, &transcodeUtf8ToUtf32, getUTFTranscoderName());
+}
+BENCHMARK(Utf8ToUtf32)->Apply(applyArguments);
+
+static void Utf8ToUtf32Scalar(benchmark::State& state) {
+    runUtf8ToUtf32(state, &transcodeUtf8ToUtf32Scalar, "scalar");
+}
+BENCHMARK(Utf8ToUtf32Scalar)->Apply(applyArguments);
+
+static void Utf16ToUtf8(benchmark::State& state) {
+    runUtf16ToUtf8(state, &transcodeUtf16ToUtf8, getUTFTranscoderName());
+}
+BENCHMARK(Utf16ToUtf8)->Apply(applyArguments);
+
+static void Utf16ToUtf8Scalar(benchmark::State& state) {
+    runUtf16ToUtf8(state, &transcodeUtf16ToUtf8Scalar, "scalar");
+}
+BENCHMARK(Utf16ToUtf8Scalar)->Apply(applyArguments);
+
+/**
+ The thread local buffer API used by the JS bridge, including the buffer management.
+ */
+static void Utf16ToUtf8ThreadLocalBuffer(benchmark::State& state) {
+    auto input = makeUtf16String(static_cast<Corpus>(state.range(0)), static_cast<size_t>(state.range(1)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utf16ToUtf8(input.data(), input.size()));
+    }
+
+    setCounters(state, input.size() * sizeof(char16_t), getUTFTranscoderName());
+}
+BENCHMARK(Utf16ToUtf8ThreadLocalBuffer)->Apply(applyArguments);
+
+BENCHMARK_MAIN();
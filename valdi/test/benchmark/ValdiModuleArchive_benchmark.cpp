@@ -0,0 +1,261 @@
+#include "benchmark/utils/benchmark_utils.hpp"
+#include <benchmark/benchmark.h>
+
+#include "valdi/runtime/Resources/DiskCacheImpl.hpp"
+#include "valdi/runtime/Resources/ValdiModuleArchive.hpp"
+#include "valdi/runtime/Resources/ZStdUtils.hpp"
+#include "valdi_core/cpp/Resources/ValdiArchive.hpp"
+#include "valdi_core/cpp/Utils/DiskUtils.hpp"
+#include <cstdlib>
+#include <fmt/format.h>
+
+using namespace Valdi;
+
+namespace {
+
+constexpr int kCompressionLevel = 19;
+
+struct SyntheticModule {
+    std::vector<std::string> contents;
+    std::vector<ValdiArchiveEntry> entries;
+    // Legacy format: the whole ValdiArchive compressed as a single zstd frame
+    Ref<ByteBuffer> legacyArchive;
+    Ref<ByteBuffer> seekableArchive;
+    // Entries a screen would typically need: a few JS files and one CSS document
+    std::vector<StringBox> screenEntries;
+};
+
+/**
+ Builds a module of about 8MB, made of 400 JS files and 40 CSS documents.
+ The content is generated from a small vocabulary so that it compresses
+ in the same ballpark as real JS sources.
+ */
+const SyntheticModule& getSyntheticModule() {
+    static auto* kModule = []() {
+        auto* module = new SyntheticModule();
+
+        std::vector<std::string> words;
+        for (size_t i = 0; i < 512; i++) {
+            words.emplace_back(makeRandomString(3 + i % 10));
+        }
+        uint32_t wordIndex = 0;
+        auto makeContent = [&](size_t size) {
+            std::string content;
+            content.reserve(size);
+            while (content.size() < size) {
+                wordIndex = wordIndex * 1664525u + 1013904223u;
+                content += words[(wordIndex >> 8) % words.size()];
+                content += (wordIndex % 7 == 0) ? ";\n" : " ";
+            }
+            return content;
+        };
+
+        for (size_t i = 0; i < 400; i++) {
+            module->contents.emplace_back(makeContent(18 * 1024 + (i % 13) * 512));
+        }
+        for (size_t i = 0; i < 40; i++) {
+            module->contents.emplace_back(makeContent(6 * 1024));
+        }
+
+        ValdiArchiveBuilder builder;
+        for (size_t i = 0; i < module->contents.size(); i++) {
+            auto path = i < 400 ? fmt::format("src/File{}.js", i) : fmt::format("src/Style{}.css", i - 400);
+            const auto& content = module->contents[i];
+            auto& entry = module->entries.emplace_back(StringCache::getGlobal().makeString(path),
+                                                       reinterpret_cast<const Byte*>(content.data()),
+                                                       content.size());
+            builder.addEntry(entry);
+        }
+
+        auto uncompressed = builder.build();
+        module->legacyArchive =
+            ZStdUtils::compress(uncompressed->data(), uncompressed->size(), kCompressionLevel).value();
+        module->seekableArchive = ValdiModuleArchive::serializeSeekable(module->entries, kCompressionLevel);
+
+        for (size_t i = 0; i < 8; i++) {
+            module->screenEntries.emplace_back(module->entries[i * 37].filePath);
+        }
+        module->screenEntries.emplace_back(module->entries[410].filePath);
+
+        return module;
+    }();
+
+    return *kModule;
+}
+
+size_t touchEntries(const ValdiModuleArchive& archive, const std::vector<StringBox>& paths) {
+    size_t total = 0;
+    for (const auto& path : paths) {
+        auto entry = archive.getEntryBytes(path);
+        if (!entry) {
+            std::abort();
+        }
+        total += entry.value().size();
+    }
+    return total;
+}
+
+void setArchiveCounters(benchmark::State& state, const ByteBuffer& archive, size_t residentBytes) {
+    state.counters["archive_bytes"] = static_cast<double>(archive.size());
+    // Decompressed bytes kept alive to serve the requested entries, a proxy for the peak RSS increase
+    state.counters["resident_bytes"] = static_cast<double>(residentBytes);
+}
+
+constexpr size_t kMaxBundlesOnDisk = 32;
+
+/**
+ A disk cache populated with kMaxBundlesOnDisk copies of the synthetic module, in both
+ the seekable and the legacy format.
+ */
+class BundlesOnDisk {
+public:
+    BundlesOnDisk() {
+        char directoryLocation[] = "/tmp/.valdi_benchmark.XXXXXX";
+        if (mkdtemp(directoryLocation) == nullptr) {
+            std::abort();
+        }
+        _rootDirectory = Path(directoryLocation);
+        _diskCache = makeShared<DiskCacheImpl>(StringBox::fromCString(directoryLocation));
+
+        const auto& module = getSyntheticModule();
+        for (size_t i = 0; i < kMaxBundlesOnDisk; i++) {
+            if (!_diskCache->store(getBundlePath(i, false), module.seekableArchive->toBytesView()) ||
+                !_diskCache->store(getBundlePath(i, true), module.legacyArchive->toBytesView())) {
+                std::abort();
+            }
+        }
+    }
+
+    ~BundlesOnDisk() {
+        DiskUtils::remove(_rootDirectory);
+    }
+
+    DiskCacheImpl& getDiskCache() {
+        return *_diskCache;
+    }
+
+    static Path getBundlePath(size_t index, bool legacy) {
+        return Path(fmt::format("{}bundle_{}.valdimodule", legacy ? "legacy_" : "", index));
+    }
+
+private:
+    Path _rootDirectory;
+    Ref<DiskCacheImpl> _diskCache;
+};
+
+BundlesOnDisk& getBundlesOnDisk() {
+    static BundlesOnDisk kBundlesOnDisk;
+    return kBundlesOnDisk;
+}
+
+template<typename LoadFn>
+void loadBundlesFromDisk(benchmark::State& state, bool legacy, LoadFn&& loadFn) {
+    const auto& module = getSyntheticModule();
+    auto& bundlesOnDisk = getBundlesOnDisk();
+    auto bundlesCount = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state) {
+        std::vector<ValdiModuleArchive> archives;
+        for (size_t i = 0; i < bundlesCount; i++) {
+            auto bytes = loadFn(bundlesOnDisk.getDiskCache(), BundlesOnDisk::getBundlePath(i, legacy));
+            auto archive = ValdiModuleArchive::decompress(bytes.value());
+            touchEntries(archive.value(), module.screenEntries);
+            archives.emplace_back(archive.moveValue());
+        }
+        benchmark::DoNotOptimize(archives);
+    }
+
+    const auto& archive = legacy ? module.legacyArchive : module.seekableArchive;
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bundlesCount * archive->size()));
+}
+
+} // namespace
+
+static void ModuleArchiveLoadBundlesRead(benchmark::State& state) {
+    loadBundlesFromDisk(
+        state, false, [](DiskCacheImpl& diskCache, const Path& path) { return diskCache.load(path); });
+}
+BENCHMARK(ModuleArchiveLoadBundlesRead)->Arg(1)->Arg(8)->Arg(kMaxBundlesOnDisk)->Unit(benchmark::kMillisecond);
+
+static void ModuleArchiveLoadBundlesMapped(benchmark::State& state) {
+    loadBundlesFromDisk(
+        state, false, [](DiskCacheImpl& diskCache, const Path& path) { return diskCache.loadMapped(path); });
+}
+BENCHMARK(ModuleArchiveLoadBundlesMapped)->Arg(1)->Arg(8)->Arg(kMaxBundlesOnDisk)->Unit(benchmark::kMillisecond);
+
+// Legacy archives are decompressed as a whole, mapping them is expected to be on par with reading them
+static void ModuleArchiveLoadLegacyBundlesRead(benchmark::State& state) {
+    loadBundlesFromDisk(state, true, [](DiskCacheImpl& diskCache, const Path& path) { return diskCache.load(path); });
+}
+BENCHMARK(ModuleArchiveLoadLegacyBundlesRead)->Arg(1)->Arg(8)->Unit(benchmark::kMillisecond);
+
+static void ModuleArchiveLoadLegacyBundlesMapped(benchmark::State& state) {
+    loadBundlesFromDisk(
+        state, true, [](DiskCacheImpl& diskCache, const Path& path) { return diskCache.loadMapped(path); });
+}
+BENCHMARK(ModuleArchiveLoadLegacyBundlesMapped)->Arg(1)->Arg(8)->Unit(benchmark::kMillisecond);
+
+static void ModuleArchiveOpenFull(benchmark::State& state) {
+    const auto& module = getSyntheticModule();
+    size_t residentBytes = 0;
+
+    for (auto _ : state) {
+        auto archive = ValdiModuleArchive::decompress(module.legacyArchive->toBytesView());
+        benchmark::DoNotOptimize(touchEntries(archive.value(), module.screenEntries));
+        residentBytes = archive.value().getDecompressedContent().size();
+    }
+
+    setArchiveCounters(state, *module.legacyArchive, residentBytes);
+}
+BENCHMARK(ModuleArchiveOpenFull)->Unit(benchmark::kMillisecond);
+
+static void ModuleArchiveOpenLazy(benchmark::State& state) {
+    const auto& module = getSyntheticModule();
+    size_t residentBytes = 0;
+
+    for (auto _ : state) {
+        auto archive = ValdiModuleArchive::decompress(module.seekableArchive->toBytesView());
+        residentBytes = touchEntries(archive.value(), module.screenEntries);
+        benchmark::DoNotOptimize(residentBytes);
+    }
+
+    setArchiveCounters(state, *module.seekableArchive, residentBytes);
+}
+BENCHMARK(ModuleArchiveOpenLazy)->Unit(benchmark::kMillisecond);
+
+static void ModuleArchiveReadAllEntriesFull(benchmark::State& state) {
+    const auto& module = getSyntheticModule();
+
+    for (auto _ : state) {
+        auto archive = ValdiModuleArchive::decompress(module.legacyArchive->toBytesView());
+        benchmark::DoNotOptimize(touchEntries(archive.value(), archive.value().getAllEntryPaths()));
+    }
+
+    setArchiveCounters(state, *module.legacyArchive, 0);
+}
+BENCHMARK(ModuleArchiveReadAllEntriesFull)->Unit(benchmark::kMillisecond);
+
+static void ModuleArchiveReadAllEntriesLazy(benchmark::State& state) {
+    const auto& module = getSyntheticModule();
+
+    for (auto _ : state) {
+        auto archive = ValdiModuleArchive::decompress(module.seekableArchive->toBytesView());
+        benchmark::DoNotOptimize(touchEntries(archive.value(), archive.value().getAllEntryPaths()));
+    }
+
+    setArchiveCounters(state, *module.seekableArchive, 0);
+}
+BENCHMARK(ModuleArchiveReadAllEntriesLazy)->Unit(benchmark::kMillisecond);
+
+static void ModuleArchiveCachedEntryLookup(benchmark::State& state) {
+    const auto& module = getSyntheticModule();
+    auto archive = ValdiModuleArchive::decompress(module.seekableArchive->toBytesView());
+    touchEntries(archive.value(), module.screenEntries);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(touchEntries(archive.value(), module.screenEntries));
+    }
+}
+BENCHMARK(ModuleArchiveCachedEntryLookup);
+
+BENCHMARK_MAIN();
@@ -1,13 +1,20 @@
-#include "benchmark_utils.hpp"
+#include "ViewNodeTestsUtils.hpp"
+#include "benchmark/utils/AllocationCounter.hpp"
+#include "benchmark/utils/benchmark_utils.hpp"
 #include "valdi_test_utils.hpp"
 
 #include "valdi/runtime/Attributes/AttributeIds.hpp"
+#include "valdi/runtime/Attributes/AttributeOwner.hpp"
 #include "valdi/runtime/Attributes/Yoga/Yoga.hpp"
+#include "valdi/runtime/CSS/CSSDocument.hpp"
+#include "valdi/runtime/Context/Context.hpp"
 #include "valdi/runtime/Context/ViewNodeTree.hpp"
 #include "valdi/runtime/Rendering/ViewNodeRenderer.hpp"
 #include "valdi/runtime/Utils/MainThreadManager.hpp"
+#include "valdi_core/cpp/Threading/ParallelWorkerPool.hpp"
 #include "valdi_core/cpp/Utils/LoggerUtils.hpp"
 
+#include "valdi/standalone_runtime/StandaloneMainQueue.hpp"
 #include "valdi/standalone_runtime/StandaloneViewManager.hpp"
 
 #include "valdi/runtime/Rendering/RenderRequest.hpp"
@@ -20,7 +27,12 @@ using namespace ValdiTest;
 using namespace Valdi;
 
 struct Dependencies {
-    Dependencies() : mainQueue(), mainThreadManager(mainQueue), viewManager(), attributeIds() {
+    Dependencies()
+        : mainQueue(makeShared<StandaloneMainQueue>()),
+          mainThreadManager(makeShared<MainThreadManager>(mainQueue->createMainThreadDispatcher())),
+          viewManager(),
+          attributeIds() {
+        mainThreadManager->markCurrentThreadIsMainThread();
         viewManagerContext = makeShared<ViewManagerContext>(viewManager,
                                                             attributeIds,
                                                             makeShared<ColorPalette>(),
@@ -33,7 +45,19 @@ struct Dependencies {
     ~Dependencies() {}
 
     Ref<ViewNodeTree> createTree() {
-        return makeShared<ViewNodeTree>(nullptr, viewManagerContext, nullptr, mainThreadManager, true);
+        return makeShared<ViewNodeTree>(makeShared<Context>(0, strongSmallRef(&ConsoleLogger::getLogger())),
+                                        viewManagerContext,
+                                        &viewManager,
+                                        nullptr,
+                                        mainThreadManager.get(),
+                                        false);
+    }
+
+    void render(const Ref<ViewNodeTree>& tree, const RenderRequest& request) {
+        tree->scheduleExclusiveUpdate([&]() {
+            ViewNodeRenderer renderer(*tree, ConsoleLogger::getLogger(), false);
+            renderer.render(request);
+        });
     }
 
     void destroyTree(Ref<ViewNodeTree>& tree) {
@@ -45,8 +69,8 @@ struct Dependencies {
         tree = nullptr;
     }
 
-    StandaloneMainQueue mainQueue;
-    MainThreadManager mainThreadManager;
+    Ref<StandaloneMainQueue> mainQueue;
+    Ref<MainThreadManager> mainThreadManager;
     StandaloneViewManager viewManager;
     AttributeIds attributeIds;
     Ref<ViewManagerContext> viewManagerContext;
@@ -190,16 +214,19 @@ static void InitialRender(benchmark::State& state) {
     auto request = makeShared<RenderRequest>();
     populateRenderRequest(*request, renderState, createElementTree());
 
+    size_t allocationsCount = 0;
     for (auto _ : state) {
         auto tree = deps.createTree();
-        ViewNodeRenderer renderer(*tree, ConsoleLogger::getLogger(), false);
-
-        renderer.render(*request);
+        auto allocationsCountBefore = getAllocationsCount();
+        deps.render(tree, *request);
+        allocationsCount += getAllocationsCount() - allocationsCountBefore;
 
         state.PauseTiming();
         deps.destroyTree(tree);
         state.ResumeTiming();
     }
+
+    state.counters["allocs"] = makeAllocationsCounter(allocationsCount);
 }
 BENCHMARK(InitialRender);
 
@@ -213,10 +240,7 @@ static void DestroyTree(benchmark::State& state) {
     for (auto _ : state) {
         state.PauseTiming();
         auto tree = deps.createTree();
-
-        ViewNodeRenderer renderer(*tree, ConsoleLogger::getLogger(), false);
-
-        renderer.render(*request);
+        deps.render(tree, *request);
         state.ResumeTiming();
 
         deps.destroyTree(tree);
@@ -224,4 +248,262 @@ static void DestroyTree(benchmark::State& state) {
 }
 BENCHMARK(DestroyTree);
 
+static void collectViewNodes(ViewNode* viewNode, std::vector<ViewNode*>& output) {
+    output.emplace_back(viewNode);
+    for (size_t i = 0; i < viewNode->getChildCount(); i++) {
+        collectViewNodes(viewNode->getChildAt(i), output);
+    }
+}
+
+/**
+ Reports the memory used by the ViewNodes of the tree after the initial render:
+ all the heap allocations made while rendering, and the bytes used by the attributes storage.
+ */
+static void MemoryPerNode(benchmark::State& state) {
+    Dependencies deps;
+
+    RenderState renderState(deps);
+    auto request = makeShared<RenderRequest>();
+    populateRenderRequest(*request, renderState, createElementTree());
+
+    size_t heapBytes = 0;
+    size_t attributesBytes = 0;
+    size_t nodesCount = 0;
+
+    for (auto _ : state) {
+        auto tree = deps.createTree();
+        auto allocatedBytesBefore = getAllocatedBytes();
+        deps.render(tree, *request);
+        heapBytes = getAllocatedBytes() - allocatedBytesBefore;
+
+        state.PauseTiming();
+        std::vector<ViewNode*> viewNodes;
+        collectViewNodes(tree->getRootViewNode().get(), viewNodes);
+        nodesCount = viewNodes.size();
+        attributesBytes = 0;
+        for (auto* viewNode : viewNodes) {
+            const auto& attributesApplier =
+                static_cast<const ViewNodeAttributesApplier&>(viewNode->getAttributesApplier());
+            attributesBytes += sizeof(ViewNodeAttributesApplier) + attributesApplier.getAttributesAllocatedBytes();
+        }
+
+        deps.destroyTree(tree);
+        state.ResumeTiming();
+    }
+
+    state.counters["nodes"] = static_cast<double>(nodesCount);
+    state.counters["heapBytesPerNode"] = static_cast<double>(heapBytes) / static_cast<double>(nodesCount);
+    state.counters["attributesBytesPerNode"] =
+        static_cast<double>(attributesBytes) / static_cast<double>(nodesCount);
+}
+BENCHMARK(MemoryPerNode);
+
+/**
+ Sets and removes attributes on every node of a rendered tree, similar to what
+ CSS updates and reapplying attributes do.
+ */
+static void ApplyAttributes(benchmark::State& state) {
+    Dependencies deps;
+
+    RenderState renderState(deps);
+    auto request = makeShared<RenderRequest>();
+    populateRenderRequest(*request, renderState, createElementTree());
+
+    auto tree = deps.createTree();
+    deps.render(tree, *request);
+
+    std::vector<ViewNode*> viewNodes;
+    collectViewNodes(tree->getRootViewNode().get(), viewNodes);
+
+    auto opacityId = deps.attributeIds.getIdForName("opacity");
+    auto marginLeftId = deps.attributeIds.getIdForName("marginLeft");
+    const auto* owner = AttributeOwner::getNativeOverridenAttributeOwner();
+    size_t iteration = 0;
+
+    for (auto _ : state) {
+        tree->withLock([&]() {
+            auto& viewTransactionScope = tree->getCurrentViewTransactionScope();
+            auto opacity = Value(iteration % 2 == 0 ? 0.5 : 1.0);
+            for (auto* viewNode : viewNodes) {
+                viewNode->setAttribute(viewTransactionScope, opacityId, owner, opacity, nullptr);
+                if (iteration % 2 == 0) {
+                    viewNode->setAttribute(viewTransactionScope, marginLeftId, owner, Value(4.0), nullptr);
+                } else {
+                    viewNode->setAttribute(viewTransactionScope, marginLeftId, owner, Value::undefined(), nullptr);
+                }
+            }
+        });
+        iteration++;
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * viewNodes.size() * 2));
+    deps.destroyTree(tree);
+}
+BENCHMARK(ApplyAttributes);
+
+static void addCSSStyle(Valdi::StyleNode& styleNode, const char* attribute, double value) {
+    auto* style = styleNode.add_styles();
+    style->mutable_attribute()->set_type(Valdi::NodeAttribute_Type_NODE_ATTRIBUTE_TYPE_DOUBLE);
+    style->mutable_attribute()->set_name(attribute);
+    style->mutable_attribute()->set_double_value(value);
+    style->set_id(styleNode.styles_size());
+}
+
+static Valdi::StyleNode& addCSSClassRule(Valdi::CSSRuleIndex& ruleIndex, const char* className) {
+    auto* rule = ruleIndex.add_class_rules();
+    rule->set_name(className);
+    return *rule->mutable_node();
+}
+
+static Ref<CSSDocument> makeCSSDocument(AttributeIds& attributeIds, bool withAncestorRule) {
+    Valdi::StyleNode root;
+    auto& ruleIndex = *root.mutable_ruleindex();
+    addCSSStyle(addCSSClassRule(ruleIndex, "list"), "padding", 4);
+    addCSSStyle(addCSSClassRule(ruleIndex, "highlighted"), "opacity", 0.9);
+    addCSSStyle(addCSSClassRule(ruleIndex, "row"), "marginTop", 2);
+    addCSSStyle(addCSSClassRule(ruleIndex, "odd"), "opacity", 0.5);
+
+    auto& item = addCSSClassRule(ruleIndex, "item");
+    addCSSStyle(item, "width", 40);
+    if (withAncestorRule) {
+        // .highlighted .item
+        auto& ancestorRules = *item.mutable_ruleindex()->mutable_ancestor_rules();
+        addCSSStyle(addCSSClassRule(ancestorRules, "highlighted"), "marginLeft", 4);
+    }
+
+    return makeShared<CSSDocument>(ResourceId(STRING_LITERAL("benchmark.css")), root, attributeIds);
+}
+
+/**
+ Toggles a class on the root of a tree of about 5k styled nodes and updates the CSS.
+ With Arg(1), the document has a descendant selector on the toggled class, so that the
+ nodes matching it need to be restyled.
+ */
+static void ToggleCSSClass(benchmark::State& state) {
+    Dependencies deps;
+
+    auto cssDocument = Value(makeCSSDocument(deps.attributeIds, state.range(0) != 0));
+
+    std::vector<Element> items;
+    for (size_t i = 0; i < 100; i++) {
+        items.emplace_back(
+            Element("view").attribute("cssDocument", cssDocument).attribute("class", i % 2 == 0 ? "item" : "item odd"));
+    }
+
+    std::vector<Element> rows;
+    for (size_t i = 0; i < 50; i++) {
+        rows.emplace_back(
+            Element("view").attribute("cssDocument", cssDocument).attribute("class", "row").setChildren(items));
+    }
+
+    auto root = Element("view").attribute("cssDocument", cssDocument).attribute("class", "list").setChildren(rows);
+
+    RenderState renderState(deps);
+    auto request = makeShared<RenderRequest>();
+    populateRenderRequest(*request, renderState, root);
+
+    auto tree = deps.createTree();
+    deps.render(tree, *request);
+
+    auto rootViewNode = tree->getRootViewNode();
+    const auto* owner = AttributeOwner::getNativeOverridenAttributeOwner();
+    auto highlightedClass = Value(STRING_LITERAL("list highlighted"));
+    auto defaultClass = Value(STRING_LITERAL("list"));
+    size_t iteration = 0;
+
+    for (auto _ : state) {
+        tree->withLock([&]() {
+            auto& viewTransactionScope = tree->getCurrentViewTransactionScope();
+            rootViewNode->setAttribute(viewTransactionScope,
+                                       DefaultAttributeCSSClass,
+                                       owner,
+                                       iteration % 2 == 0 ? highlightedClass : defaultClass,
+                                       nullptr);
+            rootViewNode->updateCSS(viewTransactionScope, nullptr);
+        });
+        iteration++;
+    }
+
+    state.counters["nodes"] = static_cast<double>(renderState.elementId);
+    rootViewNode = nullptr;
+    deps.destroyTree(tree);
+}
+BENCHMARK(ToggleCSSClass)->Arg(0)->Arg(1);
+
+namespace {
+
+constexpr size_t kCellsCount = 500;
+constexpr size_t kItemsPerCell = 24;
+constexpr double kCellHeight = 120;
+
+/**
+ A list of kCellsCount lazy layout cells, each made of a wrapping row of items,
+ with a viewport large enough so that every cell is visible.
+ */
+struct LazyLayoutList {
+    ViewNodeTestsDependencies utils;
+    Ref<ViewNode> root;
+    std::vector<Ref<ViewNode>> firstItems;
+
+    LazyLayoutList() {
+        auto& scope = utils.getViewTransactionScope();
+        root = utils.createRootView();
+
+        for (size_t i = 0; i < kCellsCount; i++) {
+            auto cell = utils.createLayout();
+            cell->setPrefersLazyLayout(scope, true);
+            root->appendChild(scope, cell);
+            utils.setViewNodeAttribute(cell, "height", Value(kCellHeight));
+            utils.setViewNodeAttribute(cell, "flexDirection", Value(STRING_LITERAL("row")));
+            utils.setViewNodeAttribute(cell, "flexWrap", Value(STRING_LITERAL("wrap")));
+            utils.setViewNodeAttribute(cell, "padding", Value(8.0));
+
+            for (size_t j = 0; j < kItemsPerCell; j++) {
+                auto item = utils.createLayout();
+                cell->appendChild(scope, item);
+                utils.setViewNodeMarginAndSize(item, 4, 20 + static_cast<double>(j % 5) * 10, 16);
+                utils.setViewNodeAttribute(item, "flexGrow", Value(1.0));
+
+                if (j == 0) {
+                    firstItems.emplace_back(item);
+                }
+            }
+        }
+
+        performLayout();
+    }
+
+    void performLayout() {
+        root->performLayout(utils.getViewTransactionScope(),
+                            Size(400, static_cast<float>(kCellsCount * kCellHeight)),
+                            LayoutDirectionLTR);
+        root->updateVisibilityAndPerformUpdates(utils.getViewTransactionScope());
+    }
+};
+
+} // namespace
+
+static void LazyLayoutDirtyAllCells(benchmark::State& state) {
+    LazyLayoutList list;
+
+    auto threadsCount = static_cast<size_t>(state.range(0));
+    if (threadsCount > 0) {
+        list.utils.getTree().setLayoutWorkerPool(makeShared<ParallelWorkerPool>(
+            STRING_LITERAL("Valdi Layout"), ThreadQoSClassMax, threadsCount));
+    }
+
+    size_t iteration = 0;
+    for (auto _ : state) {
+        auto width = static_cast<double>(20 + (iteration++ % 2) * 10);
+        for (const auto& item : list.firstItems) {
+            list.utils.setViewNodeAttribute(item, "width", Value(width));
+        }
+
+        list.performLayout();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kCellsCount));
+}
+BENCHMARK(LazyLayoutDirtyAllCells)->Arg(0)->Arg(2)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
 BENCHMARK_MAIN();
@@ -0,0 +1,227 @@
+#include "valdi/runtime/JavaScript/Modules/ProtobufArena.hpp"
+#include "valdi/runtime/JavaScript/Modules/ProtobufMessageFactory.hpp"
+#include "valdi_core/cpp/Threading/ThreadedDispatchQueue.hpp"
+#include "valdi_core/cpp/Threading/WorkerPoolDispatchQueue.hpp"
+#include "valdi_core/cpp/Utils/ByteBuffer.hpp"
+#include "valdi_core/cpp/Utils/ExceptionTracker.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace Valdi;
+
+namespace {
+
+constexpr size_t kTasksCount = 512;
+
+constexpr std::string_view kProtoFileContent = R"(
+syntax = "proto3";
+package bench;
+
+message Media {
+  string url = 1;
+  int32 width = 2;
+  int32 height = 3;
+}
+
+message Item {
+  int64 id = 1;
+  string title = 2;
+  string subtitle = 3;
+  repeated Media media = 4;
+  repeated int32 scores = 5;
+}
+
+message Feed {
+  repeated Item items = 1;
+}
+)";
+
+void writeVarint(ByteBuffer& output, uint64_t value) {
+    while (value >= 0x80) {
+        output.append(static_cast<Byte>(value | 0x80));
+        value >>= 7;
+    }
+    output.append(static_cast<Byte>(value));
+}
+
+void writeTag(ByteBuffer& output, uint32_t fieldNumber, uint32_t wireType) {
+    writeVarint(output, (fieldNumber << 3) | wireType);
+}
+
+void writeLengthDelimited(ByteBuffer& output, uint32_t fieldNumber, const Byte* data, size_t length) {
+    writeTag(output, fieldNumber, 2);
+    writeVarint(output, length);
+    output.append(data, data + length);
+}
+
+void writeString(ByteBuffer& output, uint32_t fieldNumber, std::string_view str) {
+    writeLengthDelimited(output, fieldNumber, reinterpret_cast<const Byte*>(str.data()), str.size());
+}
+
+void writeItem(ByteBuffer& output, uint64_t id) {
+    ByteBuffer item;
+    writeTag(item, 1, 0);
+    writeVarint(item, id);
+    writeString(item, 2, "Item title " + std::to_string(id));
+    writeString(item, 3, "A subtitle which is a bit longer than the title of the item");
+
+    for (int32_t i = 0; i < 3; i++) {
+        ByteBuffer media;
+        writeString(media, 1, "https://cdn.example.com/media/" + std::to_string(id) + "/" + std::to_string(i));
+        writeTag(media, 2, 0);
+        writeVarint(media, 1080);
+        writeTag(media, 3, 0);
+        writeVarint(media, 1920);
+        writeLengthDelimited(item, 4, media.data(), media.size());
+    }
+
+    ByteBuffer scores;
+    for (int32_t i = 0; i < 16; i++) {
+        writeVarint(scores, static_cast<uint64_t>(i * 37));
+    }
+    writeLengthDelimited(item, 5, scores.data(), scores.size());
+
+    writeLengthDelimited(output, 1, item.data(), item.size());
+}
+
+BytesView makeFeed(size_t itemsCount) {
+    auto output = makeShared<ByteBuffer>();
+    for (size_t i = 0; i < itemsCount; i++) {
+        writeItem(*output, i + 1);
+    }
+    return output->toBytesView();
+}
+
+/**
+ Protobuf payloads like the ones decoded through the async decode calls. Sizes vary: mostly
+ small messages, with a few large ones.
+ */
+struct DecodeWorkload {
+    Ref<ProtobufMessageFactory> messageFactory;
+    size_t descriptorIndex = 0;
+    std::vector<BytesView> payloads;
+
+    DecodeWorkload() : messageFactory(makeShared<ProtobufMessageFactory>(false)) {
+        SimpleExceptionTracker exceptionTracker;
+        messageFactory->parseAndLoad("bench.proto", kProtoFileContent, exceptionTracker);
+        SC_ASSERT(exceptionTracker, exceptionTracker.extractError().toString());
+
+        auto descriptorNames = messageFactory->getDescriptorNames();
+        descriptorIndex = static_cast<size_t>(std::find(descriptorNames.begin(), descriptorNames.end(), "bench.Feed") -
+                                              descriptorNames.begin());
+        // Resolve the descriptor upfront, like the async calls do
+        messageFactory->getDescriptorAtIndex(descriptorIndex, exceptionTracker);
+
+        auto smallFeed = makeFeed(2);
+        auto largeFeed = makeFeed(64);
+
+        payloads.reserve(kTasksCount);
+        uint32_t state = 0x12345678;
+        for (size_t i = 0; i < kTasksCount; i++) {
+            state = state * 1664525 + 1013904223;
+            payloads.emplace_back((state >> 28) == 0 ? largeFeed : smallFeed);
+        }
+    }
+
+    size_t decode(const BytesView& payload) const {
+        // Each async call decodes into the arena of its caller
+        auto arena = makeShared<ProtobufArena>(true, false);
+        auto lock = arena->lock();
+        SimpleExceptionTracker exceptionTracker;
+        auto messageIndex = arena->decodeMessage(messageFactory, descriptorIndex, payload, true, exceptionTracker);
+        SC_ASSERT(exceptionTracker, exceptionTracker.extractError().toString());
+        return messageIndex;
+    }
+};
+
+void runWorkload(benchmark::State& state, DispatchQueue& queue) {
+    DecodeWorkload workload;
+    std::atomic<size_t> result = 0;
+
+    for (auto _ : state) {
+        for (const auto& payload : workload.payloads) {
+            queue.async([&]() { result.fetch_add(workload.decode(payload), std::memory_order_relaxed); });
+        }
+        queue.sync([]() {});
+    }
+
+    benchmark::DoNotOptimize(result.load());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kTasksCount));
+}
+
+} // namespace
+
+/**
+ The previous worker queue, a single thread running all the tasks.
+ */
+static void WorkerQueueThreaded(benchmark::State& state) {
+    auto queue = makeShared<ThreadedDispatchQueue>(STRING_LITERAL("Benchmark Queue"), ThreadQoSClassHigh);
+    runWorkload(state, *queue);
+    queue->fullTeardown();
+}
+BENCHMARK(WorkerQueueThreaded)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+/**
+ The runtime worker queue, a serial queue running on top of the pool.
+ */
+static void WorkerQueueSerialOnPool(benchmark::State& state) {
+    auto pool = makeShared<WorkerPoolDispatchQueue>(
+        STRING_LITERAL("Benchmark Pool"), ThreadQoSClassHigh, WorkerPoolDispatchQueue::getDefaultWorkersCount());
+    auto queue = pool->createSerialQueue(ThreadQoSClassHigh);
+    runWorkload(state, *queue);
+    queue->fullTeardown();
+    pool->fullTeardown();
+}
+BENCHMARK(WorkerQueueSerialOnPool)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+/**
+ Decode jobs dispatched on the pool directly.
+ */
+static void WorkerQueuePool(benchmark::State& state) {
+    auto queue = makeShared<WorkerPoolDispatchQueue>(
+        STRING_LITERAL("Benchmark Pool"), ThreadQoSClassHigh, static_cast<size_t>(state.range(0)));
+    runWorkload(state, *queue);
+    queue->fullTeardown();
+}
+BENCHMARK(WorkerQueuePool)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(static_cast<int64_t>(WorkerPoolDispatchQueue::getDefaultWorkersCount()))
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ Tasks enqueued from the tasks themselves, like a load operation dispatching its dependencies.
+ */
+static void WorkerQueuePoolNestedTasks(benchmark::State& state) {
+    auto queue = makeShared<WorkerPoolDispatchQueue>(
+        STRING_LITERAL("Benchmark Pool"), ThreadQoSClassHigh, WorkerPoolDispatchQueue::getDefaultWorkersCount());
+    DecodeWorkload workload;
+    std::atomic<size_t> result = 0;
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < kTasksCount; i += 8) {
+            queue->async([&, i]() {
+                for (size_t j = 1; j < 8; j++) {
+                    queue->async([&, i, j]() {
+                        result.fetch_add(workload.decode(workload.payloads[i + j]), std::memory_order_relaxed);
+                    });
+                }
+                result.fetch_add(workload.decode(workload.payloads[i]), std::memory_order_relaxed);
+            });
+        }
+        queue->sync([]() {});
+    }
+
+    benchmark::DoNotOptimize(result.load());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kTasksCount));
+    queue->fullTeardown();
+}
+BENCHMARK(WorkerQueuePoolNestedTasks)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -1,81 +1,312 @@
-#include "benchmark_utils.hpp"
+#include "benchmark/utils/AllocationCounter.hpp"
 #include "valdi_test_utils.hpp"
 #include <benchmark/benchmark.h>
 
+#include "valdi/runtime/Attributes/AttributeOwner.hpp"
+#include "valdi/runtime/CSS/CSSDocument.hpp"
+#include "valdi/runtime/Context/Context.hpp"
+#include "valdi/runtime/Context/ViewNodeTree.hpp"
+#include "valdi/runtime/Rendering/RenderRequest.hpp"
+#include "valdi/runtime/Runtime.hpp"
+
+#include <array>
+#include <vector>
+
 using namespace ValdiTest;
+using namespace Valdi;
 
-static void CreateRenderAndDestroy(benchmark::State& state) {
-    RuntimeWrapper wrapper(false);
-    wrapper.logger.setMinLogType(Valdi::LogTypeWarn);
-    wrapper.flushQueues();
+static constexpr RawViewNodeId kRootId = 1;
+static constexpr size_t kCardsCount = 20;
+
+/**
+ Runtime without a JS engine, rendering the requests built by the benchmarks.
+ */
+struct BenchmarkRuntime {
+    Ref<MainQueue> mainQueue;
+    Ref<ValdiStandaloneRuntime> standaloneRuntime;
+    Runtime* runtime = nullptr;
+
+    BenchmarkRuntime() : mainQueue(makeShared<MainQueue>()) {
+        ConsoleLogger::getLogger().setMinLogType(LogTypeWarn);
+
+        standaloneRuntime = ValdiStandaloneRuntime::create(false,
+                                                           false,
+                                                           false,
+                                                           true,
+                                                           false,
+                                                           nullptr,
+                                                           mainQueue,
+                                                           makeShared<InMemoryDiskCache>(),
+                                                           nullptr,
+                                                           makeShared<StandaloneResourceLoader>());
+        runtime = &standaloneRuntime->getRuntime();
+
+        // The MainThreadManager does a dispatch to figure out the main thread id
+        mainQueue->runOnce();
+    }
+
+    SharedContext createContext() {
+        auto context = runtime->createContext(
+            standaloneRuntime->getViewManagerContext(), STRING_LITERAL("test/src/Benchmark.valdi"), nullptr, nullptr);
+        context->onCreate();
+        return context;
+    }
+};
+
+static RawViewNodeId getCardId(size_t index) {
+    return static_cast<RawViewNodeId>(kRootId + 1 + index * 2);
+}
+
+static void appendAttribute(
+    RenderRequest& request, AttributeIds& attributeIds, RawViewNodeId id, const char* name, const Value& value) {
+    auto* entry = request.appendSetElementAttribute();
+    entry->setElementId(id);
+    entry->setAttributeId(attributeIds.getIdForName(name));
+    entry->setAttributeValue(value);
+}
+
+static void appendElement(
+    RenderRequest& request, RawViewNodeId id, RawViewNodeId parentId, size_t parentIndex, const char* viewClassName) {
+    auto* createElement = request.appendCreateElement();
+    createElement->setElementId(id);
+    createElement->setViewClassName(STRING_LITERAL(viewClassName));
+
+    auto* move = request.appendMoveElementToParent();
+    move->setElementId(id);
+    move->setParentElementId(parentId);
+    move->setParentIndex(static_cast<int>(parentIndex));
+}
+
+/**
+ A root view with a list of cards, each card holding a label.
+ */
+static Ref<RenderRequest> makeInitialRenderRequest(ContextId contextId, AttributeIds& attributeIds) {
+    auto request = makeShared<RenderRequest>();
+    request->setContextId(contextId);
+
+    auto* createRoot = request->appendCreateElement();
+    createRoot->setElementId(kRootId);
+    createRoot->setViewClassName(STRING_LITERAL("SCValdiView"));
+    request->appendSetRootElement()->setElementId(kRootId);
+    appendAttribute(*request, attributeIds, kRootId, "width", Value(375.0));
+
+    for (size_t i = 0; i < kCardsCount; i++) {
+        auto cardId = getCardId(i);
+        appendElement(*request, cardId, kRootId, i, "SCValdiView");
+        appendAttribute(*request, attributeIds, cardId, "height", Value(80.0));
+        appendAttribute(*request, attributeIds, cardId, "margin", Value(8.0));
+        appendAttribute(*request, attributeIds, cardId, "backgroundColor", Value(STRING_LITERAL("white")));
+
+        auto labelId = cardId + 1;
+        appendElement(*request, labelId, cardId, 0, "SCValdiLabel");
+        appendAttribute(*request, attributeIds, labelId, "value", Value(STRING_FORMAT("Card {}", i)));
+        appendAttribute(*request, attributeIds, labelId, "flexGrow", Value(1.0));
+    }
+
+    return request;
+}
 
-    auto context = wrapper.runtime->createContext(STRING_LITERAL("test"), STRING_LITERAL("CSSBenchmark"), Value());
-    context->onCreate();
+/**
+ Moves the cards a bit further, like a scroll driven update would.
+ */
+static Ref<RenderRequest> makeUpdateRenderRequest(ContextId contextId, AttributeIds& attributeIds, size_t index) {
+    auto request = makeShared<RenderRequest>();
+    request->setContextId(contextId);
 
+    for (size_t i = 0; i < kCardsCount; i++) {
+        auto cardId = getCardId(i);
+        appendAttribute(*request, attributeIds, cardId, "height", Value(static_cast<double>(80 + index % 10)));
+        appendAttribute(*request, attributeIds, cardId, "opacity", Value(static_cast<double>(index % 2)));
+    }
+
+    return request;
+}
+
+static void CreateRenderAndDestroy(benchmark::State& state) {
+    BenchmarkRuntime benchmarkRuntime;
+    auto* runtime = benchmarkRuntime.runtime;
+    auto request = makeInitialRenderRequest(0, runtime->getAttributeIds());
+
+    auto allocationsCountBefore = getAllocationsCount();
     for (auto _ : state) {
-        auto tree = wrapper.runtime->createViewNodeTree(context);
-        wrapper.runtime->render(tree, nullptr);
-        wrapper.runtime->destroyViewNodeTree(*tree);
+        auto context = benchmarkRuntime.createContext();
+        request->setContextId(context->getContextId());
+        runtime->processRenderRequest(request);
+        runtime->destroyContext(context);
     }
+
+    state.counters["allocs"] = makeAllocationsCounter(getAllocationsCount() - allocationsCountBefore);
 }
 BENCHMARK(CreateRenderAndDestroy);
 
 static void Destroy(benchmark::State& state) {
-    RuntimeWrapper wrapper(false);
-    wrapper.logger.setMinLogType(Valdi::LogTypeWarn);
-    wrapper.flushQueues();
-
-    auto context = wrapper.runtime->createContext(STRING_LITERAL("test"), STRING_LITERAL("CSSBenchmark"), Value());
-    context->onCreate();
+    BenchmarkRuntime benchmarkRuntime;
+    auto* runtime = benchmarkRuntime.runtime;
+    auto request = makeInitialRenderRequest(0, runtime->getAttributeIds());
 
     for (auto _ : state) {
         state.PauseTiming();
-        auto tree = wrapper.runtime->createViewNodeTree(context);
-        wrapper.runtime->render(tree, nullptr);
+        auto context = benchmarkRuntime.createContext();
+        request->setContextId(context->getContextId());
+        runtime->processRenderRequest(request);
         state.ResumeTiming();
-        wrapper.runtime->destroyViewNodeTree(*tree);
+
+        runtime->destroyContext(context);
     }
 }
 BENCHMARK(Destroy);
 
 static void Render(benchmark::State& state) {
-    RuntimeWrapper wrapper(false);
-    wrapper.logger.setMinLogType(Valdi::LogTypeWarn);
-    wrapper.flushQueues();
-
-    auto context = wrapper.runtime->createContext(STRING_LITERAL("test"), STRING_LITERAL("CSSBenchmark"), Value());
-    context->onCreate();
+    BenchmarkRuntime benchmarkRuntime;
+    auto* runtime = benchmarkRuntime.runtime;
+    auto request = makeInitialRenderRequest(0, runtime->getAttributeIds());
 
+    size_t allocationsCount = 0;
     for (auto _ : state) {
         state.PauseTiming();
-        auto tree = wrapper.runtime->createViewNodeTree(context);
+        auto context = benchmarkRuntime.createContext();
+        request->setContextId(context->getContextId());
+        auto allocationsCountBefore = getAllocationsCount();
         state.ResumeTiming();
-        wrapper.runtime->render(tree, nullptr);
+
+        runtime->processRenderRequest(request);
+
         state.PauseTiming();
-        wrapper.runtime->destroyViewNodeTree(*tree);
+        allocationsCount += getAllocationsCount() - allocationsCountBefore;
+        runtime->destroyContext(context);
         state.ResumeTiming();
     }
+
+    state.counters["allocs"] = makeAllocationsCounter(allocationsCount);
 }
 BENCHMARK(Render);
 
+static void addCSSStyle(Valdi::StyleNode& styleNode, const char* attribute, double value) {
+    auto* style = styleNode.add_styles();
+    style->mutable_attribute()->set_type(Valdi::NodeAttribute_Type_NODE_ATTRIBUTE_TYPE_DOUBLE);
+    style->mutable_attribute()->set_name(attribute);
+    style->mutable_attribute()->set_double_value(value);
+    style->set_id(styleNode.styles_size());
+}
+
+static Valdi::StyleNode& addCSSClassRule(Valdi::CSSRuleIndex& ruleIndex, const char* className) {
+    auto* rule = ruleIndex.add_class_rules();
+    rule->set_name(className);
+    return *rule->mutable_node();
+}
+
+static Ref<CSSDocument> makeCSSDocument(AttributeIds& attributeIds) {
+    Valdi::StyleNode root;
+    auto& ruleIndex = *root.mutable_ruleindex();
+    auto& card = addCSSClassRule(ruleIndex, "card");
+    addCSSStyle(card, "marginTop", 4);
+    addCSSStyle(card, "opacity", 0.9);
+    addCSSStyle(addCSSClassRule(ruleIndex, "label"), "marginLeft", 8);
+
+    return makeShared<CSSDocument>(ResourceId(STRING_LITERAL("benchmark.css")), root, attributeIds);
+}
+
+static void collectViewNodes(ViewNode* viewNode, std::vector<ViewNode*>& output) {
+    output.emplace_back(viewNode);
+    for (size_t i = 0; i < viewNode->getChildCount(); i++) {
+        collectViewNodes(viewNode->getChildAt(i), output);
+    }
+}
+
+/**
+ Updates the CSS of every node of the rendered cards. Before each iteration, the nodes
+ are given a new CSS document with the same rules, so that they all need to be restyled.
+ */
 static void UpdateCSS(benchmark::State& state) {
-    RuntimeWrapper wrapper(false);
-    wrapper.logger.setMinLogType(Valdi::LogTypeWarn);
-    wrapper.flushQueues();
+    BenchmarkRuntime benchmarkRuntime;
+    auto* runtime = benchmarkRuntime.runtime;
+    auto& attributeIds = runtime->getAttributeIds();
+    auto context = benchmarkRuntime.createContext();
+
+    std::array<Value, 2> cssDocuments = {Value(makeCSSDocument(attributeIds)), Value(makeCSSDocument(attributeIds))};
 
-    auto context = wrapper.runtime->createContext(STRING_LITERAL("test"), STRING_LITERAL("CSSBenchmark"), Value());
-    context->onCreate();
-    auto tree = wrapper.runtime->createViewNodeTree(context);
-    wrapper.runtime->render(tree, nullptr);
+    auto request = makeInitialRenderRequest(context->getContextId(), attributeIds);
+    appendAttribute(*request, attributeIds, kRootId, "cssDocument", cssDocuments[0]);
+    for (size_t i = 0; i < kCardsCount; i++) {
+        auto cardId = getCardId(i);
+        appendAttribute(*request, attributeIds, cardId, "cssDocument", cssDocuments[0]);
+        appendAttribute(*request, attributeIds, cardId, "class", Value(STRING_LITERAL("card")));
+        appendAttribute(*request, attributeIds, cardId + 1, "cssDocument", cssDocuments[0]);
+        appendAttribute(*request, attributeIds, cardId + 1, "class", Value(STRING_LITERAL("label")));
+    }
+    runtime->processRenderRequest(request);
+
+    auto tree = runtime->getOrCreateViewNodeTreeForContextId(context->getContextId());
+    std::vector<ViewNode*> viewNodes;
+    collectViewNodes(tree->getRootViewNode().get(), viewNodes);
+
+    const auto* owner = AttributeOwner::getNativeOverridenAttributeOwner();
+    size_t iteration = 0;
 
     for (auto _ : state) {
         state.PauseTiming();
-        tree->getRootViewNode()->resetCssSubtree();
+        iteration++;
+        tree->withLock([&]() {
+            auto& viewTransactionScope = tree->getCurrentViewTransactionScope();
+            for (auto* viewNode : viewNodes) {
+                viewNode->setAttribute(
+                    viewTransactionScope, DefaultAttributeCSSDocument, owner, cssDocuments[iteration % 2], nullptr);
+            }
+        });
         state.ResumeTiming();
 
-        tree->updateCSS(nullptr);
+        tree->withLock([&]() { tree->updateCSS(nullptr); });
     }
+
+    state.counters["nodes"] = static_cast<double>(viewNodes.size());
+    runtime->destroyContext(context);
 }
 BENCHMARK(UpdateCSS);
 
+static constexpr size_t kBackloggedRendersCount = 50;
+
+/**
+ Enqueues kBackloggedRendersCount render requests on a Context while the main thread is
+ not processing them, and measures the time it takes to drain them.
+ Arg 0 applies the requests one by one, Arg 1 goes through the Context which coalesces them.
+ */
+static void DrainBackloggedRenders(benchmark::State& state) {
+    auto coalesce = state.range(0) != 0;
+
+    BenchmarkRuntime benchmarkRuntime;
+    auto* runtime = benchmarkRuntime.runtime;
+    auto& attributeIds = runtime->getAttributeIds();
+    auto context = benchmarkRuntime.createContext();
+
+    runtime->processRenderRequest(makeInitialRenderRequest(context->getContextId(), attributeIds));
+
+    std::vector<Ref<RenderRequest>> requests;
+    for (auto _ : state) {
+        state.PauseTiming();
+        requests.clear();
+        for (size_t i = 1; i <= kBackloggedRendersCount; i++) {
+            requests.emplace_back(makeUpdateRenderRequest(context->getContextId(), attributeIds, i));
+        }
+        if (coalesce) {
+            // Nothing dispatches the requests to the main thread, they pile up in the Context
+            for (const auto& request : requests) {
+                context->enqueueRenderRequest(request);
+            }
+        }
+        state.ResumeTiming();
+
+        if (coalesce) {
+            context->flushRenderRequests();
+        } else {
+            for (const auto& request : requests) {
+                runtime->processRenderRequest(request);
+            }
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kBackloggedRendersCount));
+    runtime->destroyContext(context);
+}
+BENCHMARK(DrainBackloggedRenders)->Arg(0)->Arg(1);
+
 BENCHMARK_MAIN();
@@ -1,5 +1,7 @@
 #include "benchmark/utils/benchmark_utils.hpp"
+#include "valdi_core/cpp/Utils/FlatMap.hpp"
 #include <benchmark/benchmark.h>
+#include <fmt/format.h>
 
 using namespace Valdi;
 
@@ -133,4 +135,52 @@ static void QueryMapWithInternedStrings(benchmark::State& state) {
 }
 BENCHMARK(QueryMapWithInternedStrings)->Range(8, 512);
 
+static const std::vector<std::string>& getSharedStrings() {
+    static auto kStrings = []() {
+        std::vector<std::string> out;
+        for (size_t i = 0; i < 256; i++) {
+            out.emplace_back(makeRandomString(32));
+        }
+        return out;
+    }();
+    return kStrings;
+}
+
+// Many threads interning strings which already exist in the cache,
+// which is the common case for attribute names and style values.
+static void StringCacheMakeStringWarmMultiThreaded(benchmark::State& state) {
+    const auto& strings = getSharedStrings();
+    auto& stringCache = StringCache::getGlobal();
+
+    auto cachedStrings = internStrings(stringCache, strings);
+
+    for (auto _ : state) {
+        for (const auto& str : strings) {
+            benchmark::DoNotOptimize(stringCache.makeString(str));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(strings.size()));
+}
+BENCHMARK(StringCacheMakeStringWarmMultiThreaded)->ThreadRange(1, 16)->UseRealTime();
+
+// Many threads creating and releasing strings which are not shared between threads,
+// which exercises the insertion and removal paths.
+static void StringCacheMakeStringColdMultiThreaded(benchmark::State& state) {
+    auto& stringCache = StringCache::getGlobal();
+    std::vector<std::string> strings;
+    for (size_t i = 0; i < 256; i++) {
+        strings.emplace_back(fmt::format("thread{}_string{}", state.thread_index(), i));
+    }
+
+    for (auto _ : state) {
+        for (const auto& str : strings) {
+            benchmark::DoNotOptimize(stringCache.makeString(str));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(strings.size()));
+}
+BENCHMARK(StringCacheMakeStringColdMultiThreaded)->ThreadRange(1, 16)->UseRealTime();
+
 BENCHMARK_MAIN();
@@ -0,0 +1,38 @@
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<size_t> gAllocatedBytes = 0;
+static std::atomic<size_t> gAllocationsCount = 0;
+
+void* operator new(size_t size) {
+    gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    gAllocationsCount.fetch_add(1, std::memory_order_relaxed);
+    auto* ptr = std::malloc(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t /*size*/) noexcept {
+    std::free(ptr);
+}
+
+size_t getAllocationsCount() {
+    return gAllocationsCount.load(std::memory_order_relaxed);
+}
+
+size_t getAllocatedBytes() {
+    return gAllocatedBytes.load(std::memory_order_relaxed);
+}
+
+benchmark::Counter makeAllocationsCounter(size_t allocationsCount) {
+    return benchmark::Counter(static_cast<double>(allocationsCount), benchmark::Counter::kAvgIterations);
+}
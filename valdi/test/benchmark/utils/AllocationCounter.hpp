@@ -0,0 +1,18 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+/**
+ Heap allocations made through the global operator new since the process started.
+ The counting operator new is only linked into the benchmarks depending on the
+ benchmark_allocation_counter library.
+ */
+size_t getAllocationsCount();
+size_t getAllocatedBytes();
+
+/**
+ Counter reporting the given number of allocations averaged per benchmark iteration.
+ */
+benchmark::Counter makeAllocationsCounter(size_t allocationsCount);
@@ -0,0 +1,77 @@
+#include "valdi/runtime/Attributes/AttributeIds.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+
+using namespace Valdi;
+
+namespace ValdiTest {
+
+TEST(AttributeIds, registersDefaultAttributes) {
+    AttributeIds attributeIds;
+
+    ASSERT_EQ(static_cast<AttributeId>(DefaultAttributeId), attributeIds.getIdForName("id"));
+    ASSERT_EQ(static_cast<AttributeId>(DefaultAttributeOpacity), attributeIds.getIdForName("opacity"));
+    ASSERT_EQ(STRING_LITERAL("accessibilityId"), attributeIds.getNameForId(DefaultAttributeAccessibilityId));
+}
+
+TEST(AttributeIds, keepsIdsStable) {
+    AttributeIds attributeIds;
+
+    auto firstId = attributeIds.getIdForName("firstAttribute");
+    auto secondId = attributeIds.getIdForName(STRING_LITERAL("secondAttribute"));
+    ASSERT_EQ(firstId + 1, secondId);
+
+    // Register enough names to grow the registry a few times
+    for (size_t i = 0; i < 1000; i++) {
+        attributeIds.getIdForName(STRING_FORMAT("attribute{}", i));
+    }
+
+    ASSERT_EQ(firstId, attributeIds.getIdForName("firstAttribute"));
+    ASSERT_EQ(secondId, attributeIds.getIdForName("secondAttribute"));
+    ASSERT_EQ(STRING_LITERAL("firstAttribute"), attributeIds.getNameForId(firstId));
+    ASSERT_EQ(STRING_LITERAL("attribute999"), attributeIds.getNameForId(secondId + 1000));
+    ASSERT_TRUE(attributeIds.getNameForId(secondId + 1001).isEmpty());
+}
+
+TEST(AttributeIds, supportsConcurrentRegistrations) {
+    AttributeIds attributeIds;
+    constexpr size_t kThreadsCount = 4;
+    constexpr size_t kNamesCount = 500;
+    std::vector<std::vector<AttributeId>> idsByThread(kThreadsCount);
+    std::atomic_bool hasMismatch = false;
+
+    std::vector<std::thread> threads;
+    for (size_t threadIndex = 0; threadIndex < kThreadsCount; threadIndex++) {
+        threads.emplace_back([&, threadIndex]() {
+            auto& ids = idsByThread[threadIndex];
+            for (size_t i = 0; i < kNamesCount; i++) {
+                // Threads register the same names in different orders
+                auto nameIndex = (i + threadIndex * 97) % kNamesCount;
+                auto name = STRING_FORMAT("attribute{}", nameIndex);
+                auto id = attributeIds.getIdForName(name);
+                if (attributeIds.getNameForId(id) != name || attributeIds.getIdForName("id") != DefaultAttributeId) {
+                    hasMismatch = true;
+                }
+                ids.emplace_back(id);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_FALSE(hasMismatch);
+    for (size_t threadIndex = 0; threadIndex < kThreadsCount; threadIndex++) {
+        for (size_t i = 0; i < kNamesCount; i++) {
+            auto nameIndex = (i + threadIndex * 97) % kNamesCount;
+            ASSERT_EQ(attributeIds.getIdForName(STRING_FORMAT("attribute{}", nameIndex)), idsByThread[threadIndex][i]);
+        }
+    }
+    ASSERT_FALSE(attributeIds.getNameForId(DefaultAttributeAccessibilityId + kNamesCount).isEmpty());
+    ASSERT_TRUE(attributeIds.getNameForId(DefaultAttributeAccessibilityId + kNamesCount + 1).isEmpty());
+}
+
+} // namespace ValdiTest
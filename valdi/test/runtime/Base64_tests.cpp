@@ -0,0 +1,138 @@
+#include "utils/encoding/Base64Utils.hpp"
+#include "valdi_core/cpp/Utils/ByteBuffer.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace snap::utils::encoding;
+
+namespace ValdiTest {
+
+static std::vector<uint8_t> makeData(size_t size) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+        data[i] = static_cast<uint8_t>(i * 131 + 7);
+    }
+    return data;
+}
+
+TEST(Base64, canEncodeTestVectors) {
+    ASSERT_EQ("", binaryToBase64(std::string("")));
+    ASSERT_EQ("Zg==", binaryToBase64(std::string("f")));
+    ASSERT_EQ("Zm8=", binaryToBase64(std::string("fo")));
+    ASSERT_EQ("Zm9v", binaryToBase64(std::string("foo")));
+    ASSERT_EQ("Zm9vYg==", binaryToBase64(std::string("foob")));
+    ASSERT_EQ("Zm9vYmE=", binaryToBase64(std::string("fooba")));
+    ASSERT_EQ("Zm9vYmFy", binaryToBase64(std::string("foobar")));
+    ASSERT_EQ("VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZy4/Pz8+Pg==",
+              binaryToBase64(std::string("The quick brown fox jumps over the lazy dog.???>>")));
+}
+
+TEST(Base64, canDecodeTestVectors) {
+    auto decode = [](std::string_view base64) {
+        auto bytes = base64ToBinary(base64);
+        return std::string(bytes.begin(), bytes.end());
+    };
+
+    ASSERT_EQ("f", decode("Zg=="));
+    ASSERT_EQ("fo", decode("Zm8="));
+    ASSERT_EQ("foobar", decode("Zm9vYmFy"));
+    ASSERT_EQ("The quick brown fox jumps over the lazy dog.???>>",
+              decode("VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZy4/Pz8+Pg=="));
+}
+
+TEST(Base64, roundTripsAcrossBlockSizes) {
+    // Covers the scalar tails around the 12 and 24 bytes blocks of the vectorized kernels
+    for (size_t size = 0; size < 200; size++) {
+        auto data = makeData(size);
+        auto base64 = binaryToBase64(data);
+        ASSERT_EQ(base64EncodedLength(size), base64.size());
+
+        std::vector<uint8_t> decoded;
+        ASSERT_EQ(size > 0, base64ToBinary(base64, decoded));
+        ASSERT_EQ(data, decoded);
+    }
+}
+
+TEST(Base64, skipsNewlinesWhenDecoding) {
+    auto data = makeData(300);
+    auto base64 = binaryToBase64(data);
+
+    std::string wrapped;
+    for (size_t i = 0; i < base64.size(); i += 76) {
+        wrapped += base64.substr(i, 76);
+        wrapped += "\r\n";
+    }
+    // Newlines can also split a quad
+    wrapped.insert(wrapped.begin() + 2, '\n');
+
+    std::vector<uint8_t> decoded;
+    ASSERT_TRUE(base64ToBinary(wrapped, decoded));
+    ASSERT_EQ(data, decoded);
+}
+
+TEST(Base64, rejectsInvalidInputs) {
+    auto base64 = binaryToBase64(makeData(100));
+    std::vector<uint8_t> decoded;
+
+    ASSERT_FALSE(base64ToBinary("", decoded));
+    ASSERT_FALSE(base64ToBinary("\n", decoded));
+    // Incomplete quad
+    ASSERT_FALSE(base64ToBinary(std::string_view(base64).substr(0, base64.size() - 1), decoded));
+    ASSERT_TRUE(decoded.empty());
+    // Invalid character within a vectorized block
+    auto invalid = base64;
+    invalid[40] = '!';
+    ASSERT_FALSE(base64ToBinary(invalid, decoded));
+    // Padding which is not at the end
+    ASSERT_FALSE(base64ToBinary("Zg==Zm9v", decoded));
+    ASSERT_FALSE(base64ToBinary("Z===", decoded));
+    ASSERT_FALSE(base64ToBinary("Zg=v", decoded));
+}
+
+TEST(Base64, canStreamChunks) {
+    auto data = makeData(1000);
+    auto expected = binaryToBase64(data);
+
+    for (size_t chunkSize : {1, 2, 5, 64, 333}) {
+        Base64Encoder encoder;
+        std::string encoded;
+        for (size_t i = 0; i < data.size(); i += chunkSize) {
+            auto size = std::min(chunkSize, data.size() - i);
+            auto offset = encoded.size();
+            encoded.resize(offset + Base64Encoder::maxEncodedLength(size));
+            encoded.resize(offset + encoder.encode(data.data() + i, size, encoded.data() + offset));
+        }
+        char tail[4];
+        encoded.append(tail, encoder.finish(tail));
+        ASSERT_EQ(expected, encoded);
+
+        Base64Decoder decoder;
+        std::vector<uint8_t> decoded;
+        for (size_t i = 0; i < encoded.size(); i += chunkSize) {
+            auto chunk = std::string_view(encoded).substr(i, chunkSize);
+            auto offset = decoded.size();
+            decoded.resize(offset + Base64Decoder::maxDecodedLength(chunk.size()));
+            size_t written = 0;
+            ASSERT_TRUE(decoder.decode(chunk, decoded.data() + offset, &written));
+            decoded.resize(offset + written);
+        }
+        ASSERT_TRUE(decoder.finish());
+        ASSERT_EQ(data, decoded);
+    }
+}
+
+TEST(Base64, canAppendToByteBuffer) {
+    auto data = makeData(100);
+
+    Valdi::ByteBuffer buffer;
+    buffer.append(std::string_view("base64:"));
+    appendBinaryToBase64(data.data(), data.size(), buffer);
+    ASSERT_EQ("base64:" + binaryToBase64(data), buffer.toStringView());
+
+    Valdi::ByteBuffer decoded;
+    ASSERT_TRUE(appendBase64ToBinary(buffer.toStringView().substr(7), decoded));
+    ASSERT_EQ(data, decoded.toBytesVec());
+}
+
+} // namespace ValdiTest
@@ -0,0 +1,283 @@
+#include "valdi/runtime/Attributes/AttributesApplier.hpp"
+#include "valdi/runtime/CSS/CSSAttributesManager.hpp"
+#include "valdi/runtime/CSS/CSSDocument.hpp"
+#include "valdi/runtime/Utils/MainThreadManager.hpp"
+#include "valdi/runtime/Views/ViewTransactionScope.hpp"
+#include "valdi_core/cpp/Utils/ConsoleLogger.hpp"
+#include "valdi_core/cpp/Utils/FlatMap.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
+#include <gtest/gtest.h>
+
+using namespace Valdi;
+
+namespace ValdiTest {
+
+class TestAttributesApplier : public AttributesApplier {
+public:
+    size_t setAttributeCount = 0;
+
+    bool setAttribute(ViewTransactionScope& /*viewTransactionScope*/,
+                      AttributeId id,
+                      const AttributeOwner* /*owner*/,
+                      const Value& value,
+                      const Ref<Animator>& /*animator*/) override {
+        setAttributeCount++;
+        if (value.isUndefined()) {
+            return _attributes.erase(id) > 0;
+        }
+
+        auto& currentValue = _attributes[id];
+        auto changed = currentValue != value;
+        currentValue = value;
+        return changed;
+    }
+
+    bool hasResolvedAttributeValue(AttributeId id) const override {
+        return _attributes.find(id) != _attributes.end();
+    }
+
+    Value getResolvedAttributeValue(AttributeId id) const override {
+        const auto& it = _attributes.find(id);
+        if (it == _attributes.end()) {
+            return Value::undefined();
+        }
+        return it->second;
+    }
+
+    bool removeAllAttributesForOwner(ViewTransactionScope& /*viewTransactionScope*/,
+                                     const AttributeOwner* /*owner*/,
+                                     const Ref<Animator>& /*animator*/) override {
+        return false;
+    }
+
+    void reapplyAttribute(ViewTransactionScope& /*viewTransactionScope*/, AttributeId /*id*/) override {}
+
+    void flush(ViewTransactionScope& /*viewTransactionScope*/) override {}
+
+    bool needsFlush() const override {
+        return false;
+    }
+
+private:
+    FlatMap<AttributeId, Value> _attributes;
+};
+
+class CSSTestNode {
+public:
+    CSSAttributesManager manager;
+    TestAttributesApplier applier;
+
+    void updateCSS(ViewTransactionScope& viewTransactionScope) {
+        Ref<Animator> animator;
+        manager.updateCSS(
+            CSSAttributesManagerUpdateContext(viewTransactionScope, applier, ConsoleLogger::getLogger(), animator));
+    }
+};
+
+static void addStyle(Valdi::StyleNode& styleNode, const char* attribute, double value, int id) {
+    auto* style = styleNode.add_styles();
+    style->mutable_attribute()->set_type(Valdi::NodeAttribute_Type_NODE_ATTRIBUTE_TYPE_DOUBLE);
+    style->mutable_attribute()->set_name(attribute);
+    style->mutable_attribute()->set_double_value(value);
+    style->set_id(id);
+}
+
+static Valdi::StyleNode& addClassRule(Valdi::CSSRuleIndex& ruleIndex, const char* className) {
+    auto* rule = ruleIndex.add_class_rules();
+    rule->set_name(className);
+    return *rule->mutable_node();
+}
+
+class CSSAttributesManagerTest : public ::testing::Test {
+protected:
+    AttributeIds attributeIds;
+    ViewTransactionScope viewTransactionScope = ViewTransactionScope(nullptr, nullptr, false);
+    AttributeId opacityId = attributeIds.getIdForName("opacity");
+    AttributeId marginId = attributeIds.getIdForName("margin");
+
+    Ref<CSSDocument> makeDocument(const Valdi::StyleNode& styleNode) {
+        return makeShared<CSSDocument>(ResourceId(STRING_LITERAL("test.css")), styleNode, attributeIds);
+    }
+
+    /**
+     .item { opacity: 0.5 }
+     .highlighted .item { margin: 4 }
+     */
+    Ref<CSSDocument> makeDocumentWithAncestorRule() {
+        Valdi::StyleNode root;
+        auto& item = addClassRule(*root.mutable_ruleindex(), "item");
+        addStyle(item, "opacity", 0.5, 1);
+        auto& highlighted = addClassRule(*item.mutable_ruleindex()->mutable_ancestor_rules(), "highlighted");
+        addStyle(highlighted, "margin", 4, 2);
+        return makeDocument(root);
+    }
+
+    /**
+     .item { opacity: 0.5 }
+     .item:first-child { margin: 8 }
+     */
+    Ref<CSSDocument> makeDocumentWithSiblingRule() {
+        Valdi::StyleNode root;
+        auto& item = addClassRule(*root.mutable_ruleindex(), "item");
+        addStyle(item, "opacity", 0.5, 1);
+        addStyle(*item.mutable_ruleindex()->mutable_first_child_rule(), "margin", 8, 2);
+        return makeDocument(root);
+    }
+
+    void setUp(CSSTestNode& node,
+               const Ref<CSSDocument>& document,
+               const char* cssClass,
+               int siblingsCount = 1,
+               int indexAmongSiblings = 0) {
+        node.manager.setCSSDocument(Value(document), false);
+        node.manager.setCSSClass(Value(STRING_LITERAL(cssClass)), false);
+        node.manager.setSiblingsIndexes(siblingsCount, indexAmongSiblings);
+        node.updateCSS(viewTransactionScope);
+    }
+};
+
+TEST_F(CSSAttributesManagerTest, appliesMatchedRules) {
+    Valdi::StyleNode root;
+    addStyle(addClassRule(*root.mutable_ruleindex(), "item"), "opacity", 0.5, 1);
+    auto document = makeDocument(root);
+
+    CSSTestNode node;
+    setUp(node, document, "item");
+    ASSERT_EQ(Value(0.5), node.applier.getResolvedAttributeValue(opacityId));
+
+    ASSERT_TRUE(node.manager.setCSSClass(Value(STRING_LITERAL("other")), false));
+    node.updateCSS(viewTransactionScope);
+    ASSERT_FALSE(node.applier.hasResolvedAttributeValue(opacityId));
+}
+
+TEST_F(CSSAttributesManagerTest, skipsMatchingWhenChangedInputsAreNotSelected) {
+    Valdi::StyleNode root;
+    addStyle(addClassRule(*root.mutable_ruleindex(), "item"), "opacity", 0.5, 1);
+    auto document = makeDocument(root);
+
+    CSSTestNode node;
+    setUp(node, document, "item");
+    auto setAttributeCount = node.applier.setAttributeCount;
+
+    // No selector of the document reads the id or the position of the node
+    ASSERT_TRUE(node.manager.setElementId(STRING_LITERAL("myId"), false));
+    ASSERT_TRUE(node.manager.setSiblingsIndexes(3, 1));
+    node.updateCSS(viewTransactionScope);
+
+    ASSERT_EQ(setAttributeCount, node.applier.setAttributeCount);
+    ASSERT_EQ(Value(0.5), node.applier.getResolvedAttributeValue(opacityId));
+}
+
+TEST_F(CSSAttributesManagerTest, doesNotReapplySameDeclarations) {
+    Valdi::StyleNode root;
+    addStyle(addClassRule(*root.mutable_ruleindex(), "item"), "opacity", 0.5, 1);
+    auto document = makeDocument(root);
+
+    CSSTestNode node;
+    setUp(node, document, "item");
+    auto setAttributeCount = node.applier.setAttributeCount;
+
+    ASSERT_TRUE(node.manager.setCSSClass(Value(STRING_LITERAL("item other")), false));
+    node.updateCSS(viewTransactionScope);
+
+    ASSERT_EQ(setAttributeCount, node.applier.setAttributeCount);
+}
+
+TEST_F(CSSAttributesManagerTest, restylesWhenSiblingPositionChanges) {
+    auto document = makeDocumentWithSiblingRule();
+
+    CSSTestNode node;
+    setUp(node, document, "item", 2, 0);
+    ASSERT_EQ(Value(8.0), node.applier.getResolvedAttributeValue(marginId));
+
+    ASSERT_TRUE(node.manager.setSiblingsIndexes(2, 1));
+    node.updateCSS(viewTransactionScope);
+    ASSERT_FALSE(node.applier.hasResolvedAttributeValue(marginId));
+    ASSERT_EQ(Value(0.5), node.applier.getResolvedAttributeValue(opacityId));
+}
+
+TEST_F(CSSAttributesManagerTest, restylesDescendantsDependingOnAncestors) {
+    auto document = makeDocumentWithAncestorRule();
+
+    CSSTestNode parent;
+    CSSTestNode child;
+    CSSTestNode otherChild;
+    child.manager.setParent(&parent.manager);
+    otherChild.manager.setParent(&parent.manager);
+    setUp(parent, document, "");
+    setUp(child, document, "item");
+    setUp(otherChild, document, "other");
+    ASSERT_FALSE(child.applier.hasResolvedAttributeValue(marginId));
+
+    ASSERT_TRUE(parent.manager.setCSSClass(Value(STRING_LITERAL("highlighted")), false));
+    ASSERT_TRUE(parent.manager.canAffectDescendantsCSS());
+    parent.updateCSS(viewTransactionScope);
+
+    // Only the child which matched a rule on its ancestors needs to be updated
+    ASSERT_TRUE(child.manager.setAncestorsChanged());
+    ASSERT_FALSE(otherChild.manager.setAncestorsChanged());
+
+    child.updateCSS(viewTransactionScope);
+    ASSERT_EQ(Value(4.0), child.applier.getResolvedAttributeValue(marginId));
+    ASSERT_EQ(Value(0.5), child.applier.getResolvedAttributeValue(opacityId));
+}
+
+TEST_F(CSSAttributesManagerTest, descendantsAreNotAffectedWithoutAncestorSelectors) {
+    Valdi::StyleNode root;
+    addStyle(addClassRule(*root.mutable_ruleindex(), "item"), "opacity", 0.5, 1);
+    auto document = makeDocument(root);
+
+    CSSTestNode parent;
+    CSSTestNode child;
+    child.manager.setParent(&parent.manager);
+
+    // A node which was just inserted can affect its descendants, since they have new ancestors
+    ASSERT_TRUE(child.manager.canAffectDescendantsCSS());
+
+    setUp(parent, document, "item");
+    setUp(child, document, "item");
+
+    ASSERT_TRUE(parent.manager.setCSSClass(Value(STRING_LITERAL("other")), false));
+    ASSERT_FALSE(parent.manager.canAffectDescendantsCSS());
+    ASSERT_FALSE(child.manager.canAffectDescendantsCSS());
+}
+
+TEST_F(CSSAttributesManagerTest, memoizesMatchesBySignature) {
+    auto document = makeDocumentWithSiblingRule();
+
+    CSSTestNode node;
+    setUp(node, document, "item", 2, 1);
+
+    CSSSelectorSignature signature;
+    signature.cssClass = STRING_LITERAL("item");
+    signature.indexAmongSiblings = 1;
+    signature.siblingsCount = 2;
+
+    CSSMatchedDeclarations declarations;
+    CSSSelectorDependencies dependencies = kCSSSelectorDependencyNone;
+    ASSERT_TRUE(document->getMemoizedMatch(signature, declarations, dependencies));
+    ASSERT_EQ(static_cast<size_t>(1), declarations.size());
+    ASSERT_EQ(kCSSSelectorDependencyClass | kCSSSelectorDependencySiblingPosition, dependencies);
+
+    // The match of a node with the same signature is taken from the memoized one
+    CSSTestNode otherNode;
+    setUp(otherNode, document, "item", 2, 1);
+    ASSERT_EQ(Value(0.5), otherNode.applier.getResolvedAttributeValue(opacityId));
+    ASSERT_FALSE(otherNode.applier.hasResolvedAttributeValue(marginId));
+}
+
+TEST_F(CSSAttributesManagerTest, doesNotMemoizeMatchesDependingOnAncestors) {
+    auto document = makeDocumentWithAncestorRule();
+
+    CSSTestNode node;
+    setUp(node, document, "item");
+
+    CSSSelectorSignature signature;
+    signature.cssClass = STRING_LITERAL("item");
+
+    CSSMatchedDeclarations declarations;
+    CSSSelectorDependencies dependencies = kCSSSelectorDependencyNone;
+    ASSERT_FALSE(document->getMemoizedMatch(signature, declarations, dependencies));
+}
+
+} // namespace ValdiTest
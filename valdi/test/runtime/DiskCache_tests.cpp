@@ -6,6 +6,7 @@
 //
 
 #include "valdi/runtime/Resources/DiskCacheImpl.hpp"
+#include "valdi_core/cpp/Utils/ByteBuffer.hpp"
 #include "valdi_core/cpp/Utils/DiskUtils.hpp"
 #include "valdi_core/cpp/Utils/Exception.hpp"
 #include "valdi_core/cpp/Utils/Format.hpp"
@@ -204,4 +205,114 @@ TEST(DiskCache, scopedInstanceRespectsIsolation) {
     ASSERT_FALSE(result.success()) << result.description();
 }
 
+BytesView createLargeContent(char c) {
+    auto bytes = makeShared<ByteBuffer>();
+    for (size_t i = 0; i < 64 * 1024; i++) {
+        bytes->append(static_cast<Byte>(c + (i % 7)));
+    }
+    return bytes->toBytesView();
+}
+
+TEST(DiskCache, canLoadMapped) {
+    TemporaryDirectory directory;
+    DiskCacheImpl diskCache(directory.get());
+
+    auto content = createLargeContent('a');
+    auto result = diskCache.store(Path("module"), content);
+    ASSERT_TRUE(result.success()) << result.description();
+
+    auto loadResult = diskCache.loadMapped(Path("module"));
+    ASSERT_TRUE(loadResult.success()) << loadResult.description();
+    ASSERT_EQ(content, loadResult.value());
+
+    // Small files are also supported
+    result = diskCache.store(Path("hello"), createContent("world"));
+    ASSERT_TRUE(result.success()) << result.description();
+
+    loadResult = diskCache.loadMapped(Path("hello"));
+    ASSERT_TRUE(loadResult.success()) << loadResult.description();
+    ASSERT_EQ(createContent("world"), loadResult.value());
+
+    loadResult = diskCache.loadMapped(Path("not_found"));
+    ASSERT_FALSE(loadResult.success());
+}
+
+TEST(DiskCache, mappedContentSurvivesOverwriteAndRemove) {
+    TemporaryDirectory directory;
+    DiskCacheImpl diskCache(directory.get());
+
+    auto content = createLargeContent('a');
+    auto result = diskCache.store(Path("module"), content);
+    ASSERT_TRUE(result.success()) << result.description();
+
+    auto loadResult = diskCache.loadMapped(Path("module"));
+    ASSERT_TRUE(loadResult.success()) << loadResult.description();
+    auto mapped = loadResult.moveValue();
+
+    auto newContent = createLargeContent('k');
+    result = diskCache.store(Path("module"), newContent);
+    ASSERT_TRUE(result.success()) << result.description();
+
+    // Previously mapped content should be unaffected
+    ASSERT_EQ(content, mapped);
+
+    loadResult = diskCache.loadMapped(Path("module"));
+    ASSERT_TRUE(loadResult.success()) << loadResult.description();
+    ASSERT_EQ(newContent, loadResult.value());
+
+    ASSERT_TRUE(diskCache.remove(Path("module")));
+    ASSERT_EQ(content, mapped);
+
+    // No temporary files should be left behind
+    ASSERT_TRUE(diskCache.list(diskCache.getRootPath()).empty());
+}
+
+TEST(DiskCache, canAppendAndLoadRecords) {
+    TemporaryDirectory directory;
+    DiskCacheImpl diskCache(directory.get());
+
+    auto result = diskCache.appendRecords(Path("journal/records"), {createContent("hello"), createContent("world")});
+    ASSERT_TRUE(result.success()) << result.description();
+    result = diskCache.appendRecords(Path("journal/records"), {createContent("!")});
+    ASSERT_TRUE(result.success()) << result.description();
+
+    auto records = diskCache.loadRecords(Path("journal/records"));
+    ASSERT_TRUE(records.success()) << records.description();
+    ASSERT_EQ(std::vector<BytesView>({createContent("hello"), createContent("world"), createContent("!")}),
+              records.value());
+}
+
+TEST(DiskCache, canAppend) {
+    TemporaryDirectory directory;
+    DiskCacheImpl diskCache(directory.get());
+
+    auto result = diskCache.append(Path("dir/file"), createContent("hello"));
+    ASSERT_TRUE(result.success()) << result.description();
+    result = diskCache.append(Path("dir/file"), createContent(" world"));
+    ASSERT_TRUE(result.success()) << result.description();
+
+    auto data = diskCache.loadAppended(Path("dir/file"));
+    ASSERT_TRUE(data.success()) << data.description();
+    ASSERT_EQ("hello world", data.value().asStringView());
+}
+
+TEST(DiskCache, ignoresTruncatedRecord) {
+    TemporaryDirectory directory;
+    DiskCacheImpl diskCache(directory.get());
+
+    auto result = diskCache.appendRecords(Path("records"), {createContent("hello"), createContent("world")});
+    ASSERT_TRUE(result.success()) << result.description();
+
+    // Simulate a write that was interrupted in the middle of the last record
+    auto data = diskCache.load(Path("records"));
+    ASSERT_TRUE(data.success()) << data.description();
+    auto truncated = BytesView(data.value().getSource(), data.value().data(), data.value().size() - 2);
+    result = diskCache.store(Path("records"), truncated);
+    ASSERT_TRUE(result.success()) << result.description();
+
+    auto records = diskCache.loadRecords(Path("records"));
+    ASSERT_TRUE(records.success()) << records.description();
+    ASSERT_EQ(std::vector<BytesView>({createContent("hello")}), records.value());
+}
+
 } // namespace ValdiTest
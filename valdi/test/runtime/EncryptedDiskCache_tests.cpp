@@ -88,4 +88,25 @@ TEST(EncryptedDiskCache, decryptsOnLoad) {
     ASSERT_EQ("Hello World", data.value().asStringView());
 }
 
+TEST(EncryptedDiskCache, appendsEncryptedChunks) {
+    auto innerDiskCache = makeShared<InMemoryDiskCache>();
+    auto keychain = makeShared<InMemoryKeychain>();
+    auto diskCache = makeShared<EncryptedDiskCache>(innerDiskCache, keychain);
+
+    auto result = diskCache->append(Path("file.txt"), makeData("Hello"));
+    ASSERT_TRUE(result) << result.description();
+    result = diskCache->append(Path("file.txt"), makeData(" World"));
+    ASSERT_TRUE(result) << result.description();
+
+    auto records = innerDiskCache->loadRecords(Path("file.txt"));
+    ASSERT_TRUE(records) << records.description();
+    ASSERT_EQ(static_cast<size_t>(2), records.value().size());
+    ASSERT_NE("Hello", records.value()[0].asStringView());
+
+    auto data = diskCache->loadAppended(Path("file.txt"));
+    ASSERT_TRUE(data) << data.description();
+
+    ASSERT_EQ("Hello World", data.value().asStringView());
+}
+
 } // namespace
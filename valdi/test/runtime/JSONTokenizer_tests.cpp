@@ -0,0 +1,230 @@
+#include "valdi_core/cpp/Utils/JSONTokenizer.hpp"
+#include <gtest/gtest.h>
+#include <optional>
+
+using namespace Valdi;
+
+namespace ValdiTest {
+
+using TokenType = JSONTokenizer::TokenType;
+
+struct TokenizedToken {
+    TokenType type;
+    std::string value;
+
+    bool operator==(const TokenizedToken& other) const {
+        return type == other.type && value == other.value;
+    }
+};
+
+std::ostream& operator<<(std::ostream& os, const TokenizedToken& token) {
+    return os << static_cast<int>(token.type) << ":" << token.value;
+}
+
+static std::vector<TokenizedToken> tokenizeInChunks(std::string_view json, size_t chunkSize) {
+    std::vector<TokenizedToken> output;
+    JSONTokenizer tokenizer;
+
+    size_t offset = 0;
+    for (;;) {
+        auto token = tokenizer.next();
+        if (token.type == TokenType::NeedsInput) {
+            if (offset == json.size()) {
+                tokenizer.finish();
+            } else {
+                auto length = std::min(chunkSize, json.size() - offset);
+                tokenizer.feed(json.substr(offset, length));
+                offset += length;
+            }
+            continue;
+        }
+
+        output.emplace_back(TokenizedToken{token.type, std::string(token.value)});
+        if (token.type == TokenType::End || token.type == TokenType::Error) {
+            return output;
+        }
+    }
+}
+
+static std::vector<TokenizedToken> tokenize(std::string_view json) {
+    std::vector<TokenizedToken> output;
+    JSONTokenizer tokenizer(json);
+
+    for (;;) {
+        auto token = tokenizer.next();
+        output.emplace_back(TokenizedToken{token.type, std::string(token.value)});
+        if (token.type == TokenType::End || token.type == TokenType::Error) {
+            return output;
+        }
+    }
+}
+
+TEST(JSONTokenizer, canTokenizeDocument) {
+    auto tokens = tokenize(R"({"key": [1, -2.5e3, true, false, null, "value"], "nested": {}})");
+
+    std::vector<TokenizedToken> expectedTokens = {
+        {TokenType::BeginObject, "{"}, {TokenType::String, "key"},   {TokenType::Colon, ":"},
+        {TokenType::BeginArray, "["},  {TokenType::Number, "1"},     {TokenType::Comma, ","},
+        {TokenType::Number, "-2.5e3"}, {TokenType::Comma, ","},      {TokenType::True, "true"},
+        {TokenType::Comma, ","},       {TokenType::False, "false"},  {TokenType::Comma, ","},
+        {TokenType::Null, "null"},     {TokenType::Comma, ","},      {TokenType::String, "value"},
+        {TokenType::EndArray, "]"},    {TokenType::Comma, ","},      {TokenType::String, "nested"},
+        {TokenType::Colon, ":"},       {TokenType::BeginObject, "{"}, {TokenType::EndObject, "}"},
+        {TokenType::EndObject, "}"},   {TokenType::End, ""},
+    };
+
+    ASSERT_EQ(expectedTokens, tokens);
+}
+
+TEST(JSONTokenizer, returnsViewsIntoInputForStringsWithoutEscapes) {
+    std::string json = R"(["Hello World", "Hello\nWorld"])";
+    JSONTokenizer tokenizer(json);
+
+    ASSERT_EQ(TokenType::BeginArray, tokenizer.next().type);
+
+    auto token = tokenizer.next();
+    ASSERT_EQ(TokenType::String, token.type);
+    ASSERT_EQ("Hello World", token.value);
+    ASSERT_EQ(json.data() + 2, token.value.data());
+
+    ASSERT_EQ(TokenType::Comma, tokenizer.next().type);
+
+    token = tokenizer.next();
+    ASSERT_EQ(TokenType::String, token.type);
+    ASSERT_EQ("Hello\nWorld", token.value);
+
+    ASSERT_EQ(TokenType::EndArray, tokenizer.next().type);
+    ASSERT_EQ(TokenType::End, tokenizer.next().type);
+    ASSERT_EQ(json.size(), tokenizer.position());
+}
+
+TEST(JSONTokenizer, canDecodeEscapedStrings) {
+    auto tokens = tokenize(R"(["\"quoted\"", "back\\slash\\", "\u00e9\ud83d\ude00", "\\\""])");
+
+    ASSERT_EQ(10u, tokens.size());
+    ASSERT_EQ((TokenizedToken{TokenType::String, "\"quoted\""}), tokens[1]);
+    ASSERT_EQ((TokenizedToken{TokenType::String, "back\\slash\\"}), tokens[3]);
+    ASSERT_EQ((TokenizedToken{TokenType::String, "\xC3\xA9\xF0\x9F\x98\x80"}), tokens[5]);
+    ASSERT_EQ((TokenizedToken{TokenType::String, "\\\""}), tokens[7]);
+}
+
+TEST(JSONTokenizer, producesSameTokensWhenFedInChunks) {
+    std::string json = "{";
+    for (size_t i = 0; i < 200; i++) {
+        if (i != 0) {
+            json += ",\n  ";
+        }
+        json += "\"key" + std::to_string(i) + "\": ";
+        switch (i % 5) {
+            case 0:
+                json += std::to_string(i * 1234567) + ".25";
+                break;
+            case 1:
+                json += "\"" + std::string(i, 'a') + "\\\\" + std::string(i % 7, '\\') + std::string(i % 7, '\\') +
+                        "\\\"end\"";
+                break;
+            case 2:
+                json += "[true, false, null, {\"a\": [[]]}]";
+                break;
+            case 3:
+                json += "\"{[:,]} \\u0041\"";
+                break;
+            default:
+                json += "-0";
+                break;
+        }
+    }
+    json += "}";
+
+    auto expectedTokens = tokenize(json);
+    ASSERT_EQ(TokenType::End, expectedTokens.back().type);
+
+    for (size_t chunkSize : {1, 2, 3, 7, 63, 64, 65, 127, 1000}) {
+        ASSERT_EQ(expectedTokens, tokenizeInChunks(json, chunkSize)) << "chunkSize " << chunkSize;
+    }
+}
+
+TEST(JSONTokenizer, completesScalarAtEndOfStream) {
+    auto tokens = tokenizeInChunks("12345", 2);
+
+    std::vector<TokenizedToken> expectedTokens = {
+        {TokenType::Number, "12345"},
+        {TokenType::End, ""},
+    };
+    ASSERT_EQ(expectedTokens, tokens);
+}
+
+TEST(JSONTokenizer, failsOnUnterminatedString) {
+    JSONTokenizer tokenizer(R"(["Hello)");
+
+    ASSERT_EQ(TokenType::BeginArray, tokenizer.next().type);
+    ASSERT_EQ(TokenType::Error, tokenizer.next().type);
+    ASSERT_TRUE(tokenizer.hasError());
+    ASSERT_EQ("Unterminated string at position 1", tokenizer.getError().toString());
+
+    auto tokens = tokenizeInChunks(R"(["Hello)", 3);
+    ASSERT_EQ(TokenType::Error, tokens.back().type);
+}
+
+TEST(JSONTokenizer, failsOnInvalidTokens) {
+    ASSERT_EQ(TokenType::Error, tokenize("[tru]")[1].type);
+    ASSERT_EQ(TokenType::Error, tokenize("[nulll]")[1].type);
+    ASSERT_EQ(TokenType::Error, tokenize("[01]")[1].type);
+    ASSERT_EQ(TokenType::Error, tokenize("[1.]")[1].type);
+    ASSERT_EQ(TokenType::Error, tokenize("[1e]")[1].type);
+    ASSERT_EQ(TokenType::Error, tokenize("[-]")[1].type);
+    ASSERT_EQ(TokenType::Error, tokenize(R"(["\x"])")[1].type);
+    ASSERT_EQ(TokenType::Error, tokenize(R"(["\u12"])")[1].type);
+
+    JSONTokenizer tokenizer("[1, what]");
+    while (tokenizer.next().type != TokenType::Error) {
+    }
+    ASSERT_EQ("Invalid token 'what' at position 4", tokenizer.getError().toString());
+}
+
+static std::optional<std::vector<uint32_t>> parseUIntArray(std::string_view json) {
+    JSONTokenizer tokenizer(json);
+    std::vector<uint32_t> output;
+    if (tokenizer.next().type != TokenType::BeginArray || !tokenizer.parseUIntArray(output)) {
+        return std::nullopt;
+    }
+    return output;
+}
+
+TEST(JSONTokenizer, canParseUIntArray) {
+    ASSERT_EQ((std::vector<uint32_t>{1, 0, 42, 4294967295}), parseUIntArray("[1,0, 42 ,\n4294967295]"));
+    ASSERT_EQ(std::vector<uint32_t>(), parseUIntArray("[ ]"));
+
+    JSONTokenizer tokenizer(R"({"a": [1, 2], "b": true})");
+    std::vector<uint32_t> output;
+    ASSERT_EQ(TokenType::BeginObject, tokenizer.next().type);
+    ASSERT_EQ(TokenType::String, tokenizer.next().type);
+    ASSERT_EQ(TokenType::Colon, tokenizer.next().type);
+    ASSERT_EQ(TokenType::BeginArray, tokenizer.next().type);
+    ASSERT_TRUE(tokenizer.parseUIntArray(output));
+    ASSERT_EQ((std::vector<uint32_t>{1, 2}), output);
+    ASSERT_EQ(static_cast<size_t>(12), tokenizer.position());
+    ASSERT_EQ(TokenType::Comma, tokenizer.next().type);
+    ASSERT_EQ(TokenType::String, tokenizer.next().type);
+}
+
+TEST(JSONTokenizer, failsOnInvalidUIntArray) {
+    ASSERT_EQ(std::nullopt, parseUIntArray("[-1]"));
+    ASSERT_EQ(std::nullopt, parseUIntArray("[1.5]"));
+    ASSERT_EQ(std::nullopt, parseUIntArray("[1e3]"));
+    ASSERT_EQ(std::nullopt, parseUIntArray("[01]"));
+    ASSERT_EQ(std::nullopt, parseUIntArray("[4294967296]"));
+    ASSERT_EQ(std::nullopt, parseUIntArray(R"(["1"])"));
+    ASSERT_EQ(std::nullopt, parseUIntArray("[1 2]"));
+    ASSERT_EQ(std::nullopt, parseUIntArray("[1,]"));
+    ASSERT_EQ(std::nullopt, parseUIntArray("[1, [2]]"));
+    ASSERT_EQ(std::nullopt, parseUIntArray("[1, 2"));
+
+    JSONTokenizer tokenizer("[1, 2x]");
+    std::vector<uint32_t> output;
+    ASSERT_EQ(TokenType::BeginArray, tokenizer.next().type);
+    ASSERT_FALSE(tokenizer.parseUIntArray(output));
+    ASSERT_EQ("Expected unsigned integer at position 4", tokenizer.getError().toString());
+}
+
+} // namespace ValdiTest
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+
+#include "valdi/runtime/JavaScript/JavaScriptBytecodeCache.hpp"
+#include "valdi/standalone_runtime/InMemoryDiskCache.hpp"
+#include "valdi_core/cpp/Utils/ByteBuffer.hpp"
+#include "valdi_core/cpp/Utils/ConsoleLogger.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
+
+using namespace Valdi;
+
+namespace ValdiTest {
+
+struct BytecodeCacheDependencies {
+    Ref<DispatchQueue> dispatchQueue;
+    Ref<InMemoryDiskCache> diskCache;
+    ILogger& logger;
+
+    BytecodeCacheDependencies()
+        : dispatchQueue(DispatchQueue::create(STRING_LITERAL("BytecodeCache"), ThreadQoSClassMax)),
+          diskCache(Valdi::makeShared<InMemoryDiskCache>()),
+          logger(ConsoleLogger::getLogger()) {}
+
+    ~BytecodeCacheDependencies() {
+        dispatchQueue->fullTeardown();
+    }
+
+    Ref<JavaScriptBytecodeCache> makeCache(size_t maxSizeBytes = JavaScriptBytecodeCache::kDefaultMaxSizeBytes,
+                                           const StringBox& engineBytecodeVersion = STRING_LITERAL("1")) {
+        return Valdi::makeShared<JavaScriptBytecodeCache>(
+            diskCache, dispatchQueue, engineBytecodeVersion, maxSizeBytes, logger);
+    }
+
+    void flush() {
+        dispatchQueue->sync([]() {});
+    }
+};
+
+static BytesView makeBytes(std::string_view str) {
+    auto buffer = makeShared<ByteBuffer>();
+    buffer->append(str);
+    return buffer->toBytesView();
+}
+
+static BytesView makeBytecode(char c, size_t size) {
+    return makeBytes(std::string(size, c));
+}
+
+TEST(JavaScriptBytecodeCache, canStoreAndLoad) {
+    BytecodeCacheDependencies dependencies;
+    auto cache = dependencies.makeCache();
+
+    auto key = cache->makeKey(STRING_LITERAL("module/src/File.js"), makeBytes("const a = 1;"));
+
+    ASSERT_FALSE(cache->load(key).has_value());
+    ASSERT_EQ(static_cast<size_t>(1), cache->getMissCount());
+
+    cache->store(key, makeBytecode('a', 100));
+    dependencies.flush();
+
+    auto bytecode = cache->load(key);
+    ASSERT_TRUE(bytecode.has_value());
+    ASSERT_EQ(makeBytecode('a', 100).asStringView(), bytecode.value().asStringView());
+    ASSERT_EQ(static_cast<size_t>(1), cache->getHitCount());
+    ASSERT_TRUE(cache->getTotalSize() > static_cast<size_t>(100));
+
+    // The import path is part of the key
+    auto otherKey = cache->makeKey(STRING_LITERAL("module/src/Other.js"), makeBytes("const a = 1;"));
+    ASSERT_NE(key.fileName, otherKey.fileName);
+    ASSERT_FALSE(cache->load(otherKey).has_value());
+}
+
+TEST(JavaScriptBytecodeCache, evictsLeastRecentlyUsedEntries) {
+    BytecodeCacheDependencies dependencies;
+    auto cache = dependencies.makeCache();
+
+    auto keyA = cache->makeKey(STRING_LITERAL("A.js"), makeBytes("a"));
+    cache->store(keyA, makeBytecode('a', 100));
+    dependencies.flush();
+    auto entrySize = cache->getTotalSize();
+
+    // Only room for two entries
+    cache = dependencies.makeCache(entrySize * 2 + entrySize / 2);
+
+    auto keyB = cache->makeKey(STRING_LITERAL("B.js"), makeBytes("b"));
+    auto keyC = cache->makeKey(STRING_LITERAL("C.js"), makeBytes("c"));
+
+    cache->store(keyB, makeBytecode('b', 100));
+    dependencies.flush();
+    ASSERT_EQ(entrySize * 2, cache->getTotalSize());
+
+    // A becomes more recently used than B
+    ASSERT_TRUE(cache->load(keyA).has_value());
+
+    cache->store(keyC, makeBytecode('c', 100));
+    dependencies.flush();
+
+    ASSERT_EQ(entrySize * 2, cache->getTotalSize());
+    ASSERT_TRUE(cache->load(keyA).has_value());
+    ASSERT_FALSE(cache->load(keyB).has_value());
+    ASSERT_TRUE(cache->load(keyC).has_value());
+    ASSERT_FALSE(dependencies.diskCache->exists(Path(keyB.fileName)));
+}
+
+TEST(JavaScriptBytecodeCache, rejectsStaleEntries) {
+    BytecodeCacheDependencies dependencies;
+    auto cache = dependencies.makeCache();
+
+    auto key = cache->makeKey(STRING_LITERAL("File.js"), makeBytes("const a = 1;"));
+    cache->store(key, makeBytecode('a', 100));
+    dependencies.flush();
+
+    // Entry produced by a different engine version under the same file name
+    auto newEngineCache = dependencies.makeCache(JavaScriptBytecodeCache::kDefaultMaxSizeBytes, STRING_LITERAL("2"));
+    ASSERT_FALSE(newEngineCache->load(key).has_value());
+    ASSERT_EQ(static_cast<size_t>(1), newEngineCache->getMissCount());
+    ASSERT_EQ(static_cast<size_t>(0), newEngineCache->getTotalSize());
+
+    dependencies.flush();
+    ASSERT_FALSE(dependencies.diskCache->exists(Path(key.fileName)));
+    ASSERT_FALSE(cache->load(key).has_value());
+}
+
+TEST(JavaScriptBytecodeCache, rejectsChecksumMismatch) {
+    BytecodeCacheDependencies dependencies;
+    auto cache = dependencies.makeCache();
+
+    auto key = cache->makeKey(STRING_LITERAL("File.js"), makeBytes("const a = 1;"));
+    cache->store(key, makeBytecode('a', 100));
+    dependencies.flush();
+
+    auto entry = dependencies.diskCache->load(Path(key.fileName));
+    ASSERT_TRUE(entry) << entry.description();
+
+    auto corruptedEntry = makeShared<ByteBuffer>();
+    corruptedEntry->append(entry.value().begin(), entry.value().end());
+    *(corruptedEntry->end() - 1) = static_cast<Byte>('b');
+    auto storeResult = dependencies.diskCache->store(Path(key.fileName), corruptedEntry->toBytesView());
+    ASSERT_TRUE(storeResult) << storeResult.description();
+
+    ASSERT_FALSE(cache->load(key).has_value());
+    ASSERT_EQ(static_cast<size_t>(0), cache->getHitCount());
+    ASSERT_EQ(static_cast<size_t>(1), cache->getMissCount());
+    ASSERT_EQ(static_cast<size_t>(0), cache->getTotalSize());
+
+    dependencies.flush();
+    ASSERT_FALSE(dependencies.diskCache->exists(Path(key.fileName)));
+}
+
+TEST(JavaScriptBytecodeCache, persistsStableHashes) {
+    BytecodeCacheDependencies dependencies;
+    auto cache = dependencies.makeCache();
+
+    auto key = cache->makeKey(STRING_LITERAL("File.js"), makeBytes("const a = 1;"));
+    cache->store(key, makeBytecode('a', 100));
+    dependencies.flush();
+
+    auto entry = dependencies.diskCache->load(Path(key.fileName));
+    ASSERT_TRUE(entry) << entry.description();
+
+    // The hashes are read back by other processes and builds, they must not depend on std::hash
+    uint64_t engineBytecodeVersionHash = 0;
+    uint64_t bytecodeChecksum = 0;
+    std::memcpy(&engineBytecodeVersionHash, entry.value().data() + 8, sizeof(uint64_t));
+    std::memcpy(&bytecodeChecksum, entry.value().data() + 32, sizeof(uint64_t));
+
+    ASSERT_EQ(static_cast<uint64_t>(0xaf63ac4c86019afcULL), engineBytecodeVersionHash);
+    ASSERT_EQ(static_cast<uint64_t>(0x2885d0ac2e5a9d79ULL), bytecodeChecksum);
+}
+
+TEST(JavaScriptBytecodeCache, loadWaitsForIndex) {
+    BytecodeCacheDependencies dependencies;
+    auto cache = dependencies.makeCache();
+
+    auto key = cache->makeKey(STRING_LITERAL("File.js"), makeBytes("const a = 1;"));
+    cache->store(key, makeBytecode('a', 100));
+    dependencies.flush();
+
+    // The index is loaded on the dispatch queue, load() should not miss while it is in progress
+    auto reloadedCache = dependencies.makeCache();
+    reloadedCache->prewarm();
+    ASSERT_TRUE(reloadedCache->load(key).has_value());
+    ASSERT_EQ(static_cast<size_t>(0), reloadedCache->getMissCount());
+}
+
+TEST(JavaScriptBytecodeCache, persistsIndex) {
+    BytecodeCacheDependencies dependencies;
+    auto cache = dependencies.makeCache();
+
+    auto keyA = cache->makeKey(STRING_LITERAL("A.js"), makeBytes("a"));
+    auto keyB = cache->makeKey(STRING_LITERAL("B.js"), makeBytes("b"));
+
+    cache->store(keyA, makeBytecode('a', 100));
+    dependencies.flush();
+    auto entrySize = cache->getTotalSize();
+    cache->store(keyB, makeBytecode('b', 100));
+    dependencies.flush();
+
+    // A becomes more recently used than B, the access is written in the background
+    ASSERT_TRUE(cache->load(keyA).has_value());
+    dependencies.flush();
+
+    auto reloadedCache = dependencies.makeCache(entrySize * 2 + entrySize / 2);
+    ASSERT_EQ(entrySize * 2, reloadedCache->getTotalSize());
+
+    // The access order is restored from the index, B is the least recently used
+    auto keyC = reloadedCache->makeKey(STRING_LITERAL("C.js"), makeBytes("c"));
+    reloadedCache->store(keyC, makeBytecode('c', 100));
+    dependencies.flush();
+
+    ASSERT_TRUE(reloadedCache->load(keyA).has_value());
+    ASSERT_FALSE(reloadedCache->load(keyB).has_value());
+    ASSERT_TRUE(reloadedCache->load(keyC).has_value());
+}
+
+TEST(JavaScriptBytecodeCache, removesOrphanedFiles) {
+    BytecodeCacheDependencies dependencies;
+
+    auto storeResult = dependencies.diskCache->store(Path("orphan"), makeBytes("orphan"));
+    ASSERT_TRUE(storeResult) << storeResult.description();
+
+    auto cache = dependencies.makeCache();
+    auto key = cache->makeKey(STRING_LITERAL("File.js"), makeBytes("const a = 1;"));
+    cache->store(key, makeBytecode('a', 100));
+    dependencies.flush();
+
+    ASSERT_FALSE(dependencies.diskCache->exists(Path("orphan")));
+    ASSERT_TRUE(dependencies.diskCache->exists(Path(key.fileName)));
+}
+
+} // namespace ValdiTest
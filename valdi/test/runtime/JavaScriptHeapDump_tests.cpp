@@ -6,9 +6,14 @@
 //
 
 #include "valdi/runtime/JavaScript/JavaScriptHeapDumpBuilder.hpp"
+#include "valdi/runtime/Resources/DiskCacheImpl.hpp"
+#include "valdi_core/cpp/Utils/DiskUtils.hpp"
+#include "valdi_core/cpp/Utils/Format.hpp"
 #include "valdi_core/cpp/Utils/StringCache.hpp"
 #include "valdi_core/cpp/Utils/ValueUtils.hpp"
+#include <fcntl.h>
 #include <gtest/gtest.h>
+#include <unistd.h>
 
 #define ASSERT_NO_EXCEPTION(__exceptionTracker__)                                                                      \
     if (!__exceptionTracker__) {                                                                                       \
@@ -82,6 +87,30 @@ TEST(JavaScriptHeapDumpParser, canParseHeapDump) {
     ASSERT_EQ(static_cast<size_t>(0), edges3.size());
 }
 
+TEST(JavaScriptHeapDumpParser, failsOnMalformedHeapDump) {
+    auto parse = [](std::string_view nodes) {
+        auto json = fmt::format(
+            R"({{"snapshot":{{"meta":{{"node_fields":["type","name","id","self_size","edge_count"],)"
+            R"("node_types":[["hidden","array","string","object","code","closure","regexp","number","native",)"
+            R"("synthetic","symbol","bigint","object shape"],"string","number","number","number"],)"
+            R"("edge_fields":["type","name_or_index","to_node"],)"
+            R"("edge_types":[["context","element","property","internal","hidden","shortcut","weak"],)"
+            R"("string_or_number","node"]}},)"
+            R"("node_count":1,"edge_count":0}},"nodes":{},"edges":[],"strings":["Object"]}})",
+            nodes);
+        SimpleExceptionTracker exceptionTracker;
+        JavaScriptHeapDumpParser parser(reinterpret_cast<const Byte*>(json.data()), json.size(), exceptionTracker);
+        return exceptionTracker ? std::string() : exceptionTracker.extractError().toString();
+    };
+
+    ASSERT_EQ("", parse("[3,0,1,40,0]"));
+    ASSERT_NE("", parse("[3,0,1,40]"));
+    ASSERT_NE("", parse("[3,0,1,40,0,0]"));
+    ASSERT_NE("", parse("[3,0,-1,40,0]"));
+    ASSERT_NE("", parse("[3,0,1,40,0"));
+    ASSERT_NE("", parse("{}"));
+}
+
 TEST(JavaScriptHeapDumpBuilder, canBuildHeapDump) {
     JavaScriptHeapDumpBuilder builder;
 
@@ -196,4 +225,91 @@ TEST(JavaScriptHeapDumpBuilder, canMergeHeapDumps) {
     ASSERT_EQ(expectedJSONValue.value(), result.value());
 }
 
+static void populateLargeHeapDump(JavaScriptHeapDumpBuilder& builder) {
+    // Enough nodes and edges to be flushed to the spill files multiple times
+    constexpr size_t nodesCount = 50000;
+
+    for (size_t i = 0; i < nodesCount; i++) {
+        builder.beginNode(JavaScriptHeapDumpNodeType::OBJECT, STRING_FORMAT("Object{}", i % 10), i + 1, 40);
+        for (size_t j = 1; j <= 3; j++) {
+            // Reference nodes which were already visited and nodes which will be visited later
+            builder.appendEdge(JavaScriptHeapDumpEdgeType::PROPERTY,
+                               JavaScriptHeapEdgeIdentifier::named(STRING_FORMAT("prop{}", j)),
+                               ((i + j * 7919) % nodesCount) + 1);
+        }
+        builder.appendEdgeToValue(JavaScriptHeapDumpEdgeType::ELEMENT,
+                                  JavaScriptHeapEdgeIdentifier::indexed(0),
+                                  JavaScriptHeapDumpNodeType::STRING,
+                                  static_cast<uint64_t>(0),
+                                  "Hello World",
+                                  11);
+    }
+}
+
+TEST(JavaScriptHeapDumpBuilder, canStreamHeapDump) {
+    char directoryLocation[] = "/tmp/.valdi_test.XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(directoryLocation));
+    auto directory = Path(std::string_view(directoryLocation));
+
+    JavaScriptHeapDumpBuilder inMemoryBuilder;
+    populateLargeHeapDump(inMemoryBuilder);
+    auto expectedHeapDump = inMemoryBuilder.build();
+    ASSERT_FALSE(expectedHeapDump.empty());
+
+    JavaScriptHeapDumpBuilder streamingBuilder(directory);
+    populateLargeHeapDump(streamingBuilder);
+
+    // The spill files should not be visible in the directory
+    ASSERT_TRUE(DiskUtils::listDirectory(directory).empty());
+
+    DiskCacheImpl diskCache(StringBox::fromCString(directoryLocation));
+    auto result = streamingBuilder.write(diskCache, Path("heap.heapsnapshot"));
+    ASSERT_TRUE(result) << result.description();
+
+    auto heapDump = diskCache.loadAppended(Path("heap.heapsnapshot"));
+    ASSERT_TRUE(heapDump) << heapDump.description();
+    ASSERT_EQ(expectedHeapDump.asStringView(), heapDump.value().asStringView());
+
+    // Writing again replaces the previous heap dump
+    result = streamingBuilder.write(diskCache, Path("heap.heapsnapshot"));
+    ASSERT_TRUE(result) << result.description();
+
+    heapDump = diskCache.loadAppended(Path("heap.heapsnapshot"));
+    ASSERT_TRUE(heapDump) << heapDump.description();
+    ASSERT_EQ(expectedHeapDump.asStringView(), heapDump.value().asStringView());
+
+    auto fdPath = directory.appending("heap_fd.heapsnapshot").toString();
+    auto fd = ::open(fdPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_TRUE(fd >= 0);
+    result = streamingBuilder.write(fd);
+    ::close(fd);
+    ASSERT_TRUE(result) << result.description();
+
+    heapDump = DiskUtils::load(Path(fdPath));
+    ASSERT_TRUE(heapDump) << heapDump.description();
+    ASSERT_EQ(expectedHeapDump.asStringView(), heapDump.value().asStringView());
+
+    ASSERT_EQ(expectedHeapDump.asStringView(), streamingBuilder.build().asStringView());
+
+    DiskUtils::remove(directory);
+}
+
+TEST(JavaScriptHeapDumpBuilder, createsMissingSpillDirectory) {
+    char directoryLocation[] = "/tmp/.valdi_test.XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(directoryLocation));
+    auto directory = Path(std::string_view(directoryLocation));
+
+    // Disk caches create their directories lazily, the spill directory might not exist yet
+    auto spillDirectory = directory.appending("js_heap_dumps");
+    JavaScriptHeapDumpBuilder streamingBuilder(spillDirectory);
+    populateLargeHeapDump(streamingBuilder);
+
+    DiskCacheImpl diskCache(StringBox::fromString(spillDirectory.toString()));
+    auto result = streamingBuilder.write(diskCache, Path("heap.heapsnapshot"));
+    ASSERT_TRUE(result) << result.description();
+    ASSERT_TRUE(DiskUtils::isDirectory(spillDirectory));
+
+    DiskUtils::remove(directory);
+}
+
 } // namespace ValdiTest
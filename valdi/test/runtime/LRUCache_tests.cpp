@@ -40,6 +40,21 @@ TEST(LRUCache, canInsertAndGet) {
     ASSERT_TRUE(it == cache.end());
 }
 
+TEST(LRUCache, canGetLeastRecentlyUsedEntry) {
+    LRUCache<StringBox, int> cache(16);
+
+    ASSERT_TRUE(cache.last() == cache.end());
+
+    cache.insert(STRING_LITERAL("KeyA"), 1);
+    cache.insert(STRING_LITERAL("KeyB"), 2);
+
+    ASSERT_EQ(1, cache.last()->value());
+
+    cache.find(STRING_LITERAL("KeyA"));
+
+    ASSERT_EQ(2, cache.last()->value());
+}
+
 TEST(LRUCache, canRemove) {
     LRUCache<StringBox, int> cache(16);
 
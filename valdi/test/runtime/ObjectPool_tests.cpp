@@ -40,6 +40,10 @@ public:
         return _createdObjectsCount;
     }
 
+    void clear() {
+        _innerPool.clear();
+    }
+
 private:
     ObjectPoolInner<Shared<Object>> _innerPool;
     int _createdObjectsCount = 0;
@@ -129,4 +133,22 @@ TEST(ObjectPool, canMoveObjects) {
     ASSERT_EQ(Value(), object2->get()->value);
 }
 
+TEST(ObjectPool, canClear) {
+    auto pool = Pool();
+
+    auto object = pool.create();
+    { auto object2 = pool.create(); }
+    ASSERT_EQ(2, pool.getCreatedObjectsCount());
+
+    pool.clear();
+
+    // The recycled object was destroyed, the one in use goes back to the pool
+    { auto object3 = pool.create(); }
+    ASSERT_EQ(3, pool.getCreatedObjectsCount());
+
+    object = pool.create();
+    auto object4 = pool.create();
+    ASSERT_EQ(3, pool.getCreatedObjectsCount());
+}
+
 } // namespace ValdiTest
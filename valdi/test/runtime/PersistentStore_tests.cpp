@@ -455,6 +455,121 @@ TEST(PersistentStore, restoredCacheSupportsEviction) {
     ASSERT_EQ(STRING_LITERAL("item4"), entries[1].first);
 }
 
+TEST(PersistentStore, appendsOperationsToJournal) {
+    PersistentStoreDependencies dependencies;
+    auto makeStore = [&]() {
+        return Valdi::makeShared<PersistentStore>(STRING_LITERAL("somepath"),
+                                                  dependencies.diskCache,
+                                                  nullptr,
+                                                  dependencies.keyChain,
+                                                  dependencies.dispatchQueue,
+                                                  dependencies.logger,
+                                                  0,
+                                                  true);
+    };
+
+    auto store = makeStore();
+    store->populate();
+
+    store->store(STRING_LITERAL("item1"), makeShared<ByteBuffer>("Hello")->toBytesView(), 0, 0, [](const auto&) {});
+    dependencies.dispatchQueue->sync([]() {});
+
+    auto snapshot = dependencies.diskCache->load(Path("global/somepath"));
+    ASSERT_TRUE(snapshot) << snapshot.description();
+    ASSERT_FALSE(dependencies.diskCache->exists(Path("global/somepath.journal")));
+
+    store->store(STRING_LITERAL("item2"), makeShared<ByteBuffer>("World")->toBytesView(), 0, 0, [](const auto&) {});
+    store->store(STRING_LITERAL("item3"), makeShared<ByteBuffer>("!")->toBytesView(), 0, 0, [](const auto&) {});
+    store->remove(STRING_LITERAL("item1"), [](const auto&) {});
+    dependencies.dispatchQueue->sync([]() {});
+
+    // The snapshot should be left untouched, the operations should go to the journal
+    ASSERT_EQ(snapshot.value(), dependencies.diskCache->load(Path("global/somepath")).value());
+    ASSERT_TRUE(dependencies.diskCache->exists(Path("global/somepath.journal")));
+
+    // Restore the instance
+    store = makeStore();
+    store->populate();
+
+    SharedAtomic<std::vector<std::pair<StringBox, KeyValueStoreEntry>>> result;
+    AsyncGroup group;
+
+    group.enter();
+    store->fetchAll([&](const auto& entries) {
+        result.set(entries);
+        group.leave();
+    });
+
+    ASSERT_TRUE(group.blockingWaitWithTimeout(std::chrono::seconds(5)));
+
+    auto entries = result.get();
+    ASSERT_EQ(static_cast<size_t>(2), entries.size());
+    ASSERT_EQ(STRING_LITERAL("item2"), entries[0].first);
+    ASSERT_EQ("World", entries[0].second.data.asStringView());
+    ASSERT_EQ(STRING_LITERAL("item3"), entries[1].first);
+    ASSERT_EQ("!", entries[1].second.data.asStringView());
+
+    // The replayed journal should have been compacted into the snapshot
+    dependencies.dispatchQueue->sync([]() {});
+    ASSERT_FALSE(dependencies.diskCache->exists(Path("global/somepath.journal")));
+}
+
+TEST(PersistentStore, ignoresJournalLeftBehindByCompaction) {
+    PersistentStoreDependencies dependencies;
+    auto makeStore = [&]() {
+        return Valdi::makeShared<PersistentStore>(STRING_LITERAL("somepath"),
+                                                  dependencies.diskCache,
+                                                  nullptr,
+                                                  dependencies.keyChain,
+                                                  dependencies.dispatchQueue,
+                                                  dependencies.logger,
+                                                  0,
+                                                  true);
+    };
+
+    auto store = makeStore();
+    store->populate();
+
+    store->store(STRING_LITERAL("item1"), makeShared<ByteBuffer>("Hello")->toBytesView(), 0, 0, [](const auto&) {});
+    store->store(STRING_LITERAL("item2"), makeShared<ByteBuffer>("World")->toBytesView(), 0, 0, [](const auto&) {});
+    dependencies.dispatchQueue->sync([]() {});
+
+    auto staleJournal = dependencies.diskCache->load(Path("global/somepath.journal"));
+    ASSERT_TRUE(staleJournal) << staleJournal.description();
+
+    store->remove(STRING_LITERAL("item2"), [](const auto&) {});
+    dependencies.dispatchQueue->sync([]() {});
+
+    // Restoring compacts the journal into a new snapshot
+    store = makeStore();
+    store->populate();
+    dependencies.dispatchQueue->sync([]() {});
+    ASSERT_FALSE(dependencies.diskCache->exists(Path("global/somepath.journal")));
+
+    // Simulate being interrupted before the journal was removed
+    auto storeResult = dependencies.diskCache->store(Path("global/somepath.journal"), staleJournal.value());
+    ASSERT_TRUE(storeResult) << storeResult.description();
+
+    store = makeStore();
+    store->populate();
+
+    SharedAtomic<std::vector<std::pair<StringBox, KeyValueStoreEntry>>> result;
+    AsyncGroup group;
+
+    group.enter();
+    store->fetchAll([&](const auto& entries) {
+        result.set(entries);
+        group.leave();
+    });
+
+    ASSERT_TRUE(group.blockingWaitWithTimeout(std::chrono::seconds(5)));
+
+    // The removal of item2 should not be undone by the stale journal
+    auto entries = result.get();
+    ASSERT_EQ(static_cast<size_t>(1), entries.size());
+    ASSERT_EQ(STRING_LITERAL("item1"), entries[0].first);
+}
+
 static BytesView makeBytes(std::initializer_list<Byte> data) {
     auto output = makeShared<ByteBuffer>();
     output->set(data);
@@ -0,0 +1,145 @@
+#include "valdi/runtime/JavaScript/Modules/ProtobufArena.hpp"
+#include "valdi/runtime/JavaScript/Modules/ProtobufBatchDecode.hpp"
+#include "valdi/runtime/JavaScript/Modules/ProtobufMessageFactory.hpp"
+#include "valdi_core/cpp/Threading/WorkerPoolDispatchQueue.hpp"
+#include "valdi_core/cpp/Utils/ByteBuffer.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
+#include "valdi_core/cpp/Utils/ValueArray.hpp"
+#include "valdi_core/cpp/Utils/ValueFunctionWithCallable.hpp"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <future>
+
+using namespace Valdi;
+
+namespace ValdiTest {
+
+static constexpr std::string_view kProtoFileContent = R"(
+syntax = "proto3";
+package test;
+
+message Item {
+  int32 id = 1;
+}
+)";
+
+struct BatchDecodeResult {
+    Value messageIndexes;
+    Value error;
+};
+
+class ProtobufBatchDecodeFixture : public ::testing::Test {
+protected:
+    void SetUp() override {
+        messageFactory = makeShared<ProtobufMessageFactory>(false);
+        SimpleExceptionTracker exceptionTracker;
+        ASSERT_TRUE(messageFactory->parseAndLoad("test.proto", kProtoFileContent, exceptionTracker));
+
+        auto descriptorNames = messageFactory->getDescriptorNames();
+        auto it = std::find(descriptorNames.begin(), descriptorNames.end(), "test.Item");
+        ASSERT_NE(descriptorNames.end(), it);
+        descriptorIndex = static_cast<size_t>(it - descriptorNames.begin());
+
+        arena = makeShared<ProtobufArena>(false, false);
+        queue = makeShared<WorkerPoolDispatchQueue>(STRING_LITERAL("Protobuf Test"), ThreadQoSClassHigh, 4);
+    }
+
+    void TearDown() override {
+        queue->fullTeardown();
+    }
+
+    static BytesView makeItemBytes(size_t id) {
+        // Tag of field 1 with the varint wire type, followed by the id encoded as a single byte varint
+        Byte bytes[] = {0x08, static_cast<Byte>(id)};
+        return makeShared<ByteBuffer>(std::begin(bytes), std::end(bytes))->toBytesView();
+    }
+
+    static std::vector<BytesView> makeItemsBytes(size_t count) {
+        std::vector<BytesView> output;
+        for (size_t i = 0; i < count; i++) {
+            output.emplace_back(makeItemBytes(i + 1));
+        }
+        return output;
+    }
+
+    BatchDecodeResult batchDecode(const std::vector<BytesView>& buffers, size_t jobsCount) {
+        auto promise = std::make_shared<std::promise<BatchDecodeResult>>();
+        auto future = promise->get_future();
+        auto callback = makeShared<ValueFunctionWithCallable>([promise](const ValueFunctionCallContext& callContext) {
+            promise->set_value(BatchDecodeResult{callContext.getParameter(0), callContext.getParameter(1)});
+            return Value::undefined();
+        });
+
+        auto batchDecode =
+            makeShared<ProtobufBatchDecode>(arena, messageFactory, descriptorIndex, buffers, jobsCount, callback);
+        batchDecode->dispatch(*queue);
+
+        return future.get();
+    }
+
+    Ref<ProtobufMessageFactory> messageFactory;
+    size_t descriptorIndex = 0;
+    Ref<ProtobufArena> arena;
+    Ref<WorkerPoolDispatchQueue> queue;
+};
+
+TEST_F(ProtobufBatchDecodeFixture, decodesMessagesInInputOrder) {
+    auto buffers = makeItemsBytes(50);
+
+    auto result = batchDecode(buffers, 4);
+
+    ASSERT_TRUE(result.error.isUndefined());
+    const auto* messageIndexes = result.messageIndexes.getArray();
+    ASSERT_TRUE(messageIndexes != nullptr);
+    ASSERT_EQ(buffers.size(), messageIndexes->size());
+
+    auto lock = arena->lock();
+    for (size_t i = 0; i < buffers.size(); i++) {
+        SimpleExceptionTracker exceptionTracker;
+        auto encoded = arena->encodeMessage(static_cast<size_t>((*messageIndexes)[i].toInt()), exceptionTracker);
+        ASSERT_TRUE(exceptionTracker) << exceptionTracker.extractError();
+        ASSERT_EQ(buffers[i], encoded);
+    }
+}
+
+TEST_F(ProtobufBatchDecodeFixture, appendsAfterExistingMessages) {
+    {
+        auto lock = arena->lock();
+        SimpleExceptionTracker exceptionTracker;
+        arena->decodeMessage(messageFactory, descriptorIndex, makeItemBytes(100), false, exceptionTracker);
+        ASSERT_TRUE(exceptionTracker) << exceptionTracker.extractError();
+    }
+
+    auto result = batchDecode(makeItemsBytes(8), 2);
+
+    ASSERT_TRUE(result.error.isUndefined());
+    const auto* messageIndexes = result.messageIndexes.getArray();
+    ASSERT_TRUE(messageIndexes != nullptr);
+    ASSERT_EQ(static_cast<size_t>(8), messageIndexes->size());
+    for (size_t i = 0; i < messageIndexes->size(); i++) {
+        ASSERT_EQ(static_cast<int32_t>(i + 1), (*messageIndexes)[i].toInt());
+    }
+}
+
+TEST_F(ProtobufBatchDecodeFixture, reportsDecodeErrors) {
+    auto buffers = makeItemsBytes(12);
+    // Truncated varint
+    Byte invalidBytes[] = {0x08, 0xFF};
+    buffers[7] = makeShared<ByteBuffer>(std::begin(invalidBytes), std::end(invalidBytes))->toBytesView();
+
+    auto result = batchDecode(buffers, 3);
+
+    ASSERT_TRUE(result.messageIndexes.isUndefined());
+    ASSERT_FALSE(result.error.isUndefined());
+}
+
+TEST(ProtobufBatchDecode, splitsMessagesAcrossJobs) {
+    ASSERT_EQ(static_cast<size_t>(1), ProtobufBatchDecode::getJobsCountForMessages(0, 4));
+    ASSERT_EQ(static_cast<size_t>(1), ProtobufBatchDecode::getJobsCountForMessages(4, 4));
+    ASSERT_EQ(static_cast<size_t>(2), ProtobufBatchDecode::getJobsCountForMessages(5, 4));
+    ASSERT_EQ(static_cast<size_t>(4), ProtobufBatchDecode::getJobsCountForMessages(100, 4));
+    ASSERT_EQ(static_cast<size_t>(1), ProtobufBatchDecode::getJobsCountForMessages(100, 0));
+}
+
+} // namespace ValdiTest
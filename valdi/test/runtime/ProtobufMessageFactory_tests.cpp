@@ -0,0 +1,103 @@
+#include "valdi/runtime/JavaScript/Modules/ProtobufArena.hpp"
+#include "valdi/runtime/JavaScript/Modules/ProtobufMessageFactory.hpp"
+#include "valdi_core/cpp/Utils/ByteBuffer.hpp"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace Valdi;
+
+namespace ValdiTest {
+
+static constexpr std::string_view kProtoFileContent = R"(
+syntax = "proto3";
+package test;
+
+message Item {
+  int32 id = 1;
+  string name = 2;
+  int32 count = 3;
+}
+)";
+
+class ProtobufMessageFactoryFixture : public ::testing::Test {
+protected:
+    void SetUp() override {
+        messageFactory = makeShared<ProtobufMessageFactory>(false);
+        SimpleExceptionTracker exceptionTracker;
+        ASSERT_TRUE(messageFactory->parseAndLoad("test.proto", kProtoFileContent, exceptionTracker));
+
+        auto descriptorNames = messageFactory->getDescriptorNames();
+        auto it = std::find(descriptorNames.begin(), descriptorNames.end(), "test.Item");
+        ASSERT_NE(descriptorNames.end(), it);
+        descriptorIndex = static_cast<size_t>(it - descriptorNames.begin());
+
+        arena = makeShared<ProtobufArena>(false, false);
+    }
+
+    static BytesView makeItemBytes() {
+        // id = 1, name = "a", count = 3
+        Byte bytes[] = {0x08, 0x01, 0x12, 0x01, 'a', 0x18, 0x03};
+        return makeShared<ByteBuffer>(std::begin(bytes), std::end(bytes))->toBytesView();
+    }
+
+    JSProtobufMessage* decodeItem(const BytesView& bytes) {
+        SimpleExceptionTracker exceptionTracker;
+        auto messageIndex = arena->decodeMessage(messageFactory, descriptorIndex, bytes, false, exceptionTracker);
+        EXPECT_TRUE(exceptionTracker) << exceptionTracker.extractError();
+        auto* message = arena->getMessage(messageIndex, exceptionTracker);
+        EXPECT_TRUE(exceptionTracker) << exceptionTracker.extractError();
+        return message;
+    }
+
+    Ref<ProtobufMessageFactory> messageFactory;
+    size_t descriptorIndex = 0;
+    Ref<ProtobufArena> arena;
+};
+
+TEST_F(ProtobufMessageFactoryFixture, decodesAllFieldsWithoutProjection) {
+    auto lock = arena->lock();
+    const auto* message = decodeItem(makeItemBytes());
+    ASSERT_TRUE(message != nullptr);
+
+    ASSERT_EQ(std::vector<Protobuf::FieldNumber>({1, 2, 3}), message->sortedFieldNumbers());
+    ASSERT_EQ(static_cast<size_t>(0), message->getSkippedByteSize());
+}
+
+TEST_F(ProtobufMessageFactoryFixture, appliesProjectionWhenDecodingThroughArena) {
+    SimpleExceptionTracker exceptionTracker;
+    ASSERT_TRUE(messageFactory->setProjectionForDescriptorIndex(descriptorIndex, {"name"}, exceptionTracker));
+
+    auto lock = arena->lock();
+    auto bytes = makeItemBytes();
+    auto* message = decodeItem(bytes);
+    ASSERT_TRUE(message != nullptr);
+
+    ASSERT_EQ(std::vector<Protobuf::FieldNumber>({2}), message->sortedFieldNumbers());
+    ASSERT_EQ(static_cast<size_t>(4), message->getSkippedByteSize());
+
+    // The skipped fields are written back at their original position
+    auto encoded = arena->encodeMessage(message->getMessageIndex(), exceptionTracker);
+    ASSERT_TRUE(exceptionTracker) << exceptionTracker.extractError();
+    ASSERT_EQ(bytes, encoded);
+
+    // Reading a field outside of the projection decodes the skipped fields
+    auto* field = message->getField(3);
+    ASSERT_TRUE(field != nullptr);
+    ASSERT_EQ(3, field->getInt32());
+    ASSERT_EQ(std::vector<Protobuf::FieldNumber>({1, 2, 3}), message->sortedFieldNumbers());
+}
+
+TEST_F(ProtobufMessageFactoryFixture, failsToSetProjectionWithUnknownField) {
+    SimpleExceptionTracker exceptionTracker;
+    ASSERT_FALSE(messageFactory->setProjectionForDescriptorIndex(descriptorIndex, {"unknown"}, exceptionTracker));
+    ASSERT_FALSE(exceptionTracker);
+    exceptionTracker.clearError();
+
+    auto lock = arena->lock();
+    const auto* message = decodeItem(makeItemBytes());
+    ASSERT_TRUE(message != nullptr);
+    ASSERT_EQ(std::vector<Protobuf::FieldNumber>({1, 2, 3}), message->sortedFieldNumbers());
+}
+
+} // namespace ValdiTest
@@ -0,0 +1,80 @@
+#include "valdi/runtime/Utils/RecyclingAllocator.hpp"
+#include <gtest/gtest.h>
+
+#include <array>
+
+using namespace Valdi;
+
+namespace ValdiTest {
+
+struct RecycledObject : public SharedPtrRefCountable {
+    explicit RecycledObject(int value) : value(value) {}
+
+    int value;
+    char padding[100];
+};
+
+struct RecycledObjectAllocation : public SharedPtrRefCountable {
+    char padding[200];
+};
+
+TEST(RecyclingAllocator, reusesMemoryOfDestroyedObjects) {
+    auto object = makeRecycledShared<RecycledObject>(42);
+    ASSERT_EQ(42, object->value);
+    auto* address = object.get();
+
+    object = nullptr;
+
+    auto newObject = makeRecycledShared<RecycledObject>(7);
+    ASSERT_EQ(7, newObject->value);
+    ASSERT_EQ(address, newObject.get());
+}
+
+TEST(RecyclingAllocator, keepsMemoryAliveWhileWeaklyReferenced) {
+    auto object = makeRecycledShared<RecycledObjectAllocation>();
+    auto* address = object.get();
+    Weak<RecycledObjectAllocation> weakObject = object.toShared();
+
+    object = nullptr;
+    ASSERT_EQ(nullptr, weakObject.lock());
+
+    // The control block is still referenced by the weak reference
+    auto otherObject = makeRecycledShared<RecycledObjectAllocation>();
+    ASSERT_NE(address, otherObject.get());
+
+    weakObject.reset();
+
+    auto lastObject = makeRecycledShared<RecycledObjectAllocation>();
+    ASSERT_EQ(address, lastObject.get());
+}
+
+TEST(RecyclingAllocator, capsRecycledBlocks) {
+    using Block = std::array<char, 24>;
+    using Recycler = BlockRecycler<sizeof(Block), alignof(Block)>;
+    RecyclingAllocator<Block> allocator;
+
+    std::vector<Block*> blocks;
+    for (size_t i = 0; i < Recycler::kMaxRecycledBlocks + 10; i++) {
+        blocks.emplace_back(allocator.allocate(1));
+    }
+    for (auto* block : blocks) {
+        allocator.deallocate(block, 1);
+    }
+
+    ASSERT_EQ(Recycler::kMaxRecycledBlocks, Recycler::get().getRecycledBlocksCount());
+}
+
+TEST(RecyclingAllocator, canTrimRecycledBlocks) {
+    using Block = std::array<char, 40>;
+    using Recycler = BlockRecycler<sizeof(Block), alignof(Block)>;
+    RecyclingAllocator<Block> allocator;
+
+    auto* block = allocator.allocate(1);
+    allocator.deallocate(block, 1);
+    ASSERT_EQ(static_cast<size_t>(1), Recycler::get().getRecycledBlocksCount());
+
+    BlockRecyclerBase::trimAll();
+    ASSERT_EQ(static_cast<size_t>(0), Recycler::get().getRecycledBlocksCount());
+}
+
+} // namespace ValdiTest
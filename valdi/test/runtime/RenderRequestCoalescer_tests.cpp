@@ -0,0 +1,179 @@
+#include "valdi/runtime/Rendering/RenderRequestCoalescer.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
+#include <gtest/gtest.h>
+
+#include <fmt/format.h>
+
+using namespace Valdi;
+
+namespace ValdiTest {
+
+class DescribeEntryVisitor {
+public:
+    std::vector<std::string> descriptions;
+
+    void visit(RenderRequestEntries::CreateElement& entry) {
+        descriptions.emplace_back(
+            fmt::format("create {} {}", entry.getElementId(), entry.getViewClassName().toStringView()));
+    }
+
+    void visit(RenderRequestEntries::DestroyElement& entry) {
+        descriptions.emplace_back(fmt::format("destroy {}", entry.getElementId()));
+    }
+
+    void visit(RenderRequestEntries::MoveElementToParent& entry) {
+        descriptions.emplace_back(fmt::format(
+            "move {} {} {}", entry.getElementId(), entry.getParentElementId(), entry.getParentIndex()));
+    }
+
+    void visit(RenderRequestEntries::SetRootElement& entry) {
+        descriptions.emplace_back(fmt::format("root {}", entry.getElementId()));
+    }
+
+    void visit(RenderRequestEntries::SetElementAttribute& entry) {
+        descriptions.emplace_back(fmt::format(
+            "attr {} {} {}", entry.getElementId(), entry.getAttributeId(), entry.getAttributeValue().toDouble()));
+    }
+
+    template<typename T>
+    void visit(T& /*entry*/) {
+        descriptions.emplace_back("other");
+    }
+};
+
+static std::vector<std::string> describe(const RenderRequest& renderRequest) {
+    DescribeEntryVisitor visitor;
+    renderRequest.visitEntries(visitor);
+    return visitor.descriptions;
+}
+
+static void appendCreate(RenderRequest& renderRequest, RawViewNodeId id) {
+    auto* entry = renderRequest.appendCreateElement();
+    entry->setElementId(id);
+    entry->setViewClassName(STRING_LITERAL("View"));
+}
+
+static void appendMove(RenderRequest& renderRequest, RawViewNodeId id, RawViewNodeId parentId, int index) {
+    auto* entry = renderRequest.appendMoveElementToParent();
+    entry->setElementId(id);
+    entry->setParentElementId(parentId);
+    entry->setParentIndex(index);
+}
+
+static void appendAttribute(RenderRequest& renderRequest, RawViewNodeId id, AttributeId attributeId, double value) {
+    auto* entry = renderRequest.appendSetElementAttribute();
+    entry->setElementId(id);
+    entry->setAttributeId(attributeId);
+    entry->setAttributeValue(Value(value));
+}
+
+TEST(RenderRequestCoalescer, keepsLastAttributeWrites) {
+    auto first = makeShared<RenderRequest>();
+    appendAttribute(*first, 1, 10, 1.0);
+    appendAttribute(*first, 1, 11, 2.0);
+    appendAttribute(*first, 2, 10, 3.0);
+
+    auto second = makeShared<RenderRequest>();
+    appendAttribute(*second, 1, 10, 4.0);
+
+    auto merged = RenderRequestCoalescer::coalesce({first, second});
+
+    std::vector<std::string> expected = {"attr 1 11 2", "attr 2 10 3", "attr 1 10 4"};
+    ASSERT_EQ(expected, describe(*merged));
+}
+
+TEST(RenderRequestCoalescer, dropsNodesCreatedAndDestroyed) {
+    auto first = makeShared<RenderRequest>();
+    appendCreate(*first, 2);
+    appendMove(*first, 2, 1, 0);
+    appendAttribute(*first, 2, 10, 1.0);
+
+    auto second = makeShared<RenderRequest>();
+    appendAttribute(*second, 2, 10, 2.0);
+    appendAttribute(*second, 1, 10, 3.0);
+    second->appendDestroyElement()->setElementId(2);
+
+    auto merged = RenderRequestCoalescer::coalesce({first, second});
+
+    std::vector<std::string> expected = {"attr 1 10 3"};
+    ASSERT_EQ(expected, describe(*merged));
+}
+
+TEST(RenderRequestCoalescer, keepsNodesWhichShiftSiblings) {
+    auto first = makeShared<RenderRequest>();
+    appendCreate(*first, 2);
+    appendMove(*first, 2, 1, 0);
+    appendCreate(*first, 3);
+    appendMove(*first, 3, 1, 1);
+
+    auto second = makeShared<RenderRequest>();
+    second->appendDestroyElement()->setElementId(2);
+
+    auto merged = RenderRequestCoalescer::coalesce({first, second});
+
+    std::vector<std::string> expected = {
+        "create 2 View", "move 2 1 0", "create 3 View", "move 3 1 1", "destroy 2"};
+    ASSERT_EQ(expected, describe(*merged));
+}
+
+TEST(RenderRequestCoalescer, keepsNodesWithChildren) {
+    auto first = makeShared<RenderRequest>();
+    appendCreate(*first, 2);
+    appendMove(*first, 3, 2, 0);
+
+    auto second = makeShared<RenderRequest>();
+    second->appendDestroyElement()->setElementId(2);
+
+    auto merged = RenderRequestCoalescer::coalesce({first, second});
+
+    std::vector<std::string> expected = {"create 2 View", "move 3 2 0", "destroy 2"};
+    ASSERT_EQ(expected, describe(*merged));
+}
+
+TEST(RenderRequestCoalescer, collapsesRepeatedMoves) {
+    auto first = makeShared<RenderRequest>();
+    appendMove(*first, 3, 1, 0);
+    appendAttribute(*first, 3, 10, 1.0);
+
+    auto second = makeShared<RenderRequest>();
+    appendMove(*second, 3, 2, 0);
+    appendMove(*second, 4, 2, 0);
+
+    auto third = makeShared<RenderRequest>();
+    appendMove(*third, 3, 1, 0);
+
+    auto merged = RenderRequestCoalescer::coalesce({first, second, third});
+
+    // The move of 4 into 2 relies on 3 having been inserted into 2 before
+    std::vector<std::string> expected = {"attr 3 10 1", "move 3 2 0", "move 4 2 0", "move 3 1 0"};
+    ASSERT_EQ(expected, describe(*merged));
+}
+
+TEST(RenderRequestCoalescer, treatsRecreatedElementsAsNewNodes) {
+    auto first = makeShared<RenderRequest>();
+    appendAttribute(*first, 2, 10, 1.0);
+    first->appendDestroyElement()->setElementId(2);
+
+    auto second = makeShared<RenderRequest>();
+    appendCreate(*second, 2);
+    appendAttribute(*second, 2, 10, 2.0);
+    second->appendSetRootElement()->setElementId(2);
+
+    auto merged = RenderRequestCoalescer::coalesce({first, second});
+
+    std::vector<std::string> expected = {"attr 2 10 1", "destroy 2", "create 2 View", "attr 2 10 2", "root 2"};
+    ASSERT_EQ(expected, describe(*merged));
+}
+
+TEST(RenderRequestCoalescer, doesNotCoalesceAnimations) {
+    auto renderRequest = makeShared<RenderRequest>();
+    appendAttribute(*renderRequest, 1, 10, 1.0);
+    ASSERT_TRUE(RenderRequestCoalescer::canCoalesce(*renderRequest));
+
+    renderRequest->appendStartAnimations();
+    appendAttribute(*renderRequest, 1, 10, 2.0);
+    renderRequest->appendEndAnimations();
+    ASSERT_FALSE(RenderRequestCoalescer::canCoalesce(*renderRequest));
+}
+
+} // namespace ValdiTest
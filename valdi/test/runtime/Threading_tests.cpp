@@ -88,6 +88,138 @@ TEST(TaskQueue, barrierDoesNotAllowOtherTaskToRun) {
     ASSERT_TRUE(innerTaskRan);
 }
 
+TEST(TaskQueue, runsTasksByExecuteTime) {
+    auto now = std::chrono::steady_clock::now();
+    TaskQueue taskQueue;
+    std::vector<int> order;
+
+    taskQueue.enqueue([&]() { order.emplace_back(3); }, now - std::chrono::milliseconds(1));
+    taskQueue.enqueue([&]() { order.emplace_back(4); });
+    taskQueue.enqueue([&]() { order.emplace_back(1); }, now - std::chrono::milliseconds(3));
+    taskQueue.enqueue([&]() { order.emplace_back(5); });
+    taskQueue.enqueue([&]() { order.emplace_back(2); }, now - std::chrono::milliseconds(2));
+    taskQueue.enqueue([&]() { order.emplace_back(6); }, std::chrono::hours(1));
+
+    ASSERT_EQ(static_cast<size_t>(5), taskQueue.flushUpToNow());
+    ASSERT_EQ(std::vector<int>({1, 2, 3, 4, 5}), order);
+}
+
+TEST(TaskQueue, canCancelDelayedAndImmediateTasks) {
+    TaskQueue taskQueue;
+    std::vector<task_id_t> delayedTaskIds;
+    size_t ranTasks = 0;
+
+    for (size_t i = 0; i < 1000; i++) {
+        delayedTaskIds.emplace_back(
+            taskQueue.enqueue([&]() { ranTasks++; }, std::chrono::steady_clock::now() - std::chrono::seconds(1)).id);
+    }
+    auto immediateTaskId = taskQueue.enqueue([&]() { ranTasks++; }).id;
+    taskQueue.enqueue([&]() { ranTasks++; });
+
+    for (size_t i = 0; i < delayedTaskIds.size(); i++) {
+        if (i % 10 != 0) {
+            taskQueue.cancel(delayedTaskIds[i]);
+        }
+    }
+    taskQueue.cancel(immediateTaskId);
+    // Cancelling a task which already ran or does not exist should be a no-op
+    taskQueue.cancel(delayedTaskIds[1]);
+    taskQueue.cancel(424242);
+
+    ASSERT_EQ(static_cast<size_t>(101), taskQueue.flush());
+    ASSERT_EQ(static_cast<size_t>(101), ranTasks);
+}
+
+TEST(TaskQueue, preservesOrderPerProducer) {
+    constexpr size_t kProducersCount = 4;
+    constexpr size_t kTasksPerProducer = 5000;
+
+    TaskQueue taskQueue;
+    std::vector<size_t> lastTaskIndexes(kProducersCount, 0);
+    std::atomic<size_t> ranTasks = 0;
+    std::atomic_bool outOfOrder = false;
+
+    std::vector<Ref<Thread>> producers;
+    for (size_t producer = 0; producer < kProducersCount; producer++) {
+        producers.emplace_back(Thread::create(STRING_LITERAL("Producer"), ThreadQoSClassNormal, [&, producer]() {
+                                   for (size_t i = 1; i <= kTasksPerProducer; i++) {
+                                       taskQueue.async([&, producer, i]() {
+                                           if (lastTaskIndexes[producer] + 1 != i) {
+                                               outOfOrder = true;
+                                           }
+                                           lastTaskIndexes[producer] = i;
+                                           ranTasks++;
+                                       });
+                                   }
+                               }).value());
+    }
+
+    while (ranTasks < kProducersCount * kTasksPerProducer) {
+        taskQueue.runNextTask(std::chrono::steady_clock::now() + std::chrono::seconds(5));
+    }
+
+    for (const auto& producer : producers) {
+        producer->join();
+    }
+
+    ASSERT_FALSE(outOfOrder);
+}
+
+TEST(TaskQueue, wakesUpConsumerWhenEnqueuingFromOtherThreads) {
+    auto dispatchQueue = makeShared<ThreadedDispatchQueue>(STRING_LITERAL("Test Queue"), ThreadQoSClassNormal);
+    std::atomic<size_t> ranTasks = 0;
+
+    for (size_t i = 0; i < 100; i++) {
+        dispatchQueue->async([&]() { ranTasks++; });
+        if (i % 10 == 0) {
+            // Let the consumer go back to sleep
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    dispatchQueue->asyncAfter([&]() { ranTasks++; }, std::chrono::milliseconds(5));
+
+    dispatchQueue->sync([&]() { ASSERT_EQ(static_cast<size_t>(100), ranTasks.load()); });
+
+    auto start = std::chrono::steady_clock::now();
+    while (ranTasks != 101 && std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(static_cast<size_t>(101), ranTasks.load());
+}
+
+class TestQueueListener : public IQueueListener {
+public:
+    std::vector<bool> events;
+
+    void onQueueEmpty() final {
+        events.emplace_back(true);
+    }
+
+    void onQueueNonEmpty() final {
+        events.emplace_back(false);
+    }
+};
+
+TEST(TaskQueue, notifiesListenerOnEmptinessChanges) {
+    TaskQueue taskQueue;
+    auto listener = makeShared<TestQueueListener>();
+    taskQueue.setListener(listener);
+
+    taskQueue.enqueue([]() {});
+    taskQueue.enqueue([]() {});
+    ASSERT_EQ(std::vector<bool>({false}), listener->events);
+
+    ASSERT_EQ(static_cast<size_t>(2), taskQueue.flush());
+    ASSERT_EQ(std::vector<bool>({false, true}), listener->events);
+
+    auto taskId = taskQueue.enqueue([]() {}, std::chrono::hours(1)).id;
+    ASSERT_EQ(std::vector<bool>({false, true, false}), listener->events);
+
+    taskQueue.cancel(taskId);
+    ASSERT_FALSE(taskQueue.runNextTask());
+    ASSERT_EQ(std::vector<bool>({false, true, false, true}), listener->events);
+}
+
 TEST(TrackedLock, canDropTrackedLocks) {
     auto mutex = makeShared<RecursiveMutex>();
     TrackedLock lock1(*mutex);
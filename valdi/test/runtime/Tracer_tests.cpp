@@ -1,6 +1,9 @@
+#include "valdi_core/cpp/Utils/ChromeTraceWriter.hpp"
 #include "valdi_core/cpp/Utils/Trace.hpp"
 #include <gtest/gtest.h>
 
+#include <thread>
+
 using namespace Valdi;
 
 namespace ValdiTest {
@@ -118,4 +121,158 @@ TEST(Tracer, onlyReturnsRecordingWhenLastRecorderEnd) {
     ASSERT_FALSE(tracer.isRecording());
 }
 
+TEST(Tracer, canRecordOperationsFromMultipleThreads) {
+    Tracer tracer;
+    auto start = std::chrono::steady_clock::now();
+    auto nameId = TraceNames::intern("threaded");
+
+    auto id = tracer.startRecording();
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 4; i++) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < 100; j++) {
+                tracer.append(nameId, start, appendMs(start, j));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto result = tracer.stopRecording(id);
+
+    ASSERT_EQ(static_cast<size_t>(400), result.size());
+    for (const auto& trace : result) {
+        ASSERT_EQ("threaded", trace.trace);
+    }
+
+    // Traces are grouped by thread, in the order in which they were appended
+    for (size_t i = 0; i < result.size(); i++) {
+        ASSERT_EQ(result[i - i % 100].threadId, result[i].threadId);
+        ASSERT_EQ(static_cast<double>(i % 100), result[i].duration().milliseconds());
+    }
+}
+
+TEST(Tracer, keepsTracesOfExitedThreads) {
+    Tracer tracer;
+    auto start = std::chrono::steady_clock::now();
+
+    auto id = tracer.startRecording();
+    for (size_t i = 0; i < 3; i++) {
+        std::thread([&]() { tracer.append("hello", start, appendMs(start, 50)); }).join();
+    }
+    auto result = tracer.stopRecording(id);
+
+    ASSERT_EQ(static_cast<size_t>(3), result.size());
+    ASSERT_NE(result[0].threadId, result[1].threadId);
+    ASSERT_NE(result[1].threadId, result[2].threadId);
+}
+
+TEST(Tracer, keepsTracesBeyondBufferCapacity) {
+    Tracer tracer;
+    auto start = std::chrono::steady_clock::now();
+    auto nameId = TraceNames::intern("hello");
+
+    auto id = tracer.startRecording();
+    for (size_t i = 0; i < TraceRingBuffer::kCapacity * 3; i++) {
+        tracer.append(nameId, start, appendMs(start, 50));
+    }
+    auto result = tracer.stopRecording(id);
+
+    ASSERT_EQ(TraceRingBuffer::kCapacity * 3, result.size());
+    ASSERT_EQ(static_cast<size_t>(0), tracer.getDroppedTracesCount());
+}
+
+TEST(Tracer, keepsTracesOrderedAcrossHandedOffBuffers) {
+    Tracer tracer;
+    auto start = std::chrono::steady_clock::now();
+    auto nameId = TraceNames::intern("threaded");
+    auto tracesPerThread = TraceRingBuffer::kCapacity * 2 + 10;
+
+    auto id = tracer.startRecording();
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 2; i++) {
+        threads.emplace_back([&]() {
+            for (size_t j = 0; j < tracesPerThread; j++) {
+                tracer.append(nameId, start, start + std::chrono::microseconds(j));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto result = tracer.stopRecording(id);
+
+    ASSERT_EQ(tracesPerThread * 2, result.size());
+    ASSERT_EQ(static_cast<size_t>(0), tracer.getDroppedTracesCount());
+    for (size_t i = 0; i < result.size(); i++) {
+        ASSERT_EQ(result[i - i % tracesPerThread].threadId, result[i].threadId);
+        ASSERT_EQ(static_cast<int64_t>(i % tracesPerThread),
+                  std::chrono::duration_cast<std::chrono::microseconds>(result[i].end - result[i].start).count());
+    }
+}
+
+TEST(TraceRingBuffer, dropsEventsWhenFull) {
+    TraceRingBuffer buffer;
+    TraceEvent event;
+
+    for (size_t i = 0; i < TraceRingBuffer::kCapacity; i++) {
+        ASSERT_TRUE(buffer.push(event));
+    }
+    ASSERT_FALSE(buffer.push(event));
+    ASSERT_EQ(static_cast<size_t>(1), buffer.getDroppedEventsCount());
+
+    ASSERT_EQ(TraceRingBuffer::kCapacity, buffer.drain([](const TraceEvent& /*event*/) {}));
+    ASSERT_TRUE(buffer.push(event));
+}
+
+TEST(Tracer, ignoresTracesWhenNotRecording) {
+    Tracer tracer;
+    auto start = std::chrono::steady_clock::now();
+
+    tracer.append("hello", start, appendMs(start, 50));
+
+    auto id = tracer.startRecording();
+    tracer.append("world", start, appendMs(start, 100));
+    auto result = tracer.stopRecording(id);
+
+    ASSERT_EQ(static_cast<size_t>(1), result.size());
+    ASSERT_EQ("world", result[0].trace);
+}
+
+TEST(TraceNames, internsNames) {
+    auto helloId = TraceNames::intern("hello");
+    auto worldId = TraceNames::intern("world");
+
+    ASSERT_NE(helloId, worldId);
+    ASSERT_EQ(helloId, TraceNames::intern(std::string("hello")));
+    ASSERT_EQ(helloId, TraceNames::internLiteral("hello", "hello"));
+    ASSERT_EQ(worldId, TraceNames::internCached(std::string("world")));
+    ASSERT_EQ("hello", TraceNames::getName(helloId));
+    ASSERT_EQ("world", TraceNames::getName(worldId));
+}
+
+TEST(ChromeTraceWriter, canWriteTraces) {
+    auto start = TraceTimePoint(std::chrono::microseconds(10));
+
+    std::vector<RecordedTrace> traces;
+    traces.emplace_back("hello", start, start + std::chrono::microseconds(5), 1, 0);
+    traces.emplace_back("\"world\"", start, start + std::chrono::microseconds(7), 2, 0);
+
+    ByteBuffer output;
+    ChromeTraceWriter writer(output);
+    writer.write(traces);
+    writer.finish();
+
+    ASSERT_EQ(
+        "{\"traceEvents\":["
+        "{\"name\":\"hello\",\"cat\":\"valdi\",\"ph\":\"X\",\"ts\":10.000000,\"dur\":5.000000,\"pid\":1,\"tid\":1},"
+        "{\"name\":\"\\\"world\\\"\",\"cat\":\"valdi\",\"ph\":\"X\",\"ts\":10.000000,\"dur\":7.000000,\"pid\":1,"
+        "\"tid\":2}]}",
+        output.toStringView());
+}
+
 } // namespace ValdiTest
@@ -1,5 +1,7 @@
 #include "valdi_core/cpp/Text/UTF16Utils.hpp"
+#include "valdi_core/cpp/Text/UTFTranscoding.hpp"
 #include <gtest/gtest.h>
+#include <random>
 #include <vector>
 
 using namespace Valdi;
@@ -54,4 +56,98 @@ TEST(UTF16ToUTF32Index, canResolveIndexesOnDifferentLength) {
     ASSERT_EQ(static_cast<size_t>(25), index.getUTF32Index(29));
 }
 
+static std::u16string toUtf16(const char* str, size_t length) {
+    auto result = utf8ToUtf16(str, length);
+    return std::u16string(result.first, result.second);
+}
+
+static std::u32string toUtf32(const char* str, size_t length) {
+    auto result = utf8ToUtf32(str, length);
+    return std::u32string(reinterpret_cast<const char32_t*>(result.first), result.second);
+}
+
+static std::string toUtf8(const std::u16string& str) {
+    auto result = utf16ToUtf8(str.data(), str.size());
+    return std::string(result.first, result.second);
+}
+
+TEST(UTFTranscoding, canTranscodeASCIIAcrossBlocks) {
+    std::string str;
+    for (size_t i = 0; i < 100; i++) {
+        str += static_cast<char>('a' + (i % 26));
+
+        auto utf16 = toUtf16(str.data(), str.size());
+        ASSERT_EQ(std::u16string(str.begin(), str.end()), utf16);
+        ASSERT_EQ(std::u32string(str.begin(), str.end()), toUtf32(str.data(), str.size()));
+        ASSERT_EQ(str, toUtf8(utf16));
+    }
+}
+
+TEST(UTFTranscoding, canTranscodeMultiByteCharacters) {
+    std::string str = "Hello World, this is a long prefix é 世界 \U0001F385 and some more ASCII after that";
+
+    ASSERT_EQ(u"Hello World, this is a long prefix é 世界 \U0001F385 and some more ASCII after that",
+              toUtf16(str.data(), str.size()));
+    ASSERT_EQ(U"Hello World, this is a long prefix é 世界 \U0001F385 and some more ASCII after that",
+              toUtf32(str.data(), str.size()));
+    ASSERT_EQ(str, toUtf8(toUtf16(str.data(), str.size())));
+}
+
+TEST(UTFTranscoding, replacesInvalidSequences) {
+    // Continuation byte, overlong encoding, truncated sequence and out of range code point
+    std::string str = "0123456789abcdef\x80 \xC0\x80 \xE4\xB8 \xF4\x90\x80\x80 end \xE4";
+
+    ASSERT_EQ(u"0123456789abcdef\uFFFD \uFFFD\uFFFD \uFFFD\uFFFD \uFFFD\uFFFD\uFFFD\uFFFD end \uFFFD",
+              toUtf16(str.data(), str.size()));
+
+    // Unpaired surrogates, including a high surrogate at the end of the input
+    std::u16string utf16 = u"0123456789abcdef";
+    utf16 += static_cast<char16_t>(0xDC00);
+    utf16 += u"x";
+    utf16 += static_cast<char16_t>(0xD800);
+
+    ASSERT_EQ("0123456789abcdef\xEF\xBF\xBDx\xEF\xBF\xBD", toUtf8(utf16));
+}
+
+TEST(UTFTranscoding, matchesScalarImplementation) {
+    std::mt19937 random(42);
+    std::vector<std::string_view> fragments = {
+        "a", "Hello World ", "é", "世界", "\U0001F385", "\x80", "\xC3", "\xED\xA0\x80", "\xF8", "\n"};
+
+    for (size_t iteration = 0; iteration < 2000; iteration++) {
+        std::string str;
+        auto fragmentsCount = random() % 40;
+        for (size_t i = 0; i < fragmentsCount; i++) {
+            // Favor ASCII so that the vectorized paths are taken
+            auto index = random() % (fragments.size() * 2);
+            str += fragments[index < fragments.size() ? index : index % 2];
+        }
+
+        std::vector<char16_t> utf16(maxUtf8ToUtf16Length(str.size()));
+        std::vector<char16_t> expectedUtf16(utf16.size());
+        auto utf16Length = transcodeUtf8ToUtf16(str.data(), str.size(), utf16.data());
+        ASSERT_EQ(transcodeUtf8ToUtf16Scalar(str.data(), str.size(), expectedUtf16.data()), utf16Length);
+        ASSERT_EQ(expectedUtf16, utf16);
+
+        std::vector<uint32_t> utf32(maxUtf8ToUtf32Length(str.size()));
+        std::vector<uint32_t> expectedUtf32(utf32.size());
+        auto utf32Length = transcodeUtf8ToUtf32(str.data(), str.size(), utf32.data());
+        ASSERT_EQ(transcodeUtf8ToUtf32Scalar(str.data(), str.size(), expectedUtf32.data()), utf32Length);
+        ASSERT_EQ(expectedUtf32, utf32);
+
+        // Also produce unpaired surrogates by cutting the UTF-16 string at a random position
+        auto utf16Input = std::u16string(utf16.data(), utf16Length);
+        if (!utf16Input.empty()) {
+            utf16Input.erase(random() % utf16Input.size(), 1);
+        }
+
+        std::vector<char> utf8(maxUtf16ToUtf8Length(utf16Input.size()));
+        std::vector<char> expectedUtf8(utf8.size());
+        auto utf8Length = transcodeUtf16ToUtf8(utf16Input.data(), utf16Input.size(), utf8.data());
+        ASSERT_EQ(transcodeUtf16ToUtf8Scalar(utf16Input.data(), utf16Input.size(), expectedUtf8.data()),
+                  utf8Length);
+        ASSERT_EQ(expectedUtf8, utf8);
+    }
+}
+
 } // namespace ValdiTest
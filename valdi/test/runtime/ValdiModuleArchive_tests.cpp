@@ -0,0 +1,155 @@
+#include "valdi/runtime/Resources/ValdiModuleArchive.hpp"
+#include "valdi_core/cpp/Resources/ValdiArchive.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
+#include <gtest/gtest.h>
+
+using namespace Valdi;
+
+namespace ValdiTest {
+
+static std::vector<ValdiArchiveEntry> makeEntries(std::vector<std::string>& storage) {
+    storage.clear();
+    storage.emplace_back("console.log('hello');");
+    storage.emplace_back(std::string(4096, 'a'));
+    storage.emplace_back("");
+    storage.emplace_back(std::string(10000, 'b') + std::string(10000, 'c'));
+
+    std::vector<ValdiArchiveEntry> entries;
+    entries.emplace_back(STRING_LITERAL("src/Hello.js"),
+                         reinterpret_cast<const Byte*>(storage[0].data()),
+                         storage[0].size());
+    entries.emplace_back(
+        STRING_LITERAL("src/Big.js"), reinterpret_cast<const Byte*>(storage[1].data()), storage[1].size());
+    entries.emplace_back(
+        STRING_LITERAL("src/Empty.css"), reinterpret_cast<const Byte*>(storage[2].data()), storage[2].size());
+    entries.emplace_back(
+        STRING_LITERAL("res/image.png"), reinterpret_cast<const Byte*>(storage[3].data()), storage[3].size());
+    return entries;
+}
+
+static std::string entryToString(const Result<BytesView>& entry) {
+    return std::string(entry.value().asStringView());
+}
+
+TEST(ValdiModuleArchive, canReadSeekableArchive) {
+    std::vector<std::string> storage;
+    auto entries = makeEntries(storage);
+
+    auto serialized = ValdiModuleArchive::serializeSeekable(entries, 3);
+    ASSERT_TRUE(ValdiModuleArchive::isSeekableArchive(serialized->data(), serialized->size()));
+
+    auto result = ValdiModuleArchive::decompress(serialized->toBytesView());
+    ASSERT_TRUE(result) << result.description();
+
+    const auto& archive = result.value();
+    ASSERT_TRUE(archive.isSeekable());
+    ASSERT_TRUE(archive.getDecompressedContent().empty());
+
+    ASSERT_EQ(std::vector<StringBox>({STRING_LITERAL("src/Hello.js"),
+                                      STRING_LITERAL("src/Big.js"),
+                                      STRING_LITERAL("src/Empty.css"),
+                                      STRING_LITERAL("res/image.png")}),
+              archive.getAllEntryPaths());
+
+    ASSERT_TRUE(archive.containsEntry(STRING_LITERAL("src/Big.js")));
+    ASSERT_FALSE(archive.containsEntry(STRING_LITERAL("src/Unknown.js")));
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        auto entry = archive.getEntryBytes(entries[i].filePath);
+        ASSERT_TRUE(entry) << entry.description();
+        ASSERT_EQ(storage[i], entryToString(entry));
+    }
+
+    ASSERT_FALSE(archive.getEntryBytes(STRING_LITERAL("src/Unknown.js")));
+}
+
+TEST(ValdiModuleArchive, getEntryOnlyReturnsStoredSeekableEntries) {
+    std::vector<std::string> storage;
+    auto entries = makeEntries(storage);
+
+    auto serialized = ValdiModuleArchive::serializeSeekable(entries, 3);
+    // The raw bytes are borrowed, the archive should point into them
+    auto result = ValdiModuleArchive::decompress(serialized->data(), serialized->size());
+    ASSERT_TRUE(result) << result.description();
+
+    const auto& archive = result.value();
+
+    // Too small to be worth compressing, stored as is in the archive
+    auto storedEntry = archive.getEntry(STRING_LITERAL("src/Hello.js"));
+    ASSERT_TRUE(storedEntry.has_value());
+    ASSERT_TRUE(storedEntry->data >= serialized->begin() && storedEntry->data < serialized->end());
+    ASSERT_EQ(storage[0], std::string(reinterpret_cast<const char*>(storedEntry->data), storedEntry->size));
+
+    // Compressed entries need to go through getEntryBytes()
+    ASSERT_FALSE(archive.getEntry(STRING_LITERAL("res/image.png")).has_value());
+    auto compressedEntry = archive.getEntryBytes(STRING_LITERAL("res/image.png"));
+    ASSERT_TRUE(compressedEntry) << compressedEntry.description();
+    ASSERT_EQ(storage[3], entryToString(compressedEntry));
+}
+
+TEST(ValdiModuleArchive, entriesOutliveCacheEviction) {
+    std::vector<std::string> storage;
+    auto entries = makeEntries(storage);
+
+    auto serialized = ValdiModuleArchive::serializeSeekable(entries, 3);
+    auto result = ValdiModuleArchive::decompress(serialized->toBytesView());
+    ASSERT_TRUE(result) << result.description();
+
+    auto& archive = result.value();
+    archive.setDecompressedEntriesCacheSize(5000);
+    ASSERT_EQ(static_cast<size_t>(5000), archive.getDecompressedEntriesCacheSize());
+
+    auto bigEntry = archive.getEntryBytes(STRING_LITERAL("src/Big.js"));
+    ASSERT_TRUE(bigEntry) << bigEntry.description();
+    // Larger than the cache, should evict the previous entry
+    auto imageEntry = archive.getEntryBytes(STRING_LITERAL("res/image.png"));
+    ASSERT_TRUE(imageEntry) << imageEntry.description();
+
+    ASSERT_EQ(storage[1], entryToString(bigEntry));
+    ASSERT_EQ(storage[3], entryToString(imageEntry));
+
+    auto bigEntryAgain = archive.getEntryBytes(STRING_LITERAL("src/Big.js"));
+    ASSERT_TRUE(bigEntryAgain) << bigEntryAgain.description();
+    ASSERT_EQ(storage[1], entryToString(bigEntryAgain));
+}
+
+TEST(ValdiModuleArchive, canStillReadLegacyArchive) {
+    std::vector<std::string> storage;
+    auto entries = makeEntries(storage);
+
+    ValdiArchiveBuilder builder;
+    for (const auto& entry : entries) {
+        builder.addEntry(entry);
+    }
+    auto serialized = builder.build();
+
+    ASSERT_FALSE(ValdiModuleArchive::isSeekableArchive(serialized->data(), serialized->size()));
+
+    auto result = ValdiModuleArchive::decompress(serialized->toBytesView());
+    ASSERT_TRUE(result) << result.description();
+
+    const auto& archive = result.value();
+    ASSERT_FALSE(archive.isSeekable());
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        auto entry = archive.getEntryBytes(entries[i].filePath);
+        ASSERT_TRUE(entry) << entry.description();
+        ASSERT_EQ(storage[i], entryToString(entry));
+
+        auto rawEntry = archive.getEntryForIndex(i);
+        ASSERT_EQ(storage[i], std::string(reinterpret_cast<const char*>(rawEntry.data), rawEntry.size));
+    }
+}
+
+TEST(ValdiModuleArchive, rejectsTruncatedSeekableArchive) {
+    std::vector<std::string> storage;
+    auto entries = makeEntries(storage);
+
+    auto serialized = ValdiModuleArchive::serializeSeekable(entries, 3);
+    auto truncated = makeShared<ByteBuffer>(serialized->begin(), serialized->begin() + serialized->size() / 2);
+
+    auto result = ValdiModuleArchive::decompress(truncated->toBytesView());
+    ASSERT_FALSE(result);
+}
+
+} // namespace ValdiTest
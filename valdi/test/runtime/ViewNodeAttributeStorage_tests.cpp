@@ -0,0 +1,137 @@
+#include "valdi/runtime/Attributes/AttributeHandler.hpp"
+#include "valdi/runtime/Attributes/AttributeHandlerDelegate.hpp"
+#include "valdi/runtime/Attributes/AttributeOwner.hpp"
+#include "valdi/runtime/Attributes/CompositeAttribute.hpp"
+#include "valdi/runtime/Attributes/ViewNodeAttributeStorage.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+using namespace Valdi;
+
+namespace ValdiTest {
+
+class TestAttributeOwner : public AttributeOwner {
+public:
+    explicit TestAttributeOwner(int priority) : _priority(priority) {}
+
+    int getAttributePriority(AttributeId /*id*/) const override {
+        return _priority;
+    }
+
+    StringBox getAttributeSource(AttributeId /*id*/) const override {
+        return STRING_LITERAL("test");
+    }
+
+private:
+    int _priority;
+};
+
+static AttributeHandler makeAttributeHandler(AttributeId id) {
+    return AttributeHandler(id, STRING_FORMAT("attribute{}", id), nullptr, false, false);
+}
+
+TEST(ViewNodeAttributeStorage, keepsEntriesSortedById) {
+    ViewNodeAttributeStorage storage;
+    std::vector<AttributeHandler> handlers;
+    for (AttributeId id = 0; id < 20; id++) {
+        handlers.emplace_back(makeAttributeHandler(id));
+    }
+
+    for (AttributeId id : {7, 3, 12, 0, 19, 5, 8, 1, 15, 2}) {
+        storage.emplace(id, &handlers[id]);
+    }
+
+    ASSERT_EQ(static_cast<size_t>(10), storage.size());
+    AttributeId previousId = 0;
+    for (const auto& entry : storage) {
+        ASSERT_LE(previousId, entry.first);
+        ASSERT_EQ(entry.first, entry.second->getAttributeId());
+        previousId = entry.first;
+    }
+
+    ASSERT_NE(storage.end(), storage.find(12));
+    ASSERT_EQ(storage.end(), storage.find(4));
+    ASSERT_EQ(storage.end(), storage.find(20));
+
+    // Emplacing an existing id returns the existing attribute
+    auto* attribute = storage.find(12)->second.get();
+    ASSERT_EQ(attribute, storage.emplace(12, &handlers[12]).get());
+    ASSERT_EQ(static_cast<size_t>(10), storage.size());
+
+    auto next = storage.erase(storage.find(12));
+    ASSERT_EQ(static_cast<AttributeId>(15), next->first);
+    ASSERT_EQ(storage.end(), storage.find(12));
+    ASSERT_EQ(static_cast<size_t>(9), storage.size());
+}
+
+TEST(ViewNodeAttributeStorage, keepsRemovedAttributesAliveWhileReferenced) {
+    ViewNodeAttributeStorage storage;
+    auto handler = makeAttributeHandler(1);
+    TestAttributeOwner owner(0);
+
+    auto attribute = storage.emplace(1, &handler);
+    attribute->setValue(&owner, Value(42.0));
+    storage.erase(storage.find(1));
+
+    ASSERT_TRUE(storage.empty());
+    ASSERT_EQ(Value(42.0), attribute->getResolvedValue());
+
+    attribute = nullptr;
+    // The slot of the released attribute is reused
+    auto allocatedBytes = storage.getAllocatedBytes();
+    storage.emplace(1, &handler);
+    ASSERT_EQ(allocatedBytes, storage.getAllocatedBytes());
+}
+
+TEST(ViewNodeAttributeStorage, resolvesValuesFromMultipleOwners) {
+    ViewNodeAttributeStorage storage;
+    auto handler = makeAttributeHandler(1);
+    TestAttributeOwner lowPriorityOwner(10);
+    TestAttributeOwner highPriorityOwner(1);
+
+    const auto& attribute = storage.emplace(1, &handler);
+    ASSERT_TRUE(attribute->setValue(&lowPriorityOwner, Value(1.0)));
+    ASSERT_TRUE(attribute->setValue(&highPriorityOwner, Value(2.0)));
+    ASSERT_EQ(Value(2.0), attribute->getResolvedValue());
+
+    ASSERT_TRUE(attribute->removeValue(&highPriorityOwner));
+    ASSERT_EQ(Value(1.0), attribute->getResolvedValue());
+    ASSERT_EQ(Value(1.0), attribute->getValue(&lowPriorityOwner));
+    ASSERT_TRUE(attribute->getValue(&highPriorityOwner).isUndefined());
+}
+
+TEST(ViewNodeAttributeStorage, onlyAllocatesBlocksOfAttributes) {
+    ViewNodeAttributeStorage storage;
+    std::vector<AttributeHandler> handlers;
+    for (AttributeId id = 0; id < 100; id++) {
+        handlers.emplace_back(makeAttributeHandler(id));
+    }
+
+    ASSERT_EQ(static_cast<size_t>(0), storage.getAllocatedBytes());
+
+    for (AttributeId id = 0; id < ViewNodeAttributeStorage::kInlineAttributesPoolCapacity; id++) {
+        storage.emplace(id, &handlers[id]);
+    }
+    // The first attributes are stored inline
+    ASSERT_EQ(static_cast<size_t>(0), storage.getAllocatedBytes());
+
+    for (AttributeId id = 0; id < ViewNodeAttributeStorage::kInlineAttributesCount; id++) {
+        storage.emplace(id, &handlers[id]);
+    }
+    // A single small block holds the remaining attributes of a node with few attributes
+    ASSERT_LT(storage.getAllocatedBytes(), ViewNodeAttributeStorage::kInlineAttributesCount * sizeof(ViewNodeAttribute));
+
+    for (AttributeId id = 0; id < 100; id++) {
+        storage.emplace(id, &handlers[id]);
+    }
+    ASSERT_EQ(static_cast<size_t>(100), storage.size());
+    // Blocks double in size, so there is at most twice the space needed
+    ASSERT_LE(storage.getAllocatedBytes(),
+              2 * 100 * sizeof(ViewNodeAttribute) + 2 * 100 * sizeof(ViewNodeAttributeStorage::Entry));
+
+    storage.clear();
+    ASSERT_TRUE(storage.empty());
+}
+
+} // namespace ValdiTest
@@ -1,5 +1,6 @@
 #include "ViewNodeTestsUtils.hpp"
 #include "gtest/gtest.h"
+#include "valdi_core/cpp/Threading/ParallelWorkerPool.hpp"
 
 using namespace Valdi;
 
@@ -1790,6 +1791,50 @@ TEST(ViewNode, canHandleLazyLayout) {
     ASSERT_EQ(Frame(8, 8, 8, 8), child->getCalculatedFrame());
 }
 
+TEST(ViewNode, canCalculateSiblingLazyLayoutsConcurrently) {
+    ViewNodeTestsDependencies utils;
+    utils.getTree().setLayoutWorkerPool(
+        makeShared<ParallelWorkerPool>(STRING_LITERAL("Valdi Layout"), ThreadQoSClassMax, 2));
+
+    auto root = utils.createRootView();
+    std::vector<Ref<ViewNode>> children;
+
+    for (size_t i = 0; i < 4; i++) {
+        auto offset = static_cast<double>(i);
+        auto container = utils.createLayout();
+        container->setPrefersLazyLayout(utils.getViewTransactionScope(), true);
+        root->appendChild(utils.getViewTransactionScope(), container);
+        utils.setViewNodeFrame(container, 0, offset * 25, 50, 25);
+
+        auto child = utils.createLayout();
+        container->appendChild(utils.getViewTransactionScope(), child);
+        utils.setViewNodeFrame(child, offset, offset, 10 + offset, 10);
+        children.emplace_back(child);
+    }
+
+    root->performLayout(utils.getViewTransactionScope(), Size(100, 100), LayoutDirectionLTR);
+    root->updateVisibilityAndPerformUpdates(utils.getViewTransactionScope());
+
+    for (size_t i = 0; i < children.size(); i++) {
+        auto value = static_cast<float>(i);
+        ASSERT_EQ(Frame(value, value, 10 + value, 10), children[i]->getCalculatedFrame());
+    }
+    ASSERT_FALSE(root->isLazyLayoutDirty());
+
+    // Only some of the lazy layouts are dirty, the others should be left untouched
+    utils.setViewNodeFrame(children[1], 4, 4, 4, 4);
+    utils.setViewNodeFrame(children[3], 6, 6, 6, 6);
+    ASSERT_TRUE(root->isLazyLayoutDirty());
+
+    root->updateVisibilityAndPerformUpdates(utils.getViewTransactionScope());
+
+    ASSERT_EQ(Frame(0, 0, 10, 10), children[0]->getCalculatedFrame());
+    ASSERT_EQ(Frame(4, 4, 4, 4), children[1]->getCalculatedFrame());
+    ASSERT_EQ(Frame(2, 2, 12, 10), children[2]->getCalculatedFrame());
+    ASSERT_EQ(Frame(6, 6, 6, 6), children[3]->getCalculatedFrame());
+    ASSERT_FALSE(root->isLazyLayoutDirty());
+}
+
 // TODO(simon): This test fails because we are not currently able to recover from switching
 // from non lazyLayout to lazyLayout after layout attributes have been applied.
 TEST(ViewNode, DISABLED_canToggleLazyLayout) {
@@ -0,0 +1,241 @@
+#include "valdi_core/cpp/Threading/WorkerPoolDispatchQueue.hpp"
+#include "valdi_core/cpp/Utils/Mutex.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace Valdi;
+
+namespace ValdiTest {
+
+static Ref<WorkerPoolDispatchQueue> makeWorkerPool(size_t workersCount) {
+    return makeShared<WorkerPoolDispatchQueue>(STRING_LITERAL("Test Pool"), ThreadQoSClassNormal, workersCount);
+}
+
+static bool waitUntil(const std::function<bool()>& predicate) {
+    auto start = std::chrono::steady_clock::now();
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() - start > std::chrono::seconds(5)) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+TEST(WorkerPoolDispatchQueue, runsTasksConcurrently) {
+    auto queue = makeWorkerPool(4);
+    Mutex mutex;
+    ConditionVariable condition;
+    size_t startedTasks = 0;
+    std::atomic_bool allStarted = true;
+
+    for (size_t i = 0; i < 4; i++) {
+        queue->async([&]() {
+            std::unique_lock<Mutex> lock(mutex);
+            startedTasks++;
+            condition.notifyAll();
+            // Every task waits for the other ones, which can only complete if they run in parallel
+            while (startedTasks < 4) {
+                if (condition.waitFor(lock, std::chrono::seconds(5)) == std::cv_status::timeout) {
+                    allStarted = false;
+                    return;
+                }
+            }
+        });
+    }
+
+    queue->sync([]() {});
+
+    ASSERT_EQ(static_cast<size_t>(4), startedTasks);
+    ASSERT_TRUE(allStarted);
+}
+
+TEST(WorkerPoolDispatchQueue, syncWaitsForPreviousTasks) {
+    auto queue = makeWorkerPool(4);
+    std::atomic<size_t> completedTasks = 0;
+    std::atomic<size_t> runningTasks = 0;
+    std::atomic_bool ranDuringSync = false;
+
+    for (size_t round = 0; round < 20; round++) {
+        for (size_t i = 0; i < 50; i++) {
+            queue->async([&]() {
+                runningTasks++;
+                std::this_thread::yield();
+                runningTasks--;
+                completedTasks++;
+            });
+        }
+
+        queue->sync([&]() {
+            if (runningTasks != 0 || completedTasks != (round + 1) * 50) {
+                ranDuringSync = true;
+            }
+        });
+        ASSERT_EQ((round + 1) * 50, completedTasks.load());
+    }
+
+    ASSERT_FALSE(ranDuringSync);
+}
+
+TEST(WorkerPoolDispatchQueue, tasksEnqueuedFromWorkersRun) {
+    auto queue = makeWorkerPool(3);
+    std::atomic<size_t> ranTasks = 0;
+
+    for (size_t i = 0; i < 10; i++) {
+        queue->async([&]() {
+            ASSERT_TRUE(queue->isCurrent());
+            for (size_t j = 0; j < 10; j++) {
+                queue->async([&]() { ranTasks++; });
+            }
+            // sync() from a worker runs inline instead of deadlocking
+            queue->sync([&]() { ranTasks++; });
+        });
+    }
+
+    ASSERT_FALSE(queue->isCurrent());
+    ASSERT_TRUE(waitUntil([&]() { return ranTasks == 110; }));
+}
+
+TEST(WorkerPoolDispatchQueue, runsHigherQoSTasksFirst) {
+    auto queue = makeWorkerPool(1);
+    std::vector<int> order;
+    Mutex blockerMutex;
+    std::unique_lock<Mutex> blockerLock(blockerMutex);
+
+    // Keep the only worker busy while the other tasks are enqueued
+    queue->async([&]() { std::lock_guard<Mutex> lock(blockerMutex); });
+    queue->async([&]() { order.emplace_back(3); }, ThreadQoSClassLow);
+    queue->async([&]() { order.emplace_back(1); }, ThreadQoSClassMax);
+    queue->async([&]() { order.emplace_back(2); }, ThreadQoSClassNormal);
+    blockerLock.unlock();
+
+    queue->sync([]() {});
+
+    ASSERT_EQ(std::vector<int>({1, 2, 3}), order);
+}
+
+TEST(WorkerPoolDispatchQueue, serialQueueRunsTasksInOrder) {
+    auto queue = makeWorkerPool(4);
+    auto serialQueue = queue->createSerialQueue(ThreadQoSClassNormal);
+    std::vector<size_t> order;
+    std::atomic<size_t> runningTasks = 0;
+    std::atomic_bool ranConcurrently = false;
+
+    for (size_t i = 0; i < 200; i++) {
+        serialQueue->async([&, i]() {
+            if (runningTasks++ != 0) {
+                ranConcurrently = true;
+            }
+            ASSERT_TRUE(serialQueue->isCurrent());
+            order.emplace_back(i);
+            runningTasks--;
+        });
+    }
+
+    serialQueue->sync([&]() { ASSERT_EQ(static_cast<size_t>(200), order.size()); });
+
+    ASSERT_FALSE(ranConcurrently);
+    for (size_t i = 0; i < order.size(); i++) {
+        ASSERT_EQ(i, order[i]);
+    }
+    serialQueue->fullTeardown();
+}
+
+TEST(WorkerPoolDispatchQueue, canCancelDelayedTasks) {
+    auto queue = makeWorkerPool(2);
+    std::atomic<size_t> ranTasks = 0;
+
+    auto cancelledTaskId = queue->asyncAfter([&]() { ranTasks += 100; }, std::chrono::milliseconds(10));
+    queue->asyncAfter([&]() { ranTasks++; }, std::chrono::milliseconds(20));
+    queue->asyncAfter([&]() { ranTasks++; }, std::chrono::milliseconds(1));
+    queue->cancel(cancelledTaskId);
+
+    ASSERT_TRUE(waitUntil([&]() { return ranTasks >= 2; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(static_cast<size_t>(2), ranTasks.load());
+}
+
+class WorkerPoolTestListener : public IQueueListener {
+public:
+    std::atomic<size_t> emptyCount = 0;
+    std::atomic<size_t> nonEmptyCount = 0;
+
+    void onQueueEmpty() final {
+        emptyCount++;
+    }
+
+    void onQueueNonEmpty() final {
+        nonEmptyCount++;
+    }
+};
+
+TEST(WorkerPoolDispatchQueue, notifiesListenerOnEmptinessChanges) {
+    auto queue = makeWorkerPool(2);
+    auto listener = makeShared<WorkerPoolTestListener>();
+    queue->setListener(listener);
+
+    for (size_t i = 0; i < 10; i++) {
+        queue->async([]() {});
+    }
+
+    // The queue might have become empty multiple times while the tasks were enqueued
+    ASSERT_TRUE(waitUntil([&]() {
+        return listener->emptyCount != 0 && listener->emptyCount == listener->nonEmptyCount;
+    }));
+
+    auto taskId = queue->asyncAfter([]() {}, std::chrono::hours(1));
+    ASSERT_EQ(listener->emptyCount.load() + 1, listener->nonEmptyCount.load());
+    queue->cancel(taskId);
+    ASSERT_EQ(listener->emptyCount.load(), listener->nonEmptyCount.load());
+}
+
+TEST(WorkerPoolDispatchQueue, dropsTasksOnTeardown) {
+    auto queue = makeWorkerPool(1);
+    std::atomic<size_t> ranTasks = 0;
+    std::atomic_bool blockerStarted = false;
+    std::atomic_bool unblocked = false;
+
+    queue->async([&]() {
+        blockerStarted = true;
+        while (!unblocked) {
+            std::this_thread::yield();
+        }
+        ranTasks++;
+    });
+    for (size_t i = 0; i < 10; i++) {
+        queue->async([&]() { ranTasks++; });
+    }
+    queue->asyncAfter([&]() { ranTasks++; }, std::chrono::milliseconds(1));
+    ASSERT_TRUE(waitUntil([&]() { return blockerStarted.load(); }));
+
+    std::thread unblocker([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        unblocked = true;
+    });
+    queue->fullTeardown();
+    unblocker.join();
+
+    ASSERT_EQ(static_cast<size_t>(1), ranTasks.load());
+
+    // Tasks enqueued after the teardown are ignored, sync still runs its function
+    queue->async([&]() { ranTasks++; });
+    bool didRunSync = false;
+    queue->sync([&]() { didRunSync = true; });
+    ASSERT_TRUE(didRunSync);
+    ASSERT_EQ(static_cast<size_t>(1), ranTasks.load());
+}
+
+TEST(WorkerPoolDispatchQueue, flushAndTeardownRunsPendingTasks) {
+    auto queue = makeWorkerPool(2);
+    std::atomic<size_t> ranTasks = 0;
+
+    for (size_t i = 0; i < 100; i++) {
+        queue->async([&]() { ranTasks++; });
+    }
+    queue->flushAndTeardown();
+
+    ASSERT_EQ(static_cast<size_t>(100), ranTasks.load());
+}
+
+} // namespace ValdiTest
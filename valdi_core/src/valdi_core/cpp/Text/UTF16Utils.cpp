@@ -7,216 +7,57 @@
 
 #include "valdi_core/cpp/Text/UTF16Utils.hpp"
 #include "UTF16Utils.hpp"
+#include "valdi_core/cpp/Text/UTFTranscoding.hpp"
 #include <algorithm>
 #include <vector>
 
 namespace Valdi {
 
-/*
- * UTF-8 and UTF-16 conversion functions from miniutf: https://github.com/dropbox/miniutf
+/**
+ Returns the data of the given thread local buffer, after making sure it can hold the given capacity.
+ The buffer only grows, as resizing it down and up again would zero fill it on every call.
  */
-struct OffsetPt {
-    int offset;
-    char32_t pt;
-};
-
-static constexpr const OffsetPt kInvalidPt = {-1, 0};
-
-// Code below copied and modifed from djinni, so that it exports to a temp buffer
-// instead of creating a new string everytime.
-
-static inline bool isHighSurrogate(char16_t c) {
-    return (c >= 0xD800) && (c < 0xDC00);
-}
-static inline bool isLowSurrogate(char16_t c) {
-    return (c >= 0xDC00) && (c < 0xE000);
-}
-
-/*
- * Like utf8DecodeCheck, but for UTF-16.
- */
-static inline OffsetPt utf16DecodeCheck(const char16_t* str, std::u16string::size_type i) {
-    if (isHighSurrogate(str[i]) && isLowSurrogate(str[i + 1])) {
-        // High surrogate followed by low surrogate
-        char32_t pt = (((str[i] - 0xD800) << 10) | (str[i + 1] - 0xDC00)) + 0x10000;
-        return {2, pt};
-    } else if (isHighSurrogate(str[i]) || isLowSurrogate(str[i])) {
-        // High surrogate *not* followed by low surrogate, or unpaired low surrogate
-        return kInvalidPt;
-    } else {
-        return {1, str[i]};
-    }
-}
-
-static inline char32_t utf16Decode(const char16_t* str, std::u16string::size_type& i) {
-    OffsetPt res = utf16DecodeCheck(str, i);
-    if (res.offset < 0) {
-        i += 1;
-        return 0xFFFD;
-    } else {
-        i += res.offset;
-        return res.pt;
-    }
-}
-
-static inline void utf8Encode(char32_t pt, std::vector<char>& out) {
-    if (pt < 0x80) {
-        out.push_back(static_cast<char>(pt));
-    } else if (pt < 0x800) {
-        out.push_back(static_cast<char>((pt >> 6) | 0xC0));
-        out.push_back(static_cast<char>((pt & 0x3F) | 0x80));
-    } else if (pt < 0x10000) {
-        out.push_back(static_cast<char>((pt >> 12) | 0xE0));
-        out.push_back(static_cast<char>(((pt >> 6) & 0x3F) | 0x80));
-        out.push_back(static_cast<char>((pt & 0x3F) | 0x80));
-    } else if (pt < 0x110000) {
-        out.push_back(static_cast<char>((pt >> 18) | 0xF0));
-        out.push_back(static_cast<char>(((pt >> 12) & 0x3F) | 0x80));
-        out.push_back(static_cast<char>(((pt >> 6) & 0x3F) | 0x80));
-        out.push_back(static_cast<char>((pt & 0x3F) | 0x80));
-    } else {
-        out.push_back(static_cast<char>(0xEF));
-        out.push_back(static_cast<char>(0xBF));
-        out.push_back(static_cast<char>(0xBD));
-    }
-}
-
-static inline OffsetPt utf8DecodeCheck(const char* str, std::string::size_type i) {
-    uint32_t b0;
-    uint32_t b1;
-    uint32_t b2;
-    uint32_t b3;
-
-    b0 = static_cast<unsigned char>(str[i]);
-
-    if (b0 < 0x80) {
-        // 1-byte character
-        return {1, b0};
-    } else if (b0 < 0xC0) {
-        // Unexpected continuation byte
-        return kInvalidPt;
-    } else if (b0 < 0xE0) {
-        // 2-byte character
-        if (((b1 = str[i + 1]) & 0xC0) != 0x80)
-            return kInvalidPt;
-
-        char32_t pt = (b0 & 0x1F) << 6 | (b1 & 0x3F);
-        if (pt < 0x80)
-            return kInvalidPt;
-
-        return {2, pt};
-    } else if (b0 < 0xF0) {
-        // 3-byte character
-        if (((b1 = str[i + 1]) & 0xC0) != 0x80)
-            return kInvalidPt;
-        if (((b2 = str[i + 2]) & 0xC0) != 0x80)
-            return kInvalidPt;
-
-        char32_t pt = (b0 & 0x0F) << 12 | (b1 & 0x3F) << 6 | (b2 & 0x3F);
-        if (pt < 0x800)
-            return kInvalidPt;
-
-        return {3, pt};
-    } else if (b0 < 0xF8) {
-        // 4-byte character
-        if (((b1 = str[i + 1]) & 0xC0) != 0x80)
-            return kInvalidPt;
-        if (((b2 = str[i + 2]) & 0xC0) != 0x80)
-            return kInvalidPt;
-        if (((b3 = str[i + 3]) & 0xC0) != 0x80)
-            return kInvalidPt;
-
-        char32_t pt = (b0 & 0x0F) << 18 | (b1 & 0x3F) << 12 | (b2 & 0x3F) << 6 | (b3 & 0x3F);
-        if (pt < 0x10000 || pt >= 0x110000)
-            return kInvalidPt;
-
-        return {4, pt};
-    } else {
-        // Codepoint out of range
-        return kInvalidPt;
-    }
-}
-
-static inline char32_t utf8Decode(const char* str, std::string::size_type& i) {
-    OffsetPt res = utf8DecodeCheck(str, i);
-    if (res.offset < 0) {
-        i += 1;
-        return 0xFFFD;
-    } else {
-        i += res.offset;
-        return res.pt;
-    }
-}
-
-static inline void utf16Encode(char32_t pt, std::vector<char16_t>& out) {
-    if (pt < 0x10000) {
-        out.push_back(static_cast<char16_t>(pt));
-    } else if (pt < 0x110000) {
-        out.push_back(static_cast<char16_t>(((pt - 0x10000) >> 10) + 0xD800));
-        out.push_back(static_cast<char16_t>((pt & 0x3FF) + 0xDC00));
-    } else {
-        out.push_back(0xFFFD);
+template<typename T>
+static T* prepareBuffer(std::vector<T>& buffer, size_t capacity) {
+    if (buffer.size() < capacity) {
+        buffer.resize(capacity);
     }
+    return buffer.data();
 }
 
 std::pair<const char*, size_t> utf16ToUtf8(const char16_t* utf16String, size_t len) {
     thread_local static std::vector<char> tBuffer;
-    auto& buffer = tBuffer;
-    buffer.clear();
+    auto* output = prepareBuffer(tBuffer, maxUtf16ToUtf8Length(len));
 
-    for (std::u16string::size_type i = 0; i < len;) {
-        utf8Encode(utf16Decode(utf16String, i), buffer);
-    }
-
-    return std::make_pair(buffer.data(), buffer.size());
+    return std::make_pair(output, transcodeUtf16ToUtf8(utf16String, len, output));
 }
 
 std::pair<const char16_t*, size_t> utf8ToUtf16(const char* utf8String, size_t len) {
     thread_local static std::vector<char16_t> tBuffer;
-    auto& buffer = tBuffer;
-    buffer.clear();
+    auto* output = prepareBuffer(tBuffer, maxUtf8ToUtf16Length(len));
 
-    for (std::string::size_type i = 0; i < len;) {
-        utf16Encode(utf8Decode(utf8String, i), buffer);
-    }
-
-    return std::make_pair(buffer.data(), buffer.size());
+    return std::make_pair(output, transcodeUtf8ToUtf16(utf8String, len, output));
 }
 
 std::pair<const uint32_t*, size_t> utf8ToUtf32(const char* utf8String, size_t len) {
     thread_local static std::vector<uint32_t> tBuffer;
-    auto& buffer = tBuffer;
-    buffer.clear();
-
-    for (std::string::size_type i = 0; i < len;) {
-        buffer.emplace_back(utf8Decode(utf8String, i));
-    }
+    auto* output = prepareBuffer(tBuffer, maxUtf8ToUtf32Length(len));
 
-    return std::make_pair(buffer.data(), buffer.size());
+    return std::make_pair(output, transcodeUtf8ToUtf32(utf8String, len, output));
 }
 
 std::pair<const uint32_t*, size_t> utf16ToUtf32(const char16_t* utf16String, size_t len) {
     thread_local static std::vector<uint32_t> tBuffer;
-    auto& buffer = tBuffer;
-    buffer.clear();
-
-    for (std::u16string::size_type i = 0; i < len;) {
-        buffer.emplace_back(utf16Decode(utf16String, i));
-    }
+    auto* output = prepareBuffer(tBuffer, maxUtf16ToUtf32Length(len));
 
-    return std::make_pair(buffer.data(), buffer.size());
+    return std::make_pair(output, transcodeUtf16ToUtf32(utf16String, len, output));
 }
 
 std::pair<const char*, size_t> utf32ToUtf8(const uint32_t* utf32String, size_t length) {
     thread_local static std::vector<char> tBuffer;
-    auto& buffer = tBuffer;
-    buffer.clear();
+    auto* output = prepareBuffer(tBuffer, maxUtf32ToUtf8Length(length));
 
-    for (std::u16string::size_type i = 0; i < length; i++) {
-        utf8Encode(utf32String[i], buffer);
-    }
-
-    return std::make_pair(buffer.data(), buffer.size());
+    return std::make_pair(output, transcodeUtf32ToUtf8(utf32String, length, output));
 }
 
 std::pair<const char16_t*, size_t> utf32ToUtf16(const uint32_t* utf32String, size_t length) {
@@ -0,0 +1,553 @@
+#include "valdi_core/cpp/Text/UTFTranscoding.hpp"
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define VALDI_UTF_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define VALDI_UTF_X86_KERNELS 0
+#endif
+
+#if defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define VALDI_UTF_NEON_KERNELS 1
+#include <arm_neon.h>
+#else
+#define VALDI_UTF_NEON_KERNELS 0
+#endif
+
+namespace Valdi {
+
+/*
+ * The scalar decoders and encoders follow the semantics of miniutf: https://github.com/dropbox/miniutf
+ * Every invalid code unit is replaced by U+FFFD. Unlike miniutf, the decoders never read past the end
+ * of the input, a sequence truncated by the end of the input is considered invalid.
+ */
+
+static constexpr char32_t kReplacementCharacter = 0xFFFD;
+
+static inline bool isHighSurrogate(char16_t c) {
+    return (c >= 0xD800) && (c < 0xDC00);
+}
+
+static inline bool isLowSurrogate(char16_t c) {
+    return (c >= 0xDC00) && (c < 0xE000);
+}
+
+static inline bool isContinuationByte(uint32_t b) {
+    return (b & 0xC0) == 0x80;
+}
+
+static inline char32_t decodeUtf16(const char16_t* str, size_t length, size_t& i) {
+    auto c = str[i];
+    if (isHighSurrogate(c) && i + 1 < length && isLowSurrogate(str[i + 1])) {
+        // High surrogate followed by low surrogate
+        char32_t pt = (((c - 0xD800) << 10) | (str[i + 1] - 0xDC00)) + 0x10000;
+        i += 2;
+        return pt;
+    }
+
+    i += 1;
+    if (isHighSurrogate(c) || isLowSurrogate(c)) {
+        // High surrogate *not* followed by low surrogate, or unpaired low surrogate
+        return kReplacementCharacter;
+    }
+
+    return c;
+}
+
+static inline char32_t decodeUtf8(const unsigned char* str, size_t length, size_t& i) {
+    uint32_t b0 = str[i];
+    auto remaining = length - i;
+
+    if (b0 < 0x80) {
+        // 1-byte character
+        i += 1;
+        return b0;
+    } else if (b0 < 0xC0) {
+        // Unexpected continuation byte
+    } else if (b0 < 0xE0) {
+        // 2-byte character
+        if (remaining >= 2 && isContinuationByte(str[i + 1])) {
+            char32_t pt = (b0 & 0x1F) << 6 | (str[i + 1] & 0x3F);
+            if (pt >= 0x80) {
+                i += 2;
+                return pt;
+            }
+        }
+    } else if (b0 < 0xF0) {
+        // 3-byte character
+        if (remaining >= 3 && isContinuationByte(str[i + 1]) && isContinuationByte(str[i + 2])) {
+            char32_t pt = (b0 & 0x0F) << 12 | (str[i + 1] & 0x3F) << 6 | (str[i + 2] & 0x3F);
+            if (pt >= 0x800) {
+                i += 3;
+                return pt;
+            }
+        }
+    } else if (b0 < 0xF8) {
+        // 4-byte character
+        if (remaining >= 4 && isContinuationByte(str[i + 1]) && isContinuationByte(str[i + 2]) &&
+            isContinuationByte(str[i + 3])) {
+            char32_t pt =
+                (b0 & 0x07) << 18 | (str[i + 1] & 0x3F) << 12 | (str[i + 2] & 0x3F) << 6 | (str[i + 3] & 0x3F);
+            if (pt >= 0x10000 && pt < 0x110000) {
+                i += 4;
+                return pt;
+            }
+        }
+    }
+
+    // Invalid or out of range sequence, skip its first byte
+    i += 1;
+    return kReplacementCharacter;
+}
+
+static inline size_t encodeUtf8(char32_t pt, char* out) {
+    if (pt < 0x80) {
+        out[0] = static_cast<char>(pt);
+        return 1;
+    } else if (pt < 0x800) {
+        out[0] = static_cast<char>((pt >> 6) | 0xC0);
+        out[1] = static_cast<char>((pt & 0x3F) | 0x80);
+        return 2;
+    } else if (pt < 0x10000) {
+        out[0] = static_cast<char>((pt >> 12) | 0xE0);
+        out[1] = static_cast<char>(((pt >> 6) & 0x3F) | 0x80);
+        out[2] = static_cast<char>((pt & 0x3F) | 0x80);
+        return 3;
+    } else if (pt < 0x110000) {
+        out[0] = static_cast<char>((pt >> 18) | 0xF0);
+        out[1] = static_cast<char>(((pt >> 12) & 0x3F) | 0x80);
+        out[2] = static_cast<char>(((pt >> 6) & 0x3F) | 0x80);
+        out[3] = static_cast<char>((pt & 0x3F) | 0x80);
+        return 4;
+    } else {
+        out[0] = static_cast<char>(0xEF);
+        out[1] = static_cast<char>(0xBF);
+        out[2] = static_cast<char>(0xBD);
+        return 3;
+    }
+}
+
+static inline size_t encodeUtf16(char32_t pt, char16_t* out) {
+    if (pt < 0x10000) {
+        out[0] = static_cast<char16_t>(pt);
+        return 1;
+    } else if (pt < 0x110000) {
+        out[0] = static_cast<char16_t>(((pt - 0x10000) >> 10) + 0xD800);
+        out[1] = static_cast<char16_t>((pt & 0x3FF) + 0xDC00);
+        return 2;
+    } else {
+        out[0] = static_cast<char16_t>(kReplacementCharacter);
+        return 1;
+    }
+}
+
+size_t transcodeUtf8ToUtf16Scalar(const char* input, size_t length, char16_t* output) {
+    const auto* str = reinterpret_cast<const unsigned char*>(input);
+    size_t count = 0;
+    for (size_t i = 0; i < length;) {
+        count += encodeUtf16(decodeUtf8(str, length, i), output + count);
+    }
+    return count;
+}
+
+size_t transcodeUtf8ToUtf32Scalar(const char* input, size_t length, uint32_t* output) {
+    const auto* str = reinterpret_cast<const unsigned char*>(input);
+    size_t count = 0;
+    for (size_t i = 0; i < length;) {
+        output[count++] = decodeUtf8(str, length, i);
+    }
+    return count;
+}
+
+size_t transcodeUtf16ToUtf8Scalar(const char16_t* input, size_t length, char* output) {
+    size_t count = 0;
+    for (size_t i = 0; i < length;) {
+        count += encodeUtf8(decodeUtf16(input, length, i), output + count);
+    }
+    return count;
+}
+
+size_t transcodeUtf16ToUtf32(const char16_t* input, size_t length, uint32_t* output) {
+    size_t count = 0;
+    for (size_t i = 0; i < length;) {
+        output[count++] = decodeUtf16(input, length, i);
+    }
+    return count;
+}
+
+size_t transcodeUtf32ToUtf8(const uint32_t* input, size_t length, char* output) {
+    size_t count = 0;
+    for (size_t i = 0; i < length; i++) {
+        count += encodeUtf8(input[i], output + count);
+    }
+    return count;
+}
+
+#if VALDI_UTF_X86_KERNELS || VALDI_UTF_NEON_KERNELS
+
+/**
+ The vectorized kernels are generic over a Block type, which converts Block::kSize code units
+ at once when they are all ASCII, and returns false otherwise. When a block contains other
+ characters, the next kScalarRunLength code units are transcoded by the scalar decoder before
+ trying the vectorized path again, so that text which is not mostly ASCII does not pay for a
+ failed vectorized check on every block.
+ The kernels are force inlined so that they are compiled with the target of their caller,
+ while the scalar runs are kept out of line so that they are compiled like the scalar functions.
+ */
+
+static constexpr size_t kScalarRunLength = 64;
+
+// The last character of a run may extend past its end
+__attribute__((noinline)) static void utf8ToUtf16Run(
+    const unsigned char* str, size_t length, size_t end, size_t& i, char16_t* output, size_t& count) {
+    auto position = i;
+    auto written = count;
+    while (position < end) {
+        written += encodeUtf16(decodeUtf8(str, length, position), output + written);
+    }
+    i = position;
+    count = written;
+}
+
+__attribute__((noinline)) static void utf8ToUtf32Run(
+    const unsigned char* str, size_t length, size_t end, size_t& i, uint32_t* output, size_t& count) {
+    auto position = i;
+    auto written = count;
+    while (position < end) {
+        output[written++] = decodeUtf8(str, length, position);
+    }
+    i = position;
+    count = written;
+}
+
+__attribute__((noinline)) static void utf16ToUtf8Run(
+    const char16_t* str, size_t length, size_t end, size_t& i, char* output, size_t& count) {
+    auto position = i;
+    auto written = count;
+    while (position < end) {
+        written += encodeUtf8(decodeUtf16(str, length, position), output + written);
+    }
+    i = position;
+    count = written;
+}
+
+static inline size_t getScalarRunEnd(size_t i, size_t length) {
+    return length - i > kScalarRunLength ? i + kScalarRunLength : length;
+}
+
+template<typename Block>
+__attribute__((always_inline)) inline size_t utf8ToUtf16Kernel(const char* input, size_t length, char16_t* output) {
+    const auto* str = reinterpret_cast<const unsigned char*>(input);
+    size_t i = 0;
+    size_t count = 0;
+
+    while (length - i >= Block::kSize) {
+        if (Block::widenAsciiToUtf16(str + i, output + count)) {
+            i += Block::kSize;
+            count += Block::kSize;
+        } else {
+            utf8ToUtf16Run(str, length, getScalarRunEnd(i, length), i, output, count);
+        }
+    }
+
+    utf8ToUtf16Run(str, length, length, i, output, count);
+
+    return count;
+}
+
+template<typename Block>
+__attribute__((always_inline)) inline size_t utf8ToUtf32Kernel(const char* input, size_t length, uint32_t* output) {
+    const auto* str = reinterpret_cast<const unsigned char*>(input);
+    size_t i = 0;
+    size_t count = 0;
+
+    while (length - i >= Block::kSize) {
+        if (Block::widenAsciiToUtf32(str + i, output + count)) {
+            i += Block::kSize;
+            count += Block::kSize;
+        } else {
+            utf8ToUtf32Run(str, length, getScalarRunEnd(i, length), i, output, count);
+        }
+    }
+
+    utf8ToUtf32Run(str, length, length, i, output, count);
+
+    return count;
+}
+
+template<typename Block>
+__attribute__((always_inline)) inline size_t utf16ToUtf8Kernel(const char16_t* input, size_t length, char* output) {
+    size_t i = 0;
+    size_t count = 0;
+
+    while (length - i >= Block::kSize) {
+        if (Block::narrowAsciiToUtf8(input + i, output + count)) {
+            i += Block::kSize;
+            count += Block::kSize;
+        } else {
+            utf16ToUtf8Run(input, length, getScalarRunEnd(i, length), i, output, count);
+        }
+    }
+
+    utf16ToUtf8Run(input, length, length, i, output, count);
+
+    return count;
+}
+
+#endif
+
+#if VALDI_UTF_X86_KERNELS
+
+struct SSE2Block {
+    static constexpr size_t kSize = 16;
+
+    static inline bool widenAsciiToUtf16(const unsigned char* input, char16_t* output) {
+        auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+        if (_mm_movemask_epi8(bytes) != 0) {
+            return false;
+        }
+
+        auto zero = _mm_setzero_si128();
+        auto* out = reinterpret_cast<__m128i*>(output);
+        _mm_storeu_si128(out, _mm_unpacklo_epi8(bytes, zero));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi8(bytes, zero));
+        return true;
+    }
+
+    static inline bool widenAsciiToUtf32(const unsigned char* input, uint32_t* output) {
+        auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+        if (_mm_movemask_epi8(bytes) != 0) {
+            return false;
+        }
+
+        auto zero = _mm_setzero_si128();
+        auto low = _mm_unpacklo_epi8(bytes, zero);
+        auto high = _mm_unpackhi_epi8(bytes, zero);
+        auto* out = reinterpret_cast<__m128i*>(output);
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(low, zero));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+        return true;
+    }
+
+    static inline bool narrowAsciiToUtf8(const char16_t* input, char* output) {
+        auto low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+        auto high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 8));
+        auto nonAscii = _mm_and_si128(_mm_or_si128(low, high), _mm_set1_epi16(static_cast<int16_t>(0xFF80)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(nonAscii, _mm_setzero_si128())) != 0xFFFF) {
+            return false;
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm_packus_epi16(low, high));
+        return true;
+    }
+};
+
+/**
+ The scalar runs are not compiled with AVX, the upper halves of the registers are cleared before
+ handing them a block to avoid the AVX/SSE transition penalty.
+ */
+struct AVX2Block {
+    static constexpr size_t kSize = 32;
+
+    __attribute__((target("avx2"))) static inline bool widenAsciiToUtf16(const unsigned char* input,
+                                                                          char16_t* output) {
+        auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+        if (_mm256_movemask_epi8(bytes) != 0) {
+            _mm256_zeroupper();
+            return false;
+        }
+
+        auto* out = reinterpret_cast<__m256i*>(output);
+        _mm256_storeu_si256(out, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes)));
+        _mm256_storeu_si256(out + 1, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1)));
+        return true;
+    }
+
+    __attribute__((target("avx2"))) static inline bool widenAsciiToUtf32(const unsigned char* input,
+                                                                          uint32_t* output) {
+        auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+        if (_mm256_movemask_epi8(bytes) != 0) {
+            _mm256_zeroupper();
+            return false;
+        }
+
+        auto low = _mm256_castsi256_si128(bytes);
+        auto high = _mm256_extracti128_si256(bytes, 1);
+        auto* out = reinterpret_cast<__m256i*>(output);
+        _mm256_storeu_si256(out, _mm256_cvtepu8_epi32(low));
+        _mm256_storeu_si256(out + 1, _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)));
+        _mm256_storeu_si256(out + 2, _mm256_cvtepu8_epi32(high));
+        _mm256_storeu_si256(out + 3, _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)));
+        return true;
+    }
+
+    __attribute__((target("avx2"))) static inline bool narrowAsciiToUtf8(const char16_t* input, char* output) {
+        auto low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+        auto high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + 16));
+        if (!_mm256_testz_si256(_mm256_or_si256(low, high), _mm256_set1_epi16(static_cast<int16_t>(0xFF80)))) {
+            _mm256_zeroupper();
+            return false;
+        }
+
+        // packus interleaves the 128 bits lanes of its inputs, restore their order
+        auto packed = _mm256_packus_epi16(low, high);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output),
+                            _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+        return true;
+    }
+};
+
+static size_t transcodeUtf8ToUtf16SSE2(const char* input, size_t length, char16_t* output) {
+    return utf8ToUtf16Kernel<SSE2Block>(input, length, output);
+}
+
+static size_t transcodeUtf8ToUtf32SSE2(const char* input, size_t length, uint32_t* output) {
+    return utf8ToUtf32Kernel<SSE2Block>(input, length, output);
+}
+
+static size_t transcodeUtf16ToUtf8SSE2(const char16_t* input, size_t length, char* output) {
+    return utf16ToUtf8Kernel<SSE2Block>(input, length, output);
+}
+
+__attribute__((target("avx2"))) static size_t transcodeUtf8ToUtf16AVX2(const char* input,
+                                                                        size_t length,
+                                                                        char16_t* output) {
+    return utf8ToUtf16Kernel<AVX2Block>(input, length, output);
+}
+
+__attribute__((target("avx2"))) static size_t transcodeUtf8ToUtf32AVX2(const char* input,
+                                                                        size_t length,
+                                                                        uint32_t* output) {
+    return utf8ToUtf32Kernel<AVX2Block>(input, length, output);
+}
+
+__attribute__((target("avx2"))) static size_t transcodeUtf16ToUtf8AVX2(const char16_t* input,
+                                                                        size_t length,
+                                                                        char* output) {
+    return utf16ToUtf8Kernel<AVX2Block>(input, length, output);
+}
+
+#endif
+
+#if VALDI_UTF_NEON_KERNELS
+
+struct NEONBlock {
+    static constexpr size_t kSize = 16;
+
+    static inline bool widenAsciiToUtf16(const unsigned char* input, char16_t* output) {
+        auto bytes = vld1q_u8(input);
+        if (vmaxvq_u8(bytes) >= 0x80) {
+            return false;
+        }
+
+        auto* out = reinterpret_cast<uint16_t*>(output);
+        vst1q_u16(out, vmovl_u8(vget_low_u8(bytes)));
+        vst1q_u16(out + 8, vmovl_high_u8(bytes));
+        return true;
+    }
+
+    static inline bool widenAsciiToUtf32(const unsigned char* input, uint32_t* output) {
+        auto bytes = vld1q_u8(input);
+        if (vmaxvq_u8(bytes) >= 0x80) {
+            return false;
+        }
+
+        auto low = vmovl_u8(vget_low_u8(bytes));
+        auto high = vmovl_high_u8(bytes);
+        vst1q_u32(output, vmovl_u16(vget_low_u16(low)));
+        vst1q_u32(output + 4, vmovl_high_u16(low));
+        vst1q_u32(output + 8, vmovl_u16(vget_low_u16(high)));
+        vst1q_u32(output + 12, vmovl_high_u16(high));
+        return true;
+    }
+
+    static inline bool narrowAsciiToUtf8(const char16_t* input, char* output) {
+        const auto* in = reinterpret_cast<const uint16_t*>(input);
+        auto low = vld1q_u16(in);
+        auto high = vld1q_u16(in + 8);
+        if (vmaxvq_u16(vorrq_u16(low, high)) >= 0x80) {
+            return false;
+        }
+
+        vst1q_u8(reinterpret_cast<uint8_t*>(output), vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+        return true;
+    }
+};
+
+static size_t transcodeUtf8ToUtf16NEON(const char* input, size_t length, char16_t* output) {
+    return utf8ToUtf16Kernel<NEONBlock>(input, length, output);
+}
+
+static size_t transcodeUtf8ToUtf32NEON(const char* input, size_t length, uint32_t* output) {
+    return utf8ToUtf32Kernel<NEONBlock>(input, length, output);
+}
+
+static size_t transcodeUtf16ToUtf8NEON(const char16_t* input, size_t length, char* output) {
+    return utf16ToUtf8Kernel<NEONBlock>(input, length, output);
+}
+
+#endif
+
+struct UTFTranscoder {
+    size_t (*utf8ToUtf16)(const char*, size_t, char16_t*);
+    size_t (*utf8ToUtf32)(const char*, size_t, uint32_t*);
+    size_t (*utf16ToUtf8)(const char16_t*, size_t, char*);
+    const char* name;
+};
+
+static UTFTranscoder resolveUTFTranscoder() {
+#if VALDI_UTF_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return UTFTranscoder{
+            &transcodeUtf8ToUtf16AVX2, &transcodeUtf8ToUtf32AVX2, &transcodeUtf16ToUtf8AVX2, "avx2"};
+    }
+    // SSE2 is part of the x86_64 baseline
+    return UTFTranscoder{&transcodeUtf8ToUtf16SSE2, &transcodeUtf8ToUtf32SSE2, &transcodeUtf16ToUtf8SSE2, "sse2"};
+#elif VALDI_UTF_NEON_KERNELS
+    return UTFTranscoder{&transcodeUtf8ToUtf16NEON, &transcodeUtf8ToUtf32NEON, &transcodeUtf16ToUtf8NEON, "neon"};
+#else
+    return UTFTranscoder{
+        &transcodeUtf8ToUtf16Scalar, &transcodeUtf8ToUtf32Scalar, &transcodeUtf16ToUtf8Scalar, "scalar"};
+#endif
+}
+
+static const UTFTranscoder& getUTFTranscoder() {
+    static const auto kTranscoder = resolveUTFTranscoder();
+    return kTranscoder;
+}
+
+/**
+ Strings shorter than this are always transcoded with the scalar implementation,
+ the vectorized kernels would not convert any block for them.
+ */
+static constexpr size_t kMinimumVectorizedLength = 32;
+
+size_t transcodeUtf8ToUtf16(const char* input, size_t length, char16_t* output) {
+    if (length < kMinimumVectorizedLength) {
+        return transcodeUtf8ToUtf16Scalar(input, length, output);
+    }
+    return getUTFTranscoder().utf8ToUtf16(input, length, output);
+}
+
+size_t transcodeUtf8ToUtf32(const char* input, size_t length, uint32_t* output) {
+    if (length < kMinimumVectorizedLength) {
+        return transcodeUtf8ToUtf32Scalar(input, length, output);
+    }
+    return getUTFTranscoder().utf8ToUtf32(input, length, output);
+}
+
+size_t transcodeUtf16ToUtf8(const char16_t* input, size_t length, char* output) {
+    if (length < kMinimumVectorizedLength) {
+        return transcodeUtf16ToUtf8Scalar(input, length, output);
+    }
+    return getUTFTranscoder().utf16ToUtf8(input, length, output);
+}
+
+const char* getUTFTranscoderName() {
+    return getUTFTranscoder().name;
+}
+
+} // namespace Valdi
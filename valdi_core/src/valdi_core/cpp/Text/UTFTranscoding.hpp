@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Valdi {
+
+/**
+ Transcoding kernels backing the UTF conversion functions of UTF16Utils.hpp.
+ They write into a caller provided output, which must be able to hold the number of
+ code units returned by the matching maxTranscodedLength function.
+
+ Invalid sequences are replaced by U+FFFD. The UTF-8 to UTF-16/UTF-32 and UTF-16 to UTF-8
+ kernels convert runs of ASCII characters using SSE2, AVX2 or NEON, selected once at runtime
+ depending on the CPU, and fall back to the scalar decoder for the other characters. All
+ implementations produce the same output as the scalar one.
+ */
+
+/**
+ Maximum number of UTF-16 code units needed to transcode a UTF-8 string of the given length.
+ */
+constexpr size_t maxUtf8ToUtf16Length(size_t utf8Length) {
+    return utf8Length;
+}
+
+/**
+ Maximum number of UTF-32 code units needed to transcode a UTF-8 string of the given length.
+ */
+constexpr size_t maxUtf8ToUtf32Length(size_t utf8Length) {
+    return utf8Length;
+}
+
+/**
+ Maximum number of UTF-8 code units needed to transcode a UTF-16 string of the given length.
+ */
+constexpr size_t maxUtf16ToUtf8Length(size_t utf16Length) {
+    return utf16Length * 3;
+}
+
+/**
+ Maximum number of UTF-32 code units needed to transcode a UTF-16 string of the given length.
+ */
+constexpr size_t maxUtf16ToUtf32Length(size_t utf16Length) {
+    return utf16Length;
+}
+
+/**
+ Maximum number of UTF-8 code units needed to transcode a UTF-32 string of the given length.
+ */
+constexpr size_t maxUtf32ToUtf8Length(size_t utf32Length) {
+    return utf32Length * 4;
+}
+
+/**
+ Each transcode function returns the number of code units written into the output.
+ */
+size_t transcodeUtf8ToUtf16(const char* input, size_t length, char16_t* output);
+size_t transcodeUtf8ToUtf32(const char* input, size_t length, uint32_t* output);
+size_t transcodeUtf16ToUtf8(const char16_t* input, size_t length, char* output);
+size_t transcodeUtf16ToUtf32(const char16_t* input, size_t length, uint32_t* output);
+size_t transcodeUtf32ToUtf8(const uint32_t* input, size_t length, char* output);
+
+/**
+ Same as their counterpart above, but always use the portable scalar implementation.
+ */
+size_t transcodeUtf8ToUtf16Scalar(const char* input, size_t length, char16_t* output);
+size_t transcodeUtf8ToUtf32Scalar(const char* input, size_t length, uint32_t* output);
+size_t transcodeUtf16ToUtf8Scalar(const char16_t* input, size_t length, char* output);
+
+/**
+ Returns the name of the transcoding kernels selected for this CPU.
+ */
+const char* getUTFTranscoderName();
+
+} // namespace Valdi
@@ -0,0 +1,90 @@
+#include "valdi_core/cpp/Threading/ParallelWorkerPool.hpp"
+#include "valdi_core/cpp/Threading/Thread.hpp"
+
+namespace Valdi {
+
+ParallelWorkerPool::ParallelWorkerPool(const StringBox& threadName, ThreadQoSClass qosClass, size_t threadsCount) {
+    for (size_t i = 0; i < threadsCount; i++) {
+        auto thread = Thread::create(threadName, qosClass, [this]() { this->runWorker(); });
+        if (!thread) {
+            // The pool works with fewer threads, the calling thread always contributes
+            break;
+        }
+        _threads.emplace_back(thread.moveValue());
+    }
+}
+
+ParallelWorkerPool::~ParallelWorkerPool() {
+    {
+        std::lock_guard<Mutex> lock(_mutex);
+        _stopped = true;
+    }
+    _tasksAvailableCondition.notifyAll();
+
+    for (const auto& thread : _threads) {
+        thread->join();
+    }
+}
+
+size_t ParallelWorkerPool::getThreadsCount() const {
+    return _threads.size();
+}
+
+void ParallelWorkerPool::run(size_t tasksCount, const Function<void(size_t)>& task) {
+    if (tasksCount == 0) {
+        return;
+    }
+
+    std::lock_guard<Mutex> runLock(_runMutex);
+    std::unique_lock<Mutex> lock(_mutex);
+    _task = &task;
+    _tasksCount = tasksCount;
+    _nextTaskIndex = 0;
+    _pendingTasksCount = tasksCount;
+
+    if (!_threads.empty()) {
+        _tasksAvailableCondition.notifyAll();
+    }
+
+    while (runNextTask(lock)) {
+    }
+
+    while (_pendingTasksCount > 0) {
+        _tasksCompletedCondition.wait(lock);
+    }
+
+    _task = nullptr;
+    _tasksCount = 0;
+    _nextTaskIndex = 0;
+}
+
+bool ParallelWorkerPool::runNextTask(std::unique_lock<Mutex>& lock) {
+    if (_task == nullptr || _nextTaskIndex >= _tasksCount) {
+        return false;
+    }
+
+    const auto* task = _task;
+    auto taskIndex = _nextTaskIndex++;
+
+    lock.unlock();
+    (*task)(taskIndex);
+    lock.lock();
+
+    _pendingTasksCount--;
+    if (_pendingTasksCount == 0) {
+        _tasksCompletedCondition.notifyAll();
+    }
+
+    return true;
+}
+
+void ParallelWorkerPool::runWorker() {
+    std::unique_lock<Mutex> lock(_mutex);
+    while (!_stopped) {
+        if (!runNextTask(lock)) {
+            _tasksAvailableCondition.wait(lock);
+        }
+    }
+}
+
+} // namespace Valdi
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "valdi_core/cpp/Threading/ThreadQoSClass.hpp"
+#include "valdi_core/cpp/Utils/Function.hpp"
+#include "valdi_core/cpp/Utils/Mutex.hpp"
+#include "valdi_core/cpp/Utils/Shared.hpp"
+#include "valdi_core/cpp/Utils/StringBox.hpp"
+#include <vector>
+
+namespace Valdi {
+
+class Thread;
+
+/**
+ ParallelWorkerPool is a fixed set of threads used to split a piece of work into independent
+ tasks which run in parallel, like rasterizing tiles or calculating the layout of independent
+ subtrees. The thread calling run() participates in the work, so a pool of N threads processes
+ up to N + 1 tasks concurrently.
+ */
+class ParallelWorkerPool : public SimpleRefCountable {
+public:
+    ParallelWorkerPool(const StringBox& threadName, ThreadQoSClass qosClass, size_t threadsCount);
+    ~ParallelWorkerPool() override;
+
+    size_t getThreadsCount() const;
+
+    /**
+     Call the given function for every index between 0 and tasksCount, and
+     return once all the calls have completed. Only one run() executes at a time.
+     */
+    void run(size_t tasksCount, const Function<void(size_t)>& task);
+
+private:
+    Mutex _runMutex;
+    Mutex _mutex;
+    ConditionVariable _tasksAvailableCondition;
+    ConditionVariable _tasksCompletedCondition;
+    std::vector<Ref<Thread>> _threads;
+    const Function<void(size_t)>* _task = nullptr;
+    size_t _tasksCount = 0;
+    size_t _nextTaskIndex = 0;
+    size_t _pendingTasksCount = 0;
+    bool _stopped = false;
+
+    void runWorker();
+    bool runNextTask(std::unique_lock<Mutex>& lock);
+};
+
+} // namespace Valdi
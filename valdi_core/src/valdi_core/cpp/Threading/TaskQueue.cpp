@@ -10,30 +10,68 @@
 
 #include "valdi_core/cpp/Constants.hpp"
 
+#include <algorithm>
+
 #include <pthread.h>
 
 namespace Valdi {
 
+// Cancelled delayed tasks are removed lazily, the heap is compacted once they
+// represent at least half of it.
+constexpr size_t kMinCancelledTasksToCompact = 32;
+
 TaskQueue::Task::Task(task_id_t id,
                       DispatchFunction function,
                       std::chrono::steady_clock::time_point executeTime,
-                      bool isBarrier)
-    : id(id), function(std::move(function)), executeTime(executeTime), isBarrier(isBarrier) {}
+                      bool isBarrier,
+                      bool isDelayed)
+    : id(id), function(std::move(function)), executeTime(executeTime), isBarrier(isBarrier), isDelayed(isDelayed) {}
+
+bool TaskQueue::TaskList::empty() const {
+    return head == nullptr;
+}
+
+void TaskQueue::TaskList::pushBack(Task* task) {
+    task->next = nullptr;
+    if (tail == nullptr) {
+        head = task;
+    } else {
+        tail->next = task;
+    }
+    tail = task;
+}
+
+TaskQueue::Task* TaskQueue::TaskList::popFront() {
+    auto* task = head;
+    head = task->next;
+    if (head == nullptr) {
+        tail = nullptr;
+    }
+    task->next = nullptr;
+    return task;
+}
 
 TaskQueue::TaskQueue() : _disposed(false) {}
 
 TaskQueue::~TaskQueue() {
     dispose();
+
+    // Release the tasks which might have been enqueued concurrently with dispose()
+    std::vector<Task*> toDelete;
+    _mutex.lock();
+    toDelete = lockFreeRemoveAllTasks();
+    _mutex.unlock();
+    deleteTasks(toDelete);
 }
 
 void TaskQueue::dispose() {
-    if (!_disposed) {
-        _disposed = true;
-        std::deque<Task> toDelete;
+    if (!_disposed.exchange(true)) {
+        std::vector<Task*> toDelete;
         _mutex.lock();
-        toDelete.swap(_tasks);
+        toDelete = lockFreeRemoveAllTasks();
         _mutex.unlock();
         _condition.notifyAll();
+        deleteTasks(toDelete);
     }
 }
 
@@ -50,57 +88,158 @@ task_id_t TaskQueue::asyncAfter(DispatchFunction function, std::chrono::steady_c
 }
 
 EnqueuedTask TaskQueue::enqueue(Valdi::DispatchFunction function) {
-    return enqueue(std::move(function), std::chrono::steady_clock::now());
+    return pushTask(std::move(function), std::chrono::steady_clock::now(), false);
 }
 
 EnqueuedTask TaskQueue::enqueue(Valdi::DispatchFunction function, std::chrono::steady_clock::duration delay) {
     return enqueue(std::move(function), std::chrono::steady_clock::now() + delay);
 }
 
-task_id_t TaskQueue::insertTask(DispatchFunction&& function,
-                                std::chrono::steady_clock::time_point executeTime,
-                                bool isBarrier) {
-    auto id = ++_taskIdCounter;
+EnqueuedTask TaskQueue::enqueue(Valdi::DispatchFunction function, std::chrono::steady_clock::time_point executeTime) {
+    return pushTask(std::move(function), executeTime, true);
+}
+
+EnqueuedTask TaskQueue::pushTask(DispatchFunction&& function,
+                                 std::chrono::steady_clock::time_point executeTime,
+                                 bool isDelayed) {
+    EnqueuedTask enqueuedTask;
+
+    if (_disposed) {
+        return enqueuedTask;
+    }
+
+    enqueuedTask.id = ++_taskIdCounter;
+    auto* task = new Task(enqueuedTask.id, std::move(function), executeTime, false, isDelayed);
+
+    auto* head = _inbox.load(std::memory_order_relaxed);
+    do {
+        task->next = head;
+    } while (!_inbox.compare_exchange_weak(head, task, std::memory_order_seq_cst, std::memory_order_relaxed));
 
-    // Keep the tasks sorted by execute time
-    Task task(id, std::move(function), executeTime, isBarrier);
+    enqueuedTask.isFirst = _first.load(std::memory_order_relaxed) && _first.exchange(false);
 
-    auto it = std::upper_bound(_tasks.begin(), _tasks.end(), task, [](const Task& a, const Task& b) {
-        if (a.executeTime == b.executeTime) {
-            return a.id < b.id;
+    // The consumer only needs to be woken up if it is waiting, or if the listener needs to
+    // know that the queue is no longer empty. Otherwise it will drain the inbox on its own.
+    if (_waiters.load() != 0 || _emptyHint.load()) {
+        {
+            std::lock_guard<Mutex> lockGuard(_mutex);
+            lockFreeDrainInbox();
         }
-        return a.executeTime < b.executeTime;
-    });
+        _condition.notifyAll();
+    }
 
-    _tasks.emplace(it, std::move(task));
+    return enqueuedTask;
+}
+
+void TaskQueue::lockFreeDrainInbox() {
+    auto* task = _inbox.exchange(nullptr, std::memory_order_acquire);
+    if (task == nullptr) {
+        return;
+    }
+
+    // The inbox is a stack, reverse it to insert the tasks in the order they were enqueued
+    Task* reversed = nullptr;
+    while (task != nullptr) {
+        auto* next = task->next;
+        task->next = reversed;
+        reversed = task;
+        task = next;
+    }
 
-    return id;
+    while (reversed != nullptr) {
+        auto* next = reversed->next;
+        lockFreeInsertTask(reversed);
+        reversed = next;
+    }
+
+    if (_empty) {
+        _empty = false;
+        _emptyHint = false;
+        if (_listener != nullptr) {
+            _listener->onQueueNonEmpty();
+        }
+    }
 }
 
-EnqueuedTask TaskQueue::enqueue(Valdi::DispatchFunction function, std::chrono::steady_clock::time_point executeTime) {
-    EnqueuedTask enqueuedTask;
+bool TaskQueue::isExecutedAfter(const Task* left, const Task* right) {
+    if (left->executeTime == right->executeTime) {
+        return left->id > right->id;
+    }
+    return left->executeTime > right->executeTime;
+}
 
-    if (_disposed) {
-        return enqueuedTask;
+void TaskQueue::lockFreeInsertTask(Task* task) {
+    if (!task->isDelayed) {
+        _readyTasks.pushBack(task);
+        return;
     }
 
-    {
-        std::lock_guard<Mutex> lockGuard(_mutex);
+    task->next = nullptr;
+    _delayedTasks.emplace_back(task);
+    std::push_heap(_delayedTasks.begin(), _delayedTasks.end(), &TaskQueue::isExecutedAfter);
+    _delayedTaskById[task->id] = task;
+}
 
-        enqueuedTask.id = insertTask(std::move(function), executeTime, false);
-        enqueuedTask.isFirst = _first;
-        _first = false;
+TaskQueue::Task* TaskQueue::lockFreePeekTask() {
+    while (!_delayedTasks.empty() && _delayedTasks.front()->isCancelled) {
+        std::pop_heap(_delayedTasks.begin(), _delayedTasks.end(), &TaskQueue::isExecutedAfter);
+        delete _delayedTasks.back();
+        _delayedTasks.pop_back();
+        _cancelledDelayedTasks--;
+    }
 
-        if (_empty) {
-            _empty = false;
-            if (_listener != nullptr) {
-                _listener->onQueueNonEmpty();
-            }
+    auto* readyTask = _readyTasks.head;
+    auto* delayedTask = _delayedTasks.empty() ? nullptr : _delayedTasks.front();
+
+    if (readyTask == nullptr) {
+        return delayedTask;
+    }
+    if (delayedTask == nullptr || isExecutedAfter(delayedTask, readyTask)) {
+        return readyTask;
+    }
+    return delayedTask;
+}
+
+void TaskQueue::lockFreePopTask(Task* task) {
+    if (!task->isDelayed) {
+        _readyTasks.popFront();
+        return;
+    }
+
+    std::pop_heap(_delayedTasks.begin(), _delayedTasks.end(), &TaskQueue::isExecutedAfter);
+    _delayedTasks.pop_back();
+    _delayedTaskById.erase(task->id);
+}
+
+void TaskQueue::lockFreeCompactDelayedTasks() {
+    if (_cancelledDelayedTasks < kMinCancelledTasksToCompact || _cancelledDelayedTasks * 2 < _delayedTasks.size()) {
+        return;
+    }
+
+    size_t retainedCount = 0;
+    for (auto* task : _delayedTasks) {
+        if (task->isCancelled) {
+            delete task;
+        } else {
+            _delayedTasks[retainedCount++] = task;
         }
     }
+    _delayedTasks.resize(retainedCount);
+    std::make_heap(_delayedTasks.begin(), _delayedTasks.end(), &TaskQueue::isExecutedAfter);
+    _cancelledDelayedTasks = 0;
+}
 
-    _condition.notifyAll();
-    return enqueuedTask;
+std::cv_status TaskQueue::lockFreeWaitUntil(std::unique_lock<Mutex>& lock,
+                                            std::chrono::steady_clock::time_point time) {
+    // Producers check _waiters after pushing to the inbox, and we check the inbox after
+    // incrementing _waiters: either we see their task, or they will wake us up.
+    _waiters++;
+    auto result = std::cv_status::no_timeout;
+    if (_inbox.load() == nullptr) {
+        result = _condition.waitUntil(lock, time);
+    }
+    _waiters--;
+    return result;
 }
 
 void TaskQueue::cancel(Valdi::task_id_t taskId) {
@@ -114,37 +253,104 @@ void TaskQueue::cancel(Valdi::task_id_t taskId) {
 }
 
 DispatchFunction TaskQueue::lockFreeRemoveTask(task_id_t taskId) {
-    for (auto i = _tasks.begin(); i != _tasks.end(); ++i) {
-        if (i->id == taskId) {
-            auto task = std::move(*i);
-            _tasks.erase(i);
-            return std::move(task.function);
+    lockFreeDrainInbox();
+
+    // Delayed tasks are marked as cancelled and removed from the heap later on
+    auto it = _delayedTaskById.find(taskId);
+    if (it != _delayedTaskById.end()) {
+        auto* task = it->second;
+        _delayedTaskById.erase(it);
+        task->isCancelled = true;
+        _cancelledDelayedTasks++;
+        auto function = std::move(task->function);
+        lockFreeCompactDelayedTasks();
+        return function;
+    }
+
+    // Ready tasks are expected to be dequeued shortly, so they are just searched for
+    Task* previous = nullptr;
+    for (auto* task = _readyTasks.head; task != nullptr; previous = task, task = task->next) {
+        if (task->id != taskId || task->isBarrier) {
+            continue;
+        }
+
+        if (previous == nullptr) {
+            _readyTasks.head = task->next;
+        } else {
+            previous->next = task->next;
         }
+        if (_readyTasks.tail == task) {
+            _readyTasks.tail = previous;
+        }
+
+        auto function = std::move(task->function);
+        delete task;
+        return function;
     }
 
     return DispatchFunction();
 }
 
+std::vector<TaskQueue::Task*> TaskQueue::lockFreeRemoveAllTasks() {
+    std::vector<Task*> tasks;
+    tasks.reserve(_delayedTasks.size());
+
+    auto* task = _inbox.exchange(nullptr, std::memory_order_acquire);
+    while (task != nullptr) {
+        tasks.emplace_back(task);
+        task = task->next;
+    }
+
+    while (!_readyTasks.empty()) {
+        task = _readyTasks.popFront();
+        if (task->isBarrier) {
+            // Barrier tasks are owned by the thread waiting on them
+            task->isCancelled = true;
+        } else {
+            tasks.emplace_back(task);
+        }
+    }
+
+    tasks.insert(tasks.end(), _delayedTasks.begin(), _delayedTasks.end());
+    _delayedTasks.clear();
+    _delayedTaskById.clear();
+    _cancelledDelayedTasks = 0;
+
+    return tasks;
+}
+
+void TaskQueue::deleteTasks(std::vector<Task*>& tasks) {
+    for (auto* task : tasks) {
+        delete task;
+    }
+    tasks.clear();
+}
+
 void TaskQueue::barrier(const DispatchFunction& function) {
     auto executeTime = std::chrono::steady_clock::now();
+    Task barrierTask(++_taskIdCounter, DispatchFunction(), executeTime, true, false);
 
     std::unique_lock<Mutex> lockGuard(_mutex);
-    auto id = insertTask(DispatchFunction(), executeTime, true);
+    // Tasks enqueued before the barrier need to run before it
+    lockFreeDrainInbox();
+    _readyTasks.pushBack(&barrierTask);
 
-    while (!_tasks.empty()) {
+    while (!barrierTask.isCancelled) {
         // Wait until we have no currently running tasks, and that the task at the front is our barrier task
-        if (_currentRunningTasks != 0 || _tasks.front().id != id) {
+        if (_currentRunningTasks != 0 || _runningBarrier || lockFreePeekTask() != &barrierTask) {
             _condition.wait(lockGuard);
             continue;
         }
 
         // We have no running tasks, and our barrier task is at the front.
         // We can now execute our barrier
+        lockFreePopTask(&barrierTask);
         _currentRunningTasks++;
+        _runningBarrier = true;
         lockGuard.unlock();
         function();
         lockGuard.lock();
-        auto toDelete = lockFreeRemoveTask(id);
+        _runningBarrier = false;
         _currentRunningTasks--;
         lockGuard.unlock();
         _condition.notifyAll();
@@ -154,18 +360,22 @@ void TaskQueue::barrier(const DispatchFunction& function) {
 
 DispatchFunction TaskQueue::nextTask(std::chrono::steady_clock::time_point maxTime, bool* shouldRun) {
     std::unique_lock<Mutex> lockGuard(_mutex);
-    bool hasTask = false;
+    Task* task = nullptr;
 
     while (!_disposed) {
-        if (_tasks.empty()) {
+        lockFreeDrainInbox();
+
+        auto* nextTask = lockFreePeekTask();
+        if (nextTask == nullptr) {
             if (!_empty) {
                 _empty = true;
+                _emptyHint = true;
                 if (_listener != nullptr) {
                     _listener->onQueueEmpty();
                 }
             }
             // Wait until there's at least one task
-            auto result = _condition.waitUntil(lockGuard, maxTime);
+            auto result = lockFreeWaitUntil(lockGuard, maxTime);
             if (result == std::cv_status::timeout) {
                 // We timed out waiting for tasks, so we break now
                 break;
@@ -175,9 +385,9 @@ DispatchFunction TaskQueue::nextTask(std::chrono::steady_clock::time_point maxTi
             }
         }
 
-        if (_currentRunningTasks >= _maxConcurrentTasks) {
+        if (_currentRunningTasks >= _maxConcurrentTasks || _runningBarrier) {
             // Wait until there are no more pending running tasks
-            auto result = _condition.waitUntil(lockGuard, maxTime);
+            auto result = lockFreeWaitUntil(lockGuard, maxTime);
             if (result == std::cv_status::timeout) {
                 // We timed out waiting for tasks, so we break now
                 break;
@@ -188,19 +398,18 @@ DispatchFunction TaskQueue::nextTask(std::chrono::steady_clock::time_point maxTi
         }
 
         // Wait until the next task is ready to run
-        const auto& nextTask = _tasks.front();
-        if (VALDI_UNLIKELY(nextTask.isBarrier)) {
-            auto result = _condition.waitUntil(lockGuard, maxTime);
+        if (VALDI_UNLIKELY(nextTask->isBarrier)) {
+            auto result = lockFreeWaitUntil(lockGuard, maxTime);
 
             if (result == std::cv_status::timeout) {
                 break;
             } else {
                 continue;
             }
-        } else if (nextTask.executeTime > std::chrono::steady_clock::now()) {
-            auto maxTimeToWait = std::min(maxTime, nextTask.executeTime);
+        } else if (nextTask->executeTime > std::chrono::steady_clock::now()) {
+            auto maxTimeToWait = std::min(maxTime, nextTask->executeTime);
 
-            auto result = _condition.waitUntil(lockGuard, maxTimeToWait);
+            auto result = lockFreeWaitUntil(lockGuard, maxTimeToWait);
 
             // If we reached the given maxTime, we should abort.
             if (maxTimeToWait == maxTime && result == std::cv_status::timeout) {
@@ -211,17 +420,18 @@ DispatchFunction TaskQueue::nextTask(std::chrono::steady_clock::time_point maxTi
         }
 
         // The next task is ready
-        hasTask = true;
+        task = nextTask;
         break;
     }
 
     DispatchFunction nextTaskFunction;
-    if (_disposed || !hasTask) {
+    if (_disposed || task == nullptr) {
         *shouldRun = false;
     } else {
-        nextTaskFunction = std::move(_tasks.front().function);
+        lockFreePopTask(task);
+        nextTaskFunction = std::move(task->function);
         _currentRunningTasks++;
-        _tasks.pop_front();
+        delete task;
     }
     return nextTaskFunction;
 }
@@ -14,8 +14,11 @@
 #include "valdi_core/cpp/Utils/Function.hpp"
 #include "valdi_core/cpp/Utils/Mutex.hpp"
 #include "valdi_core/cpp/Utils/Shared.hpp"
+#include <atomic>
 #include <chrono>
 #include <queue>
+#include <unordered_map>
+#include <vector>
 
 namespace Valdi {
 
@@ -24,6 +27,15 @@ struct EnqueuedTask {
     bool isFirst = false;
 };
 
+/**
+ A queue of tasks ordered by execute time, which can be consumed by one or more threads.
+
+ Producers never take the lock: every enqueued task is pushed onto a lock-free inbox, which
+ is drained by whichever thread holds the lock next, typically the consumer. Tasks without
+ a delay are appended to a FIFO of ready tasks, delayed tasks are kept in a min-heap indexed
+ by task id, making cancel() O(1) for them. The consumer runs the earliest of the two heads,
+ which preserves the (executeTime, id) ordering of the tasks.
+ */
 class TaskQueue : public IDispatchQueue {
 public:
     TaskQueue();
@@ -62,31 +74,68 @@ private:
         DispatchFunction function;
         std::chrono::steady_clock::time_point executeTime;
         bool isBarrier;
+        bool isDelayed;
+        bool isCancelled = false;
+        Task* next = nullptr;
 
         Task(task_id_t id,
              DispatchFunction function,
              std::chrono::steady_clock::time_point executeTime,
-             bool isBarrier);
+             bool isBarrier,
+             bool isDelayed);
+    };
+
+    /**
+     Intrusive FIFO of tasks, linked through Task::next.
+     */
+    struct TaskList {
+        Task* head = nullptr;
+        Task* tail = nullptr;
+
+        bool empty() const;
+        void pushBack(Task* task);
+        Task* popFront();
     };
 
     std::atomic_bool _disposed;
+    std::atomic_bool _first{true};
+    std::atomic<task_id_t> _taskIdCounter{0};
+    // Lock-free stack of tasks pushed by the producers, most recent first
+    std::atomic<Task*> _inbox{nullptr};
+    // Number of threads waiting on _condition, producers need to wake them up
+    std::atomic<size_t> _waiters{0};
+    // Mirrors _empty, so that producers can tell when the listener needs to be notified
+    std::atomic_bool _emptyHint{true};
+
     mutable Mutex _mutex;
     ConditionVariable _condition;
-    task_id_t _taskIdCounter{0};
-    std::deque<Task> _tasks;
+    TaskList _readyTasks;
+    std::vector<Task*> _delayedTasks;
+    std::unordered_map<task_id_t, Task*> _delayedTaskById;
+    size_t _cancelledDelayedTasks = 0;
     bool _empty = true;
-    bool _first = true;
+    bool _runningBarrier = false;
     size_t _currentRunningTasks = 0;
     size_t _maxConcurrentTasks = 1;
     Shared<IQueueListener> _listener;
 
     DispatchFunction nextTask(std::chrono::steady_clock::time_point maxTime, bool* shouldRun);
 
-    task_id_t insertTask(DispatchFunction&& function,
-                         std::chrono::steady_clock::time_point executeTime,
-                         bool isBarrier);
+    EnqueuedTask pushTask(DispatchFunction&& function,
+                          std::chrono::steady_clock::time_point executeTime,
+                          bool isDelayed);
 
+    void lockFreeDrainInbox();
+    void lockFreeInsertTask(Task* task);
+    Task* lockFreePeekTask();
+    void lockFreePopTask(Task* task);
+    void lockFreeCompactDelayedTasks();
+    std::cv_status lockFreeWaitUntil(std::unique_lock<Mutex>& lock, std::chrono::steady_clock::time_point time);
     DispatchFunction lockFreeRemoveTask(task_id_t taskId);
+    std::vector<Task*> lockFreeRemoveAllTasks();
+
+    static bool isExecutedAfter(const Task* left, const Task* right);
+    static void deleteTasks(std::vector<Task*>& tasks);
 };
 
 } // namespace Valdi
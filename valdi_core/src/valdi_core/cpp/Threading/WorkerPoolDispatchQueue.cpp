@@ -0,0 +1,707 @@
+#include "valdi_core/cpp/Threading/WorkerPoolDispatchQueue.hpp"
+#include "utils/debugging/Assert.hpp"
+#include "valdi_core/cpp/Constants.hpp"
+#include "valdi_core/cpp/Threading/Thread.hpp"
+#include "valdi_core/cpp/Utils/Mutex.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Valdi {
+
+constexpr size_t kLanesCount = static_cast<size_t>(ThreadQoSClassMax) + 1;
+constexpr size_t kMaxDefaultWorkersCount = 8;
+constexpr uint64_t kNoBarrier = std::numeric_limits<uint64_t>::max();
+constexpr std::chrono::steady_clock::rep kNoDelayedTask = std::numeric_limits<std::chrono::steady_clock::rep>::max();
+// Cancelled delayed tasks are removed lazily from the heap, it is rebuilt when they start to dominate it
+constexpr size_t kMinCancelledDelayedTasksToCompact = 32;
+// Number of tasks a serial queue runs before letting the worker pick other tasks
+constexpr size_t kMaxSerialTasksPerDrain = 16;
+
+class SerialWorkerQueue;
+
+static thread_local WorkerPool* currentPool = nullptr;
+static thread_local size_t currentWorkerIndex = 0;
+static thread_local SerialWorkerQueue* currentSerialQueue = nullptr;
+
+struct WorkerPoolTask {
+    DispatchFunction function;
+    uint64_t sequence = 0;
+};
+
+class WorkerPool : public SimpleRefCountable {
+public:
+    WorkerPool(const StringBox& name, ThreadQoSClass qosClass, size_t workersCount);
+    ~WorkerPool() override;
+
+    void submit(DispatchFunction&& function, ThreadQoSClass qosClass);
+    task_id_t submitAfter(DispatchFunction&& function,
+                          ThreadQoSClass qosClass,
+                          std::chrono::steady_clock::time_point executeTime);
+    void cancel(task_id_t taskId);
+    void barrier(const DispatchFunction& function);
+    void dispose();
+
+    bool isCurrent() const;
+    bool isDisposed() const;
+    size_t getWorkersCount() const;
+
+    ThreadQoSClass getQoSClass() const;
+    void setQoSClass(ThreadQoSClass qosClass);
+
+    void setListener(const Shared<IQueueListener>& listener);
+    Shared<IQueueListener> getListener() const;
+
+private:
+    struct Worker {
+        Mutex mutex;
+        std::array<std::deque<WorkerPoolTask>, kLanesCount> lanes;
+        // Bit mask of the non empty lanes, which lets the other workers skip them without locking
+        std::atomic<uint32_t> nonEmptyLanes{0};
+        Ref<Thread> thread;
+    };
+
+    struct DelayedTask {
+        DispatchFunction function;
+        ThreadQoSClass qosClass;
+    };
+
+    using DelayedTaskEntry = std::pair<std::chrono::steady_clock::time_point, task_id_t>;
+
+    StringBox _name;
+    std::atomic<ThreadQoSClass> _qosClass;
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::atomic_bool _started{false};
+    std::atomic_bool _disposed{false};
+    std::atomic<size_t> _nextWorkerIndex{0};
+
+    // Every task gets a sequence number when it is pushed into a worker. Barriers use them
+    // to know which tasks were enqueued before them.
+    std::atomic<uint64_t> _sequence{0};
+    std::atomic<uint64_t> _completedCount{0};
+    // Tasks with a greater sequence cannot start until the barrier has completed
+    std::atomic<uint64_t> _barrierSequence{kNoBarrier};
+    Mutex _barrierMutex;
+
+    // Incremented whenever the workers might have new tasks to run
+    std::atomic<uint64_t> _workVersion{0};
+    std::atomic<size_t> _sleepingWorkers{0};
+
+    mutable Mutex _mutex;
+    ConditionVariable _workersCondition;
+    ConditionVariable _barrierCondition;
+    task_id_t _taskIdCounter = 0;
+    std::vector<DelayedTaskEntry> _delayedTaskEntries;
+    std::unordered_map<task_id_t, DelayedTask> _delayedTasks;
+    std::atomic<std::chrono::steady_clock::rep> _nextDelayedTaskTime{kNoDelayedTask};
+
+    std::atomic<int64_t> _pendingTasksCount{0};
+    std::atomic_bool _hasListener{false};
+    mutable Mutex _listenerMutex;
+    Shared<IQueueListener> _listener;
+    bool _notifiedEmpty = true;
+
+    void ensureStarted();
+    void runWorker(size_t workerIndex);
+    void park(uint64_t workVersion);
+    bool findTask(size_t workerIndex, WorkerPoolTask& task);
+    bool tryPopTask(Worker& worker, size_t lane, WorkerPoolTask& task);
+    void submitDueDelayedTasks();
+    void lockFreeUpdateNextDelayedTaskTime();
+    void lockFreeCompactDelayedTasks();
+    void updatePendingTasksCount(int64_t delta);
+};
+
+static size_t toLane(ThreadQoSClass qosClass) {
+    return std::min(static_cast<size_t>(qosClass), kLanesCount - 1);
+}
+
+WorkerPool::WorkerPool(const StringBox& name, ThreadQoSClass qosClass, size_t workersCount)
+    : _name(name), _qosClass(qosClass) {
+    workersCount = std::max(workersCount, static_cast<size_t>(1));
+    _workers.reserve(workersCount);
+    for (size_t i = 0; i < workersCount; i++) {
+        _workers.emplace_back(std::make_unique<Worker>());
+    }
+}
+
+WorkerPool::~WorkerPool() = default;
+
+void WorkerPool::ensureStarted() {
+    if (_started.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::lock_guard<Mutex> lock(_mutex);
+    if (_started || _disposed) {
+        return;
+    }
+
+    auto qosClass = _qosClass.load();
+    for (size_t i = 0; i < _workers.size(); i++) {
+        auto threadResult = Thread::create(STRING_FORMAT("{} {}", _name.toStringView(), i + 1),
+                                           qosClass,
+                                           [self = strongSmallRef(this), i]() { self->runWorker(i); });
+        SC_ASSERT(threadResult.success(), threadResult.description());
+        _workers[i]->thread = threadResult.moveValue();
+    }
+
+    _started.store(true, std::memory_order_release);
+}
+
+void WorkerPool::submit(DispatchFunction&& function, ThreadQoSClass qosClass) {
+    if (_disposed) {
+        return;
+    }
+
+    ensureStarted();
+    updatePendingTasksCount(1);
+
+    // Keep tasks enqueued from a worker on that worker, the other ones are spread across the workers
+    auto workerIndex =
+        currentPool == this ? currentWorkerIndex : _nextWorkerIndex.fetch_add(1, std::memory_order_relaxed);
+    auto& worker = *_workers[workerIndex % _workers.size()];
+    auto lane = toLane(qosClass);
+
+    {
+        std::lock_guard<Mutex> lock(worker.mutex);
+        // The sequence is taken under the worker lock, so that it is always increasing within a lane
+        worker.lanes[lane].emplace_back(WorkerPoolTask{std::move(function), _sequence++});
+        worker.nonEmptyLanes.fetch_or(1u << lane, std::memory_order_relaxed);
+    }
+
+    _workVersion++;
+    if (_sleepingWorkers.load() != 0) {
+        {
+            // Synchronize with a worker which is about to sleep, so that it doesn't miss the notification
+            std::lock_guard<Mutex> lock(_mutex);
+        }
+        _workersCondition.notifyOne();
+    }
+}
+
+task_id_t WorkerPool::submitAfter(DispatchFunction&& function,
+                                  ThreadQoSClass qosClass,
+                                  std::chrono::steady_clock::time_point executeTime) {
+    if (_disposed) {
+        return DispatchQueue::TaskIDNull;
+    }
+
+    ensureStarted();
+    updatePendingTasksCount(1);
+
+    task_id_t taskId;
+    bool isNextDelayedTask;
+    {
+        std::lock_guard<Mutex> lock(_mutex);
+        taskId = ++_taskIdCounter;
+        _delayedTasks.emplace(taskId, DelayedTask{std::move(function), qosClass});
+        _delayedTaskEntries.emplace_back(executeTime, taskId);
+        std::push_heap(_delayedTaskEntries.begin(), _delayedTaskEntries.end(), std::greater<>());
+        isNextDelayedTask = _delayedTaskEntries.front().second == taskId;
+        if (isNextDelayedTask) {
+            lockFreeUpdateNextDelayedTaskTime();
+            _workVersion++;
+        }
+    }
+
+    if (isNextDelayedTask) {
+        // Sleeping workers need to wait until the new execute time
+        _workersCondition.notifyAll();
+    }
+
+    return taskId;
+}
+
+void WorkerPool::cancel(task_id_t taskId) {
+    {
+        DispatchFunction toDelete;
+        std::lock_guard<Mutex> lock(_mutex);
+        const auto& it = _delayedTasks.find(taskId);
+        if (it == _delayedTasks.end()) {
+            return;
+        }
+        toDelete = std::move(it->second.function);
+        _delayedTasks.erase(it);
+        lockFreeCompactDelayedTasks();
+    }
+
+    updatePendingTasksCount(-1);
+}
+
+void WorkerPool::lockFreeUpdateNextDelayedTaskTime() {
+    _nextDelayedTaskTime = _delayedTaskEntries.empty() ? kNoDelayedTask :
+                                                         _delayedTaskEntries.front().first.time_since_epoch().count();
+}
+
+void WorkerPool::lockFreeCompactDelayedTasks() {
+    auto cancelledCount = _delayedTaskEntries.size() - _delayedTasks.size();
+    if (cancelledCount < kMinCancelledDelayedTasksToCompact || cancelledCount < _delayedTasks.size()) {
+        return;
+    }
+
+    auto it = std::remove_if(_delayedTaskEntries.begin(), _delayedTaskEntries.end(), [&](const auto& entry) {
+        return _delayedTasks.find(entry.second) == _delayedTasks.end();
+    });
+    _delayedTaskEntries.erase(it, _delayedTaskEntries.end());
+    std::make_heap(_delayedTaskEntries.begin(), _delayedTaskEntries.end(), std::greater<>());
+    lockFreeUpdateNextDelayedTaskTime();
+}
+
+void WorkerPool::submitDueDelayedTasks() {
+    auto nextDelayedTaskTime = _nextDelayedTaskTime.load(std::memory_order_relaxed);
+    if (nextDelayedTaskTime == kNoDelayedTask ||
+        std::chrono::steady_clock::now().time_since_epoch().count() < nextDelayedTaskTime) {
+        return;
+    }
+
+    std::vector<DelayedTask> dueTasks;
+    {
+        std::lock_guard<Mutex> lock(_mutex);
+        auto now = std::chrono::steady_clock::now();
+        while (!_delayedTaskEntries.empty() && _delayedTaskEntries.front().first <= now) {
+            auto taskId = _delayedTaskEntries.front().second;
+            std::pop_heap(_delayedTaskEntries.begin(), _delayedTaskEntries.end(), std::greater<>());
+            _delayedTaskEntries.pop_back();
+
+            const auto& it = _delayedTasks.find(taskId);
+            if (it != _delayedTasks.end()) {
+                dueTasks.emplace_back(std::move(it->second));
+                _delayedTasks.erase(it);
+            }
+        }
+        lockFreeUpdateNextDelayedTaskTime();
+    }
+
+    for (auto& dueTask : dueTasks) {
+        submit(std::move(dueTask.function), dueTask.qosClass);
+        updatePendingTasksCount(-1);
+    }
+}
+
+bool WorkerPool::tryPopTask(Worker& worker, size_t lane, WorkerPoolTask& task) {
+    auto laneMask = 1u << lane;
+    if ((worker.nonEmptyLanes.load(std::memory_order_relaxed) & laneMask) == 0) {
+        return false;
+    }
+
+    std::lock_guard<Mutex> lock(worker.mutex);
+    auto& tasks = worker.lanes[lane];
+    if (tasks.empty() || tasks.front().sequence > _barrierSequence.load()) {
+        return false;
+    }
+
+    task = std::move(tasks.front());
+    tasks.pop_front();
+    if (tasks.empty()) {
+        worker.nonEmptyLanes.fetch_and(~laneMask, std::memory_order_relaxed);
+    }
+
+    return true;
+}
+
+bool WorkerPool::findTask(size_t workerIndex, WorkerPoolTask& task) {
+    auto workersCount = _workers.size();
+
+    // Higher QoS lanes first, in our own deque first and then stealing from the other workers
+    for (size_t lane = kLanesCount; lane-- > 0;) {
+        for (size_t i = 0; i < workersCount; i++) {
+            if (tryPopTask(*_workers[(workerIndex + i) % workersCount], lane, task)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void WorkerPool::park(uint64_t workVersion) {
+    std::unique_lock<Mutex> lock(_mutex);
+    _sleepingWorkers++;
+
+    // Submitters increment _workVersion before checking _sleepingWorkers, so either we see
+    // their task here, or they will wake us up.
+    if (_workVersion.load() == workVersion && !_disposed) {
+        if (_delayedTaskEntries.empty()) {
+            _workersCondition.wait(lock);
+        } else {
+            // Copied as the heap can be modified while we are waiting
+            auto nextDelayedTaskTime = _delayedTaskEntries.front().first;
+            _workersCondition.waitUntil(lock, nextDelayedTaskTime);
+        }
+    }
+
+    _sleepingWorkers--;
+}
+
+void WorkerPool::runWorker(size_t workerIndex) {
+    currentPool = this;
+    currentWorkerIndex = workerIndex;
+
+    WorkerPoolTask task;
+    while (!_disposed) {
+        auto workVersion = _workVersion.load();
+        submitDueDelayedTasks();
+
+        if (!findTask(workerIndex, task)) {
+            park(workVersion);
+            continue;
+        }
+
+        task.function();
+        // Release the captured objects before the task is considered completed
+        task.function = DispatchFunction();
+
+        _completedCount++;
+        if (VALDI_UNLIKELY(_barrierSequence.load() != kNoBarrier)) {
+            {
+                std::lock_guard<Mutex> lock(_mutex);
+            }
+            _barrierCondition.notifyAll();
+        }
+
+        updatePendingTasksCount(-1);
+    }
+
+    currentPool = nullptr;
+}
+
+void WorkerPool::barrier(const DispatchFunction& function) {
+    std::lock_guard<Mutex> barrierLock(_barrierMutex);
+
+    // Take the barrier sequence while no task can be pushed, all the tasks with a lower
+    // sequence need to complete before the barrier, and the other ones after.
+    for (auto& worker : _workers) {
+        worker->mutex.lock();
+    }
+    auto sequence = _sequence++;
+    _barrierSequence = sequence;
+    for (auto& worker : _workers) {
+        worker->mutex.unlock();
+    }
+
+    {
+        // The tasks are dropped when the pool is disposed, so there is nothing left to wait for
+        std::unique_lock<Mutex> lock(_mutex);
+        while (_completedCount.load() != sequence && !_disposed) {
+            _barrierCondition.wait(lock);
+        }
+    }
+
+    function();
+
+    _barrierSequence = kNoBarrier;
+    _completedCount++;
+
+    {
+        std::lock_guard<Mutex> lock(_mutex);
+        _workVersion++;
+    }
+    _workersCondition.notifyAll();
+}
+
+void WorkerPool::dispose() {
+    if (_disposed.exchange(true)) {
+        return;
+    }
+
+    std::vector<WorkerPoolTask> tasks;
+    std::unordered_map<task_id_t, DelayedTask> delayedTasks;
+    std::vector<Ref<Thread>> threads;
+
+    for (auto& worker : _workers) {
+        std::lock_guard<Mutex> lock(worker->mutex);
+        for (auto& lane : worker->lanes) {
+            std::move(lane.begin(), lane.end(), std::back_inserter(tasks));
+            lane.clear();
+        }
+        worker->nonEmptyLanes = 0;
+    }
+
+    {
+        std::lock_guard<Mutex> lock(_mutex);
+        delayedTasks = std::move(_delayedTasks);
+        _delayedTasks.clear();
+        _delayedTaskEntries.clear();
+        lockFreeUpdateNextDelayedTaskTime();
+        for (auto& worker : _workers) {
+            threads.emplace_back(std::move(worker->thread));
+        }
+        _workVersion++;
+    }
+
+    _workersCondition.notifyAll();
+    _barrierCondition.notifyAll();
+
+    for (size_t i = 0; i < threads.size(); i++) {
+        // A worker cannot join itself, it will exit after its current task
+        if (threads[i] != nullptr && !(currentPool == this && currentWorkerIndex == i)) {
+            threads[i]->join();
+        }
+    }
+}
+
+bool WorkerPool::isCurrent() const {
+    return currentPool == this;
+}
+
+bool WorkerPool::isDisposed() const {
+    return _disposed;
+}
+
+size_t WorkerPool::getWorkersCount() const {
+    return _workers.size();
+}
+
+ThreadQoSClass WorkerPool::getQoSClass() const {
+    return _qosClass;
+}
+
+void WorkerPool::setQoSClass(ThreadQoSClass qosClass) {
+    std::lock_guard<Mutex> lock(_mutex);
+    _qosClass = qosClass;
+    for (auto& worker : _workers) {
+        if (worker->thread != nullptr) {
+            worker->thread->setQoSClass(qosClass);
+        }
+    }
+}
+
+void WorkerPool::updatePendingTasksCount(int64_t delta) {
+    auto previousCount = _pendingTasksCount.fetch_add(delta);
+    auto newCount = previousCount + delta;
+    if ((previousCount != 0 && newCount != 0) || !_hasListener) {
+        return;
+    }
+
+    // The count might have changed again since, notify the latest state only
+    std::lock_guard<Mutex> lock(_listenerMutex);
+    auto empty = _pendingTasksCount.load() == 0;
+    if (empty == _notifiedEmpty) {
+        return;
+    }
+    _notifiedEmpty = empty;
+
+    if (_listener != nullptr) {
+        if (empty) {
+            _listener->onQueueEmpty();
+        } else {
+            _listener->onQueueNonEmpty();
+        }
+    }
+}
+
+void WorkerPool::setListener(const Shared<IQueueListener>& listener) {
+    std::lock_guard<Mutex> lock(_listenerMutex);
+    _listener = listener;
+    _hasListener = listener != nullptr;
+}
+
+Shared<IQueueListener> WorkerPool::getListener() const {
+    std::lock_guard<Mutex> lock(_listenerMutex);
+    return _listener;
+}
+
+/**
+ A queue running its tasks in order on a WorkerPool. At most one task of the queue is
+ enqueued in the pool at a time, which runs a batch of the queue tasks.
+ */
+class SerialWorkerQueue : public DispatchQueue {
+public:
+    SerialWorkerQueue(Ref<WorkerPool> pool, ThreadQoSClass qosClass)
+        : _pool(std::move(pool)), _qosClass(qosClass) {}
+
+    ~SerialWorkerQueue() override {
+        fullTeardown();
+    }
+
+    void sync(const DispatchFunction& function) final {
+        if (isCurrent() || _pool->isDisposed()) {
+            function();
+            return;
+        }
+
+        std::promise<void> promise;
+        auto future = promise.get_future();
+
+        async([&]() {
+            _runningSync = true;
+            function();
+            _runningSync = false;
+            promise.set_value();
+        });
+
+        future.get();
+    }
+
+    void async(DispatchFunction function) final {
+        {
+            std::lock_guard<Mutex> lock(_mutex);
+            if (_disposed) {
+                return;
+            }
+            _tasks.emplace_back(std::move(function));
+            if (_scheduled) {
+                return;
+            }
+            _scheduled = true;
+        }
+
+        scheduleDrain();
+    }
+
+    task_id_t asyncAfter(DispatchFunction function, std::chrono::steady_clock::duration delay) final {
+        return _pool->submitAfter(
+            [self = strongSmallRef(this), function = std::move(function)]() { self->async(function); },
+            _qosClass,
+            std::chrono::steady_clock::now() + delay);
+    }
+
+    void cancel(task_id_t taskId) final {
+        _pool->cancel(taskId);
+    }
+
+    bool isCurrent() const final {
+        return currentSerialQueue == this;
+    }
+
+    void fullTeardown() final {
+        std::deque<DispatchFunction> toDelete;
+        std::lock_guard<Mutex> lock(_mutex);
+        _disposed = true;
+        toDelete.swap(_tasks);
+    }
+
+    void setListener(const Shared<IQueueListener>& listener) final {
+        std::lock_guard<Mutex> lock(_mutex);
+        _listener = listener;
+    }
+
+    Shared<IQueueListener> getListener() const final {
+        std::lock_guard<Mutex> lock(_mutex);
+        return _listener;
+    }
+
+private:
+    Ref<WorkerPool> _pool;
+    ThreadQoSClass _qosClass;
+    mutable Mutex _mutex;
+    std::deque<DispatchFunction> _tasks;
+    bool _scheduled = false;
+    bool _disposed = false;
+    // Only stored, the queue does not notify listeners
+    Shared<IQueueListener> _listener;
+
+    void scheduleDrain() {
+        _pool->submit([self = strongSmallRef(this)]() { self->drain(); }, _qosClass);
+    }
+
+    void drain() {
+        auto* previousSerialQueue = currentSerialQueue;
+        currentSerialQueue = this;
+
+        for (size_t i = 0; i < kMaxSerialTasksPerDrain; i++) {
+            DispatchFunction task;
+            {
+                std::lock_guard<Mutex> lock(_mutex);
+                if (_tasks.empty() || _disposed) {
+                    _scheduled = false;
+                    currentSerialQueue = previousSerialQueue;
+                    return;
+                }
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            task();
+        }
+
+        currentSerialQueue = previousSerialQueue;
+
+        // Give a chance to the other tasks of the pool to run before continuing
+        scheduleDrain();
+    }
+};
+
+WorkerPoolDispatchQueue::WorkerPoolDispatchQueue(const StringBox& name, ThreadQoSClass qosClass, size_t workersCount)
+    : _pool(makeShared<WorkerPool>(name, qosClass, workersCount)) {}
+
+WorkerPoolDispatchQueue::~WorkerPoolDispatchQueue() {
+    _pool->dispose();
+}
+
+void WorkerPoolDispatchQueue::sync(const DispatchFunction& function) {
+    if (_pool->isCurrent()) {
+        // Waiting for the other tasks from a worker would deadlock
+        function();
+        return;
+    }
+
+    _pool->barrier([&]() {
+        _runningSync = true;
+        function();
+        _runningSync = false;
+    });
+}
+
+void WorkerPoolDispatchQueue::async(DispatchFunction function) {
+    _pool->submit(std::move(function), _pool->getQoSClass());
+}
+
+void WorkerPoolDispatchQueue::async(DispatchFunction function, ThreadQoSClass qosClass) {
+    _pool->submit(std::move(function), qosClass);
+}
+
+task_id_t WorkerPoolDispatchQueue::asyncAfter(DispatchFunction function, std::chrono::steady_clock::duration delay) {
+    return _pool->submitAfter(std::move(function), _pool->getQoSClass(), std::chrono::steady_clock::now() + delay);
+}
+
+void WorkerPoolDispatchQueue::cancel(task_id_t taskId) {
+    _pool->cancel(taskId);
+}
+
+bool WorkerPoolDispatchQueue::isCurrent() const {
+    return _pool->isCurrent();
+}
+
+void WorkerPoolDispatchQueue::fullTeardown() {
+    _pool->dispose();
+}
+
+void WorkerPoolDispatchQueue::setListener(const Shared<IQueueListener>& listener) {
+    _pool->setListener(listener);
+}
+
+Shared<IQueueListener> WorkerPoolDispatchQueue::getListener() const {
+    return _pool->getListener();
+}
+
+void WorkerPoolDispatchQueue::setQoSClass(ThreadQoSClass qosClass) {
+    _pool->setQoSClass(qosClass);
+}
+
+Ref<DispatchQueue> WorkerPoolDispatchQueue::createSerialQueue(ThreadQoSClass qosClass) {
+    return makeShared<SerialWorkerQueue>(_pool, qosClass);
+}
+
+size_t WorkerPoolDispatchQueue::getWorkersCount() const {
+    return _pool->getWorkersCount();
+}
+
+size_t WorkerPoolDispatchQueue::getDefaultWorkersCount() {
+    auto coresCount = static_cast<size_t>(std::thread::hardware_concurrency());
+    if (coresCount == 0) {
+        return 2;
+    }
+    return std::min(coresCount, kMaxDefaultWorkersCount);
+}
+
+} // namespace Valdi
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "valdi_core/cpp/Threading/DispatchQueue.hpp"
+
+namespace Valdi {
+
+class WorkerPool;
+
+/**
+ A DispatchQueue backed by a pool of worker threads, for background work which can run concurrently
+ like asset decoding or protobuf parsing.
+
+ Every worker owns one deque of tasks per ThreadQoSClass lane. Tasks enqueued from a worker go into
+ its own deque, tasks enqueued from other threads are distributed across the workers. A worker runs
+ the task from the highest QoS lane it can find, looking into its own deque first and stealing from
+ the other workers otherwise.
+
+ Tasks can run concurrently and in any order. sync() acts as a barrier: it waits until all the
+ previously enqueued tasks have completed, and no other task runs while its function is executing.
+ Callers which need their tasks to run in order can use a queue returned by createSerialQueue().
+ */
+class WorkerPoolDispatchQueue : public DispatchQueue {
+public:
+    WorkerPoolDispatchQueue(const StringBox& name, ThreadQoSClass qosClass, size_t workersCount);
+    ~WorkerPoolDispatchQueue() override;
+
+    void sync(const DispatchFunction& function) final;
+    void async(DispatchFunction function) final;
+    task_id_t asyncAfter(DispatchFunction function, std::chrono::steady_clock::duration delay) final;
+    void cancel(task_id_t taskId) final;
+
+    /**
+     Enqueue a task in the lane of the given QoS class instead of the one of the queue.
+     */
+    void async(DispatchFunction function, ThreadQoSClass qosClass);
+
+    /**
+     Returns whether the current thread is one of the workers of this pool.
+     */
+    bool isCurrent() const final;
+
+    void fullTeardown() final;
+
+    void setListener(const Shared<IQueueListener>& listener) final;
+
+    /**
+     Set the QoS class used by the workers and for the tasks enqueued through async().
+     */
+    void setQoSClass(ThreadQoSClass qosClass) final;
+
+    /**
+     Create a queue which runs its tasks one at a time and in order on this pool.
+     */
+    Ref<DispatchQueue> createSerialQueue(ThreadQoSClass qosClass);
+
+    size_t getWorkersCount() const;
+
+    // For Testing Only
+    Shared<IQueueListener> getListener() const final;
+
+    /**
+     Number of workers matching the number of cores of the device.
+     */
+    static size_t getDefaultWorkersCount();
+
+private:
+    Ref<WorkerPool> _pool;
+};
+
+} // namespace Valdi
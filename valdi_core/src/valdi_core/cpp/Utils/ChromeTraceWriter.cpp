@@ -0,0 +1,59 @@
+#include "valdi_core/cpp/Utils/ChromeTraceWriter.hpp"
+
+namespace Valdi {
+
+static constexpr int32_t kTraceProcessId = 1;
+
+static double toTraceMicroseconds(const TraceTimePoint::duration& duration) {
+    auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
+    return static_cast<double>(nanoseconds.count()) / 1000.0;
+}
+
+ChromeTraceWriter::ChromeTraceWriter(ByteBuffer& output) : _writer(output) {
+    _writer.writeBeginObject();
+    _writer.writeProperty("traceEvents");
+    _writer.writeBeginArray();
+}
+
+void ChromeTraceWriter::write(const RecordedTrace& trace) {
+    if (_hasEvents) {
+        _writer.writeComma();
+    }
+    _hasEvents = true;
+
+    _writer.writeBeginObject();
+    _writer.writeProperty("name");
+    _writer.writeString(trace.trace);
+    _writer.writeComma();
+    _writer.writeProperty("cat");
+    _writer.writeString("valdi");
+    _writer.writeComma();
+    _writer.writeProperty("ph");
+    _writer.writeString("X");
+    _writer.writeComma();
+    _writer.writeProperty("ts");
+    _writer.writeDouble(toTraceMicroseconds(trace.start.time_since_epoch()));
+    _writer.writeComma();
+    _writer.writeProperty("dur");
+    _writer.writeDouble(toTraceMicroseconds(trace.end - trace.start));
+    _writer.writeComma();
+    _writer.writeProperty("pid");
+    _writer.writeInt(kTraceProcessId);
+    _writer.writeComma();
+    _writer.writeProperty("tid");
+    _writer.writeInt(static_cast<int64_t>(trace.threadId));
+    _writer.writeEndObject();
+}
+
+void ChromeTraceWriter::write(const std::vector<RecordedTrace>& traces) {
+    for (const auto& trace : traces) {
+        write(trace);
+    }
+}
+
+void ChromeTraceWriter::finish() {
+    _writer.writeEndArray();
+    _writer.writeEndObject();
+}
+
+} // namespace Valdi
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "valdi_core/cpp/Utils/ByteBuffer.hpp"
+#include "valdi_core/cpp/Utils/JSONWriter.hpp"
+#include "valdi_core/cpp/Utils/Trace.hpp"
+
+#include <vector>
+
+namespace Valdi {
+
+/**
+ Streams recorded traces in the Chrome trace event JSON format, which can be
+ opened with Perfetto (ui.perfetto.dev) or chrome://tracing.
+ Each trace is written as a complete ("X") event, timestamps are in microseconds
+ since the epoch of the steady clock.
+ */
+class ChromeTraceWriter {
+public:
+    explicit ChromeTraceWriter(ByteBuffer& output);
+
+    void write(const RecordedTrace& trace);
+    void write(const std::vector<RecordedTrace>& traces);
+
+    /**
+     Closes the trace document. Nothing should be written afterwards.
+     */
+    void finish();
+
+private:
+    JSONWriter _writer;
+    bool _hasEvents = false;
+};
+
+} // namespace Valdi
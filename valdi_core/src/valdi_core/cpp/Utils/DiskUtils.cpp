@@ -11,8 +11,11 @@
 #include "valdi_core/cpp/Utils/Format.hpp"
 #include "valdi_core/cpp/Utils/StringCache.hpp"
 #include <cstdio>
+#include <atomic>
 #include <dirent.h>
+#include <fcntl.h>
 #include <fstream>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -168,6 +171,82 @@ Result<BytesView> DiskUtils::loadFromFd(int fd) {
     return bytes->toBytesView();
 }
 
+// Below this size, reading the file is cheaper than setting up a mapping
+constexpr size_t kMinMappedFileSize = 16 * 1024;
+
+class MemoryMappedFile : public SimpleRefCountable {
+public:
+    MemoryMappedFile(void* address, size_t size) : _address(address), _size(size) {}
+
+    ~MemoryMappedFile() override {
+        ::munmap(_address, _size);
+    }
+
+    const Byte* data() const {
+        return reinterpret_cast<const Byte*>(_address);
+    }
+
+private:
+    void* _address;
+    size_t _size;
+};
+
+static Error onLoadMappedError(const Path& path, const char* error) {
+    return Valdi::Error(STRING_FORMAT("Failed to map file at '{}': {}", path.toString(), error));
+}
+
+Result<BytesView> DiskUtils::loadMapped(const Path& path) {
+    auto pathStr = path.toString();
+    auto fd = ::open(pathStr.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return onLoadMappedError(path, strerror(errno));
+    }
+
+    auto stat = statFromFd(fd);
+    if (!stat.isFile()) {
+        ::close(fd);
+        return Error(STRING_FORMAT("No file at {}", pathStr));
+    }
+
+    if (stat.size() < kMinMappedFileSize) {
+        auto result = loadFromFd(fd);
+        ::close(fd);
+        return result;
+    }
+
+    auto* address = ::mmap(nullptr, stat.size(), PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+
+    if (address == MAP_FAILED) {
+        return onLoadMappedError(path, strerror(errno));
+    }
+
+    auto mappedFile = makeShared<MemoryMappedFile>(address, stat.size());
+    return BytesView(mappedFile, mappedFile->data(), stat.size());
+}
+
+Result<Void> DiskUtils::storeAtomically(const Path& path, const BytesView& bytes) {
+    static std::atomic<uint32_t> kTemporaryFileSequence = 0;
+
+    auto temporaryPath = path.toString();
+    temporaryPath += fmt::format(".{}.{}.tmp", ::getpid(), kTemporaryFileSequence++);
+
+    auto result = store(Path(temporaryPath), bytes);
+    if (!result) {
+        ::unlink(temporaryPath.c_str());
+        return result;
+    }
+
+    if (::rename(temporaryPath.c_str(), path.toString().c_str()) != 0) {
+        auto error = Error(STRING_FORMAT("Unable to move file to {}: {}", path.toString(), strerror(errno)));
+        ::unlink(temporaryPath.c_str());
+        return error;
+    }
+
+    return Void();
+}
+
 Result<Void> DiskUtils::store(const Path& path, const BytesView& bytes) {
     return store(path, bytes.asStringView());
 }
@@ -191,6 +270,25 @@ Result<Void> DiskUtils::store(const Path& path, std::string_view bytes) {
     return Void();
 }
 
+Result<Void> DiskUtils::append(const Path& path, const BytesView& bytes) {
+    auto pathStr = path.toString();
+    std::ofstream s;
+    s.open(pathStr, std::ios::app | std::ios::binary);
+    if (!s.is_open()) {
+        return Error(STRING_FORMAT("Unable to open file for appending at {}", pathStr));
+    }
+
+    s.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    auto success = s.good();
+    s.close();
+
+    if (!success) {
+        return Error(STRING_FORMAT("Unable to append to file at {}", pathStr));
+    }
+
+    return Void();
+}
+
 bool DiskUtils::makeDirectory(const Path& path, bool createIntermediates) {
     if (createIntermediates && path.getComponents().size() > 1) {
         auto parentPath = path.removingLastComponent();
@@ -78,10 +78,30 @@ public:
 
     static Result<BytesView> loadFromFd(int fd);
 
+    /**
+     Map the file at the given path into memory instead of reading it.
+     The mapping is released when the last BytesView referencing it is destroyed.
+     Pages are only read from disk when they are accessed, and can be reclaimed
+     by the kernel under memory pressure. Small files are read as with load().
+     */
+    static Result<BytesView> loadMapped(const Path& path);
+
     static Result<Void> store(const Path& path, const BytesView& bytes);
 
     static Result<Void> store(const Path& path, std::string_view bytes);
 
+    /**
+     Append the bytes at the end of the file at the given path, creating the file if needed.
+     */
+    static Result<Void> append(const Path& path, const BytesView& bytes);
+
+    /**
+     Store the bytes into a temporary file which is then renamed to the given path.
+     Readers never observe a partially written file, and existing memory mappings
+     of the previous file stay valid.
+     */
+    static Result<Void> storeAtomically(const Path& path, const BytesView& bytes);
+
     static bool remove(const Path& path);
 
     static bool makeDirectory(const Path& path, bool createIntermediates);
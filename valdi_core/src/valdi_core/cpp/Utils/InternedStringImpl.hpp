@@ -52,7 +52,8 @@ private:
     /**
      Returns a reference to this InternedStringImpl if the
      InternedStringImpl is alive and is not pending removal.
-     This should be called only with the StringCache mutex locked.
+     This can be called without the StringCache shard lock, as long
+     as the caller is registered as a reader of the shard.
     */
     Ref<InternedStringImpl> lock();
 
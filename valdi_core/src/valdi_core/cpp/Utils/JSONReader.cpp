@@ -7,38 +7,11 @@
 //
 
 #include "valdi_core/cpp/Utils/JSONReader.hpp"
+#include "valdi_core/cpp/Utils/JSONTokenizer.hpp"
 #include <fmt/format.h>
 
 namespace Valdi {
 
-static inline std::string codePointToUTF8(unsigned int cp) {
-    std::string result;
-
-    // based on description from http://en.wikipedia.org/wiki/UTF-8
-
-    if (cp <= 0x7f) {
-        result.resize(1);
-        result[0] = static_cast<char>(cp);
-    } else if (cp <= 0x7FF) {
-        result.resize(2);
-        result[1] = static_cast<char>(0x80 | (0x3f & cp));
-        result[0] = static_cast<char>(0xC0 | (0x1f & (cp >> 6)));
-    } else if (cp <= 0xFFFF) {
-        result.resize(3);
-        result[2] = static_cast<char>(0x80 | (0x3f & cp));
-        result[1] = static_cast<char>(0x80 | (0x3f & (cp >> 6)));
-        result[0] = static_cast<char>(0xE0 | (0xf & (cp >> 12)));
-    } else if (cp <= 0x10FFFF) {
-        result.resize(4);
-        result[3] = static_cast<char>(0x80 | (0x3f & cp));
-        result[2] = static_cast<char>(0x80 | (0x3f & (cp >> 6)));
-        result[1] = static_cast<char>(0x80 | (0x3f & (cp >> 12)));
-        result[0] = static_cast<char>(0xF0 | (0x7 & (cp >> 18)));
-    }
-
-    return result;
-}
-
 JSONReader::JSONReader(std::string_view input) : _parser(input) {}
 
 bool JSONReader::hasError() const {
@@ -203,109 +176,11 @@ bool JSONReader::parseString(std::string& output) {
 }
 
 bool JSONReader::decodeString(std::string_view str, std::string& decoded) {
-    decoded.reserve(str.size());
-    const auto* current = str.data();
-    const auto* end = str.data() + str.size();
-    while (current != end) {
-        auto c = *current++;
-        if (c == '"')
-            break;
-        if (c == '\\') {
-            if (current == end) {
-                setErrorAtCurrentPosition("Empty escape sequence in string");
-                return false;
-            }
-            auto escape = *current++;
-            switch (escape) {
-                case '"':
-                    decoded += '"';
-                    break;
-                case '/':
-                    decoded += '/';
-                    break;
-                case '\\':
-                    decoded += '\\';
-                    break;
-                case 'b':
-                    decoded += '\b';
-                    break;
-                case 'f':
-                    decoded += '\f';
-                    break;
-                case 'n':
-                    decoded += '\n';
-                    break;
-                case 'r':
-                    decoded += '\r';
-                    break;
-                case 't':
-                    decoded += '\t';
-                    break;
-                case 'u': {
-                    unsigned int unicode;
-                    if (!decodeUnicodeCodePoint(current, end, unicode))
-                        return false;
-                    decoded += codePointToUTF8(unicode);
-                } break;
-                default:
-                    setErrorAtCurrentPosition("Bad escape sequence in string");
-                    return false;
-            }
-        } else {
-            decoded += c;
-        }
-    }
-    return true;
-}
-
-// Taken from the jsoncpp library
-bool JSONReader::decodeUnicodeCodePoint(const char*& current, const char* end, unsigned int& unicode) {
-    if (!decodeUnicodeEscapeSequence(current, end, unicode))
-        return false;
-    if (unicode >= 0xD800 && unicode <= 0xDBFF) {
-        // surrogate pairs
-        if (end - current < 6) {
-            setErrorAtCurrentPosition("additional six characters expected to parse unicode surrogate pair.");
-            return false;
-        }
-        if (*(current++) == '\\' && *(current++) == 'u') {
-            unsigned int surrogatePair;
-            if (decodeUnicodeEscapeSequence(current, end, surrogatePair)) {
-                unicode = 0x10000 + ((unicode & 0x3FF) << 10) + (surrogatePair & 0x3FF);
-            } else {
-                return false;
-            }
-        } else {
-            setErrorAtCurrentPosition(
-                "expecting another \\u token to begin the second half of a unicode surrogate pair");
-            return false;
-        }
-    }
-    return true;
-}
-
-// Taken from the jsoncpp library
-bool JSONReader::decodeUnicodeEscapeSequence(const char*& current, const char* end, unsigned int& retUnicode) {
-    if (end - current < 4) {
-        setErrorAtCurrentPosition("Bad unicode escape sequence in string: four digits expected.");
+    auto error = JSONTokenizer::decodeString(str, decoded);
+    if (error) {
+        setErrorAtCurrentPosition(error.value());
         return false;
     }
-    int unicode = 0;
-    for (int index = 0; index < 4; index++) {
-        auto c = *current++;
-        unicode *= 16;
-        if (c >= '0' && c <= '9') {
-            unicode += c - '0';
-        } else if (c >= 'a' && c <= 'f') {
-            unicode += c - 'a' + 10;
-        } else if (c >= 'A' && c <= 'F') {
-            unicode += c - 'A' + 10;
-        } else {
-            setErrorAtCurrentPosition("Bad unicode escape sequence in string: hexadecimal digit expected.");
-            return false;
-        }
-    }
-    retUnicode = static_cast<unsigned int>(unicode);
     return true;
 }
 
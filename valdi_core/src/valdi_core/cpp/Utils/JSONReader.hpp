@@ -74,8 +74,6 @@ private:
     bool parseToken(std::string_view token);
 
     bool decodeString(std::string_view str, std::string& decoded);
-    bool decodeUnicodeCodePoint(const char*& current, const char* end, unsigned int& unicode);
-    bool decodeUnicodeEscapeSequence(const char*& current, const char* end, unsigned int& retUnicode);
 };
 
 } // namespace Valdi
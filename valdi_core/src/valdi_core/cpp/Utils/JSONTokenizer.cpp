@@ -0,0 +1,725 @@
+#include "valdi_core/cpp/Utils/JSONTokenizer.hpp"
+#include "utils/debugging/Assert.hpp"
+#include "valdi_core/cpp/Constants.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fmt/format.h>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define VALDI_JSON_SSE2_SCANNER 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define VALDI_JSON_NEON_SCANNER 1
+#include <arm_neon.h>
+#endif
+
+namespace Valdi {
+
+constexpr size_t kBlockSize = 64;
+// Number of bytes scanned at once by the first stage. Keeps the structural indexes
+// small and cache resident regardless of the size of the chunks.
+constexpr size_t kScanWindowSize = 16 * 1024;
+
+static_assert(kScanWindowSize % kBlockSize == 0);
+
+static inline bool isJSONOperator(char c) {
+    return c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+}
+
+static inline bool isJSONWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+namespace {
+
+struct BlockMasks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t op;
+    uint64_t whitespace;
+};
+
+} // namespace
+
+#if VALDI_JSON_SSE2_SCANNER
+
+static inline uint64_t toBlockMask(__m128i v0, __m128i v1, __m128i v2, __m128i v3) {
+    auto m0 = static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(v0)));
+    auto m1 = static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(v1)));
+    auto m2 = static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(v2)));
+    auto m3 = static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(v3)));
+    return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+}
+
+static inline BlockMasks classifyBlock(const char* data) {
+    __m128i v[4];
+    for (size_t i = 0; i < 4; i++) {
+        v[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16));
+    }
+
+    const auto quote = _mm_set1_epi8('"');
+    const auto backslash = _mm_set1_epi8('\\');
+    const auto caseBit = _mm_set1_epi8(0x20);
+    // '[' and ']' only differ from '{' and '}' by the 0x20 bit
+    const auto openBrace = _mm_set1_epi8('{');
+    const auto closeBrace = _mm_set1_epi8('}');
+    const auto colon = _mm_set1_epi8(':');
+    const auto comma = _mm_set1_epi8(',');
+    const auto space = _mm_set1_epi8(' ');
+    const auto tab = _mm_set1_epi8('\t');
+    const auto newLine = _mm_set1_epi8('\n');
+    const auto carriageReturn = _mm_set1_epi8('\r');
+
+    __m128i quotes[4];
+    __m128i backslashes[4];
+    __m128i ops[4];
+    __m128i whitespaces[4];
+    for (size_t i = 0; i < 4; i++) {
+        auto lowered = _mm_or_si128(v[i], caseBit);
+        quotes[i] = _mm_cmpeq_epi8(v[i], quote);
+        backslashes[i] = _mm_cmpeq_epi8(v[i], backslash);
+        ops[i] = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(lowered, openBrace), _mm_cmpeq_epi8(lowered, closeBrace)),
+                              _mm_or_si128(_mm_cmpeq_epi8(v[i], colon), _mm_cmpeq_epi8(v[i], comma)));
+        whitespaces[i] =
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v[i], space), _mm_cmpeq_epi8(v[i], tab)),
+                         _mm_or_si128(_mm_cmpeq_epi8(v[i], newLine), _mm_cmpeq_epi8(v[i], carriageReturn)));
+    }
+
+    BlockMasks masks;
+    masks.quote = toBlockMask(quotes[0], quotes[1], quotes[2], quotes[3]);
+    masks.backslash = toBlockMask(backslashes[0], backslashes[1], backslashes[2], backslashes[3]);
+    masks.op = toBlockMask(ops[0], ops[1], ops[2], ops[3]);
+    masks.whitespace = toBlockMask(whitespaces[0], whitespaces[1], whitespaces[2], whitespaces[3]);
+    return masks;
+}
+
+#elif VALDI_JSON_NEON_SCANNER
+
+static inline uint64_t toBlockMask(uint8x16_t v0, uint8x16_t v1, uint8x16_t v2, uint8x16_t v3) {
+    const uint8x16_t bitMask = {
+        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
+    auto sum0 = vpaddq_u8(vandq_u8(v0, bitMask), vandq_u8(v1, bitMask));
+    auto sum1 = vpaddq_u8(vandq_u8(v2, bitMask), vandq_u8(v3, bitMask));
+    sum0 = vpaddq_u8(sum0, sum1);
+    sum0 = vpaddq_u8(sum0, sum0);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+}
+
+static inline BlockMasks classifyBlock(const char* data) {
+    uint8x16_t v[4];
+    for (size_t i = 0; i < 4; i++) {
+        v[i] = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i * 16));
+    }
+
+    const auto caseBit = vdupq_n_u8(0x20);
+
+    uint8x16_t quotes[4];
+    uint8x16_t backslashes[4];
+    uint8x16_t ops[4];
+    uint8x16_t whitespaces[4];
+    for (size_t i = 0; i < 4; i++) {
+        // '[' and ']' only differ from '{' and '}' by the 0x20 bit
+        auto lowered = vorrq_u8(v[i], caseBit);
+        quotes[i] = vceqq_u8(v[i], vdupq_n_u8('"'));
+        backslashes[i] = vceqq_u8(v[i], vdupq_n_u8('\\'));
+        ops[i] = vorrq_u8(vorrq_u8(vceqq_u8(lowered, vdupq_n_u8('{')), vceqq_u8(lowered, vdupq_n_u8('}'))),
+                          vorrq_u8(vceqq_u8(v[i], vdupq_n_u8(':')), vceqq_u8(v[i], vdupq_n_u8(','))));
+        whitespaces[i] = vorrq_u8(vorrq_u8(vceqq_u8(v[i], vdupq_n_u8(' ')), vceqq_u8(v[i], vdupq_n_u8('\t'))),
+                                  vorrq_u8(vceqq_u8(v[i], vdupq_n_u8('\n')), vceqq_u8(v[i], vdupq_n_u8('\r'))));
+    }
+
+    BlockMasks masks;
+    masks.quote = toBlockMask(quotes[0], quotes[1], quotes[2], quotes[3]);
+    masks.backslash = toBlockMask(backslashes[0], backslashes[1], backslashes[2], backslashes[3]);
+    masks.op = toBlockMask(ops[0], ops[1], ops[2], ops[3]);
+    masks.whitespace = toBlockMask(whitespaces[0], whitespaces[1], whitespaces[2], whitespaces[3]);
+    return masks;
+}
+
+#else
+
+static inline BlockMasks classifyBlock(const char* data) {
+    BlockMasks masks = {0, 0, 0, 0};
+    for (size_t i = 0; i < kBlockSize; i++) {
+        auto c = data[i];
+        auto bit = static_cast<uint64_t>(1) << i;
+        if (c == '"') {
+            masks.quote |= bit;
+        } else if (c == '\\') {
+            masks.backslash |= bit;
+        } else if (isJSONOperator(c)) {
+            masks.op |= bit;
+        } else if (isJSONWhitespace(c)) {
+            masks.whitespace |= bit;
+        }
+    }
+    return masks;
+}
+
+#endif
+
+/**
+ Returns the mask of characters which are escaped by a preceding odd sequence of backslashes.
+ prevEscaped is 1 if the first character of the block is escaped, and is updated for the next block.
+ */
+static inline uint64_t findEscaped(uint64_t backslash, uint64_t& prevEscaped) {
+    constexpr uint64_t kEvenBits = 0x5555555555555555ULL;
+
+    backslash &= ~prevEscaped;
+    auto followsEscape = (backslash << 1) | prevEscaped;
+    auto oddSequenceStarts = backslash & ~kEvenBits & ~followsEscape;
+    uint64_t sequencesStartingOnEvenBits;
+    prevEscaped = __builtin_add_overflow(oddSequenceStarts, backslash, &sequencesStartingOnEvenBits) ? 1 : 0;
+    auto invertMask = sequencesStartingOnEvenBits << 1;
+
+    return (kEvenBits ^ invertMask) & followsEscape;
+}
+
+/**
+ Returns a mask where each bit is the xor of all the bits up to and including
+ that bit, which turns a mask of quotes into a mask of string contents.
+ */
+static inline uint64_t prefixXor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+static bool isValidNumber(std::string_view str) {
+    const auto* it = str.data();
+    const auto* end = it + str.size();
+
+    auto parseDigits = [&]() {
+        const auto* start = it;
+        while (it != end && *it >= '0' && *it <= '9') {
+            it++;
+        }
+        return it != start;
+    };
+
+    if (it != end && *it == '-') {
+        it++;
+    }
+    if (it != end && *it == '0') {
+        it++;
+    } else if (!parseDigits()) {
+        return false;
+    }
+    if (it != end && *it == '.') {
+        it++;
+        if (!parseDigits()) {
+            return false;
+        }
+    }
+    if (it != end && (*it == 'e' || *it == 'E')) {
+        it++;
+        if (it != end && (*it == '+' || *it == '-')) {
+            it++;
+        }
+        if (!parseDigits()) {
+            return false;
+        }
+    }
+
+    return it == end;
+}
+
+static void appendCodePointAsUTF8(unsigned int cp, std::string& output) {
+    // based on description from http://en.wikipedia.org/wiki/UTF-8
+
+    if (cp <= 0x7f) {
+        output += static_cast<char>(cp);
+    } else if (cp <= 0x7FF) {
+        output += static_cast<char>(0xC0 | (0x1f & (cp >> 6)));
+        output += static_cast<char>(0x80 | (0x3f & cp));
+    } else if (cp <= 0xFFFF) {
+        output += static_cast<char>(0xE0 | (0xf & (cp >> 12)));
+        output += static_cast<char>(0x80 | (0x3f & (cp >> 6)));
+        output += static_cast<char>(0x80 | (0x3f & cp));
+    } else if (cp <= 0x10FFFF) {
+        output += static_cast<char>(0xF0 | (0x7 & (cp >> 18)));
+        output += static_cast<char>(0x80 | (0x3f & (cp >> 12)));
+        output += static_cast<char>(0x80 | (0x3f & (cp >> 6)));
+        output += static_cast<char>(0x80 | (0x3f & cp));
+    }
+}
+
+// Taken from the jsoncpp library
+static std::optional<std::string_view> decodeUnicodeEscapeSequence(const char*& current,
+                                                                   const char* end,
+                                                                   unsigned int& retUnicode) {
+    if (end - current < 4) {
+        return "Bad unicode escape sequence in string: four digits expected.";
+    }
+    int unicode = 0;
+    for (int index = 0; index < 4; index++) {
+        auto c = *current++;
+        unicode *= 16;
+        if (c >= '0' && c <= '9') {
+            unicode += c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            unicode += c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            unicode += c - 'A' + 10;
+        } else {
+            return "Bad unicode escape sequence in string: hexadecimal digit expected.";
+        }
+    }
+    retUnicode = static_cast<unsigned int>(unicode);
+    return std::nullopt;
+}
+
+// Taken from the jsoncpp library
+static std::optional<std::string_view> decodeUnicodeCodePoint(const char*& current,
+                                                              const char* end,
+                                                              unsigned int& unicode) {
+    auto error = decodeUnicodeEscapeSequence(current, end, unicode);
+    if (error) {
+        return error;
+    }
+    if (unicode >= 0xD800 && unicode <= 0xDBFF) {
+        // surrogate pairs
+        if (end - current < 6) {
+            return "additional six characters expected to parse unicode surrogate pair.";
+        }
+        if (*(current++) == '\\' && *(current++) == 'u') {
+            unsigned int surrogatePair;
+            error = decodeUnicodeEscapeSequence(current, end, surrogatePair);
+            if (error) {
+                return error;
+            }
+            unicode = 0x10000 + ((unicode & 0x3FF) << 10) + (surrogatePair & 0x3FF);
+        } else {
+            return "expecting another \\u token to begin the second half of a unicode surrogate pair";
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string_view> JSONTokenizer::decodeString(std::string_view str, std::string& output) {
+    output.reserve(output.size() + str.size());
+    const auto* current = str.data();
+    const auto* end = str.data() + str.size();
+    while (current != end) {
+        const auto* escapeStart = static_cast<const char*>(std::memchr(current, '\\', end - current));
+        if (escapeStart == nullptr) {
+            output.append(current, end);
+            break;
+        }
+        output.append(current, escapeStart);
+        current = escapeStart + 1;
+
+        if (current == end) {
+            return "Empty escape sequence in string";
+        }
+        auto escape = *current++;
+        switch (escape) {
+            case '"':
+                output += '"';
+                break;
+            case '/':
+                output += '/';
+                break;
+            case '\\':
+                output += '\\';
+                break;
+            case 'b':
+                output += '\b';
+                break;
+            case 'f':
+                output += '\f';
+                break;
+            case 'n':
+                output += '\n';
+                break;
+            case 'r':
+                output += '\r';
+                break;
+            case 't':
+                output += '\t';
+                break;
+            case 'u': {
+                unsigned int unicode;
+                auto error = decodeUnicodeCodePoint(current, end, unicode);
+                if (error) {
+                    return error;
+                }
+                appendCodePointAsUTF8(unicode, output);
+            } break;
+            default:
+                return "Bad escape sequence in string";
+        }
+    }
+    return std::nullopt;
+}
+
+JSONTokenizer::JSONTokenizer() = default;
+
+JSONTokenizer::JSONTokenizer(std::string_view input) {
+    feed(input);
+    finish();
+}
+
+JSONTokenizer::~JSONTokenizer() = default;
+
+void JSONTokenizer::feed(std::string_view chunk) {
+    SC_ASSERT(!_finished);
+    SC_ASSERT(_scanPosition == _chunk.size() && _structuralIndex == _structuralsCount);
+
+    _chunkOffset += _chunk.size();
+    _chunk = chunk;
+    _scanPosition = 0;
+    _windowStart = 0;
+    _structuralsCount = 0;
+    _structuralIndex = 0;
+}
+
+void JSONTokenizer::finish() {
+    _finished = true;
+}
+
+bool JSONTokenizer::hasError() const {
+    return _error.has_value();
+}
+
+Error JSONTokenizer::getError() const {
+    SC_ASSERT(hasError());
+    return _error.value();
+}
+
+void JSONTokenizer::setErrorAtCurrentPosition(std::string_view errorMessage) {
+    if (!_error) {
+        _error = Error(STRING_FORMAT("{} at position {}", errorMessage, _position));
+    }
+}
+
+size_t JSONTokenizer::position() const {
+    return _position;
+}
+
+void JSONTokenizer::releaseChunk() {
+    _chunkOffset += _chunk.size();
+    _position = _chunkOffset;
+    _chunk = std::string_view();
+    _scanPosition = 0;
+    _windowStart = 0;
+    _structuralsCount = 0;
+    _structuralIndex = 0;
+}
+
+void JSONTokenizer::scanWindow() {
+    _structuralsCount = 0;
+    _structuralIndex = 0;
+    _windowStart = _scanPosition;
+
+    auto windowSize = std::min(_chunk.size() - _scanPosition, kScanWindowSize);
+    if (_structurals.size() < windowSize) {
+        // Each character is at most one structural
+        _structurals.resize(windowSize);
+    }
+    auto blocksSize = windowSize - (windowSize % kBlockSize);
+    const auto* data = _chunk.data() + _scanPosition;
+
+    scanBlocks(data, blocksSize, 0);
+    if (blocksSize != windowSize) {
+        // Trailing bytes of the chunk which don't fill a whole block
+        scanRemainder(data + blocksSize, windowSize - blocksSize, static_cast<uint32_t>(blocksSize));
+    }
+
+    _scanPosition += windowSize;
+}
+
+void JSONTokenizer::scanBlocks(const char* data, size_t length, uint32_t windowOffset) {
+    for (size_t offset = 0; offset < length; offset += kBlockSize) {
+        auto masks = classifyBlock(data + offset);
+
+        auto escaped = findEscaped(masks.backslash, _prevEscaped);
+        auto quote = masks.quote & ~escaped;
+        // Includes the opening quote of each string, but not the closing one
+        auto inString = prefixXor(quote) ^ _prevInString;
+        _prevInString = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+
+        auto scalar = ~(masks.op | masks.whitespace | quote | inString);
+        auto followsScalar = (scalar << 1) | _prevScalar;
+        _prevScalar = scalar >> 63;
+
+        auto structurals = (masks.op & ~inString) | quote | (scalar & ~followsScalar);
+
+        auto base = windowOffset + static_cast<uint32_t>(offset);
+        auto* output = _structurals.data() + _structuralsCount;
+        _structuralsCount += static_cast<size_t>(__builtin_popcountll(structurals));
+        while (structurals != 0) {
+            *output++ = base + static_cast<uint32_t>(__builtin_ctzll(structurals));
+            structurals &= structurals - 1;
+        }
+    }
+}
+
+void JSONTokenizer::scanRemainder(const char* data, size_t length, uint32_t windowOffset) {
+    // Same logic as scanBlocks(), one character at a time
+    auto inString = _prevInString != 0;
+    auto escaped = _prevEscaped != 0;
+    auto inScalar = _prevScalar != 0;
+
+    for (size_t i = 0; i < length; i++) {
+        auto c = data[i];
+        auto isEscaped = escaped;
+        escaped = c == '\\' && !isEscaped;
+
+        auto isQuote = c == '"' && !isEscaped;
+        if (isQuote) {
+            inString = !inString;
+        }
+
+        auto isOp = isJSONOperator(c);
+        auto isScalar = !isOp && !isJSONWhitespace(c) && !isQuote && !inString;
+
+        if ((isOp && !inString) || isQuote || (isScalar && !inScalar)) {
+            _structurals[_structuralsCount++] = windowOffset + static_cast<uint32_t>(i);
+        }
+        inScalar = isScalar;
+    }
+
+    _prevInString = inString ? ~static_cast<uint64_t>(0) : 0;
+    _prevEscaped = escaped ? 1 : 0;
+    _prevScalar = inScalar ? 1 : 0;
+}
+
+bool JSONTokenizer::nextStructural(size_t& index) {
+    while (_structuralIndex == _structuralsCount) {
+        if (_scanPosition == _chunk.size()) {
+            return false;
+        }
+        scanWindow();
+    }
+
+    index = _windowStart + _structurals[_structuralIndex++];
+    return true;
+}
+
+size_t JSONTokenizer::findScalarEnd(size_t startIndex) {
+    // A scalar is followed by optional whitespaces and then by the next structural character
+    while (_structuralIndex == _structuralsCount && _scanPosition != _chunk.size()) {
+        scanWindow();
+    }
+
+    auto endIndex =
+        _structuralIndex < _structuralsCount ? _windowStart + _structurals[_structuralIndex] : _chunk.size();
+    while (endIndex > startIndex && isJSONWhitespace(_chunk[endIndex - 1])) {
+        endIndex--;
+    }
+    return endIndex;
+}
+
+JSONTokenizer::Token JSONTokenizer::makeToken(TokenType type, std::string_view value, size_t endIndex) {
+    _position = _chunkOffset + endIndex;
+    return Token{type, value};
+}
+
+JSONTokenizer::Token JSONTokenizer::makeError(std::string_view errorMessage, size_t position) {
+    _position = position;
+    setErrorAtCurrentPosition(errorMessage);
+    return Token{TokenType::Error, std::string_view()};
+}
+
+JSONTokenizer::Token JSONTokenizer::makeNeedsInput() {
+    // The partial token was copied, the chunk can be released
+    releaseChunk();
+    return Token{TokenType::NeedsInput, std::string_view()};
+}
+
+JSONTokenizer::Token JSONTokenizer::next() {
+    if (VALDI_UNLIKELY(_error)) {
+        return Token{TokenType::Error, std::string_view()};
+    }
+
+    if (VALDI_UNLIKELY(_pendingToken != PendingToken::None)) {
+        return continuePendingToken();
+    }
+
+    size_t index;
+    if (!nextStructural(index)) {
+        _position = _chunkOffset + _chunk.size();
+        return Token{_finished ? TokenType::End : TokenType::NeedsInput, std::string_view()};
+    }
+
+    switch (_chunk[index]) {
+        case '{':
+            return makeToken(TokenType::BeginObject, _chunk.substr(index, 1), index + 1);
+        case '}':
+            return makeToken(TokenType::EndObject, _chunk.substr(index, 1), index + 1);
+        case '[':
+            return makeToken(TokenType::BeginArray, _chunk.substr(index, 1), index + 1);
+        case ']':
+            return makeToken(TokenType::EndArray, _chunk.substr(index, 1), index + 1);
+        case ':':
+            return makeToken(TokenType::Colon, _chunk.substr(index, 1), index + 1);
+        case ',':
+            return makeToken(TokenType::Comma, _chunk.substr(index, 1), index + 1);
+        case '"':
+            return parseString(index);
+        default:
+            return parseScalar(index);
+    }
+}
+
+bool JSONTokenizer::parseUIntArray(std::vector<uint32_t>& output) {
+    SC_ASSERT(_finished);
+    if (_error || _pendingToken != PendingToken::None) {
+        return false;
+    }
+
+    size_t index;
+    if (!nextStructural(index)) {
+        makeError("Unexpected end of input", _chunkOffset + _chunk.size());
+        return false;
+    }
+    if (_chunk[index] == ']') {
+        _position = _chunkOffset + index + 1;
+        return true;
+    }
+
+    const auto* begin = _chunk.data();
+    const auto* end = begin + _chunk.size();
+
+    for (;;) {
+        const auto* digitsStart = begin + index;
+        const auto* it = digitsStart;
+        uint64_t value = 0;
+        while (it != end && *it >= '0' && *it <= '9') {
+            value = value * 10 + static_cast<uint64_t>(*it - '0');
+            if (value > std::numeric_limits<uint32_t>::max()) {
+                makeError("Integer out of range", _chunkOffset + index);
+                return false;
+            }
+            it++;
+        }
+        auto digitsCount = static_cast<size_t>(it - digitsStart);
+        while (it != end && isJSONWhitespace(*it)) {
+            it++;
+        }
+
+        // The integer must be directly followed by the next structural character
+        size_t separatorIndex;
+        if (digitsCount == 0 || (digitsCount > 1 && *digitsStart == '0') || !nextStructural(separatorIndex) ||
+            begin + separatorIndex != it) {
+            makeError("Expected unsigned integer", _chunkOffset + index);
+            return false;
+        }
+
+        output.emplace_back(static_cast<uint32_t>(value));
+
+        if (_chunk[separatorIndex] == ']') {
+            _position = _chunkOffset + separatorIndex + 1;
+            return true;
+        }
+        if (_chunk[separatorIndex] != ',' || !nextStructural(index)) {
+            makeError("Expected ',' or ']'", _chunkOffset + separatorIndex);
+            return false;
+        }
+    }
+}
+
+JSONTokenizer::Token JSONTokenizer::parseString(size_t openingQuoteIndex) {
+    size_t closingQuoteIndex;
+    if (!nextStructural(closingQuoteIndex)) {
+        if (_finished) {
+            return makeError("Unterminated string", _chunkOffset + openingQuoteIndex);
+        }
+        _pendingToken = PendingToken::String;
+        _pendingBuffer.assign(_chunk.substr(openingQuoteIndex + 1));
+        return makeNeedsInput();
+    }
+
+    return completeString(_chunk.substr(openingQuoteIndex + 1, closingQuoteIndex - openingQuoteIndex - 1),
+                          closingQuoteIndex + 1);
+}
+
+JSONTokenizer::Token JSONTokenizer::parseScalar(size_t startIndex) {
+    auto endIndex = findScalarEnd(startIndex);
+    if (endIndex == _chunk.size() && !_finished) {
+        // The scalar might continue in the next chunk
+        _pendingToken = PendingToken::Scalar;
+        _pendingBuffer.assign(_chunk.substr(startIndex));
+        return makeNeedsInput();
+    }
+
+    return completeScalar(_chunk.substr(startIndex, endIndex - startIndex), endIndex);
+}
+
+JSONTokenizer::Token JSONTokenizer::continuePendingToken() {
+    if (_pendingToken == PendingToken::String) {
+        size_t closingQuoteIndex;
+        if (!nextStructural(closingQuoteIndex)) {
+            if (_finished) {
+                _pendingToken = PendingToken::None;
+                return makeError("Unterminated string", _chunkOffset + _chunk.size());
+            }
+            _pendingBuffer.append(_chunk);
+            return makeNeedsInput();
+        }
+
+        _pendingToken = PendingToken::None;
+        _pendingBuffer.append(_chunk.substr(0, closingQuoteIndex));
+        return completeString(_pendingBuffer, closingQuoteIndex + 1);
+    } else {
+        auto endIndex = findScalarEnd(0);
+        _pendingBuffer.append(_chunk.substr(0, endIndex));
+        if (endIndex == _chunk.size() && !_finished) {
+            return makeNeedsInput();
+        }
+
+        _pendingToken = PendingToken::None;
+        return completeScalar(_pendingBuffer, endIndex);
+    }
+}
+
+JSONTokenizer::Token JSONTokenizer::completeString(std::string_view rawString, size_t endIndex) {
+    if (std::memchr(rawString.data(), '\\', rawString.size()) == nullptr) {
+        return makeToken(TokenType::String, rawString, endIndex);
+    }
+
+    _decodedString.clear();
+    auto error = decodeString(rawString, _decodedString);
+    if (error) {
+        return makeError(error.value(), _chunkOffset + endIndex);
+    }
+
+    return makeToken(TokenType::String, _decodedString, endIndex);
+}
+
+JSONTokenizer::Token JSONTokenizer::completeScalar(std::string_view scalar, size_t endIndex) {
+    switch (scalar[0]) {
+        case 't':
+            if (scalar == "true") {
+                return makeToken(TokenType::True, scalar, endIndex);
+            }
+            break;
+        case 'f':
+            if (scalar == "false") {
+                return makeToken(TokenType::False, scalar, endIndex);
+            }
+            break;
+        case 'n':
+            if (scalar == "null") {
+                return makeToken(TokenType::Null, scalar, endIndex);
+            }
+            break;
+        default:
+            if (isValidNumber(scalar)) {
+                return makeToken(TokenType::Number, scalar, endIndex);
+            }
+            break;
+    }
+
+    return makeError(STRING_FORMAT("Invalid token '{}'", scalar).toStringView(),
+                     _chunkOffset + endIndex - scalar.size());
+}
+
+} // namespace Valdi
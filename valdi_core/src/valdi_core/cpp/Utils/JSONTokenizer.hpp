@@ -0,0 +1,160 @@
+#pragma once
+
+#include "valdi_core/cpp/Utils/Error.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Valdi {
+
+/**
+ A streaming JSON tokenizer, which can be used as an alternative to the JSONReader
+ when parsing large inputs.
+
+ The input is scanned in two stages, in the same spirit as simdjson: the first stage
+ finds the position of every structural character, string boundary and scalar start
+ 64 bytes at a time using SIMD instructions, the second stage walks those positions
+ to emit tokens. Strings without escape sequences are returned as views into the
+ input, so tokenizing does not allocate in the common case.
+
+ The input can be provided in chunks through feed(). When a token spans two chunks,
+ next() returns a NeedsInput token, the tokenizer keeps the partial token and completes
+ it once the next chunk is provided. This allows parsing documents which are never
+ fully resident in memory.
+ */
+class JSONTokenizer {
+public:
+    enum class TokenType : uint8_t {
+        BeginObject,
+        EndObject,
+        BeginArray,
+        EndArray,
+        Colon,
+        Comma,
+        String,
+        Number,
+        True,
+        False,
+        Null,
+        /**
+         The current chunk was fully consumed, feed() or finish() should be called.
+         */
+        NeedsInput,
+        /**
+         finish() was called and all the tokens were consumed.
+         */
+        End,
+        Error,
+    };
+
+    struct Token {
+        TokenType type = TokenType::Error;
+        /**
+         The text of the token. For strings, this is the decoded string without the quotes.
+         The view remains valid until the next call to next() or feed().
+         */
+        std::string_view value;
+    };
+
+    JSONTokenizer();
+
+    /**
+     Create a tokenizer for a complete JSON document.
+     */
+    explicit JSONTokenizer(std::string_view input);
+
+    ~JSONTokenizer();
+
+    /**
+     Provide the next chunk of input. The previous chunk must have been fully consumed,
+     which is the case once next() returned NeedsInput. The chunk must remain valid until
+     the next call to feed() or until the tokenizer is destroyed.
+     */
+    void feed(std::string_view chunk);
+
+    /**
+     Notify the tokenizer that no more input will be provided.
+     */
+    void finish();
+
+    /**
+     Return the next token. Whitespaces are skipped. The tokenizer only validates the
+     syntax of the individual tokens, the caller is responsible for validating the
+     structure of the document.
+     */
+    Token next();
+
+    /**
+     Parse the elements and the closing bracket of an array made only of unsigned 32 bits integers,
+     after its BeginArray token was returned, and append them to the output. Digits are converted
+     while they are validated, which is much faster than calling next() for each element of large
+     numeric arrays. Only supported once finish() was called, since elements are not carried over
+     across chunks. Returns false and sets an error if the array contains anything else.
+     */
+    bool parseUIntArray(std::vector<uint32_t>& output);
+
+    bool hasError() const;
+    Error getError() const;
+    void setErrorAtCurrentPosition(std::string_view errorMessage);
+
+    /**
+     Return the position within the whole input right after the last returned token.
+     */
+    size_t position() const;
+
+    /**
+     Decode a JSON string body, without the enclosing quotes, into the given output.
+     Returns a null optional on success, or an error message otherwise.
+     */
+    static std::optional<std::string_view> decodeString(std::string_view str, std::string& output);
+
+private:
+    enum class PendingToken : uint8_t {
+        None,
+        String,
+        Scalar,
+    };
+
+    std::string_view _chunk;
+    size_t _chunkOffset = 0;
+    size_t _position = 0;
+    size_t _scanPosition = 0;
+    size_t _windowStart = 0;
+    bool _finished = false;
+
+    // Stage 1: structural indexes of the scanned window
+    std::vector<uint32_t> _structurals;
+    size_t _structuralsCount = 0;
+    size_t _structuralIndex = 0;
+    uint64_t _prevInString = 0;
+    uint64_t _prevEscaped = 0;
+    uint64_t _prevScalar = 0;
+
+    // Stage 2: partial token carried over across chunks
+    PendingToken _pendingToken = PendingToken::None;
+    std::string _pendingBuffer;
+    std::string _decodedString;
+
+    std::optional<Error> _error;
+
+    bool nextStructural(size_t& index);
+    void scanWindow();
+    void scanBlocks(const char* data, size_t length, uint32_t windowOffset);
+    void scanRemainder(const char* data, size_t length, uint32_t windowOffset);
+    size_t findScalarEnd(size_t startIndex);
+    void releaseChunk();
+
+    Token makeToken(TokenType type, std::string_view value, size_t endIndex);
+    Token makeError(std::string_view errorMessage, size_t position);
+    Token makeNeedsInput();
+    Token parseString(size_t openingQuoteIndex);
+    Token parseScalar(size_t startIndex);
+    Token continuePendingToken();
+    Token completeString(std::string_view rawString, size_t endIndex);
+    Token completeScalar(std::string_view scalar, size_t endIndex);
+};
+
+} // namespace Valdi
@@ -122,6 +122,19 @@ public:
         _objects.emplace_back(std::move(object));
     }
 
+    /**
+     Destroys the objects kept in the pool, typically when the application is low in memory.
+     Objects currently in use go back to the pool when released.
+     */
+    void clear() {
+        std::deque<T> objects;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            objects = std::move(_objects);
+            _objects = std::deque<T>();
+        }
+    }
+
 private:
     std::deque<T> _objects;
     std::mutex _mutex;
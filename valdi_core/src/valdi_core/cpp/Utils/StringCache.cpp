@@ -9,33 +9,91 @@
 #include "valdi_core/cpp/Text/UTF16Utils.hpp"
 #include <codecvt>
 #include <iostream>
+#include <thread>
 #include <vector>
 
 namespace Valdi {
 
-static size_t makePHMapHash(size_t hash) {
-    // Same function used by phmap internally, so that the find variant
-    // that takes a hash parameter matches what the hasher function does.
-    return phmap::phmap_mix<sizeof(size_t)>()(hash);
-}
+static constexpr size_t kInitialTableCapacity = 16;
 
-std::size_t StringCacheHash::operator()(const StringCacheEntry& entry) const {
-    return entry.impl->getHash();
-}
+// Marks a slot whose string was removed. Lookups need to continue probing past it.
+static InternedStringImpl* const kTombstone = reinterpret_cast<InternedStringImpl*>(static_cast<uintptr_t>(1));
+
+struct StringCache::Table {
+    size_t mask;
+    std::unique_ptr<std::atomic<InternedStringImpl*>[]> slots;
+
+    explicit Table(size_t capacity) : mask(capacity - 1), slots(new std::atomic<InternedStringImpl*>[capacity]) {
+        for (size_t i = 0; i < capacity; i++) {
+            slots[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+};
+
+/**
+ Registers the current thread as a reader of the shard for the lifetime
+ of the guard. Pointers loaded from the shard table are guaranteed
+ to remain valid until the guard is destroyed.
+ */
+class StringCacheReadGuard {
+public:
+    explicit StringCacheReadGuard(std::atomic<uint32_t>& readersEpoch, std::atomic<uint32_t>* readers)
+        : _readers(readers[readersEpoch.load() & 1]) {
+        _readers.fetch_add(1);
+    }
+
+    ~StringCacheReadGuard() {
+        _readers.fetch_sub(1);
+    }
 
-bool StringCacheEqual::operator()(const Valdi::StringCacheEntry& left, const Valdi::StringCacheEntry& right) const {
-    return left.impl == right.impl;
+private:
+    std::atomic<uint32_t>& _readers;
+};
+
+static size_t mixHash(size_t hash) {
+    // Spread the bits of the hash, as std::hash can be the identity function
+    // on some platforms. The low bits select the shard, the remaining bits the slot.
+    if constexpr (sizeof(size_t) == 8) {
+        uint64_t h = static_cast<uint64_t>(hash);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    } else {
+        uint32_t h = static_cast<uint32_t>(hash);
+        h ^= h >> 16;
+        h *= 0x85ebca6bU;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35U;
+        h ^= h >> 16;
+        return static_cast<size_t>(h);
+    }
 }
 
-bool StringCacheEqual::operator()(const Valdi::StringCacheEntry& left, const std::string_view& right) const {
-    return left.impl->toStringView() == right;
+static size_t getSlotIndex(size_t mixedHash) {
+    return mixedHash >> 6;
 }
 
-bool StringCacheEqual::operator()(const Valdi::StringCacheEntry& left, const Valdi::InternedStringImpl* right) const {
-    return left.impl == right;
+StringCache::StringCache() {
+    static_assert((kShardsCount & (kShardsCount - 1)) == 0, "kShardsCount must be a power of two");
+    static_assert(kShardsCount <= 64, "getSlotIndex() assumes at most 64 shards");
+
+    for (auto& shard : _shards) {
+        shard.table.store(new Table(kInitialTableCapacity));
+    }
 }
 
-StringCache::StringCache() = default;
+StringCache::~StringCache() {
+    for (auto& shard : _shards) {
+        delete shard.table.load();
+    }
+}
 
 StringBox StringCache::makeStringFromLiteral(const std::string_view& str) noexcept {
     return makeString(str);
@@ -57,20 +115,23 @@ StringBox StringCache::makeString(std::string_view strView) noexcept {
     }
 
     auto hash = StringBox::makeHash(strView);
-
-    std::lock_guard<Mutex> guard(_mutex);
-
-    const auto& it = findEntry(strView, hash);
-    if (it != _table.end()) {
-        auto locked = it->impl->lock();
-        if (locked != nullptr) {
-            return StringBox(Ref<InternedStringImpl>(std::move(locked)));
-        } else {
-            _table.erase(it);
+    auto mixedHash = mixHash(hash);
+    auto& shard = getShard(mixedHash);
+
+    {
+        // Fast path: the string is already interned, we don't need the lock.
+        StringCacheReadGuard guard(shard.readersEpoch, shard.readers);
+        auto* entry = findEntry(*shard.table.load(), strView, hash, mixedHash);
+        if (entry != nullptr) {
+            auto locked = entry->lock();
+            if (locked != nullptr) {
+                return StringBox(std::move(locked));
+            }
         }
     }
 
-    return insertString(strView, hash);
+    std::lock_guard<Mutex> guard(shard.mutex);
+    return insertString(shard, strView, hash, mixedHash);
 }
 
 StringBox StringCache::makeStringFromUTF16(const char16_t* utf16String, size_t len) noexcept {
@@ -87,45 +148,191 @@ StringBox StringCache::makeStringFromCLiteral(const char* cStr) noexcept {
     return getGlobal().makeStringFromLiteral(cStr);
 }
 
-StringBox StringCache::insertString(std::string_view str, size_t hash) {
+StringCache::Shard& StringCache::getShard(size_t mixedHash) {
+    return _shards[mixedHash & (kShardsCount - 1)];
+}
+
+StringBox StringCache::insertString(Shard& shard, std::string_view str, size_t hash, size_t mixedHash) {
+    auto* table = shard.table.load(std::memory_order_relaxed);
+    auto index = getSlotIndex(mixedHash) & table->mask;
+    std::atomic<InternedStringImpl*>* insertionSlot = nullptr;
+
+    for (;;) {
+        auto& slot = table->slots[index];
+        auto* entry = slot.load(std::memory_order_relaxed);
+        if (entry == nullptr) {
+            break;
+        }
+
+        if (entry == kTombstone) {
+            if (insertionSlot == nullptr) {
+                insertionSlot = &slot;
+            }
+        } else if (entry->getHash() == hash && entry->toStringView() == str) {
+            // Another thread might have inserted the string while we were waiting for the lock
+            auto locked = entry->lock();
+            if (locked != nullptr) {
+                return StringBox(std::move(locked));
+            }
+
+            // The string is pending removal, we replace it by a new one.
+            // removeString() will not find it in the table anymore.
+            slot.store(kTombstone);
+            shard.size--;
+            shard.tombstones++;
+            if (insertionSlot == nullptr) {
+                insertionSlot = &slot;
+            }
+        }
+
+        index = (index + 1) & table->mask;
+    }
+
+    if (insertionSlot == nullptr && (shard.size + shard.tombstones + 1) * 4 > table->capacity() * 3) {
+        auto capacity = table->capacity();
+        while ((shard.size + 1) * 2 > capacity) {
+            capacity *= 2;
+        }
+        rehash(shard, capacity);
+        return insertString(shard, str, hash, mixedHash);
+    }
+
+    if (insertionSlot == nullptr) {
+        insertionSlot = &table->slots[index];
+    } else {
+        shard.tombstones--;
+    }
+
     auto internedString = InternedStringImpl::make(str.data(), str.size(), hash);
 
-    _table.emplace(internedString.get());
+    // The release store publishes the fully constructed string to the lock-free readers
+    insertionSlot->store(internedString.get(), std::memory_order_release);
+    shard.size++;
 
     return StringBox(Ref<InternedStringImpl>(std::move(internedString)));
 }
 
+void StringCache::rehash(Shard& shard, size_t capacity) {
+    auto* oldTable = shard.table.load(std::memory_order_relaxed);
+    auto* newTable = new Table(capacity);
+
+    for (size_t i = 0; i < oldTable->capacity(); i++) {
+        auto* entry = oldTable->slots[i].load(std::memory_order_relaxed);
+        if (entry == nullptr || entry == kTombstone) {
+            continue;
+        }
+
+        auto index = getSlotIndex(mixHash(entry->getHash())) & newTable->mask;
+        while (newTable->slots[index].load(std::memory_order_relaxed) != nullptr) {
+            index = (index + 1) & newTable->mask;
+        }
+        newTable->slots[index].store(entry, std::memory_order_relaxed);
+    }
+
+    shard.table.store(newTable);
+    shard.tombstones = 0;
+
+    waitForReaders(shard);
+    delete oldTable;
+}
+
 void StringCache::removeString(const InternedStringImpl* internedString) {
-    std::lock_guard<Mutex> guard(_mutex);
+    auto& shard = getShard(mixHash(internedString->getHash()));
+
+    std::lock_guard<Mutex> guard(shard.mutex);
+
+    auto* table = shard.table.load(std::memory_order_relaxed);
+    auto index = getSlotIndex(mixHash(internedString->getHash())) & table->mask;
+
+    for (;;) {
+        auto& slot = table->slots[index];
+        auto* entry = slot.load(std::memory_order_relaxed);
+        if (entry == nullptr) {
+            break;
+        }
+        if (entry == internedString) {
+            slot.store(kTombstone);
+            shard.size--;
+            shard.tombstones++;
+            break;
+        }
 
-    const auto& it = _table.find(internedString, makePHMapHash(internedString->getHash()));
-    if (it != _table.end()) {
-        _table.erase(it);
+        index = (index + 1) & table->mask;
     }
+
+    // Even if the string was already replaced in the table, a reader might still
+    // hold a pointer to it. The caller deletes the string once we return.
+    waitForReaders(shard);
 }
 
-std::unique_lock<Mutex> StringCache::lock() {
-    return std::unique_lock<Mutex>(_mutex);
+void StringCache::waitForReaders(Shard& shard) {
+    // Two flips are needed: a reader might have picked its counter
+    // from the epoch right before the first flip.
+    for (size_t i = 0; i < 2; i++) {
+        auto previousEpoch = shard.readersEpoch.fetch_xor(1) & 1;
+        auto& readers = shard.readers[previousEpoch];
+        while (readers.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+StringCache::ShardsLock StringCache::lock() {
+    return ShardsLock(*this);
+}
+
+StringCache::ShardsLock::ShardsLock(StringCache& cache) {
+    _locks.reserve(kShardsCount);
+    for (auto& shard : cache._shards) {
+        _locks.emplace_back(shard.mutex);
+    }
+}
+
+void StringCache::ShardsLock::unlock() {
+    for (auto& lock : _locks) {
+        lock.unlock();
+    }
 }
 
 std::vector<StringBox> StringCache::all() const {
     std::vector<StringBox> out;
 
-    std::lock_guard<Mutex> guard(_mutex);
-    out.reserve(_table.size());
-
-    for (const auto& it : _table) {
-        auto locked = it.impl->lock();
-        if (locked != nullptr) {
-            out.emplace_back(Ref<InternedStringImpl>(std::move(locked)));
+    for (const auto& shard : _shards) {
+        std::lock_guard<Mutex> guard(shard.mutex);
+        const auto* table = shard.table.load(std::memory_order_relaxed);
+
+        for (size_t i = 0; i < table->capacity(); i++) {
+            auto* entry = table->slots[i].load(std::memory_order_relaxed);
+            if (entry == nullptr || entry == kTombstone) {
+                continue;
+            }
+            auto locked = entry->lock();
+            if (locked != nullptr) {
+                out.emplace_back(Ref<InternedStringImpl>(std::move(locked)));
+            }
         }
     }
 
     return out;
 }
 
-StringCache::StringTable::const_iterator StringCache::findEntry(const std::string_view& str, size_t hash) const {
-    return _table.find(str, makePHMapHash(hash));
+InternedStringImpl* StringCache::findEntry(const Table& table,
+                                           const std::string_view& str,
+                                           size_t hash,
+                                           size_t mixedHash) {
+    auto index = getSlotIndex(mixedHash) & table.mask;
+
+    for (;;) {
+        auto* entry = table.slots[index].load();
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        if (entry != kTombstone && entry->getHash() == hash && entry->toStringView() == str) {
+            return entry;
+        }
+
+        index = (index + 1) & table.mask;
+    }
 }
 
 } // namespace Valdi
@@ -11,6 +11,9 @@
 #include "valdi_core/cpp/Utils/InternedStringImpl.hpp"
 #include "valdi_core/cpp/Utils/Mutex.hpp"
 #include "valdi_core/cpp/Utils/StringBox.hpp"
+#include <array>
+#include <atomic>
+#include <vector>
 
 #define STRING_LITERAL(str) Valdi::StringCache::makeStringFromCLiteral(str)
 #define STRING_FORMAT(__format, ...) Valdi::StringCache::getGlobal().makeString(fmt::format((__format), __VA_ARGS__))
@@ -39,27 +42,23 @@ static inline std::string_view convertInline(const std::string_view& str) {
     return str;
 }
 
-struct StringCacheEntry {
-    InternedStringImpl* impl;
-
-    inline StringCacheEntry(InternedStringImpl* impl) : impl(impl) {}
-};
-
-struct StringCacheHash {
-    using is_transparent = void;
-    std::size_t operator()(const StringCacheEntry& entry) const;
-};
-
-struct StringCacheEqual {
-    using is_transparent = void;
-    bool operator()(const StringCacheEntry& left, const StringCacheEntry& right) const;
-    bool operator()(const StringCacheEntry& left, const std::string_view& right) const;
-    bool operator()(const StringCacheEntry& left, const InternedStringImpl* right) const;
-};
-
 class StringCache {
 public:
+    /**
+     Holds the insertion lock of every shard of the StringCache.
+     Exposed for tests only, DO NOT USE
+     */
+    class ShardsLock {
+    public:
+        explicit ShardsLock(StringCache& cache);
+        void unlock();
+
+    private:
+        std::vector<std::unique_lock<Mutex>> _locks;
+    };
+
     StringCache(const StringCache& other) = delete;
+    ~StringCache();
 
     /**
      Returns a string from the given C++ string literal.
@@ -90,7 +89,7 @@ public:
     /**
      Exposed for tests only, DO NOT USE
      */
-    std::unique_lock<Mutex> lock();
+    ShardsLock lock();
 
     /**
      Returns all of the strings inside the StringCache
@@ -103,22 +102,56 @@ public:
     static StringBox makeStringFromCLiteral(const char* cStr) noexcept;
 
 private:
-    using StringTable =
-        phmap::flat_hash_set<StringCacheEntry, StringCacheHash, StringCacheEqual, phmap::Allocator<StringCacheEntry>>;
+    /**
+     Open addressing table of a shard. Slots are atomics so that they can be
+     read without holding the shard lock. Tables are never mutated in place
+     when resizing: a new table is published and the old one is deleted once
+     no readers can observe it anymore.
+     */
+    struct Table;
+
+    /**
+     The StringCache is partitioned into shards using the hash of the strings.
+     Lookups of strings that already exist in the cache don't take any lock,
+     they only register themselves as readers of the shard. The shard mutex is
+     only taken when inserting or removing strings. Removals wait until all
+     the readers that could have observed the removed string have left before
+     letting the string be deleted.
+     */
+    struct alignas(64) Shard {
+        mutable Mutex mutex;
+        std::atomic<Table*> table;
+        std::atomic<uint32_t> readersEpoch{0};
+        std::atomic<uint32_t> readers[2]{{0}, {0}};
+        size_t size = 0;
+        size_t tombstones = 0;
+    };
 
-    StringTable _table;
-    mutable Mutex _mutex;
+    static constexpr size_t kShardsCount = 64;
+
+    std::array<Shard, kShardsCount> _shards;
 
     StringCache();
 
-    // Should be called with a lock already acquired
-    StringBox insertString(std::string_view str, size_t hash);
+    Shard& getShard(size_t mixedHash);
+
+    // Should be called with the shard lock already acquired
+    StringBox insertString(Shard& shard, std::string_view str, size_t hash, size_t mixedHash);
+    // Should be called with the shard lock already acquired
+    void rehash(Shard& shard, size_t capacity);
     // Should be called without a lock
     void removeString(const InternedStringImpl* internedString);
 
     friend InternedStringImpl;
 
-    StringTable::const_iterator findEntry(const std::string_view& str, size_t hash) const;
+    /**
+     Wait until all the readers that might have loaded a pointer from the
+     shard table before this call have finished their lookup.
+     Should be called with the shard lock already acquired.
+     */
+    static void waitForReaders(Shard& shard);
+
+    static InternedStringImpl* findEntry(const Table& table, const std::string_view& str, size_t hash, size_t mixedHash);
 };
 
 } // namespace Valdi
@@ -6,8 +6,12 @@
 //
 
 #include "valdi_core/cpp/Utils/Trace.hpp"
+#include "valdi_core/cpp/Utils/FlatMap.hpp"
+#include "valdi_core/cpp/Utils/SmallVector.hpp"
 #include "valdi_core/cpp/Utils/StringBox.hpp"
 
+#include <deque>
+
 namespace Valdi {
 
 std::string getTraceName(std::string_view prefix, const StringBox& suffix) {
@@ -28,18 +32,107 @@ TraceDuration RecordedTrace::duration() const {
     return TraceDuration(end - start);
 }
 
-ScopedTrace::ScopedTrace(const StringBox& trace) : _trace(trace.toStringView()), _snapTrace(_trace) {
+/**
+ Names are never removed from the table, trace names are expected to be
+ a bounded set of literals and component paths.
+ */
+class TraceNamesTable {
+public:
+    TraceNameId intern(std::string_view name) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto& it = _ids.find(name);
+        if (it != _ids.end()) {
+            return it->second;
+        }
+
+        auto nameId = static_cast<TraceNameId>(_names.size());
+        const auto& storedName = _names.emplace_back(name);
+        _ids[std::string_view(storedName)] = nameId;
+        return nameId;
+    }
+
+    std::string getName(TraceNameId nameId) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (nameId >= _names.size()) {
+            return std::string();
+        }
+        return _names[nameId];
+    }
+
+    static TraceNamesTable& get() {
+        static auto* kInstance = new TraceNamesTable();
+        return *kInstance;
+    }
+
+private:
+    std::mutex _mutex;
+    // Deque so that the views used as keys stay valid as names are added
+    std::deque<std::string> _names;
+    FlatMap<std::string_view, TraceNameId> _ids;
+};
+
+static constexpr size_t kMaxCachedTraceNames = 256;
+
+template<typename Key>
+struct TraceNamesCache {
+    FlatMap<Key, TraceNameId> ids;
+
+    template<typename LookupKey>
+    TraceNameId intern(const LookupKey& key, std::string_view name) {
+        const auto& it = ids.find(key);
+        if (it != ids.end()) {
+            return it->second;
+        }
+
+        if (ids.size() >= kMaxCachedTraceNames) {
+            ids.clear();
+        }
+
+        auto nameId = TraceNamesTable::get().intern(name);
+        ids[key] = nameId;
+        return nameId;
+    }
+};
+
+static thread_local TraceNamesCache<const char*> tLiteralTraceNames;
+static thread_local TraceNamesCache<StringBox> tStringBoxTraceNames;
+static thread_local TraceNamesCache<std::string> tStringTraceNames;
+
+TraceNameId TraceNames::intern(std::string_view name) {
+    return TraceNamesTable::get().intern(name);
+}
+
+std::string TraceNames::getName(TraceNameId nameId) {
+    return TraceNamesTable::get().getName(nameId);
+}
+
+TraceNameId TraceNames::internLiteral(const char* literal, std::string_view name) {
+    return tLiteralTraceNames.intern(literal, name);
+}
+
+TraceNameId TraceNames::internCached(const StringBox& name) {
+    return tStringBoxTraceNames.intern(name, name.toStringView());
+}
+
+TraceNameId TraceNames::internCached(const std::string& name) {
+    return tStringTraceNames.intern(name, name);
+}
+
+ScopedTrace::ScopedTrace(const StringBox& trace)
+    : _trace(trace.toStringView()), _traceName(_trace), _snapTrace(_trace) {
     begin();
 
     if (Tracer::shared().isRecording()) {
+        _nameId = TraceNames::internCached(trace);
         _startTime = {std::chrono::steady_clock::now()};
     }
 }
 
-ScopedTrace::ScopedTrace(std::string&& trace) : _trace(std::move(trace)), _snapTrace(_trace) {
+ScopedTrace::ScopedTrace(std::string&& trace) : _trace(std::move(trace)), _traceName(_trace), _snapTrace(_trace) {
     begin();
 
     if (Tracer::shared().isRecording()) {
+        _nameId = TraceNames::internCached(_trace);
         _startTime = {std::chrono::steady_clock::now()};
     }
 }
@@ -47,7 +140,7 @@ ScopedTrace::ScopedTrace(std::string&& trace) : _trace(std::move(trace)), _snapT
 ScopedTrace::~ScopedTrace() {
     if (_startTime) {
         auto endTime = std::chrono::steady_clock::now();
-        Tracer::shared().append(std::move(_trace), _startTime.value(), endTime);
+        Tracer::shared().append(_nameId, _startTime.value(), endTime);
     }
 
     end();
@@ -55,37 +148,219 @@ ScopedTrace::~ScopedTrace() {
 
 void ScopedTrace::begin() {
     snap::profiling::TraceBegin traceBegin;
-    traceBegin.name = _trace;
+    traceBegin.name = _traceName;
 
     _osEmitter.begin(traceBegin);
 }
 
 void ScopedTrace::end() {
     snap::profiling::TraceEnd traceEnd;
-    traceEnd.name = _trace;
+    traceEnd.name = _traceName;
 
     _osEmitter.end(traceEnd);
 }
 
-Tracer::Tracer() = default;
-Tracer::~Tracer() = default;
+TraceRingBuffer::TraceRingBuffer() = default;
+TraceRingBuffer::~TraceRingBuffer() = default;
+
+size_t TraceRingBuffer::getDroppedEventsCount() const {
+    return _droppedEventsCount.load(std::memory_order_relaxed);
+}
+
+bool TraceRingBuffer::tryAcquire() {
+    auto owned = false;
+    return _owned.compare_exchange_strong(owned, true, std::memory_order_acquire);
+}
+
+void TraceRingBuffer::relinquish() {
+    _owned.store(false, std::memory_order_release);
+}
+
+size_t TraceRingBuffer::getAcquireSequence() const {
+    return _acquireSequence.load(std::memory_order_relaxed);
+}
+
+void TraceRingBuffer::setAcquireSequence(size_t acquireSequence) {
+    _acquireSequence.store(acquireSequence, std::memory_order_relaxed);
+}
+
+bool TraceRingBuffer::isHandedOff() const {
+    return _handedOff.load(std::memory_order_acquire);
+}
+
+void TraceRingBuffer::setHandedOff(bool handedOff) {
+    _handedOff.store(handedOff, std::memory_order_release);
+}
+
+/**
+ The trace buffers used by the current thread, one per Tracer it appended traces to.
+ */
+struct ThreadTraceBuffers {
+    SmallVector<std::pair<uint64_t, Ref<TraceRingBuffer>>, 2> buffers;
+
+    ~ThreadTraceBuffers() {
+        for (const auto& it : buffers) {
+            it.second->relinquish();
+        }
+    }
+};
+
+static thread_local ThreadTraceBuffers tThreadTraceBuffers;
+static std::atomic<uint64_t> kTracerIdentifierCounter = 0;
+
+Tracer::Tracer() : _identifier(++kTracerIdentifierCounter) {}
+
+Tracer::~Tracer() {
+    auto* node = _buffers.load();
+    while (node != nullptr) {
+        auto* next = node->next;
+        delete node;
+        node = next;
+    }
+}
 
 Tracer& Tracer::shared() {
     static auto* kInstance = new Tracer();
     return *kInstance;
 }
 
+TraceRingBuffer& Tracer::getCurrentThreadBuffer() {
+    for (const auto& it : tThreadTraceBuffers.buffers) {
+        if (it.first == _identifier) {
+            return *it.second;
+        }
+    }
+
+    return registerCurrentThreadBuffer();
+}
+
+TraceRingBuffer& Tracer::registerCurrentThreadBuffer() {
+    auto& threadBuffers = tThreadTraceBuffers.buffers;
+
+    // Forget about the buffers of the Tracers that were destroyed
+    auto it = threadBuffers.begin();
+    while (it != threadBuffers.end()) {
+        if (it->second->retainCount() == 1) {
+            it = threadBuffers.erase(it);
+        } else {
+            it++;
+        }
+    }
+
+    auto buffer = acquireBuffer();
+    threadBuffers.emplace_back(_identifier, buffer);
+    return *buffer;
+}
+
+Ref<TraceRingBuffer> Tracer::acquireBuffer() {
+    Ref<TraceRingBuffer> buffer;
+    for (auto* node = _buffers.load(std::memory_order_acquire); node != nullptr; node = node->next) {
+        if (node->buffer->tryAcquire()) {
+            buffer = node->buffer;
+            break;
+        }
+    }
+
+    if (buffer == nullptr) {
+        buffer = makeShared<TraceRingBuffer>();
+
+        auto* node = new BufferNode();
+        node->buffer = buffer;
+        node->next = _buffers.load(std::memory_order_relaxed);
+        while (!_buffers.compare_exchange_weak(node->next, node, std::memory_order_release)) {
+        }
+    }
+
+    buffer->setAcquireSequence(++_acquireSequence);
+    return buffer;
+}
+
+void Tracer::handOffCurrentThreadBuffer() {
+    for (auto& it : tThreadTraceBuffers.buffers) {
+        if (it.first == _identifier) {
+            // The buffer stays owned until the Tracer drains it
+            it.second->setHandedOff(true);
+            it.second = acquireBuffer();
+            return;
+        }
+    }
+}
+
 void Tracer::append(std::string&& trace, const TraceTimePoint& start, const TraceTimePoint& end) {
-    std::lock_guard<std::mutex> lock(_mutex);
-    if (_recorders.empty()) {
+    if (!isRecording()) {
         return;
     }
 
-    _pendingTraces.emplace_back(std::move(trace), start, end, getCurrentThreadId(), _recordingSequence);
+    append(TraceNames::intern(trace), start, end);
+}
+
+void Tracer::append(TraceNameId nameId, const TraceTimePoint& start, const TraceTimePoint& end) {
+    if (!isRecording()) {
+        return;
+    }
+
+    TraceEvent event;
+    event.nameId = nameId;
+    event.threadId = getCurrentThreadId();
+    event.recordingSequence = _recordingSequence.load(std::memory_order_relaxed);
+    event.start = start;
+    event.end = end;
+
+    auto& buffer = getCurrentThreadBuffer();
+    buffer.push(event);
+
+    if (buffer.size() == TraceRingBuffer::kCapacity) {
+        handOffCurrentThreadBuffer();
+    }
+}
+
+size_t Tracer::getDroppedTracesCount() const {
+    size_t count = 0;
+    for (auto* node = _buffers.load(std::memory_order_acquire); node != nullptr; node = node->next) {
+        count += node->buffer->getDroppedEventsCount();
+    }
+    return count;
+}
+
+void Tracer::drainBuffers() {
+    SmallVector<TraceRingBuffer*, 8> buffers;
+    for (auto* node = _buffers.load(std::memory_order_acquire); node != nullptr; node = node->next) {
+        buffers.emplace_back(node->buffer.get());
+    }
+    std::sort(buffers.begin(), buffers.end(), [](const TraceRingBuffer* left, const TraceRingBuffer* right) {
+        return left->getAcquireSequence() < right->getAcquireSequence();
+    });
+
+    auto drainStart = _pendingEvents.size();
+    for (auto* buffer : buffers) {
+        // Checked before draining, a handed off buffer is no longer pushed to
+        auto handedOff = buffer->isHandedOff();
+        drainBuffer(*buffer);
+
+        if (handedOff) {
+            buffer->setHandedOff(false);
+            buffer->relinquish();
+        }
+    }
+
+    // A thread might have filled multiple buffers, group its traces back together
+    std::stable_sort(_pendingEvents.begin() + drainStart,
+                     _pendingEvents.end(),
+                     [](const TraceEvent& left, const TraceEvent& right) { return left.threadId < right.threadId; });
+}
+
+void Tracer::drainBuffer(TraceRingBuffer& buffer) {
+    buffer.drain([&](const TraceEvent& event) { _pendingEvents.emplace_back(event); });
 }
 
 size_t Tracer::startRecording() {
     std::lock_guard<std::mutex> lock(_mutex);
+    if (_recorders.empty()) {
+        // Discard the traces appended while the last recording was stopping
+        drainBuffers();
+        _pendingEvents.clear();
+    }
+
     auto sequence = ++_recordingSequence;
     _recording = true;
 
@@ -94,6 +369,28 @@ size_t Tracer::startRecording() {
     return sequence;
 }
 
+static std::vector<RecordedTrace> toRecordedTraces(const std::vector<TraceEvent>& events,
+                                                   size_t minRecordingSequence) {
+    std::vector<RecordedTrace> outTraces;
+    outTraces.reserve(events.size());
+
+    FlatMap<TraceNameId, std::string> names;
+    for (const auto& event : events) {
+        if (event.recordingSequence < minRecordingSequence) {
+            continue;
+        }
+
+        auto& name = names[event.nameId];
+        if (name.empty()) {
+            name = TraceNames::getName(event.nameId);
+        }
+
+        outTraces.emplace_back(std::string(name), event.start, event.end, event.threadId, event.recordingSequence);
+    }
+
+    return outTraces;
+}
+
 std::vector<RecordedTrace> Tracer::stopRecording(size_t recordingIdentifier) {
     std::lock_guard<std::mutex> lock(_mutex);
 
@@ -103,34 +400,31 @@ std::vector<RecordedTrace> Tracer::stopRecording(size_t recordingIdentifier) {
     }
 
     _recorders.erase(it);
+    drainBuffers();
 
     // Simple case, we only have one recorder we can return all the recorded traces
     if (_recorders.empty()) {
         _recording = false;
-        return std::move(_pendingTraces);
+        auto outTraces = toRecordedTraces(_pendingEvents, 0);
+        _pendingEvents.clear();
+        return outTraces;
     }
 
     // We still have one active recorder. We collect the traces that ocurreded with or after
     // this identifier
+    auto outTraces = toRecordedTraces(_pendingEvents, recordingIdentifier);
 
-    std::vector<RecordedTrace> outTraces;
-
-    for (const auto& trace : _pendingTraces) {
-        if (trace.recordingSequence >= recordingIdentifier) {
-            outTraces.emplace_back(trace);
-        }
-    }
-
-    auto lowestRecordingIdentifier = *_recorders.begin();
+    auto lowestRecordingIdentifier = *std::min_element(_recorders.begin(), _recorders.end());
     if (lowestRecordingIdentifier > recordingIdentifier) {
         // If the next lowest recording identifier is above the ending identifier,
         // we might have dangling traces to remove.
         // Remove all the traces that occured before the new lowest recording identifier.
-        auto newStartIt = _pendingTraces.begin();
-        while (newStartIt != _pendingTraces.end() && newStartIt->recordingSequence < lowestRecordingIdentifier) {
-            newStartIt++;
-        }
-        _pendingTraces.erase(_pendingTraces.begin(), newStartIt);
+        _pendingEvents.erase(std::remove_if(_pendingEvents.begin(),
+                                            _pendingEvents.end(),
+                                            [&](const TraceEvent& event) {
+                                                return event.recordingSequence < lowestRecordingIdentifier;
+                                            }),
+                             _pendingEvents.end());
     }
 
     return outTraces;
@@ -12,10 +12,13 @@
 #include "valdi_core/cpp/Threading/ThreadBase.hpp"
 #include "valdi_core/cpp/Utils/Defer.hpp"
 #include "valdi_core/cpp/Utils/Format.hpp"
+#include "valdi_core/cpp/Utils/Shared.hpp"
 
+#include <array>
 #include <atomic>
 #include <mutex>
 #include <optional>
+#include <string_view>
 #include <thread>
 #include <vector>
 
@@ -46,38 +49,199 @@ struct RecordedTrace {
     TraceDuration duration() const;
 };
 
+/**
+ Identifier of an interned trace name.
+ */
+using TraceNameId = uint32_t;
+
+/**
+ Global table of interned trace names, so that recorded traces can refer to their
+ name with a TraceNameId instead of owning a copy of it.
+ */
+class TraceNames {
+public:
+    static TraceNameId intern(std::string_view name);
+    static std::string getName(TraceNameId nameId);
+
+    /**
+     Same as intern(), but caches the ids in thread local storage, so that the global
+     table is only accessed the first time a thread sees a name.
+     The literal overload caches by address and must only be given string literals.
+     */
+    static TraceNameId internLiteral(const char* literal, std::string_view name);
+    static TraceNameId internCached(const StringBox& name);
+    static TraceNameId internCached(const std::string& name);
+};
+
+/**
+ A trace recorded by a Tracer, as stored in the trace buffers of the threads.
+ */
+struct TraceEvent {
+    TraceNameId nameId;
+    ThreadId threadId;
+    size_t recordingSequence;
+    TraceTimePoint start;
+    TraceTimePoint end;
+};
+
+/**
+ Fixed size queue of trace events with a single producer, the thread which owns the buffer,
+ and a single consumer, the Tracer draining it under its lock. Pushing and draining
+ never block each other. Events pushed while the buffer is full are dropped.
+ */
+class TraceRingBuffer : public SimpleRefCountable {
+public:
+    static constexpr size_t kCapacity = 4096;
+
+    TraceRingBuffer();
+    ~TraceRingBuffer() override;
+
+    inline bool push(const TraceEvent& event) {
+        auto head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= kCapacity) {
+            _droppedEventsCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        _events[head % kCapacity] = event;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    template<typename F>
+    size_t drain(F&& fn) {
+        auto tail = _tail.load(std::memory_order_relaxed);
+        auto head = _head.load(std::memory_order_acquire);
+        for (auto i = tail; i != head; i++) {
+            fn(_events[i % kCapacity]);
+        }
+        _tail.store(head, std::memory_order_release);
+        return head - tail;
+    }
+
+    inline size_t size() const {
+        return _head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_acquire);
+    }
+
+    size_t getDroppedEventsCount() const;
+
+    /**
+     A buffer is owned by a single thread at a time. Buffers of threads that exited
+     are given back to the Tracer, which hands them to the next thread that needs one.
+     */
+    bool tryAcquire();
+    void relinquish();
+
+    /**
+     Order in which the buffer was given to its current thread. Buffers of a thread
+     are drained in that order, so that its traces stay in the order they were appended.
+     */
+    size_t getAcquireSequence() const;
+    void setAcquireSequence(size_t acquireSequence);
+
+    /**
+     A full buffer is handed off by its thread, which continues with another buffer.
+     The Tracer relinquishes it once it has drained it.
+     */
+    bool isHandedOff() const;
+    void setHandedOff(bool handedOff);
+
+private:
+    alignas(64) std::atomic<size_t> _head = 0;
+    alignas(64) std::atomic<size_t> _tail = 0;
+    std::atomic<size_t> _droppedEventsCount = 0;
+    std::atomic_bool _owned = true;
+    std::atomic_bool _handedOff = false;
+    std::atomic<size_t> _acquireSequence = 0;
+    std::array<TraceEvent, kCapacity> _events;
+};
+
 class Tracer {
 public:
     Tracer();
     ~Tracer();
 
     inline bool isRecording() const {
-        return _recording;
+        return _recording.load(std::memory_order_relaxed);
     }
 
     size_t startRecording();
+
+    /**
+     Stops the given recording and returns the traces recorded since it started.
+     Traces are grouped by thread, in the order in which they were appended.
+     */
     std::vector<RecordedTrace> stopRecording(size_t recordingIdentifier);
 
     void append(std::string&& trace, const TraceTimePoint& start, const TraceTimePoint& end);
 
+    /**
+     Appends a trace to the buffer of the current thread, without taking the lock.
+     When the buffer is full, the thread hands it off to the Tracer and continues
+     with another one, the handed off buffers are drained when the recording stops.
+     */
+    void append(TraceNameId nameId, const TraceTimePoint& start, const TraceTimePoint& end);
+
+    /**
+     Returns how many traces were dropped because the buffer of their thread was full.
+     */
+    size_t getDroppedTracesCount() const;
+
     static Tracer& shared();
 
 private:
+    struct BufferNode {
+        Ref<TraceRingBuffer> buffer;
+        BufferNode* next = nullptr;
+    };
+
+    // Identifies the Tracer in the thread local buffers, never re-used unlike its address
+    const uint64_t _identifier;
+    // Guards the recorders and pending events, never taken when appending traces
     std::mutex _mutex;
     std::atomic_bool _recording = false;
-    size_t _recordingSequence = 0;
-    std::vector<RecordedTrace> _pendingTraces;
+    std::atomic<size_t> _recordingSequence = 0;
+    std::atomic<size_t> _acquireSequence = 0;
+    std::atomic<BufferNode*> _buffers = nullptr;
+    std::vector<TraceEvent> _pendingEvents;
     std::vector<size_t> _recorders;
+
+    TraceRingBuffer& getCurrentThreadBuffer();
+    TraceRingBuffer& registerCurrentThreadBuffer();
+    Ref<TraceRingBuffer> acquireBuffer();
+    void handOffCurrentThreadBuffer();
+
+    void drainBuffers();
+    void drainBuffer(TraceRingBuffer& buffer);
 };
 
 class ScopedTrace {
 public:
+    /**
+     Traces from string literals, which avoids copying the name.
+     */
+    template<size_t kSize>
+    explicit ScopedTrace(const char (&trace)[kSize]) : _traceName(trace, kSize - 1), _snapTrace(trace) {
+        begin();
+
+        if (Tracer::shared().isRecording()) {
+            _nameId = TraceNames::internLiteral(trace, _traceName);
+            _startTime = {std::chrono::steady_clock::now()};
+        }
+    }
+
+    template<size_t kSize>
+    explicit ScopedTrace(char (&trace)[kSize]) = delete;
+
     explicit ScopedTrace(const StringBox& trace);
     explicit ScopedTrace(std::string&& trace);
+    ScopedTrace(const ScopedTrace&) = delete;
     ~ScopedTrace();
 
 protected:
     std::string _trace;
+    std::string_view _traceName;
+    TraceNameId _nameId = 0;
     std::optional<TraceTimePoint> _startTime;
     snap::utils::debugging::ScopedTrace _snapTrace;
     snap::profiling::OsTraceEmitter _osEmitter;
@@ -8,6 +8,7 @@
 
 #include "valdi_core/cpp/Utils/ValueUtils.hpp"
 #include "valdi_core/cpp/Utils/JSONReader.hpp"
+#include "valdi_core/cpp/Utils/JSONTokenizer.hpp"
 #include "valdi_core/cpp/Utils/JSONWriter.hpp"
 #include "valdi_core/cpp/Utils/ValueArrayBuilder.hpp"
 
@@ -319,4 +320,108 @@ Value readValueFromJSONReader(JSONReader& reader) {
     }
 }
 
+static Value readValueFromJSONTokenizer(JSONTokenizer& tokenizer, const JSONTokenizer::Token& token);
+
+static Value readObjectFromJSONTokenizer(JSONTokenizer& tokenizer) {
+    auto valueMap = makeShared<ValueMap>();
+    auto token = tokenizer.next();
+    if (token.type == JSONTokenizer::TokenType::EndObject) {
+        return Value(valueMap);
+    }
+
+    for (;;) {
+        if (token.type != JSONTokenizer::TokenType::String) {
+            tokenizer.setErrorAtCurrentPosition("Expected object key");
+            return Value();
+        }
+        auto key = StringCache::getGlobal().makeString(token.value);
+
+        if (tokenizer.next().type != JSONTokenizer::TokenType::Colon) {
+            tokenizer.setErrorAtCurrentPosition("Expected ':'");
+            return Value();
+        }
+
+        auto value = readValueFromJSONTokenizer(tokenizer, tokenizer.next());
+        if (tokenizer.hasError()) {
+            return Value();
+        }
+        (*valueMap)[std::move(key)] = std::move(value);
+
+        token = tokenizer.next();
+        if (token.type == JSONTokenizer::TokenType::EndObject) {
+            return Value(valueMap);
+        }
+        if (token.type != JSONTokenizer::TokenType::Comma) {
+            tokenizer.setErrorAtCurrentPosition("Expected ',' or '}'");
+            return Value();
+        }
+        token = tokenizer.next();
+    }
+}
+
+static Value readArrayFromJSONTokenizer(JSONTokenizer& tokenizer) {
+    ValueArrayBuilder arrayBuilder;
+    auto token = tokenizer.next();
+    if (token.type == JSONTokenizer::TokenType::EndArray) {
+        return Value(arrayBuilder.build());
+    }
+
+    for (;;) {
+        auto value = readValueFromJSONTokenizer(tokenizer, token);
+        if (tokenizer.hasError()) {
+            return Value();
+        }
+        arrayBuilder.append(std::move(value));
+
+        token = tokenizer.next();
+        if (token.type == JSONTokenizer::TokenType::EndArray) {
+            return Value(arrayBuilder.build());
+        }
+        if (token.type != JSONTokenizer::TokenType::Comma) {
+            tokenizer.setErrorAtCurrentPosition("Expected ',' or ']'");
+            return Value();
+        }
+        token = tokenizer.next();
+    }
+}
+
+static Value readValueFromJSONTokenizer(JSONTokenizer& tokenizer, const JSONTokenizer::Token& token) {
+    switch (token.type) {
+        case JSONTokenizer::TokenType::BeginObject:
+            return readObjectFromJSONTokenizer(tokenizer);
+        case JSONTokenizer::TokenType::BeginArray:
+            return readArrayFromJSONTokenizer(tokenizer);
+        case JSONTokenizer::TokenType::String:
+            return Value(token.value);
+        case JSONTokenizer::TokenType::Number: {
+            TextParser parser(token.value);
+            double d;
+            if (!parser.parseDouble(d) || !parser.isAtEnd()) {
+                tokenizer.setErrorAtCurrentPosition("Invalid number");
+                return Value();
+            }
+            return Value(d);
+        }
+        case JSONTokenizer::TokenType::True:
+            return Value(true);
+        case JSONTokenizer::TokenType::False:
+            return Value(false);
+        case JSONTokenizer::TokenType::Null:
+            return Value();
+        case JSONTokenizer::TokenType::Error:
+            return Value();
+        case JSONTokenizer::TokenType::NeedsInput:
+        case JSONTokenizer::TokenType::End:
+            tokenizer.setErrorAtCurrentPosition("Unexpected end of input");
+            return Value();
+        default:
+            tokenizer.setErrorAtCurrentPosition("Expected a value");
+            return Value();
+    }
+}
+
+Value readValueFromJSONTokenizer(JSONTokenizer& tokenizer) {
+    return readValueFromJSONTokenizer(tokenizer, tokenizer.next());
+}
+
 } // namespace Valdi
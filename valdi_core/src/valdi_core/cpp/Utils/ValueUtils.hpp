@@ -18,6 +18,7 @@ namespace Valdi {
 
 class JSONWriter;
 class JSONReader;
+class JSONTokenizer;
 
 // Very basic primitive to serialize map Values into strings.
 // Only supports map with no nested object currently.
@@ -44,4 +45,10 @@ Result<Value> fastJsonToValue(const std::string_view& str);
 
 Value readValueFromJSONReader(JSONReader& reader);
 
+/**
+ * Read the next value from a tokenizer which was provided with the whole document.
+ * Returns an undefined Value and sets an error on the tokenizer if the value is malformed.
+ */
+Value readValueFromJSONTokenizer(JSONTokenizer& tokenizer);
+
 } // namespace Valdi
@@ -1,8 +1,13 @@
 #include "protogen/test.pb.h"
 #include "valdi_core/cpp/Utils/ByteBuffer.hpp"
 #include "valdi_protobuf/Message.hpp"
+#include "valdi_protobuf/PackedDecoding.hpp"
 #include <benchmark/benchmark.h>
+#include <google/protobuf/descriptor.pb.h>
 #include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <fmt/format.h>
+#include <random>
 
 using namespace Valdi;
 
@@ -109,11 +114,12 @@ BENCHMARK(EncodeProtobufReflectionCpp);
 
 static void DecodeValdiProtobuf(benchmark::State& state) {
     auto protoData = makeProtoData();
-    const auto& descriptor = *test::Message::GetDescriptor();
+    const auto* descriptor = test::Message::GetDescriptor();
 
     for (auto _ : state) {
-        auto message = Protobuf::Message::parse(protoData, descriptor);
-        if (!message) {
+        SimpleExceptionTracker exceptionTracker;
+        auto message = Protobuf::Message::parse(protoData, descriptor, exceptionTracker);
+        if (message == nullptr || !message->postprocess(true, exceptionTracker)) {
             SC_ABORT("Message failed to parse");
         }
     }
@@ -124,7 +130,7 @@ static void DecodeValdiProtobufNoPostprocess(benchmark::State& state) {
     auto protoData = makeProtoData();
 
     for (auto _ : state) {
-        auto message = Protobuf::Message::parse(protoData);
+        auto message = Protobuf::Message::parse(protoData, test::Message::GetDescriptor());
         if (!message) {
             SC_ABORT("Message failed to parse");
         }
@@ -134,8 +140,7 @@ BENCHMARK(DecodeValdiProtobufNoPostprocess);
 
 static void EncodeValdiProtobuf(benchmark::State& state) {
     auto protoData = makeProtoData();
-    const auto& descriptor = *test::Message::GetDescriptor();
-    auto result = Protobuf::Message::parse(protoData, descriptor);
+    auto result = Protobuf::Message::parse(protoData, test::Message::GetDescriptor());
     if (!result) {
         SC_ABORT("Message failed to parse");
     }
@@ -143,11 +148,259 @@ static void EncodeValdiProtobuf(benchmark::State& state) {
 
     for (auto _ : state) {
         auto result = message->encode();
-        if (!result) {
+        if (result.empty()) {
             SC_ABORT("Message failed to serialize");
         }
     }
 }
 BENCHMARK(EncodeValdiProtobuf);
 
+static constexpr int kWideMessageFieldsCount = 200;
+
+/**
+ Returns a message type made of kWideMessageFieldsCount fields,
+ alternating between int64, string, double and repeated int32 fields.
+ */
+static const google::protobuf::Descriptor* getWideMessageDescriptor() {
+    static const auto* kDescriptor = []() {
+        google::protobuf::FileDescriptorProto fileProto;
+        fileProto.set_name("wide.proto");
+        fileProto.set_package("benchmark");
+        fileProto.set_syntax("proto3");
+
+        auto* messageProto = fileProto.add_message_type();
+        messageProto->set_name("WideMessage");
+
+        for (int i = 1; i <= kWideMessageFieldsCount; i++) {
+            auto* fieldProto = messageProto->add_field();
+            fieldProto->set_name(fmt::format("field_{}", i));
+            fieldProto->set_number(i);
+            fieldProto->set_label(google::protobuf::FieldDescriptorProto::LABEL_OPTIONAL);
+
+            switch (i % 4) {
+                case 0:
+                    fieldProto->set_type(google::protobuf::FieldDescriptorProto::TYPE_INT64);
+                    break;
+                case 1:
+                    fieldProto->set_type(google::protobuf::FieldDescriptorProto::TYPE_STRING);
+                    break;
+                case 2:
+                    fieldProto->set_type(google::protobuf::FieldDescriptorProto::TYPE_DOUBLE);
+                    break;
+                default:
+                    fieldProto->set_type(google::protobuf::FieldDescriptorProto::TYPE_INT32);
+                    fieldProto->set_label(google::protobuf::FieldDescriptorProto::LABEL_REPEATED);
+                    break;
+            }
+        }
+
+        auto* pool = new google::protobuf::DescriptorPool();
+        const auto* fileDescriptor = pool->BuildFile(fileProto);
+        SC_ASSERT_NOTNULL(fileDescriptor);
+        return fileDescriptor->message_type(0);
+    }();
+
+    return kDescriptor;
+}
+
+static BytesView makeWideProtoData() {
+    const auto* descriptor = getWideMessageDescriptor();
+    google::protobuf::DynamicMessageFactory factory;
+    std::unique_ptr<google::protobuf::Message> message(factory.GetPrototype(descriptor)->New());
+    const auto* reflection = message->GetReflection();
+
+    for (int i = 0; i < descriptor->field_count(); i++) {
+        const auto* field = descriptor->field(i);
+        switch (field->type()) {
+            case google::protobuf::FieldDescriptor::TYPE_INT64:
+                reflection->SetInt64(message.get(), field, 1337133713371337 + i);
+                break;
+            case google::protobuf::FieldDescriptor::TYPE_STRING:
+                reflection->SetString(message.get(), field, fmt::format("Hello World from field {}", i));
+                break;
+            case google::protobuf::FieldDescriptor::TYPE_DOUBLE:
+                reflection->SetDouble(message.get(), field, 0.987654321 * i);
+                break;
+            default:
+                for (int j = 0; j < 16; j++) {
+                    reflection->AddInt32(message.get(), field, i * j);
+                }
+                break;
+        }
+    }
+
+    auto buffer = makeShared<ByteBuffer>();
+    buffer->resize(message->ByteSizeLong());
+    SC_ASSERT(message->SerializeToArray(buffer->data(), static_cast<int>(buffer->size())));
+
+    return buffer->toBytesView();
+}
+
+static void readWideMessageSparsely(benchmark::State& state, const Ref<Protobuf::MessageProjection>& projection) {
+    auto protoData = makeWideProtoData();
+    const auto* descriptor = getWideMessageDescriptor();
+
+    for (auto _ : state) {
+        SimpleExceptionTracker exceptionTracker;
+        auto message = makeShared<Protobuf::Message>(descriptor, protoData.getSource());
+        message->setProjection(projection);
+        if (!message->decode(protoData.data(), protoData.size(), exceptionTracker)) {
+            SC_ABORT("Message failed to parse");
+        }
+
+        benchmark::DoNotOptimize(message->getFieldAsString(9));
+        benchmark::DoNotOptimize(message->getOrCreateField(152).getInt64());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * protoData.size()));
+}
+
+static void DecodeWideMessageReflectionCpp(benchmark::State& state) {
+    auto protoData = makeWideProtoData();
+    const auto* descriptor = getWideMessageDescriptor();
+    google::protobuf::DynamicMessageFactory factory;
+    const auto* prototype = factory.GetPrototype(descriptor);
+    const auto* stringField = descriptor->FindFieldByNumber(9);
+    const auto* int64Field = descriptor->FindFieldByNumber(152);
+
+    for (auto _ : state) {
+        std::unique_ptr<google::protobuf::Message> message(prototype->New());
+        if (!message->ParseFromArray(protoData.data(), static_cast<int>(protoData.size()))) {
+            SC_ABORT("Message failed to parse");
+        }
+
+        benchmark::DoNotOptimize(message->GetReflection()->GetString(*message, stringField));
+        benchmark::DoNotOptimize(message->GetReflection()->GetInt64(*message, int64Field));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * protoData.size()));
+}
+BENCHMARK(DecodeWideMessageReflectionCpp);
+
+static void DecodeWideMessageValdiProtobuf(benchmark::State& state) {
+    readWideMessageSparsely(state, nullptr);
+}
+BENCHMARK(DecodeWideMessageValdiProtobuf);
+
+static void DecodeWideMessageValdiProtobufProjected(benchmark::State& state) {
+    auto projection = Protobuf::MessageProjection::fromFieldPaths(getWideMessageDescriptor(), {"field_9", "field_152"});
+    if (!projection) {
+        SC_ABORT("Failed to create projection");
+    }
+
+    readWideMessageSparsely(state, projection.value());
+}
+BENCHMARK(DecodeWideMessageValdiProtobufProjected);
+
+static constexpr size_t kPackedValuesCount = 4096;
+
+/**
+ A message dominated by packed arrays, like ids and timestamps.
+ */
+static BytesView makePackedProtoData() {
+    test::RepeatedMessage message;
+    std::mt19937_64 random(42);
+
+    int64_t timestamp = 1700000000000;
+    for (size_t i = 0; i < kPackedValuesCount; i++) {
+        timestamp += static_cast<int64_t>(random() % 5000);
+        message.add_int64(timestamp);
+        message.add_uint32(static_cast<uint32_t>(random() % 200));
+        message.add_uint64(random() >> (random() % 64));
+        message.add_fixed64(random());
+    }
+
+    auto buffer = makeShared<ByteBuffer>();
+    buffer->resize(message.ByteSizeLong());
+    SC_ASSERT(message.SerializeToArray(buffer->data(), static_cast<int>(buffer->size())));
+
+    return buffer->toBytesView();
+}
+
+static void DecodePackedProtobufCpp(benchmark::State& state) {
+    auto protoData = makePackedProtoData();
+
+    for (auto _ : state) {
+        test::RepeatedMessage message;
+        if (!message.ParseFromArray(protoData.data(), static_cast<int>(protoData.size()))) {
+            SC_ABORT("Message failed to parse");
+        }
+        benchmark::DoNotOptimize(message.int64(0));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * protoData.size()));
+}
+BENCHMARK(DecodePackedProtobufCpp);
+
+static void DecodePackedProtobufReflectionCpp(benchmark::State& state) {
+    auto protoData = makePackedProtoData();
+    google::protobuf::DynamicMessageFactory factory;
+    const auto* prototype = factory.GetPrototype(test::RepeatedMessage::GetDescriptor());
+
+    for (auto _ : state) {
+        std::unique_ptr<google::protobuf::Message> message(prototype->New());
+        if (!message->ParseFromArray(protoData.data(), static_cast<int>(protoData.size()))) {
+            SC_ABORT("Message failed to parse");
+        }
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * protoData.size()));
+}
+BENCHMARK(DecodePackedProtobufReflectionCpp);
+
+static void DecodePackedValdiProtobuf(benchmark::State& state) {
+    auto protoData = makePackedProtoData();
+    const auto* descriptor = test::RepeatedMessage::GetDescriptor();
+
+    for (auto _ : state) {
+        SimpleExceptionTracker exceptionTracker;
+        auto message = Protobuf::Message::parse(protoData, descriptor, exceptionTracker);
+        if (message == nullptr || !message->postprocess(true, exceptionTracker)) {
+            SC_ABORT("Message failed to parse");
+        }
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * protoData.size()));
+    state.SetLabel(Protobuf::getPackedVarintsDecoderName());
+}
+BENCHMARK(DecodePackedValdiProtobuf);
+
+static void decodePackedVarints(benchmark::State& state, decltype(&Protobuf::decodePackedVarints) decoder) {
+    test::RepeatedMessage message;
+    std::mt19937_64 random(42);
+    for (size_t i = 0; i < kPackedValuesCount; i++) {
+        message.add_uint64(random() >> (random() % 64));
+    }
+    auto encoded = message.SerializeAsString();
+    // Skip the tag and length prefix of the packed field
+    google::protobuf::io::CodedInputStream inputStream(reinterpret_cast<const uint8_t*>(encoded.data()),
+                                                       static_cast<int>(encoded.size()));
+    uint32_t length = 0;
+    inputStream.ReadTag();
+    inputStream.ReadVarint32(&length);
+    const auto* data = reinterpret_cast<const Byte*>(encoded.data()) + inputStream.CurrentPosition();
+
+    std::vector<uint64_t> output(kPackedValuesCount);
+    for (auto _ : state) {
+        auto result = decoder(data, length, output.data(), output.size());
+        if (result.valuesCount != kPackedValuesCount) {
+            SC_ABORT("Failed to decode varints");
+        }
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * length));
+}
+
+static void DecodePackedVarintsScalar(benchmark::State& state) {
+    decodePackedVarints(state, &Protobuf::decodePackedVarintsScalar);
+}
+BENCHMARK(DecodePackedVarintsScalar);
+
+static void DecodePackedVarintsDispatched(benchmark::State& state) {
+    decodePackedVarints(state, &Protobuf::decodePackedVarints);
+    state.SetLabel(Protobuf::getPackedVarintsDecoderName());
+}
+BENCHMARK(DecodePackedVarintsDispatched);
+
 BENCHMARK_MAIN();
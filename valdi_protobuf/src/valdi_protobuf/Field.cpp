@@ -1,5 +1,6 @@
 #include "valdi_protobuf/Field.hpp"
 #include "valdi_protobuf/Message.hpp"
+#include "valdi_protobuf/PackedDecoding.hpp"
 #include "valdi_protobuf/RepeatedField.hpp"
 
 #include <google/protobuf/descriptor.h>
@@ -755,30 +756,51 @@ static RepeatedField* toPackedRepeated(Field* field, RepeatedParser parser) {
     return field->toRepeated();
 }
 
-static void parseVarintRepeated(RepeatedField* repeated, const Byte* data, size_t length) {
-    google::protobuf::io::CodedInputStream inputStream(data, static_cast<int>(length));
+// Values are decoded in batches on the stack, then bulk appended to the RepeatedField
+static constexpr size_t kPackedDecodeBatchSize = 256;
 
-    uint64_t varint;
-    while (inputStream.ReadVarint64(&varint)) {
-        repeated->append(Field::varint(varint));
+static void parseVarintRepeated(RepeatedField* repeated, const Byte* data, size_t length) {
+    repeated->reserve(repeated->size() + countPackedVarints(data, length));
+
+    uint64_t values[kPackedDecodeBatchSize];
+    while (length > 0) {
+        auto result = decodePackedVarints(data, length, values, kPackedDecodeBatchSize);
+        repeated->appendVarints(values, result.valuesCount);
+        if (result.valuesCount < kPackedDecodeBatchSize) {
+            break;
+        }
+        data += result.bytesRead;
+        length -= result.bytesRead;
     }
 }
 
 static void parseFixed64Repeated(RepeatedField* repeated, const Byte* data, size_t length) {
-    google::protobuf::io::CodedInputStream inputStream(data, static_cast<int>(length));
+    repeated->reserve(repeated->size() + length / sizeof(uint64_t));
 
-    uint64_t value;
-    while (inputStream.ReadLittleEndian64(&value)) {
-        repeated->append(Field::fixed64(value));
+    uint64_t values[kPackedDecodeBatchSize];
+    for (;;) {
+        auto result = decodePackedFixed64(data, length, values, kPackedDecodeBatchSize);
+        if (result.valuesCount == 0) {
+            break;
+        }
+        repeated->appendFixed64(values, result.valuesCount);
+        data += result.bytesRead;
+        length -= result.bytesRead;
     }
 }
 
 static void parseFixed32Repeated(RepeatedField* repeated, const Byte* data, size_t length) {
-    google::protobuf::io::CodedInputStream inputStream(data, static_cast<int>(length));
+    repeated->reserve(repeated->size() + length / sizeof(uint32_t));
 
-    uint32_t value;
-    while (inputStream.ReadLittleEndian32(&value)) {
-        repeated->append(Field::fixed32(value));
+    uint32_t values[kPackedDecodeBatchSize];
+    for (;;) {
+        auto result = decodePackedFixed32(data, length, values, kPackedDecodeBatchSize);
+        if (result.valuesCount == 0) {
+            break;
+        }
+        repeated->appendFixed32(values, result.valuesCount);
+        data += result.bytesRead;
+        length -= result.bytesRead;
     }
 }
 
@@ -3,7 +3,10 @@
 #include "utils/platform/BuildOptions.hpp"
 #include "valdi_core/cpp/Utils/Format.hpp"
 #include "valdi_core/cpp/Utils/LoggerUtils.hpp"
+#include "valdi_core/cpp/Utils/SmallVector.hpp"
 #include <algorithm>
+#include <cstring>
+#include <limits>
 
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/io/coded_stream.h>
@@ -27,8 +30,16 @@ public:
     }
 };
 
+static DefaultMessageFactory& getDefaultMessageFactory() {
+    // Static as it can be retained to postprocess the skipped fields later on
+    static DefaultMessageFactory kMessageFactory;
+    return kMessageFactory;
+}
+
 using WireType = google::protobuf::internal::WireFormatLite::WireType;
 
+static Valdi::ILogger* kLogger = nullptr;
+
 struct JSONHelper {
     std::string output;
     google::protobuf::io::ArrayInputStream inputStream;
@@ -66,14 +77,31 @@ BytesView Message::encode(bool includeEmptyFields) {
 }
 
 Byte* Message::encode(bool includeEmptyFields, Byte* bufferStart, Byte* bufferEnd) const {
+    // Fields skipped by the projection are written back as they were received, interleaved
+    // with the decoded fields so that the fields keep their original order
+    size_t skippedRangeIndex = 0;
+    auto writeSkippedRangesBefore = [&](FieldNumber fieldNumber) {
+        while (skippedRangeIndex < _skippedRanges.size() &&
+               _skippedRanges[skippedRangeIndex].fieldNumber < fieldNumber) {
+            const auto& skippedRange = _skippedRanges[skippedRangeIndex++];
+            SC_ASSERT(bufferStart + skippedRange.length <= bufferEnd);
+            std::memcpy(bufferStart, skippedRange.data, skippedRange.length);
+            bufferStart += skippedRange.length;
+        }
+    };
+
     _fieldMap.forEachSorted([&](const FieldMap::Entry& entry) {
+        writeSkippedRangesBefore(entry.number);
         bufferStart = entry.value->write(entry.number, includeEmptyFields, includeEmptyFields, bufferStart, bufferEnd);
     });
+
+    writeSkippedRangesBefore(std::numeric_limits<FieldNumber>::max());
+
     return bufferStart;
 }
 
 size_t Message::encodedByteSize(bool includeEmptyFields) {
-    size_t byteSize = 0;
+    size_t byteSize = getSkippedByteSize();
     _fieldMap.forEach([&](const FieldMap::Entry& entry) {
         byteSize += entry.value->byteSize(entry.number, includeEmptyFields, includeEmptyFields);
     });
@@ -88,7 +116,12 @@ size_t Message::getCachedEncodedByteSize() const {
 }
 
 void Message::appendField(FieldNumber fieldNumber, Field field) {
-    auto& it = getOrCreateField(fieldNumber);
+    decodeSkippedFieldsIfNeeded(fieldNumber);
+    appendDecodedField(fieldNumber, std::move(field));
+}
+
+void Message::appendDecodedField(FieldNumber fieldNumber, Field field) {
+    auto& it = _fieldMap[fieldNumber];
     if (it.isUnset()) {
         it = std::move(field);
     } else {
@@ -98,9 +131,12 @@ void Message::appendField(FieldNumber fieldNumber, Field field) {
 
 void Message::clearAllFields() {
     _fieldMap.clear();
+    _skippedRanges.clear();
+    _skippedFieldsMessageFactory = nullptr;
 }
 
 void Message::clearField(FieldNumber fieldNumber) {
+    decodeSkippedFieldsIfNeeded(fieldNumber);
     _fieldMap.erase(fieldNumber);
 }
 
@@ -137,10 +173,12 @@ const Field* Message::getFieldByName(std::string_view fieldName) const {
 }
 
 Field* Message::getField(FieldNumber fieldNumber) {
+    decodeSkippedFieldsIfNeeded(fieldNumber);
     return _fieldMap.find(fieldNumber);
 }
 
 Field& Message::getOrCreateField(FieldNumber fieldNumber) {
+    decodeSkippedFieldsIfNeeded(fieldNumber);
     return _fieldMap[fieldNumber];
 }
 
@@ -195,6 +233,81 @@ const google::protobuf::Descriptor* Message::getDescriptor() const {
     return _descriptor;
 }
 
+void Message::setProjection(const Ref<MessageProjection>& projection) {
+    decodeSkippedFields();
+    _projection = projection;
+}
+
+const Ref<MessageProjection>& Message::getProjection() const {
+    return _projection;
+}
+
+Ref<MessageProjection> Message::getNestedProjection(FieldNumber fieldNumber) const {
+    if (_projection == nullptr) {
+        return nullptr;
+    }
+    return _projection->getNestedProjection(fieldNumber);
+}
+
+size_t Message::getSkippedByteSize() const {
+    size_t byteSize = 0;
+    for (const auto& skippedRange : _skippedRanges) {
+        byteSize += skippedRange.length;
+    }
+    return byteSize;
+}
+
+void Message::decodeSkippedFields() {
+    if (_skippedRanges.empty()) {
+        return;
+    }
+
+    auto skippedRanges = std::move(_skippedRanges);
+    _skippedRanges.clear();
+
+    SimpleExceptionTracker exceptionTracker;
+    for (const auto& skippedRange : skippedRanges) {
+        // The ranges were already validated when they were skipped
+        decodeFields(skippedRange.data, skippedRange.length, nullptr, exceptionTracker);
+    }
+    SC_ASSERT(static_cast<bool>(exceptionTracker));
+
+    populateFieldFlags();
+
+    auto* messageFactory = _skippedFieldsMessageFactory;
+    _skippedFieldsMessageFactory = nullptr;
+    if (messageFactory == nullptr) {
+        return;
+    }
+
+    // The message was postprocessed before the skipped fields were decoded, apply the same
+    // postprocessing to them so that they look the same as the eagerly decoded fields.
+    // A repeated field can span multiple ranges, it should only be processed once.
+    SmallVector<FieldNumber, 8> fieldNumbers;
+    for (const auto& skippedRange : skippedRanges) {
+        if (std::find(fieldNumbers.begin(), fieldNumbers.end(), skippedRange.fieldNumber) == fieldNumbers.end()) {
+            fieldNumbers.emplace_back(skippedRange.fieldNumber);
+        }
+    }
+
+    for (auto fieldNumber : fieldNumbers) {
+        const auto* fieldDescriptor = _descriptor->FindFieldByNumber(static_cast<int>(fieldNumber));
+        if (fieldDescriptor == nullptr) {
+            // Unknown field, kept as is like in postprocess()
+            continue;
+        }
+        if (!postprocessField(
+                *fieldDescriptor, _skippedFieldsPostprocessedRecursively, *messageFactory, exceptionTracker)) {
+            // Leave the field in its decoded form, the error will be surfaced when it is accessed
+            auto error = exceptionTracker.extractError();
+            auto logger = Valdi::strongSmallRef(kLogger);
+            if (logger != nullptr) {
+                VALDI_WARN(*logger, "Failed to postprocess skipped field: {}", error);
+            }
+        }
+    }
+}
+
 std::string Message::toJSON(const JSONPrintOptions& options, ExceptionTracker& exceptionTracker) {
     if (_descriptor == nullptr) {
         exceptionTracker.onError("Cannot convert to JSON without a descriptor");
@@ -250,6 +363,13 @@ bool Message::decodeFromJSON(std::string_view json, ExceptionTracker& exceptionT
 Ref<Message> Message::clone() const {
     auto out = makeShared<Message>(_descriptor, _dataSource);
     out->_fieldMap = _fieldMap;
+    out->_projection = _projection;
+    out->_skippedRanges = _skippedRanges;
+    if (_skippedFieldsMessageFactory != nullptr) {
+        // The clone is not owned by the original factory
+        out->_skippedFieldsMessageFactory = &getDefaultMessageFactory();
+    }
+    out->_skippedFieldsPostprocessedRecursively = _skippedFieldsPostprocessedRecursively;
     _fieldMap.forEach([&](const auto& it) { out->_fieldMap[it.number] = it.value->clone(); });
 
     return out;
@@ -289,8 +409,6 @@ Result<Ref<Message>> Message::parseFromJSON(std::string_view json, const google:
     return exceptionTracker.toResult(parseFromJSON(json, descriptor, exceptionTracker));
 }
 
-static Valdi::ILogger* kLogger = nullptr;
-
 void Message::setLogger(Valdi::ILogger* logger) {
     Valdi::unsafeRelease(kLogger);
     kLogger = Valdi::unsafeRetain(logger);
@@ -316,9 +434,45 @@ bool Message::onDecodeError(
 }
 
 bool Message::decode(const Byte* data, size_t length, ExceptionTracker& exceptionTracker) {
+    if (!decodeFields(data, length, _projection.get(), exceptionTracker)) {
+        return false;
+    }
+
+    populateFieldFlags();
+
+    return true;
+}
+
+static bool skipField(google::protobuf::io::CodedInputStream& inputStream, WireType wireType) {
+    switch (wireType) {
+        case WireType::WIRETYPE_VARINT: {
+            uint64_t varint;
+            return inputStream.ReadVarint64(&varint);
+        }
+        case WireType::WIRETYPE_FIXED64:
+            return inputStream.Skip(8);
+        case WireType::WIRETYPE_LENGTH_DELIMITED: {
+            uint32_t innerLength;
+            if (!inputStream.ReadVarint32(&innerLength)) {
+                return false;
+            }
+            return inputStream.Skip(static_cast<int>(innerLength));
+        }
+        case WireType::WIRETYPE_FIXED32:
+            return inputStream.Skip(4);
+        default:
+            return false;
+    }
+}
+
+bool Message::decodeFields(const Byte* data,
+                           size_t length,
+                           const MessageProjection* projection,
+                           ExceptionTracker& exceptionTracker) {
     google::protobuf::io::CodedInputStream inputStream(data, static_cast<int>(length));
 
     for (;;) {
+        auto tagPosition = static_cast<size_t>(inputStream.CurrentPosition());
         auto tag = inputStream.ReadTag();
         if (tag == 0) {
             break;
@@ -326,6 +480,24 @@ bool Message::decode(const Byte* data, size_t length, ExceptionTracker& exceptio
         auto wireType = static_cast<WireType>(tag & 0x7);
         auto fieldNumber = static_cast<int>(tag >> 3);
 
+        if (projection != nullptr && !projection->includesField(static_cast<FieldNumber>(fieldNumber))) {
+            if (!skipField(inputStream, wireType)) {
+                return onDecodeError("Unable to skip field", fieldNumber, data, length, exceptionTracker);
+            }
+
+            const auto* rangeStart = &data[tagPosition];
+            auto rangeLength = static_cast<size_t>(inputStream.CurrentPosition()) - tagPosition;
+            if (!_skippedRanges.empty() && _skippedRanges.back().fieldNumber == fieldNumber &&
+                _skippedRanges.back().data + _skippedRanges.back().length == rangeStart) {
+                // Coalesce with the previous skipped range of the same field
+                _skippedRanges.back().length += rangeLength;
+            } else {
+                _skippedRanges.emplace_back(
+                    SkippedRange{static_cast<FieldNumber>(fieldNumber), rangeStart, rangeLength});
+            }
+            continue;
+        }
+
         switch (wireType) {
             case WireType::WIRETYPE_VARINT:
                 uint64_t varint;
@@ -333,7 +505,7 @@ bool Message::decode(const Byte* data, size_t length, ExceptionTracker& exceptio
                     return onDecodeError("Unable to read varint", fieldNumber, data, length, exceptionTracker);
                 }
 
-                appendField(fieldNumber, Field::varint(varint));
+                appendDecodedField(fieldNumber, Field::varint(varint));
                 break;
             case WireType::WIRETYPE_FIXED64:
                 uint64_t fixed64;
@@ -341,7 +513,7 @@ bool Message::decode(const Byte* data, size_t length, ExceptionTracker& exceptio
                     return onDecodeError("Unable to read fixed64", fieldNumber, data, length, exceptionTracker);
                 }
 
-                appendField(fieldNumber, Field::fixed64(fixed64));
+                appendDecodedField(fieldNumber, Field::fixed64(fixed64));
                 break;
             case WireType::WIRETYPE_LENGTH_DELIMITED: {
                 uint32_t innerLength;
@@ -362,9 +534,10 @@ bool Message::decode(const Byte* data, size_t length, ExceptionTracker& exceptio
                             "Out of bounds length delimited", fieldNumber, data, length, exceptionTracker);
                     }
 
-                    appendField(fieldNumber, Field::raw(reinterpret_cast<const Byte*>(dataPtr), innerLength));
+                    appendDecodedField(fieldNumber, Field::raw(reinterpret_cast<const Byte*>(dataPtr), innerLength));
                 } else {
-                    appendField(fieldNumber, Field::raw(&data[static_cast<size_t>(inputStream.CurrentPosition())], 0));
+                    appendDecodedField(fieldNumber,
+                                       Field::raw(&data[static_cast<size_t>(inputStream.CurrentPosition())], 0));
                 }
             } break;
             case WireType::WIRETYPE_START_GROUP:
@@ -376,7 +549,7 @@ bool Message::decode(const Byte* data, size_t length, ExceptionTracker& exceptio
                     return onDecodeError("Unable to read fixed32", fieldNumber, data, length, exceptionTracker);
                 }
 
-                appendField(fieldNumber, Field::fixed32(fixed32));
+                appendDecodedField(fieldNumber, Field::fixed32(fixed32));
                 break;
             default:
                 return onDecodeError("Unsupported wiretype", fieldNumber, data, length, exceptionTracker);
@@ -388,8 +561,6 @@ bool Message::decode(const Byte* data, size_t length, ExceptionTracker& exceptio
         return false;
     }
 
-    populateFieldFlags();
-
     return true;
 }
 
@@ -431,6 +602,7 @@ bool Message::postprocessForField(const google::protobuf::FieldDescriptor& field
         if (internalFieldType == Field::InternalType::Raw) {
             auto raw = fieldValue.getRaw();
             auto childMessage = messageFactory.newMessage(fieldDescriptor.message_type(), _dataSource);
+            childMessage->setProjection(getNestedProjection(static_cast<FieldNumber>(fieldDescriptor.number())));
             if (!childMessage->decode(raw.data, raw.length, exceptionTracker)) {
                 return onPopulateFieldError(fieldDescriptor, "Failed to decode", exceptionTracker);
             }
@@ -471,8 +643,7 @@ bool Message::postprocessForField(const google::protobuf::FieldDescriptor& field
 }
 
 bool Message::postprocess(bool recursive, ExceptionTracker& exceptionTracker) {
-    DefaultMessageFactory messageFactory;
-    return postprocess(recursive, messageFactory, exceptionTracker);
+    return postprocess(recursive, getDefaultMessageFactory(), exceptionTracker);
 }
 
 bool Message::postprocess(bool recursive, IMessageFactory& messageFactory, ExceptionTracker& exceptionTracker) {
@@ -481,38 +652,59 @@ bool Message::postprocess(bool recursive, IMessageFactory& messageFactory, Excep
         return false;
     }
 
+    if (!_skippedRanges.empty()) {
+        _skippedFieldsMessageFactory = &messageFactory;
+        _skippedFieldsPostprocessedRecursively = recursive;
+    }
+
     auto fieldCount = _descriptor->field_count();
     for (int i = 0; i < fieldCount; i++) {
-        const auto& fieldDescriptor = *_descriptor->field(i);
-        auto isRepeated = fieldDescriptor.is_repeated();
-        auto isMessage = fieldDescriptor.cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE;
-        if (!(isRepeated || isMessage)) {
-            // Standard field that doesn't need to be processed
-            continue;
+        if (!postprocessField(*_descriptor->field(i), recursive, messageFactory, exceptionTracker)) {
+            return false;
         }
+    }
 
-        auto* it = _fieldMap.find(static_cast<size_t>(fieldDescriptor.number()));
-        if (it == nullptr) {
-            continue;
-        }
+    return true;
+}
 
-        auto& fieldValue = *it;
+void Message::setSkippedFieldsMessageFactory(IMessageFactory* messageFactory) {
+    if (_skippedFieldsMessageFactory != nullptr) {
+        _skippedFieldsMessageFactory = messageFactory;
+    }
+}
 
-        if (isRepeated) {
-            auto* repeated = fieldValue.toRepeated(fieldDescriptor);
+bool Message::postprocessField(const google::protobuf::FieldDescriptor& fieldDescriptor,
+                               bool recursive,
+                               IMessageFactory& messageFactory,
+                               ExceptionTracker& exceptionTracker) {
+    auto isRepeated = fieldDescriptor.is_repeated();
+    auto isMessage = fieldDescriptor.cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE;
+    if (!(isRepeated || isMessage)) {
+        // Standard field that doesn't need to be processed
+        return true;
+    }
 
-            if (isMessage) {
-                for (auto& repeatedFieldValue : *repeated) {
-                    if (!postprocessForField(
-                            fieldDescriptor, repeatedFieldValue, recursive, messageFactory, exceptionTracker)) {
-                        return false;
-                    }
+    auto* it = _fieldMap.find(static_cast<size_t>(fieldDescriptor.number()));
+    if (it == nullptr) {
+        return true;
+    }
+
+    auto& fieldValue = *it;
+
+    if (isRepeated) {
+        auto* repeated = fieldValue.toRepeated(fieldDescriptor);
+
+        if (isMessage) {
+            for (auto& repeatedFieldValue : *repeated) {
+                if (!postprocessForField(
+                        fieldDescriptor, repeatedFieldValue, recursive, messageFactory, exceptionTracker)) {
+                    return false;
                 }
             }
-        } else {
-            if (!postprocessForField(fieldDescriptor, fieldValue, recursive, messageFactory, exceptionTracker)) {
-                return false;
-            }
+        }
+    } else {
+        if (!postprocessForField(fieldDescriptor, fieldValue, recursive, messageFactory, exceptionTracker)) {
+            return false;
         }
     }
 
@@ -9,6 +9,7 @@
 #include "valdi_protobuf/Field.hpp"
 #include "valdi_protobuf/FieldMap.hpp"
 #include "valdi_protobuf/FieldNumber.hpp"
+#include "valdi_protobuf/MessageProjection.hpp"
 #include "valdi_protobuf/RepeatedField.hpp"
 #include "valdi_protobuf/RepeatedFieldIterator.hpp"
 
@@ -69,10 +70,19 @@ public:
     void appendField(FieldNumber fieldNumber, Field field);
     void clearField(FieldNumber fieldNumber);
 
+    /**
+     Returns the field numbers of the decoded fields, which excludes fields
+     that were skipped because of the projection.
+     */
     std::vector<FieldNumber> sortedFieldNumbers() const;
 
     std::optional<FieldNumber> getFieldNumberForName(std::string_view fieldName) const;
 
+    /**
+     Mutable accessors will decode the fields that were skipped because of the projection
+     when the requested field is not part of it. The const accessors only return fields
+     that were decoded.
+     */
     Field* getFieldByName(std::string_view fieldName);
     Field* getField(FieldNumber fieldNumber);
     Field& getOrCreateField(FieldNumber fieldNumber);
@@ -88,6 +98,24 @@ public:
 
     const Ref<RefCountable>& getDataSource() const;
 
+    /**
+     Set the projection to apply on the next decode() call. Fields outside of the projection
+     will be kept as raw byte ranges until they are accessed through a mutable accessor.
+     */
+    void setProjection(const Ref<MessageProjection>& projection);
+    const Ref<MessageProjection>& getProjection() const;
+
+    /**
+     Returns the projection to apply when decoding the nested message at the given field.
+     */
+    Ref<MessageProjection> getNestedProjection(FieldNumber fieldNumber) const;
+
+    /**
+     Returns the number of bytes that were skipped during decode because of the projection
+     and that have not been decoded since.
+     */
+    size_t getSkippedByteSize() const;
+
     /**
      Postprocess will validate the parsed Message and transform Message fields from raw bytes into Message objects.
      If recursive is true, nested messages will also be postprocessed.
@@ -100,6 +128,13 @@ public:
      */
     bool postprocess(bool recursive, ExceptionTracker& exceptionTracker);
 
+    /**
+     Replaces the message factory used to postprocess the fields skipped by the projection once they
+     get decoded. Should be called when the factory given to postprocess() won't outlive the message,
+     nullptr leaves the skipped fields unprocessed. Does nothing if the message has no pending skipped fields.
+     */
+    void setSkippedFieldsMessageFactory(IMessageFactory* messageFactory);
+
     const google::protobuf::Descriptor* getDescriptor() const;
 
     std::string toJSON(const JSONPrintOptions& options, ExceptionTracker& exceptionTracker);
@@ -121,15 +156,49 @@ private:
     const google::protobuf::Descriptor* _descriptor = nullptr;
     Ref<RefCountable> _dataSource;
     FieldMap _fieldMap;
+    Ref<MessageProjection> _projection;
+    struct SkippedRange {
+        // Number of the field of the range, used to write the range back in place
+        FieldNumber fieldNumber;
+        const Byte* data;
+        size_t length;
+    };
+
+    // Wire ranges of the fields which were skipped because of the projection, one per field
+    std::vector<SkippedRange> _skippedRanges;
+    // Set when the message was postprocessed while it had skipped ranges, the skipped fields
+    // are postprocessed with it once they get decoded. The factory must outlive the message.
+    IMessageFactory* _skippedFieldsMessageFactory = nullptr;
+    bool _skippedFieldsPostprocessedRecursively = false;
     size_t _cachedEncodedByteSize = 0;
 
     friend Message;
 
+    bool decodeFields(const Byte* data,
+                      size_t length,
+                      const MessageProjection* projection,
+                      ExceptionTracker& exceptionTracker);
+
+    void appendDecodedField(FieldNumber fieldNumber, Field field);
+
+    inline void decodeSkippedFieldsIfNeeded(FieldNumber fieldNumber) {
+        if (VALDI_UNLIKELY(!_skippedRanges.empty()) && !_projection->includesField(fieldNumber)) {
+            decodeSkippedFields();
+        }
+    }
+
+    void decodeSkippedFields();
+
     bool populateFieldFlags();
 
     bool onDecodeError(
         std::string_view message, int fieldNumber, const Byte* data, size_t length, ExceptionTracker& exceptionTracker);
 
+    bool postprocessField(const google::protobuf::FieldDescriptor& fieldDescriptor,
+                          bool recursive,
+                          IMessageFactory& messageFactory,
+                          ExceptionTracker& exceptionTracker);
+
     bool postprocessForField(const google::protobuf::FieldDescriptor& fieldDescriptor,
                              Field& fieldValue,
                              bool recursive,
@@ -0,0 +1,83 @@
+#include "valdi_protobuf/MessageProjection.hpp"
+#include "valdi_core/cpp/Utils/Format.hpp"
+#include "valdi_core/cpp/Utils/StringCache.hpp"
+
+#include <google/protobuf/descriptor.h>
+
+namespace Valdi::Protobuf {
+
+MessageProjection::MessageProjection() = default;
+MessageProjection::~MessageProjection() = default;
+
+void MessageProjection::addField(FieldNumber fieldNumber, const Ref<MessageProjection>& nestedProjection) {
+    if (fieldNumber < kMaxMaskFieldNumber) {
+        _fieldsMask |= static_cast<uint64_t>(1) << fieldNumber;
+    }
+    _nestedProjections[fieldNumber] = nestedProjection;
+}
+
+const Ref<MessageProjection>& MessageProjection::getNestedProjection(FieldNumber fieldNumber) const {
+    static const Ref<MessageProjection> kNoProjection;
+
+    const auto& it = _nestedProjections.find(fieldNumber);
+    if (it == _nestedProjections.end()) {
+        return kNoProjection;
+    }
+    return it->second;
+}
+
+Result<Void> MessageProjection::addFieldPath(const google::protobuf::Descriptor* descriptor,
+                                             std::string_view fieldPath) {
+    auto dotIndex = fieldPath.find('.');
+    auto fieldName = fieldPath.substr(0, dotIndex);
+
+    const auto* fieldDescriptor = descriptor->FindFieldByName(std::string(fieldName));
+    if (fieldDescriptor == nullptr) {
+        return Error(STRING_FORMAT("Unknown field '{}' in message type '{}'", fieldName, descriptor->full_name()));
+    }
+
+    auto fieldNumber = static_cast<FieldNumber>(fieldDescriptor->number());
+
+    if (dotIndex == std::string_view::npos) {
+        // The whole field is requested, which overrides any previously set nested projection
+        addField(fieldNumber, nullptr);
+        return Void();
+    }
+
+    if (fieldDescriptor->message_type() == nullptr) {
+        return Error(STRING_FORMAT(
+            "Field '{}' in message type '{}' is not a message", fieldName, descriptor->full_name()));
+    }
+
+    auto nestedProjection = getNestedProjection(fieldNumber);
+    if (includesField(fieldNumber) && nestedProjection == nullptr) {
+        // Field was already fully requested
+        return Void();
+    }
+
+    if (nestedProjection == nullptr) {
+        nestedProjection = makeShared<MessageProjection>();
+        addField(fieldNumber, nestedProjection);
+    }
+
+    return nestedProjection->addFieldPath(fieldDescriptor->message_type(), fieldPath.substr(dotIndex + 1));
+}
+
+Result<Ref<MessageProjection>> MessageProjection::fromFieldPaths(const google::protobuf::Descriptor* descriptor,
+                                                                 const std::vector<std::string_view>& fieldPaths) {
+    if (descriptor == nullptr) {
+        return Error("Cannot create a MessageProjection without a descriptor");
+    }
+
+    auto projection = makeShared<MessageProjection>();
+    for (const auto& fieldPath : fieldPaths) {
+        auto result = projection->addFieldPath(descriptor, fieldPath);
+        if (!result) {
+            return result.moveError();
+        }
+    }
+
+    return projection;
+}
+
+} // namespace Valdi::Protobuf
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "valdi_core/cpp/Utils/FlatMap.hpp"
+#include "valdi_core/cpp/Utils/Result.hpp"
+#include "valdi_core/cpp/Utils/Shared.hpp"
+#include "valdi_protobuf/FieldNumber.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace google::protobuf {
+class Descriptor;
+} // namespace google::protobuf
+
+namespace Valdi::Protobuf {
+
+/**
+ A MessageProjection describes the subset of fields of a Message type that a caller
+ intends to read. When set on a Message before decoding, fields that are not part of
+ the projection are skipped at the wire level: they are not tokenized into the FieldMap
+ and are instead kept as raw byte ranges, which are written back verbatim on encode.
+
+ Each projected field can itself hold a nested projection, which will be applied
+ when the field is decoded as a Message. A projected field without a nested
+ projection is decoded entirely.
+ */
+class MessageProjection : public SimpleRefCountable {
+public:
+    MessageProjection();
+    ~MessageProjection() override;
+
+    /**
+     Add the given field to the projection. If nestedProjection is null,
+     the whole field will be decoded.
+     */
+    void addField(FieldNumber fieldNumber, const Ref<MessageProjection>& nestedProjection);
+
+    inline bool includesField(FieldNumber fieldNumber) const {
+        if (fieldNumber < kMaxMaskFieldNumber) {
+            return (_fieldsMask & (static_cast<uint64_t>(1) << fieldNumber)) != 0;
+        }
+        return _nestedProjections.find(fieldNumber) != _nestedProjections.end();
+    }
+
+    /**
+     Returns the projection to apply to the nested message at the given field,
+     or null if the nested message should be decoded entirely.
+     */
+    const Ref<MessageProjection>& getNestedProjection(FieldNumber fieldNumber) const;
+
+    /**
+     Build a projection from a list of dot separated field paths, like
+     "items.id" or "title", resolved against the given descriptor.
+     */
+    static Result<Ref<MessageProjection>> fromFieldPaths(const google::protobuf::Descriptor* descriptor,
+                                                         const std::vector<std::string_view>& fieldPaths);
+
+private:
+    static constexpr FieldNumber kMaxMaskFieldNumber = 64;
+
+    uint64_t _fieldsMask = 0;
+    FlatMap<FieldNumber, Ref<MessageProjection>> _nestedProjections;
+
+    Result<Void> addFieldPath(const google::protobuf::Descriptor* descriptor, std::string_view fieldPath);
+};
+
+} // namespace Valdi::Protobuf
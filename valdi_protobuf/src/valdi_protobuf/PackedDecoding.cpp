@@ -0,0 +1,277 @@
+#include "valdi_protobuf/PackedDecoding.hpp"
+#include "valdi_core/cpp/Constants.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define VALDI_PROTOBUF_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define VALDI_PROTOBUF_X86_KERNELS 0
+#endif
+
+namespace Valdi::Protobuf {
+
+static constexpr size_t kMaxVarintLength = 10;
+
+template<typename T>
+static inline T loadLittleEndian(const Byte* data) {
+    T value;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    std::memcpy(&value, data, sizeof(value));
+#else
+    value = 0;
+    for (size_t i = 0; i < sizeof(value); i++) {
+        value |= static_cast<T>(data[i]) << (i * 8);
+    }
+#endif
+    return value;
+}
+
+static inline bool decodeVarint(const Byte*& current, const Byte* end, uint64_t& output) {
+    const auto* it = current;
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 64 && it < end; shift += 7) {
+        auto byte = *it++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            output = value;
+            current = it;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+PackedDecodeResult decodePackedVarintsScalar(const Byte* data,
+                                             size_t length,
+                                             uint64_t* output,
+                                             size_t outputCapacity) {
+    const auto* current = data;
+    const auto* end = data + length;
+    size_t count = 0;
+
+    while (count < outputCapacity && decodeVarint(current, end, output[count])) {
+        count++;
+    }
+
+    return PackedDecodeResult{count, static_cast<size_t>(current - data)};
+}
+
+size_t countPackedVarints(const Byte* data, size_t length) {
+    // Every varint ends with exactly one byte which does not have the continuation bit
+    static constexpr uint64_t kContinuationBits = 0x8080808080808080ULL;
+
+    size_t continuationBytes = 0;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+        auto continuationBits = loadLittleEndian<uint64_t>(data + i) & kContinuationBits;
+        continuationBytes += static_cast<size_t>(__builtin_popcountll(continuationBits));
+    }
+    for (; i < length; i++) {
+        continuationBytes += (data[i] >> 7);
+    }
+
+    return length - continuationBytes;
+}
+
+#if VALDI_PROTOBUF_X86_KERNELS
+
+/**
+ Given the 8 bytes of a varint of at most 8 bytes, with the bytes past the varint cleared,
+ remove the continuation bits and pack the 7 bits groups together.
+ */
+static inline uint64_t compactVarintBytes(uint64_t bytes) {
+    bytes = (bytes & 0x007f007f007f007fULL) | ((bytes & 0x7f007f007f007f00ULL) >> 1);
+    bytes = (bytes & 0x00003fff00003fffULL) | ((bytes & 0x3fff00003fff0000ULL) >> 2);
+    bytes = (bytes & 0x000000000fffffffULL) | ((bytes & 0x0fffffff00000000ULL) >> 4);
+    return bytes;
+}
+
+/**
+ Decode the varints ending within a chunk, using the positions of the bytes
+ without continuation bit computed by the SIMD kernel. At least 8 readable bytes
+ must be available past the chunk. Returns the number of bytes consumed, or 0
+ if the chunk contains a malformed varint.
+ */
+static inline size_t decodeVarintsInChunk(const Byte* chunk,
+                                          uint32_t terminators,
+                                          uint64_t* output,
+                                          size_t& count,
+                                          size_t outputCapacity) {
+    size_t offset = 0;
+
+    while (terminators != 0 && count < outputCapacity) {
+        auto end = static_cast<size_t>(__builtin_ctz(terminators)) + 1;
+        auto varintLength = end - offset;
+
+        if (VALDI_LIKELY(varintLength <= sizeof(uint64_t))) {
+            auto bytes = loadLittleEndian<uint64_t>(chunk + offset);
+            if (varintLength < sizeof(uint64_t)) {
+                bytes &= (static_cast<uint64_t>(1) << (varintLength * 8)) - 1;
+            }
+            output[count++] = compactVarintBytes(bytes);
+        } else {
+            if (varintLength > kMaxVarintLength) {
+                break;
+            }
+            const auto* current = chunk + offset;
+            decodeVarint(current, chunk + end, output[count++]);
+        }
+
+        offset = end;
+        terminators &= terminators - 1;
+    }
+
+    return offset;
+}
+
+__attribute__((target("sse4.1"))) static PackedDecodeResult decodePackedVarintsSSE41(const Byte* data,
+                                                                                    size_t length,
+                                                                                    uint64_t* output,
+                                                                                    size_t outputCapacity) {
+    static constexpr size_t kChunkSize = 16;
+
+    const auto* current = data;
+    const auto* end = data + length;
+    size_t count = 0;
+
+    while (static_cast<size_t>(end - current) >= kChunkSize + sizeof(uint64_t) && count < outputCapacity) {
+        auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(current));
+        auto continuationMask = static_cast<uint32_t>(_mm_movemask_epi8(chunk));
+
+        if (continuationMask == 0 && outputCapacity - count >= kChunkSize) {
+            // Fast path: a run of single byte varints, zero extend them all
+            auto* out = reinterpret_cast<__m128i*>(output + count);
+            _mm_storeu_si128(out, _mm_cvtepu8_epi64(chunk));
+            _mm_storeu_si128(out + 1, _mm_cvtepu8_epi64(_mm_srli_si128(chunk, 2)));
+            _mm_storeu_si128(out + 2, _mm_cvtepu8_epi64(_mm_srli_si128(chunk, 4)));
+            _mm_storeu_si128(out + 3, _mm_cvtepu8_epi64(_mm_srli_si128(chunk, 6)));
+            _mm_storeu_si128(out + 4, _mm_cvtepu8_epi64(_mm_srli_si128(chunk, 8)));
+            _mm_storeu_si128(out + 5, _mm_cvtepu8_epi64(_mm_srli_si128(chunk, 10)));
+            _mm_storeu_si128(out + 6, _mm_cvtepu8_epi64(_mm_srli_si128(chunk, 12)));
+            _mm_storeu_si128(out + 7, _mm_cvtepu8_epi64(_mm_srli_si128(chunk, 14)));
+            count += kChunkSize;
+            current += kChunkSize;
+            continue;
+        }
+
+        auto consumed = decodeVarintsInChunk(current, ~continuationMask & 0xffff, output, count, outputCapacity);
+        if (consumed == 0) {
+            return PackedDecodeResult{count, static_cast<size_t>(current - data)};
+        }
+        current += consumed;
+    }
+
+    auto result = decodePackedVarintsScalar(
+        current, static_cast<size_t>(end - current), output + count, outputCapacity - count);
+    return PackedDecodeResult{count + result.valuesCount, static_cast<size_t>(current - data) + result.bytesRead};
+}
+
+__attribute__((target("avx2"))) static PackedDecodeResult decodePackedVarintsAVX2(const Byte* data,
+                                                                                 size_t length,
+                                                                                 uint64_t* output,
+                                                                                 size_t outputCapacity) {
+    static constexpr size_t kChunkSize = 32;
+
+    const auto* current = data;
+    const auto* end = data + length;
+    size_t count = 0;
+
+    while (static_cast<size_t>(end - current) >= kChunkSize + sizeof(uint64_t) && count < outputCapacity) {
+        auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(current));
+        auto continuationMask = static_cast<uint32_t>(_mm256_movemask_epi8(chunk));
+
+        if (continuationMask == 0 && outputCapacity - count >= kChunkSize) {
+            // Fast path: a run of single byte varints, zero extend them all
+            auto low = _mm256_castsi256_si128(chunk);
+            auto high = _mm256_extracti128_si256(chunk, 1);
+            auto* out = reinterpret_cast<__m256i*>(output + count);
+            _mm256_storeu_si256(out, _mm256_cvtepu8_epi64(low));
+            _mm256_storeu_si256(out + 1, _mm256_cvtepu8_epi64(_mm_srli_si128(low, 4)));
+            _mm256_storeu_si256(out + 2, _mm256_cvtepu8_epi64(_mm_srli_si128(low, 8)));
+            _mm256_storeu_si256(out + 3, _mm256_cvtepu8_epi64(_mm_srli_si128(low, 12)));
+            _mm256_storeu_si256(out + 4, _mm256_cvtepu8_epi64(high));
+            _mm256_storeu_si256(out + 5, _mm256_cvtepu8_epi64(_mm_srli_si128(high, 4)));
+            _mm256_storeu_si256(out + 6, _mm256_cvtepu8_epi64(_mm_srli_si128(high, 8)));
+            _mm256_storeu_si256(out + 7, _mm256_cvtepu8_epi64(_mm_srli_si128(high, 12)));
+            count += kChunkSize;
+            current += kChunkSize;
+            continue;
+        }
+
+        auto consumed = decodeVarintsInChunk(current, ~continuationMask, output, count, outputCapacity);
+        if (consumed == 0) {
+            return PackedDecodeResult{count, static_cast<size_t>(current - data)};
+        }
+        current += consumed;
+    }
+
+    auto result = decodePackedVarintsScalar(
+        current, static_cast<size_t>(end - current), output + count, outputCapacity - count);
+    return PackedDecodeResult{count + result.valuesCount, static_cast<size_t>(current - data) + result.bytesRead};
+}
+
+#endif
+
+using PackedVarintsDecoder = PackedDecodeResult (*)(const Byte*, size_t, uint64_t*, size_t);
+
+struct PackedVarintsDecoderEntry {
+    PackedVarintsDecoder decoder;
+    const char* name;
+};
+
+static PackedVarintsDecoderEntry resolvePackedVarintsDecoder() {
+#if VALDI_PROTOBUF_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return PackedVarintsDecoderEntry{&decodePackedVarintsAVX2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return PackedVarintsDecoderEntry{&decodePackedVarintsSSE41, "sse4.1"};
+    }
+#endif
+    return PackedVarintsDecoderEntry{&decodePackedVarintsScalar, "scalar"};
+}
+
+static const PackedVarintsDecoderEntry& getPackedVarintsDecoder() {
+    static const auto kEntry = resolvePackedVarintsDecoder();
+    return kEntry;
+}
+
+PackedDecodeResult decodePackedVarints(const Byte* data, size_t length, uint64_t* output, size_t outputCapacity) {
+    return getPackedVarintsDecoder().decoder(data, length, output, outputCapacity);
+}
+
+const char* getPackedVarintsDecoderName() {
+    return getPackedVarintsDecoder().name;
+}
+
+PackedDecodeResult decodePackedFixed32(const Byte* data, size_t length, uint32_t* output, size_t outputCapacity) {
+    auto count = std::min(length / sizeof(uint32_t), outputCapacity);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // The wire format matches the memory layout, which lets memcpy use wide vector moves
+    std::memcpy(output, data, count * sizeof(uint32_t));
+#else
+    for (size_t i = 0; i < count; i++) {
+        output[i] = loadLittleEndian<uint32_t>(data + i * sizeof(uint32_t));
+    }
+#endif
+    return PackedDecodeResult{count, count * sizeof(uint32_t)};
+}
+
+PackedDecodeResult decodePackedFixed64(const Byte* data, size_t length, uint64_t* output, size_t outputCapacity) {
+    auto count = std::min(length / sizeof(uint64_t), outputCapacity);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    std::memcpy(output, data, count * sizeof(uint64_t));
+#else
+    for (size_t i = 0; i < count; i++) {
+        output[i] = loadLittleEndian<uint64_t>(data + i * sizeof(uint64_t));
+    }
+#endif
+    return PackedDecodeResult{count, count * sizeof(uint64_t)};
+}
+
+} // namespace Valdi::Protobuf
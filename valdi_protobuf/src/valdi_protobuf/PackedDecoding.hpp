@@ -0,0 +1,49 @@
+#pragma once
+
+#include "valdi_core/cpp/Utils/Bytes.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Valdi::Protobuf {
+
+struct PackedDecodeResult {
+    size_t valuesCount = 0;
+    size_t bytesRead = 0;
+};
+
+/**
+ Decoding kernels for packed repeated scalars.
+ The varint decoder uses SSE4.1 or AVX2 when the CPU supports them, selected
+ once at runtime, and a portable scalar implementation otherwise.
+ */
+
+/**
+ Returns the number of complete varints contained in the given packed varint run.
+ */
+size_t countPackedVarints(const Byte* data, size_t length);
+
+/**
+ Decode up to outputCapacity varints from the given packed varint run into output.
+ Decoding stops early on a truncated or malformed varint. The result holds the number of
+ decoded values and the number of bytes that were consumed.
+ */
+PackedDecodeResult decodePackedVarints(const Byte* data, size_t length, uint64_t* output, size_t outputCapacity);
+
+/**
+ Same as decodePackedVarints(), but always uses the portable scalar implementation.
+ */
+PackedDecodeResult decodePackedVarintsScalar(const Byte* data,
+                                             size_t length,
+                                             uint64_t* output,
+                                             size_t outputCapacity);
+
+/**
+ Returns the name of the varint decoding kernel selected for this CPU.
+ */
+const char* getPackedVarintsDecoderName();
+
+PackedDecodeResult decodePackedFixed32(const Byte* data, size_t length, uint32_t* output, size_t outputCapacity);
+PackedDecodeResult decodePackedFixed64(const Byte* data, size_t length, uint64_t* output, size_t outputCapacity);
+
+} // namespace Valdi::Protobuf
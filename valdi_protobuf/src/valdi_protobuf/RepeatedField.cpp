@@ -54,6 +54,33 @@ Field& RepeatedField::append() {
     return _values.emplace_back();
 }
 
+void RepeatedField::appendVarints(const uint64_t* values, size_t count) {
+    auto offset = _values.size();
+    _values.resize(offset + count);
+    auto* output = _values.data() + offset;
+    for (size_t i = 0; i < count; i++) {
+        output[i].setUInt64(values[i]);
+    }
+}
+
+void RepeatedField::appendFixed64(const uint64_t* values, size_t count) {
+    auto offset = _values.size();
+    _values.resize(offset + count);
+    auto* output = _values.data() + offset;
+    for (size_t i = 0; i < count; i++) {
+        output[i].setFixed64(values[i]);
+    }
+}
+
+void RepeatedField::appendFixed32(const uint32_t* values, size_t count) {
+    auto offset = _values.size();
+    _values.resize(offset + count);
+    auto* output = _values.data() + offset;
+    for (size_t i = 0; i < count; i++) {
+        output[i].setFixed32(values[i]);
+    }
+}
+
 const Field* RepeatedField::begin() const {
     return &_values[0];
 }
@@ -24,6 +24,13 @@ public:
     void append(const Field& field);
     Field& append();
 
+    /**
+     Bulk append decoded values, which avoids growing the storage one Field at a time.
+     */
+    void appendVarints(const uint64_t* values, size_t count);
+    void appendFixed64(const uint64_t* values, size_t count);
+    void appendFixed32(const uint32_t* values, size_t count);
+
     const Field& operator[](size_t i) const;
     Field& operator[](size_t i);
 
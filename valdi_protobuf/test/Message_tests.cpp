@@ -176,6 +176,106 @@ TEST(Message, canDecodeNested) {
     ASSERT_EQ("Hello World!", parsedOtherMessage->getOrCreateField(1).getRaw().toStringView());
 }
 
+TEST(Message, decodesOnlyProjectedFields) {
+    test::Message message;
+
+    message.set_int32(-42);
+    message.set_int64(-1337133713371337);
+    message.set_string("Hello");
+    message.set_fixed32(42);
+    message.mutable_other_message()->set_value("Hello World!");
+    message.mutable_self_message()->set_int32(7);
+    message.mutable_self_message()->set_string("Nested");
+
+    auto encoded = message.SerializeAsString();
+    auto buffer = makeShared<ByteBuffer>(encoded);
+
+    auto projection =
+        Protobuf::MessageProjection::fromFieldPaths(message.GetDescriptor(), {"int64", "self_message.string"});
+    ASSERT_TRUE(projection) << projection.description();
+
+    SimpleExceptionTracker exceptionTracker;
+    auto parsedMessage = makeShared<Protobuf::Message>(message.GetDescriptor(), buffer);
+    parsedMessage->setProjection(projection.value());
+    ASSERT_TRUE(parsedMessage->decode(buffer->data(), buffer->size(), exceptionTracker));
+
+    ASSERT_EQ(std::vector<Protobuf::FieldNumber>({2, 17}), parsedMessage->sortedFieldNumbers());
+    ASSERT_EQ(-1337133713371337, parsedMessage->getOrCreateField(2).getInt64());
+    ASSERT_TRUE(parsedMessage->getSkippedByteSize() > 0);
+
+    ASSERT_TRUE(parsedMessage->postprocess(true, exceptionTracker));
+
+    auto* parsedSelfMessage = parsedMessage->getOrCreateField(17).getMessage();
+    ASSERT_TRUE(parsedSelfMessage != nullptr);
+    ASSERT_EQ(std::vector<Protobuf::FieldNumber>({14}), parsedSelfMessage->sortedFieldNumbers());
+    ASSERT_EQ("Nested", parsedSelfMessage->getFieldAsString(14));
+
+    // Skipped fields should be re-encoded as they were received and at their original position
+    auto reencoded = parsedMessage->encode();
+    ASSERT_EQ(encoded, std::string(reinterpret_cast<const char*>(reencoded.data()), reencoded.size()));
+
+    // Accessing a field outside of the projection decodes the skipped fields
+    ASSERT_EQ(-42, parsedMessage->getOrCreateField(1).getInt32());
+    ASSERT_EQ(static_cast<size_t>(0), parsedMessage->getSkippedByteSize());
+    ASSERT_EQ(std::vector<Protobuf::FieldNumber>({1, 2, 7, 14, 17, 18}), parsedMessage->sortedFieldNumbers());
+    ASSERT_EQ("Hello", parsedMessage->getFieldAsString(14));
+}
+
+TEST(Message, postprocessesSkippedFieldsWhenDecoded) {
+    test::RepeatedMessage message;
+    message.add_int64(42);
+    message.add_string("Hello");
+    message.add_self_message()->add_int32(1);
+    message.add_self_message()->add_int32(2);
+    message.add_other_message()->set_value("Hello World!");
+
+    auto encoded = message.SerializeAsString();
+    auto buffer = makeShared<ByteBuffer>(encoded);
+
+    auto projection = Protobuf::MessageProjection::fromFieldPaths(message.GetDescriptor(), {"int64"});
+    ASSERT_TRUE(projection) << projection.description();
+
+    SimpleExceptionTracker exceptionTracker;
+    auto parsedMessage = makeShared<Protobuf::Message>(message.GetDescriptor(), buffer);
+    parsedMessage->setProjection(projection.value());
+    ASSERT_TRUE(parsedMessage->decode(buffer->data(), buffer->size(), exceptionTracker));
+    ASSERT_TRUE(parsedMessage->postprocess(true, exceptionTracker));
+
+    // Accessing a skipped field should give the same result as if it was decoded eagerly
+    auto* otherMessages = parsedMessage->getOrCreateField(18).getRepeated();
+    ASSERT_TRUE(otherMessages != nullptr);
+    ASSERT_EQ(static_cast<size_t>(1), otherMessages->size());
+    auto* otherMessage = (*otherMessages)[0].getMessage();
+    ASSERT_TRUE(otherMessage != nullptr);
+    ASSERT_EQ("Hello World!", otherMessage->getFieldAsString(1));
+
+    auto* selfMessages = parsedMessage->getOrCreateField(17).getRepeated();
+    ASSERT_TRUE(selfMessages != nullptr);
+    ASSERT_EQ(static_cast<size_t>(2), selfMessages->size());
+    for (size_t i = 0; i < selfMessages->size(); i++) {
+        auto* selfMessage = (*selfMessages)[i].getMessage();
+        ASSERT_TRUE(selfMessage != nullptr);
+        auto* int32s = selfMessage->getOrCreateField(1).getRepeated();
+        ASSERT_TRUE(int32s != nullptr);
+        ASSERT_EQ(static_cast<int32_t>(i + 1), (*int32s)[0].getInt32());
+    }
+
+    auto* strings = parsedMessage->getOrCreateField(14).getRepeated();
+    ASSERT_TRUE(strings != nullptr);
+    ASSERT_EQ(static_cast<size_t>(1), strings->size());
+
+    auto reencoded = parsedMessage->encode();
+    ASSERT_EQ(encoded, std::string(reinterpret_cast<const char*>(reencoded.data()), reencoded.size()));
+}
+
+TEST(Message, failsToCreateProjectionWithUnknownField) {
+    auto projection = Protobuf::MessageProjection::fromFieldPaths(test::Message::GetDescriptor(), {"int32.value"});
+    ASSERT_FALSE(projection);
+
+    projection = Protobuf::MessageProjection::fromFieldPaths(test::Message::GetDescriptor(), {"unknown"});
+    ASSERT_FALSE(projection);
+}
+
 TEST(Message, canEncodeNested) {
     auto message = makeShared<Protobuf::Message>();
     message->getOrCreateField(1).setInt32(42);
@@ -0,0 +1,165 @@
+#include "protogen/test.pb.h"
+#include "valdi_protobuf/Message.hpp"
+#include "valdi_protobuf/PackedDecoding.hpp"
+#include "gtest/gtest.h"
+
+#include <limits>
+#include <random>
+
+using namespace Valdi;
+namespace {
+
+void appendVarint(std::vector<Byte>& output, uint64_t value) {
+    while (value >= 0x80) {
+        output.emplace_back(static_cast<Byte>(value | 0x80));
+        value >>= 7;
+    }
+    output.emplace_back(static_cast<Byte>(value));
+}
+
+/**
+ Returns values covering every varint length, with runs of single byte
+ varints long enough to hit the vectorized fast path.
+ */
+std::vector<uint64_t> makeVarintValues(size_t count) {
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> values;
+    values.reserve(count);
+
+    for (size_t i = 0; i < count; i++) {
+        if ((i / 64) % 2 == 0) {
+            values.emplace_back(random() % 128);
+        } else {
+            auto bits = static_cast<uint32_t>(random() % 64) + 1;
+            values.emplace_back(bits == 64 ? random() : random() & ((static_cast<uint64_t>(1) << bits) - 1));
+        }
+    }
+
+    return values;
+}
+
+std::vector<Byte> encodeVarints(const std::vector<uint64_t>& values) {
+    std::vector<Byte> output;
+    for (auto value : values) {
+        appendVarint(output, value);
+    }
+    return output;
+}
+
+TEST(PackedDecoding, canDecodeVarints) {
+    auto values = makeVarintValues(4096);
+    auto encoded = encodeVarints(values);
+
+    ASSERT_EQ(values.size(), Protobuf::countPackedVarints(encoded.data(), encoded.size()));
+
+    std::vector<uint64_t> output(values.size());
+    auto result = Protobuf::decodePackedVarints(encoded.data(), encoded.size(), output.data(), output.size());
+    ASSERT_EQ(values.size(), result.valuesCount);
+    ASSERT_EQ(encoded.size(), result.bytesRead);
+    ASSERT_EQ(values, output) << "With decoder " << Protobuf::getPackedVarintsDecoderName();
+
+    std::vector<uint64_t> scalarOutput(values.size());
+    auto scalarResult =
+        Protobuf::decodePackedVarintsScalar(encoded.data(), encoded.size(), scalarOutput.data(), scalarOutput.size());
+    ASSERT_EQ(values.size(), scalarResult.valuesCount);
+    ASSERT_EQ(encoded.size(), scalarResult.bytesRead);
+    ASSERT_EQ(values, scalarOutput);
+}
+
+TEST(PackedDecoding, canDecodeVarintsInBatches) {
+    auto values = makeVarintValues(1000);
+    auto encoded = encodeVarints(values);
+
+    std::vector<uint64_t> output;
+    const auto* data = encoded.data();
+    auto length = encoded.size();
+    uint64_t batch[7];
+    while (length > 0) {
+        auto result = Protobuf::decodePackedVarints(data, length, batch, 7);
+        ASSERT_TRUE(result.valuesCount > 0);
+        output.insert(output.end(), batch, batch + result.valuesCount);
+        data += result.bytesRead;
+        length -= result.bytesRead;
+    }
+
+    ASSERT_EQ(values, output);
+}
+
+TEST(PackedDecoding, stopsAtTruncatedVarint) {
+    auto values = makeVarintValues(200);
+    values.back() = std::numeric_limits<uint64_t>::max();
+    auto encoded = encodeVarints(values);
+    encoded.pop_back();
+
+    std::vector<uint64_t> output(values.size());
+    auto result = Protobuf::decodePackedVarints(encoded.data(), encoded.size(), output.data(), output.size());
+    ASSERT_EQ(values.size() - 1, result.valuesCount);
+    ASSERT_EQ(encoded.size() - 9, result.bytesRead);
+    ASSERT_EQ(values.size() - 1, Protobuf::countPackedVarints(encoded.data(), encoded.size()));
+}
+
+TEST(PackedDecoding, stopsAtMalformedVarint) {
+    std::vector<Byte> encoded;
+    appendVarint(encoded, 300);
+    // A varint cannot be longer than 10 bytes
+    encoded.insert(encoded.end(), 48, 0xff);
+    encoded.emplace_back(0x01);
+
+    std::vector<uint64_t> output(encoded.size());
+    auto result = Protobuf::decodePackedVarints(encoded.data(), encoded.size(), output.data(), output.size());
+    ASSERT_EQ(static_cast<size_t>(1), result.valuesCount);
+    ASSERT_EQ(static_cast<uint64_t>(300), output[0]);
+}
+
+TEST(PackedDecoding, canDecodeFixed) {
+    std::vector<uint32_t> values32 = {0, 1, 42, 0xffffffff, 0x12345678};
+    std::vector<uint32_t> output32(values32.size());
+    auto result32 = Protobuf::decodePackedFixed32(reinterpret_cast<const Byte*>(values32.data()),
+                                                  values32.size() * sizeof(uint32_t) + 2,
+                                                  output32.data(),
+                                                  output32.size());
+    ASSERT_EQ(values32.size(), result32.valuesCount);
+    ASSERT_EQ(values32, output32);
+
+    std::vector<uint64_t> values64 = {0, 1, 42, 0xffffffffffffffff, 0x1234567890abcdef};
+    std::vector<uint64_t> output64(values64.size());
+    auto result64 = Protobuf::decodePackedFixed64(reinterpret_cast<const Byte*>(values64.data()),
+                                                  values64.size() * sizeof(uint64_t),
+                                                  output64.data(),
+                                                  output64.size());
+    ASSERT_EQ(values64.size(), result64.valuesCount);
+    ASSERT_EQ(values64, output64);
+}
+
+TEST(PackedDecoding, canDecodePackedRepeatedFields) {
+    test::RepeatedMessage message;
+    auto values = makeVarintValues(1000);
+    for (auto value : values) {
+        message.add_uint64(value);
+        message.add_fixed64(value);
+        message.add_fixed32(static_cast<uint32_t>(value));
+    }
+
+    auto encoded = message.SerializeAsString();
+    auto buffer = makeShared<ByteBuffer>(encoded);
+
+    SimpleExceptionTracker exceptionTracker;
+    auto parsedMessage = Protobuf::Message::parse(buffer->toBytesView(), message.GetDescriptor(), exceptionTracker);
+    ASSERT_TRUE(parsedMessage != nullptr);
+
+    auto* uint64Values = parsedMessage->getOrCreateField(4).toVarintRepeated();
+    auto* fixed64Values = parsedMessage->getOrCreateField(8).toFixed64Repeated();
+    auto* fixed32Values = parsedMessage->getOrCreateField(7).toFixed32Repeated();
+
+    ASSERT_EQ(values.size(), uint64Values->size());
+    ASSERT_EQ(values.size(), fixed64Values->size());
+    ASSERT_EQ(values.size(), fixed32Values->size());
+
+    for (size_t i = 0; i < values.size(); i++) {
+        ASSERT_EQ(values[i], (*uint64Values)[i].getUInt64());
+        ASSERT_EQ(values[i], (*fixed64Values)[i].getFixed64());
+        ASSERT_EQ(static_cast<uint32_t>(values[i]), (*fixed32Values)[i].getFixed32());
+    }
+}
+
+} // namespace